@@ -10,12 +10,12 @@ namespace Rendering
 	RTTI_DEFINITIONS(CelestialBodies)
 
 	CelestialBodies::CelestialBodies(Game & game, const shared_ptr<Camera>& camera, float orbitRadius, float scale, float orbPer, float rotPer, float axTilt, 
-		wstring texFilename, wstring specFilename, Microsoft::WRL::ComPtr<ID3D11Buffer> frameBuffer, Microsoft::WRL::ComPtr<ID3D11Buffer> objectBuffer,
+		wstring texFilename, wstring specFilename,
 		std::shared_ptr<CelestialBodies> parent) :
-		DrawableGameComponent(game, camera), mWorldMatrix(MatrixHelper::Identity), mRenderStateHelper(game), mIndexCount(0),
+		DrawableGameComponent(game, camera), mLocalMatrix(MatrixHelper::Identity), mWorldMatrix(MatrixHelper::Identity), mQueuedPipelineState(0), mTextures(0), mIndexCount(0),
 		mAnimationEnabled(false), mOrbitalDistance(orbitRadius), mTextureFilename(texFilename), mSpecularFilename(specFilename), mScale(scale), 
 		mOrbitalPeriod(orbPer), mRotationalPeriod(rotPer), mAxialDisplacement(0.0f), mOrbitalDisplacement(0.0f), mAxialTilt(axTilt), 
-		mVSCBufferPerFrame(frameBuffer), mVSCBufferPerObject(objectBuffer), mParent(parent), OrbitalSpeedFactor(0.1f), RotationalSpeedFactor(.001f)
+		mParent(parent), OrbitalSpeedFactor(SolarSystemBodies::OrbitalSpeedFactor), RotationalSpeedFactor(SolarSystemBodies::RotationalSpeedFactor)
 	{
 	}
 
@@ -29,112 +29,130 @@ namespace Rendering
 		mAnimationEnabled = enabled;
 	}
 
+	const XMFLOAT4X4& CelestialBodies::WorldMatrix() const
+	{
+		return mWorldMatrix;
+	}
+
 	void CelestialBodies::Initialize()
 	{
+		RenderDevice& device = mGame->Device();
+
 		// Load a compiled vertex shader
 		vector<char> compiledVertexShader;
 		Utility::LoadBinaryFile(L"Content\\Shaders\\PointLightDemoVS.cso", compiledVertexShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateVertexShader(&compiledVertexShader[0], compiledVertexShader.size(), nullptr, mVertexShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedVertexShader() failed.");
+		mVertexShader = device.CreateShader(ShaderStage::Vertex, compiledVertexShader);
 
 		// Load a compiled pixel shader
 		vector<char> compiledPixelShader;
 		Utility::LoadBinaryFile(L"Content\\Shaders\\PointLightDemoPS.cso", compiledPixelShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreatePixelShader(&compiledPixelShader[0], compiledPixelShader.size(), nullptr, mPixelShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
+		mPixelShader = device.CreateShader(ShaderStage::Pixel, compiledPixelShader);
 
-		// Create an input layout
-		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
+		PipelineStateDescription pipelineStateDescription(mVertexShader, mPixelShader,
 		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-			{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-		};
-
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateInputLayout(inputElementDescriptions, ARRAYSIZE(inputElementDescriptions), &compiledVertexShader[0], compiledVertexShader.size(), mInputLayout.ReleaseAndGetAddressOf()), "ID3D11Device::CreateInputLayout() failed.");
+			InputElement("POSITION", VertexFormat::Float4),
+			InputElement("TEXCOORD", VertexFormat::Float2),
+			InputElement("NORMAL", VertexFormat::Float3)
+		});
+		pipelineStateDescription.Sampler = SamplerMode::TrilinearWrap;
+		mPipelineState = device.CreatePipelineState(pipelineStateDescription);
 
 		// Load the model
 		Library::Model model("Content\\Models\\Sphere.obj.bin");
 
 		// Create vertex and index buffers for the model
 		Library::Mesh* mesh = model.Meshes().at(0).get();
-		CreateVertexBuffer(*mesh, mVertexBuffer.ReleaseAndGetAddressOf());
-		mesh->CreateIndexBuffer(*mGame->Direct3DDevice(), mIndexBuffer.ReleaseAndGetAddressOf());
-		mIndexCount = static_cast<uint32_t>(mesh->Indices().size());
-
-		// Initialize shaders
-		mGame->Direct3DDeviceContext()->UpdateSubresource(mVSCBufferPerFrame.Get(), 0, nullptr, &mVSCBufferPerFrameData, 0, 0);
-		mGame->Direct3DDeviceContext()->UpdateSubresource(mVSCBufferPerObject.Get(), 0, nullptr, &mVSCBufferPerObjectData, 0, 0);
+		mVertexBuffer = CreateVertexBuffer(device, *mesh);
+		mIndexBuffer = mesh->CreateIndexBuffer(device);
+		mIndexCount = static_cast<uint32_t>(mesh->Indices().Size());
 
 		// Load textures for the color and specular maps
-		ThrowIfFailed(CreateDDSTextureFromFile(mGame->Direct3DDevice(), mTextureFilename.c_str(), nullptr, mColorTexture.ReleaseAndGetAddressOf()), "CreateDDSTextureFromFile() failed.");
-		ThrowIfFailed(CreateWICTextureFromFile(mGame->Direct3DDevice(), mSpecularFilename.c_str(), nullptr, mSpecularMap.ReleaseAndGetAddressOf()), "CreateWICTextureFromFile() failed.");
+		mColorTexture = device.CreateTextureFromFile(mTextureFilename);
+		mSpecularMap = device.CreateTextureFromFile(mSpecularFilename);
+
+		RenderQueue& drawQueue = mGame->DrawQueue();
+		mQueuedPipelineState = drawQueue.RegisterPipelineState(mPipelineState);
+		mTextures = drawQueue.RegisterTextures(RenderQueue::TextureState({ mColorTexture, mSpecularMap }));
+	}
+
+	void CelestialBodies::IncreaseSpeed()
+	{
+		RotationalSpeedFactor += .001f;
+		OrbitalSpeedFactor += 0.1f;
+	}
 
-		// Retrieve the keyboard service
-		mKeyboard = reinterpret_cast<KeyboardComponent*>(mGame->Services().GetService(KeyboardComponent::TypeIdClass()));
+	void CelestialBodies::DecreaseSpeed()
+	{
+		if ((RotationalSpeedFactor - .001f) > 0 && (OrbitalSpeedFactor - 0.1f) > 0)
+		{
+			RotationalSpeedFactor -= .001f;
+			OrbitalSpeedFactor -= 0.1f;
+		}
 	}
 
-	void CelestialBodies::Update(const GameTime& gameTime)
+	XMFLOAT3 CelestialBodies::SchedulingPosition() const
 	{
-		static float angle = 0.0f;
+		return XMFLOAT3(mWorldMatrix._41, mWorldMatrix._42, mWorldMatrix._43);
+	}
 
-		XMMATRIX matTrans;
-		XMMATRIX matScale;
-		XMMATRIX matAxialRot;
-		XMMATRIX matOrbitalRot;
-		XMMATRIX matAxialTilt;
+	float CelestialBodies::SchedulingRadius() const
+	{
+		return mScale;
+	}
 
+	void CelestialBodies::ScheduledUpdate(float elapsedSeconds)
+	{
 		if (mAnimationEnabled)
 		{
-			if (mParent == nullptr)
-			{
-				mAxialDisplacement += gameTime.ElapsedGameTimeSeconds().count() * (1 / mRotationalPeriod) * RotationalSpeedFactor;
-				mOrbitalDisplacement += gameTime.ElapsedGameTimeSeconds().count() * (1 / mOrbitalPeriod) * OrbitalSpeedFactor;
-
-				matScale = XMMatrixScaling(mScale, mScale, mScale);
-				matAxialRot = XMMatrixRotationY(mAxialDisplacement);
-				matAxialTilt = XMMatrixRotationZ(mAxialTilt);
-				matOrbitalRot = XMMatrixRotationY(mOrbitalDisplacement);
-				matTrans = XMMatrixTranslation(angle, angle, mOrbitalDistance);
-				XMStoreFloat4x4(&mWorldMatrix, (matScale * matAxialRot * matAxialTilt * matTrans * matOrbitalRot));
-			}
-			else
-			{
-				mAxialDisplacement += gameTime.ElapsedGameTimeSeconds().count() * (1 / mRotationalPeriod) * RotationalSpeedFactor;
-				mOrbitalDisplacement += gameTime.ElapsedGameTimeSeconds().count() * (1 / mOrbitalPeriod) * OrbitalSpeedFactor;
-
-				matScale = XMMatrixScaling(mScale, mScale, mScale);
-				matAxialRot = XMMatrixRotationY(mAxialDisplacement);
-				matAxialTilt = XMMatrixRotationZ(mAxialTilt);
-				matOrbitalRot = XMMatrixRotationY(mOrbitalDisplacement);
-				matTrans = XMMatrixTranslation(angle, angle, mOrbitalDistance);
-
-				XMMATRIX parentMatrix = XMLoadFloat4x4(&mParent->mWorldMatrix);
-
-				XMStoreFloat4x4(&mWorldMatrix, (matScale * matAxialRot * matAxialTilt * matTrans * matOrbitalRot * parentMatrix));
-			}
+			mAxialDisplacement += elapsedSeconds * (1 / mRotationalPeriod) * RotationalSpeedFactor;
+			mOrbitalDisplacement += elapsedSeconds * (1 / mOrbitalPeriod) * OrbitalSpeedFactor;
+
+			const OrbitalTransform local = SolarSystemBodies::LocalTransform(mOrbitalDistance, mScale, mAxialTilt, mAxialDisplacement, mOrbitalDisplacement);
+			XMVECTOR rotation = XMVectorSet(local.Rotation[0], local.Rotation[1], local.Rotation[2], local.Rotation[3]);
+			XMVECTOR translation = XMVectorSet(local.Translation[0], local.Translation[1], local.Translation[2], 0.0f);
+			XMStoreFloat4x4(&mLocalMatrix, XMMatrixAffineTransformation(XMVectorReplicate(local.Scale), XMVectorZero(), rotation, translation));
+		}
+	}
+
+	void CelestialBodies::Extrapolate(float elapsedSeconds)
+	{
+		if (mAnimationEnabled == false)
+		{
+			return;
+		}
+
+		// The orbital rotation is the outermost local transform, so advancing it is a single post-multiply.
+		XMMATRIX localMatrix = XMLoadFloat4x4(&mLocalMatrix);
+		if (elapsedSeconds > 0.0f)
+		{
+			localMatrix *= XMMatrixRotationY(elapsedSeconds * (1 / mOrbitalPeriod) * OrbitalSpeedFactor);
 		}
 
-		if (mKeyboard != nullptr)
+		if (mParent == nullptr)
 		{
-			if (mKeyboard->WasKeyPressedThisFrame(Keys::Space))
-			{
-				ToggleAnimation();
-			}
-
-			if (mKeyboard->WasKeyPressedThisFrame(Keys::R))
-			{
-				RotationalSpeedFactor += .001f;
-				OrbitalSpeedFactor += 0.1f;
-			}
-
-			if (mKeyboard->WasKeyPressedThisFrame(Keys::E))
-			{
-				if ((RotationalSpeedFactor - .001f) > 0 && (OrbitalSpeedFactor - 0.1f) > 0)
-				{
-					RotationalSpeedFactor -= .001f;
-					OrbitalSpeedFactor -= 0.1f;
-				}
-			}
+			XMStoreFloat4x4(&mWorldMatrix, localMatrix);
 		}
+		else
+		{
+			XMMATRIX parentMatrix = XMLoadFloat4x4(&mParent->mWorldMatrix);
+			XMStoreFloat4x4(&mWorldMatrix, localMatrix * parentMatrix);
+		}
+	}
+
+	void CelestialBodies::SaveSnapshot(OutputStreamHelper& streamHelper) const
+	{
+		streamHelper << mAxialDisplacement << mOrbitalDisplacement;
+		streamHelper << OrbitalSpeedFactor << RotationalSpeedFactor;
+		streamHelper << mAnimationEnabled;
+		streamHelper << mLocalMatrix << mWorldMatrix;
+	}
+
+	void CelestialBodies::LoadSnapshot(InputStreamHelper& streamHelper)
+	{
+		streamHelper >> mAxialDisplacement >> mOrbitalDisplacement;
+		streamHelper >> OrbitalSpeedFactor >> RotationalSpeedFactor;
+		streamHelper >> mAnimationEnabled;
+		streamHelper >> mLocalMatrix >> mWorldMatrix;
 	}
 
 	void CelestialBodies::Draw(const GameTime& gameTime)
@@ -142,18 +160,6 @@ namespace Rendering
 		UNREFERENCED_PARAMETER(gameTime);
 		assert(mCamera != nullptr);
 
-		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
-		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		direct3DDeviceContext->IASetInputLayout(mInputLayout.Get());
-
-		UINT stride = sizeof(VertexPositionTextureNormal);
-		UINT offset = 0;
-		direct3DDeviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
-		direct3DDeviceContext->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
-
-		direct3DDeviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
-		direct3DDeviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
-
 		XMMATRIX worldMatrix = XMLoadFloat4x4(&mWorldMatrix);
 		XMMATRIX wvp = worldMatrix * mCamera->ViewProjectionMatrix();
 
@@ -162,42 +168,37 @@ namespace Rendering
 		XMStoreFloat4x4(&mVSCBufferPerObjectData.WorldViewProjection, wvp);
 		XMStoreFloat4x4(&mVSCBufferPerObjectData.World, XMMatrixTranspose(worldMatrix));
 
-		direct3DDeviceContext->UpdateSubresource(mVSCBufferPerObject.Get(), 0, nullptr, &mVSCBufferPerObjectData, 0, 0);
+		ConstantBufferRing& constantBuffers = mGame->ConstantBuffers();
 
-		ID3D11Buffer* VSConstantBuffers[] = { mVSCBufferPerFrame.Get(), mVSCBufferPerObject.Get() };
-		direct3DDeviceContext->VSSetConstantBuffers(0, ARRAYSIZE(VSConstantBuffers), VSConstantBuffers);
+		RenderQueue::DrawPacket packet;
+		packet.AddVertexBuffer(mVertexBuffer, sizeof(VertexPositionTextureNormal));
+		packet.IndexBuffer = mIndexBuffer;
+		packet.AddVSConstantBuffer(constantBuffers.Allocate(mVSCBufferPerFrameData));
+		packet.AddVSConstantBuffer(constantBuffers.Allocate(mVSCBufferPerObjectData));
+		packet.ElementCount = mIndexCount;
 
-		ID3D11ShaderResourceView* PSShaderResources[] = { mColorTexture.Get(), mSpecularMap.Get() };
-		direct3DDeviceContext->PSSetShaderResources(0, ARRAYSIZE(PSShaderResources), PSShaderResources);
-		direct3DDeviceContext->PSSetSamplers(0, 1, SamplerStates::TrilinearWrap.GetAddressOf());
-
-		direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
+		mGame->DrawQueue().Submit(RenderLayer::Opaque, mQueuedPipelineState, mTextures, mCamera->NormalizedDepth(worldMatrix.r[3]), packet);
 	}
 
-	void CelestialBodies::CreateVertexBuffer(const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	BufferHandle CelestialBodies::CreateVertexBuffer(RenderDevice& device, const Mesh& mesh)
 	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
-		const vector<XMFLOAT3>& sourceNormals = mesh.Normals();
-		const auto& sourceUVs = mesh.TextureCoordinates().at(0);
+		Span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+		Span<const XMFLOAT3> sourceNormals = mesh.Normals();
+		Span<const XMFLOAT3> sourceUVs = mesh.TextureCoordinates(0);
+		assert(sourceNormals.Size() == sourceVertices.Size());
 
 		vector<VertexPositionTextureNormal> vertices;
-		vertices.reserve(sourceVertices.size());
-		for (UINT i = 0; i < sourceVertices.size(); i++)
+		vertices.reserve(sourceVertices.Size());
+		for (UINT i = 0; i < sourceVertices.Size(); i++)
 		{
-			const XMFLOAT3& position = sourceVertices.at(i);
-			const XMFLOAT3& uv = sourceUVs->at(i);
-			const XMFLOAT3& normal = sourceNormals.at(i);
+			const XMFLOAT3& position = sourceVertices[i];
+			const XMFLOAT3& uv = sourceUVs[i];
+			const XMFLOAT3& normal = sourceNormals[i];
 
 			vertices.push_back(VertexPositionTextureNormal(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y), normal));
 		}
-		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
-		vertexBufferDesc.ByteWidth = sizeof(VertexPositionTextureNormal) * static_cast<UINT>(vertices.size());
-		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-		D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
-		vertexSubResourceData.pSysMem = &vertices[0];
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer), "ID3D11Device::CreateBuffer() failed.");
+
+		return device.CreateBuffer(BufferDescription(BufferType::Vertex, ResourceUsage::Immutable, sizeof(VertexPositionTextureNormal) * static_cast<uint32_t>(vertices.size())), &vertices[0]);
 	}
 
 	void CelestialBodies::ToggleAnimation()
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "DrawableGameComponent.h"
-#include "RenderStateHelper.h"
+#include "RenderDevice.h"
 #include "PointLight.h"
+#include "UpdateScheduler.h"
+#include "SnapshotBuffer.h"
 #include <DirectXMath.h>
 #include <DirectXColors.h>
 
@@ -10,7 +12,6 @@ namespace Library
 {
 	class Mesh;
 	class ProxyModel;
-	class KeyboardComponent;
 }
 
 namespace DirectX
@@ -21,22 +22,35 @@ namespace DirectX
 
 namespace Rendering
 {
-	class CelestialBodies final : public Library::DrawableGameComponent
+	class CelestialBodies final : public Library::DrawableGameComponent, public Library::IScheduledUpdatable, public Library::ISnapshotable
 	{
 		RTTI_DECLARATIONS(CelestialBodies, Library::DrawableGameComponent)
 
 	public:
 		CelestialBodies(Library::Game& game, const std::shared_ptr<Library::Camera>& camera, float orbitRadius, float scale, float orbPer, float rotPer, float axTilt, 
-			std::wstring texFilename, std::wstring specFilename, Microsoft::WRL::ComPtr<ID3D11Buffer> frameBuffer, Microsoft::WRL::ComPtr<ID3D11Buffer> objectBuffer,
+			std::wstring texFilename, std::wstring specFilename,
 			std::shared_ptr<CelestialBodies> parent = nullptr);
 
 		bool AnimationEnabled() const;
 		void SetAnimationEnabled(bool enabled);
+		void ToggleAnimation();
+		const DirectX::XMFLOAT4X4& WorldMatrix() const;
+
+		// Step the rotational and orbital speed factors; decreasing never takes them to zero.
+		void IncreaseSpeed();
+		void DecreaseSpeed();
 
 		virtual void Initialize() override;
-		virtual void Update(const Library::GameTime& gameTime) override;
 		virtual void Draw(const Library::GameTime& gameTime) override;
 
+		virtual DirectX::XMFLOAT3 SchedulingPosition() const override;
+		virtual float SchedulingRadius() const override;
+		virtual void ScheduledUpdate(float elapsedSeconds) override;
+		virtual void Extrapolate(float elapsedSeconds) override;
+
+		virtual void SaveSnapshot(Library::OutputStreamHelper& streamHelper) const override;
+		virtual void LoadSnapshot(Library::InputStreamHelper& streamHelper) override;
+
 	private:
 		struct VSCBufferPerFrame
 		{
@@ -95,8 +109,7 @@ namespace Rendering
 				SpecularColor(specularColor), SpecularPower(specularPower) { }
 		};
 
-		void CreateVertexBuffer(const Library::Mesh& mesh, ID3D11Buffer** vertexBuffer) const;
-		void ToggleAnimation();
+		static Library::BufferHandle CreateVertexBuffer(Library::RenderDevice& device, const Library::Mesh& mesh);
 
 		std::shared_ptr<CelestialBodies> mParent;
 
@@ -113,20 +126,19 @@ namespace Rendering
 		float OrbitalSpeedFactor;
 		float RotationalSpeedFactor;
 
+		DirectX::XMFLOAT4X4 mLocalMatrix;
 		DirectX::XMFLOAT4X4 mWorldMatrix;
 		VSCBufferPerFrame mVSCBufferPerFrameData;
 		VSCBufferPerObject mVSCBufferPerObjectData;
-		Library::RenderStateHelper mRenderStateHelper;
-		Microsoft::WRL::ComPtr<ID3D11VertexShader> mVertexShader;
-		Microsoft::WRL::ComPtr<ID3D11PixelShader> mPixelShader;
-		Microsoft::WRL::ComPtr<ID3D11InputLayout> mInputLayout;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mVertexBuffer;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mIndexBuffer;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mVSCBufferPerFrame;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mVSCBufferPerObject;
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mColorTexture;
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mSpecularMap;
-		Library::KeyboardComponent* mKeyboard;
+		Library::ShaderHandle mVertexShader;
+		Library::ShaderHandle mPixelShader;
+		Library::PipelineStateHandle mPipelineState;
+		Library::BufferHandle mVertexBuffer;
+		Library::BufferHandle mIndexBuffer;
+		Library::TextureHandle mColorTexture;
+		Library::TextureHandle mSpecularMap;
+		std::uint32_t mQueuedPipelineState;
+		std::uint32_t mTextures;
 		std::uint32_t mIndexCount;
 		bool mAnimationEnabled;
 	};
@@ -0,0 +1,311 @@
+#include "pch.h"
+#include "CelestialBodyRenderer.h"
+#include <cfloat>
+
+using namespace std;
+using namespace Library;
+using namespace DirectX;
+
+namespace Rendering
+{
+	const uint32_t CelestialBodyRenderer::MaterialTextureWidth = 1024;
+	const uint32_t CelestialBodyRenderer::MaterialTextureHeight = 512;
+
+	CelestialBodyRenderer::CelestialBodyRenderer(Game& game, const shared_ptr<Camera>& camera) :
+		mGame(&game), mCamera(camera), mQueuedPipelineState(0), mTextures(0), mDrawCallCount(0), mOcclusionCullingEnabled(true), mIsInitialized(false)
+	{
+	}
+
+	CelestialBodyRenderer::~CelestialBodyRenderer()
+	{
+		EndPacking();
+	}
+
+	uint32_t CelestialBodyRenderer::AddMesh(Mesh& mesh)
+	{
+		RenderDevice& device = mGame->Device();
+
+		MeshBuffers meshBuffers;
+		meshBuffers.VertexBuffer = CreateVertexBuffer(device, mesh);
+		meshBuffers.IndexBuffer = mesh.CreateIndexBuffer(device);
+		meshBuffers.IndexCount = static_cast<uint32_t>(mesh.Indices().Size());
+		mMeshes.push_back(meshBuffers);
+
+		uint32_t meshIndex = static_cast<uint32_t>(mMeshes.size() - 1);
+		mInstancePacker.SetMeshBounds(meshIndex, mesh.Bounds().Center, mesh.Bounds().Radius);
+		mInstancePacker.SetMeshOccluderRadius(meshIndex, InscribedRadius(mesh));
+
+		return meshIndex;
+	}
+
+	uint32_t CelestialBodyRenderer::AddMaterial(const wstring& colorFilename, const wstring& specularFilename)
+	{
+		assert(mIsInitialized == false);
+
+		for (uint32_t i = 0; i < mMaterials.size(); ++i)
+		{
+			if (mMaterials[i].ColorFilename == colorFilename && mMaterials[i].SpecularFilename == specularFilename)
+			{
+				return i;
+			}
+		}
+
+		mMaterials.emplace_back(colorFilename, specularFilename);
+
+		return static_cast<uint32_t>(mMaterials.size() - 1);
+	}
+
+	uint32_t CelestialBodyRenderer::AddInstance(const XMFLOAT4X4& world, uint32_t meshIndex, uint32_t materialIndex, float ambientIntensity)
+	{
+		assert(mIsInitialized == false);
+		assert(meshIndex < mMeshes.size());
+		assert(materialIndex < mMaterials.size());
+
+		return mInstancePacker.Add(world, meshIndex, materialIndex, ambientIntensity);
+	}
+
+	void CelestialBodyRenderer::Initialize()
+	{
+		RenderDevice& device = mGame->Device();
+
+		// Load a compiled vertex shader
+		vector<char> compiledVertexShader;
+		Utility::LoadBinaryFile(L"Content\\Shaders\\InstancedPointLightVS.cso", compiledVertexShader);
+		mVertexShader = device.CreateShader(ShaderStage::Vertex, compiledVertexShader);
+
+		// Load a compiled pixel shader
+		vector<char> compiledPixelShader;
+		Utility::LoadBinaryFile(L"Content\\Shaders\\InstancedPointLightPS.cso", compiledPixelShader);
+		mPixelShader = device.CreateShader(ShaderStage::Pixel, compiledPixelShader);
+
+		// Slot 0 holds the mesh vertices, slot 1 the per-instance data
+		PipelineStateDescription pipelineStateDescription(mVertexShader, mPixelShader,
+		{
+			InputElement("POSITION", VertexFormat::Float4),
+			InputElement("TEXCOORD", VertexFormat::Float2),
+			InputElement("NORMAL", VertexFormat::Float3),
+			InputElement("WORLD", VertexFormat::Float4, 0, 1, true),
+			InputElement("WORLD", VertexFormat::Float4, 1, 1, true),
+			InputElement("WORLD", VertexFormat::Float4, 2, 1, true),
+			InputElement("WORLD", VertexFormat::Float4, 3, 1, true),
+			InputElement("WORLDVIEWPROJECTION", VertexFormat::Float4, 0, 1, true),
+			InputElement("WORLDVIEWPROJECTION", VertexFormat::Float4, 1, 1, true),
+			InputElement("WORLDVIEWPROJECTION", VertexFormat::Float4, 2, 1, true),
+			InputElement("WORLDVIEWPROJECTION", VertexFormat::Float4, 3, 1, true),
+			InputElement("MATERIALINDEX", VertexFormat::UInt1, 0, 1, true),
+			InputElement("AMBIENTINTENSITY", VertexFormat::Float1, 0, 1, true)
+		});
+		pipelineStateDescription.Sampler = SamplerMode::TrilinearWrap;
+		mPipelineState = device.CreatePipelineState(pipelineStateDescription);
+
+		// Create the dynamic instance buffer
+		if (mInstancePacker.Size() > 0)
+		{
+			mInstanceBuffer = device.CreateBuffer(BufferDescription(BufferType::Vertex, ResourceUsage::Dynamic, static_cast<uint32_t>(sizeof(InstanceData) * mInstancePacker.Size())), nullptr);
+		}
+
+		// Build texture arrays so that a single draw can index every material; the device resamples each map to a common size
+		if (mMaterials.size() > 0)
+		{
+			vector<wstring> colorFilenames;
+			vector<wstring> specularFilenames;
+			for (const Material& material : mMaterials)
+			{
+				colorFilenames.push_back(material.ColorFilename);
+				specularFilenames.push_back(material.SpecularFilename);
+			}
+
+			mColorMaps = device.CreateTextureArrayFromFiles(colorFilenames, MaterialTextureWidth, MaterialTextureHeight);
+			mSpecularMaps = device.CreateTextureArrayFromFiles(specularFilenames, MaterialTextureWidth, MaterialTextureHeight);
+		}
+
+		RenderQueue& drawQueue = mGame->DrawQueue();
+		mQueuedPipelineState = drawQueue.RegisterPipelineState(mPipelineState);
+		mTextures = drawQueue.RegisterTextures(RenderQueue::TextureState({ mColorMaps, mSpecularMaps }));
+
+		mIsInitialized = true;
+	}
+
+	void CelestialBodyRenderer::SetPointLight(const PointLight& pointLight)
+	{
+		XMStoreFloat3(&mVSCBufferPerFrameData.LightPosition, pointLight.PositionVector());
+		mVSCBufferPerFrameData.LightRadius = pointLight.Radius();
+		mPSCBufferPerFrameData.LightPosition = mVSCBufferPerFrameData.LightPosition;
+		mPSCBufferPerFrameData.LightColor = ColorHelper::ToFloat3(pointLight.Color(), true);
+	}
+
+	void CelestialBodyRenderer::BeginPacking()
+	{
+		assert(mIsInitialized);
+		assert(mCamera != nullptr);
+
+		EndPacking();
+		if (mInstanceBuffer.IsValid() == false)
+		{
+			return;
+		}
+
+		XMFLOAT4X4 viewProjection;
+		XMStoreFloat4x4(&viewProjection, mCamera->ViewProjectionMatrix());
+		Frustum frustum = mCamera->ViewFrustum();
+
+		// The bodies are rasterized here, while their world matrices are known to be stable, and tested on the packing thread.
+		const OcclusionCuller* occlusionCuller = nullptr;
+		if (mOcclusionCullingEnabled)
+		{
+			mOcclusionCuller.BeginFrame(&viewProjection.m[0][0]);
+			mInstancePacker.AddOccluders(mOcclusionCuller);
+			mOcclusionCuller.RasterizeOccluders(&mGame->Workers());
+			occlusionCuller = &mOcclusionCuller;
+		}
+
+		InstanceData* instances = static_cast<InstanceData*>(mGame->Device().ImmediateEncoder().Map(mInstanceBuffer, MapMode::Discard));
+		mPackingTask = mGame->Workers().Enqueue([this, viewProjection, frustum, instances, occlusionCuller]()
+		{
+			mInstancePacker.Pack(viewProjection, frustum, instances, occlusionCuller);
+		});
+	}
+
+	void CelestialBodyRenderer::Draw()
+	{
+		assert(mIsInitialized);
+		assert(mCamera != nullptr);
+
+		EndPacking();
+		mDrawCallCount = 0;
+
+		const vector<InstanceRange>& instanceRanges = mInstancePacker.Ranges();
+		if (instanceRanges.empty())
+		{
+			return;
+		}
+
+		ConstantBufferRing& constantBuffers = mGame->ConstantBuffers();
+		ConstantBufferRing::Allocation VSCBufferPerFrame = constantBuffers.Allocate(mVSCBufferPerFrameData);
+
+		mPSCBufferPerFrameData.CameraPosition = mCamera->Position();
+		ConstantBufferRing::Allocation PSCBufferPerFrame = constantBuffers.Allocate(mPSCBufferPerFrameData);
+		ConstantBufferRing::Allocation PSCBufferPerObject = constantBuffers.Allocate(mPSCBufferPerObjectData);
+
+		RenderQueue& drawQueue = mGame->DrawQueue();
+		for (const InstanceRange& instanceRange : instanceRanges)
+		{
+			const MeshBuffers& mesh = mMeshes[instanceRange.MeshIndex];
+
+			RenderQueue::DrawPacket packet;
+			packet.AddVertexBuffer(mesh.VertexBuffer, sizeof(VertexPositionTextureNormal));
+			packet.AddVertexBuffer(mInstanceBuffer, sizeof(InstanceData));
+			packet.IndexBuffer = mesh.IndexBuffer;
+			packet.AddVSConstantBuffer(VSCBufferPerFrame);
+			packet.AddPSConstantBuffer(PSCBufferPerFrame);
+			packet.AddPSConstantBuffer(PSCBufferPerObject);
+			packet.ElementCount = mesh.IndexCount;
+			packet.InstanceCount = instanceRange.InstanceCount;
+			packet.StartInstance = instanceRange.StartInstance;
+
+			// Instances span the whole system, so a range has no single depth to sort by.
+			drawQueue.Submit(RenderLayer::Opaque, mQueuedPipelineState, mTextures, 0.0f, packet);
+			++mDrawCallCount;
+		}
+	}
+
+	uint32_t CelestialBodyRenderer::DrawCallCount() const
+	{
+		return mDrawCallCount;
+	}
+
+	uint32_t CelestialBodyRenderer::InstanceCount() const
+	{
+		return mInstancePacker.Size();
+	}
+
+	uint32_t CelestialBodyRenderer::VisibleInstanceCount() const
+	{
+		return mInstancePacker.VisibleCount();
+	}
+
+	uint32_t CelestialBodyRenderer::OccludedInstanceCount() const
+	{
+		return mInstancePacker.OccludedCount();
+	}
+
+	bool CelestialBodyRenderer::OcclusionCullingEnabled() const
+	{
+		return mOcclusionCullingEnabled;
+	}
+
+	void CelestialBodyRenderer::SetOcclusionCullingEnabled(bool enabled)
+	{
+		mOcclusionCullingEnabled = enabled;
+	}
+
+	bool CelestialBodyRenderer::IsOccluded(const XMFLOAT3& center, float radius) const
+	{
+		return (mOcclusionCullingEnabled && mOcclusionCuller.IsOccluded(center.x, center.y, center.z, radius));
+	}
+
+	const OcclusionCuller& CelestialBodyRenderer::Occlusion() const
+	{
+		return mOcclusionCuller;
+	}
+
+	double CelestialBodyRenderer::OcclusionTestMicroseconds() const
+	{
+		return mInstancePacker.OcclusionTestMicroseconds();
+	}
+
+	void CelestialBodyRenderer::EndPacking()
+	{
+		if (mPackingTask.valid())
+		{
+			mPackingTask.wait();
+			mGame->Device().ImmediateEncoder().Unmap(mInstanceBuffer);
+			mPackingTask.get();
+		}
+	}
+
+	float CelestialBodyRenderer::InscribedRadius(const Mesh& mesh)
+	{
+		// The nearest face plane bounds the largest sphere about the center that a convex mesh, such as the body sphere, contains.
+		Span<const XMFLOAT3> vertices = mesh.Vertices();
+		Span<const uint32_t> indices = mesh.Indices();
+		XMVECTOR center = XMLoadFloat3(&mesh.Bounds().Center);
+
+		float radius = FLT_MAX;
+		for (size_t i = 0; i + 2 < indices.Size(); i += 3)
+		{
+			XMVECTOR vertex0 = XMLoadFloat3(&vertices[indices[i]]);
+			XMVECTOR normal = XMVector3Cross(XMLoadFloat3(&vertices[indices[i + 1]]) - vertex0, XMLoadFloat3(&vertices[indices[i + 2]]) - vertex0);
+			if (XMVectorGetX(XMVector3LengthSq(normal)) == 0.0f)
+			{
+				continue;
+			}
+
+			float distance = fabsf(XMVectorGetX(XMVector3Dot(XMVector3Normalize(normal), center - vertex0)));
+			radius = (distance < radius ? distance : radius);
+		}
+
+		return (radius < FLT_MAX ? radius : 0.0f);
+	}
+
+	BufferHandle CelestialBodyRenderer::CreateVertexBuffer(RenderDevice& device, const Mesh& mesh)
+	{
+		Span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+		Span<const XMFLOAT3> sourceNormals = mesh.Normals();
+		Span<const XMFLOAT3> sourceUVs = mesh.TextureCoordinates(0);
+		assert(sourceNormals.Size() == sourceVertices.Size());
+
+		vector<VertexPositionTextureNormal> vertices;
+		vertices.reserve(sourceVertices.Size());
+		for (UINT i = 0; i < sourceVertices.Size(); i++)
+		{
+			const XMFLOAT3& position = sourceVertices[i];
+			const XMFLOAT3& uv = sourceUVs[i];
+			const XMFLOAT3& normal = sourceNormals[i];
+
+			vertices.push_back(VertexPositionTextureNormal(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y), normal));
+		}
+
+		return device.CreateBuffer(BufferDescription(BufferType::Vertex, ResourceUsage::Immutable, sizeof(VertexPositionTextureNormal) * static_cast<uint32_t>(vertices.size())), &vertices[0]);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "RenderDevice.h"
+#include "InstancePacker.h"
+#include <future>
+#include <DirectXMath.h>
+
+namespace Library
+{
+	class Game;
+	class Camera;
+	class Mesh;
+	class PointLight;
+}
+
+namespace Rendering
+{
+	class CelestialBodyRenderer final
+	{
+	public:
+		CelestialBodyRenderer(Library::Game& game, const std::shared_ptr<Library::Camera>& camera);
+		CelestialBodyRenderer(const CelestialBodyRenderer&) = delete;
+		CelestialBodyRenderer& operator=(const CelestialBodyRenderer&) = delete;
+		CelestialBodyRenderer(CelestialBodyRenderer&&) = delete;
+		CelestialBodyRenderer& operator=(CelestialBodyRenderer&&) = delete;
+		~CelestialBodyRenderer();
+
+		std::uint32_t AddMesh(Library::Mesh& mesh);
+		std::uint32_t AddMaterial(const std::wstring& colorFilename, const std::wstring& specularFilename);
+		std::uint32_t AddInstance(const DirectX::XMFLOAT4X4& world, std::uint32_t meshIndex, std::uint32_t materialIndex, float ambientIntensity);
+
+		void Initialize();
+		void SetPointLight(const Library::PointLight& pointLight);
+
+		// Maps the instance buffer and packs this frame's instances into it on a worker thread.
+		// The registered world matrices must not change until the following Draw().
+		void BeginPacking();
+
+		// Finishes packing and submits one instanced packet per mesh to the game's render queue.
+		void Draw();
+
+		std::uint32_t DrawCallCount() const;
+		std::uint32_t InstanceCount() const;
+
+		// Instances that survived frustum and occlusion culling in the last Draw().
+		std::uint32_t VisibleInstanceCount() const;
+
+		// Instances inside the frustum that were hidden behind other bodies in the last Draw().
+		std::uint32_t OccludedInstanceCount() const;
+
+		bool OcclusionCullingEnabled() const;
+		void SetOcclusionCullingEnabled(bool enabled);
+
+		// Tests a world-space sphere against the bodies rasterized by the last BeginPacking(); false while occlusion culling is disabled.
+		bool IsOccluded(const DirectX::XMFLOAT3& center, float radius) const;
+
+		const Library::OcclusionCuller& Occlusion() const;
+		double OcclusionTestMicroseconds() const;
+
+		static const std::uint32_t MaterialTextureWidth;
+		static const std::uint32_t MaterialTextureHeight;
+
+	private:
+		struct VSCBufferPerFrame
+		{
+			DirectX::XMFLOAT3 LightPosition;
+			float LightRadius;
+
+			VSCBufferPerFrame() :
+				LightPosition(Library::Vector3Helper::Zero), LightRadius(100000.0f) { }
+		};
+
+		struct PSCBufferPerFrame
+		{
+			DirectX::XMFLOAT3 CameraPosition;
+			float Padding;
+			DirectX::XMFLOAT3 LightPosition;
+			float Padding2;
+			DirectX::XMFLOAT3 LightColor;
+			float Padding3;
+
+			PSCBufferPerFrame() :
+				CameraPosition(Library::Vector3Helper::Zero), LightPosition(Library::Vector3Helper::Zero), LightColor(Library::Vector3Helper::Zero) { }
+		};
+
+		struct PSCBufferPerObject
+		{
+			DirectX::XMFLOAT3 SpecularColor;
+			float SpecularPower;
+
+			PSCBufferPerObject() :
+				SpecularColor(1.0f, 1.0f, 1.0f), SpecularPower(128.0f) { }
+		};
+
+		struct MeshBuffers
+		{
+			Library::BufferHandle VertexBuffer;
+			Library::BufferHandle IndexBuffer;
+			std::uint32_t IndexCount;
+
+			MeshBuffers() :
+				IndexCount(0) { }
+		};
+
+		struct Material
+		{
+			std::wstring ColorFilename;
+			std::wstring SpecularFilename;
+
+			Material(const std::wstring& colorFilename, const std::wstring& specularFilename) :
+				ColorFilename(colorFilename), SpecularFilename(specularFilename) { }
+		};
+
+		void EndPacking();
+		static float InscribedRadius(const Library::Mesh& mesh);
+		static Library::BufferHandle CreateVertexBuffer(Library::RenderDevice& device, const Library::Mesh& mesh);
+
+		Library::Game* mGame;
+		std::shared_ptr<Library::Camera> mCamera;
+		Library::InstancePacker mInstancePacker;
+		Library::OcclusionCuller mOcclusionCuller;
+		std::vector<MeshBuffers> mMeshes;
+		std::vector<Material> mMaterials;
+		VSCBufferPerFrame mVSCBufferPerFrameData;
+		PSCBufferPerFrame mPSCBufferPerFrameData;
+		PSCBufferPerObject mPSCBufferPerObjectData;
+		Library::ShaderHandle mVertexShader;
+		Library::ShaderHandle mPixelShader;
+		Library::PipelineStateHandle mPipelineState;
+		Library::BufferHandle mInstanceBuffer;
+		Library::TextureHandle mColorMaps;
+		Library::TextureHandle mSpecularMaps;
+		std::uint32_t mQueuedPipelineState;
+		std::uint32_t mTextures;
+		std::future<void> mPackingTask;
+		std::uint32_t mDrawCallCount;
+		bool mOcclusionCullingEnabled;
+		bool mIsInitialized;
+	};
+}
\ No newline at end of file
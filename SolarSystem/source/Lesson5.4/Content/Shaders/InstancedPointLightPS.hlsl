@@ -0,0 +1,49 @@
+cbuffer CBufferPerFrame
+{
+	float3 CameraPosition;
+	float3 LightPosition;
+	float3 LightColor;
+};
+
+cbuffer CBufferPerObject
+{
+	float3 SpecularColor;
+	float SpecularPower;
+}
+
+Texture2DArray ColorMaps;
+Texture2DArray SpecularMaps;
+SamplerState TextureSampler;
+
+struct VS_OUTPUT
+{
+	float4 Position: SV_Position;
+	float3 WorldPosition : WORLDPOS;
+	float Attenuation : ATTENUATION;
+	float2 TextureCoordinate : TEXCOORD;
+	float3 Normal : NORMAL;
+	nointerpolation uint MaterialIndex : MATERIALINDEX;
+	nointerpolation float AmbientIntensity : AMBIENTINTENSITY;
+};
+
+float4 main(VS_OUTPUT IN) : SV_TARGET
+{
+	float3 viewDirection = normalize(CameraPosition - IN.WorldPosition);
+	float3 lightDirection = normalize(LightPosition - IN.WorldPosition);
+
+	float3 normal = normalize(IN.Normal);
+	float n_dot_l = dot(normal, lightDirection);
+	float3 halfVector = normalize(lightDirection + viewDirection);
+	float n_dot_h = dot(normal, halfVector);
+
+	float3 textureCoordinate = float3(IN.TextureCoordinate, IN.MaterialIndex);
+	float4 color = ColorMaps.Sample(TextureSampler, textureCoordinate);
+	float specularClamp = SpecularMaps.Sample(TextureSampler, textureCoordinate).x;
+	float2 lightCoefficients = lit(n_dot_l, n_dot_h, SpecularPower).yz;
+
+	float3 ambient = color.rgb * IN.AmbientIntensity;
+	float3 diffuse = color.rgb * lightCoefficients.x * LightColor * IN.Attenuation;
+	float3 specular = min(lightCoefficients.y, specularClamp) * SpecularColor * IN.Attenuation;
+
+	return float4(saturate(ambient + diffuse + specular), color.a);
+}
\ No newline at end of file
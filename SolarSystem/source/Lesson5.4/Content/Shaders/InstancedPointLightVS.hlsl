@@ -0,0 +1,53 @@
+cbuffer CBufferPerFrame
+{
+	float3 LightPosition;
+	float LightRadius;
+}
+
+struct VS_INPUT
+{
+	float4 ObjectPosition: POSITION;
+	float2 TextureCoordinate : TEXCOORD;
+	float3 Normal : NORMAL;
+	float4 World0 : WORLD0;
+	float4 World1 : WORLD1;
+	float4 World2 : WORLD2;
+	float4 World3 : WORLD3;
+	float4 WorldViewProjection0 : WORLDVIEWPROJECTION0;
+	float4 WorldViewProjection1 : WORLDVIEWPROJECTION1;
+	float4 WorldViewProjection2 : WORLDVIEWPROJECTION2;
+	float4 WorldViewProjection3 : WORLDVIEWPROJECTION3;
+	uint MaterialIndex : MATERIALINDEX;
+	float AmbientIntensity : AMBIENTINTENSITY;
+};
+
+struct VS_OUTPUT
+{
+	float4 Position: SV_Position;
+	float3 WorldPosition : WORLDPOS;
+	float Attenuation : ATTENUATION;
+	float2 TextureCoordinate : TEXCOORD;
+	float3 Normal : NORMAL;
+	nointerpolation uint MaterialIndex : MATERIALINDEX;
+	nointerpolation float AmbientIntensity : AMBIENTINTENSITY;
+};
+
+VS_OUTPUT main(VS_INPUT IN)
+{
+	VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+	float4x4 world = float4x4(IN.World0, IN.World1, IN.World2, IN.World3);
+	float4x4 worldViewProjection = float4x4(IN.WorldViewProjection0, IN.WorldViewProjection1, IN.WorldViewProjection2, IN.WorldViewProjection3);
+
+	OUT.Position = mul(IN.ObjectPosition, worldViewProjection);
+	OUT.WorldPosition = mul(IN.ObjectPosition, world).xyz;
+	OUT.TextureCoordinate = IN.TextureCoordinate;
+	OUT.Normal = normalize(mul(float4(IN.Normal, 0), world).xyz);
+	OUT.MaterialIndex = IN.MaterialIndex;
+	OUT.AmbientIntensity = IN.AmbientIntensity;
+
+	float3 lightDirection = LightPosition - OUT.WorldPosition;
+	OUT.Attenuation = saturate(1.0f - (length(lightDirection) / LightRadius));
+
+	return OUT;
+}
\ No newline at end of file
@@ -18,7 +18,6 @@ int WINAPI WinMain(HINSTANCE instance, HINSTANCE previousInstance, LPSTR command
 #endif
 
 	UNREFERENCED_PARAMETER(previousInstance);
-	UNREFERENCED_PARAMETER(commandLine);
 
 	SetCurrentDirectory(UtilityWin32::ExecutableDirectory().c_str());
 
@@ -39,7 +38,31 @@ int WINAPI WinMain(HINSTANCE instance, HINSTANCE previousInstance, LPSTR command
 		return reinterpret_cast<void*>(mWindowHandle);
 	};
 
-	mGame = make_unique<RenderingGame>(getWindow, getRenderTargetSize);
+	// -nullrenderer: run headless on the null render device, without a Direct3D device or swap chain
+	RenderDeviceType deviceType = (strstr(commandLine, "-nullrenderer") != nullptr ? RenderDeviceType::Null : RenderDeviceType::Direct3D11);
+	mGame = make_unique<RenderingGame>(getWindow, getRenderTargetSize, deviceType);
+
+	if (strstr(commandLine, "-serial") != nullptr)
+	{
+		mGame->DisablePipelinedSimulation();
+	}
+
+	// -allocationsampling [interval]: record the call stack of every interval-th allocation for the memory report
+	const char* samplingOption = strstr(commandLine, "-allocationsampling");
+	if (samplingOption != nullptr)
+	{
+		unsigned long interval = strtoul(samplingOption + strlen("-allocationsampling"), nullptr, 10);
+		AllocationCounter::SetSamplingInterval(interval > 0 && interval <= 1000000 ? static_cast<uint32_t>(interval) : 1000);
+	}
+
+	// -benchmark [frames]
+	const char* benchmarkOption = strstr(commandLine, "-benchmark");
+	if (benchmarkOption != nullptr)
+	{
+		unsigned long frameCount = strtoul(benchmarkOption + strlen("-benchmark"), nullptr, 10);
+		mGame->EnableBenchmark(frameCount > 0 && frameCount <= 1000000 ? static_cast<uint32_t>(frameCount) : RenderingGame::DefaultBenchmarkFrameCount);
+	}
+
 	mGame->UpdateRenderTargetSize();
 	mGame->Initialize();
 
@@ -9,47 +9,111 @@ namespace Rendering
 	const XMVECTORF32 RenderingGame::BackgroundColor = Colors::Black;
 	const float RenderingGame::DistanceMultiplier = 50.0f;
 	const float RenderingGame::OrbitalPeriodMultipler = 0.1f;
+	const string RenderingGame::FrameStatisticsCsvFilename = "FrameStatistics.csv";
+	const string RenderingGame::FrameStatisticsJsonFilename = "FrameStatistics.json";
+	const string RenderingGame::MemoryReportFilename = "MemoryReport.txt";
+	const uint32_t RenderingGame::DefaultBenchmarkFrameCount = 1200;
+	const uint32_t RenderingGame::BenchmarkWarmupFrameCount = 60;
+	const chrono::nanoseconds RenderingGame::BenchmarkTimeStep = chrono::nanoseconds(1000000000 / 60);
+	const double RenderingGame::MinGameTimeScale = 1.0 / 64.0;
+	const double RenderingGame::MaxGameTimeScale = 64.0;
+	const string RenderingGame::BenchmarkCameraPathFilename = "Content\\Benchmarks\\SolarSystem.path";
+	const string RenderingGame::BenchmarkReportFilename = "Benchmark.json";
 
-	RenderingGame::RenderingGame(std::function<void*()> getWindowCallback, std::function<void(SIZE&)> getRenderTargetSizeCallback) :
-		Game(getWindowCallback, getRenderTargetSizeCallback), mRenderStateHelper(*this)
+	RenderingGame::RenderingGame(std::function<void*()> getWindowCallback, std::function<void(SIZE&)> getRenderTargetSizeCallback, RenderDeviceType deviceType) :
+		Game(getWindowCallback, getRenderTargetSizeCallback, deviceType),
+		mFrameGameTime(nullptr), mPresentResult(S_OK), mSyncInterval(1), mPipelinedSimulation(true),
+		mBenchmarkFrameCount(0), mBenchmarkSegmentStartTime(0), mUpdatePhase(0), mDrawPhase(0), mPresentPhase(0)
 	{
 	}
 
 	void RenderingGame::Initialize()
 	{
-		RasterizerStates::Initialize(mDirect3DDevice.Get());
-		SamplerStates::Initialize(mDirect3DDevice.Get());
-
 		mKeyboard = make_shared<KeyboardComponent>(*this);
-		mComponents.push_back(mKeyboard);
-		mServices.AddService(KeyboardComponent::TypeIdClass(), mKeyboard.get());
+		AddComponent(mKeyboard);
+		mServices.AddService<KeyboardComponent>(mKeyboard.get());
 
 		mMouse = make_shared<MouseComponent>(*this);
-		mComponents.push_back(mMouse);
-		mServices.AddService(MouseComponent::TypeIdClass(), mMouse.get());
+		AddComponent(mMouse);
+		mServices.AddService<MouseComponent>(mMouse.get());
 
 		mGamePad = make_shared<GamePadComponent>(*this);
-		mComponents.push_back(mGamePad);
-		mServices.AddService(GamePadComponent::TypeIdClass(), mGamePad.get());
+		AddComponent(mGamePad);
+		mServices.AddService<GamePadComponent>(mGamePad.get());
 
 		mCamera = make_shared<FirstPersonCamera>(*this);
-		mComponents.push_back(mCamera);
-		mServices.AddService(Camera::TypeIdClass(), mCamera.get());
+		AddComponent(mCamera);
+		mServices.AddService<Camera>(mCamera.get());
+
+		// Added after everything that sets label text, so the HUD lays out and submits its pass last
+		mHud = make_shared<HudComponent>(*this);
+		mServices.AddService<HudComponent>(mHud.get());
+
+		const CelestialBodyDescription& sun = SolarSystemBodies::Sun;
+		mSolarSystem = make_shared<SolarSystem>(*this, mCamera, sun.OrbitRadius, sun.Scale, sun.OrbitalPeriod, sun.RotationalPeriod, sun.AxialTilt,
+			SolarSystem::TexturePath(sun.TextureFilename), SolarSystem::TexturePath(SolarSystemBodies::SpecularFilename));
+		AddComponent(mSolarSystem);
 
-		mSolarSystem = make_shared<SolarSystem>(*this, mCamera, 0.0f, 1.0f, SunOrbitalVelocity,
-			SunRotationalVelocity, SunAxialTilt, mSunTextureFilename, mSunSpecularFilename);
-		mComponents.push_back(mSolarSystem);
+		AddComponent(mHud);
 
 		Game::Initialize();
 
 		mFpsComponent = make_shared<FpsComponent>(*this);
 		mFpsComponent->Initialize();
 
+		mSolarSystem->SetSimulationPipelined(mPipelinedSimulation);
+
 		mCamera->SetPosition(0.0f, 2.5f, 25.0f);
+
+		CreateFrameGraphExecutor();
+		BuildFrameGraph();
+
+		if (mBenchmarkFrameCount > 0)
+		{
+			mBenchmarkCameraPath = CameraPath(BenchmarkCameraPathFilename);
+
+			mBenchmark = make_unique<Benchmark>("SolarSystem", mBenchmarkFrameCount, BenchmarkWarmupFrameCount, vector<string>({ "Pipelined", "Serial" }));
+			mUpdatePhase = mBenchmark->AddPhase("Update");
+			mDrawPhase = mBenchmark->AddPhase("Draw");
+			mPresentPhase = mBenchmark->AddPhase("Present");
+			mBenchmark->SetProperty("renderer", mRenderDevice->Name());
+			mBenchmark->SetProperty("resolution", to_string(mRenderTargetSize.cx) + "x" + to_string(mRenderTargetSize.cy));
+			mBenchmark->SetProperty("syncInterval", to_string(mSyncInterval));
+			mBenchmark->SetProperty("timeStepNanoseconds", to_string(BenchmarkTimeStep.count()));
+			mBenchmark->SetProperty("cameraPath", BenchmarkCameraPathFilename);
+		}
 	}
 
 	void RenderingGame::Update(const GameTime &gameTime)
 	{
+		if (mBenchmark != nullptr && mBenchmark->BeginFrame() == false)
+		{
+			WriteBenchmarkReport();
+			mBenchmark = nullptr;
+			Exit();
+		}
+
+		BenchmarkPhaseScope updateScope(mBenchmark.get(), mUpdatePhase);
+
+		if (mBenchmark != nullptr)
+		{
+			// Each segment flies the whole path, the first with pipelined simulation and the second with serial. The clock has
+			// already advanced one step by a segment's first frame.
+			if (mBenchmark->SegmentFrameIndex() == 0)
+			{
+				mBenchmarkSegmentStartTime = gameTime.TotalGameTime() - gameTime.ElapsedGameTime();
+				mSolarSystem->SetSimulationPipelined(mBenchmark->CurrentSegment() == 0);
+			}
+
+			CameraPath::Point position;
+			CameraPath::Point target;
+			mBenchmarkCameraPath.Evaluate(chrono::duration_cast<chrono::duration<float>>(gameTime.TotalGameTime() - mBenchmarkSegmentStartTime).count(), position, target);
+
+			XMVECTOR cameraPosition = XMVectorSet(position.X, position.Y, position.Z, 1.0f);
+			mCamera->SetPosition(cameraPosition);
+			mCamera->SetDirection(XMVectorSet(target.X, target.Y, target.Z, 1.0f) - cameraPosition, XMLoadFloat3(&Vector3Helper::Up));
+		}
+
 		mFpsComponent->Update(gameTime);
 
 		if (mKeyboard->WasKeyPressedThisFrame(Keys::Escape) || mGamePad->WasButtonPressedThisFrame(GamePadButtons::Back))
@@ -62,41 +126,162 @@ namespace Rendering
 			mCamera->SetPosition(0.0f, 0.0f, 0.0f);
 		}
 
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::F))
+		{
+			WriteFrameStatistics();
+		}
+
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::N))
+		{
+			WriteMemoryReport();
+		}
+
+		// Takes effect from the next frame's game time
+		Timeline& gameTimeline = mGameClock.GameTimeline();
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::Pause))
+		{
+			gameTimeline.SetPaused(gameTimeline.IsPaused() == false);
+		}
+
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::PageUp) && gameTimeline.Scale() < MaxGameTimeScale)
+		{
+			gameTimeline.SetScale(gameTimeline.Scale() * 2.0);
+		}
+
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::PageDown) && gameTimeline.Scale() > MinGameTimeScale)
+		{
+			gameTimeline.SetScale(gameTimeline.Scale() * 0.5);
+		}
+
 		Game::Update(gameTime);
 	}
 
 	void RenderingGame::Draw(const GameTime &gameTime)
 	{
-		mDirect3DDeviceContext->ClearRenderTargetView(mRenderTargetView.Get(), reinterpret_cast<const float*>(&BackgroundColor));
-		mDirect3DDeviceContext->ClearDepthStencilView(mDepthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
-
-		Game::Draw(gameTime);
+		const TextureDescription& backBufferDescription = mFrameGraph.Description(mBackBuffer);
+		if (backBufferDescription.Width != static_cast<uint32_t>(mRenderTargetSize.cx) || backBufferDescription.Height != static_cast<uint32_t>(mRenderTargetSize.cy))
+		{
+			BuildFrameGraph();
+		}
 
-		mRenderStateHelper.SaveAll();
-		mFpsComponent->Draw(gameTime);
-		mRenderStateHelper.RestoreAll();
+		// The swap chain's views are recreated on resize, so they are bound every frame
+		if (mDeviceType == RenderDeviceType::Direct3D11)
+		{
+			Direct3D11RenderGraphExecutor& executor = static_cast<Direct3D11RenderGraphExecutor&>(*mFrameGraphExecutor);
+			executor.SetImportedTexture(mBackBuffer, mRenderTargetView.Get(), nullptr, nullptr);
+			executor.SetImportedTexture(mDepthStencil, nullptr, mDepthStencilView.Get(), nullptr);
+		}
 
-		HRESULT hr = mSwapChain->Present(1, 0);
+		mFrameGameTime = &gameTime;
+		mFrameGraph.Execute(*mFrameGraphExecutor);
+		mFrameGameTime = nullptr;
 
 		// If the device was removed either by a disconnection or a driver upgrade, we must recreate all device resources.
-		if (hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET)
+		if (mPresentResult == DXGI_ERROR_DEVICE_REMOVED || mPresentResult == DXGI_ERROR_DEVICE_RESET)
 		{
 			HandleDeviceLost();
 		}
 		else
 		{
-			ThrowIfFailed(hr, "IDXGISwapChain::Present() failed.");
+			ThrowIfFailed(mPresentResult, "IDXGISwapChain::Present() failed.");
 		}
 	}
 
 	void RenderingGame::Shutdown()
 	{
-		SamplerStates::Shutdown();
-		RasterizerStates::Shutdown();
+		WriteFrameStatistics();
 	}
 
 	void RenderingGame::Exit()
 	{
 		PostQuitMessage(0);
 	}
+
+	void RenderingGame::EnableBenchmark(uint32_t frameCount)
+	{
+		assert(frameCount > 0);
+
+		mBenchmarkFrameCount = frameCount;
+		mSyncInterval = 0;
+		mGameClock.SetFixedTimeStep(BenchmarkTimeStep);
+	}
+
+	void RenderingGame::DisablePipelinedSimulation()
+	{
+		mPipelinedSimulation = false;
+	}
+
+	void RenderingGame::HandleDeviceLost()
+	{
+		// The executor's transient textures belong to the lost device.
+		mFrameGraphExecutor = nullptr;
+
+		Game::HandleDeviceLost();
+
+		CreateFrameGraphExecutor();
+		BuildFrameGraph();
+	}
+
+	void RenderingGame::CreateFrameGraphExecutor()
+	{
+		if (mDeviceType == RenderDeviceType::Null)
+		{
+			mFrameGraphExecutor = make_unique<NullRenderGraphExecutor>();
+		}
+		else
+		{
+			mFrameGraphExecutor = make_unique<Direct3D11RenderGraphExecutor>(mDirect3DDevice.Get(), mDirect3DDeviceContext.Get(), mStateCache);
+		}
+	}
+
+	void RenderingGame::BuildFrameGraph()
+	{
+		mFrameGraph.Reset();
+		mFrameGraph.ReleaseTransientTextures();
+
+		uint32_t width = static_cast<uint32_t>(mRenderTargetSize.cx);
+		uint32_t height = static_cast<uint32_t>(mRenderTargetSize.cy);
+		mBackBuffer = mFrameGraph.ImportTexture("BackBuffer", TextureDescription(width, height, TextureFormat::R8G8B8A8UNorm), ResourceState::Present,
+			ClearValue(BackgroundColor.f[0], BackgroundColor.f[1], BackgroundColor.f[2], BackgroundColor.f[3]));
+		mDepthStencil = mFrameGraph.ImportTexture("DepthStencil", TextureDescription(width, height, TextureFormat::D24UNormS8UInt), ResourceState::DepthWrite, ClearValue::DepthStencil());
+
+		// The graph clears both targets before the scene, which draws every component through the render queue
+		mFrameGraph.AddPass("Scene", [this]()
+		{
+			BenchmarkPhaseScope drawScope(mBenchmark.get(), mDrawPhase);
+			Game::Draw(*mFrameGameTime);
+		}).Write(mBackBuffer).Write(mDepthStencil);
+
+		mFrameGraph.AddPass("Present", [this]()
+		{
+			PROFILE_SCOPE("IDXGISwapChain::Present");
+			BenchmarkPhaseScope presentScope(mBenchmark.get(), mPresentPhase);
+			mPresentResult = (mSwapChain != nullptr ? mSwapChain->Present(mSyncInterval, 0) : S_OK);
+		}).Read(mBackBuffer, ResourceState::Present).SetSideEffects();
+
+		mFrameGraph.Compile();
+	}
+
+	void RenderingGame::WriteFrameStatistics() const
+	{
+		const FrameStatistics& statistics = mFpsComponent->Statistics();
+
+		ofstream csvFile(FrameStatisticsCsvFilename);
+		statistics.WriteCsv(csvFile);
+
+		ofstream jsonFile(FrameStatisticsJsonFilename);
+		statistics.WriteJson(jsonFile);
+	}
+
+	void RenderingGame::WriteMemoryReport() const
+	{
+		ofstream file(MemoryReportFilename);
+		AllocationCounter::WriteReport(file);
+	}
+
+	void RenderingGame::WriteBenchmarkReport() const
+	{
+		ofstream file(BenchmarkReportFilename);
+		mBenchmark->WriteJson(file);
+	}
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 
 #include "Game.h"
-#include "RenderStateHelper.h"
+#include "RenderGraph.h"
+#include "CameraPath.h"
 #include <windows.h>
 #include <functional>
 
@@ -11,6 +12,9 @@ namespace Library
 	class MouseComponent;
 	class GamePadComponent;
 	class FpsComponent;
+	class HudComponent;
+	class RenderGraphExecutor;
+	class Benchmark;
 	class Camera;
 	class Grid;
 }
@@ -23,7 +27,7 @@ namespace Rendering
 	class RenderingGame final : public Library::Game
 	{
 	public:
-		RenderingGame(std::function<void*()> getWindowCallback, std::function<void(SIZE&)> getRenderTargetSizeCallback);
+		RenderingGame(std::function<void*()> getWindowCallback, std::function<void(SIZE&)> getRenderTargetSizeCallback, Library::RenderDeviceType deviceType = Library::RenderDeviceType::Direct3D11);
 
 		virtual void Initialize() override;
 		virtual void Update(const Library::GameTime& gameTime) override;
@@ -32,25 +36,63 @@ namespace Rendering
 
 		void Exit();
 
+		// Call before Initialize(). Runs the given number of frames (after a warm-up) without vsync, with a fixed time step and
+		// the camera on the benchmark path, first with pipelined and then with serial simulation, then writes Benchmark.json next
+		// to the executable and exits.
+		void EnableBenchmark(std::uint32_t frameCount);
+
+		// Call before Initialize(). Simulates the solar system on the main thread, between input and rendering, rather than a frame ahead on its own thread.
+		void DisablePipelinedSimulation();
+
+		static const std::uint32_t DefaultBenchmarkFrameCount;
+
+	protected:
+		virtual void HandleDeviceLost() override;
+
 	private:
-		float SunOrbitalVelocity = 0.0f;
-		float SunRotationalVelocity = 0.0f;
-		float SunAxialTilt = 0.0f;
+		void CreateFrameGraphExecutor();
+		void BuildFrameGraph();
+		void WriteFrameStatistics() const;
+		void WriteMemoryReport() const;
+		void WriteBenchmarkReport() const;
 
 		static const DirectX::XMVECTORF32 BackgroundColor;
 		static const float DistanceMultiplier;
 		static const float OrbitalPeriodMultipler;
+		static const std::string FrameStatisticsCsvFilename;
+		static const std::string FrameStatisticsJsonFilename;
+		static const std::string MemoryReportFilename;
+		static const std::uint32_t BenchmarkWarmupFrameCount;
+		static const std::chrono::nanoseconds BenchmarkTimeStep;
+		static const double MinGameTimeScale;
+		static const double MaxGameTimeScale;
+		static const std::string BenchmarkCameraPathFilename;
+		static const std::string BenchmarkReportFilename;
 		static const int NumberOfPlanets = 9;
 
-		Library::RenderStateHelper mRenderStateHelper;
 		std::shared_ptr<Library::KeyboardComponent> mKeyboard;
 		std::shared_ptr<Library::MouseComponent> mMouse;
 		std::shared_ptr<Library::GamePadComponent> mGamePad;
 		std::shared_ptr<Library::FpsComponent> mFpsComponent;
+		std::shared_ptr<Library::HudComponent> mHud;
 		std::shared_ptr<Library::Camera> mCamera;
 		std::shared_ptr<SolarSystem> mSolarSystem;
 
-		const std::wstring mSunTextureFilename = L"Content\\Textures\\SunComposite.dds";
-		const std::wstring mSunSpecularFilename = L"Content\\Textures\\MarsSpecularMap.png";
+		Library::RenderGraph mFrameGraph;
+		std::unique_ptr<Library::RenderGraphExecutor> mFrameGraphExecutor;
+		Library::RenderGraphResource mBackBuffer;
+		Library::RenderGraphResource mDepthStencil;
+		const Library::GameTime* mFrameGameTime;
+		HRESULT mPresentResult;
+		UINT mSyncInterval;
+		bool mPipelinedSimulation;
+
+		std::uint32_t mBenchmarkFrameCount;
+		std::unique_ptr<Library::Benchmark> mBenchmark;
+		Library::CameraPath mBenchmarkCameraPath;
+		std::chrono::nanoseconds mBenchmarkSegmentStartTime;
+		std::uint32_t mUpdatePhase;
+		std::uint32_t mDrawPhase;
+		std::uint32_t mPresentPhase;
 	};
 }
@@ -0,0 +1,175 @@
+#include "pch.h"
+#include "SceneEntities.h"
+
+using namespace std;
+using namespace Library;
+using namespace DirectX;
+
+namespace Rendering
+{
+	SceneSystems::SceneSystems(EntityWorld& world) :
+		mWorld(&world), mElapsedSeconds(0.0f)
+	{
+		// All three write transforms, so they run one after another; the chunks of each are split across the workers.
+		mScheduler.AddSystem("SceneSystems::UpdateOrbits", 0, EntityWorld::MaskOf<OrbitComponent, TransformComponent>(), [this](const EntityChunk& chunk) { UpdateOrbits(chunk); });
+		mScheduler.AddSystem("SceneSystems::FollowParents", EntityWorld::MaskOf<ParentComponent>(), EntityWorld::MaskOf<TransformComponent>(), [this](const EntityChunk& chunk) { FollowParents(chunk); });
+		mScheduler.AddSystem("SceneSystems::FollowLights", EntityWorld::MaskOf<LightProxyComponent>(), EntityWorld::MaskOf<TransformComponent>(), [this](const EntityChunk& chunk) { FollowLights(chunk); });
+	}
+
+	void SceneSystems::Update(float elapsedSeconds, ThreadPool& workers)
+	{
+		mElapsedSeconds = elapsedSeconds;
+		mScheduler.Run(*mWorld, workers, mCommands);
+	}
+
+	EntityCommandBuffer& SceneSystems::Commands()
+	{
+		return mCommands;
+	}
+
+	Entity SceneSystems::CreateCelestialBody(EntityWorld& world, float orbitalDistance, float scale, float orbitalPeriod, float rotationalPeriod, float axialTilt, Entity parent)
+	{
+		TransformComponent transform;
+		XMStoreFloat4x4(&transform.LocalMatrix, XMMatrixIdentity());
+		transform.WorldMatrix = transform.LocalMatrix;
+
+		const OrbitComponent orbit = Orbit(orbitalDistance, scale, orbitalPeriod, rotationalPeriod, axialTilt);
+
+		return (parent.IsNull() ? world.CreateEntity(orbit, transform) : world.CreateEntity(orbit, transform, ParentComponent{ parent }));
+	}
+
+	Entity SceneSystems::CreatePointLight(EntityWorld& world, const XMFLOAT3& position, const XMFLOAT4& color, float radius)
+	{
+		TransformComponent transform;
+		XMStoreFloat4x4(&transform.LocalMatrix, XMMatrixTranslation(position.x, position.y, position.z));
+		transform.WorldMatrix = transform.LocalMatrix;
+
+		return world.CreateEntity(PointLightComponent{ color, radius }, transform);
+	}
+
+	Entity SceneSystems::CreateLightProxy(EntityWorld& world, Entity light, float scale)
+	{
+		TransformComponent transform;
+		XMStoreFloat4x4(&transform.LocalMatrix, XMMatrixScaling(scale, scale, scale));
+		transform.WorldMatrix = transform.LocalMatrix;
+
+		return world.CreateEntity(LightProxyComponent{ light }, transform);
+	}
+
+	OrbitComponent SceneSystems::Orbit(float orbitalDistance, float scale, float orbitalPeriod, float rotationalPeriod, float axialTilt)
+	{
+		OrbitComponent orbit;
+		orbit.OrbitalDistance = orbitalDistance;
+		orbit.Scale = scale;
+		orbit.OrbitalPeriod = orbitalPeriod;
+		orbit.RotationalPeriod = rotationalPeriod;
+		orbit.AxialTilt = axialTilt;
+		orbit.AxialDisplacement = 0.0f;
+		orbit.OrbitalDisplacement = 0.0f;
+		orbit.OrbitalSpeedFactor = SolarSystemBodies::OrbitalSpeedFactor;
+		orbit.RotationalSpeedFactor = SolarSystemBodies::RotationalSpeedFactor;
+		orbit.Center = Vector3Helper::Zero;
+
+		return orbit;
+	}
+
+	void SceneSystems::UpdateOrbits(const EntityChunk& chunk) const
+	{
+		OrbitComponent* orbits = chunk.Components<OrbitComponent>();
+		TransformComponent* transforms = chunk.Components<TransformComponent>();
+
+		// The same transform chain as SolarSystemBodies::LocalTransform(), placed about the orbit's center:
+		// scaling * rotationY(axial) * rotationZ(tilt) * translation(0, 0, distance) * rotationY(orbital) is a scaling, the
+		// rotation of the three rotations' product and the orbital rotation of (0, 0, distance). TransformKernels composes a
+		// batch of those at a time.
+		float scales[OrbitBatchSize];
+		float rotationX[OrbitBatchSize];
+		float rotationY[OrbitBatchSize];
+		float rotationZ[OrbitBatchSize];
+		float rotationW[OrbitBatchSize];
+		float translationX[OrbitBatchSize];
+		float translationY[OrbitBatchSize];
+		float translationZ[OrbitBatchSize];
+		float worldX[OrbitBatchSize];
+		float worldY[OrbitBatchSize];
+		float worldZ[OrbitBatchSize];
+
+		for (uint32_t first = 0; first < chunk.Count(); first += OrbitBatchSize)
+		{
+			uint32_t count = chunk.Count() - first;
+			if (count > OrbitBatchSize)
+			{
+				count = OrbitBatchSize;
+			}
+
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				OrbitComponent& orbit = orbits[first + i];
+				orbit.AxialDisplacement += mElapsedSeconds * (1 / orbit.RotationalPeriod) * orbit.RotationalSpeedFactor;
+				orbit.OrbitalDisplacement += mElapsedSeconds * (1 / orbit.OrbitalPeriod) * orbit.OrbitalSpeedFactor;
+
+				float axialSine;
+				float axialCosine;
+				float tiltSine;
+				float tiltCosine;
+				float orbitalSine;
+				float orbitalCosine;
+				XMScalarSinCos(&axialSine, &axialCosine, orbit.AxialDisplacement * 0.5f);
+				XMScalarSinCos(&tiltSine, &tiltCosine, orbit.AxialTilt * 0.5f);
+				XMScalarSinCos(&orbitalSine, &orbitalCosine, orbit.OrbitalDisplacement * 0.5f);
+
+				XMFLOAT4 rotation;
+				XMStoreFloat4(&rotation, XMQuaternionMultiply(XMQuaternionMultiply(XMVectorSet(0.0f, axialSine, 0.0f, axialCosine), XMVectorSet(0.0f, 0.0f, tiltSine, tiltCosine)),
+					XMVectorSet(0.0f, orbitalSine, 0.0f, orbitalCosine)));
+
+				scales[i] = orbit.Scale;
+				rotationX[i] = rotation.x;
+				rotationY[i] = rotation.y;
+				rotationZ[i] = rotation.z;
+				rotationW[i] = rotation.w;
+				translationX[i] = orbit.OrbitalDistance * 2.0f * orbitalSine * orbitalCosine;
+				translationY[i] = 0.0f;
+				translationZ[i] = orbit.OrbitalDistance * (orbitalCosine * orbitalCosine - orbitalSine * orbitalSine);
+				worldX[i] = translationX[i] + orbit.Center.x;
+				worldY[i] = orbit.Center.y;
+				worldZ[i] = translationZ[i] + orbit.Center.z;
+			}
+
+			const TrsArrays local = { scales, scales, scales, rotationX, rotationY, rotationZ, rotationW, translationX, translationY, translationZ };
+			const TrsArrays world = { scales, scales, scales, rotationX, rotationY, rotationZ, rotationW, worldX, worldY, worldZ };
+			TransformKernels::ComposeTrs(local, MatrixArray(&transforms[first].LocalMatrix, sizeof(TransformComponent)), count);
+			TransformKernels::ComposeTrs(world, MatrixArray(&transforms[first].WorldMatrix, sizeof(TransformComponent)), count);
+		}
+	}
+
+	void SceneSystems::FollowParents(const EntityChunk& chunk) const
+	{
+		const ParentComponent* parents = chunk.Components<ParentComponent>();
+		TransformComponent* transforms = chunk.Components<TransformComponent>();
+
+		for (uint32_t i = 0; i < chunk.Count(); ++i)
+		{
+			const TransformComponent* parentTransform = mWorld->GetComponent<TransformComponent>(parents[i].Parent);
+			if (parentTransform != nullptr)
+			{
+				XMStoreFloat4x4(&transforms[i].WorldMatrix, XMLoadFloat4x4(&transforms[i].LocalMatrix) * XMLoadFloat4x4(&parentTransform->WorldMatrix));
+			}
+		}
+	}
+
+	void SceneSystems::FollowLights(const EntityChunk& chunk) const
+	{
+		const LightProxyComponent* proxies = chunk.Components<LightProxyComponent>();
+		TransformComponent* transforms = chunk.Components<TransformComponent>();
+
+		for (uint32_t i = 0; i < chunk.Count(); ++i)
+		{
+			const TransformComponent* lightTransform = mWorld->GetComponent<TransformComponent>(proxies[i].Light);
+			if (lightTransform != nullptr)
+			{
+				const XMFLOAT4X4& lightMatrix = lightTransform->WorldMatrix;
+				XMStoreFloat4x4(&transforms[i].WorldMatrix, XMLoadFloat4x4(&transforms[i].LocalMatrix) * XMMatrixTranslation(lightMatrix._41, lightMatrix._42, lightMatrix._43));
+			}
+		}
+	}
+}
\ No newline at end of file
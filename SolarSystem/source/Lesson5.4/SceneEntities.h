@@ -0,0 +1,99 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include "EntityWorld.h"
+#include "EntityCommandBuffer.h"
+#include "EntitySystemScheduler.h"
+
+namespace Library
+{
+	class ThreadPool;
+}
+
+namespace Rendering
+{
+	// The components that describe the scene's objects as entities. A celestial body is an OrbitComponent and a
+	// TransformComponent, plus a ParentComponent for a moon; a point light is a PointLightComponent and a TransformComponent;
+	// a light's proxy model is a LightProxyComponent and a TransformComponent. Anything drawn through the render queue also
+	// carries a RenderStateComponent.
+	struct OrbitComponent
+	{
+		float OrbitalDistance;
+		float Scale;
+		float OrbitalPeriod;
+		float RotationalPeriod;
+		float AxialTilt;
+		float AxialDisplacement;
+		float OrbitalDisplacement;
+		float OrbitalSpeedFactor;
+		float RotationalSpeedFactor;
+		DirectX::XMFLOAT3 Center;
+	};
+
+	struct TransformComponent
+	{
+		DirectX::XMFLOAT4X4 LocalMatrix;
+		DirectX::XMFLOAT4X4 WorldMatrix;
+	};
+
+	// Moons follow their planet. Only one level is resolved: a parent must not itself have a parent.
+	struct ParentComponent
+	{
+		Library::Entity Parent;
+	};
+
+	struct PointLightComponent
+	{
+		DirectX::XMFLOAT4 Color;
+		float Radius;
+	};
+
+	struct LightProxyComponent
+	{
+		Library::Entity Light;
+	};
+
+	// Render queue ids (see RenderQueue::RegisterPipelineState() and RegisterTextures()).
+	struct RenderStateComponent
+	{
+		std::uint32_t PipelineState;
+		std::uint32_t Textures;
+	};
+
+	// Creates scene entities and moves them each frame: bodies orbit, moons follow their planets and proxies follow their
+	// lights. The systems run on the game's worker threads.
+	class SceneSystems final
+	{
+	public:
+		explicit SceneSystems(Library::EntityWorld& world);
+		SceneSystems(const SceneSystems&) = delete;
+		SceneSystems& operator=(const SceneSystems&) = delete;
+		SceneSystems(SceneSystems&&) = delete;
+		SceneSystems& operator=(SceneSystems&&) = delete;
+		~SceneSystems() = default;
+
+		void Update(float elapsedSeconds, Library::ThreadPool& workers);
+
+		// For structural changes requested while the systems run; played back at the end of Update().
+		Library::EntityCommandBuffer& Commands();
+
+		static Library::Entity CreateCelestialBody(Library::EntityWorld& world, float orbitalDistance, float scale, float orbitalPeriod, float rotationalPeriod, float axialTilt, Library::Entity parent = Library::Entity());
+		static Library::Entity CreatePointLight(Library::EntityWorld& world, const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT4& color, float radius);
+		static Library::Entity CreateLightProxy(Library::EntityWorld& world, Library::Entity light, float scale);
+
+		static OrbitComponent Orbit(float orbitalDistance, float scale, float orbitalPeriod, float rotationalPeriod, float axialTilt);
+
+	private:
+		void UpdateOrbits(const Library::EntityChunk& chunk) const;
+		void FollowParents(const Library::EntityChunk& chunk) const;
+		void FollowLights(const Library::EntityChunk& chunk) const;
+
+		// Orbits are composed this many at a time from arrays on the stack.
+		static const std::uint32_t OrbitBatchSize = 64;
+
+		Library::EntityWorld* mWorld;
+		Library::EntitySystemScheduler mScheduler;
+		Library::EntityCommandBuffer mCommands;
+		float mElapsedSeconds;
+	};
+}
\ No newline at end of file
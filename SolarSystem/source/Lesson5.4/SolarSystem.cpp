@@ -10,139 +10,235 @@ namespace Rendering
 
 	const float SolarSystem::LightModulationRate = UCHAR_MAX;
 	const float SolarSystem::LightMovementRate = 10.0f;
-	const float SolarSystem::SunAmbientColor = 0.8f;
-	const float SolarSystem::PlanetAmbientColor = 0.0f;
-	const float SolarSystem::DistanceMultiplier = 50.0f;
+	const string SolarSystem::ProfilerTraceFilename = "Profile.json";
+	const string SolarSystem::ProfilerBinaryFilename = "Profile.bin";
 	const float SolarSystem::SpeedFactor = .1f;
 
 	SolarSystem::SolarSystem(Game & game, const shared_ptr<Camera>& camera, float orbitRadius, float scale, float orbPer, float rotPer, float axTilt, wstring texFilename, wstring specFilename) :
-		DrawableGameComponent(game, camera), mWorldMatrix(MatrixHelper::Identity), mPointLight(game, XMFLOAT3(0.0f, 0.0f, 0.0f), 100000.0f), mRenderStateHelper(game), mIndexCount(0), 
-		mTextPosition(0.0f, 40.0f), mAnimationEnabled(false), mOrbitalDistance(orbitRadius), mTextureFilename(texFilename), mSpecularFilename(specFilename), mScale(scale), 
-		mOrbitalPeriod(orbPer), mRotationalPeriod(rotPer), mAxialAngle(0.0f), mOrbitalAngle(0.0f), mAxialTilt(axTilt)
+		DrawableGameComponent(game, camera), mWorldMatrix(MatrixHelper::Identity), mPointLight(game, XMFLOAT3(0.0f, 0.0f, 0.0f), 100000.0f), mProxyModelRadius(0.0f),
+		mHud(nullptr), mHelpLabel(0), mStatisticsLabel(0), mTextPosition(0.0f, 40.0f), mAnimationEnabled(false), mOrbitalDistance(orbitRadius), mTextureFilename(texFilename), mSpecularFilename(specFilename), mScale(scale), 
+		mOrbitalPeriod(orbPer), mRotationalPeriod(rotPer), mAxialAngle(0.0f), mOrbitalAngle(0.0f), mAxialTilt(axTilt),
+		mSimulation([this](const SimulationInput& input, SimulationFrame& frame) { Simulate(input, frame); })
 	{
+		for (XMFLOAT4X4& worldMatrix : mFrameWorldMatrices)
+		{
+			worldMatrix = MatrixHelper::Identity;
+		}
+	}
 
+	SolarSystem::SimulationFrame::SimulationFrame() :
+		LightPosition(Vector3Helper::Zero), UpdatedCount(0), DeferredCount(0), AnimationEnabled(false)
+	{
+		for (XMFLOAT4X4& worldMatrix : WorldMatrices)
+		{
+			worldMatrix = MatrixHelper::Identity;
+		}
 	}
 
 	bool SolarSystem::AnimationEnabled() const
 	{
-		return mAnimationEnabled;
+		return mSimulation.CurrentFrame().AnimationEnabled;
 	}
 
-	void SolarSystem::SetAnimationEnabled(bool enabled)
+	bool SolarSystem::SimulationPipelined() const
 	{
-		mAnimationEnabled = enabled;
+		return mSimulation.IsRunning();
 	}
 
-	void SolarSystem::Initialize()
+	void SolarSystem::SetSimulationPipelined(bool pipelined)
 	{
-		// Load a compiled vertex shader
-		vector<char> compiledVertexShader;
-		Utility::LoadBinaryFile(L"Content\\Shaders\\PointLightDemoVS.cso", compiledVertexShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateVertexShader(&compiledVertexShader[0], compiledVertexShader.size(), nullptr, mVertexShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedVertexShader() failed.");
-
-		// Load a compiled pixel shader
-		vector<char> compiledPixelShader;
-		Utility::LoadBinaryFile(L"Content\\Shaders\\PointLightDemoPS.cso", compiledPixelShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreatePixelShader(&compiledPixelShader[0], compiledPixelShader.size(), nullptr, mPixelShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
-
-		// Create an input layout
-		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
+		if (pipelined)
 		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-			{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-		};
-
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateInputLayout(inputElementDescriptions, ARRAYSIZE(inputElementDescriptions), &compiledVertexShader[0], compiledVertexShader.size(), mInputLayout.ReleaseAndGetAddressOf()), "ID3D11Device::CreateInputLayout() failed.");
+			mSimulation.Start();
+		}
+		else
+		{
+			mSimulation.Stop();
+		}
+	}
 
+	void SolarSystem::Initialize()
+	{
 		// Load the model
 		Library::Model model("Content\\Models\\Sphere.obj.bin");
-
-		// Create vertex and index buffers for the model
 		Library::Mesh* mesh = model.Meshes().at(0).get();
-		CreateVertexBuffer(*mesh, mVertexBuffer.ReleaseAndGetAddressOf());
-		mesh->CreateIndexBuffer(*mGame->Direct3DDevice(), mIndexBuffer.ReleaseAndGetAddressOf());
-		mIndexCount = static_cast<uint32_t>(mesh->Indices().size());
-
-		// Create constant buffers
-		D3D11_BUFFER_DESC constantBufferDesc = { 0 };
-		constantBufferDesc.ByteWidth = sizeof(VSCBufferPerFrame);
-		constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mVSCBufferPerFrame.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
-
-		constantBufferDesc.ByteWidth = sizeof(VSCBufferPerObject);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mVSCBufferPerObject.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
-
-		constantBufferDesc.ByteWidth = sizeof(PSCBufferPerFrame);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mPSCBufferPerFrame.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
 
-		constantBufferDesc.ByteWidth = sizeof(PSCBufferPerObject);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mPSCBufferPerObject.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+		// Retrieve the keyboard and HUD services
+		mKeyboard = mGame->Services().GetService<KeyboardComponent>();
+		mHud = mGame->Services().GetService<HudComponent>();
+		assert(mHud != nullptr);
 
-		// Load textures for the color and specular maps
-		ThrowIfFailed(CreateDDSTextureFromFile(mGame->Direct3DDevice(), mTextureFilename.c_str(), nullptr, mColorTexture.ReleaseAndGetAddressOf()), "CreateDDSTextureFromFile() failed.");
-		ThrowIfFailed(CreateWICTextureFromFile(mGame->Direct3DDevice(), mSpecularFilename.c_str(), nullptr, mSpecularMap.ReleaseAndGetAddressOf()), "CreateWICTextureFromFile() failed.");
-
-		// Create text rendering helpers
-		mSpriteBatch = make_unique<SpriteBatch>(mGame->Direct3DDeviceContext());
-		mSpriteFont = make_unique<SpriteFont>(mGame->Direct3DDevice(), L"Content\\Fonts\\Arial_14_Regular.spritefont");
-
-		// Retrieve the keyboard service
-		mKeyboard = reinterpret_cast<KeyboardComponent*>(mGame->Services().GetService(KeyboardComponent::TypeIdClass()));
+		// The help text only changes with the profiler's state; the statistics below it change every frame
+		mHelpLabel = mHud->CreateLabel(mTextPosition);
+		mStatisticsLabel = mHud->CreateLabel(mTextPosition);
+		UpdateHelpText();
 		
-		// Setup the point light
-		mVSCBufferPerFrameData.LightPosition = mPointLight.Position();
-		mVSCBufferPerFrameData.LightRadius = mPointLight.Radius();
-		mPSCBufferPerFrameData.LightPosition = mPointLight.Position();
-		mPSCBufferPerFrameData.LightColor = ColorHelper::ToFloat3(mPointLight.Color(), true);
-
-		// Update the vertex and pixel shader constant buffers
-		mGame->Direct3DDeviceContext()->UpdateSubresource(mVSCBufferPerFrame.Get(), 0, nullptr, &mVSCBufferPerFrameData, 0, 0);
-		mGame->Direct3DDeviceContext()->UpdateSubresource(mPSCBufferPerObject.Get(), 0, nullptr, &mPSCBufferPerObjectData, 0, 0);
-
 		// Load a proxy model for the point light
 		mProxyModel = make_unique<ProxyModel>(*mGame, mCamera, "Content\\Models\\Sphere.obj.bin", 1.0f);
 		mProxyModel->Initialize();
 		mProxyModel->SetPosition(mPointLight.Position());
+		mProxyModelRadius = mesh->Bounds().Radius;
 
-		// Initializing celestial body data for each of the planets & Earth's moon
-		mCelestialBodyDataList.push_back(make_shared<CelestialBodyData>(Mercury));
-		mCelestialBodyDataList.push_back(make_shared<CelestialBodyData>(Venus));
-		mCelestialBodyDataList.push_back(make_shared<CelestialBodyData>(Earth));
-		mCelestialBodyDataList.push_back(make_shared<CelestialBodyData>(Mars));
-		mCelestialBodyDataList.push_back(make_shared<CelestialBodyData>(Jupiter));
-		mCelestialBodyDataList.push_back(make_shared<CelestialBodyData>(Saturn));
-		mCelestialBodyDataList.push_back(make_shared<CelestialBodyData>(Uranus));
-		mCelestialBodyDataList.push_back(make_shared<CelestialBodyData>(Neptune));
-		mCelestialBodyDataList.push_back(make_shared<CelestialBodyData>(Pluto));
-		mCelestialBodyDataList.push_back(make_shared<CelestialBodyData>(Moon));
-
+		// The planets and Earth's moon; a parent precedes its satellites, so it has been created by the time they are
 		mCelestialBodies.resize(NumCelestialBodies);
 
 		for (int i = 0; i < NumCelestialBodies; ++i)
 		{
-			if (i == NumCelestialBodies - 1)
+			const CelestialBodyDescription& description = SolarSystemBodies::Bodies[i];
+			shared_ptr<CelestialBodies> parent;
+			if (description.ParentIndex >= 0)
 			{
-				mCelestialBodies[i] = make_shared<CelestialBodies>(*mGame, mCamera, mCelestialBodyDataList[i]->OrbitRadius * DistanceMultiplier, mCelestialBodyDataList[i]->Scale,
-					mCelestialBodyDataList[i]->OrbitalPeriod, mCelestialBodyDataList[i]->RotationalPeriod, mCelestialBodyDataList[i]->AxialTilt,
-					mCelestialBodyDataList[i]->TextureFilename, mCelestialBodyDataList[i]->SpecularFilename, mVSCBufferPerFrame, mVSCBufferPerObject, mCelestialBodies[EarthIndex]);
-			}
-			else
-			{
-				mCelestialBodies[i] = make_shared<CelestialBodies>(*mGame, mCamera, mCelestialBodyDataList[i]->OrbitRadius * DistanceMultiplier, mCelestialBodyDataList[i]->Scale,
-					mCelestialBodyDataList[i]->OrbitalPeriod, mCelestialBodyDataList[i]->RotationalPeriod, mCelestialBodyDataList[i]->AxialTilt,
-					mCelestialBodyDataList[i]->TextureFilename, mCelestialBodyDataList[i]->SpecularFilename, mVSCBufferPerFrame, mVSCBufferPerObject);
+				parent = mCelestialBodies[description.ParentIndex];
 			}
+
+			mCelestialBodies[i] = make_shared<CelestialBodies>(*mGame, mCamera, description.OrbitRadius * SolarSystemBodies::DistanceMultiplier, description.Scale,
+				description.OrbitalPeriod, description.RotationalPeriod, description.AxialTilt, TexturePath(description.TextureFilename),
+				TexturePath(SolarSystemBodies::SpecularFilename), parent);
 		}
 
 		for (int i = 0; i < NumCelestialBodies; ++i)
 		{
 			mCelestialBodies[i]->Initialize();
+			mUpdateScheduler.Register(*mCelestialBodies[i]);
+		}
+
+		// Every body, the sun included, shares the sphere mesh and is drawn as one instanced batch
+		mCelestialBodyRenderer = make_unique<CelestialBodyRenderer>(*mGame, mCamera);
+		uint32_t sphereMeshIndex = mCelestialBodyRenderer->AddMesh(*mesh);
+		mCelestialBodyRenderer->AddInstance(mFrameWorldMatrices[0], sphereMeshIndex, mCelestialBodyRenderer->AddMaterial(mTextureFilename, mSpecularFilename), SolarSystemBodies::SunAmbientColor);
+
+		for (int i = 0; i < NumCelestialBodies; ++i)
+		{
+			uint32_t materialIndex = mCelestialBodyRenderer->AddMaterial(TexturePath(SolarSystemBodies::Bodies[i].TextureFilename), TexturePath(SolarSystemBodies::SpecularFilename));
+			mCelestialBodyRenderer->AddInstance(mFrameWorldMatrices[i + 1], sphereMeshIndex, materialIndex, SolarSystemBodies::PlanetAmbientColor);
 		}
+
+		mCelestialBodyRenderer->Initialize();
+		mCelestialBodyRenderer->SetPointLight(mPointLight);
+
+		mStressScene = make_unique<StressScene>(*mGame, mCamera);
+		mStressScene->Initialize(*mesh);
+		mStressScene->SetPointLight(mPointLight);
+
+		mSimulation.Start();
 	}
 
 	void SolarSystem::Update(const GameTime& gameTime)
 	{
+		// Input is sampled here, on the main thread; the simulation only ever sees these copies.
+		SimulationInput input;
+		input.GameTime = gameTime;
+		input.CameraPosition = mCamera->Position();
+		input.ProjectionScale = UpdateScheduler::ProjectionScale(mCamera->ProjectionMatrix(), mGame->Viewport().Height);
+
+		if (mKeyboard != nullptr)
+		{
+			input.Rewind = mKeyboard->IsKeyDown(Keys::B);
+			input.ToggleAnimation = mKeyboard->WasKeyPressedThisFrame(Keys::Space);
+			input.IncreaseSpeed = mKeyboard->WasKeyPressedThisFrame(Keys::R);
+			input.DecreaseSpeed = mKeyboard->WasKeyPressedThisFrame(Keys::E);
+
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::L))
+			{
+				SetSimulationPipelined(SimulationPipelined() == false);
+				UpdateHelpText();
+			}
+
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::T))
+			{
+				mStressScene->SetEnabled(!mStressScene->Enabled());
+			}
+
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::M))
+			{
+				RenderQueue& drawQueue = mGame->DrawQueue();
+				drawQueue.SetMultithreadedRecording(!drawQueue.MultithreadedRecording());
+			}
+
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::O))
+			{
+				mCelestialBodyRenderer->SetOcclusionCullingEnabled(!mCelestialBodyRenderer->OcclusionCullingEnabled());
+			}
+
+			if (mKeyboard->WasKeyPressedThisFrame(Keys::P))
+			{
+				ToggleProfilerCapture();
+				UpdateHelpText();
+			}
+		}
+
+		mProxyModel->Update(gameTime);
+		mStressScene->Update(gameTime);
+
+		// While pipelined this is the frame simulated from the previous input, and this input is simulated during Draw().
+		ApplyFrame(mSimulation.Exchange(input));
+
+		mCelestialBodyRenderer->BeginPacking();
+	}
+
+	void SolarSystem::Draw(const GameTime& gameTime)
+	{
+		assert(mCamera != nullptr);
+
+		mCelestialBodyRenderer->Draw();
+		mStressScene->Draw();
+
+		// Skip the light's proxy while a body hides it
+		if (mCelestialBodyRenderer->IsOccluded(mProxyModel->Position(), mProxyModelRadius) == false)
+		{
+			mProxyModel->Draw(gameTime);
+		}
+
+		UpdateStatisticsText();
+	}
+
+	void SolarSystem::SaveSnapshot(OutputStreamHelper& streamHelper) const
+	{
+		streamHelper << mAxialAngle << mOrbitalAngle;
+		streamHelper << mAnimationEnabled;
+		streamHelper << mWorldMatrix;
+
+		streamHelper << static_cast<uint32_t>(mCelestialBodies.size());
+		for (const auto& celestialBody : mCelestialBodies)
+		{
+			celestialBody->SaveSnapshot(streamHelper);
+		}
+
+		mUpdateScheduler.SaveSnapshot(streamHelper);
+	}
+
+	void SolarSystem::LoadSnapshot(InputStreamHelper& streamHelper)
+	{
+		streamHelper >> mAxialAngle >> mOrbitalAngle;
+		streamHelper >> mAnimationEnabled;
+		streamHelper >> mWorldMatrix;
+
+		uint32_t celestialBodyCount;
+		streamHelper >> celestialBodyCount;
+		assert(celestialBodyCount == mCelestialBodies.size());
+		for (auto& celestialBody : mCelestialBodies)
+		{
+			celestialBody->LoadSnapshot(streamHelper);
+		}
+
+		mUpdateScheduler.LoadSnapshot(streamHelper);
+	}
+
+	const SnapshotBuffer& SolarSystem::Snapshots() const
+	{
+		return mSnapshots;
+	}
+
+	wstring SolarSystem::TexturePath(const char* filename)
+	{
+		return L"Content\\Textures\\" + Utility::ToWideString(filename);
+	}
+
+	void SolarSystem::Simulate(const SimulationInput& input, SimulationFrame& frame)
+	{
+		PROFILE_SCOPE("SolarSystem::Simulate");
+		MemoryTagScope memoryTagScope(MemoryTag::Simulation);
+
 		static float angle = 0.0f;
 
 		XMMATRIX matTrans;
@@ -151,10 +247,18 @@ namespace Rendering
 		XMMATRIX matOrbitalRot;
 		XMMATRIX matAxialTilt;
 
-		if (mAnimationEnabled)
+		if (input.Rewind)
 		{
-			mAxialAngle += gameTime.ElapsedGameTimeSeconds().count() * mRotationalPeriod;
-			mOrbitalAngle += gameTime.ElapsedGameTimeSeconds().count() * mOrbitalPeriod;
+			// Step back one captured frame per rendered frame while the key is held.
+			if (mSnapshots.Size() > 1 && mSnapshots.CanRestore(mSnapshots.NewestFrame() - 1))
+			{
+				mSnapshots.Rewind(mSnapshots.NewestFrame() - 1, *this);
+			}
+		}
+		else if (mAnimationEnabled)
+		{
+			mAxialAngle += input.GameTime.ElapsedGameTimeSeconds().count() * mRotationalPeriod;
+			mOrbitalAngle += input.GameTime.ElapsedGameTimeSeconds().count() * mOrbitalPeriod;
 
 			matScale = XMMatrixScaling(mScale, mScale, mScale);
 			matAxialRot = XMMatrixRotationY(mAxialAngle);
@@ -164,121 +268,154 @@ namespace Rendering
 			XMStoreFloat4x4(&mWorldMatrix, (matScale * matAxialRot * matAxialTilt * matTrans * matOrbitalRot));
 		}
 
-		if (mKeyboard != nullptr)
+		if (input.ToggleAnimation)
+		{
+			mAnimationEnabled = !mAnimationEnabled;
+		}
+
+		for (int i = 0; i < NumCelestialBodies; ++i)
 		{
-			if (mKeyboard->WasKeyPressedThisFrame(Keys::Space))
+			if (input.ToggleAnimation)
 			{
-				ToggleAnimation();
+				mCelestialBodies[i]->ToggleAnimation();
+			}
+
+			if (input.IncreaseSpeed)
+			{
+				mCelestialBodies[i]->IncreaseSpeed();
+			}
+
+			if (input.DecreaseSpeed)
+			{
+				mCelestialBodies[i]->DecreaseSpeed();
 			}
 		}
 
-		mProxyModel->Update(gameTime);
+		if (input.Rewind == false)
+		{
+			mUpdateScheduler.Update(input.GameTime, XMLoadFloat3(&input.CameraPosition), input.ProjectionScale);
+			mSnapshots.Capture(mSnapshots.IsEmpty() ? 0 : mSnapshots.NewestFrame() + 1, *this);
+		}
 
+		frame.WorldMatrices[0] = mWorldMatrix;
 		for (int i = 0; i < NumCelestialBodies; ++i)
 		{
-			mCelestialBodies[i]->Update(gameTime);
+			frame.WorldMatrices[i + 1] = mCelestialBodies[i]->WorldMatrix();
 		}
+
+		// The light sits at the sun's center
+		frame.LightPosition = XMFLOAT3(mWorldMatrix._41, mWorldMatrix._42, mWorldMatrix._43);
+		frame.UpdatedCount = mUpdateScheduler.UpdatedCount();
+		frame.DeferredCount = mUpdateScheduler.DeferredCount();
+		frame.AnimationEnabled = mAnimationEnabled;
 	}
 
-	void SolarSystem::Draw(const GameTime& gameTime)
+	void SolarSystem::ApplyFrame(const SimulationFrame& frame)
 	{
-		mPSCBufferPerFrameData.AmbientColor = XMFLOAT3(SunAmbientColor, SunAmbientColor, SunAmbientColor);
-		mGame->Direct3DDeviceContext()->UpdateSubresource(mPSCBufferPerFrame.Get(), 0, nullptr, &mPSCBufferPerFrameData, 0, 0);
-
-		UNREFERENCED_PARAMETER(gameTime);
-		assert(mCamera != nullptr);
-
-		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
-		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		direct3DDeviceContext->IASetInputLayout(mInputLayout.Get());
-
-		UINT stride = sizeof(VertexPositionTextureNormal);
-		UINT offset = 0;
-		direct3DDeviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
-		direct3DDeviceContext->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
-
-		direct3DDeviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
-		direct3DDeviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
-
-		XMMATRIX worldMatrix = XMLoadFloat4x4(&mWorldMatrix);
-		XMMATRIX wvp = worldMatrix * mCamera->ViewProjectionMatrix();
-
-		wvp = XMMatrixTranspose(wvp);
+		copy(begin(frame.WorldMatrices), end(frame.WorldMatrices), begin(mFrameWorldMatrices));
 
-		XMStoreFloat4x4(&mVSCBufferPerObjectData.WorldViewProjection, wvp);
-		XMStoreFloat4x4(&mVSCBufferPerObjectData.World, XMMatrixTranspose(worldMatrix));
-
-		direct3DDeviceContext->UpdateSubresource(mVSCBufferPerObject.Get(), 0, nullptr, &mVSCBufferPerObjectData, 0, 0);
-
-		ID3D11Buffer* VSConstantBuffers[] = { mVSCBufferPerFrame.Get(), mVSCBufferPerObject.Get() };
-		direct3DDeviceContext->VSSetConstantBuffers(0, ARRAYSIZE(VSConstantBuffers), VSConstantBuffers);
-
-		mPSCBufferPerFrameData.CameraPosition = mCamera->Position();
-		direct3DDeviceContext->UpdateSubresource(mPSCBufferPerFrame.Get(), 0, nullptr, &mPSCBufferPerFrameData, 0, 0);
+		const XMFLOAT3& lightPosition = mPointLight.Position();
+		if (lightPosition.x != frame.LightPosition.x || lightPosition.y != frame.LightPosition.y || lightPosition.z != frame.LightPosition.z)
+		{
+			mPointLight.SetPosition(frame.LightPosition);
+			mProxyModel->SetPosition(frame.LightPosition);
+			mCelestialBodyRenderer->SetPointLight(mPointLight);
+			mStressScene->SetPointLight(mPointLight);
+		}
+	}
 
-		ID3D11Buffer* PSConstantBuffers[] = { mPSCBufferPerFrame.Get(), mPSCBufferPerObject.Get() };
-		direct3DDeviceContext->PSSetConstantBuffers(0, ARRAYSIZE(PSConstantBuffers), PSConstantBuffers);
+	void SolarSystem::ToggleProfilerCapture()
+	{
+		if (Profiler::IsEnabled() == false)
+		{
+			Profiler::Clear();
+			Profiler::SetEnabled(true);
+			return;
+		}
 
-		ID3D11ShaderResourceView* PSShaderResources[] = { mColorTexture.Get(), mSpecularMap.Get() };
-		direct3DDeviceContext->PSSetShaderResources(0, ARRAYSIZE(PSShaderResources), PSShaderResources);
-		direct3DDeviceContext->PSSetSamplers(0, 1, SamplerStates::TrilinearWrap.GetAddressOf());
+		Profiler::SetEnabled(false);
 
-		direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
+		ofstream traceFile(ProfilerTraceFilename);
+		Profiler::ExportChromeTrace(traceFile);
 
-		mProxyModel->Draw(gameTime);
+		ofstream binaryFile(ProfilerBinaryFilename, ios::binary);
+		Profiler::ExportBinary(binaryFile);
+	}
 
-		// Draw help text
-		mRenderStateHelper.SaveAll();
-		mSpriteBatch->Begin();
+	void SolarSystem::UpdateHelpText()
+	{
+		MemoryTagScope memoryTagScope(MemoryTag::UI);
 
 		wostringstream helpLabel;
 		helpLabel << L"Decrease/Increase Rotational & Orbital Velocities (E/R)" << "\n";
 		helpLabel << L"Reset Camera to Center of Solar System (Q)" << "\n";
 		helpLabel << L"Camera Controls (WASD + Left Mouse)" << "\n";
 		helpLabel << L"Toggle Animation (Space)" << "\n";
+		helpLabel << L"Rewind (Hold B)" << "\n";
+		helpLabel << L"Pause Game Time (Pause)" << "\n";
+		helpLabel << L"Slow Down/Speed Up Game Time (Page Down/Page Up)" << "\n";
+		helpLabel << (mSimulation.IsRunning() ? L"Simulate on the Main Thread (L)" : L"Simulate on a Separate Thread (L)") << "\n";
+		helpLabel << L"Toggle Stress Scene (T)" << "\n";
+		helpLabel << L"Toggle Multithreaded Recording (M)" << "\n";
+		helpLabel << L"Toggle Occlusion Culling (O)" << "\n";
+		helpLabel << L"Write Frame Statistics (F)" << "\n";
+		helpLabel << L"Write Memory Report (N)" << "\n";
+		helpLabel << (Profiler::IsEnabled() ? L"Stop Profiler Capture (P)" : L"Start Profiler Capture (P)") << "\n";
 		helpLabel << L"Exit (Esc)" << "\n";
-	
-		mSpriteFont->DrawString(mSpriteBatch.get(), helpLabel.str().c_str(), mTextPosition);
-		mSpriteBatch->End();
-		mRenderStateHelper.RestoreAll();
-
-		mPSCBufferPerFrameData.AmbientColor = XMFLOAT3(PlanetAmbientColor, PlanetAmbientColor, PlanetAmbientColor);
-		mGame->Direct3DDeviceContext()->UpdateSubresource(mPSCBufferPerFrame.Get(), 0, nullptr, &mPSCBufferPerFrameData, 0, 0);
-
-		for (int i = 0; i < NumCelestialBodies; ++i)
-		{
-			mCelestialBodies[i]->Draw(gameTime);
-		}
+		mHud->SetText(mHelpLabel, helpLabel.str());
 	}
 
-	void SolarSystem::CreateVertexBuffer(const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	void SolarSystem::UpdateStatisticsText()
 	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
-		const vector<XMFLOAT3>& sourceNormals = mesh.Normals();
-		const auto& sourceUVs = mesh.TextureCoordinates().at(0);
+		MemoryTagScope memoryTagScope(MemoryTag::UI);
 
-		vector<VertexPositionTextureNormal> vertices;
-		vertices.reserve(sourceVertices.size());
-		for (UINT i = 0; i < sourceVertices.size(); i++)
-		{
-			const XMFLOAT3& position = sourceVertices.at(i);
-			const XMFLOAT3& uv = sourceUVs->at(i);
-			const XMFLOAT3& normal = sourceNormals.at(i);
+		// Queue and HUD counters are from the previous frame; this frame's Execute() has not run yet.
+		const RenderQueue& drawQueue = mGame->DrawQueue();
 
-			vertices.push_back(VertexPositionTextureNormal(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y), normal));
+		// Rebuilt every frame, so the text lives in frame memory rather than on the heap
+		TextBuilder statisticsLabel(mGame->FrameMemory().ThreadResource(), 1024);
+		statisticsLabel << L"Visible Bodies: " << mCelestialBodyRenderer->VisibleInstanceCount() << L"/" << mCelestialBodyRenderer->InstanceCount() << "\n";
+		if (mCelestialBodyRenderer->OcclusionCullingEnabled())
+		{
+			const OcclusionCuller& occlusion = mCelestialBodyRenderer->Occlusion();
+			uint32_t occludedCount = mCelestialBodyRenderer->OccludedInstanceCount();
+			uint32_t testedCount = mCelestialBodyRenderer->VisibleInstanceCount() + occludedCount;
+			statisticsLabel << L"Occluded Bodies: " << occludedCount << L"/" << testedCount << L" (" << occlusion.OccluderCount() << L" occluders, raster " << TextBuilder::Fixed(1) << occlusion.RasterizationMicroseconds()
+				<< L" us, test " << mCelestialBodyRenderer->OcclusionTestMicroseconds() << L" us)" << "\n";
 		}
-		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
-		vertexBufferDesc.ByteWidth = sizeof(VertexPositionTextureNormal) * static_cast<UINT>(vertices.size());
-		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-		D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
-		vertexSubResourceData.pSysMem = &vertices[0];
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer), "ID3D11Device::CreateBuffer() failed.");
-	}
+		else
+		{
+			statisticsLabel << L"Occluded Bodies: off" << "\n";
+		}
+		statisticsLabel << L"State Changes: " << drawQueue.StateChangeCount() << L" (unsorted " << drawQueue.UnsortedStateChangeCount() << L")" << "\n";
+		statisticsLabel << L"Context Calls: " << drawQueue.IssuedCallCount() << L" (filtered " << drawQueue.FilteredCallCount() << L")" << "\n";
+		statisticsLabel << L"Draw Packets: " << drawQueue.PacketCount() << L", Recording: " << (drawQueue.MultithreadedRecording() ? L"Deferred" : (drawQueue.SupportsCommandLists() ? L"Immediate" : L"Immediate (no driver command lists)")) << "\n";
+		const auto& partitionStatistics = drawQueue.PartitionStatistics();
+		for (size_t i = 0; i < partitionStatistics.size(); ++i)
+		{
+			statisticsLabel << L"  Partition " << i << L": " << partitionStatistics[i].PacketCount << L" packets, " << TextBuilder::Fixed(3) << partitionStatistics[i].RecordingMilliseconds << L" ms" << "\n";
+		}
+		statisticsLabel << L"Simulation: " << (mSimulation.IsRunning() ? L"Pipelined" : L"Serial") << L", " << TextBuilder::Fixed(3)
+			<< chrono::duration<double, milli>(mSimulation.LastSimulationTime()).count() << L" ms (render waited " << chrono::duration<double, milli>(mSimulation.LastWaitTime()).count() << L" ms), "
+			<< mSimulation.CurrentFrame().UpdatedCount << L" updated, " << mSimulation.CurrentFrame().DeferredCount << L" deferred" << "\n";
+		const Timeline& gameTimeline = mGame->Clock().GameTimeline();
+		statisticsLabel << L"Game Time: " << TextBuilder::Fixed(1) << chrono::duration<double>(gameTimeline.Total()).count() << L" s at " << TextBuilder::Fixed(3)
+			<< gameTimeline.Scale() << L"x" << (gameTimeline.IsPaused() ? L", paused" : L"") << "\n";
+		statisticsLabel << L"HUD: " << mHud->LabelCount() << L" labels, " << mHud->GlyphCount() << L" glyphs, " << mHud->DrawCallCount() << L" draw calls, " << mHud->LayoutCount() << L" layouts" << "\n";
+
+		statisticsLabel << L"Heap Allocations: " << AllocationCounter::LastFrameAllocationCount() << L" last frame (";
+		for (uint32_t i = 1; i < AllocationCounter::TagCount; ++i)
+		{
+			const MemoryTag tag = static_cast<MemoryTag>(i);
+			statisticsLabel << (i > 1 ? L", " : L"") << AllocationCounter::TagName(tag) << L" " << AllocationCounter::TagStatistics(tag).LastFrameAllocationCount;
+		}
+		statisticsLabel << L"), Frame Memory: " << mGame->FrameMemory().UsedBytes() / 1024 << L" KB (" << mGame->FrameMemory().OverflowCount() << L" overflows)" << "\n";
 
-	void SolarSystem::ToggleAnimation()
-	{
-		mAnimationEnabled = !mAnimationEnabled;
+		mHud->SetText(mStatisticsLabel, statisticsLabel.c_str());
+
+		// The font is loaded once every component has initialized, so the label is placed here rather than in Initialize()
+		const wstring& helpText = mHud->Text(mHelpLabel);
+		float helpLineCount = static_cast<float>(count(helpText.begin(), helpText.end(), L'\n'));
+		mHud->SetPosition(mStatisticsLabel, XMFLOAT2(mTextPosition.x, mTextPosition.y + helpLineCount * mHud->LineSpacing()));
 	}
 }
\ No newline at end of file
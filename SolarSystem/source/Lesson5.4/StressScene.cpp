@@ -0,0 +1,196 @@
+#include "pch.h"
+#include "StressScene.h"
+
+using namespace std;
+using namespace Library;
+using namespace DirectX;
+
+namespace Rendering
+{
+	const uint32_t StressScene::GridSize = 32;
+	const float StressScene::Spacing = 3.0f;
+	const float StressScene::RotationRate = 0.5f;
+
+	StressScene::StressScene(Game& game, const shared_ptr<Camera>& camera) :
+		mGame(&game), mCamera(camera), mSystems(mEntities), mIndexCount(0), mEnabled(false)
+	{
+	}
+
+	void StressScene::Initialize(Mesh& mesh)
+	{
+		RenderDevice& device = mGame->Device();
+
+		// Load a compiled vertex shader
+		vector<char> compiledVertexShader;
+		Utility::LoadBinaryFile(L"Content\\Shaders\\PointLightDemoVS.cso", compiledVertexShader);
+		mVertexShader = device.CreateShader(ShaderStage::Vertex, compiledVertexShader);
+
+		// Load a compiled pixel shader
+		vector<char> compiledPixelShader;
+		Utility::LoadBinaryFile(L"Content\\Shaders\\PointLightDemoPS.cso", compiledPixelShader);
+		mPixelShader = device.CreateShader(ShaderStage::Pixel, compiledPixelShader);
+
+		PipelineStateDescription pipelineStateDescription(mVertexShader, mPixelShader,
+		{
+			InputElement("POSITION", VertexFormat::Float4),
+			InputElement("TEXCOORD", VertexFormat::Float2),
+			InputElement("NORMAL", VertexFormat::Float3)
+		});
+		pipelineStateDescription.Sampler = SamplerMode::TrilinearWrap;
+		mPipelineState = device.CreatePipelineState(pipelineStateDescription);
+
+		// Create vertex and index buffers for the sphere
+		mVertexBuffer = CreateVertexBuffer(device, mesh);
+		mIndexBuffer = mesh.CreateIndexBuffer(device);
+		mIndexCount = static_cast<uint32_t>(mesh.Indices().Size());
+
+		// Load the planet maps so that neighbouring spheres differ in texture state
+		const wstring colorFilenames[] =
+		{
+			L"Content\\Textures\\MercuryComposite.dds",
+			L"Content\\Textures\\VenusComposite.dds",
+			L"Content\\Textures\\EarthComposite.dds",
+			L"Content\\Textures\\MarsComposite.dds",
+			L"Content\\Textures\\JupiterComposite.dds",
+			L"Content\\Textures\\SaturnComposite.dds",
+			L"Content\\Textures\\UranusComposite.dds",
+			L"Content\\Textures\\NeptuneComposite.dds",
+			L"Content\\Textures\\PlutoComposite.dds",
+			L"Content\\Textures\\MoonComposite.dds"
+		};
+
+		mSpecularMap = device.CreateTextureFromFile(L"Content\\Textures\\MarsSpecularMap.png");
+
+		RenderQueue& drawQueue = mGame->DrawQueue();
+		vector<uint32_t> textures;
+		for (const wstring& colorFilename : colorFilenames)
+		{
+			TextureHandle colorMap = device.CreateTextureFromFile(colorFilename);
+			textures.push_back(drawQueue.RegisterTextures(RenderQueue::TextureState({ colorMap, mSpecularMap })));
+			mColorMaps.push_back(colorMap);
+		}
+
+		uint32_t pipelineState = drawQueue.RegisterPipelineState(mPipelineState);
+
+		// Lay the spheres out in a plane above the solar system, each spinning in place
+		float halfExtent = (GridSize - 1) * Spacing * 0.5f;
+		for (uint32_t row = 0; row < GridSize; ++row)
+		{
+			for (uint32_t column = 0; column < GridSize; ++column)
+			{
+				OrbitComponent orbit = SceneSystems::Orbit(0.0f, 1.0f, 1.0f, 1.0f, 0.0f);
+				orbit.Center = XMFLOAT3(column * Spacing - halfExtent, 20.0f, row * Spacing - halfExtent);
+				orbit.OrbitalSpeedFactor = 0.0f;
+				orbit.RotationalSpeedFactor = RotationRate;
+
+				TransformComponent transform;
+				XMStoreFloat4x4(&transform.LocalMatrix, XMMatrixIdentity());
+				XMStoreFloat4x4(&transform.WorldMatrix, XMMatrixTranslation(orbit.Center.x, orbit.Center.y, orbit.Center.z));
+
+				mEntities.CreateEntity(orbit, transform, RenderStateComponent{ pipelineState, textures[(row * GridSize + column) % textures.size()] });
+			}
+		}
+	}
+
+	void StressScene::SetPointLight(const PointLight& pointLight)
+	{
+		XMStoreFloat3(&mVSCBufferPerFrameData.LightPosition, pointLight.PositionVector());
+		mVSCBufferPerFrameData.LightRadius = pointLight.Radius();
+		mPSCBufferPerFrameData.LightPosition = mVSCBufferPerFrameData.LightPosition;
+		mPSCBufferPerFrameData.LightColor = ColorHelper::ToFloat3(pointLight.Color(), true);
+	}
+
+	bool StressScene::Enabled() const
+	{
+		return mEnabled;
+	}
+
+	void StressScene::SetEnabled(bool enabled)
+	{
+		mEnabled = enabled;
+	}
+
+	void StressScene::Update(const GameTime& gameTime)
+	{
+		if (mEnabled)
+		{
+			mSystems.Update(gameTime.ElapsedGameTimeSeconds().count(), mGame->Workers());
+		}
+	}
+
+	void StressScene::Draw()
+	{
+		assert(mCamera != nullptr);
+
+		if (mEnabled == false)
+		{
+			return;
+		}
+
+		ConstantBufferRing& constantBuffers = mGame->ConstantBuffers();
+		ConstantBufferRing::Allocation VSCBufferPerFrame = constantBuffers.Allocate(mVSCBufferPerFrameData);
+
+		mPSCBufferPerFrameData.CameraPosition = mCamera->Position();
+		ConstantBufferRing::Allocation PSCBufferPerFrame = constantBuffers.Allocate(mPSCBufferPerFrameData);
+		ConstantBufferRing::Allocation PSCBufferPerObject = constantBuffers.Allocate(mPSCBufferPerObjectData);
+
+		XMFLOAT4X4 viewProjection;
+		XMStoreFloat4x4(&viewProjection, mCamera->ViewProjectionMatrix());
+		RenderQueue& drawQueue = mGame->DrawQueue();
+		MemoryResource& frameMemory = mGame->FrameMemory().ThreadResource();
+
+		mEntities.ForEachChunk(EntityWorld::MaskOf<TransformComponent, RenderStateComponent>(), [&](const EntityChunk& chunk)
+		{
+			const TransformComponent* transforms = chunk.Components<TransformComponent>();
+			const RenderStateComponent* renderStates = chunk.Components<RenderStateComponent>();
+
+			// The whole chunk's constant buffer data at once, straight from the components.
+			VSCBufferPerObject* VSCBufferPerObjectData = static_cast<VSCBufferPerObject*>(frameMemory.Allocate(chunk.Count() * sizeof(VSCBufferPerObject), alignof(VSCBufferPerObject)));
+			TransformKernels::WorldViewProjection(ConstMatrixArray(&transforms[0].WorldMatrix, sizeof(TransformComponent)), viewProjection,
+				MatrixArray(&VSCBufferPerObjectData[0].World, sizeof(VSCBufferPerObject)), MatrixArray(&VSCBufferPerObjectData[0].WorldViewProjection, sizeof(VSCBufferPerObject)), chunk.Count());
+
+			for (uint32_t i = 0; i < chunk.Count(); ++i)
+			{
+				const XMFLOAT4X4& worldMatrix = transforms[i].WorldMatrix;
+
+				RenderQueue::DrawPacket packet;
+				packet.AddVertexBuffer(mVertexBuffer, sizeof(VertexPositionTextureNormal));
+				packet.IndexBuffer = mIndexBuffer;
+				packet.AddVSConstantBuffer(VSCBufferPerFrame);
+				packet.AddVSConstantBuffer(constantBuffers.Allocate(VSCBufferPerObjectData[i]));
+				packet.AddPSConstantBuffer(PSCBufferPerFrame);
+				packet.AddPSConstantBuffer(PSCBufferPerObject);
+				packet.ElementCount = mIndexCount;
+
+				const RenderStateComponent& renderState = renderStates[i];
+				drawQueue.Submit(RenderLayer::Opaque, renderState.PipelineState, renderState.Textures, mCamera->NormalizedDepth(XMVectorSet(worldMatrix._41, worldMatrix._42, worldMatrix._43, 1.0f)), packet);
+			}
+		});
+	}
+
+	uint32_t StressScene::ObjectCount() const
+	{
+		return mEntities.EntityCount();
+	}
+
+	BufferHandle StressScene::CreateVertexBuffer(RenderDevice& device, const Mesh& mesh)
+	{
+		Span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+		Span<const XMFLOAT3> sourceNormals = mesh.Normals();
+		Span<const XMFLOAT3> sourceUVs = mesh.TextureCoordinates(0);
+		assert(sourceNormals.Size() == sourceVertices.Size());
+
+		vector<VertexPositionTextureNormal> vertices;
+		vertices.reserve(sourceVertices.Size());
+		for (UINT i = 0; i < sourceVertices.Size(); i++)
+		{
+			const XMFLOAT3& position = sourceVertices[i];
+			const XMFLOAT3& uv = sourceUVs[i];
+			const XMFLOAT3& normal = sourceNormals[i];
+
+			vertices.push_back(VertexPositionTextureNormal(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y), normal));
+		}
+
+		return device.CreateBuffer(BufferDescription(BufferType::Vertex, ResourceUsage::Immutable, sizeof(VertexPositionTextureNormal) * static_cast<uint32_t>(vertices.size())), &vertices[0]);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include "RenderDevice.h"
+#include "SceneEntities.h"
+
+namespace Library
+{
+	class Game;
+	class GameTime;
+	class Camera;
+	class Mesh;
+	class PointLight;
+}
+
+namespace Rendering
+{
+	// A grid of individually drawn spheres that gives the render queue enough packets to be worth recording on several threads.
+	// The spheres are entities, spun by SceneSystems on the worker threads.
+	class StressScene final
+	{
+	public:
+		StressScene(Library::Game& game, const std::shared_ptr<Library::Camera>& camera);
+		StressScene(const StressScene&) = delete;
+		StressScene& operator=(const StressScene&) = delete;
+		StressScene(StressScene&&) = delete;
+		StressScene& operator=(StressScene&&) = delete;
+		~StressScene() = default;
+
+		void Initialize(Library::Mesh& mesh);
+		void SetPointLight(const Library::PointLight& pointLight);
+
+		bool Enabled() const;
+		void SetEnabled(bool enabled);
+
+		void Update(const Library::GameTime& gameTime);
+
+		// Submits one packet per sphere to the game's render queue.
+		void Draw();
+
+		std::uint32_t ObjectCount() const;
+
+		static const std::uint32_t GridSize;
+		static const float Spacing;
+		static const float RotationRate;
+
+	private:
+		struct VSCBufferPerFrame
+		{
+			DirectX::XMFLOAT3 LightPosition;
+			float LightRadius;
+
+			VSCBufferPerFrame() :
+				LightPosition(Library::Vector3Helper::Zero), LightRadius(100000.0f) { }
+		};
+
+		struct VSCBufferPerObject
+		{
+			DirectX::XMFLOAT4X4 WorldViewProjection;
+			DirectX::XMFLOAT4X4 World;
+
+			VSCBufferPerObject() = default;
+		};
+
+		struct PSCBufferPerFrame
+		{
+			DirectX::XMFLOAT3 CameraPosition;
+			float Padding;
+			DirectX::XMFLOAT3 AmbientColor;
+			float Padding2;
+			DirectX::XMFLOAT3 LightPosition;
+			float Padding3;
+			DirectX::XMFLOAT3 LightColor;
+			float Padding4;
+
+			PSCBufferPerFrame() :
+				CameraPosition(Library::Vector3Helper::Zero), AmbientColor(0.2f, 0.2f, 0.2f), LightPosition(Library::Vector3Helper::Zero), LightColor(Library::Vector3Helper::Zero) { }
+		};
+
+		struct PSCBufferPerObject
+		{
+			DirectX::XMFLOAT3 SpecularColor;
+			float SpecularPower;
+
+			PSCBufferPerObject() :
+				SpecularColor(1.0f, 1.0f, 1.0f), SpecularPower(128.0f) { }
+		};
+
+		static Library::BufferHandle CreateVertexBuffer(Library::RenderDevice& device, const Library::Mesh& mesh);
+
+		Library::Game* mGame;
+		std::shared_ptr<Library::Camera> mCamera;
+		VSCBufferPerFrame mVSCBufferPerFrameData;
+		PSCBufferPerFrame mPSCBufferPerFrameData;
+		PSCBufferPerObject mPSCBufferPerObjectData;
+		Library::ShaderHandle mVertexShader;
+		Library::ShaderHandle mPixelShader;
+		Library::PipelineStateHandle mPipelineState;
+		Library::BufferHandle mVertexBuffer;
+		Library::BufferHandle mIndexBuffer;
+		Library::TextureHandle mSpecularMap;
+		std::vector<Library::TextureHandle> mColorMaps;
+		Library::EntityWorld mEntities;
+		SceneSystems mSystems;
+		std::uint32_t mIndexCount;
+		bool mEnabled;
+	};
+}
\ No newline at end of file
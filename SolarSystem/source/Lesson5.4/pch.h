@@ -20,6 +20,7 @@
 #include <codecvt>
 #include <algorithm>
 #include <functional>
+#include <numeric>
 
 #if defined(DEBUG) || defined(_DEBUG)
 #define _CRTDBG_MAP_ALLOC
@@ -44,6 +45,7 @@
 // Local
 #include "RTTI.h"
 #include "GameException.h"
+#include "Timeline.h"
 #include "GameClock.h"
 #include "GameTime.h"
 #include "ServiceContainer.h"
@@ -58,6 +60,8 @@
 #include "PerspectiveCamera.h"
 #include "OrthographicCamera.h"
 #include "FirstPersonCamera.h"
+#include "CameraPath.h"
+#include "SolarSystemBodies.h"
 #include "Light.h"
 #include "DirectionalLight.h"
 #include "PointLight.h"
@@ -69,7 +73,9 @@
 #include "RasterizerStates.h"
 #include "SamplerStates.h"
 #include "RenderStateHelper.h"
+#include "FrameStatistics.h"
 #include "FpsComponent.h"
+#include "HudComponent.h"
 #include "StreamHelper.h"
 #include "..\Library.Shared\Model.h"
 #include "..\Library.Shared\Mesh.h"
@@ -80,6 +86,37 @@
 #include "KeyboardComponent.h"
 #include "GamePadComponent.h"
 #include "Grid.h"
+#include "UpdateScheduler.h"
+#include "SnapshotBuffer.h"
+#include "ThreadPool.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include "FramePipeline.h"
+#include "EntityWorld.h"
+#include "EntityCommandBuffer.h"
+#include "EntitySystemScheduler.h"
+#include "MemoryResource.h"
+#include "LinearArena.h"
+#include "FrameArena.h"
+#include "TextBuilder.h"
+#include "Span.h"
+#include "TransformKernels.h"
+#include "InstancePacker.h"
+#include "ConstantBufferRing.h"
+#include "DrawKey.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "StateCachingContext.h"
+#include "Direct3DStateCache.h"
+#include "RenderDevice.h"
+#include "Direct3D11RenderDevice.h"
+#include "NullRenderDevice.h"
+#include "RenderGraph.h"
+#include "Direct3D11RenderGraphExecutor.h"
+#include "Profiler.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
 
 // Library.Desktop
 #include "UtilityWin32.h"
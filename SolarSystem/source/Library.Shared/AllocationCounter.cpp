@@ -0,0 +1,511 @@
+#include "pch.h"
+
+#if !defined(_WIN32)
+#include <execinfo.h>
+#endif
+
+using namespace std;
+
+namespace Library
+{
+	// Constant-initialized, so allocations made while other statics are constructed are counted too
+	AllocationCounter::ThreadCounters AllocationCounter::sThreadCounters[AllocationCounter::MaxThreadSlots + 1];
+	atomic<uint32_t> AllocationCounter::sNextThreadSlot(0);
+	atomic<uint64_t> AllocationCounter::sHighWaterBytes[AllocationCounter::TagCount];
+	uint64_t AllocationCounter::sFrameStartCounts[AllocationCounter::TagCount];
+	uint64_t AllocationCounter::sLastFrameCounts[AllocationCounter::TagCount];
+	atomic<uint32_t> AllocationCounter::sSamplingInterval(0);
+	atomic_flag AllocationCounter::sSampleLock = ATOMIC_FLAG_INIT;
+	AllocationCounter::Sample AllocationCounter::sSamples[AllocationCounter::SampleCapacity];
+	uint64_t AllocationCounter::sDroppedSampleCount = 0;
+	thread_local MemoryTag AllocationCounter::sCurrentTag = MemoryTag::Untagged;
+	thread_local uint32_t AllocationCounter::sThreadSlot = 0;
+	thread_local uint32_t AllocationCounter::sSamplingCountdown = 0;
+	thread_local bool AllocationCounter::sIsSampling = false;
+
+	uint64_t AllocationCounter::AllocationCount()
+	{
+		uint64_t count = 0;
+		for (const ThreadCounters& threadCounters : sThreadCounters)
+		{
+			for (const TagCounters& counters : threadCounters.Tags)
+			{
+				count += counters.AllocationCount.load(memory_order_relaxed);
+			}
+		}
+
+		return count;
+	}
+
+	uint64_t AllocationCounter::AllocatedBytes()
+	{
+		uint64_t bytes = 0;
+		for (const ThreadCounters& threadCounters : sThreadCounters)
+		{
+			for (const TagCounters& counters : threadCounters.Tags)
+			{
+				bytes += counters.AllocatedBytes.load(memory_order_relaxed);
+			}
+		}
+
+		return bytes;
+	}
+
+	AllocationCounter::Statistics AllocationCounter::TagStatistics(MemoryTag tag)
+	{
+		const uint32_t index = static_cast<uint32_t>(tag);
+
+		// Frees are read first; slots are read one after another while other threads run, so the live values are clamped
+		uint64_t freeCount = 0;
+		uint64_t freedBytes = 0;
+		for (const ThreadCounters& threadCounters : sThreadCounters)
+		{
+			freeCount += threadCounters.Tags[index].FreeCount.load(memory_order_relaxed);
+			freedBytes += threadCounters.Tags[index].FreedBytes.load(memory_order_relaxed);
+		}
+
+		Statistics statistics;
+		statistics.AllocationCount = 0;
+		statistics.AllocatedBytes = 0;
+		for (const ThreadCounters& threadCounters : sThreadCounters)
+		{
+			statistics.AllocationCount += threadCounters.Tags[index].AllocationCount.load(memory_order_relaxed);
+			statistics.AllocatedBytes += threadCounters.Tags[index].AllocatedBytes.load(memory_order_relaxed);
+		}
+
+		statistics.LiveCount = (statistics.AllocationCount > freeCount ? statistics.AllocationCount - freeCount : 0);
+		statistics.LiveBytes = (statistics.AllocatedBytes > freedBytes ? statistics.AllocatedBytes - freedBytes : 0);
+		statistics.HighWaterBytes = max(UpdateHighWater(index), statistics.LiveBytes);
+		statistics.LastFrameAllocationCount = sLastFrameCounts[index];
+
+		return statistics;
+	}
+
+	const char* AllocationCounter::TagName(MemoryTag tag)
+	{
+		switch (tag)
+		{
+			case MemoryTag::Assets:
+				return "Assets";
+
+			case MemoryTag::Simulation:
+				return "Simulation";
+
+			case MemoryTag::Rendering:
+				return "Rendering";
+
+			case MemoryTag::UI:
+				return "UI";
+
+			default:
+				return "Untagged";
+		}
+	}
+
+	MemoryTag AllocationCounter::CurrentTag()
+	{
+		return sCurrentTag;
+	}
+
+	void AllocationCounter::BeginFrame()
+	{
+		for (uint32_t i = 0; i < TagCount; ++i)
+		{
+			uint64_t count = 0;
+			for (const ThreadCounters& threadCounters : sThreadCounters)
+			{
+				count += threadCounters.Tags[i].AllocationCount.load(memory_order_relaxed);
+			}
+
+			sLastFrameCounts[i] = count - sFrameStartCounts[i];
+			sFrameStartCounts[i] = count;
+
+			UpdateHighWater(i);
+		}
+	}
+
+	uint64_t AllocationCounter::LastFrameAllocationCount()
+	{
+		uint64_t count = 0;
+		for (uint64_t frameCount : sLastFrameCounts)
+		{
+			count += frameCount;
+		}
+
+		return count;
+	}
+
+	void AllocationCounter::SetSamplingInterval(uint32_t interval)
+	{
+		sSamplingInterval.store(interval, memory_order_relaxed);
+	}
+
+	uint32_t AllocationCounter::SamplingInterval()
+	{
+		return sSamplingInterval.load(memory_order_relaxed);
+	}
+
+	void AllocationCounter::WriteReport(ostream& stream)
+	{
+		stream << "Tag         Allocations      Allocated KB   Live Allocations     Live KB  High Water KB  Last Frame" << endl;
+
+		for (uint32_t i = 0; i < TagCount; ++i)
+		{
+			const MemoryTag tag = static_cast<MemoryTag>(i);
+			const Statistics statistics = TagStatistics(tag);
+
+			stream << left << setw(10) << TagName(tag) << right
+				<< setw(13) << statistics.AllocationCount
+				<< setw(18) << statistics.AllocatedBytes / 1024
+				<< setw(19) << statistics.LiveCount
+				<< setw(12) << statistics.LiveBytes / 1024
+				<< setw(15) << statistics.HighWaterBytes / 1024
+				<< setw(12) << statistics.LastFrameAllocationCount << endl;
+		}
+
+		const uint32_t interval = SamplingInterval();
+		if (interval == 0)
+		{
+			stream << endl << "Call stack sampling is off." << endl;
+			return;
+		}
+
+		// Reserved before the lock is taken; allocating while holding it would deadlock on this thread's own sample
+		vector<Sample> samples;
+		samples.reserve(SampleCapacity);
+
+		uint64_t droppedSampleCount;
+		while (sSampleLock.test_and_set(memory_order_acquire))
+		{
+		}
+
+		for (const Sample& sample : sSamples)
+		{
+			if (sample.Count > 0)
+			{
+				samples.push_back(sample);
+			}
+		}
+
+		droppedSampleCount = sDroppedSampleCount;
+		sSampleLock.clear(memory_order_release);
+
+		sort(samples.begin(), samples.end(), [](const Sample& lhs, const Sample& rhs) { return lhs.Count > rhs.Count; });
+
+		stream << endl << "Sampled call stacks (every " << interval << " allocations per thread, " << samples.size() << " distinct";
+		if (droppedSampleCount > 0)
+		{
+			stream << ", " << droppedSampleCount << " samples dropped with the table full";
+		}
+		stream << ")" << endl;
+
+		const size_t reportedCount = min(samples.size(), static_cast<size_t>(ReportedSampleCount));
+		for (size_t i = 0; i < reportedCount; ++i)
+		{
+			const Sample& sample = samples[i];
+			stream << endl << sample.Count << " samples, " << sample.Bytes << " bytes, " << TagName(static_cast<MemoryTag>(sample.Tag)) << endl;
+
+			for (uint32_t frame = 0; frame < sample.Depth; ++frame)
+			{
+				stream << "    ";
+				WriteFrame(stream, sample.Frames[frame]);
+				stream << endl;
+			}
+		}
+	}
+
+	void* AllocationCounter::Allocate(size_t size)
+	{
+		if (size > SIZE_MAX - sizeof(Header))
+		{
+			return nullptr;
+		}
+
+		Header* header = static_cast<Header*>(malloc(sizeof(Header) + size));
+		if (header == nullptr)
+		{
+			return nullptr;
+		}
+
+		const MemoryTag tag = sCurrentTag;
+		header->Size = size;
+		header->Tag = static_cast<uint64_t>(tag);
+
+		const uint32_t slot = ThreadSlot();
+		const bool isShared = (slot == MaxThreadSlots);
+		TagCounters& counters = sThreadCounters[slot].Tags[static_cast<uint32_t>(tag)];
+		Add(counters.AllocationCount, 1, isShared);
+		Add(counters.AllocatedBytes, size, isShared);
+
+		// Loading assets is mostly large allocations, so checking these keeps short-lived peaks in the high-water marks
+		if (size >= LargeAllocationSize)
+		{
+			UpdateHighWater(static_cast<uint32_t>(tag));
+		}
+
+		const uint32_t interval = sSamplingInterval.load(memory_order_relaxed);
+		if (interval > 0 && sIsSampling == false)
+		{
+			if (sSamplingCountdown == 0 || sSamplingCountdown > interval)
+			{
+				sSamplingCountdown = interval;
+			}
+
+			if (--sSamplingCountdown == 0)
+			{
+				RecordSample(size, tag);
+			}
+		}
+
+		return header + 1;
+	}
+
+	void AllocationCounter::Free(void* memory)
+	{
+		if (memory == nullptr)
+		{
+			return;
+		}
+
+		Header* header = static_cast<Header*>(memory) - 1;
+
+		const uint32_t slot = ThreadSlot();
+		const bool isShared = (slot == MaxThreadSlots);
+		TagCounters& counters = sThreadCounters[slot].Tags[static_cast<uint32_t>(header->Tag)];
+		Add(counters.FreeCount, 1, isShared);
+		Add(counters.FreedBytes, header->Size, isShared);
+
+		free(header);
+	}
+
+	MemoryTag AllocationCounter::SetCurrentTag(MemoryTag tag)
+	{
+		const MemoryTag previousTag = sCurrentTag;
+		sCurrentTag = tag;
+
+		return previousTag;
+	}
+
+	void AllocationCounter::Add(atomic<uint64_t>& counter, uint64_t value, bool isShared)
+	{
+		if (isShared)
+		{
+			counter.fetch_add(value, memory_order_relaxed);
+		}
+		else
+		{
+			// Only this thread writes the counter, so a plain load and store is enough and takes no lock
+			counter.store(counter.load(memory_order_relaxed) + value, memory_order_relaxed);
+		}
+	}
+
+	uint32_t AllocationCounter::ThreadSlot()
+	{
+		// Stored plus one, so the zero-initialized value means the thread has no slot yet
+		if (sThreadSlot == 0)
+		{
+			const uint32_t slot = sNextThreadSlot.fetch_add(1, memory_order_relaxed);
+			sThreadSlot = (slot < MaxThreadSlots ? slot + 1 : MaxThreadSlots + 1);
+		}
+
+		return sThreadSlot - 1;
+	}
+
+	uint64_t AllocationCounter::UpdateHighWater(uint32_t tagIndex)
+	{
+		uint64_t freedBytes = 0;
+		for (const ThreadCounters& threadCounters : sThreadCounters)
+		{
+			freedBytes += threadCounters.Tags[tagIndex].FreedBytes.load(memory_order_relaxed);
+		}
+
+		uint64_t allocatedBytes = 0;
+		for (const ThreadCounters& threadCounters : sThreadCounters)
+		{
+			allocatedBytes += threadCounters.Tags[tagIndex].AllocatedBytes.load(memory_order_relaxed);
+		}
+
+		const uint64_t liveBytes = (allocatedBytes > freedBytes ? allocatedBytes - freedBytes : 0);
+		uint64_t highWaterBytes = sHighWaterBytes[tagIndex].load(memory_order_relaxed);
+		while (liveBytes > highWaterBytes && sHighWaterBytes[tagIndex].compare_exchange_weak(highWaterBytes, liveBytes, memory_order_relaxed) == false)
+		{
+		}
+
+		return max(highWaterBytes, liveBytes);
+	}
+
+	void AllocationCounter::RecordSample(size_t size, MemoryTag tag)
+	{
+		// Capturing a stack can allocate the first time (the unwinder loads lazily); those allocations aren't sampled
+		sIsSampling = true;
+
+		void* frames[MaxStackDepth];
+		const uint32_t depth = CaptureStack(frames, MaxStackDepth);
+
+		uint64_t hash = 14695981039346656037ULL;
+		for (uint32_t i = 0; i < depth; ++i)
+		{
+			hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ULL;
+		}
+
+		while (sSampleLock.test_and_set(memory_order_acquire))
+		{
+		}
+
+		bool isRecorded = false;
+		for (uint32_t probe = 0; probe < SampleCapacity; ++probe)
+		{
+			Sample& sample = sSamples[(hash + probe) % SampleCapacity];
+			if (sample.Count == 0)
+			{
+				sample.Hash = hash;
+				copy(frames, frames + depth, sample.Frames);
+				sample.Depth = depth;
+				sample.Tag = static_cast<uint32_t>(tag);
+			}
+			else if (sample.Hash != hash || sample.Depth != depth || equal(frames, frames + depth, sample.Frames) == false)
+			{
+				continue;
+			}
+
+			++sample.Count;
+			sample.Bytes += size;
+			isRecorded = true;
+			break;
+		}
+
+		if (isRecorded == false)
+		{
+			++sDroppedSampleCount;
+		}
+
+		sSampleLock.clear(memory_order_release);
+		sIsSampling = false;
+	}
+
+	uint32_t AllocationCounter::CaptureStack(void** frames, uint32_t maxDepth)
+	{
+		// Skips this function, RecordSample and Allocate
+		const uint32_t skippedFrameCount = 3;
+
+#if defined(_WIN32)
+		return CaptureStackBackTrace(skippedFrameCount, maxDepth, frames, nullptr);
+#else
+		void* capturedFrames[MaxStackDepth + skippedFrameCount];
+		const int capturedCount = backtrace(capturedFrames, static_cast<int>(maxDepth + skippedFrameCount));
+		if (capturedCount <= static_cast<int>(skippedFrameCount))
+		{
+			return 0;
+		}
+
+		const uint32_t depth = static_cast<uint32_t>(capturedCount) - skippedFrameCount;
+		copy(capturedFrames + skippedFrameCount, capturedFrames + capturedCount, frames);
+
+		return depth;
+#endif
+	}
+
+	void AllocationCounter::WriteFrame(ostream& stream, void* frame)
+	{
+#if defined(_WIN32)
+		HMODULE module = nullptr;
+		char moduleName[MAX_PATH];
+		if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, static_cast<LPCSTR>(frame), &module) &&
+			GetModuleFileNameA(module, moduleName, MAX_PATH) > 0)
+		{
+			const char* fileName = strrchr(moduleName, '\\');
+			stream << (fileName != nullptr ? fileName + 1 : moduleName) << "+0x" << hex << (reinterpret_cast<uintptr_t>(frame) - reinterpret_cast<uintptr_t>(module)) << dec;
+		}
+		else
+		{
+			stream << frame;
+		}
+#else
+		// backtrace_symbols uses malloc, not operator new, so it can't recurse into the counter
+		char** symbols = backtrace_symbols(&frame, 1);
+		if (symbols != nullptr)
+		{
+			stream << symbols[0];
+			free(symbols);
+		}
+		else
+		{
+			stream << frame;
+		}
+#endif
+	}
+}
+
+void* operator new(size_t size)
+{
+	// Like the standard operator new, give the new handler a chance to free memory and retry; throw only when there is none
+	for (;;)
+	{
+		void* memory = Library::AllocationCounter::Allocate(size);
+		if (memory != nullptr)
+		{
+			return memory;
+		}
+
+		new_handler handler = get_new_handler();
+		if (handler == nullptr)
+		{
+			throw bad_alloc();
+		}
+
+		handler();
+	}
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept
+{
+	// The new handler may throw bad_alloc to give up
+	try
+	{
+		return operator new(size);
+	}
+	catch (const bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, const nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept
+{
+	Library::AllocationCounter::Free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	Library::AllocationCounter::Free(memory);
+}
+
+void operator delete(void* memory, const nothrow_t&) noexcept
+{
+	Library::AllocationCounter::Free(memory);
+}
+
+void operator delete[](void* memory, const nothrow_t&) noexcept
+{
+	Library::AllocationCounter::Free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	Library::AllocationCounter::Free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	Library::AllocationCounter::Free(memory);
+}
\ No newline at end of file
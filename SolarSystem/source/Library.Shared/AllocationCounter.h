@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+namespace Library
+{
+	// The subsystem an allocation is charged to: the innermost MemoryTagScope on the allocating thread.
+	enum class MemoryTag : std::uint8_t
+	{
+		Untagged,
+		Assets,
+		Simulation,
+		Rendering,
+		UI
+	};
+
+	// Counts heap allocations made through the global operator new, which AllocationCounter.cpp replaces. Every allocation
+	// carries a small header with its size and tag, so frees are charged back to the subsystem that allocated, giving live
+	// bytes per tag. The totals only ever grow; take the difference between two reads to count the allocations in between.
+	// Each thread counts into its own slot, which only it writes, so counting takes no locked instructions; reads sum the
+	// slots. High-water marks are therefore taken at frame boundaries, on large allocations and whenever statistics are read,
+	// rather than on every allocation.
+	// Sampling is off by default. When on, every Nth allocation on each thread records its call stack, so a report can show
+	// where allocations come from.
+	class AllocationCounter final
+	{
+	public:
+		static const std::uint32_t TagCount = 5;
+
+		struct Statistics
+		{
+			std::uint64_t AllocationCount;
+			std::uint64_t AllocatedBytes;
+			std::uint64_t LiveCount;
+			std::uint64_t LiveBytes;
+			std::uint64_t HighWaterBytes;
+			std::uint64_t LastFrameAllocationCount;
+		};
+
+		static std::uint64_t AllocationCount();
+		static std::uint64_t AllocatedBytes();
+
+		static Statistics TagStatistics(MemoryTag tag);
+		static const char* TagName(MemoryTag tag);
+
+		static MemoryTag CurrentTag();
+
+		// Ends a frame for the per-frame counts. Call it from one thread only.
+		static void BeginFrame();
+		static std::uint64_t LastFrameAllocationCount();
+
+		// Every interval-th allocation on each thread records its call stack; 0 turns sampling off.
+		static void SetSamplingInterval(std::uint32_t interval);
+		static std::uint32_t SamplingInterval();
+
+		// Per-tag counters, then the most frequent sampled call stacks.
+		static void WriteReport(std::ostream& stream);
+
+		// Called by the replacement operators new and delete.
+		static void* Allocate(std::size_t size);
+		static void Free(void* memory);
+
+		AllocationCounter() = delete;
+		AllocationCounter(const AllocationCounter&) = delete;
+		AllocationCounter& operator=(const AllocationCounter&) = delete;
+		AllocationCounter(AllocationCounter&&) = delete;
+		AllocationCounter& operator=(AllocationCounter&&) = delete;
+		~AllocationCounter() = default;
+
+	private:
+		friend class MemoryTagScope;
+
+		static const std::size_t CacheLineSize = 64;
+		static const std::uint32_t MaxThreadSlots = 64;
+		static const std::size_t LargeAllocationSize = 64 * 1024;
+		static const std::uint32_t MaxStackDepth = 16;
+		static const std::uint32_t SampleCapacity = 1024;
+		static const std::uint32_t ReportedSampleCount = 20;
+
+		// Kept in front of every allocation; its size keeps the memory after it aligned like malloc's.
+		struct Header
+		{
+			std::uint64_t Size;
+			std::uint64_t Tag;
+		};
+
+		struct TagCounters
+		{
+			std::atomic<std::uint64_t> AllocationCount;
+			std::atomic<std::uint64_t> AllocatedBytes;
+			std::atomic<std::uint64_t> FreeCount;
+			std::atomic<std::uint64_t> FreedBytes;
+		};
+
+		// One thread's counters, padded so neighbouring threads don't share a cache line. A thread frees memory other threads
+		// allocated, so a slot's free counters can exceed its allocation counters; only the sums over all slots mean anything.
+		struct ThreadCounters
+		{
+			TagCounters Tags[TagCount];
+			char Padding[CacheLineSize - TagCount * sizeof(TagCounters) % CacheLineSize];
+		};
+
+		struct Sample
+		{
+			std::uint64_t Hash;
+			void* Frames[MaxStackDepth];
+			std::uint32_t Depth;
+			std::uint32_t Tag;
+			std::uint64_t Count;
+			std::uint64_t Bytes;
+		};
+
+		static MemoryTag SetCurrentTag(MemoryTag tag);
+		static void Add(std::atomic<std::uint64_t>& counter, std::uint64_t value, bool isShared);
+		static std::uint32_t ThreadSlot();
+		static std::uint64_t UpdateHighWater(std::uint32_t tagIndex);
+		static void RecordSample(std::size_t size, MemoryTag tag);
+		static std::uint32_t CaptureStack(void** frames, std::uint32_t maxDepth);
+		static void WriteFrame(std::ostream& stream, void* frame);
+
+		// Threads past MaxThreadSlots share the last slot and update it with atomic adds.
+		static ThreadCounters sThreadCounters[MaxThreadSlots + 1];
+		static std::atomic<std::uint32_t> sNextThreadSlot;
+		static std::atomic<std::uint64_t> sHighWaterBytes[TagCount];
+		static std::uint64_t sFrameStartCounts[TagCount];
+		static std::uint64_t sLastFrameCounts[TagCount];
+		static std::atomic<std::uint32_t> sSamplingInterval;
+		static std::atomic_flag sSampleLock;
+		static Sample sSamples[SampleCapacity];
+		static std::uint64_t sDroppedSampleCount;
+		static thread_local MemoryTag sCurrentTag;
+		static thread_local std::uint32_t sThreadSlot;
+		static thread_local std::uint32_t sSamplingCountdown;
+		static thread_local bool sIsSampling;
+	};
+
+	// Charges the current thread's allocations to a tag until the scope ends.
+	class MemoryTagScope final
+	{
+	public:
+		explicit MemoryTagScope(MemoryTag tag) :
+			mPreviousTag(AllocationCounter::SetCurrentTag(tag))
+		{
+		}
+
+		MemoryTagScope(const MemoryTagScope&) = delete;
+		MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+		MemoryTagScope(MemoryTagScope&&) = delete;
+		MemoryTagScope& operator=(MemoryTagScope&&) = delete;
+
+		~MemoryTagScope()
+		{
+			AllocationCounter::SetCurrentTag(mPreviousTag);
+		}
+
+	private:
+		MemoryTag mPreviousTag;
+	};
+}
\ No newline at end of file
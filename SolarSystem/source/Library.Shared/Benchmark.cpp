@@ -0,0 +1,306 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace Library
+{
+	Benchmark::Benchmark(const string& name, uint32_t frameCount, uint32_t warmupFrameCount, const vector<string>& segments) :
+		mName(name), mFrameCount(frameCount), mWarmupFrameCount(warmupFrameCount), mFramesBegun(0), mSegments(segments),
+		mCurrentSegment(0), mSegmentFramesBegun(0), mSegmentRecordedFrameCount(0), mFrameTimes(frameCount * SegmentCount()),
+		mAllocatedBytes(0), mFrameStartTime(), mFrameStartAllocations(0), mFrameStartBytes(0)
+	{
+		assert(frameCount > 0);
+
+		// Every segment records the full frame count
+		uint32_t totalFrameCount = frameCount * SegmentCount();
+		mFrameAllocations.reserve(totalFrameCount);
+		mFrameSegments.reserve(totalFrameCount);
+		mFrameNanoseconds.reserve(totalFrameCount);
+	}
+
+	uint32_t Benchmark::AddPhase(const string& name)
+	{
+		assert(mFramesBegun == 0);
+
+		mPhases.emplace_back(name);
+		mPhases.back().Nanoseconds.reserve(mFrameCount * SegmentCount());
+		mPhases.back().Allocations.reserve(mFrameCount * SegmentCount());
+
+		return static_cast<uint32_t>(mPhases.size() - 1);
+	}
+
+	void Benchmark::SetProperty(const string& key, const string& value)
+	{
+		mProperties[key] = value;
+	}
+
+	bool Benchmark::BeginFrame()
+	{
+		high_resolution_clock::time_point now = high_resolution_clock::now();
+		uint64_t allocationCount = AllocationCounter::AllocationCount();
+		uint64_t allocatedBytes = AllocationCounter::AllocatedBytes();
+
+		if (IsRecording())
+		{
+			nanoseconds frameTime = duration_cast<nanoseconds>(now - mFrameStartTime);
+			mFrameTimes.AddFrame(frameTime);
+			mFrameNanoseconds.push_back(static_cast<uint64_t>(frameTime.count()));
+			mFrameSegments.push_back(mCurrentSegment);
+			++mSegmentRecordedFrameCount;
+			mFrameAllocations.push_back(allocationCount - mFrameStartAllocations);
+			mAllocatedBytes += allocatedBytes - mFrameStartBytes;
+
+			for (Phase& phase : mPhases)
+			{
+				phase.Nanoseconds.push_back(phase.FrameNanoseconds);
+				phase.Allocations.push_back(phase.FrameAllocations);
+			}
+		}
+
+		for (Phase& phase : mPhases)
+		{
+			phase.FrameNanoseconds = 0;
+			phase.FrameAllocations = 0;
+		}
+
+		if (IsComplete())
+		{
+			return false;
+		}
+
+		if (mSegmentRecordedFrameCount == mFrameCount)
+		{
+			++mCurrentSegment;
+			mSegmentFramesBegun = 0;
+			mSegmentRecordedFrameCount = 0;
+		}
+
+		++mFramesBegun;
+		++mSegmentFramesBegun;
+		mFrameStartTime = now;
+		mFrameStartAllocations = allocationCount;
+		mFrameStartBytes = allocatedBytes;
+
+		return true;
+	}
+
+	void Benchmark::AddPhaseTime(uint32_t phase, nanoseconds duration, uint64_t allocationCount)
+	{
+		Phase& target = mPhases.at(phase);
+		target.FrameNanoseconds += static_cast<uint64_t>(duration.count());
+		target.FrameAllocations += allocationCount;
+	}
+
+	bool Benchmark::IsComplete() const
+	{
+		return (RecordedFrameCount() == mFrameCount * SegmentCount());
+	}
+
+	uint32_t Benchmark::FrameCount() const
+	{
+		return mFrameCount;
+	}
+
+	uint32_t Benchmark::WarmupFrameCount() const
+	{
+		return mWarmupFrameCount;
+	}
+
+	uint32_t Benchmark::RecordedFrameCount() const
+	{
+		return static_cast<uint32_t>(mFrameAllocations.size());
+	}
+
+	uint32_t Benchmark::SegmentCount() const
+	{
+		return max(static_cast<uint32_t>(mSegments.size()), 1U);
+	}
+
+	uint32_t Benchmark::CurrentSegment() const
+	{
+		return mCurrentSegment;
+	}
+
+	uint32_t Benchmark::SegmentFrameIndex() const
+	{
+		return (mSegmentFramesBegun > 0 ? mSegmentFramesBegun - 1 : 0);
+	}
+
+	const FrameStatistics& Benchmark::FrameTimes() const
+	{
+		return mFrameTimes;
+	}
+
+	void Benchmark::WriteJson(ostream& stream) const
+	{
+		stream << "{\n";
+		stream << "  \"benchmark\": ";
+		WriteString(stream, mName);
+		stream << ",\n";
+		stream << "  \"frames\": " << RecordedFrameCount() << ",\n";
+		stream << "  \"warmupFrames\": " << mWarmupFrameCount << ",\n";
+
+		stream << "  \"configuration\": {";
+		bool isFirst = true;
+		for (const auto& property : mProperties)
+		{
+			stream << (isFirst ? "" : ",") << "\n    ";
+			WriteString(stream, property.first);
+			stream << ": ";
+			WriteString(stream, property.second);
+			isFirst = false;
+		}
+		stream << (isFirst ? "" : "\n  ") << "},\n";
+
+		// Nested one level deeper than FrameStatistics writes it
+		ostringstream frameTimes;
+		mFrameTimes.WriteJson(frameTimes);
+		string frameTimesJson = frameTimes.str();
+		frameTimesJson.pop_back();
+		stream << "  \"frameTime\": ";
+		for (char character : frameTimesJson)
+		{
+			stream << character;
+			if (character == '\n')
+			{
+				stream << "  ";
+			}
+		}
+		stream << ",\n";
+
+		stream << "  \"phases\": [";
+		for (size_t i = 0; i < mPhases.size(); ++i)
+		{
+			const Phase& phase = mPhases[i];
+			uint64_t allocationCount = accumulate(phase.Allocations.begin(), phase.Allocations.end(), uint64_t(0));
+
+			stream << (i == 0 ? "" : ",") << "\n    { \"name\": ";
+			WriteString(stream, phase.Name);
+			stream << ", ";
+			WriteDistribution(stream, phase.Nanoseconds);
+			stream << ", \"allocations\": " << allocationCount << ", \"allocationsPerFrame\": "
+				<< (phase.Allocations.empty() ? 0.0 : static_cast<double>(allocationCount) / phase.Allocations.size()) << " }";
+		}
+		stream << (mPhases.empty() ? "" : "\n  ") << "],\n";
+
+		uint64_t allocationCount = accumulate(mFrameAllocations.begin(), mFrameAllocations.end(), uint64_t(0));
+		uint64_t maxFrameAllocations = (mFrameAllocations.empty() ? 0 : *max_element(mFrameAllocations.begin(), mFrameAllocations.end()));
+		stream << "  \"allocations\": { \"total\": " << allocationCount << ", \"bytes\": " << mAllocatedBytes << ", \"perFrameMean\": "
+			<< (mFrameAllocations.empty() ? 0.0 : static_cast<double>(allocationCount) / mFrameAllocations.size())
+			<< ", \"perFrameMax\": " << maxFrameAllocations << " }";
+
+		if (mSegments.empty() == false)
+		{
+			stream << ",\n  \"segments\": [";
+			for (uint32_t segment = 0; segment < mSegments.size(); ++segment)
+			{
+				vector<uint64_t> frameNanoseconds;
+				for (size_t frame = 0; frame < mFrameSegments.size(); ++frame)
+				{
+					if (mFrameSegments[frame] == segment)
+					{
+						frameNanoseconds.push_back(mFrameNanoseconds[frame]);
+					}
+				}
+
+				stream << (segment == 0 ? "" : ",") << "\n    { \"name\": ";
+				WriteString(stream, mSegments[segment]);
+				stream << ", \"frames\": " << frameNanoseconds.size() << ",\n      \"frameTime\": { ";
+				WriteDistribution(stream, frameNanoseconds);
+				stream << " },\n      \"phases\": [";
+				for (size_t i = 0; i < mPhases.size(); ++i)
+				{
+					vector<uint64_t> phaseNanoseconds;
+					for (size_t frame = 0; frame < mFrameSegments.size(); ++frame)
+					{
+						if (mFrameSegments[frame] == segment)
+						{
+							phaseNanoseconds.push_back(mPhases[i].Nanoseconds[frame]);
+						}
+					}
+
+					stream << (i == 0 ? "" : ",") << "\n        { \"name\": ";
+					WriteString(stream, mPhases[i].Name);
+					stream << ", ";
+					WriteDistribution(stream, phaseNanoseconds);
+					stream << " }";
+				}
+				stream << (mPhases.empty() ? "" : "\n      ") << "] }";
+			}
+			stream << "\n  ]";
+		}
+		stream << "\n}\n";
+	}
+
+	bool Benchmark::IsRecording() const
+	{
+		return (mSegmentFramesBegun > mWarmupFrameCount && mSegmentRecordedFrameCount < mFrameCount);
+	}
+
+	void Benchmark::WriteString(ostream& stream, const string& value)
+	{
+		// Property values are often Windows paths
+		stream << '"';
+		for (char character : value)
+		{
+			if (character == '"' || character == '\\')
+			{
+				stream << '\\';
+			}
+
+			stream << character;
+		}
+		stream << '"';
+	}
+
+	void Benchmark::WriteDistribution(ostream& stream, vector<uint64_t> samples)
+	{
+		sort(samples.begin(), samples.end());
+		uint64_t total = accumulate(samples.begin(), samples.end(), uint64_t(0));
+
+		stream << "\"totalMilliseconds\": " << ToMilliseconds(total)
+			<< ", \"meanMilliseconds\": " << (samples.empty() ? 0.0 : ToMilliseconds(total) / samples.size())
+			<< ", \"p50Milliseconds\": " << ToMilliseconds(Percentile(samples, 50))
+			<< ", \"p95Milliseconds\": " << ToMilliseconds(Percentile(samples, 95))
+			<< ", \"p99Milliseconds\": " << ToMilliseconds(Percentile(samples, 99))
+			<< ", \"maxMilliseconds\": " << ToMilliseconds(samples.empty() ? 0 : samples.back());
+	}
+
+	uint64_t Benchmark::Percentile(const vector<uint64_t>& sorted, uint32_t percent)
+	{
+		if (sorted.empty())
+		{
+			return 0;
+		}
+
+		// Nearest rank, as FrameStatistics computes it
+		size_t rank = (percent * sorted.size() + 99) / 100;
+
+		return sorted[rank > 0 ? rank - 1 : 0];
+	}
+
+	double Benchmark::ToMilliseconds(uint64_t nanoseconds)
+	{
+		return static_cast<double>(nanoseconds) / 1000000.0;
+	}
+
+	BenchmarkPhaseScope::BenchmarkPhaseScope(Benchmark* benchmark, uint32_t phase) :
+		mBenchmark(benchmark), mPhase(phase), mStartTime(), mStartAllocations(0)
+	{
+		if (mBenchmark != nullptr)
+		{
+			mStartAllocations = AllocationCounter::AllocationCount();
+			mStartTime = high_resolution_clock::now();
+		}
+	}
+
+	BenchmarkPhaseScope::~BenchmarkPhaseScope()
+	{
+		if (mBenchmark != nullptr)
+		{
+			nanoseconds duration = duration_cast<nanoseconds>(high_resolution_clock::now() - mStartTime);
+			mBenchmark->AddPhaseTime(mPhase, duration, AllocationCounter::AllocationCount() - mStartAllocations);
+		}
+	}
+}
\ No newline at end of file
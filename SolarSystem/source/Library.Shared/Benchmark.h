@@ -0,0 +1,111 @@
+#pragma once
+
+#include "FrameStatistics.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include <iosfwd>
+#include <cstdint>
+
+namespace Library
+{
+	// Records a benchmark run of a fixed number of frames: the time between successive BeginFrame() calls, the CPU time of named
+	// phases and the heap allocations (as counted by AllocationCounter) made during each. The first warm-up frames are run but
+	// not recorded. Phases are timed with BenchmarkPhaseScope and may run any number of times per frame; their times add up.
+	// A run may be split into segments that each record the frame count after their own warm-up, so that configurations can be
+	// compared in one run, e.g. pipelined and serial simulation; the caller switches configuration when a segment starts.
+	// Everything is recorded on the thread that calls BeginFrame(). Nothing in this header depends on Windows.
+	class Benchmark final
+	{
+	public:
+		// Segments run in the order given. Without any, the run is a single unnamed segment.
+		Benchmark(const std::string& name, std::uint32_t frameCount, std::uint32_t warmupFrameCount,
+			const std::vector<std::string>& segments = std::vector<std::string>());
+		Benchmark(const Benchmark&) = delete;
+		Benchmark& operator=(const Benchmark&) = delete;
+		Benchmark(Benchmark&&) = delete;
+		Benchmark& operator=(Benchmark&&) = delete;
+		~Benchmark() = default;
+
+		std::uint32_t AddPhase(const std::string& name);
+
+		// Written to the report's configuration section, e.g. the renderer and the time step.
+		void SetProperty(const std::string& key, const std::string& value);
+
+		// Ends the current frame, if any, and starts the next one. Returns false once every frame has been recorded.
+		bool BeginFrame();
+		void AddPhaseTime(std::uint32_t phase, std::chrono::nanoseconds duration, std::uint64_t allocationCount);
+
+		bool IsComplete() const;
+		std::uint32_t FrameCount() const;
+		std::uint32_t WarmupFrameCount() const;
+		std::uint32_t RecordedFrameCount() const;
+		std::uint32_t SegmentCount() const;
+		std::uint32_t CurrentSegment() const;
+
+		// The index of the current frame within its segment, counting the warm-up. 0 on a segment's first frame.
+		std::uint32_t SegmentFrameIndex() const;
+		const FrameStatistics& FrameTimes() const;
+
+		// Configuration, frame-time distribution (FrameStatistics::WriteJson()), per-phase times and allocation counts, followed by
+		// the frame and phase times of each segment.
+		void WriteJson(std::ostream& stream) const;
+
+	private:
+		struct Phase
+		{
+			std::string Name;
+			std::vector<std::uint64_t> Nanoseconds;
+			std::vector<std::uint64_t> Allocations;
+			std::uint64_t FrameNanoseconds;
+			std::uint64_t FrameAllocations;
+
+			explicit Phase(const std::string& name) :
+				Name(name), FrameNanoseconds(0), FrameAllocations(0) { }
+		};
+
+		bool IsRecording() const;
+		static void WriteString(std::ostream& stream, const std::string& value);
+		static void WriteDistribution(std::ostream& stream, std::vector<std::uint64_t> samples);
+		static std::uint64_t Percentile(const std::vector<std::uint64_t>& sorted, std::uint32_t percent);
+		static double ToMilliseconds(std::uint64_t nanoseconds);
+
+		std::string mName;
+		std::uint32_t mFrameCount;
+		std::uint32_t mWarmupFrameCount;
+		std::uint32_t mFramesBegun;
+		std::vector<std::string> mSegments;
+		std::uint32_t mCurrentSegment;
+		std::uint32_t mSegmentFramesBegun;
+		std::uint32_t mSegmentRecordedFrameCount;
+		std::vector<std::uint32_t> mFrameSegments;
+		std::vector<std::uint64_t> mFrameNanoseconds;
+		std::map<std::string, std::string> mProperties;
+		std::vector<Phase> mPhases;
+		FrameStatistics mFrameTimes;
+		std::vector<std::uint64_t> mFrameAllocations;
+		std::uint64_t mAllocatedBytes;
+		std::chrono::high_resolution_clock::time_point mFrameStartTime;
+		std::uint64_t mFrameStartAllocations;
+		std::uint64_t mFrameStartBytes;
+	};
+
+	// Times the enclosing scope as one run of a benchmark phase. Does nothing if the benchmark is null.
+	class BenchmarkPhaseScope final
+	{
+	public:
+		BenchmarkPhaseScope(Benchmark* benchmark, std::uint32_t phase);
+		BenchmarkPhaseScope(const BenchmarkPhaseScope&) = delete;
+		BenchmarkPhaseScope& operator=(const BenchmarkPhaseScope&) = delete;
+		BenchmarkPhaseScope(BenchmarkPhaseScope&&) = delete;
+		BenchmarkPhaseScope& operator=(BenchmarkPhaseScope&&) = delete;
+		~BenchmarkPhaseScope();
+
+	private:
+		Benchmark* mBenchmark;
+		std::uint32_t mPhase;
+		std::chrono::high_resolution_clock::time_point mStartTime;
+		std::uint64_t mStartAllocations;
+	};
+}
\ No newline at end of file
@@ -11,9 +11,10 @@ namespace Library
 
 	Camera::Camera(Game& game, float nearPlaneDistance, float farPlaneDistance) :
 		GameComponent(game),
-		mNearPlaneDistance(nearPlaneDistance), mFarPlaneDistance(farPlaneDistance)
+		mNearPlaneDistance(nearPlaneDistance), mFarPlaneDistance(farPlaneDistance), mDerivedDataDirty(true)
 	{
 	}
+
 	const XMFLOAT3& Camera::Position() const
 	{
 		return mPosition;
@@ -76,10 +77,35 @@ namespace Library
 
 	XMMATRIX Camera::ViewProjectionMatrix() const
 	{
-		XMMATRIX viewMatrix = XMLoadFloat4x4(&mViewMatrix);
-		XMMATRIX projectionMatrix = XMLoadFloat4x4(&mProjectionMatrix);
+		UpdateDerivedData();
+
+		return XMLoadFloat4x4(&mViewProjectionMatrix);
+	}
+
+	XMMATRIX Camera::InverseViewProjectionMatrix() const
+	{
+		UpdateDerivedData();
 
-		return XMMatrixMultiply(viewMatrix, projectionMatrix);
+		return XMLoadFloat4x4(&mInverseViewProjectionMatrix);
+	}
+
+	const Frustum& Camera::ViewFrustum() const
+	{
+		UpdateDerivedData();
+
+		return mFrustum;
+	}
+
+	void Camera::CullSpheres(const BoundingSphereSet& spheres, uint8_t* visibility) const
+	{
+		FrustumCuller::Cull(ViewFrustum(), spheres, visibility);
+	}
+
+	float Camera::NormalizedDepth(FXMVECTOR position) const
+	{
+		float viewDepth = XMVectorGetX(XMVector3Dot(position - PositionVector(), DirectionVector()));
+
+		return (viewDepth - mNearPlaneDistance) / (mFarPlaneDistance - mNearPlaneDistance);
 	}
 
 	void Camera::SetPosition(float x, float y, float z)
@@ -98,6 +124,16 @@ namespace Library
 		mPosition = position;
 	}
 
+	void Camera::SetDirection(FXMVECTOR direction, FXMVECTOR up)
+	{
+		XMVECTOR forward = XMVector3Normalize(direction);
+		XMVECTOR right = XMVector3Normalize(XMVector3Cross(forward, up));
+
+		XMStoreFloat3(&mDirection, forward);
+		XMStoreFloat3(&mUp, XMVector3Cross(right, forward));
+		XMStoreFloat3(&mRight, right);
+	}
+
 	void Camera::Reset()
 	{
 		mPosition = Vector3Helper::Zero;
@@ -129,6 +165,7 @@ namespace Library
 
 		XMMATRIX viewMatrix = XMMatrixLookToRH(eyePosition, direction, upDirection);
 		XMStoreFloat4x4(&mViewMatrix, viewMatrix);
+		mDerivedDataDirty = true;
 	}
 
 	void Camera::ApplyRotation(CXMMATRIX transform)
@@ -155,4 +192,38 @@ namespace Library
 		XMMATRIX transformMatrix = XMLoadFloat4x4(&transform);
 		ApplyRotation(transformMatrix);
 	}
-}
+
+	void Camera::UpdateDerivedData() const
+	{
+		if (mDerivedDataDirty == false)
+		{
+			return;
+		}
+
+		XMMATRIX viewProjectionMatrix = XMMatrixMultiply(XMLoadFloat4x4(&mViewMatrix), XMLoadFloat4x4(&mProjectionMatrix));
+		XMStoreFloat4x4(&mViewProjectionMatrix, viewProjectionMatrix);
+		XMStoreFloat4x4(&mInverseViewProjectionMatrix, XMMatrixInverse(nullptr, viewProjectionMatrix));
+
+		// Extract the planes from the columns of the view-projection matrix (clip = position * viewProjection, with 0 <= z <= w).
+		const XMFLOAT4X4& m = mViewProjectionMatrix;
+		XMVECTOR column0 = XMVectorSet(m._11, m._21, m._31, m._41);
+		XMVECTOR column1 = XMVectorSet(m._12, m._22, m._32, m._42);
+		XMVECTOR column2 = XMVectorSet(m._13, m._23, m._33, m._43);
+		XMVECTOR column3 = XMVectorSet(m._14, m._24, m._34, m._44);
+
+		XMVECTOR planes[Frustum::PlaneCount];
+		planes[Frustum::Left] = column3 + column0;
+		planes[Frustum::Right] = column3 - column0;
+		planes[Frustum::Bottom] = column3 + column1;
+		planes[Frustum::Top] = column3 - column1;
+		planes[Frustum::Near] = column2;
+		planes[Frustum::Far] = column3 - column2;
+
+		for (int i = 0; i < Frustum::PlaneCount; ++i)
+		{
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(mFrustum.Planes[i]), XMPlaneNormalize(planes[i]));
+		}
+
+		mDerivedDataDirty = false;
+	}
+}
\ No newline at end of file
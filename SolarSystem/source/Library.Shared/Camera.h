@@ -2,6 +2,7 @@
 
 #include "GameComponent.h"
 #include <DirectXMath.h>
+#include "FrustumCuller.h"
 
 namespace Library
 {
@@ -35,11 +36,22 @@ namespace Library
 		DirectX::XMMATRIX ViewMatrix() const;
 		DirectX::XMMATRIX ProjectionMatrix() const;
 		DirectX::XMMATRIX ViewProjectionMatrix() const;
+		DirectX::XMMATRIX InverseViewProjectionMatrix() const;
+		const Frustum& ViewFrustum() const;
+
+		// Writes 1 to visibility[i] for each world-space sphere that intersects the view frustum and 0 otherwise.
+		void CullSpheres(const BoundingSphereSet& spheres, std::uint8_t* visibility) const;
+
+		// Distance of a world-space point along the view direction, scaled so the near plane is 0 and the far plane is 1.
+		float NormalizedDepth(DirectX::FXMVECTOR position) const;
 
 		virtual void SetPosition(float x, float y, float z);
 		virtual void SetPosition(DirectX::FXMVECTOR position);
 		virtual void SetPosition(const DirectX::XMFLOAT3& position);
 
+		// Looks along direction with the up vector as close to up as it can be. Neither needs to be normalized.
+		virtual void SetDirection(DirectX::FXMVECTOR direction, DirectX::FXMVECTOR up);
+
 		virtual void Reset();
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
@@ -62,5 +74,15 @@ namespace Library
 
 		DirectX::XMFLOAT4X4 mViewMatrix;
 		DirectX::XMFLOAT4X4 mProjectionMatrix;
+
+		// Set whenever mViewMatrix or mProjectionMatrix changes; the values below are rebuilt on next use.
+		mutable bool mDerivedDataDirty;
+
+	private:
+		void UpdateDerivedData() const;
+
+		mutable DirectX::XMFLOAT4X4 mViewProjectionMatrix;
+		mutable DirectX::XMFLOAT4X4 mInverseViewProjectionMatrix;
+		mutable Frustum mFrustum;
 	};
 }
\ No newline at end of file
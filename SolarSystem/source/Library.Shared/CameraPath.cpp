@@ -0,0 +1,113 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	CameraPath::CameraPath(const string& filename)
+	{
+		ifstream file(filename.c_str());
+		if (file.good() == false)
+		{
+			throw GameException("Could not open camera path.");
+		}
+
+		Load(file);
+	}
+
+	void CameraPath::Load(istream& stream)
+	{
+		mKeyframes.clear();
+
+		string line;
+		while (getline(stream, line))
+		{
+			line = line.substr(0, line.find('#'));
+			if (line.find_first_not_of(" \t\r") == string::npos)
+			{
+				continue;
+			}
+
+			istringstream fields(line);
+			float time;
+			Point position;
+			Point target;
+			fields >> time >> position.X >> position.Y >> position.Z >> target.X >> target.Y >> target.Z;
+			if (fields.fail() || (fields >> ws).eof() == false)
+			{
+				throw GameException("Malformed camera path keyframe.");
+			}
+
+			AddKeyframe(Keyframe(time, position, target));
+		}
+	}
+
+	void CameraPath::AddKeyframe(const Keyframe& keyframe)
+	{
+		if (mKeyframes.empty() == false && keyframe.Time <= mKeyframes.back().Time)
+		{
+			throw GameException("Camera path keyframe times must increase.");
+		}
+
+		mKeyframes.push_back(keyframe);
+	}
+
+	const vector<CameraPath::Keyframe>& CameraPath::Keyframes() const
+	{
+		return mKeyframes;
+	}
+
+	float CameraPath::Duration() const
+	{
+		return (mKeyframes.empty() ? 0.0f : mKeyframes.back().Time);
+	}
+
+	void CameraPath::Evaluate(float seconds, Point& position, Point& target) const
+	{
+		assert(mKeyframes.empty() == false);
+
+		if (seconds <= mKeyframes.front().Time || mKeyframes.size() == 1)
+		{
+			position = mKeyframes.front().Position;
+			target = mKeyframes.front().Target;
+			return;
+		}
+
+		if (seconds >= mKeyframes.back().Time)
+		{
+			position = mKeyframes.back().Position;
+			target = mKeyframes.back().Target;
+			return;
+		}
+
+		// The segment [i, i + 1] holding seconds; the end keyframes stand in for the missing neighbours.
+		size_t i = static_cast<size_t>(upper_bound(mKeyframes.begin(), mKeyframes.end(), seconds, [](float time, const Keyframe& keyframe)
+		{
+			return time < keyframe.Time;
+		}) - mKeyframes.begin()) - 1;
+
+		const Keyframe& previous = mKeyframes[i > 0 ? i - 1 : i];
+		const Keyframe& start = mKeyframes[i];
+		const Keyframe& end = mKeyframes[i + 1];
+		const Keyframe& next = mKeyframes[i + 2 < mKeyframes.size() ? i + 2 : i + 1];
+		float t = (seconds - start.Time) / (end.Time - start.Time);
+
+		position = CatmullRom(previous.Position, start.Position, end.Position, next.Position, t);
+		target = CatmullRom(previous.Target, start.Target, end.Target, next.Target, t);
+	}
+
+	CameraPath::Point CameraPath::CatmullRom(const Point& point0, const Point& point1, const Point& point2, const Point& point3, float t)
+	{
+		// Same weights as XMVectorCatmullRom
+		float t2 = t * t;
+		float t3 = t2 * t;
+		float weight0 = (-t3 + 2.0f * t2 - t) * 0.5f;
+		float weight1 = (3.0f * t3 - 5.0f * t2 + 2.0f) * 0.5f;
+		float weight2 = (-3.0f * t3 + 4.0f * t2 + t) * 0.5f;
+		float weight3 = (t3 - t2) * 0.5f;
+
+		return Point(point0.X * weight0 + point1.X * weight1 + point2.X * weight2 + point3.X * weight3,
+			point0.Y * weight0 + point1.Y * weight1 + point2.Y * weight2 + point3.Y * weight3,
+			point0.Z * weight0 + point1.Z * weight1 + point2.Z * weight2 + point3.Z * weight3);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+namespace Library
+{
+	// A scripted camera flight: keyframes of time, position and look-at target, joined by Catmull-Rom splines (the weights
+	// XMVectorCatmullRom uses). The path holds the first keyframe before it starts and the last one after it ends.
+	//
+	// Paths are text, one keyframe per line and '#' to the end of a line is a comment:
+	//   seconds  positionX positionY positionZ  targetX targetY targetZ
+	// Keyframe times must increase. Only the standard library is used, so the headless renderer follows the same paths.
+	class CameraPath final
+	{
+	public:
+		struct Point
+		{
+			float X;
+			float Y;
+			float Z;
+
+			Point(float x = 0.0f, float y = 0.0f, float z = 0.0f) :
+				X(x), Y(y), Z(z) { }
+		};
+
+		struct Keyframe
+		{
+			float Time;
+			Point Position;
+			Point Target;
+
+			Keyframe(float time, const Point& position, const Point& target) :
+				Time(time), Position(position), Target(target) { }
+		};
+
+		CameraPath() = default;
+		explicit CameraPath(const std::string& filename);
+		CameraPath(const CameraPath&) = default;
+		CameraPath& operator=(const CameraPath&) = default;
+		CameraPath(CameraPath&&) = default;
+		CameraPath& operator=(CameraPath&&) = default;
+		~CameraPath() = default;
+
+		// Throws GameException if the file can't be read or a line is malformed.
+		void Load(std::istream& stream);
+		void AddKeyframe(const Keyframe& keyframe);
+
+		const std::vector<Keyframe>& Keyframes() const;
+		float Duration() const;
+
+		void Evaluate(float seconds, Point& position, Point& target) const;
+
+	private:
+		static Point CatmullRom(const Point& point0, const Point& point1, const Point& point2, const Point& point3, float t);
+
+		std::vector<Keyframe> mKeyframes;
+	};
+}
\ No newline at end of file
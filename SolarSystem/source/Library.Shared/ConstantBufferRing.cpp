@@ -0,0 +1,257 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	const uint32_t ConstantBufferRing::DefaultSize = 256 * 1024;
+	const uint32_t ConstantBufferRing::Alignment = 256;
+	const uint32_t ConstantBufferRing::InitialFrameEntryCount = 512;
+
+	ConstantBufferRing::ConstantBufferRing(RenderDevice& device, uint32_t size) :
+		mDevice(&device), mSize(size), mOffset(0), mSupportsOffsets(device.SupportsConstantBufferOffsets()), mNeedsDiscard(true), mFallbackIndex(0),
+		mFrameEntries(InitialFrameEntryCount), mFrameEntryCount(0), mFrameNumber(1), mUploadCount(0), mUploadedBytes(0), mReusedCount(0)
+	{
+		assert(size > 0 && (size % Alignment) == 0);
+
+		// Both are cleared each frame without releasing their storage, so once they have grown to a frame's needs, allocating
+		// doesn't touch the heap.
+		mShadowData.reserve(size);
+
+		if (mSupportsOffsets)
+		{
+			mBuffer = CreateBuffer(mSize);
+		}
+	}
+
+	ConstantBufferRing::~ConstantBufferRing()
+	{
+		mDevice->Destroy(mBuffer);
+		for (BufferHandle retiredBuffer : mRetiredBuffers)
+		{
+			mDevice->Destroy(retiredBuffer);
+		}
+
+		for (const FallbackBuffer& fallbackBuffer : mFallbackBuffers)
+		{
+			mDevice->Destroy(fallbackBuffer.Buffer);
+		}
+	}
+
+	bool ConstantBufferRing::SupportsOffsets() const
+	{
+		return mSupportsOffsets;
+	}
+
+	uint32_t ConstantBufferRing::Size() const
+	{
+		return mSize;
+	}
+
+	void ConstantBufferRing::BeginFrame()
+	{
+		mNeedsDiscard = true;
+		mOffset = 0;
+		mFallbackIndex = 0;
+		for (BufferHandle retiredBuffer : mRetiredBuffers)
+		{
+			mDevice->Destroy(retiredBuffer);
+		}
+		mRetiredBuffers.clear();
+		mShadowData.clear();
+
+		// Advancing the frame number empties every slot.
+		mFrameEntryCount = 0;
+		if (++mFrameNumber == 0)
+		{
+			for (FrameEntry& entry : mFrameEntries)
+			{
+				entry.FrameNumber = 0;
+			}
+
+			mFrameNumber = 1;
+		}
+
+		mUploadCount = 0;
+		mUploadedBytes = 0;
+		mReusedCount = 0;
+	}
+
+	ConstantBufferRing::Allocation ConstantBufferRing::Allocate(const void* data, uint32_t size)
+	{
+		assert(data != nullptr);
+		assert(size > 0);
+
+		// Keep the table at most half full so that probes stay short.
+		if ((mFrameEntryCount + 1) * 2 > mFrameEntries.size())
+		{
+			GrowFrameEntries();
+		}
+
+		uint64_t hash = Hash(data, size);
+		uint32_t mask = static_cast<uint32_t>(mFrameEntries.size() - 1);
+		uint32_t slot = static_cast<uint32_t>(hash) & mask;
+		for (; mFrameEntries[slot].FrameNumber == mFrameNumber; slot = (slot + 1) & mask)
+		{
+			const FrameEntry& entry = mFrameEntries[slot];
+			if (entry.Hash == hash && entry.Size == size && memcmp(&mShadowData[entry.ShadowOffset], data, size) == 0)
+			{
+				++mReusedCount;
+				return entry.BlockAllocation;
+			}
+		}
+
+		uint32_t alignedSize = (size + Alignment - 1) & ~(Alignment - 1);
+		Allocation allocation = (mSupportsOffsets ? AllocateFromRing(data, size, alignedSize) : AllocateFromFallback(data, size, alignedSize));
+
+		FrameEntry& entry = mFrameEntries[slot];
+		entry.Hash = hash;
+		entry.FrameNumber = mFrameNumber;
+		entry.Size = size;
+		entry.ShadowOffset = mShadowData.size();
+		entry.BlockAllocation = allocation;
+		++mFrameEntryCount;
+
+		const char* bytes = static_cast<const char*>(data);
+		mShadowData.insert(mShadowData.end(), bytes, bytes + size);
+
+		return allocation;
+	}
+
+	void ConstantBufferRing::SetConstantBuffers(CommandEncoder& encoder, ShaderStage stage, uint32_t startSlot, uint32_t count, const Allocation* allocations) const
+	{
+		assert(startSlot + count <= CommandEncoder::MaxConstantBuffers);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const Allocation& allocation = allocations[i];
+			if (mSupportsOffsets)
+			{
+				encoder.SetConstantBufferRange(stage, startSlot + i, allocation.Buffer, allocation.FirstConstant, allocation.ConstantCount);
+			}
+			else
+			{
+				encoder.SetConstantBuffer(stage, startSlot + i, allocation.Buffer);
+			}
+		}
+	}
+
+	uint32_t ConstantBufferRing::UploadCount() const
+	{
+		return mUploadCount;
+	}
+
+	size_t ConstantBufferRing::UploadedBytes() const
+	{
+		return mUploadedBytes;
+	}
+
+	uint32_t ConstantBufferRing::ReusedCount() const
+	{
+		return mReusedCount;
+	}
+
+	ConstantBufferRing::Allocation ConstantBufferRing::AllocateFromRing(const void* data, uint32_t size, uint32_t alignedSize)
+	{
+		if (mOffset + alignedSize > mSize)
+		{
+			// Allocations are bound when the render queue executes at the end of the frame, so a full buffer is retired
+			// until the next BeginFrame() and replaced with a larger one rather than discarded under them.
+			mRetiredBuffers.push_back(mBuffer);
+			while (mSize < mOffset + alignedSize)
+			{
+				mSize *= 2;
+			}
+
+			mBuffer = CreateBuffer(mSize);
+			mNeedsDiscard = true;
+			mOffset = 0;
+		}
+
+		MapMode mode = (mNeedsDiscard ? MapMode::Discard : MapMode::NoOverwrite);
+		mNeedsDiscard = false;
+
+		Upload(mBuffer, mode, mOffset, data, size);
+
+		Allocation allocation(mBuffer, mOffset / 16, alignedSize / 16);
+		mOffset += alignedSize;
+
+		return allocation;
+	}
+
+	ConstantBufferRing::Allocation ConstantBufferRing::AllocateFromFallback(const void* data, uint32_t size, uint32_t alignedSize)
+	{
+		if (mFallbackIndex == mFallbackBuffers.size())
+		{
+			mFallbackBuffers.emplace_back();
+		}
+
+		FallbackBuffer& fallbackBuffer = mFallbackBuffers[mFallbackIndex++];
+		if (fallbackBuffer.Size < alignedSize)
+		{
+			mDevice->Destroy(fallbackBuffer.Buffer);
+			fallbackBuffer.Buffer = CreateBuffer(alignedSize);
+			fallbackBuffer.Size = alignedSize;
+		}
+
+		Upload(fallbackBuffer.Buffer, MapMode::Discard, 0, data, size);
+
+		return Allocation(fallbackBuffer.Buffer, 0, fallbackBuffer.Size / 16);
+	}
+
+	BufferHandle ConstantBufferRing::CreateBuffer(uint32_t size)
+	{
+		return mDevice->CreateBuffer(BufferDescription(BufferType::Constant, ResourceUsage::Dynamic, size), nullptr);
+	}
+
+	void ConstantBufferRing::Upload(BufferHandle buffer, MapMode mode, uint32_t offset, const void* data, uint32_t size)
+	{
+		CommandEncoder& encoder = mDevice->ImmediateEncoder();
+
+		// Devices that report errors rather than throw hand back null.
+		void* mappedData = encoder.Map(buffer, mode);
+		if (mappedData != nullptr)
+		{
+			memcpy(static_cast<char*>(mappedData) + offset, data, size);
+			encoder.Unmap(buffer);
+		}
+
+		++mUploadCount;
+		mUploadedBytes += size;
+	}
+
+	void ConstantBufferRing::GrowFrameEntries()
+	{
+		vector<FrameEntry> frameEntries(mFrameEntries.size() * 2);
+		uint32_t mask = static_cast<uint32_t>(frameEntries.size() - 1);
+		for (const FrameEntry& entry : mFrameEntries)
+		{
+			if (entry.FrameNumber == mFrameNumber)
+			{
+				uint32_t slot = static_cast<uint32_t>(entry.Hash) & mask;
+				while (frameEntries[slot].FrameNumber == mFrameNumber)
+				{
+					slot = (slot + 1) & mask;
+				}
+
+				frameEntries[slot] = entry;
+			}
+		}
+
+		mFrameEntries.swap(frameEntries);
+	}
+
+	uint64_t ConstantBufferRing::Hash(const void* data, uint32_t size)
+	{
+		// 64-bit FNV-1a
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		uint64_t hash = 14695981039346656037ULL;
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+
+		return hash;
+	}
+}
\ No newline at end of file
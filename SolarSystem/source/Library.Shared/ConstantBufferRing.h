@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "RenderDevice.h"
+
+namespace Library
+{
+	// Per-draw constants for a frame, written into one dynamic constant buffer and bound by range where the device supports
+	// constant buffer offsets, or into a dynamic buffer per block where it doesn't. Uploads go through the device's immediate encoder.
+	class ConstantBufferRing final
+	{
+	public:
+		struct Allocation
+		{
+			BufferHandle Buffer;
+			std::uint32_t FirstConstant;
+			std::uint32_t ConstantCount;
+
+			Allocation() :
+				Buffer(), FirstConstant(0), ConstantCount(0) { }
+			Allocation(BufferHandle buffer, std::uint32_t firstConstant, std::uint32_t constantCount) :
+				Buffer(buffer), FirstConstant(firstConstant), ConstantCount(constantCount) { }
+		};
+
+		explicit ConstantBufferRing(RenderDevice& device, std::uint32_t size = DefaultSize);
+		ConstantBufferRing(const ConstantBufferRing&) = delete;
+		ConstantBufferRing& operator=(const ConstantBufferRing&) = delete;
+		ConstantBufferRing(ConstantBufferRing&&) = delete;
+		ConstantBufferRing& operator=(ConstantBufferRing&&) = delete;
+		~ConstantBufferRing();
+
+		bool SupportsOffsets() const;
+		std::uint32_t Size() const;
+
+		void BeginFrame();
+
+		// Identical blocks allocated within a frame share one upload. Allocations stay valid until the next BeginFrame().
+		Allocation Allocate(const void* data, std::uint32_t size);
+
+		template <typename T>
+		Allocation Allocate(const T& data)
+		{
+			return Allocate(&data, sizeof(T));
+		}
+
+		// Binding only reads the allocations, so deferred encoders may bind on worker threads.
+		void SetConstantBuffers(CommandEncoder& encoder, ShaderStage stage, std::uint32_t startSlot, std::uint32_t count, const Allocation* allocations) const;
+
+		std::uint32_t UploadCount() const;
+		std::size_t UploadedBytes() const;
+		std::uint32_t ReusedCount() const;
+
+		static const std::uint32_t DefaultSize;
+		static const std::uint32_t Alignment;
+
+	private:
+		// A slot of the open-addressed table of this frame's blocks; slots stamped with an earlier frame are empty.
+		struct FrameEntry
+		{
+			std::uint64_t Hash;
+			std::uint32_t FrameNumber;
+			std::uint32_t Size;
+			std::size_t ShadowOffset;
+			Allocation BlockAllocation;
+
+			FrameEntry() :
+				Hash(0), FrameNumber(0), Size(0), ShadowOffset(0) { }
+		};
+
+		struct FallbackBuffer
+		{
+			BufferHandle Buffer;
+			std::uint32_t Size;
+
+			FallbackBuffer() :
+				Buffer(), Size(0) { }
+		};
+
+		Allocation AllocateFromRing(const void* data, std::uint32_t size, std::uint32_t alignedSize);
+		Allocation AllocateFromFallback(const void* data, std::uint32_t size, std::uint32_t alignedSize);
+		BufferHandle CreateBuffer(std::uint32_t size);
+		void Upload(BufferHandle buffer, MapMode mode, std::uint32_t offset, const void* data, std::uint32_t size);
+		void GrowFrameEntries();
+
+		static std::uint64_t Hash(const void* data, std::uint32_t size);
+
+		static const std::uint32_t InitialFrameEntryCount;
+
+		RenderDevice* mDevice;
+		BufferHandle mBuffer;
+		std::vector<BufferHandle> mRetiredBuffers;
+		std::uint32_t mSize;
+		std::uint32_t mOffset;
+		bool mSupportsOffsets;
+		bool mNeedsDiscard;
+		std::vector<FallbackBuffer> mFallbackBuffers;
+		std::uint32_t mFallbackIndex;
+		std::vector<FrameEntry> mFrameEntries;
+		std::uint32_t mFrameEntryCount;
+		std::uint32_t mFrameNumber;
+		std::vector<char> mShadowData;
+		std::uint32_t mUploadCount;
+		std::size_t mUploadedBytes;
+		std::uint32_t mReusedCount;
+	};
+}
\ No newline at end of file
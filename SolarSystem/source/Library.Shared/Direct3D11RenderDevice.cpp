@@ -0,0 +1,948 @@
+#include "pch.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Microsoft::WRL;
+
+namespace Library
+{
+	Direct3D11RenderDevice::Direct3D11RenderDevice(ID3D11Device1* device, Direct3DStateCache& stateCache) :
+		mDevice(device), mStateCache(&stateCache), mImmediateEncoder(*this, stateCache), mSupportsConstantBufferOffsets(false), mSupportsDeferredEncoders(false)
+	{
+		assert(mDevice != nullptr);
+
+		mDevice->GetImmediateContext1(mContext.GetAddressOf());
+		CreateStates();
+
+		D3D11_FEATURE_DATA_D3D11_OPTIONS options = { 0 };
+		if (SUCCEEDED(mDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))))
+		{
+			mSupportsConstantBufferOffsets = (options.ConstantBufferOffsetting != FALSE && options.MapNoOverwriteOnDynamicConstantBuffer != FALSE);
+		}
+
+		// Without driver support the runtime emulates command lists on one thread, which only adds overhead.
+		D3D11_FEATURE_DATA_THREADING threading = { 0 };
+		if (SUCCEEDED(mDevice->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading))))
+		{
+			mSupportsDeferredEncoders = (threading.DriverCommandLists != FALSE);
+		}
+	}
+
+	Direct3D11RenderDevice::~Direct3D11RenderDevice() = default;
+
+	void Direct3D11RenderDevice::Reset(ID3D11Device1* device)
+	{
+		assert(device != nullptr);
+
+		// Release everything on the lost device before creating anything on the new one.
+		mDeferredEncoders.clear();
+		mSpriteBatch = nullptr;
+		for (Buffer& buffer : mBuffers)
+		{
+			buffer.Resource = nullptr;
+		}
+
+		for (Texture& texture : mTextures)
+		{
+			texture.View = nullptr;
+		}
+
+		for (Shader& shader : mShaders)
+		{
+			shader.VertexShader = nullptr;
+			shader.PixelShader = nullptr;
+		}
+
+		for (PipelineState& pipelineState : mPipelineStates)
+		{
+			pipelineState.InputLayout = nullptr;
+			pipelineState.VertexShader = nullptr;
+			pipelineState.PixelShader = nullptr;
+		}
+
+		for (Font& font : mFonts)
+		{
+			font.SpriteFont = nullptr;
+			font.SpriteSheet = nullptr;
+		}
+
+		mContext = nullptr;
+		mDevice = device;
+		mDevice->GetImmediateContext1(mContext.GetAddressOf());
+		CreateStates();
+
+		for (Buffer& buffer : mBuffers)
+		{
+			if (IsAlive(buffer))
+			{
+				CreateBufferObject(buffer);
+			}
+		}
+
+		// Shaders come before the pipeline states, which share their native objects.
+		for (Shader& shader : mShaders)
+		{
+			if (IsAlive(shader))
+			{
+				CreateShaderObject(shader);
+			}
+		}
+
+		for (PipelineState& pipelineState : mPipelineStates)
+		{
+			if (IsAlive(pipelineState))
+			{
+				CreatePipelineStateObject(pipelineState);
+			}
+		}
+
+		for (Texture& texture : mTextures)
+		{
+			if (IsAlive(texture))
+			{
+				CreateTextureObject(texture);
+			}
+		}
+
+		for (Font& font : mFonts)
+		{
+			if (IsAlive(font))
+			{
+				CreateFontObject(font);
+			}
+		}
+	}
+
+	const char* Direct3D11RenderDevice::Name() const
+	{
+		return "Direct3D 11";
+	}
+
+	bool Direct3D11RenderDevice::SupportsConstantBufferOffsets() const
+	{
+		return mSupportsConstantBufferOffsets;
+	}
+
+	BufferHandle Direct3D11RenderDevice::CreateBuffer(const BufferDescription& description, const void* initialData)
+	{
+		if (description.ByteWidth == 0)
+		{
+			throw GameException("Buffers cannot be empty.");
+		}
+
+		Buffer buffer;
+		buffer.Description = description;
+		if (initialData != nullptr && description.Usage != ResourceUsage::Dynamic)
+		{
+			const char* bytes = static_cast<const char*>(initialData);
+			buffer.Contents.assign(bytes, bytes + description.ByteWidth);
+		}
+
+		CreateBufferObject(buffer);
+
+		// Dynamic buffers keep no copy, so their initial data goes straight to the new object.
+		if (initialData != nullptr && description.Usage == ResourceUsage::Dynamic)
+		{
+			D3D11_MAPPED_SUBRESOURCE mappedResource;
+			ThrowIfFailed(mContext->Map(buffer.Resource.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource), "ID3D11DeviceContext::Map() failed.");
+			memcpy(mappedResource.pData, initialData, description.ByteWidth);
+			mContext->Unmap(buffer.Resource.Get(), 0);
+		}
+
+		mBuffers.push_back(move(buffer));
+
+		return BufferHandle(static_cast<uint32_t>(mBuffers.size()));
+	}
+
+	TextureHandle Direct3D11RenderDevice::CreateTextureFromFile(const wstring& filename)
+	{
+		Texture texture;
+		texture.Filenames.push_back(filename);
+		texture.Width = 0;
+		texture.Height = 0;
+		CreateTextureObject(texture);
+		mTextures.push_back(move(texture));
+
+		return TextureHandle(static_cast<uint32_t>(mTextures.size()));
+	}
+
+	TextureHandle Direct3D11RenderDevice::CreateTextureArrayFromFiles(const vector<wstring>& filenames, uint32_t width, uint32_t height)
+	{
+		if (filenames.empty() || width == 0 || height == 0)
+		{
+			throw GameException("Texture arrays need at least one file and a size.");
+		}
+
+		Texture texture;
+		texture.Filenames = filenames;
+		texture.Width = width;
+		texture.Height = height;
+		CreateTextureObject(texture);
+		mTextures.push_back(move(texture));
+
+		return TextureHandle(static_cast<uint32_t>(mTextures.size()));
+	}
+
+	ShaderHandle Direct3D11RenderDevice::CreateShader(ShaderStage stage, const vector<char>& bytecode)
+	{
+		if (bytecode.empty())
+		{
+			throw GameException("Shader bytecode is empty.");
+		}
+
+		// Input layouts are validated against the vertex shader's signature, and every shader is recreated from its bytecode after
+		// device loss.
+		Shader shader;
+		shader.Stage = stage;
+		shader.Bytecode = make_shared<const vector<char>>(bytecode);
+		CreateShaderObject(shader);
+		mShaders.push_back(move(shader));
+
+		return ShaderHandle(static_cast<uint32_t>(mShaders.size()));
+	}
+
+	PipelineStateHandle Direct3D11RenderDevice::CreatePipelineState(const PipelineStateDescription& description)
+	{
+		const Shader& vertexShader = Lookup(mShaders, description.VertexShader.Id, "vertex shader");
+		const Shader& pixelShader = Lookup(mShaders, description.PixelShader.Id, "pixel shader");
+		if (vertexShader.Stage != ShaderStage::Vertex || pixelShader.Stage != ShaderStage::Pixel)
+		{
+			throw GameException("Pipeline state shaders are bound to the wrong stages.");
+		}
+
+		PipelineState pipelineState(description);
+		pipelineState.VertexShaderBytecode = vertexShader.Bytecode;
+		pipelineState.PixelShaderBytecode = pixelShader.Bytecode;
+		CreatePipelineStateObject(pipelineState);
+		mPipelineStates.push_back(move(pipelineState));
+
+		return PipelineStateHandle(static_cast<uint32_t>(mPipelineStates.size()));
+	}
+
+	FontHandle Direct3D11RenderDevice::CreateFontFromFile(const wstring& filename)
+	{
+		Font font;
+		font.Filename = filename;
+		CreateFontObject(font);
+		mFonts.push_back(move(font));
+
+		return FontHandle(static_cast<uint32_t>(mFonts.size()));
+	}
+
+	float Direct3D11RenderDevice::LineSpacing(FontHandle font)
+	{
+		return Lookup(mFonts, font.Id, "font").SpriteFont->GetLineSpacing();
+	}
+
+	FontGlyph Direct3D11RenderDevice::Glyph(FontHandle font, wchar_t character)
+	{
+		const SpriteFont::Glyph* glyph = Lookup(mFonts, font.Id, "font").SpriteFont->FindGlyph(character);
+
+		FontGlyph fontGlyph;
+		fontGlyph.Subrect.Left = glyph->Subrect.left;
+		fontGlyph.Subrect.Top = glyph->Subrect.top;
+		fontGlyph.Subrect.Right = glyph->Subrect.right;
+		fontGlyph.Subrect.Bottom = glyph->Subrect.bottom;
+		fontGlyph.XOffset = glyph->XOffset;
+		fontGlyph.YOffset = glyph->YOffset;
+		fontGlyph.XAdvance = glyph->XAdvance;
+
+		return fontGlyph;
+	}
+
+	void Direct3D11RenderDevice::Destroy(BufferHandle buffer)
+	{
+		if (buffer.IsValid())
+		{
+			Lookup(mBuffers, buffer.Id, "buffer") = Buffer();
+		}
+	}
+
+	void Direct3D11RenderDevice::Destroy(TextureHandle texture)
+	{
+		if (texture.IsValid())
+		{
+			Lookup(mTextures, texture.Id, "texture") = Texture();
+		}
+	}
+
+	void Direct3D11RenderDevice::Destroy(ShaderHandle shader)
+	{
+		if (shader.IsValid())
+		{
+			Lookup(mShaders, shader.Id, "shader") = Shader();
+		}
+	}
+
+	void Direct3D11RenderDevice::Destroy(PipelineStateHandle pipelineState)
+	{
+		if (pipelineState.IsValid())
+		{
+			PipelineState& target = Lookup(mPipelineStates, pipelineState.Id, "pipeline state");
+			target.SemanticNames.clear();
+			target.VertexShaderBytecode = nullptr;
+			target.PixelShaderBytecode = nullptr;
+			target.InputLayout = nullptr;
+			target.VertexShader = nullptr;
+			target.PixelShader = nullptr;
+		}
+	}
+
+	void Direct3D11RenderDevice::Destroy(FontHandle font)
+	{
+		if (font.IsValid())
+		{
+			Lookup(mFonts, font.Id, "font") = Font();
+		}
+	}
+
+	CommandEncoder& Direct3D11RenderDevice::ImmediateEncoder()
+	{
+		return mImmediateEncoder;
+	}
+
+	bool Direct3D11RenderDevice::SupportsDeferredEncoders() const
+	{
+		return mSupportsDeferredEncoders;
+	}
+
+	CommandEncoder& Direct3D11RenderDevice::BeginDeferred(uint32_t index)
+	{
+		assert(mSupportsDeferredEncoders);
+
+		while (mDeferredEncoders.size() <= index)
+		{
+			ComPtr<ID3D11DeviceContext1> deferredContext;
+			ThrowIfFailed(mDevice->CreateDeferredContext1(0, deferredContext.GetAddressOf()), "ID3D11Device1::CreateDeferredContext1() failed.");
+			mDeferredEncoders.push_back(make_unique<DeferredEncoder>(*this, deferredContext.Get()));
+		}
+
+		// Deferred contexts start from the default pipeline state, so the render target and viewport are carried over explicitly.
+		DeferredEncoder& deferredEncoder = *mDeferredEncoders[index];
+		OutputState(mContext.Get()).Apply(deferredEncoder.Context.Get());
+		deferredEncoder.StateCache.Invalidate();
+
+		return deferredEncoder.Commands;
+	}
+
+	void Direct3D11RenderDevice::ExecuteDeferred(uint32_t index)
+	{
+		DeferredEncoder& deferredEncoder = *mDeferredEncoders.at(index);
+
+		ComPtr<ID3D11CommandList> commandList;
+		ThrowIfFailed(deferredEncoder.Context->FinishCommandList(FALSE, commandList.GetAddressOf()), "ID3D11DeviceContext::FinishCommandList() failed.");
+
+		// Executing without restoring leaves the immediate context in its default state.
+		OutputState outputState(mContext.Get());
+		mContext->ExecuteCommandList(commandList.Get(), FALSE);
+		outputState.Apply(mContext.Get());
+		mStateCache->Invalidate();
+	}
+
+	ID3D11Buffer* Direct3D11RenderDevice::NativeBuffer(BufferHandle buffer) const
+	{
+		return Lookup(mBuffers, buffer.Id, "buffer").Resource.Get();
+	}
+
+	ID3D11ShaderResourceView* Direct3D11RenderDevice::NativeTexture(TextureHandle texture) const
+	{
+		return Lookup(mTextures, texture.Id, "texture").View.Get();
+	}
+
+	Direct3D11RenderDevice::Encoder::Encoder(Direct3D11RenderDevice& device, Direct3DStateCache& stateCache) :
+		mDevice(&device), mStateCache(&stateCache)
+	{
+	}
+
+	void Direct3D11RenderDevice::Encoder::UpdateBuffer(BufferHandle buffer, const void* data, uint32_t size)
+	{
+		Buffer& target = Lookup(mDevice->mBuffers, buffer.Id, "buffer");
+		assert(data != nullptr && size <= target.Description.ByteWidth);
+
+		ID3D11DeviceContext1* context = mStateCache->Context();
+		switch (target.Description.Usage)
+		{
+		case ResourceUsage::Dynamic:
+		{
+			D3D11_MAPPED_SUBRESOURCE mappedResource;
+			ThrowIfFailed(context->Map(target.Resource.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource), "ID3D11DeviceContext::Map() failed.");
+			memcpy(mappedResource.pData, data, size);
+			context->Unmap(target.Resource.Get(), 0);
+			break;
+		}
+
+		case ResourceUsage::Default:
+		{
+			// The copy is what Reset() restores.
+			const char* bytes = static_cast<const char*>(data);
+			target.Contents.resize(target.Description.ByteWidth);
+			copy(bytes, bytes + size, target.Contents.begin());
+			context->UpdateSubresource(target.Resource.Get(), 0, nullptr, data, 0, 0);
+			break;
+		}
+
+		default:
+			throw GameException("Immutable buffers cannot be updated.");
+		}
+	}
+
+	void* Direct3D11RenderDevice::Encoder::Map(BufferHandle buffer, MapMode mode)
+	{
+		const Buffer& target = Lookup(mDevice->mBuffers, buffer.Id, "buffer");
+		if (target.Description.Usage != ResourceUsage::Dynamic)
+		{
+			throw GameException("Only dynamic buffers can be mapped.");
+		}
+
+		D3D11_MAPPED_SUBRESOURCE mappedResource;
+		ThrowIfFailed(mStateCache->Context()->Map(target.Resource.Get(), 0, (mode == MapMode::Discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE), 0, &mappedResource), "ID3D11DeviceContext::Map() failed.");
+
+		return mappedResource.pData;
+	}
+
+	void Direct3D11RenderDevice::Encoder::Unmap(BufferHandle buffer)
+	{
+		mStateCache->Context()->Unmap(Lookup(mDevice->mBuffers, buffer.Id, "buffer").Resource.Get(), 0);
+	}
+
+	void Direct3D11RenderDevice::Encoder::SetPipelineState(PipelineStateHandle pipelineState)
+	{
+		const PipelineState& state = Lookup(mDevice->mPipelineStates, pipelineState.Id, "pipeline state");
+
+		mStateCache->IASetInputLayout(state.InputLayout.Get());
+		mStateCache->IASetPrimitiveTopology(state.Topology);
+		mStateCache->VSSetShader(state.VertexShader.Get(), nullptr, 0);
+		mStateCache->PSSetShader(state.PixelShader.Get(), nullptr, 0);
+		mStateCache->RSSetState(state.RasterizerState);
+		mStateCache->OMSetBlendState(state.BlendState, nullptr, 0xFFFFFFFF);
+		mStateCache->OMSetDepthStencilState(state.DepthStencilState, 0);
+		if (state.SamplerState != nullptr)
+		{
+			mStateCache->PSSetSamplers(0, 1, &state.SamplerState);
+		}
+	}
+
+	void Direct3D11RenderDevice::Encoder::SetVertexBuffer(uint32_t slot, BufferHandle buffer, uint32_t stride, uint32_t offset)
+	{
+		ID3D11Buffer* vertexBuffer = Lookup(mDevice->mBuffers, buffer.Id, "vertex buffer").Resource.Get();
+		mStateCache->IASetVertexBuffers(slot, 1, &vertexBuffer, &stride, &offset);
+	}
+
+	void Direct3D11RenderDevice::Encoder::SetIndexBuffer(BufferHandle buffer, IndexFormat format, uint32_t offset)
+	{
+		ID3D11Buffer* indexBuffer = Lookup(mDevice->mBuffers, buffer.Id, "index buffer").Resource.Get();
+		mStateCache->IASetIndexBuffer(indexBuffer, (format == IndexFormat::UInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT), offset);
+	}
+
+	void Direct3D11RenderDevice::Encoder::SetConstantBuffer(ShaderStage stage, uint32_t slot, BufferHandle buffer)
+	{
+		ID3D11Buffer* constantBuffer = Lookup(mDevice->mBuffers, buffer.Id, "constant buffer").Resource.Get();
+		if (stage == ShaderStage::Vertex)
+		{
+			mStateCache->VSSetConstantBuffers(slot, 1, &constantBuffer);
+		}
+		else
+		{
+			mStateCache->PSSetConstantBuffers(slot, 1, &constantBuffer);
+		}
+	}
+
+	void Direct3D11RenderDevice::Encoder::SetConstantBufferRange(ShaderStage stage, uint32_t slot, BufferHandle buffer, uint32_t firstConstant, uint32_t constantCount)
+	{
+		assert(mDevice->mSupportsConstantBufferOffsets);
+
+		ID3D11Buffer* constantBuffer = Lookup(mDevice->mBuffers, buffer.Id, "constant buffer").Resource.Get();
+		if (stage == ShaderStage::Vertex)
+		{
+			mStateCache->VSSetConstantBuffers1(slot, 1, &constantBuffer, &firstConstant, &constantCount);
+		}
+		else
+		{
+			mStateCache->PSSetConstantBuffers1(slot, 1, &constantBuffer, &firstConstant, &constantCount);
+		}
+	}
+
+	void Direct3D11RenderDevice::Encoder::SetTexture(ShaderStage stage, uint32_t slot, TextureHandle texture)
+	{
+		ID3D11ShaderResourceView* shaderResourceView = (texture.IsValid() ? Lookup(mDevice->mTextures, texture.Id, "texture").View.Get() : nullptr);
+		if (stage == ShaderStage::Vertex)
+		{
+			// The state cache only tracks pixel shader resources.
+			mStateCache->Context()->VSSetShaderResources(slot, 1, &shaderResourceView);
+		}
+		else
+		{
+			mStateCache->PSSetShaderResources(slot, 1, &shaderResourceView);
+		}
+	}
+
+	void Direct3D11RenderDevice::Encoder::Draw(uint32_t vertexCount, uint32_t startVertex)
+	{
+		mStateCache->Context()->Draw(vertexCount, startVertex);
+	}
+
+	void Direct3D11RenderDevice::Encoder::DrawInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance)
+	{
+		mStateCache->Context()->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+	}
+
+	void Direct3D11RenderDevice::Encoder::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+	{
+		mStateCache->Context()->DrawIndexed(indexCount, startIndex, baseVertex);
+	}
+
+	void Direct3D11RenderDevice::Encoder::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+	{
+		mStateCache->Context()->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+	}
+
+	void Direct3D11RenderDevice::Encoder::DrawGlyphs(FontHandle font, const GlyphSprite* glyphs, uint32_t count)
+	{
+		if (this != &mDevice->mImmediateEncoder)
+		{
+			throw GameException("Only the immediate encoder draws text.");
+		}
+
+		const Font& target = Lookup(mDevice->mFonts, font.Id, "font");
+		if (mDevice->mSpriteBatch == nullptr)
+		{
+			mDevice->mSpriteBatch = make_unique<SpriteBatch>(mDevice->mContext.Get());
+		}
+
+		SpriteBatch& spriteBatch = *mDevice->mSpriteBatch;
+		spriteBatch.Begin();
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const GlyphSprite& glyph = glyphs[i];
+			RECT subrect = { glyph.Subrect.Left, glyph.Subrect.Top, glyph.Subrect.Right, glyph.Subrect.Bottom };
+			spriteBatch.Draw(target.SpriteSheet.Get(), XMFLOAT2(glyph.X, glyph.Y), &subrect, XMVectorSet(glyph.Color[0], glyph.Color[1], glyph.Color[2], glyph.Color[3]));
+		}
+
+		spriteBatch.End();
+
+		// SpriteBatch sets state behind the cache's back.
+		mStateCache->Invalidate();
+	}
+
+	uint32_t Direct3D11RenderDevice::Encoder::IssuedCallCount() const
+	{
+		return mStateCache->IssuedCallCount();
+	}
+
+	uint32_t Direct3D11RenderDevice::Encoder::FilteredCallCount() const
+	{
+		return mStateCache->FilteredCallCount();
+	}
+
+	Direct3D11RenderDevice::DeferredEncoder::DeferredEncoder(Direct3D11RenderDevice& device, ID3D11DeviceContext1* context) :
+		Context(context), StateCache(context), Commands(device, StateCache)
+	{
+	}
+
+	Direct3D11RenderDevice::OutputState::OutputState(ID3D11DeviceContext* context) :
+		ViewportCount(1)
+	{
+		context->OMGetRenderTargets(1, RenderTargetView.GetAddressOf(), DepthStencilView.GetAddressOf());
+		context->RSGetViewports(&ViewportCount, &Viewport);
+	}
+
+	void Direct3D11RenderDevice::OutputState::Apply(ID3D11DeviceContext* context) const
+	{
+		context->OMSetRenderTargets(1, RenderTargetView.GetAddressOf(), DepthStencilView.Get());
+		if (ViewportCount > 0)
+		{
+			context->RSSetViewports(1, &Viewport);
+		}
+	}
+
+	Direct3D11RenderDevice::PipelineState::PipelineState(const PipelineStateDescription& description) :
+		Description(description), Topology(D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED), RasterizerState(nullptr), BlendState(nullptr),
+		DepthStencilState(nullptr), SamplerState(nullptr)
+	{
+		// Semantic names usually point at literals, but nothing says they outlive the description, so the state keeps its own.
+		SemanticNames.reserve(Description.InputElements.size());
+		for (InputElement& element : Description.InputElements)
+		{
+			SemanticNames.push_back(element.SemanticName);
+			element.SemanticName = nullptr;
+		}
+	}
+
+	template <typename T>
+	T& Direct3D11RenderDevice::Lookup(vector<T>& objects, uint32_t id, const char* typeName)
+	{
+		return const_cast<T&>(Lookup(static_cast<const vector<T>&>(objects), id, typeName));
+	}
+
+	template <typename T>
+	const T& Direct3D11RenderDevice::Lookup(const vector<T>& objects, uint32_t id, const char* typeName)
+	{
+		if (id == 0 || id > objects.size() || IsAlive(objects[id - 1]) == false)
+		{
+			string message = string("Invalid ") + typeName + " handle.";
+			throw GameException(message.c_str());
+		}
+
+		return objects[id - 1];
+	}
+
+	bool Direct3D11RenderDevice::IsAlive(const Buffer& buffer)
+	{
+		return (buffer.Description.ByteWidth > 0);
+	}
+
+	bool Direct3D11RenderDevice::IsAlive(const Texture& texture)
+	{
+		return (texture.Filenames.empty() == false);
+	}
+
+	bool Direct3D11RenderDevice::IsAlive(const Shader& shader)
+	{
+		return (shader.Bytecode != nullptr);
+	}
+
+	bool Direct3D11RenderDevice::IsAlive(const PipelineState& pipelineState)
+	{
+		return (pipelineState.VertexShaderBytecode != nullptr);
+	}
+
+	bool Direct3D11RenderDevice::IsAlive(const Font& font)
+	{
+		return (font.Filename.empty() == false);
+	}
+
+	void Direct3D11RenderDevice::CreateStates()
+	{
+		D3D11_RASTERIZER_DESC rasterizerStateDesc;
+		ZeroMemory(&rasterizerStateDesc, sizeof(rasterizerStateDesc));
+		rasterizerStateDesc.FillMode = D3D11_FILL_SOLID;
+		rasterizerStateDesc.CullMode = D3D11_CULL_BACK;
+		rasterizerStateDesc.FrontCounterClockwise = true;
+		rasterizerStateDesc.DepthClipEnable = true;
+		ThrowIfFailed(mDevice->CreateRasterizerState(&rasterizerStateDesc, mFrontCullingState.ReleaseAndGetAddressOf()), "ID3D11Device::CreateRasterizerState() failed.");
+
+		rasterizerStateDesc.CullMode = D3D11_CULL_NONE;
+		rasterizerStateDesc.FrontCounterClockwise = false;
+		ThrowIfFailed(mDevice->CreateRasterizerState(&rasterizerStateDesc, mDisabledCullingState.ReleaseAndGetAddressOf()), "ID3D11Device::CreateRasterizerState() failed.");
+
+		rasterizerStateDesc.FillMode = D3D11_FILL_WIREFRAME;
+		ThrowIfFailed(mDevice->CreateRasterizerState(&rasterizerStateDesc, mWireframeState.ReleaseAndGetAddressOf()), "ID3D11Device::CreateRasterizerState() failed.");
+
+		D3D11_BLEND_DESC blendStateDesc = { 0 };
+		blendStateDesc.RenderTarget[0].BlendEnable = true;
+		blendStateDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+		blendStateDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+		blendStateDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+		blendStateDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ZERO;
+		blendStateDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+		blendStateDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+		blendStateDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+		ThrowIfFailed(mDevice->CreateBlendState(&blendStateDesc, mAlphaBlendingState.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBlendState() failed.");
+
+		CD3D11_DEPTH_STENCIL_DESC depthStencilDesc(D3D11_DEFAULT);
+		depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+		ThrowIfFailed(mDevice->CreateDepthStencilState(&depthStencilDesc, mReadOnlyDepthState.ReleaseAndGetAddressOf()), "ID3D11Device::CreateDepthStencilState() failed.");
+
+		depthStencilDesc.DepthEnable = false;
+		ThrowIfFailed(mDevice->CreateDepthStencilState(&depthStencilDesc, mDisabledDepthState.ReleaseAndGetAddressOf()), "ID3D11Device::CreateDepthStencilState() failed.");
+
+		D3D11_SAMPLER_DESC samplerStateDesc;
+		ZeroMemory(&samplerStateDesc, sizeof(samplerStateDesc));
+		samplerStateDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+		samplerStateDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
+		samplerStateDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
+		samplerStateDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+		samplerStateDesc.MinLOD = -FLT_MAX;
+		samplerStateDesc.MaxLOD = FLT_MAX;
+		samplerStateDesc.MaxAnisotropy = 1;
+		samplerStateDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+		ThrowIfFailed(mDevice->CreateSamplerState(&samplerStateDesc, mTrilinearWrapState.ReleaseAndGetAddressOf()), "ID3D11Device::CreateSamplerState() failed.");
+
+		samplerStateDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+		samplerStateDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+		samplerStateDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+		ThrowIfFailed(mDevice->CreateSamplerState(&samplerStateDesc, mTrilinearClampState.ReleaseAndGetAddressOf()), "ID3D11Device::CreateSamplerState() failed.");
+
+		samplerStateDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
+		ThrowIfFailed(mDevice->CreateSamplerState(&samplerStateDesc, mPointClampState.ReleaseAndGetAddressOf()), "ID3D11Device::CreateSamplerState() failed.");
+	}
+
+	void Direct3D11RenderDevice::CreateBufferObject(Buffer& buffer)
+	{
+		static const UINT BindFlags[] = { D3D11_BIND_VERTEX_BUFFER, D3D11_BIND_INDEX_BUFFER, D3D11_BIND_CONSTANT_BUFFER };
+
+		const BufferDescription& description = buffer.Description;
+		D3D11_BUFFER_DESC bufferDesc = { 0 };
+		bufferDesc.ByteWidth = description.ByteWidth;
+		bufferDesc.BindFlags = BindFlags[static_cast<int>(description.Type)];
+		switch (description.Usage)
+		{
+		case ResourceUsage::Immutable:
+			bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+			break;
+
+		case ResourceUsage::Dynamic:
+			bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+			bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+			break;
+
+		default:
+			bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+			break;
+		}
+
+		D3D11_SUBRESOURCE_DATA subResourceData = { 0 };
+		subResourceData.pSysMem = buffer.Contents.data();
+
+		ThrowIfFailed(mDevice->CreateBuffer(&bufferDesc, (buffer.Contents.empty() == false ? &subResourceData : nullptr), buffer.Resource.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+	}
+
+	void Direct3D11RenderDevice::CreateTextureObject(Texture& texture)
+	{
+		if (texture.Width == 0)
+		{
+			LoadTexture(texture.Filenames[0], texture.View.ReleaseAndGetAddressOf());
+			return;
+		}
+
+		// The source maps may differ in size and format, so each one is resampled into a slice of a common array and the mip chain regenerated.
+		D3D11_TEXTURE2D_DESC textureDesc = { 0 };
+		textureDesc.Width = texture.Width;
+		textureDesc.Height = texture.Height;
+		textureDesc.MipLevels = 0;
+		textureDesc.ArraySize = static_cast<UINT>(texture.Filenames.size());
+		textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.Usage = D3D11_USAGE_DEFAULT;
+		textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+		textureDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+		ComPtr<ID3D11Texture2D> textureArray;
+		ThrowIfFailed(mDevice->CreateTexture2D(&textureDesc, nullptr, textureArray.ReleaseAndGetAddressOf()), "ID3D11Device::CreateTexture2D() failed.");
+
+		OutputState previousOutputState(mContext.Get());
+
+		D3D11_VIEWPORT viewport = { 0.0f, 0.0f, static_cast<float>(texture.Width), static_cast<float>(texture.Height), 0.0f, 1.0f };
+		mContext->RSSetViewports(1, &viewport);
+
+		RECT destinationRectangle = { 0, 0, static_cast<LONG>(texture.Width), static_cast<LONG>(texture.Height) };
+		SpriteBatch spriteBatch(mContext.Get());
+
+		for (UINT i = 0; i < texture.Filenames.size(); ++i)
+		{
+			ComPtr<ID3D11ShaderResourceView> sourceTexture;
+			LoadTexture(texture.Filenames[i], sourceTexture.ReleaseAndGetAddressOf());
+
+			D3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc;
+			ZeroMemory(&renderTargetViewDesc, sizeof(renderTargetViewDesc));
+			renderTargetViewDesc.Format = textureDesc.Format;
+			renderTargetViewDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
+			renderTargetViewDesc.Texture2DArray.MipSlice = 0;
+			renderTargetViewDesc.Texture2DArray.FirstArraySlice = i;
+			renderTargetViewDesc.Texture2DArray.ArraySize = 1;
+
+			ComPtr<ID3D11RenderTargetView> renderTargetView;
+			ThrowIfFailed(mDevice->CreateRenderTargetView(textureArray.Get(), &renderTargetViewDesc, renderTargetView.ReleaseAndGetAddressOf()), "ID3D11Device::CreateRenderTargetView() failed.");
+
+			mContext->ClearRenderTargetView(renderTargetView.Get(), reinterpret_cast<const float*>(&Colors::Black));
+			mContext->OMSetRenderTargets(1, renderTargetView.GetAddressOf(), nullptr);
+
+			spriteBatch.Begin();
+			spriteBatch.Draw(sourceTexture.Get(), destinationRectangle);
+			spriteBatch.End();
+		}
+
+		previousOutputState.Apply(mContext.Get());
+
+		// SpriteBatch sets state behind the cache's back.
+		mStateCache->Invalidate();
+
+		ThrowIfFailed(mDevice->CreateShaderResourceView(textureArray.Get(), nullptr, texture.View.ReleaseAndGetAddressOf()), "ID3D11Device::CreateShaderResourceView() failed.");
+		mContext->GenerateMips(texture.View.Get());
+	}
+
+	void Direct3D11RenderDevice::CreateShaderObject(Shader& shader)
+	{
+		const vector<char>& bytecode = *shader.Bytecode;
+		if (shader.Stage == ShaderStage::Vertex)
+		{
+			ThrowIfFailed(mDevice->CreateVertexShader(&bytecode[0], bytecode.size(), nullptr, shader.VertexShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedVertexShader() failed.");
+		}
+		else
+		{
+			ThrowIfFailed(mDevice->CreatePixelShader(&bytecode[0], bytecode.size(), nullptr, shader.PixelShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
+		}
+	}
+
+	void Direct3D11RenderDevice::CreatePipelineStateObject(PipelineState& pipelineState)
+	{
+		const PipelineStateDescription& description = pipelineState.Description;
+		const vector<char>& vertexShaderBytecode = *pipelineState.VertexShaderBytecode;
+		const vector<char>& pixelShaderBytecode = *pipelineState.PixelShaderBytecode;
+
+		// Share the shader objects while the shaders are alive, so the state cache sees the same pointers; otherwise recreate them.
+		pipelineState.VertexShader = nullptr;
+		pipelineState.PixelShader = nullptr;
+		for (const Shader& shader : mShaders)
+		{
+			if (shader.Bytecode == pipelineState.VertexShaderBytecode)
+			{
+				pipelineState.VertexShader = shader.VertexShader;
+			}
+			else if (shader.Bytecode == pipelineState.PixelShaderBytecode)
+			{
+				pipelineState.PixelShader = shader.PixelShader;
+			}
+		}
+
+		if (pipelineState.VertexShader == nullptr)
+		{
+			ThrowIfFailed(mDevice->CreateVertexShader(&vertexShaderBytecode[0], vertexShaderBytecode.size(), nullptr, pipelineState.VertexShader.GetAddressOf()), "ID3D11Device::CreatedVertexShader() failed.");
+		}
+
+		if (pipelineState.PixelShader == nullptr)
+		{
+			ThrowIfFailed(mDevice->CreatePixelShader(&pixelShaderBytecode[0], pixelShaderBytecode.size(), nullptr, pipelineState.PixelShader.GetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
+		}
+
+		vector<D3D11_INPUT_ELEMENT_DESC> inputElementDescriptions;
+		inputElementDescriptions.reserve(description.InputElements.size());
+		for (size_t i = 0; i < description.InputElements.size(); ++i)
+		{
+			const InputElement& element = description.InputElements[i];
+
+			D3D11_INPUT_ELEMENT_DESC elementDesc;
+			elementDesc.SemanticName = pipelineState.SemanticNames[i].c_str();
+			elementDesc.SemanticIndex = element.SemanticIndex;
+			elementDesc.Format = FormatFor(element.Format);
+			elementDesc.InputSlot = element.Slot;
+			elementDesc.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+			elementDesc.InputSlotClass = (element.PerInstance ? D3D11_INPUT_PER_INSTANCE_DATA : D3D11_INPUT_PER_VERTEX_DATA);
+			elementDesc.InstanceDataStepRate = (element.PerInstance ? 1 : 0);
+			inputElementDescriptions.push_back(elementDesc);
+		}
+
+		pipelineState.InputLayout = nullptr;
+		if (inputElementDescriptions.empty() == false)
+		{
+			ThrowIfFailed(mDevice->CreateInputLayout(&inputElementDescriptions[0], static_cast<UINT>(inputElementDescriptions.size()), &vertexShaderBytecode[0], vertexShaderBytecode.size(), pipelineState.InputLayout.GetAddressOf()), "ID3D11Device::CreateInputLayout() failed.");
+		}
+
+		pipelineState.Topology = TopologyFor(description.Topology);
+		pipelineState.RasterizerState = RasterizerStateFor(description);
+		pipelineState.BlendState = (description.Blend == BlendMode::AlphaBlend ? mAlphaBlendingState.Get() : nullptr);
+		pipelineState.DepthStencilState = DepthStencilStateFor(description.Depth);
+		pipelineState.SamplerState = SamplerStateFor(description.Sampler);
+	}
+
+	void Direct3D11RenderDevice::CreateFontObject(Font& font)
+	{
+		font.SpriteFont = make_unique<SpriteFont>(mDevice.Get(), font.Filename.c_str());
+		font.SpriteFont->GetSpriteSheet(font.SpriteSheet.ReleaseAndGetAddressOf());
+	}
+
+	void Direct3D11RenderDevice::LoadTexture(const wstring& filename, ID3D11ShaderResourceView** texture) const
+	{
+		if (filename.size() >= 4 && _wcsicmp(filename.c_str() + filename.size() - 4, L".dds") == 0)
+		{
+			ThrowIfFailed(CreateDDSTextureFromFile(mDevice.Get(), filename.c_str(), nullptr, texture), "CreateDDSTextureFromFile() failed.");
+		}
+		else
+		{
+			ThrowIfFailed(CreateWICTextureFromFile(mDevice.Get(), filename.c_str(), nullptr, texture), "CreateWICTextureFromFile() failed.");
+		}
+	}
+
+	ID3D11RasterizerState* Direct3D11RenderDevice::RasterizerStateFor(const PipelineStateDescription& description) const
+	{
+		if (description.Fill == FillMode::Wireframe)
+		{
+			return mWireframeState.Get();
+		}
+
+		switch (description.Cull)
+		{
+		case CullMode::None:
+			return mDisabledCullingState.Get();
+
+		case CullMode::Front:
+			return mFrontCullingState.Get();
+
+		default:
+			return nullptr;
+		}
+	}
+
+	ID3D11SamplerState* Direct3D11RenderDevice::SamplerStateFor(SamplerMode sampler) const
+	{
+		switch (sampler)
+		{
+		case SamplerMode::TrilinearWrap:
+			return mTrilinearWrapState.Get();
+
+		case SamplerMode::TrilinearClamp:
+			return mTrilinearClampState.Get();
+
+		case SamplerMode::PointClamp:
+			return mPointClampState.Get();
+
+		default:
+			return nullptr;
+		}
+	}
+
+	ID3D11DepthStencilState* Direct3D11RenderDevice::DepthStencilStateFor(DepthMode depth) const
+	{
+		switch (depth)
+		{
+		case DepthMode::ReadOnly:
+			return mReadOnlyDepthState.Get();
+
+		case DepthMode::Disabled:
+			return mDisabledDepthState.Get();
+
+		default:
+			return nullptr;
+		}
+	}
+
+	DXGI_FORMAT Direct3D11RenderDevice::FormatFor(VertexFormat format)
+	{
+		switch (format)
+		{
+		case VertexFormat::UInt1:
+			return DXGI_FORMAT_R32_UINT;
+
+		case VertexFormat::Float1:
+			return DXGI_FORMAT_R32_FLOAT;
+
+		case VertexFormat::Float2:
+			return DXGI_FORMAT_R32G32_FLOAT;
+
+		case VertexFormat::Float3:
+			return DXGI_FORMAT_R32G32B32_FLOAT;
+
+		default:
+			return DXGI_FORMAT_R32G32B32A32_FLOAT;
+		}
+	}
+
+	D3D11_PRIMITIVE_TOPOLOGY Direct3D11RenderDevice::TopologyFor(PrimitiveTopology topology)
+	{
+		switch (topology)
+		{
+		case PrimitiveTopology::PointList:
+			return D3D11_PRIMITIVE_TOPOLOGY_POINTLIST;
+
+		case PrimitiveTopology::LineList:
+			return D3D11_PRIMITIVE_TOPOLOGY_LINELIST;
+
+		case PrimitiveTopology::TriangleStrip:
+			return D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+
+		default:
+			return D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+		}
+	}
+}
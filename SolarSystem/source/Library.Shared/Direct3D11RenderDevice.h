@@ -0,0 +1,226 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d11_2.h>
+#include <vector>
+#include <string>
+#include <memory>
+#include "RenderDevice.h"
+#include "Direct3DStateCache.h"
+
+namespace DirectX
+{
+	class SpriteBatch;
+	class SpriteFont;
+}
+
+namespace Library
+{
+	// Creates resources on a Direct3D 11 device. The immediate encoder draws on the immediate context through the game's state
+	// cache, so bindings shared with code that still uses the cache directly are filtered; deferred encoders each own a deferred
+	// context and a state cache of their own. Every object keeps what it was created from, so Reset() can rebuild it on a new
+	// device after the old one was lost without invalidating any handle.
+	class Direct3D11RenderDevice final : public RenderDevice
+	{
+	public:
+		Direct3D11RenderDevice(ID3D11Device1* device, Direct3DStateCache& stateCache);
+		Direct3D11RenderDevice(const Direct3D11RenderDevice&) = delete;
+		Direct3D11RenderDevice& operator=(const Direct3D11RenderDevice&) = delete;
+		Direct3D11RenderDevice(Direct3D11RenderDevice&&) = delete;
+		Direct3D11RenderDevice& operator=(Direct3D11RenderDevice&&) = delete;
+		~Direct3D11RenderDevice();
+
+		// Recreates every live object on device, whose immediate context the state cache must already wrap. Immutable and default
+		// buffers get their last contents back; dynamic buffers come back uninitialized, as they are rewritten before use anyway.
+		void Reset(ID3D11Device1* device);
+
+		virtual const char* Name() const override;
+		virtual bool SupportsConstantBufferOffsets() const override;
+
+		virtual BufferHandle CreateBuffer(const BufferDescription& description, const void* initialData) override;
+		virtual TextureHandle CreateTextureFromFile(const std::wstring& filename) override;
+		virtual TextureHandle CreateTextureArrayFromFiles(const std::vector<std::wstring>& filenames, std::uint32_t width, std::uint32_t height) override;
+		virtual ShaderHandle CreateShader(ShaderStage stage, const std::vector<char>& bytecode) override;
+		virtual PipelineStateHandle CreatePipelineState(const PipelineStateDescription& description) override;
+		virtual FontHandle CreateFontFromFile(const std::wstring& filename) override;
+		virtual float LineSpacing(FontHandle font) override;
+		virtual FontGlyph Glyph(FontHandle font, wchar_t character) override;
+
+		virtual void Destroy(BufferHandle buffer) override;
+		virtual void Destroy(TextureHandle texture) override;
+		virtual void Destroy(ShaderHandle shader) override;
+		virtual void Destroy(PipelineStateHandle pipelineState) override;
+		virtual void Destroy(FontHandle font) override;
+
+		virtual CommandEncoder& ImmediateEncoder() override;
+		virtual bool SupportsDeferredEncoders() const override;
+		virtual CommandEncoder& BeginDeferred(std::uint32_t index) override;
+		virtual void ExecuteDeferred(std::uint32_t index) override;
+
+		// The native objects behind the handles, for code that still talks to Direct3D directly.
+		ID3D11Buffer* NativeBuffer(BufferHandle buffer) const;
+		ID3D11ShaderResourceView* NativeTexture(TextureHandle texture) const;
+
+	private:
+		// Encodes onto one device context through a state cache.
+		class Encoder final : public CommandEncoder
+		{
+		public:
+			Encoder(Direct3D11RenderDevice& device, Direct3DStateCache& stateCache);
+			Encoder(const Encoder&) = delete;
+			Encoder& operator=(const Encoder&) = delete;
+			Encoder(Encoder&&) = delete;
+			Encoder& operator=(Encoder&&) = delete;
+			~Encoder() = default;
+
+			virtual void UpdateBuffer(BufferHandle buffer, const void* data, std::uint32_t size) override;
+			virtual void* Map(BufferHandle buffer, MapMode mode) override;
+			virtual void Unmap(BufferHandle buffer) override;
+
+			virtual void SetPipelineState(PipelineStateHandle pipelineState) override;
+			virtual void SetVertexBuffer(std::uint32_t slot, BufferHandle buffer, std::uint32_t stride, std::uint32_t offset) override;
+			virtual void SetIndexBuffer(BufferHandle buffer, IndexFormat format, std::uint32_t offset) override;
+			virtual void SetConstantBuffer(ShaderStage stage, std::uint32_t slot, BufferHandle buffer) override;
+			virtual void SetConstantBufferRange(ShaderStage stage, std::uint32_t slot, BufferHandle buffer, std::uint32_t firstConstant, std::uint32_t constantCount) override;
+			virtual void SetTexture(ShaderStage stage, std::uint32_t slot, TextureHandle texture) override;
+
+			virtual void Draw(std::uint32_t vertexCount, std::uint32_t startVertex) override;
+			virtual void DrawInstanced(std::uint32_t vertexCount, std::uint32_t instanceCount, std::uint32_t startVertex, std::uint32_t startInstance) override;
+			virtual void DrawIndexed(std::uint32_t indexCount, std::uint32_t startIndex, std::int32_t baseVertex) override;
+			virtual void DrawIndexedInstanced(std::uint32_t indexCount, std::uint32_t instanceCount, std::uint32_t startIndex, std::int32_t baseVertex, std::uint32_t startInstance) override;
+			virtual void DrawGlyphs(FontHandle font, const GlyphSprite* glyphs, std::uint32_t count) override;
+
+			virtual std::uint32_t IssuedCallCount() const override;
+			virtual std::uint32_t FilteredCallCount() const override;
+
+		private:
+			Direct3D11RenderDevice* mDevice;
+			Direct3DStateCache* mStateCache;
+		};
+
+		// Its state cache lives alongside the encoder that points at it, so deferred encoders are held by pointer.
+		struct DeferredEncoder
+		{
+			Microsoft::WRL::ComPtr<ID3D11DeviceContext1> Context;
+			Direct3DStateCache StateCache;
+			Encoder Commands;
+
+			DeferredEncoder(Direct3D11RenderDevice& device, ID3D11DeviceContext1* context);
+		};
+
+		// The render target and viewport a context draws to, which deferred contexts and command lists don't carry over.
+		struct OutputState
+		{
+			Microsoft::WRL::ComPtr<ID3D11RenderTargetView> RenderTargetView;
+			Microsoft::WRL::ComPtr<ID3D11DepthStencilView> DepthStencilView;
+			UINT ViewportCount;
+			D3D11_VIEWPORT Viewport;
+
+			explicit OutputState(ID3D11DeviceContext* context);
+			void Apply(ID3D11DeviceContext* context) const;
+		};
+
+		struct Buffer
+		{
+			BufferDescription Description;
+			std::vector<char> Contents;
+			Microsoft::WRL::ComPtr<ID3D11Buffer> Resource;
+		};
+
+		// Single files have an empty size; arrays resample every file to Width x Height.
+		struct Texture
+		{
+			std::vector<std::wstring> Filenames;
+			std::uint32_t Width;
+			std::uint32_t Height;
+			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> View;
+		};
+
+		// Bytecode is shared with the pipeline states created from the shader, which may outlive it.
+		struct Shader
+		{
+			ShaderStage Stage;
+			std::shared_ptr<const std::vector<char>> Bytecode;
+			Microsoft::WRL::ComPtr<ID3D11VertexShader> VertexShader;
+			Microsoft::WRL::ComPtr<ID3D11PixelShader> PixelShader;
+		};
+
+		struct PipelineState
+		{
+			PipelineStateDescription Description;
+			std::vector<std::string> SemanticNames;
+			std::shared_ptr<const std::vector<char>> VertexShaderBytecode;
+			std::shared_ptr<const std::vector<char>> PixelShaderBytecode;
+			Microsoft::WRL::ComPtr<ID3D11InputLayout> InputLayout;
+			Microsoft::WRL::ComPtr<ID3D11VertexShader> VertexShader;
+			Microsoft::WRL::ComPtr<ID3D11PixelShader> PixelShader;
+			D3D11_PRIMITIVE_TOPOLOGY Topology;
+			ID3D11RasterizerState* RasterizerState;
+			ID3D11BlendState* BlendState;
+			ID3D11DepthStencilState* DepthStencilState;
+			ID3D11SamplerState* SamplerState;
+
+			PipelineState(const PipelineStateDescription& description);
+		};
+
+		struct Font
+		{
+			std::wstring Filename;
+			std::unique_ptr<DirectX::SpriteFont> SpriteFont;
+			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> SpriteSheet;
+		};
+
+		// Returns the live object behind a handle, or throws.
+		template <typename T>
+		static T& Lookup(std::vector<T>& objects, std::uint32_t id, const char* typeName);
+		template <typename T>
+		static const T& Lookup(const std::vector<T>& objects, std::uint32_t id, const char* typeName);
+
+		static bool IsAlive(const Buffer& buffer);
+		static bool IsAlive(const Texture& texture);
+		static bool IsAlive(const Shader& shader);
+		static bool IsAlive(const PipelineState& pipelineState);
+		static bool IsAlive(const Font& font);
+
+		// The Create*Object() methods (re)build the native objects from what the wrappers were created with.
+		void CreateStates();
+		void CreateBufferObject(Buffer& buffer);
+		void CreateTextureObject(Texture& texture);
+		void CreateShaderObject(Shader& shader);
+		void CreatePipelineStateObject(PipelineState& pipelineState);
+		void CreateFontObject(Font& font);
+		void LoadTexture(const std::wstring& filename, ID3D11ShaderResourceView** texture) const;
+		ID3D11RasterizerState* RasterizerStateFor(const PipelineStateDescription& description) const;
+		ID3D11SamplerState* SamplerStateFor(SamplerMode sampler) const;
+		ID3D11DepthStencilState* DepthStencilStateFor(DepthMode depth) const;
+
+		static DXGI_FORMAT FormatFor(VertexFormat format);
+		static D3D11_PRIMITIVE_TOPOLOGY TopologyFor(PrimitiveTopology topology);
+
+		Microsoft::WRL::ComPtr<ID3D11Device1> mDevice;
+		Microsoft::WRL::ComPtr<ID3D11DeviceContext1> mContext;
+		Direct3DStateCache* mStateCache;
+		Encoder mImmediateEncoder;
+		std::vector<std::unique_ptr<DeferredEncoder>> mDeferredEncoders;
+		std::unique_ptr<DirectX::SpriteBatch> mSpriteBatch;
+		bool mSupportsConstantBufferOffsets;
+		bool mSupportsDeferredEncoders;
+
+		Microsoft::WRL::ComPtr<ID3D11RasterizerState> mFrontCullingState;
+		Microsoft::WRL::ComPtr<ID3D11RasterizerState> mDisabledCullingState;
+		Microsoft::WRL::ComPtr<ID3D11RasterizerState> mWireframeState;
+		Microsoft::WRL::ComPtr<ID3D11BlendState> mAlphaBlendingState;
+		Microsoft::WRL::ComPtr<ID3D11DepthStencilState> mReadOnlyDepthState;
+		Microsoft::WRL::ComPtr<ID3D11DepthStencilState> mDisabledDepthState;
+		Microsoft::WRL::ComPtr<ID3D11SamplerState> mTrilinearWrapState;
+		Microsoft::WRL::ComPtr<ID3D11SamplerState> mTrilinearClampState;
+		Microsoft::WRL::ComPtr<ID3D11SamplerState> mPointClampState;
+
+		// Slot i holds the object with id i + 1; destroyed objects leave an empty slot behind.
+		std::vector<Buffer> mBuffers;
+		std::vector<Texture> mTextures;
+		std::vector<Shader> mShaders;
+		std::vector<PipelineState> mPipelineStates;
+		std::vector<Font> mFonts;
+	};
+}
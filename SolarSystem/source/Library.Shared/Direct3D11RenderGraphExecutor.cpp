@@ -0,0 +1,241 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Microsoft::WRL;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(Direct3D11RenderGraphExecutor)
+
+	Direct3D11RenderGraphExecutor::Direct3D11RenderGraphExecutor(ID3D11Device* device, ID3D11DeviceContext* deviceContext, Direct3DStateCache& stateCache) :
+		mDevice(device), mDeviceContext(deviceContext), mStateCache(&stateCache),
+		mPassRenderTargetCount(0), mPassRenderTargetViews(), mPassDepthStencilView(nullptr), mPassViewport()
+	{
+		assert(mDevice != nullptr);
+		assert(mDeviceContext != nullptr);
+	}
+
+	void Direct3D11RenderGraphExecutor::SetImportedTexture(RenderGraphResource resource, ID3D11RenderTargetView* renderTargetView, ID3D11DepthStencilView* depthStencilView, ID3D11ShaderResourceView* shaderResourceView)
+	{
+		assert(resource.IsValid());
+
+		if (resource.Id > mImportedTextures.size())
+		{
+			mImportedTextures.resize(resource.Id);
+		}
+
+		TextureViews& views = mImportedTextures[resource.Id - 1];
+		views.RenderTargetView = renderTargetView;
+		views.DepthStencilView = depthStencilView;
+		views.ShaderResourceView = shaderResourceView;
+	}
+
+	ID3D11RenderTargetView* Direct3D11RenderGraphExecutor::RenderTargetView(const RenderGraph& graph, RenderGraphResource resource) const
+	{
+		return Views(graph, resource).RenderTargetView;
+	}
+
+	ID3D11DepthStencilView* Direct3D11RenderGraphExecutor::DepthStencilView(const RenderGraph& graph, RenderGraphResource resource) const
+	{
+		return Views(graph, resource).DepthStencilView;
+	}
+
+	ID3D11ShaderResourceView* Direct3D11RenderGraphExecutor::ShaderResourceView(const RenderGraph& graph, RenderGraphResource resource) const
+	{
+		return Views(graph, resource).ShaderResourceView;
+	}
+
+	void Direct3D11RenderGraphExecutor::PreparePhysicalTextures(const vector<TextureDescription>& physicalTextures)
+	{
+		if (physicalTextures.size() < mPhysicalTextures.size())
+		{
+			mPhysicalTextures.resize(physicalTextures.size());
+		}
+
+		for (size_t i = 0; i < physicalTextures.size(); ++i)
+		{
+			if (i == mPhysicalTextures.size())
+			{
+				mPhysicalTextures.emplace_back();
+			}
+
+			PhysicalTexture& physicalTexture = mPhysicalTextures[i];
+			if (physicalTexture.Texture == nullptr || physicalTexture.Description != physicalTextures[i])
+			{
+				physicalTexture.Description = physicalTextures[i];
+				CreatePhysicalTexture(physicalTexture);
+			}
+		}
+	}
+
+	void Direct3D11RenderGraphExecutor::ApplyBarrier(const RenderGraph& graph, const RenderGraphBarrier& barrier)
+	{
+		// Direct3D 11 tracks hazards itself, but it silently unbinds a shader resource that is bound as a target, which would leave
+		// the state cache out of date. A transient texture can still be bound under the name it is aliased with, so its first write
+		// unbinds too. Targets are unbound when their pass ends, so reads need nothing.
+		bool isWrite = (barrier.After == ResourceState::RenderTarget || barrier.After == ResourceState::DepthWrite);
+		if (isWrite && (barrier.Before == ResourceState::ShaderResource || graph.IsImported(barrier.Resource) == false))
+		{
+			static ID3D11ShaderResourceView* const nullViews[Direct3DStateCache::ShaderResourceSlotCount] = { nullptr };
+			mStateCache->PSSetShaderResources(0, Direct3DStateCache::ShaderResourceSlotCount, nullViews);
+		}
+	}
+
+	void Direct3D11RenderGraphExecutor::Clear(const RenderGraph& graph, RenderGraphResource resource)
+	{
+		const ClearValue& clearValue = graph.ResourceClearValue(resource);
+		TextureViews views = Views(graph, resource);
+		if (graph.Description(resource).IsDepth())
+		{
+			assert(views.DepthStencilView != nullptr);
+			mDeviceContext->ClearDepthStencilView(views.DepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, clearValue.Depth, clearValue.Stencil);
+		}
+		else
+		{
+			assert(views.RenderTargetView != nullptr);
+			mDeviceContext->ClearRenderTargetView(views.RenderTargetView, clearValue.Color);
+		}
+	}
+
+	void Direct3D11RenderGraphExecutor::BeginPass(const RenderGraph& graph, uint32_t pass)
+	{
+		mPassRenderTargetCount = 0;
+		mPassDepthStencilView = nullptr;
+
+		const vector<RenderGraphResource>& writes = graph.PassWrites(pass);
+		if (writes.empty())
+		{
+			return;
+		}
+
+		for (RenderGraphResource resource : writes)
+		{
+			TextureViews views = Views(graph, resource);
+			if (graph.Description(resource).IsDepth())
+			{
+				mPassDepthStencilView = views.DepthStencilView;
+			}
+			else
+			{
+				assert(mPassRenderTargetCount < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
+				mPassRenderTargetViews[mPassRenderTargetCount++] = views.RenderTargetView;
+			}
+		}
+
+		const TextureDescription& description = graph.Description(writes.front());
+		mPassViewport.TopLeftX = 0.0f;
+		mPassViewport.TopLeftY = 0.0f;
+		mPassViewport.Width = static_cast<float>(description.Width);
+		mPassViewport.Height = static_cast<float>(description.Height);
+		mPassViewport.MinDepth = D3D11_MIN_DEPTH;
+		mPassViewport.MaxDepth = D3D11_MAX_DEPTH;
+
+		Begin();
+	}
+
+	void Direct3D11RenderGraphExecutor::EndPass(const RenderGraph& graph, uint32_t pass)
+	{
+		if (graph.PassWrites(pass).empty() == false)
+		{
+			End();
+		}
+	}
+
+	void Direct3D11RenderGraphExecutor::Begin()
+	{
+		RenderTarget::Begin(mDeviceContext, mPassRenderTargetCount, mPassRenderTargetViews, mPassDepthStencilView, mPassViewport);
+	}
+
+	void Direct3D11RenderGraphExecutor::End()
+	{
+		RenderTarget::End(mDeviceContext);
+	}
+
+	Direct3D11RenderGraphExecutor::TextureViews Direct3D11RenderGraphExecutor::Views(const RenderGraph& graph, RenderGraphResource resource) const
+	{
+		if (graph.IsImported(resource))
+		{
+			return (resource.Id <= mImportedTextures.size() ? mImportedTextures[resource.Id - 1] : TextureViews());
+		}
+
+		uint32_t index = graph.PhysicalTexture(resource);
+		assert(index < mPhysicalTextures.size());
+
+		const PhysicalTexture& physicalTexture = mPhysicalTextures[index];
+		TextureViews views;
+		views.RenderTargetView = physicalTexture.RenderTargetView.Get();
+		views.DepthStencilView = physicalTexture.DepthStencilView.Get();
+		views.ShaderResourceView = physicalTexture.ShaderResourceView.Get();
+
+		return views;
+	}
+
+	void Direct3D11RenderGraphExecutor::CreatePhysicalTexture(PhysicalTexture& physicalTexture)
+	{
+		// Depth textures are typeless so they can also be sampled
+		DXGI_FORMAT textureFormat;
+		DXGI_FORMAT viewFormat;
+		DXGI_FORMAT shaderResourceFormat;
+		switch (physicalTexture.Description.Format)
+		{
+		case TextureFormat::R16G16B16A16Float:
+			textureFormat = viewFormat = shaderResourceFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+			break;
+
+		case TextureFormat::R11G11B10Float:
+			textureFormat = viewFormat = shaderResourceFormat = DXGI_FORMAT_R11G11B10_FLOAT;
+			break;
+
+		case TextureFormat::R32Float:
+			textureFormat = viewFormat = shaderResourceFormat = DXGI_FORMAT_R32_FLOAT;
+			break;
+
+		case TextureFormat::D24UNormS8UInt:
+			textureFormat = DXGI_FORMAT_R24G8_TYPELESS;
+			viewFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+			shaderResourceFormat = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+			break;
+
+		case TextureFormat::D32Float:
+			textureFormat = DXGI_FORMAT_R32_TYPELESS;
+			viewFormat = DXGI_FORMAT_D32_FLOAT;
+			shaderResourceFormat = DXGI_FORMAT_R32_FLOAT;
+			break;
+
+		default:
+			textureFormat = viewFormat = shaderResourceFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+			break;
+		}
+
+		bool isDepth = physicalTexture.Description.IsDepth();
+
+		D3D11_TEXTURE2D_DESC textureDesc = { 0 };
+		textureDesc.Width = physicalTexture.Description.Width;
+		textureDesc.Height = physicalTexture.Description.Height;
+		textureDesc.MipLevels = 1;
+		textureDesc.ArraySize = 1;
+		textureDesc.Format = textureFormat;
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.Usage = D3D11_USAGE_DEFAULT;
+		textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | (isDepth ? D3D11_BIND_DEPTH_STENCIL : D3D11_BIND_RENDER_TARGET);
+
+		physicalTexture.RenderTargetView = nullptr;
+		physicalTexture.DepthStencilView = nullptr;
+		physicalTexture.ShaderResourceView = nullptr;
+		ThrowIfFailed(mDevice->CreateTexture2D(&textureDesc, nullptr, physicalTexture.Texture.ReleaseAndGetAddressOf()), "ID3D11Device::CreateTexture2D() failed.");
+
+		if (isDepth)
+		{
+			CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(D3D11_DSV_DIMENSION_TEXTURE2D, viewFormat);
+			ThrowIfFailed(mDevice->CreateDepthStencilView(physicalTexture.Texture.Get(), &depthStencilViewDesc, physicalTexture.DepthStencilView.GetAddressOf()), "ID3D11Device::CreateDepthStencilView() failed.");
+		}
+		else
+		{
+			CD3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc(D3D11_RTV_DIMENSION_TEXTURE2D, viewFormat);
+			ThrowIfFailed(mDevice->CreateRenderTargetView(physicalTexture.Texture.Get(), &renderTargetViewDesc, physicalTexture.RenderTargetView.GetAddressOf()), "ID3D11Device::CreateRenderTargetView() failed.");
+		}
+
+		CD3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc(D3D11_SRV_DIMENSION_TEXTURE2D, shaderResourceFormat);
+		ThrowIfFailed(mDevice->CreateShaderResourceView(physicalTexture.Texture.Get(), &shaderResourceViewDesc, physicalTexture.ShaderResourceView.GetAddressOf()), "ID3D11Device::CreateShaderResourceView() failed.");
+	}
+}
\ No newline at end of file
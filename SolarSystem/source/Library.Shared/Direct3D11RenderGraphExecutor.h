@@ -0,0 +1,81 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d11_2.h>
+#include <vector>
+#include "RenderTarget.h"
+#include "RenderGraph.h"
+#include "Direct3DStateCache.h"
+
+namespace Library
+{
+	// Runs render graphs on Direct3D 11. Physical textures are created as the pool grows, each pass's writes are bound through the
+	// render target stack for the duration of the pass, and textures about to be rendered to are unbound from the pixel shader
+	// through the game's state cache. Imported textures are bound to views with SetImportedTexture() before each execution.
+	class Direct3D11RenderGraphExecutor final : public RenderTarget, public RenderGraphExecutor
+	{
+		RTTI_DECLARATIONS(Direct3D11RenderGraphExecutor, RenderTarget)
+
+	public:
+		Direct3D11RenderGraphExecutor(ID3D11Device* device, ID3D11DeviceContext* deviceContext, Direct3DStateCache& stateCache);
+		Direct3D11RenderGraphExecutor(const Direct3D11RenderGraphExecutor&) = delete;
+		Direct3D11RenderGraphExecutor& operator=(const Direct3D11RenderGraphExecutor&) = delete;
+		Direct3D11RenderGraphExecutor(Direct3D11RenderGraphExecutor&&) = delete;
+		Direct3D11RenderGraphExecutor& operator=(Direct3D11RenderGraphExecutor&&) = delete;
+		~Direct3D11RenderGraphExecutor() = default;
+
+		// Any of the views may be null if the graph never uses the texture that way. No references are kept, so set the views
+		// again before every execution (e.g. the back buffer's views change when the swap chain is resized).
+		void SetImportedTexture(RenderGraphResource resource, ID3D11RenderTargetView* renderTargetView, ID3D11DepthStencilView* depthStencilView, ID3D11ShaderResourceView* shaderResourceView);
+
+		// Views of a graph texture, for pass callbacks.
+		ID3D11RenderTargetView* RenderTargetView(const RenderGraph& graph, RenderGraphResource resource) const;
+		ID3D11DepthStencilView* DepthStencilView(const RenderGraph& graph, RenderGraphResource resource) const;
+		ID3D11ShaderResourceView* ShaderResourceView(const RenderGraph& graph, RenderGraphResource resource) const;
+
+		virtual void PreparePhysicalTextures(const std::vector<TextureDescription>& physicalTextures) override;
+		virtual void ApplyBarrier(const RenderGraph& graph, const RenderGraphBarrier& barrier) override;
+		virtual void Clear(const RenderGraph& graph, RenderGraphResource resource) override;
+		virtual void BeginPass(const RenderGraph& graph, std::uint32_t pass) override;
+		virtual void EndPass(const RenderGraph& graph, std::uint32_t pass) override;
+
+	protected:
+		// Bind and unbind the current pass's targets.
+		virtual void Begin() override;
+		virtual void End() override;
+
+	private:
+		struct TextureViews
+		{
+			ID3D11RenderTargetView* RenderTargetView;
+			ID3D11DepthStencilView* DepthStencilView;
+			ID3D11ShaderResourceView* ShaderResourceView;
+
+			TextureViews() :
+				RenderTargetView(nullptr), DepthStencilView(nullptr), ShaderResourceView(nullptr) { }
+		};
+
+		struct PhysicalTexture
+		{
+			TextureDescription Description;
+			Microsoft::WRL::ComPtr<ID3D11Texture2D> Texture;
+			Microsoft::WRL::ComPtr<ID3D11RenderTargetView> RenderTargetView;
+			Microsoft::WRL::ComPtr<ID3D11DepthStencilView> DepthStencilView;
+			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> ShaderResourceView;
+		};
+
+		TextureViews Views(const RenderGraph& graph, RenderGraphResource resource) const;
+		void CreatePhysicalTexture(PhysicalTexture& physicalTexture);
+
+		ID3D11Device* mDevice;
+		ID3D11DeviceContext* mDeviceContext;
+		Direct3DStateCache* mStateCache;
+		std::vector<PhysicalTexture> mPhysicalTextures;
+		std::vector<TextureViews> mImportedTextures;
+
+		UINT mPassRenderTargetCount;
+		ID3D11RenderTargetView* mPassRenderTargetViews[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+		ID3D11DepthStencilView* mPassDepthStencilView;
+		D3D11_VIEWPORT mPassViewport;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <d3d11_2.h>
+#include "StateCachingContext.h"
+
+namespace Library
+{
+	struct Direct3DStateTypes
+	{
+		typedef ID3D11DeviceContext1 DeviceContext;
+		typedef D3D11_PRIMITIVE_TOPOLOGY PrimitiveTopology;
+		typedef DXGI_FORMAT Format;
+		typedef ID3D11InputLayout InputLayout;
+		typedef ID3D11Buffer Buffer;
+		typedef ID3D11VertexShader VertexShader;
+		typedef ID3D11PixelShader PixelShader;
+		typedef ID3D11ClassInstance ClassInstance;
+		typedef ID3D11ShaderResourceView ShaderResourceView;
+		typedef ID3D11SamplerState SamplerState;
+		typedef ID3D11RasterizerState RasterizerState;
+		typedef ID3D11BlendState BlendState;
+		typedef ID3D11DepthStencilState DepthStencilState;
+	};
+
+	typedef StateCachingContext<Direct3DStateTypes> Direct3DStateCache;
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	const uint32_t DrawKey::LayerBits = 4;
+	const uint32_t DrawKey::ShaderBits = 10;
+	const uint32_t DrawKey::MaterialBits = 12;
+	const uint32_t DrawKey::TextureBits = 14;
+	const uint32_t DrawKey::DepthBits = 24;
+
+	const uint32_t DrawKey::DepthShift = 0;
+	const uint32_t DrawKey::TextureShift = DepthShift + DepthBits;
+	const uint32_t DrawKey::MaterialShift = TextureShift + TextureBits;
+	const uint32_t DrawKey::ShaderShift = MaterialShift + MaterialBits;
+	const uint32_t DrawKey::LayerShift = ShaderShift + ShaderBits;
+
+	uint64_t DrawKey::Encode(RenderLayer layer, uint32_t shader, uint32_t material, uint32_t texture, uint32_t depth)
+	{
+		assert(static_cast<uint32_t>(layer) < (1U << LayerBits));
+		assert(shader < (1U << ShaderBits));
+		assert(material < (1U << MaterialBits));
+		assert(texture < (1U << TextureBits));
+		assert(depth < (1U << DepthBits));
+
+		// Transparent draws blend over what is behind them, so they sort back to front.
+		if (layer == RenderLayer::Transparent)
+		{
+			depth = ((1U << DepthBits) - 1) - depth;
+		}
+
+		return (static_cast<uint64_t>(layer) << LayerShift) |
+			(static_cast<uint64_t>(shader) << ShaderShift) |
+			(static_cast<uint64_t>(material) << MaterialShift) |
+			(static_cast<uint64_t>(texture) << TextureShift) |
+			(static_cast<uint64_t>(depth) << DepthShift);
+	}
+
+	uint32_t DrawKey::QuantizeDepth(float depth)
+	{
+		static const float MaxDepth = static_cast<float>((1U << DepthBits) - 1);
+
+		if (depth <= 0.0f)
+		{
+			return 0;
+		}
+
+		if (depth >= 1.0f)
+		{
+			return static_cast<uint32_t>(MaxDepth);
+		}
+
+		return static_cast<uint32_t>(depth * MaxDepth + 0.5f);
+	}
+
+	RenderLayer DrawKey::Layer(uint64_t key)
+	{
+		return static_cast<RenderLayer>(Field(key, LayerShift, LayerBits));
+	}
+
+	uint32_t DrawKey::Shader(uint64_t key)
+	{
+		return Field(key, ShaderShift, ShaderBits);
+	}
+
+	uint32_t DrawKey::Material(uint64_t key)
+	{
+		return Field(key, MaterialShift, MaterialBits);
+	}
+
+	uint32_t DrawKey::Texture(uint64_t key)
+	{
+		return Field(key, TextureShift, TextureBits);
+	}
+
+	uint32_t DrawKey::Depth(uint64_t key)
+	{
+		return Field(key, DepthShift, DepthBits);
+	}
+
+	uint32_t DrawKey::Field(uint64_t key, uint32_t shift, uint32_t bits)
+	{
+		return static_cast<uint32_t>((key >> shift) & ((1ULL << bits) - 1));
+	}
+
+	void DrawKeySorter::Sort(vector<DrawKeyEntry>& entries)
+	{
+		static const uint32_t RadixBits = 8;
+		static const uint32_t BucketCount = 1 << RadixBits;
+		static const uint32_t RadixPassCount = 64 / RadixBits;
+
+		mPassCount = 0;
+
+		size_t entryCount = entries.size();
+		if (entryCount < 2)
+		{
+			return;
+		}
+
+		// Build every pass's histogram in a single read of the keys.
+		uint32_t histograms[RadixPassCount][BucketCount] = { 0 };
+		for (const DrawKeyEntry& entry : entries)
+		{
+			uint64_t key = entry.Key;
+			for (uint32_t pass = 0; pass < RadixPassCount; ++pass)
+			{
+				++histograms[pass][(key >> (pass * RadixBits)) & (BucketCount - 1)];
+			}
+		}
+
+		mScratch.resize(entryCount);
+		DrawKeyEntry* source = entries.data();
+		DrawKeyEntry* destination = mScratch.data();
+
+		for (uint32_t pass = 0; pass < RadixPassCount; ++pass)
+		{
+			uint32_t* histogram = histograms[pass];
+			uint32_t shift = pass * RadixBits;
+
+			// Every key has the same digit in this pass, so the order would not change.
+			if (histogram[(source[0].Key >> shift) & (BucketCount - 1)] == entryCount)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+			{
+				uint32_t count = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += count;
+			}
+
+			for (size_t i = 0; i < entryCount; ++i)
+			{
+				const DrawKeyEntry& entry = source[i];
+				destination[histogram[(entry.Key >> shift) & (BucketCount - 1)]++] = entry;
+			}
+
+			swap(source, destination);
+			++mPassCount;
+		}
+
+		if (source != entries.data())
+		{
+			entries.swap(mScratch);
+		}
+	}
+
+	uint32_t DrawKeySorter::PassCount() const
+	{
+		return mPassCount;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace Library
+{
+	// Layers are drawn in declaration order.
+	enum class RenderLayer : std::uint8_t
+	{
+		Opaque = 0,
+		Background,
+		Transparent,
+		Overlay
+	};
+
+	// Packs the sort order of a draw into 64 bits, most significant first:
+	// layer (4) | shader (10) | material (12) | texture (14) | depth (24).
+	class DrawKey final
+	{
+	public:
+		static std::uint64_t Encode(RenderLayer layer, std::uint32_t shader, std::uint32_t material, std::uint32_t texture, std::uint32_t depth);
+
+		// Maps a normalized depth in [0, 1] onto the depth field; values outside the range are clamped.
+		static std::uint32_t QuantizeDepth(float depth);
+
+		static RenderLayer Layer(std::uint64_t key);
+		static std::uint32_t Shader(std::uint64_t key);
+		static std::uint32_t Material(std::uint64_t key);
+		static std::uint32_t Texture(std::uint64_t key);
+		static std::uint32_t Depth(std::uint64_t key);
+
+		static const std::uint32_t LayerBits;
+		static const std::uint32_t ShaderBits;
+		static const std::uint32_t MaterialBits;
+		static const std::uint32_t TextureBits;
+		static const std::uint32_t DepthBits;
+
+		DrawKey() = delete;
+		DrawKey(const DrawKey&) = delete;
+		DrawKey& operator=(const DrawKey&) = delete;
+		DrawKey(DrawKey&&) = delete;
+		DrawKey& operator=(DrawKey&&) = delete;
+		~DrawKey() = default;
+
+	private:
+		static std::uint32_t Field(std::uint64_t key, std::uint32_t shift, std::uint32_t bits);
+
+		static const std::uint32_t DepthShift;
+		static const std::uint32_t TextureShift;
+		static const std::uint32_t MaterialShift;
+		static const std::uint32_t ShaderShift;
+		static const std::uint32_t LayerShift;
+	};
+
+	struct DrawKeyEntry
+	{
+		std::uint64_t Key;
+		std::uint32_t Index;
+
+		DrawKeyEntry() :
+			Key(0), Index(0) { }
+		DrawKeyEntry(std::uint64_t key, std::uint32_t index) :
+			Key(key), Index(index) { }
+	};
+
+	// Stable least-significant-digit radix sort of draw keys, one byte per pass.
+	// Passes in which every key shares the same byte are skipped, so keys that differ only in a few fields sort in a few passes.
+	class DrawKeySorter final
+	{
+	public:
+		DrawKeySorter() = default;
+		DrawKeySorter(const DrawKeySorter&) = delete;
+		DrawKeySorter& operator=(const DrawKeySorter&) = delete;
+		DrawKeySorter(DrawKeySorter&&) = default;
+		DrawKeySorter& operator=(DrawKeySorter&&) = default;
+		~DrawKeySorter() = default;
+
+		void Sort(std::vector<DrawKeyEntry>& entries);
+
+		// Number of scatter passes performed by the last Sort().
+		std::uint32_t PassCount() const;
+
+	private:
+		std::vector<DrawKeyEntry> mScratch;
+		std::uint32_t mPassCount = 0;
+	};
+}
\ No newline at end of file
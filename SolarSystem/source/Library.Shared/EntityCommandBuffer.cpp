@@ -0,0 +1,40 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	void EntityCommandBuffer::DestroyEntity(Entity entity)
+	{
+		Record([entity](EntityWorld& world)
+		{
+			world.DestroyEntity(entity);
+		});
+	}
+
+	void EntityCommandBuffer::Playback(EntityWorld& world)
+	{
+		vector<function<void(EntityWorld&)>> commands;
+		{
+			lock_guard<mutex> lock(mMutex);
+			commands.swap(mCommands);
+		}
+
+		for (const auto& command : commands)
+		{
+			command(world);
+		}
+	}
+
+	bool EntityCommandBuffer::IsEmpty() const
+	{
+		lock_guard<mutex> lock(mMutex);
+		return mCommands.empty();
+	}
+
+	void EntityCommandBuffer::Record(function<void(EntityWorld&)> command)
+	{
+		lock_guard<mutex> lock(mMutex);
+		mCommands.push_back(move(command));
+	}
+}
\ No newline at end of file
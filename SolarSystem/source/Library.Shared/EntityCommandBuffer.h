@@ -0,0 +1,65 @@
+#pragma once
+
+#include "EntityWorld.h"
+#include <vector>
+#include <functional>
+#include <mutex>
+
+namespace Library
+{
+	// Records structural changes (creating and destroying entities, adding and removing components) so that systems can ask
+	// for them while chunks are being iterated. Recording is safe from several threads at once; Playback() applies the
+	// changes in the order they were recorded and empties the buffer. Changes to entities destroyed in the meantime are skipped.
+	class EntityCommandBuffer final
+	{
+	public:
+		EntityCommandBuffer() = default;
+		EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer(EntityCommandBuffer&&) = delete;
+		EntityCommandBuffer& operator=(EntityCommandBuffer&&) = delete;
+		~EntityCommandBuffer() = default;
+
+		template <typename... TComponents>
+		void CreateEntity(const TComponents&... components)
+		{
+			Record([=](EntityWorld& world)
+			{
+				world.CreateEntity(components...);
+			});
+		}
+
+		void DestroyEntity(Entity entity);
+
+		template <typename T>
+		void AddComponent(Entity entity, const T& component)
+		{
+			Record([=](EntityWorld& world)
+			{
+				if (world.IsAlive(entity))
+				{
+					world.AddComponent(entity, component);
+				}
+			});
+		}
+
+		template <typename T>
+		void RemoveComponent(Entity entity)
+		{
+			Record([=](EntityWorld& world)
+			{
+				world.RemoveComponent<T>(entity);
+			});
+		}
+
+		void Playback(EntityWorld& world);
+
+		bool IsEmpty() const;
+
+	private:
+		void Record(std::function<void(EntityWorld&)> command);
+
+		mutable std::mutex mMutex;
+		std::vector<std::function<void(EntityWorld&)>> mCommands;
+	};
+}
\ No newline at end of file
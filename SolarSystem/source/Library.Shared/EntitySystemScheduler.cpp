@@ -0,0 +1,123 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	void EntitySystemScheduler::AddSystem(const char* name, ComponentMask reads, ComponentMask writes, ChunkFunction function)
+	{
+		const uint32_t systemIndex = static_cast<uint32_t>(mSystems.size());
+		mSystems.push_back({ name, reads, writes, move(function) });
+
+		size_t waveIndex = mWaves.size();
+		while (waveIndex > 0)
+		{
+			const Wave& wave = mWaves[waveIndex - 1];
+			if ((writes & (wave.Reads | wave.Writes)) != 0 || (reads & wave.Writes) != 0)
+			{
+				break;
+			}
+
+			--waveIndex;
+		}
+
+		if (waveIndex == mWaves.size())
+		{
+			mWaves.push_back({ 0, 0, { } });
+		}
+
+		Wave& wave = mWaves[waveIndex];
+		wave.Reads |= reads;
+		wave.Writes |= writes;
+		wave.Systems.push_back(systemIndex);
+	}
+
+	void EntitySystemScheduler::Run(EntityWorld& world, ThreadPool& threadPool, EntityCommandBuffer& commandBuffer)
+	{
+		PROFILE_SCOPE("EntitySystemScheduler::Run");
+
+		++world.mIterationDepth;
+
+		try
+		{
+			for (const Wave& wave : mWaves)
+			{
+				RunWave(wave, world, threadPool);
+			}
+		}
+		catch (...)
+		{
+			--world.mIterationDepth;
+			throw;
+		}
+
+		--world.mIterationDepth;
+
+		commandBuffer.Playback(world);
+	}
+
+	uint32_t EntitySystemScheduler::SystemCount() const
+	{
+		return static_cast<uint32_t>(mSystems.size());
+	}
+
+	uint32_t EntitySystemScheduler::WaveCount() const
+	{
+		return static_cast<uint32_t>(mWaves.size());
+	}
+
+	void EntitySystemScheduler::RunWave(const Wave& wave, EntityWorld& world, ThreadPool& threadPool)
+	{
+		mWorkItems.clear();
+		for (uint32_t systemIndex : wave.Systems)
+		{
+			const System& system = mSystems[systemIndex];
+
+			mChunks.clear();
+			world.GetChunks(system.Reads | system.Writes, mChunks);
+			for (const EntityChunk& chunk : mChunks)
+			{
+				mWorkItems.emplace_back(systemIndex, chunk);
+			}
+		}
+
+		if (mWorkItems.empty())
+		{
+			return;
+		}
+
+		const size_t batchCount = min(mWorkItems.size(), static_cast<size_t>(threadPool.ThreadCount()) * 4);
+		const size_t batchSize = (mWorkItems.size() + batchCount - 1) / batchCount;
+
+		vector<future<void>> batches;
+		batches.reserve(batchCount);
+		for (size_t begin = 0; begin < mWorkItems.size(); begin += batchSize)
+		{
+			const size_t end = min(begin + batchSize, mWorkItems.size());
+			batches.push_back(threadPool.Enqueue([this, begin, end]()
+			{
+				// One profiler scope per run of chunks from the same system rather than one per chunk.
+				for (size_t i = begin; i < end; )
+				{
+					const System& system = mSystems[mWorkItems[i].System];
+					PROFILE_SCOPE(system.Name);
+
+					for (; i < end && &mSystems[mWorkItems[i].System] == &system; ++i)
+					{
+						system.Function(mWorkItems[i].Chunk);
+					}
+				}
+			}));
+		}
+
+		for (future<void>& batch : batches)
+		{
+			batch.wait();
+		}
+
+		for (future<void>& batch : batches)
+		{
+			batch.get();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "EntityWorld.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace Library
+{
+	class ThreadPool;
+	class EntityCommandBuffer;
+
+	// Runs systems over an EntityWorld's chunks on a thread pool. Each system names the components it reads and writes and is
+	// called once per chunk that has all of them. Systems are grouped into waves: a system joins the wave after the last one
+	// holding a system it conflicts with (one writes a component the other reads or writes), so systems that touch different
+	// data run at the same time and conflicting systems keep the order they were added in. Within a wave, chunks are split
+	// across the workers too.
+	class EntitySystemScheduler final
+	{
+	public:
+		typedef std::function<void(const EntityChunk&)> ChunkFunction;
+
+		EntitySystemScheduler() = default;
+		EntitySystemScheduler(const EntitySystemScheduler&) = delete;
+		EntitySystemScheduler& operator=(const EntitySystemScheduler&) = delete;
+		EntitySystemScheduler(EntitySystemScheduler&&) = delete;
+		EntitySystemScheduler& operator=(EntitySystemScheduler&&) = delete;
+		~EntitySystemScheduler() = default;
+
+		// The name must stay valid for the scheduler's lifetime; it labels the system in profiler captures.
+		void AddSystem(const char* name, ComponentMask reads, ComponentMask writes, ChunkFunction function);
+
+		// Runs every system, wave by wave, then plays back the command buffer the systems recorded into. Call it from outside
+		// the pool.
+		void Run(EntityWorld& world, ThreadPool& threadPool, EntityCommandBuffer& commandBuffer);
+
+		std::uint32_t SystemCount() const;
+		std::uint32_t WaveCount() const;
+
+	private:
+		struct System
+		{
+			const char* Name;
+			ComponentMask Reads;
+			ComponentMask Writes;
+			ChunkFunction Function;
+		};
+
+		struct Wave
+		{
+			ComponentMask Reads;
+			ComponentMask Writes;
+			std::vector<std::uint32_t> Systems;
+		};
+
+		struct WorkItem
+		{
+			std::uint32_t System;
+			EntityChunk Chunk;
+
+			WorkItem(std::uint32_t system, const EntityChunk& chunk) :
+				System(system), Chunk(chunk) { }
+		};
+
+		void RunWave(const Wave& wave, EntityWorld& world, ThreadPool& threadPool);
+
+		std::vector<System> mSystems;
+		std::vector<Wave> mWaves;
+		std::vector<WorkItem> mWorkItems;
+		std::vector<EntityChunk> mChunks;
+	};
+}
\ No newline at end of file
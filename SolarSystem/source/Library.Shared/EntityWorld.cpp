@@ -0,0 +1,428 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	const uint32_t EntityWorld::NoColumn = UINT32_MAX;
+	const uint32_t EntityWorld::NoArchetype = UINT32_MAX;
+
+	EntityWorld::EntityWorld() :
+		mEntityCount(0), mIterationDepth(0)
+	{
+	}
+
+	void EntityWorld::DestroyEntity(Entity entity)
+	{
+		ThrowIfIterating();
+
+		const EntityRecord* record = FindRecord(entity);
+		if (record == nullptr)
+		{
+			return;
+		}
+
+		FreeRow(record->Archetype, record->Chunk, record->Row);
+
+		EntityRecord& freedRecord = mRecords[entity.Index];
+		freedRecord.Archetype = NoArchetype;
+		if (++freedRecord.Generation == 0)
+		{
+			freedRecord.Generation = 1;
+		}
+
+		mFreeIndices.push_back(entity.Index);
+		--mEntityCount;
+	}
+
+	bool EntityWorld::IsAlive(Entity entity) const
+	{
+		return (FindRecord(entity) != nullptr);
+	}
+
+	void EntityWorld::GetChunks(ComponentMask mask, vector<EntityChunk>& chunks)
+	{
+		for (const auto& archetype : mArchetypes)
+		{
+			if ((archetype->Mask & mask) == mask)
+			{
+				for (Chunk& chunk : archetype->Chunks)
+				{
+					chunks.push_back(EntityChunk(chunk.Data, chunk.Count, archetype->ColumnOffsets));
+				}
+			}
+		}
+	}
+
+	void EntityWorld::ForEachChunk(ComponentMask mask, const function<void(const EntityChunk&)>& function)
+	{
+		++mIterationDepth;
+
+		try
+		{
+			for (const auto& archetype : mArchetypes)
+			{
+				if ((archetype->Mask & mask) == mask)
+				{
+					for (Chunk& chunk : archetype->Chunks)
+					{
+						function(EntityChunk(chunk.Data, chunk.Count, archetype->ColumnOffsets));
+					}
+				}
+			}
+		}
+		catch (...)
+		{
+			--mIterationDepth;
+			throw;
+		}
+
+		--mIterationDepth;
+	}
+
+	void EntityWorld::ParallelForEachChunk(ThreadPool& threadPool, ComponentMask mask, const function<void(const EntityChunk&)>& function)
+	{
+		vector<EntityChunk> chunks;
+		GetChunks(mask, chunks);
+		if (chunks.empty())
+		{
+			return;
+		}
+
+		// A few batches per worker keeps the workers busy when chunks cost different amounts, without a task per chunk.
+		const size_t batchCount = min(chunks.size(), static_cast<size_t>(threadPool.ThreadCount()) * 4);
+		const size_t batchSize = (chunks.size() + batchCount - 1) / batchCount;
+
+		++mIterationDepth;
+
+		vector<future<void>> batches;
+		batches.reserve(batchCount);
+		for (size_t begin = 0; begin < chunks.size(); begin += batchSize)
+		{
+			const size_t end = min(begin + batchSize, chunks.size());
+			batches.push_back(threadPool.Enqueue([&chunks, &function, begin, end]()
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					function(chunks[i]);
+				}
+			}));
+		}
+
+		// Every batch refers to the chunk list, so wait for all of them before rethrowing a failure.
+		for (future<void>& batch : batches)
+		{
+			batch.wait();
+		}
+
+		--mIterationDepth;
+
+		for (future<void>& batch : batches)
+		{
+			batch.get();
+		}
+	}
+
+	uint32_t EntityWorld::EntityCount() const
+	{
+		return mEntityCount;
+	}
+
+	uint32_t EntityWorld::ArchetypeCount() const
+	{
+		return static_cast<uint32_t>(mArchetypes.size());
+	}
+
+	uint32_t EntityWorld::ChunkCount() const
+	{
+		size_t chunkCount = 0;
+		for (const auto& archetype : mArchetypes)
+		{
+			chunkCount += archetype->Chunks.size();
+		}
+
+		return static_cast<uint32_t>(chunkCount);
+	}
+
+	uint32_t EntityWorld::RegisterComponentType(size_t size, size_t alignment)
+	{
+		if (alignment > ChunkAlignment)
+		{
+			throw GameException("EntityWorld: component alignment cannot exceed the chunk alignment.");
+		}
+
+		lock_guard<mutex> lock(ComponentTypesMutex());
+
+		vector<ComponentType>& componentTypes = ComponentTypes();
+		if (componentTypes.size() >= MaxComponentTypes)
+		{
+			throw GameException("EntityWorld: too many component types; raise EntityWorld::MaxComponentTypes.");
+		}
+
+		ComponentType componentType;
+		componentType.Size = static_cast<uint32_t>(size);
+		componentType.Alignment = static_cast<uint32_t>(alignment);
+		componentTypes.push_back(componentType);
+
+		return static_cast<uint32_t>(componentTypes.size() - 1);
+	}
+
+	vector<EntityWorld::ComponentType>& EntityWorld::ComponentTypes()
+	{
+		static vector<ComponentType> componentTypes;
+		return componentTypes;
+	}
+
+	mutex& EntityWorld::ComponentTypesMutex()
+	{
+		static mutex componentTypesMutex;
+		return componentTypesMutex;
+	}
+
+	Entity EntityWorld::CreateEntityFromData(ComponentMask mask, const void* const* data, const uint32_t* typeIds, size_t componentCount)
+	{
+		ThrowIfIterating();
+
+		const uint32_t archetypeIndex = FindOrCreateArchetype(mask);
+		const Entity entity = AllocateEntity();
+		AllocateRow(archetypeIndex, entity);
+
+		const EntityRecord& record = mRecords[entity.Index];
+		const Archetype& archetype = *mArchetypes[archetypeIndex];
+		unsigned char* chunkData = archetype.Chunks[record.Chunk].Data;
+		for (size_t i = 0; i < componentCount; ++i)
+		{
+			const uint32_t size = archetype.ComponentSizes[typeIds[i]];
+			memcpy(chunkData + archetype.ColumnOffsets[typeIds[i]] + record.Row * size, data[i], size);
+		}
+
+		++mEntityCount;
+
+		return entity;
+	}
+
+	void EntityWorld::AddComponent(Entity entity, uint32_t typeId, const void* component)
+	{
+		ThrowIfIterating();
+
+		const EntityRecord* record = FindRecord(entity);
+		if (record == nullptr)
+		{
+			throw GameException("EntityWorld::AddComponent(): the entity has been destroyed.");
+		}
+
+		if (mArchetypes[record->Archetype]->ColumnOffsets[typeId] == NoColumn)
+		{
+			MoveEntity(entity, FindOrCreateArchetype(mArchetypes[record->Archetype]->Mask | ComponentBit(typeId)));
+		}
+
+		void* destination = GetComponent(entity, typeId);
+		memcpy(destination, component, mArchetypes[record->Archetype]->ComponentSizes[typeId]);
+	}
+
+	void EntityWorld::RemoveComponent(Entity entity, uint32_t typeId)
+	{
+		ThrowIfIterating();
+
+		const EntityRecord* record = FindRecord(entity);
+		if (record == nullptr || mArchetypes[record->Archetype]->ColumnOffsets[typeId] == NoColumn)
+		{
+			return;
+		}
+
+		MoveEntity(entity, FindOrCreateArchetype(mArchetypes[record->Archetype]->Mask & ~ComponentBit(typeId)));
+	}
+
+	void* EntityWorld::GetComponent(Entity entity, uint32_t typeId) const
+	{
+		const EntityRecord* record = FindRecord(entity);
+		if (record == nullptr)
+		{
+			return nullptr;
+		}
+
+		const Archetype& archetype = *mArchetypes[record->Archetype];
+		const uint32_t offset = archetype.ColumnOffsets[typeId];
+		if (offset == NoColumn)
+		{
+			return nullptr;
+		}
+
+		return archetype.Chunks[record->Chunk].Data + offset + record->Row * archetype.ComponentSizes[typeId];
+	}
+
+	uint32_t EntityWorld::FindOrCreateArchetype(ComponentMask mask)
+	{
+		auto position = mArchetypesByMask.find(mask);
+		if (position != mArchetypesByMask.end())
+		{
+			return position->second;
+		}
+
+		unique_ptr<Archetype> archetype = make_unique<Archetype>();
+		archetype->Mask = mask;
+		archetype->EntityCount = 0;
+		fill(begin(archetype->ColumnOffsets), end(archetype->ColumnOffsets), NoColumn);
+		fill(begin(archetype->ComponentSizes), end(archetype->ComponentSizes), 0);
+
+		uint32_t alignments[MaxComponentTypes];
+		uint32_t rowSize = sizeof(Entity);
+		uint32_t alignmentPadding = 0;
+		{
+			lock_guard<mutex> lock(ComponentTypesMutex());
+
+			const vector<ComponentType>& componentTypes = ComponentTypes();
+			for (uint32_t typeId = 0; typeId < MaxComponentTypes; ++typeId)
+			{
+				if ((mask & ComponentBit(typeId)) != 0)
+				{
+					archetype->ComponentTypes.push_back(typeId);
+					archetype->ComponentSizes[typeId] = componentTypes[typeId].Size;
+					alignments[typeId] = max(1U, componentTypes[typeId].Alignment);
+					rowSize += componentTypes[typeId].Size;
+					alignmentPadding += componentTypes[typeId].Alignment;
+				}
+			}
+		}
+
+		// Size the chunk so that every array fits after aligning each one; a row larger than a chunk gets a chunk of its own.
+		archetype->Capacity = (alignmentPadding + rowSize < ChunkSize ? (ChunkSize - alignmentPadding) / rowSize : 1);
+
+		uint32_t offset = archetype->Capacity * sizeof(Entity);
+		for (uint32_t typeId : archetype->ComponentTypes)
+		{
+			offset = (offset + alignments[typeId] - 1) / alignments[typeId] * alignments[typeId];
+			archetype->ColumnOffsets[typeId] = offset;
+			offset += archetype->Capacity * archetype->ComponentSizes[typeId];
+		}
+
+		archetype->ChunkBytes = offset;
+
+		const uint32_t archetypeIndex = static_cast<uint32_t>(mArchetypes.size());
+		mArchetypes.push_back(move(archetype));
+		mArchetypesByMask.emplace(mask, archetypeIndex);
+
+		return archetypeIndex;
+	}
+
+	Entity EntityWorld::AllocateEntity()
+	{
+		if (mFreeIndices.empty() == false)
+		{
+			const uint32_t index = mFreeIndices.back();
+			mFreeIndices.pop_back();
+
+			return Entity(index, mRecords[index].Generation);
+		}
+
+		EntityRecord record;
+		record.Archetype = NoArchetype;
+		record.Chunk = 0;
+		record.Row = 0;
+		record.Generation = 1;
+		mRecords.push_back(record);
+
+		return Entity(static_cast<uint32_t>(mRecords.size() - 1), record.Generation);
+	}
+
+	void EntityWorld::AllocateRow(uint32_t archetypeIndex, Entity entity)
+	{
+		Archetype& archetype = *mArchetypes[archetypeIndex];
+
+		// Only the last chunk is ever partly full, so new rows always go there.
+		if (archetype.Chunks.empty() || archetype.Chunks.back().Count == archetype.Capacity)
+		{
+			Chunk chunk;
+			chunk.Memory.reset(new unsigned char[archetype.ChunkBytes + ChunkAlignment]);
+			const uintptr_t address = reinterpret_cast<uintptr_t>(chunk.Memory.get());
+			chunk.Data = chunk.Memory.get() + ((ChunkAlignment - address % ChunkAlignment) % ChunkAlignment);
+			archetype.Chunks.push_back(move(chunk));
+		}
+
+		Chunk& chunk = archetype.Chunks.back();
+		const uint32_t row = chunk.Count++;
+		reinterpret_cast<Entity*>(chunk.Data)[row] = entity;
+		++archetype.EntityCount;
+
+		EntityRecord& record = mRecords[entity.Index];
+		record.Archetype = archetypeIndex;
+		record.Chunk = static_cast<uint32_t>(archetype.Chunks.size() - 1);
+		record.Row = row;
+	}
+
+	void EntityWorld::FreeRow(uint32_t archetypeIndex, uint32_t chunkIndex, uint32_t row)
+	{
+		Archetype& archetype = *mArchetypes[archetypeIndex];
+		Chunk& lastChunk = archetype.Chunks.back();
+		const uint32_t lastChunkIndex = static_cast<uint32_t>(archetype.Chunks.size() - 1);
+		const uint32_t lastRow = lastChunk.Count - 1;
+
+		// Fill the hole with the archetype's last row so the chunks stay packed.
+		if (chunkIndex != lastChunkIndex || row != lastRow)
+		{
+			Chunk& chunk = archetype.Chunks[chunkIndex];
+			const Entity movedEntity = reinterpret_cast<Entity*>(lastChunk.Data)[lastRow];
+			reinterpret_cast<Entity*>(chunk.Data)[row] = movedEntity;
+
+			for (uint32_t typeId : archetype.ComponentTypes)
+			{
+				const uint32_t size = archetype.ComponentSizes[typeId];
+				const uint32_t offset = archetype.ColumnOffsets[typeId];
+				memcpy(chunk.Data + offset + row * size, lastChunk.Data + offset + lastRow * size, size);
+			}
+
+			EntityRecord& movedRecord = mRecords[movedEntity.Index];
+			movedRecord.Chunk = chunkIndex;
+			movedRecord.Row = row;
+		}
+
+		--archetype.EntityCount;
+		if (--lastChunk.Count == 0)
+		{
+			archetype.Chunks.pop_back();
+		}
+	}
+
+	void EntityWorld::MoveEntity(Entity entity, uint32_t archetypeIndex)
+	{
+		const EntityRecord source = mRecords[entity.Index];
+		AllocateRow(archetypeIndex, entity);
+
+		const EntityRecord& destination = mRecords[entity.Index];
+		const Archetype& sourceArchetype = *mArchetypes[source.Archetype];
+		const Archetype& destinationArchetype = *mArchetypes[archetypeIndex];
+		const unsigned char* sourceData = sourceArchetype.Chunks[source.Chunk].Data;
+		unsigned char* destinationData = destinationArchetype.Chunks[destination.Chunk].Data;
+
+		for (uint32_t typeId : destinationArchetype.ComponentTypes)
+		{
+			if (sourceArchetype.ColumnOffsets[typeId] != NoColumn)
+			{
+				const uint32_t size = destinationArchetype.ComponentSizes[typeId];
+				memcpy(destinationData + destinationArchetype.ColumnOffsets[typeId] + destination.Row * size, sourceData + sourceArchetype.ColumnOffsets[typeId] + source.Row * size, size);
+			}
+		}
+
+		FreeRow(source.Archetype, source.Chunk, source.Row);
+	}
+
+	const EntityWorld::EntityRecord* EntityWorld::FindRecord(Entity entity) const
+	{
+		if (entity.Index >= mRecords.size())
+		{
+			return nullptr;
+		}
+
+		const EntityRecord& record = mRecords[entity.Index];
+
+		return (record.Archetype != NoArchetype && record.Generation == entity.Generation ? &record : nullptr);
+	}
+
+	void EntityWorld::ThrowIfIterating() const
+	{
+		if (mIterationDepth > 0)
+		{
+			throw GameException("EntityWorld: entities and components cannot be added or removed while chunks are being iterated; record the change in an EntityCommandBuffer.");
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+#include <type_traits>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+namespace Library
+{
+	class ThreadPool;
+
+	// A handle to an entity. The generation changes whenever an index is reused, so a handle to a destroyed entity stays invalid.
+	struct Entity final
+	{
+		std::uint32_t Index;
+		std::uint32_t Generation;
+
+		Entity() :
+			Index(0), Generation(0) { }
+
+		Entity(std::uint32_t index, std::uint32_t generation) :
+			Index(index), Generation(generation) { }
+
+		bool IsNull() const
+		{
+			return Generation == 0;
+		}
+
+		bool operator==(const Entity& rhs) const
+		{
+			return (Index == rhs.Index && Generation == rhs.Generation);
+		}
+
+		bool operator!=(const Entity& rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	// One bit per component type.
+	typedef std::uint64_t ComponentMask;
+
+	// One chunk of an archetype: Count() entities, with each component type stored as its own array.
+	class EntityChunk final
+	{
+		friend class EntityWorld;
+
+	public:
+		std::uint32_t Count() const
+		{
+			return mCount;
+		}
+
+		const Entity* Entities() const
+		{
+			return reinterpret_cast<const Entity*>(mData);
+		}
+
+		// The chunk's array of T, or nullptr when its archetype has no T.
+		template <typename T>
+		T* Components() const;
+
+		template <typename T>
+		bool Has() const
+		{
+			return (Components<T>() != nullptr);
+		}
+
+	private:
+		EntityChunk(unsigned char* data, std::uint32_t count, const std::uint32_t* columnOffsets) :
+			mData(data), mCount(count), mColumnOffsets(columnOffsets) { }
+
+		unsigned char* mData;
+		std::uint32_t mCount;
+		const std::uint32_t* mColumnOffsets;
+	};
+
+	// Stores entities by archetype (the exact set of component types they have). Each archetype packs its entities into
+	// fixed-size chunks, one array per component type, so a system touches only the arrays it asks for, in order.
+	// Components must be trivially copyable; they are moved between archetypes with memcpy and never destructed.
+	// Adding or removing entities or components moves data between chunks, so it must not happen while chunks are being
+	// iterated; record those changes in an EntityCommandBuffer and play it back afterwards.
+	class EntityWorld final
+	{
+		friend class EntitySystemScheduler;
+
+	public:
+		static const std::uint32_t MaxComponentTypes = 64;
+		static const std::uint32_t ChunkSize = 16 * 1024;
+
+		EntityWorld();
+		EntityWorld(const EntityWorld&) = delete;
+		EntityWorld& operator=(const EntityWorld&) = delete;
+		EntityWorld(EntityWorld&&) = delete;
+		EntityWorld& operator=(EntityWorld&&) = delete;
+		~EntityWorld() = default;
+
+		// Every type gets a small dense id the first time it is used as a component.
+		template <typename T>
+		static std::uint32_t ComponentTypeId()
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Entity components must be trivially copyable.");
+
+			static const std::uint32_t id = RegisterComponentType(sizeof(T), alignof(T));
+			return id;
+		}
+
+		template <typename... TComponents>
+		static ComponentMask MaskOf()
+		{
+			ComponentMask mask = 0;
+			int expand[] = { 0, (mask |= ComponentBit(ComponentTypeId<TComponents>()), 0)... };
+			(void)expand;
+
+			return mask;
+		}
+
+		template <typename... TComponents>
+		Entity CreateEntity(const TComponents&... components)
+		{
+			const void* data[] = { nullptr, &components... };
+			const std::uint32_t typeIds[] = { 0, ComponentTypeId<TComponents>()... };
+
+			return CreateEntityFromData(MaskOf<TComponents...>(), data + 1, typeIds + 1, sizeof...(TComponents));
+		}
+
+		void DestroyEntity(Entity entity);
+		bool IsAlive(Entity entity) const;
+
+		// Moves the entity to the archetype that also has T; replaces the value if it already has one.
+		template <typename T>
+		void AddComponent(Entity entity, const T& component)
+		{
+			AddComponent(entity, ComponentTypeId<T>(), &component);
+		}
+
+		template <typename T>
+		void RemoveComponent(Entity entity)
+		{
+			RemoveComponent(entity, ComponentTypeId<T>());
+		}
+
+		template <typename T>
+		T* GetComponent(Entity entity)
+		{
+			return static_cast<T*>(GetComponent(entity, ComponentTypeId<T>()));
+		}
+
+		template <typename T>
+		const T* GetComponent(Entity entity) const
+		{
+			return static_cast<const T*>(GetComponent(entity, ComponentTypeId<T>()));
+		}
+
+		template <typename T>
+		bool HasComponent(Entity entity) const
+		{
+			return (GetComponent(entity, ComponentTypeId<T>()) != nullptr);
+		}
+
+		// Appends a view of every non-empty chunk whose archetype has all the components in the mask.
+		void GetChunks(ComponentMask mask, std::vector<EntityChunk>& chunks);
+
+		void ForEachChunk(ComponentMask mask, const std::function<void(const EntityChunk&)>& function);
+
+		// Splits the matching chunks into batches and runs them on the pool, returning once every batch is done. The function
+		// must only write to the chunk it is given. Call it from outside the pool; a worker waiting on its own pool can deadlock.
+		void ParallelForEachChunk(ThreadPool& threadPool, ComponentMask mask, const std::function<void(const EntityChunk&)>& function);
+
+		std::uint32_t EntityCount() const;
+		std::uint32_t ArchetypeCount() const;
+		std::uint32_t ChunkCount() const;
+
+		static ComponentMask ComponentBit(std::uint32_t typeId)
+		{
+			return (ComponentMask(1) << typeId);
+		}
+
+		static const std::uint32_t NoColumn;
+
+	private:
+		struct ComponentType
+		{
+			std::uint32_t Size;
+			std::uint32_t Alignment;
+		};
+
+		struct Chunk
+		{
+			std::unique_ptr<unsigned char[]> Memory;
+			unsigned char* Data;
+			std::uint32_t Count;
+
+			Chunk() :
+				Data(nullptr), Count(0) { }
+		};
+
+		struct Archetype
+		{
+			ComponentMask Mask;
+			std::vector<std::uint32_t> ComponentTypes;
+			std::uint32_t ColumnOffsets[MaxComponentTypes];
+			std::uint32_t ComponentSizes[MaxComponentTypes];
+			std::uint32_t Capacity;
+			std::uint32_t ChunkBytes;
+			std::vector<Chunk> Chunks;
+			std::uint32_t EntityCount;
+		};
+
+		struct EntityRecord
+		{
+			std::uint32_t Archetype;
+			std::uint32_t Chunk;
+			std::uint32_t Row;
+			std::uint32_t Generation;
+		};
+
+		static std::uint32_t RegisterComponentType(std::size_t size, std::size_t alignment);
+		static std::vector<ComponentType>& ComponentTypes();
+		static std::mutex& ComponentTypesMutex();
+
+		Entity CreateEntityFromData(ComponentMask mask, const void* const* data, const std::uint32_t* typeIds, std::size_t componentCount);
+		void AddComponent(Entity entity, std::uint32_t typeId, const void* component);
+		void RemoveComponent(Entity entity, std::uint32_t typeId);
+		void* GetComponent(Entity entity, std::uint32_t typeId) const;
+
+		std::uint32_t FindOrCreateArchetype(ComponentMask mask);
+		Entity AllocateEntity();
+		void AllocateRow(std::uint32_t archetypeIndex, Entity entity);
+		void FreeRow(std::uint32_t archetypeIndex, std::uint32_t chunkIndex, std::uint32_t row);
+		void MoveEntity(Entity entity, std::uint32_t archetypeIndex);
+		const EntityRecord* FindRecord(Entity entity) const;
+		void ThrowIfIterating() const;
+
+		static const std::uint32_t NoArchetype;
+		static const std::uint32_t ChunkAlignment = 64;
+
+		std::vector<std::unique_ptr<Archetype>> mArchetypes;
+		std::unordered_map<ComponentMask, std::uint32_t> mArchetypesByMask;
+		std::vector<EntityRecord> mRecords;
+		std::vector<std::uint32_t> mFreeIndices;
+		std::uint32_t mEntityCount;
+		std::uint32_t mIterationDepth;
+	};
+
+	template <typename T>
+	T* EntityChunk::Components() const
+	{
+		const std::uint32_t offset = mColumnOffsets[EntityWorld::ComponentTypeId<T>()];
+		return (offset == EntityWorld::NoColumn ? nullptr : reinterpret_cast<T*>(mData + offset));
+	}
+}
\ No newline at end of file
@@ -71,9 +71,9 @@ namespace Library
 
 	void FirstPersonCamera::Initialize()
 	{
-		mGamePad = (GamePadComponent*)mGame->Services().GetService(GamePadComponent::TypeIdClass());
-		mKeyboard = (KeyboardComponent*)mGame->Services().GetService(KeyboardComponent::TypeIdClass());
-		mMouse = (MouseComponent*)mGame->Services().GetService(MouseComponent::TypeIdClass());
+		mGamePad = mGame->Services().GetService<GamePadComponent>();
+		mKeyboard = mGame->Services().GetService<KeyboardComponent>();
+		mMouse = mGame->Services().GetService<MouseComponent>();
 
 		Camera::Initialize();
 	}
@@ -137,7 +137,8 @@ namespace Library
 
 	void FirstPersonCamera::UpdatePosition(const XMFLOAT2& movementAmount, const XMFLOAT2& rotationAmount, const GameTime& gameTime)
 	{
-		float elapsedTime = gameTime.ElapsedGameTimeSeconds().count();
+		// Real time, so the camera still moves while the game is paused or time is warped.
+		float elapsedTime = gameTime.ElapsedRealTimeSeconds().count();
 		XMVECTOR rotationVector = XMLoadFloat2(&rotationAmount) * mRotationRate * elapsedTime;
 		XMVECTOR right = XMLoadFloat3(&mRight);
 
@@ -1,6 +1,7 @@
 #include "pch.h"
 
 using namespace std;
+using namespace std::chrono;
 using namespace DirectX;
 
 namespace Library
@@ -9,8 +10,19 @@ namespace Library
 
 	FpsComponent::FpsComponent(Game& game) :
 		DrawableGameComponent(game),
-		mTextPosition(0.0f, 20.0f), mFrameCount(0), mFrameRate(0)
+		mHud(nullptr), mLabel(0), mTextPosition(0.0f, 20.0f), mFrameCount(0), mFrameRate(0), mStatistics(), mLastTotalRealTime(0), mLastFrameTime(), mDisplayedValues()
 	{
+		UpdateText();
+	}
+
+	FpsComponent::DisplayedValues::DisplayedValues() :
+		FrameRate(0), Mean(0), P50(0), P95(0), P99(0), Max(0), HitchCount(0)
+	{
+	}
+
+	bool FpsComponent::DisplayedValues::operator==(const DisplayedValues& rhs) const
+	{
+		return (FrameRate == rhs.FrameRate && Mean == rhs.Mean && P50 == rhs.P50 && P95 == rhs.P95 && P99 == rhs.P99 && Max == rhs.Max && HitchCount == rhs.HitchCount);
 	}
 
 	XMFLOAT2& FpsComponent::TextPosition()
@@ -20,35 +32,77 @@ namespace Library
 
 	int FpsComponent::FrameRate() const
 	{
-		return mFrameCount;
+		return mFrameRate;
+	}
+
+	FrameStatistics& FpsComponent::Statistics()
+	{
+		return mStatistics;
+	}
+
+	const FrameStatistics& FpsComponent::Statistics() const
+	{
+		return mStatistics;
 	}
 
 	void FpsComponent::Initialize()
 	{
-		mSpriteBatch = make_unique<SpriteBatch>(mGame->Direct3DDeviceContext());
-		mSpriteFont = make_unique<SpriteFont>(mGame->Direct3DDevice(), L"Content\\Fonts\\Arial_14_Regular.spritefont");
+		mHud = mGame->Services().GetService<HudComponent>();
+		assert(mHud != nullptr);
+
+		mLabel = mHud->CreateLabel(mTextPosition);
+		mHud->SetText(mLabel, mText);
 	}
 
 	void FpsComponent::Update(const GameTime& gameTime)
 	{
-		if ((gameTime.TotalGameTime() - mLastTotalGameTime).count() >= 1000)
+		// Real time, so the rate stays right while game time is paused, scaled or stepped.
+		if (gameTime.TotalRealTime() - mLastTotalRealTime >= seconds(1))
 		{
-			mLastTotalGameTime = gameTime.TotalGameTime();
+			mLastTotalRealTime = gameTime.TotalRealTime();
 			mFrameRate = mFrameCount;
 			mFrameCount = 0;
 		}
 
 		++mFrameCount;
+
+		// The first frame has nothing before it to measure from.
+		const steady_clock::time_point& currentTime = gameTime.CurrentTime();
+		if (mLastFrameTime != steady_clock::time_point())
+		{
+			mStatistics.AddFrame(duration_cast<nanoseconds>(currentTime - mLastFrameTime));
+		}
+		mLastFrameTime = currentTime;
+
+		const FrameStatistics::Summary& summary = mStatistics.CurrentSummary();
+		DisplayedValues values;
+		values.FrameRate = mFrameRate;
+		values.Mean = static_cast<int>(summary.MeanMilliseconds * 10.0f + 0.5f);
+		values.P50 = static_cast<int>(summary.P50Milliseconds * 10.0f + 0.5f);
+		values.P95 = static_cast<int>(summary.P95Milliseconds * 10.0f + 0.5f);
+		values.P99 = static_cast<int>(summary.P99Milliseconds * 10.0f + 0.5f);
+		values.Max = static_cast<int>(summary.MaxMilliseconds * 10.0f + 0.5f);
+		values.HitchCount = summary.HitchCount;
+
+		if ((values == mDisplayedValues) == false)
+		{
+			mDisplayedValues = values;
+			UpdateText();
+			mHud->SetText(mLabel, mText);
+		}
+
+		mHud->SetPosition(mLabel, mTextPosition);
 	}
 
-	void FpsComponent::Draw(const GameTime& gameTime)
+	void FpsComponent::UpdateText()
 	{
-		mSpriteBatch->Begin();
-
-		wostringstream fpsLabel;
-		fpsLabel << setprecision(4) << L"Frame Rate: " << mFrameRate << "    Total Elapsed Time: " << gameTime.TotalGameTimeSeconds().count();
-		mSpriteFont->DrawString(mSpriteBatch.get(), fpsLabel.str().c_str(), mTextPosition);
+		MemoryTagScope memoryTagScope(MemoryTag::UI);
 
-		mSpriteBatch->End();
+		// The text changes most frames, so build it in frame memory; assign() reuses mText's capacity
+		TextBuilder fpsLabel(mGame->FrameMemory().ThreadResource());
+		fpsLabel << TextBuilder::Fixed(1) << L"Frame Rate: " << mDisplayedValues.FrameRate
+			<< L"    Frame Time: " << mDisplayedValues.Mean / 10.0f << L" ms (p50 " << mDisplayedValues.P50 / 10.0f << L", p95 " << mDisplayedValues.P95 / 10.0f
+			<< L", p99 " << mDisplayedValues.P99 / 10.0f << L", max " << mDisplayedValues.Max / 10.0f << L")    Hitches: " << mDisplayedValues.HitchCount;
+		mText.assign(fpsLabel.c_str(), fpsLabel.Length());
 	}
 }
\ No newline at end of file
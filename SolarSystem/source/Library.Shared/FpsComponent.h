@@ -1,18 +1,15 @@
 #pragma once
 
 #include "DrawableGameComponent.h"
+#include "FrameStatistics.h"
 #include <DirectXMath.h>
 #include <chrono>
-#include <memory>
-
-namespace DirectX
-{
-	class SpriteBatch;
-	class SpriteFont;
-}
+#include <string>
 
 namespace Library
 {
+	class HudComponent;
+
 	class FpsComponent final : public DrawableGameComponent
 	{
 		RTTI_DECLARATIONS(FpsComponent, DrawableGameComponent)
@@ -27,17 +24,42 @@ namespace Library
 		DirectX::XMFLOAT2& TextPosition();
 		int FrameRate() const;
 
+		FrameStatistics& Statistics();
+		const FrameStatistics& Statistics() const;
+
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
-		virtual void Draw(const GameTime& gameTime) override;
 
 	private:
-		std::unique_ptr<DirectX::SpriteBatch> mSpriteBatch;
-		std::unique_ptr<DirectX::SpriteFont> mSpriteFont;
+		// What the label shows, at display precision (frame times in tenths of a millisecond).
+		struct DisplayedValues
+		{
+			int FrameRate;
+			int Mean;
+			int P50;
+			int P95;
+			int P99;
+			int Max;
+			std::uint64_t HitchCount;
+
+			DisplayedValues();
+
+			bool operator==(const DisplayedValues& rhs) const;
+		};
+
+		void UpdateText();
+
+		HudComponent* mHud;
+		std::uint32_t mLabel;
 		DirectX::XMFLOAT2 mTextPosition;
 
 		int mFrameCount;
 		int mFrameRate;
-		std::chrono::milliseconds mLastTotalGameTime;
+		std::chrono::nanoseconds mLastTotalRealTime;
+
+		FrameStatistics mStatistics;
+		std::chrono::steady_clock::time_point mLastFrameTime;
+		DisplayedValues mDisplayedValues;
+		std::wstring mText;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	mutex FrameArena::sThreadIndexMutex;
+	vector<uint32_t> FrameArena::sFreeThreadIndices;
+	uint32_t FrameArena::sNextThreadIndex = 0;
+
+	FrameArena::FrameArena(size_t capacityPerThread) :
+		mFrameIndex(0)
+	{
+		for (unique_ptr<ThreadArena>& threadArena : mThreadArenas)
+		{
+			threadArena = make_unique<ThreadArena>(*this, capacityPerThread);
+		}
+	}
+
+	void FrameArena::BeginFrame()
+	{
+		mFrameIndex.fetch_add(1, memory_order_relaxed);
+	}
+
+	uint64_t FrameArena::FrameIndex() const
+	{
+		return mFrameIndex.load(memory_order_relaxed);
+	}
+
+	MemoryResource& FrameArena::ThreadResource()
+	{
+		const uint32_t threadIndex = ThreadIndex();
+		if (threadIndex >= MaxThreads)
+		{
+			return MemoryResource::Heap();
+		}
+
+		return *mThreadArenas[threadIndex];
+	}
+
+	size_t FrameArena::UsedBytes() const
+	{
+		size_t usedBytes = 0;
+		for (const unique_ptr<ThreadArena>& threadArena : mThreadArenas)
+		{
+			usedBytes += threadArena->UsedBytes();
+		}
+
+		return usedBytes;
+	}
+
+	uint32_t FrameArena::OverflowCount() const
+	{
+		uint32_t overflowCount = 0;
+		for (const unique_ptr<ThreadArena>& threadArena : mThreadArenas)
+		{
+			overflowCount += threadArena->OverflowCount();
+		}
+
+		return overflowCount;
+	}
+
+	uint32_t FrameArena::ThreadIndex()
+	{
+		// Dense per-process thread numbers, shared by every FrameArena
+		static thread_local const ThreadIndexLease lease;
+		return lease.Index();
+	}
+
+	FrameArena::ThreadIndexLease::ThreadIndexLease()
+	{
+		lock_guard<mutex> lock(sThreadIndexMutex);
+		if (sFreeThreadIndices.empty())
+		{
+			mIndex = sNextThreadIndex++;
+		}
+		else
+		{
+			// The exited thread's last allocations happened before it returned the index under this lock, so its arenas can be
+			// taken over without further synchronization. Taking the lowest index keeps the live threads within MaxThreads.
+			auto lowest = min_element(sFreeThreadIndices.begin(), sFreeThreadIndices.end());
+			mIndex = *lowest;
+			sFreeThreadIndices.erase(lowest);
+		}
+	}
+
+	FrameArena::ThreadIndexLease::~ThreadIndexLease()
+	{
+		lock_guard<mutex> lock(sThreadIndexMutex);
+		sFreeThreadIndices.push_back(mIndex);
+	}
+
+	uint32_t FrameArena::ThreadIndexLease::Index() const
+	{
+		return mIndex;
+	}
+
+	FrameArena::ThreadArena::ThreadArena(const FrameArena& owner, size_t capacity) :
+		mOwner(&owner), mCurrent(0), mFrameIndex(0), mUsedBytes(0), mOverflowCount(0)
+	{
+		mArenas[0] = make_unique<LinearArena>(capacity);
+		mArenas[1] = make_unique<LinearArena>(capacity);
+	}
+
+	size_t FrameArena::ThreadArena::UsedBytes() const
+	{
+		return mUsedBytes.load(memory_order_relaxed);
+	}
+
+	uint32_t FrameArena::ThreadArena::OverflowCount() const
+	{
+		return mOverflowCount.load(memory_order_relaxed);
+	}
+
+	void* FrameArena::ThreadArena::DoAllocate(size_t bytes, size_t alignment)
+	{
+		// Only the owning thread gets here, so switching arenas needs no synchronization
+		const uint64_t frameIndex = mOwner->FrameIndex();
+		if (frameIndex != mFrameIndex)
+		{
+			mFrameIndex = frameIndex;
+			mCurrent = 1 - mCurrent;
+			mArenas[mCurrent]->Reset();
+		}
+
+		LinearArena& arena = *mArenas[mCurrent];
+		void* memory = arena.Allocate(bytes, alignment);
+		mUsedBytes.store(arena.UsedBytes() + arena.OverflowBytes(), memory_order_relaxed);
+		mOverflowCount.store(arena.OverflowCount(), memory_order_relaxed);
+
+		return memory;
+	}
+
+	void FrameArena::ThreadArena::DoDeallocate(void* memory, size_t bytes, size_t alignment)
+	{
+		UNREFERENCED_PARAMETER(memory);
+		UNREFERENCED_PARAMETER(bytes);
+		UNREFERENCED_PARAMETER(alignment);
+	}
+
+	bool FrameArena::ThreadArena::DoIsEqual(const MemoryResource& other) const
+	{
+		return (this == &other);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "LinearArena.h"
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+namespace Library
+{
+	// Scratch memory for allocations that only live until the end of the frame after the one that made them. Every thread
+	// gets its own pair of LinearArenas, so worker jobs allocate without locks. BeginFrame() only advances the frame index;
+	// each thread switches to its other arena, resetting it, on its first allocation of a new frame. Nothing needs to stop
+	// at the frame boundary, and memory a thread got last frame stays valid through this one (e.g. for a frame simulated
+	// ahead on another thread). Threads are numbered per process, and a thread's number goes back for reuse when it exits, so
+	// a new thread can take over an exited thread's arenas; only threads beyond MaxThreads alive at once fall back to the heap.
+	class FrameArena final
+	{
+	public:
+		static const std::uint32_t MaxThreads = 32;
+		static const std::size_t DefaultCapacityPerThread = 256 * 1024;
+
+		explicit FrameArena(std::size_t capacityPerThread = DefaultCapacityPerThread);
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+		FrameArena(FrameArena&&) = delete;
+		FrameArena& operator=(FrameArena&&) = delete;
+		~FrameArena() = default;
+
+		void BeginFrame();
+		std::uint64_t FrameIndex() const;
+
+		// The calling thread's arena, or the heap for threads beyond MaxThreads alive at once.
+		MemoryResource& ThreadResource();
+
+		// Totals over every thread's current arena; other threads may be allocating while these are read.
+		std::size_t UsedBytes() const;
+		std::uint32_t OverflowCount() const;
+
+	private:
+		class ThreadArena final : public MemoryResource
+		{
+		public:
+			ThreadArena(const FrameArena& owner, std::size_t capacity);
+			ThreadArena(const ThreadArena&) = delete;
+			ThreadArena& operator=(const ThreadArena&) = delete;
+			ThreadArena(ThreadArena&&) = delete;
+			ThreadArena& operator=(ThreadArena&&) = delete;
+			~ThreadArena() = default;
+
+			std::size_t UsedBytes() const;
+			std::uint32_t OverflowCount() const;
+
+		protected:
+			virtual void* DoAllocate(std::size_t bytes, std::size_t alignment) override;
+			virtual void DoDeallocate(void* memory, std::size_t bytes, std::size_t alignment) override;
+			virtual bool DoIsEqual(const MemoryResource& other) const override;
+
+		private:
+			const FrameArena* mOwner;
+			std::unique_ptr<LinearArena> mArenas[2];
+			std::uint32_t mCurrent;
+			std::uint64_t mFrameIndex;
+			std::atomic<std::size_t> mUsedBytes;
+			std::atomic<std::uint32_t> mOverflowCount;
+		};
+
+		// Takes the lowest free thread index for as long as the thread runs.
+		class ThreadIndexLease final
+		{
+		public:
+			ThreadIndexLease();
+			ThreadIndexLease(const ThreadIndexLease&) = delete;
+			ThreadIndexLease& operator=(const ThreadIndexLease&) = delete;
+			ThreadIndexLease(ThreadIndexLease&&) = delete;
+			ThreadIndexLease& operator=(ThreadIndexLease&&) = delete;
+			~ThreadIndexLease();
+
+			std::uint32_t Index() const;
+
+		private:
+			std::uint32_t mIndex;
+		};
+
+		static std::uint32_t ThreadIndex();
+
+		static std::mutex sThreadIndexMutex;
+		static std::vector<std::uint32_t> sFreeThreadIndices;
+		static std::uint32_t sNextThreadIndex;
+
+		std::atomic<std::uint64_t> mFrameIndex;
+		std::unique_ptr<ThreadArena> mThreadArenas[MaxThreads];
+	};
+}
\ No newline at end of file
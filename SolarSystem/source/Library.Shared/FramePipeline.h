@@ -0,0 +1,235 @@
+#pragma once
+
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cassert>
+
+namespace Library
+{
+	// Runs a simulation one frame ahead of the thread that renders it. Each frame the render thread hands Exchange() the input
+	// it sampled and gets back the frame simulated from the previous input, while the simulation thread turns the new input
+	// into the next frame. Inputs travel through an SPSC queue and frames through a triple buffer, so the handoff itself takes
+	// no locks; the mutex only parks a thread that has nothing to do. Until Start() (and after Stop()) Exchange() simulates on
+	// the calling thread, so the same callback serves both modes.
+	template <typename TInput, typename TFrame>
+	class FramePipeline final
+	{
+	public:
+		typedef std::function<void(const TInput&, TFrame&)> SimulateCallback;
+
+		explicit FramePipeline(SimulateCallback simulate) :
+			mSimulate(simulate), mInputs(InputCapacity), mSimulationNanoseconds(0), mWaitTime(0),
+			mIsFrameInFlight(false), mHasFrame(false), mStopRequested(false)
+		{
+		}
+
+		FramePipeline(const FramePipeline&) = delete;
+		FramePipeline& operator=(const FramePipeline&) = delete;
+		FramePipeline(FramePipeline&&) = delete;
+		FramePipeline& operator=(FramePipeline&&) = delete;
+
+		~FramePipeline()
+		{
+			// Don't let a pending simulation failure escape the destructor
+			if (IsRunning())
+			{
+				{
+					std::lock_guard<std::mutex> lock(mMutex);
+					mStopRequested = true;
+				}
+
+				mInputAvailable.notify_one();
+				mThread.join();
+			}
+		}
+
+		bool IsRunning() const
+		{
+			return mThread.joinable();
+		}
+
+		void Start()
+		{
+			if (IsRunning())
+			{
+				return;
+			}
+
+			mStopRequested = false;
+			mThread = std::thread(&FramePipeline::SimulationThread, this);
+		}
+
+		// Waits for the frame in flight, which becomes the current frame, then joins the simulation thread.
+		void Stop()
+		{
+			if (IsRunning() == false)
+			{
+				return;
+			}
+
+			if (mIsFrameInFlight)
+			{
+				WaitForFrame();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mStopRequested = true;
+			}
+
+			mInputAvailable.notify_one();
+			mThread.join();
+			RethrowSimulationException();
+		}
+
+		// Render thread only, once per frame. Rethrows anything the callback threw on the simulation thread. The very first
+		// frame, and every frame while stopped, is simulated here and returned directly; once running, the frame current
+		// before Start() is returned once more while the simulation thread catches up.
+		const TFrame& Exchange(const TInput& input)
+		{
+			if (IsRunning() == false || mHasFrame == false)
+			{
+				const std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+				mSimulate(input, mFrames.WriteBuffer());
+				mSimulationNanoseconds.store(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count(), std::memory_order_relaxed);
+
+				mFrames.Publish();
+				mFrames.Acquire();
+				mHasFrame = true;
+				mWaitTime = std::chrono::nanoseconds::zero();
+
+				return mFrames.ReadBuffer();
+			}
+
+			if (mIsFrameInFlight)
+			{
+				WaitForFrame();
+			}
+			else
+			{
+				mWaitTime = std::chrono::nanoseconds::zero();
+			}
+
+			// The simulation thread is never more than one input behind, so the queue can't be full
+			bool isPushed = mInputs.TryPush(input);
+			assert(isPushed);
+			UNREFERENCED_PARAMETER(isPushed);
+
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+			}
+
+			mInputAvailable.notify_one();
+			mIsFrameInFlight = true;
+
+			return mFrames.ReadBuffer();
+		}
+
+		// Render thread only; the frame the last Exchange() returned.
+		const TFrame& CurrentFrame() const
+		{
+			return mFrames.ReadBuffer();
+		}
+
+		// How long the callback took for the newest frame, on whichever thread ran it.
+		std::chrono::nanoseconds LastSimulationTime() const
+		{
+			return std::chrono::nanoseconds(mSimulationNanoseconds.load(std::memory_order_relaxed));
+		}
+
+		// How long the last Exchange() waited for the simulation thread; zero when the frame was already waiting.
+		std::chrono::nanoseconds LastWaitTime() const
+		{
+			return mWaitTime;
+		}
+
+	private:
+		static const std::size_t InputCapacity = 2;
+
+		void SimulationThread()
+		{
+			TInput input;
+			for (;;)
+			{
+				if (mInputs.TryPop(input) == false)
+				{
+					std::unique_lock<std::mutex> lock(mMutex);
+					mInputAvailable.wait(lock, [&]() { return mStopRequested || mInputs.IsEmpty() == false; });
+					if (mInputs.IsEmpty())
+					{
+						return;
+					}
+
+					continue;
+				}
+
+				const std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+				try
+				{
+					mSimulate(input, mFrames.WriteBuffer());
+				}
+				catch (...)
+				{
+					// Published anyway so the render thread wakes up and rethrows
+					mException = std::current_exception();
+				}
+				mSimulationNanoseconds.store(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count(), std::memory_order_relaxed);
+
+				mFrames.Publish();
+
+				{
+					std::lock_guard<std::mutex> lock(mMutex);
+				}
+
+				mFrameAvailable.notify_one();
+			}
+		}
+
+		void WaitForFrame()
+		{
+			const std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+			if (mFrames.HasFreshValue() == false)
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mFrameAvailable.wait(lock, [&]() { return mFrames.HasFreshValue(); });
+			}
+			mWaitTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime);
+
+			mFrames.Acquire();
+			mIsFrameInFlight = false;
+			RethrowSimulationException();
+		}
+
+		void RethrowSimulationException()
+		{
+			if (mException != nullptr)
+			{
+				std::exception_ptr exception = mException;
+				mException = nullptr;
+				std::rethrow_exception(exception);
+			}
+		}
+
+		SimulateCallback mSimulate;
+		SpscQueue<TInput> mInputs;
+		TripleBuffer<TFrame> mFrames;
+		std::thread mThread;
+		std::mutex mMutex;
+		std::condition_variable mInputAvailable;
+		std::condition_variable mFrameAvailable;
+		std::exception_ptr mException;
+		std::atomic<std::int64_t> mSimulationNanoseconds;
+		std::chrono::nanoseconds mWaitTime;
+		bool mIsFrameInFlight;
+		bool mHasFrame;
+		bool mStopRequested;
+	};
+}
\ No newline at end of file
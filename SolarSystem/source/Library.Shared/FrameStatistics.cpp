@@ -0,0 +1,216 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace Library
+{
+	const uint32_t FrameStatistics::DefaultWindowSize = 1024;
+	const nanoseconds FrameStatistics::DefaultHitchThreshold = milliseconds(50);
+	const uint32_t FrameStatistics::HistogramBucketCount = 23;
+	const uint32_t FrameStatistics::MaxRecentHitches = 32;
+
+	FrameStatistics::Summary::Summary() :
+		FrameCount(0), SampleCount(0), MeanMilliseconds(0.0f), P50Milliseconds(0.0f), P95Milliseconds(0.0f), P99Milliseconds(0.0f),
+		MaxMilliseconds(0.0f), HitchCount(0)
+	{
+	}
+
+	FrameStatistics::FrameStatistics(uint32_t windowSize, nanoseconds hitchThreshold) :
+		mWindowSize(windowSize), mRing(new atomic<uint32_t>[windowSize]()), mFrameCount(0),
+		mWindowSum(0), mHistogram(HistogramBucketCount), mHitchThreshold(hitchThreshold), mLastFrameWasHitch(false)
+	{
+		assert(windowSize > 0);
+
+		mSortedWindow.reserve(windowSize);
+	}
+
+	void FrameStatistics::AddFrame(nanoseconds duration)
+	{
+		uint32_t sample = static_cast<uint32_t>(min<nanoseconds::rep>(max<nanoseconds::rep>(duration.count(), 0), UINT32_MAX));
+		uint64_t frameIndex = mFrameCount.load(memory_order_relaxed);
+		atomic<uint32_t>& slot = mRing[static_cast<size_t>(frameIndex % mWindowSize)];
+
+		// Retire the sample this frame overwrites
+		if (frameIndex >= mWindowSize)
+		{
+			uint32_t evicted = slot.load(memory_order_relaxed);
+			mSortedWindow.erase(lower_bound(mSortedWindow.begin(), mSortedWindow.end(), evicted));
+			mWindowSum -= evicted;
+			--mHistogram[HistogramBucket(evicted)];
+		}
+
+		slot.store(sample, memory_order_relaxed);
+		mFrameCount.store(frameIndex + 1, memory_order_release);
+
+		mSortedWindow.insert(upper_bound(mSortedWindow.begin(), mSortedWindow.end(), sample), sample);
+		mWindowSum += sample;
+		++mHistogram[HistogramBucket(sample)];
+
+		mLastFrameWasHitch = (duration > mHitchThreshold);
+		if (mLastFrameWasHitch)
+		{
+			++mSummary.HitchCount;
+			if (mRecentHitches.size() == MaxRecentHitches)
+			{
+				mRecentHitches.pop_front();
+			}
+
+			mRecentHitches.emplace_back(frameIndex, ToMilliseconds(sample));
+		}
+
+		uint32_t sampleCount = static_cast<uint32_t>(mSortedWindow.size());
+		mSummary.FrameCount = frameIndex + 1;
+		mSummary.SampleCount = sampleCount;
+		mSummary.MeanMilliseconds = ToMilliseconds(mWindowSum / sampleCount);
+		mSummary.P50Milliseconds = ToMilliseconds(Percentile(50));
+		mSummary.P95Milliseconds = ToMilliseconds(Percentile(95));
+		mSummary.P99Milliseconds = ToMilliseconds(Percentile(99));
+		mSummary.MaxMilliseconds = ToMilliseconds(mSortedWindow.back());
+	}
+
+	void FrameStatistics::Reset()
+	{
+		mFrameCount.store(0, memory_order_release);
+		mSortedWindow.clear();
+		mWindowSum = 0;
+		fill(mHistogram.begin(), mHistogram.end(), 0);
+		mLastFrameWasHitch = false;
+		mRecentHitches.clear();
+		mSummary = Summary();
+	}
+
+	uint32_t FrameStatistics::WindowSize() const
+	{
+		return mWindowSize;
+	}
+
+	const FrameStatistics::Summary& FrameStatistics::CurrentSummary() const
+	{
+		return mSummary;
+	}
+
+	const nanoseconds& FrameStatistics::HitchThreshold() const
+	{
+		return mHitchThreshold;
+	}
+
+	void FrameStatistics::SetHitchThreshold(const nanoseconds& hitchThreshold)
+	{
+		mHitchThreshold = hitchThreshold;
+	}
+
+	bool FrameStatistics::LastFrameWasHitch() const
+	{
+		return mLastFrameWasHitch;
+	}
+
+	const deque<FrameStatistics::Hitch>& FrameStatistics::RecentHitches() const
+	{
+		return mRecentHitches;
+	}
+
+	const vector<uint32_t>& FrameStatistics::Histogram() const
+	{
+		return mHistogram;
+	}
+
+	uint32_t FrameStatistics::HistogramBucketLowerBound(uint32_t bucket)
+	{
+		return (bucket == 0 ? 0 : 1U << bucket);
+	}
+
+	void FrameStatistics::RecentFrameTimes(vector<float>& milliseconds) const
+	{
+		uint64_t frameCount = mFrameCount.load(memory_order_acquire);
+		uint64_t first = (frameCount > mWindowSize ? frameCount - mWindowSize : 0);
+
+		milliseconds.clear();
+		milliseconds.reserve(static_cast<size_t>(frameCount - first));
+		for (uint64_t frame = first; frame < frameCount; ++frame)
+		{
+			milliseconds.push_back(ToMilliseconds(mRing[static_cast<size_t>(frame % mWindowSize)].load(memory_order_relaxed)));
+		}
+	}
+
+	void FrameStatistics::WriteCsv(ostream& stream) const
+	{
+		stream << "section,key,value\n";
+		stream << "summary,frames," << mSummary.FrameCount << "\n";
+		stream << "summary,window_frames," << mSummary.SampleCount << "\n";
+		stream << "summary,mean_ms," << mSummary.MeanMilliseconds << "\n";
+		stream << "summary,p50_ms," << mSummary.P50Milliseconds << "\n";
+		stream << "summary,p95_ms," << mSummary.P95Milliseconds << "\n";
+		stream << "summary,p99_ms," << mSummary.P99Milliseconds << "\n";
+		stream << "summary,max_ms," << mSummary.MaxMilliseconds << "\n";
+		stream << "summary,hitches," << mSummary.HitchCount << "\n";
+
+		for (uint32_t bucket = 0; bucket < HistogramBucketCount; ++bucket)
+		{
+			stream << "histogram_us," << HistogramBucketLowerBound(bucket) << "," << mHistogram[bucket] << "\n";
+		}
+
+		for (const Hitch& hitch : mRecentHitches)
+		{
+			stream << "hitch_ms," << hitch.FrameIndex << "," << hitch.Milliseconds << "\n";
+		}
+	}
+
+	void FrameStatistics::WriteJson(ostream& stream) const
+	{
+		stream << "{\n";
+		stream << "  \"frames\": " << mSummary.FrameCount << ",\n";
+		stream << "  \"windowFrames\": " << mSummary.SampleCount << ",\n";
+		stream << "  \"meanMilliseconds\": " << mSummary.MeanMilliseconds << ",\n";
+		stream << "  \"p50Milliseconds\": " << mSummary.P50Milliseconds << ",\n";
+		stream << "  \"p95Milliseconds\": " << mSummary.P95Milliseconds << ",\n";
+		stream << "  \"p99Milliseconds\": " << mSummary.P99Milliseconds << ",\n";
+		stream << "  \"maxMilliseconds\": " << mSummary.MaxMilliseconds << ",\n";
+		stream << "  \"hitchThresholdMilliseconds\": " << ToMilliseconds(static_cast<uint64_t>(mHitchThreshold.count())) << ",\n";
+		stream << "  \"hitches\": " << mSummary.HitchCount << ",\n";
+
+		stream << "  \"histogram\": [";
+		for (uint32_t bucket = 0; bucket < HistogramBucketCount; ++bucket)
+		{
+			stream << (bucket == 0 ? "" : ",") << "\n    { \"lowerMicroseconds\": " << HistogramBucketLowerBound(bucket) << ", \"count\": " << mHistogram[bucket] << " }";
+		}
+		stream << "\n  ],\n";
+
+		stream << "  \"recentHitches\": [";
+		bool isFirst = true;
+		for (const Hitch& hitch : mRecentHitches)
+		{
+			stream << (isFirst ? "" : ",") << "\n    { \"frame\": " << hitch.FrameIndex << ", \"milliseconds\": " << hitch.Milliseconds << " }";
+			isFirst = false;
+		}
+		stream << (isFirst ? "" : "\n  ") << "]\n";
+		stream << "}\n";
+	}
+
+	uint32_t FrameStatistics::HistogramBucket(uint32_t nanoseconds)
+	{
+		uint32_t microseconds = nanoseconds / 1000;
+		uint32_t bucket = 0;
+		while (microseconds > 1 && bucket < HistogramBucketCount - 1)
+		{
+			microseconds >>= 1;
+			++bucket;
+		}
+
+		return bucket;
+	}
+
+	float FrameStatistics::ToMilliseconds(uint64_t nanoseconds)
+	{
+		return static_cast<float>(static_cast<double>(nanoseconds) / 1000000.0);
+	}
+
+	uint32_t FrameStatistics::Percentile(uint32_t percent) const
+	{
+		// Nearest rank
+		uint32_t sampleCount = static_cast<uint32_t>(mSortedWindow.size());
+		uint32_t rank = (percent * sampleCount + 99) / 100;
+
+		return mSortedWindow[rank > 0 ? rank - 1 : 0];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <iosfwd>
+#include <cstdint>
+
+namespace Library
+{
+	// Rolling frame-time statistics over the most recent WindowSize() frames. AddFrame() updates the summary and histogram
+	// incrementally (the window is kept sorted, so percentiles are exact). Only the recording thread may call AddFrame() and
+	// read the summary; the raw samples live in a lock-free ring that any thread can copy with RecentFrameTimes().
+	class FrameStatistics final
+	{
+	public:
+		struct Summary
+		{
+			std::uint64_t FrameCount;
+			std::uint32_t SampleCount;
+			float MeanMilliseconds;
+			float P50Milliseconds;
+			float P95Milliseconds;
+			float P99Milliseconds;
+			float MaxMilliseconds;
+			std::uint64_t HitchCount;
+
+			Summary();
+		};
+
+		struct Hitch
+		{
+			std::uint64_t FrameIndex;
+			float Milliseconds;
+
+			Hitch(std::uint64_t frameIndex, float milliseconds) :
+				FrameIndex(frameIndex), Milliseconds(milliseconds) { }
+		};
+
+		explicit FrameStatistics(std::uint32_t windowSize = DefaultWindowSize, std::chrono::nanoseconds hitchThreshold = DefaultHitchThreshold);
+		FrameStatistics(const FrameStatistics&) = delete;
+		FrameStatistics& operator=(const FrameStatistics&) = delete;
+		FrameStatistics(FrameStatistics&&) = delete;
+		FrameStatistics& operator=(FrameStatistics&&) = delete;
+		~FrameStatistics() = default;
+
+		// Durations are clamped to about four seconds.
+		void AddFrame(std::chrono::nanoseconds duration);
+		void Reset();
+
+		std::uint32_t WindowSize() const;
+		const Summary& CurrentSummary() const;
+
+		// Frames longer than the threshold are counted as hitches.
+		const std::chrono::nanoseconds& HitchThreshold() const;
+		void SetHitchThreshold(const std::chrono::nanoseconds& hitchThreshold);
+		bool LastFrameWasHitch() const;
+		const std::deque<Hitch>& RecentHitches() const;
+
+		// Bucket i counts window frames in [HistogramBucketLowerBound(i), HistogramBucketLowerBound(i + 1)) microseconds;
+		// bucket 0 starts at zero and the last bucket is unbounded.
+		const std::vector<std::uint32_t>& Histogram() const;
+		static std::uint32_t HistogramBucketLowerBound(std::uint32_t bucket);
+
+		// Oldest first. Safe to call from any thread; samples overwritten while copying show up as the newer value.
+		void RecentFrameTimes(std::vector<float>& milliseconds) const;
+
+		// Summary, histogram and recent hitches. The CSV form is one "section,key,value" row per entry.
+		void WriteCsv(std::ostream& stream) const;
+		void WriteJson(std::ostream& stream) const;
+
+		static const std::uint32_t DefaultWindowSize;
+		static const std::chrono::nanoseconds DefaultHitchThreshold;
+		static const std::uint32_t HistogramBucketCount;
+		static const std::uint32_t MaxRecentHitches;
+
+	private:
+		static std::uint32_t HistogramBucket(std::uint32_t nanoseconds);
+		static float ToMilliseconds(std::uint64_t nanoseconds);
+		std::uint32_t Percentile(std::uint32_t percent) const;
+
+		std::uint32_t mWindowSize;
+		std::unique_ptr<std::atomic<std::uint32_t>[]> mRing;
+		std::atomic<std::uint64_t> mFrameCount;
+
+		std::vector<std::uint32_t> mSortedWindow;
+		std::uint64_t mWindowSum;
+		std::vector<std::uint32_t> mHistogram;
+		std::chrono::nanoseconds mHitchThreshold;
+		bool mLastFrameWasHitch;
+		std::deque<Hitch> mRecentHitches;
+		Summary mSummary;
+	};
+}
\ No newline at end of file
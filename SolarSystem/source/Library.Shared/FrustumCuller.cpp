@@ -0,0 +1,237 @@
+#include "pch.h"
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LIBRARY_TARGET_AVX
+#else
+#define LIBRARY_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+using namespace std;
+
+namespace Library
+{
+	uint32_t BoundingSphereSet::Add(float x, float y, float z, float radius)
+	{
+		mX.push_back(x);
+		mY.push_back(y);
+		mZ.push_back(z);
+		mRadius.push_back(radius);
+
+		return static_cast<uint32_t>(mX.size() - 1);
+	}
+
+	void BoundingSphereSet::Set(uint32_t index, float x, float y, float z, float radius)
+	{
+		assert(index < mX.size());
+
+		mX[index] = x;
+		mY[index] = y;
+		mZ[index] = z;
+		mRadius[index] = radius;
+	}
+
+	void BoundingSphereSet::Resize(uint32_t size)
+	{
+		mX.resize(size);
+		mY.resize(size);
+		mZ.resize(size);
+		mRadius.resize(size);
+	}
+
+	void BoundingSphereSet::Clear()
+	{
+		mX.clear();
+		mY.clear();
+		mZ.clear();
+		mRadius.clear();
+	}
+
+	uint32_t BoundingSphereSet::Size() const
+	{
+		return static_cast<uint32_t>(mX.size());
+	}
+
+	const float* BoundingSphereSet::X() const
+	{
+		return mX.data();
+	}
+
+	const float* BoundingSphereSet::Y() const
+	{
+		return mY.data();
+	}
+
+	const float* BoundingSphereSet::Z() const
+	{
+		return mZ.data();
+	}
+
+	const float* BoundingSphereSet::Radius() const
+	{
+		return mRadius.data();
+	}
+
+	void FrustumCuller::Cull(const Frustum& frustum, const BoundingSphereSet& spheres, uint8_t* visibility)
+	{
+		static const InstructionSet instructionSet = BestInstructionSet();
+
+		Cull(frustum, spheres, visibility, instructionSet);
+	}
+
+	void FrustumCuller::Cull(const Frustum& frustum, const BoundingSphereSet& spheres, uint8_t* visibility, InstructionSet instructionSet)
+	{
+		assert(visibility != nullptr || spheres.Size() == 0);
+
+		switch (instructionSet)
+		{
+		case InstructionSet::AVX:
+			CullAVX(frustum, spheres, visibility);
+			break;
+
+		case InstructionSet::SSE:
+			CullSSE(frustum, spheres, visibility);
+			break;
+
+		default:
+			CullScalar(frustum, spheres, 0, visibility);
+			break;
+		}
+	}
+
+	FrustumCuller::InstructionSet FrustumCuller::BestInstructionSet()
+	{
+		// SSE2 is part of every x86 target this library builds for.
+		return (SupportsAVX() ? InstructionSet::AVX : InstructionSet::SSE);
+	}
+
+	void FrustumCuller::CullScalar(const Frustum& frustum, const BoundingSphereSet& spheres, uint32_t first, uint8_t* visibility)
+	{
+		const float* x = spheres.X();
+		const float* y = spheres.Y();
+		const float* z = spheres.Z();
+		const float* radius = spheres.Radius();
+
+		uint32_t size = spheres.Size();
+		for (uint32_t i = first; i < size; ++i)
+		{
+			bool inside = true;
+			for (uint32_t planeIndex = 0; planeIndex < Frustum::PlaneCount; ++planeIndex)
+			{
+				// Summed in the same order as the SIMD paths, so a sphere's visibility doesn't depend on which path tests it.
+				const float* plane = frustum.Planes[planeIndex];
+				float distance = (plane[0] * x[i] + plane[1] * y[i]) + (plane[2] * z[i] + plane[3]);
+				inside = inside && (distance + radius[i] >= 0.0f);
+			}
+
+			visibility[i] = static_cast<uint8_t>(inside ? 1 : 0);
+		}
+	}
+
+	void FrustumCuller::CullSSE(const Frustum& frustum, const BoundingSphereSet& spheres, uint8_t* visibility)
+	{
+		static const uint32_t Width = 4;
+
+		__m128 planes[Frustum::PlaneCount][4];
+		for (uint32_t planeIndex = 0; planeIndex < Frustum::PlaneCount; ++planeIndex)
+		{
+			for (uint32_t component = 0; component < 4; ++component)
+			{
+				planes[planeIndex][component] = _mm_set1_ps(frustum.Planes[planeIndex][component]);
+			}
+		}
+
+		const float* x = spheres.X();
+		const float* y = spheres.Y();
+		const float* z = spheres.Z();
+		const float* radius = spheres.Radius();
+		const __m128 zero = _mm_setzero_ps();
+
+		uint32_t vectorizedSize = spheres.Size() & ~(Width - 1);
+		for (uint32_t i = 0; i < vectorizedSize; i += Width)
+		{
+			__m128 centerX = _mm_loadu_ps(x + i);
+			__m128 centerY = _mm_loadu_ps(y + i);
+			__m128 centerZ = _mm_loadu_ps(z + i);
+			__m128 sphereRadius = _mm_loadu_ps(radius + i);
+
+			__m128 inside = _mm_cmpeq_ps(zero, zero);
+			for (uint32_t planeIndex = 0; planeIndex < Frustum::PlaneCount; ++planeIndex)
+			{
+				const __m128* plane = planes[planeIndex];
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[0], centerX), _mm_mul_ps(plane[1], centerY)), _mm_add_ps(_mm_mul_ps(plane[2], centerZ), plane[3]));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, sphereRadius), zero));
+			}
+
+			int mask = _mm_movemask_ps(inside);
+			for (uint32_t lane = 0; lane < Width; ++lane)
+			{
+				visibility[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+			}
+		}
+
+		CullScalar(frustum, spheres, vectorizedSize, visibility);
+	}
+
+	LIBRARY_TARGET_AVX void FrustumCuller::CullAVX(const Frustum& frustum, const BoundingSphereSet& spheres, uint8_t* visibility)
+	{
+		static const uint32_t Width = 8;
+
+		__m256 planes[Frustum::PlaneCount][4];
+		for (uint32_t planeIndex = 0; planeIndex < Frustum::PlaneCount; ++planeIndex)
+		{
+			for (uint32_t component = 0; component < 4; ++component)
+			{
+				planes[planeIndex][component] = _mm256_set1_ps(frustum.Planes[planeIndex][component]);
+			}
+		}
+
+		const float* x = spheres.X();
+		const float* y = spheres.Y();
+		const float* z = spheres.Z();
+		const float* radius = spheres.Radius();
+		const __m256 zero = _mm256_setzero_ps();
+
+		uint32_t vectorizedSize = spheres.Size() & ~(Width - 1);
+		for (uint32_t i = 0; i < vectorizedSize; i += Width)
+		{
+			__m256 centerX = _mm256_loadu_ps(x + i);
+			__m256 centerY = _mm256_loadu_ps(y + i);
+			__m256 centerZ = _mm256_loadu_ps(z + i);
+			__m256 sphereRadius = _mm256_loadu_ps(radius + i);
+
+			__m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+			for (uint32_t planeIndex = 0; planeIndex < Frustum::PlaneCount; ++planeIndex)
+			{
+				const __m256* plane = planes[planeIndex];
+				__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(plane[0], centerX), _mm256_mul_ps(plane[1], centerY)), _mm256_add_ps(_mm256_mul_ps(plane[2], centerZ), plane[3]));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, sphereRadius), zero, _CMP_GE_OQ));
+			}
+
+			int mask = _mm256_movemask_ps(inside);
+			for (uint32_t lane = 0; lane < Width; ++lane)
+			{
+				visibility[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+			}
+		}
+
+		CullScalar(frustum, spheres, vectorizedSize, visibility);
+	}
+
+	bool FrustumCuller::SupportsAVX()
+	{
+#if defined(_MSC_VER)
+		// AVX needs both the CPU feature and the operating system saving the YMM registers (OSXSAVE + XCR0 bits 1 and 2).
+		int cpuInfo[4];
+		__cpuid(cpuInfo, 1);
+
+		bool osxsave = ((cpuInfo[2] & (1 << 27)) != 0);
+		bool avx = ((cpuInfo[2] & (1 << 28)) != 0);
+
+		return (osxsave && avx && (_xgetbv(0) & 0x6) == 0x6);
+#else
+		return (__builtin_cpu_supports("avx") != 0);
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace Library
+{
+	// Six planes (a, b, c, d) with unit normals pointing into the frustum, so a point p is inside a plane when a*p.x + b*p.y + c*p.z + d >= 0.
+	struct Frustum
+	{
+		enum PlaneIndex
+		{
+			Left = 0,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+			PlaneCount
+		};
+
+		float Planes[PlaneCount][4];
+	};
+
+	// Bounding spheres in structure-of-arrays form so they can be tested several at a time.
+	class BoundingSphereSet final
+	{
+	public:
+		BoundingSphereSet() = default;
+		BoundingSphereSet(const BoundingSphereSet&) = default;
+		BoundingSphereSet& operator=(const BoundingSphereSet&) = default;
+		BoundingSphereSet(BoundingSphereSet&&) = default;
+		BoundingSphereSet& operator=(BoundingSphereSet&&) = default;
+		~BoundingSphereSet() = default;
+
+		std::uint32_t Add(float x, float y, float z, float radius);
+		void Set(std::uint32_t index, float x, float y, float z, float radius);
+		void Resize(std::uint32_t size);
+		void Clear();
+		std::uint32_t Size() const;
+
+		const float* X() const;
+		const float* Y() const;
+		const float* Z() const;
+		const float* Radius() const;
+
+	private:
+		std::vector<float> mX;
+		std::vector<float> mY;
+		std::vector<float> mZ;
+		std::vector<float> mRadius;
+	};
+
+	class FrustumCuller final
+	{
+	public:
+		enum class InstructionSet
+		{
+			Scalar,
+			SSE,
+			AVX
+		};
+
+		// Writes 1 to visibility[i] for every sphere that intersects the frustum and 0 otherwise. visibility must hold spheres.Size() entries.
+		// Uses the widest instruction set the processor supports.
+		static void Cull(const Frustum& frustum, const BoundingSphereSet& spheres, std::uint8_t* visibility);
+		static void Cull(const Frustum& frustum, const BoundingSphereSet& spheres, std::uint8_t* visibility, InstructionSet instructionSet);
+
+		static InstructionSet BestInstructionSet();
+
+		FrustumCuller() = delete;
+		FrustumCuller(const FrustumCuller&) = delete;
+		FrustumCuller& operator=(const FrustumCuller&) = delete;
+		FrustumCuller(FrustumCuller&&) = delete;
+		FrustumCuller& operator=(FrustumCuller&&) = delete;
+		~FrustumCuller() = default;
+
+	private:
+		static void CullScalar(const Frustum& frustum, const BoundingSphereSet& spheres, std::uint32_t first, std::uint8_t* visibility);
+		static void CullSSE(const Frustum& frustum, const BoundingSphereSet& spheres, std::uint8_t* visibility);
+		static void CullAVX(const Frustum& frustum, const BoundingSphereSet& spheres, std::uint8_t* visibility);
+		static bool SupportsAVX();
+	};
+}
\ No newline at end of file
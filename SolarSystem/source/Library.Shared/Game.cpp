@@ -13,11 +13,11 @@ namespace Library
 	const UINT Game::DefaultMultiSamplingCount = 4;
 	const UINT Game::DefaultBufferCount = 2;
 
-	Game::Game(std::function<void*()> getWindowCallback, std::function<void(SIZE&)> getRenderTargetSizeCallback) :
+	Game::Game(std::function<void*()> getWindowCallback, std::function<void(SIZE&)> getRenderTargetSizeCallback, RenderDeviceType deviceType) :
 		RenderTarget(),
 		mFeatureLevel(D3D_FEATURE_LEVEL_9_1), mFrameRate(DefaultFrameRate), mIsFullScreen(false),
 		mMultiSamplingCount(DefaultMultiSamplingCount), mMultiSamplingQualityLevels(0),
-		mGetWindow(getWindowCallback), mGetRenderTargetSize(getRenderTargetSizeCallback)
+		mGetWindow(getWindowCallback), mGetRenderTargetSize(getRenderTargetSizeCallback), mDeviceNotify(nullptr), mDeviceType(deviceType)
 	{
 		assert(getWindowCallback != nullptr);
 		assert(mGetRenderTargetSize != nullptr);
@@ -36,6 +36,11 @@ namespace Library
 		return mDirect3DDeviceContext.Get();
 	}
 
+	Direct3DStateCache& Game::StateCache()
+	{
+		return mStateCache;
+	}
+
 	IDXGISwapChain1* Game::SwapChain() const
 	{
 		return mSwapChain.Get();
@@ -91,23 +96,97 @@ namespace Library
 		return mComponents;
 	}
 
+	void Game::AddComponent(const shared_ptr<GameComponent>& component)
+	{
+		assert(component != nullptr);
+
+		mComponents.push_back(component);
+
+		DrawableGameComponent* drawableGameComponent = component->As<DrawableGameComponent>();
+		if (drawableGameComponent != nullptr)
+		{
+			mDrawableComponents.push_back(drawableGameComponent);
+		}
+	}
+
+	bool Game::RemoveComponent(const GameComponent& component)
+	{
+		auto found = find_if(mComponents.begin(), mComponents.end(), [&](const shared_ptr<GameComponent>& entry) { return entry.get() == &component; });
+		if (found == mComponents.end())
+		{
+			return false;
+		}
+
+		mDrawableComponents.erase(remove(mDrawableComponents.begin(), mDrawableComponents.end(), component.As<DrawableGameComponent>()), mDrawableComponents.end());
+		mComponents.erase(found);
+
+		return true;
+	}
+
 	const ServiceContainer& Game::Services() const
 	{
 		return mServices;
 	}
 
+	ThreadPool& Game::Workers()
+	{
+		return mWorkers;
+	}
+
+	GameClock& Game::Clock()
+	{
+		return mGameClock;
+	}
+
+	FrameArena& Game::FrameMemory()
+	{
+		return mFrameMemory;
+	}
+
+	ConstantBufferRing& Game::ConstantBuffers()
+	{
+		return *mConstantBuffers;
+	}
+
+	RenderQueue& Game::DrawQueue()
+	{
+		return *mRenderQueue;
+	}
+
+	RenderDevice& Game::Device()
+	{
+		return *mRenderDevice;
+	}
+
+	RenderDeviceType Game::DeviceType() const
+	{
+		return mDeviceType;
+	}
+
 	void Game::Initialize()
 	{
+		Profiler::SetThreadName("Main");
+		PROFILE_SCOPE("Game::Initialize");
+
 		mGameClock.Reset();
 
+		MemoryTagScope memoryTagScope(MemoryTag::Assets);
 		for (auto& component : mComponents)
 		{
+			PROFILE_SCOPE(component->TypeNameInstance());
 			component->Initialize();
 		}
+
+		// Components have looked up what they need; from here on services may be read from any thread
+		mServices.Freeze();
 	}
 
 	void Game::Run()
 	{
+		PROFILE_SCOPE("Game::Run");
+
+		AllocationCounter::BeginFrame();
+		mFrameMemory.BeginFrame();
 		mGameClock.UpdateGameTime(mGameTime);
 		Update(mGameTime);
 		Draw(mGameTime);
@@ -116,12 +195,22 @@ namespace Library
 	void Game::Shutdown()
 	{
 		// Free up all D3D resources.
-		mDirect3DDeviceContext->ClearState();
-		mDirect3DDeviceContext->Flush();
+		if (mDirect3DDeviceContext != nullptr)
+		{
+			mDirect3DDeviceContext->ClearState();
+			mDirect3DDeviceContext->Flush();
+		}
+
+		mStateCache.SetContext(nullptr);
 		
+		mDrawableComponents.clear();
+		mDrawableComponents.shrink_to_fit();
 		mComponents.clear();
 		mComponents.shrink_to_fit();
 
+		mRenderQueue = nullptr;
+		mConstantBuffers = nullptr;
+		mRenderDevice = nullptr;
 		mDepthStencilView = nullptr;
 		mRenderTargetView = nullptr;
 		mSwapChain = nullptr;
@@ -131,10 +220,14 @@ namespace Library
 
 	void Game::Update(const GameTime& gameTime)
 	{
+		PROFILE_SCOPE("Game::Update");
+		MemoryTagScope memoryTagScope(MemoryTag::Simulation);
+
 		for (auto& component : mComponents)
 		{
 			if (component->Enabled())
 			{
+				PROFILE_SCOPE(component->TypeNameInstance());
 				component->Update(gameTime);
 			}
 		}
@@ -142,14 +235,22 @@ namespace Library
 
 	void Game::Draw(const GameTime& gameTime)
 	{
-		for (auto& component : mComponents)
+		PROFILE_SCOPE("Game::Draw");
+		MemoryTagScope memoryTagScope(MemoryTag::Rendering);
+
+		mConstantBuffers->BeginFrame();
+		mStateCache.Invalidate();
+
+		for (DrawableGameComponent* drawableGameComponent : mDrawableComponents)
 		{
-			DrawableGameComponent* drawableGameComponent = component->As<DrawableGameComponent>();
-			if (drawableGameComponent != nullptr && drawableGameComponent->Visible())
+			if (drawableGameComponent->Visible())
 			{
+				PROFILE_SCOPE(drawableGameComponent->TypeNameInstance());
 				drawableGameComponent->Draw(gameTime);
 			}
 		}
+
+		mRenderQueue->Execute();
 	}
 
 	void Game::UpdateRenderTargetSize()
@@ -167,7 +268,7 @@ namespace Library
 		static ID3D11ShaderResourceView* emptySRV[5] = { nullptr, nullptr, nullptr, nullptr, nullptr };
 		assert(count < ARRAYSIZE(emptySRV));
 
-		mDirect3DDeviceContext->PSSetShaderResources(startSlot, count, emptySRV);
+		mStateCache.PSSetShaderResources(startSlot, count, emptySRV);
 	}
 
 	std::function<void*()> Game::GetWindowCallback() const
@@ -177,12 +278,18 @@ namespace Library
 
 	void Game::Begin()
 	{
-		RenderTarget::Begin(mDirect3DDeviceContext.Get(), 1, mRenderTargetView.GetAddressOf(), mDepthStencilView.Get(), mViewport);
+		if (mDirect3DDeviceContext != nullptr)
+		{
+			RenderTarget::Begin(mDirect3DDeviceContext.Get(), 1, mRenderTargetView.GetAddressOf(), mDepthStencilView.Get(), mViewport);
+		}
 	}
 
 	void Game::End()
 	{
-		RenderTarget::End(mDirect3DDeviceContext.Get());
+		if (mDirect3DDeviceContext != nullptr)
+		{
+			RenderTarget::End(mDirect3DDeviceContext.Get());
+		}
 	}
 
 	void Game::CreateDeviceIndependentResources()
@@ -191,6 +298,14 @@ namespace Library
 
 	void Game::CreateDeviceResources()
 	{
+		if (mDeviceType == RenderDeviceType::Null)
+		{
+			mRenderDevice = make_unique<NullRenderDevice>();
+			mConstantBuffers = make_unique<ConstantBufferRing>(*mRenderDevice);
+			mRenderQueue = make_unique<RenderQueue>(*mRenderDevice, *mConstantBuffers, mWorkers);
+			return;
+		}
+
 		// This flag adds support for surfaces with a different color channel ordering
 		// than the API default. It is required for compatibility with Direct2D.
 		UINT createDeviceFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
@@ -216,6 +331,7 @@ namespace Library
 		ThrowIfFailed(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, NULL, createDeviceFlags, featureLevels, ARRAYSIZE(featureLevels), D3D11_SDK_VERSION, direct3DDevice.ReleaseAndGetAddressOf(), &mFeatureLevel, direct3DDeviceContext.ReleaseAndGetAddressOf()), "D3D11CreateDevice() failed");
 		ThrowIfFailed(direct3DDevice.As(&mDirect3DDevice));
 		ThrowIfFailed(direct3DDeviceContext.As(&mDirect3DDeviceContext));
+		mStateCache.SetContext(mDirect3DDeviceContext.Get());
 
 		ThrowIfFailed(mDirect3DDevice->CheckMultisampleQualityLevels(DXGI_FORMAT_R8G8B8A8_UNORM, mMultiSamplingCount, &mMultiSamplingQualityLevels), "CheckMultisampleQualityLevels() failed.");
 		if (mMultiSamplingQualityLevels == 0)
@@ -247,6 +363,19 @@ namespace Library
 			}
 		}
 #endif
+
+		// After device loss the render device rebuilds its objects on the new device, so the handles components hold, and the
+		// constant buffer ring and render queue built on it, stay valid.
+		if (mRenderDevice != nullptr)
+		{
+			static_cast<Direct3D11RenderDevice&>(*mRenderDevice).Reset(mDirect3DDevice.Get());
+		}
+		else
+		{
+			mRenderDevice = make_unique<Direct3D11RenderDevice>(mDirect3DDevice.Get(), mStateCache);
+			mConstantBuffers = make_unique<ConstantBufferRing>(*mRenderDevice);
+			mRenderQueue = make_unique<RenderQueue>(*mRenderDevice, *mConstantBuffers, mWorkers);
+		}
 	}
 
 	void Game::CreateWindowSizeDependentResources()
@@ -256,6 +385,17 @@ namespace Library
 		mSwapChain = nullptr;
 #endif
 
+		if (mDeviceType == RenderDeviceType::Null)
+		{
+			mGetRenderTargetSize(mRenderTargetSize);
+			ZeroMemory(&mBackBufferDesc, sizeof(mBackBufferDesc));
+			mBackBufferDesc.Width = mRenderTargetSize.cx;
+			mBackBufferDesc.Height = mRenderTargetSize.cy;
+			mBackBufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+			mViewport = CD3D11_VIEWPORT(0.0f, 0.0f, static_cast<float>(mRenderTargetSize.cx), static_cast<float>(mRenderTargetSize.cy));
+			return;
+		}
+
 		ID3D11RenderTargetView* nullViews[] = { nullptr };
 		mDirect3DDeviceContext->OMSetRenderTargets(ARRAYSIZE(nullViews), nullViews, nullptr);
 		mRenderTargetView = nullptr;
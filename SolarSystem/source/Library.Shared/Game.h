@@ -17,10 +17,17 @@
 #include "GameTime.h"
 #include "ServiceContainer.h"
 #include "RenderTarget.h"
+#include "ThreadPool.h"
+#include "FrameArena.h"
+#include "Direct3DStateCache.h"
+#include "ConstantBufferRing.h"
+#include "RenderQueue.h"
+#include "RenderDevice.h"
 
 namespace Library
 {
 	class GameComponent;
+	class DrawableGameComponent;
 
 	class IDeviceNotify
 	{
@@ -34,20 +41,31 @@ namespace Library
 		IDeviceNotify() { };
 	};
 
+	// The null device creates no Direct3D device or swap chain; the window is still used for input.
+	enum class RenderDeviceType
+	{
+		Direct3D11,
+		Null
+	};
+
     class Game : public RenderTarget
     {
 		RTTI_DECLARATIONS(Game, RenderTarget)
 
     public:
-        Game(std::function<void*()> getWindowCallback, std::function<void(SIZE&)> getRenderTargetSizeCallback);
+        Game(std::function<void*()> getWindowCallback, std::function<void(SIZE&)> getRenderTargetSizeCallback, RenderDeviceType deviceType = RenderDeviceType::Direct3D11);
 		Game(const Game&) = delete;
 		Game& operator=(const Game&) = delete;
 		Game(Game&&) = delete;
 		Game& operator=(Game&&) = delete;
 		virtual ~Game() = default;
 
+		// Null, along with the swap chain and its views, when the game runs on the null device.
 		ID3D11Device2* Direct3DDevice() const;
 		ID3D11DeviceContext2* Direct3DDeviceContext() const;
+
+		// Pipeline state set through the cache skips redundant calls on the immediate context. It is invalidated at the start of each Draw().
+		Direct3DStateCache& StateCache();
 		IDXGISwapChain1* SwapChain() const;
 		ID3D11RenderTargetView* RenderTargetView() const;
 		ID3D11DepthStencilView* DepthStencilView() const;
@@ -60,7 +78,26 @@ namespace Library
 		UINT MultiSamplingQualityLevels() const;
 
 		const std::vector<std::shared_ptr<GameComponent>>& Components() const;
+
+		// Components update and draw in the order they were added. Drawable components are also kept in a list of their own,
+		// so Draw() never asks a component for its type. Don't add or remove components from inside Update() or Draw().
+		void AddComponent(const std::shared_ptr<GameComponent>& component);
+		bool RemoveComponent(const GameComponent& component);
 		const ServiceContainer& Services() const;			
+		ThreadPool& Workers();
+
+		// Its timelines may be read, scaled and paused from any thread.
+		GameClock& Clock();
+
+		// Scratch memory that lives until the end of the next frame; see FrameArena.
+		FrameArena& FrameMemory();
+		ConstantBufferRing& ConstantBuffers();
+		RenderQueue& DrawQueue();
+
+		// Components that create their resources and draw through the device also run on the null device. The device outlives
+		// device loss, so its handles stay valid.
+		RenderDevice& Device();
+		RenderDeviceType DeviceType() const;
 
         virtual void Initialize();
 		virtual void Run();
@@ -89,6 +126,7 @@ namespace Library
 
 		Microsoft::WRL::ComPtr<ID3D11Device2> mDirect3DDevice;
 		Microsoft::WRL::ComPtr<ID3D11DeviceContext2> mDirect3DDeviceContext;
+		Direct3DStateCache mStateCache;
 		Microsoft::WRL::ComPtr<IDXGISwapChain1> mSwapChain;
 		D3D_FEATURE_LEVEL mFeatureLevel;
 
@@ -109,7 +147,16 @@ namespace Library
 
         GameClock mGameClock;
         GameTime mGameTime;
-		std::vector<std::shared_ptr<GameComponent>> mComponents;
 		ServiceContainer mServices;
+		ThreadPool mWorkers;
+		FrameArena mFrameMemory;
+		RenderDeviceType mDeviceType;
+		std::unique_ptr<RenderDevice> mRenderDevice;
+		std::unique_ptr<ConstantBufferRing> mConstantBuffers;
+		std::unique_ptr<RenderQueue> mRenderQueue;
+
+	private:
+		std::vector<std::shared_ptr<GameComponent>> mComponents;
+		std::vector<DrawableGameComponent*> mDrawableComponents;
     };
 }
\ No newline at end of file
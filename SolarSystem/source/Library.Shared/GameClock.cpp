@@ -4,40 +4,103 @@ using namespace std::chrono;
 
 namespace Library
 {
-	GameClock::GameClock()
+	GameClock::GameClock() :
+		mFixedTimeStep(0)
 	{
 		Reset();
 	}
 
-	const high_resolution_clock::time_point& GameClock::StartTime() const
+	const steady_clock::time_point& GameClock::StartTime() const
 	{
 		return mStartTime;
 	}
 
-	const high_resolution_clock::time_point& GameClock::CurrentTime() const
+	const steady_clock::time_point& GameClock::CurrentTime() const
 	{
 		return mCurrentTime;
 	}
 
-	const high_resolution_clock::time_point& GameClock::LastTime() const
+	const steady_clock::time_point& GameClock::LastTime() const
 	{
 		return mLastTime;
 	}
 
+	const nanoseconds& GameClock::FixedTimeStep() const
+	{
+		return mFixedTimeStep;
+	}
+
+	void GameClock::SetFixedTimeStep(const nanoseconds& fixedTimeStep)
+	{
+		assert(fixedTimeStep.count() >= 0);
+		mFixedTimeStep = fixedTimeStep;
+	}
+
+	const Timeline& GameClock::RealTimeline() const
+	{
+		return mRealTimeline;
+	}
+
+	Timeline& GameClock::GameTimeline()
+	{
+		return mGameTimeline;
+	}
+
+	const Timeline& GameClock::GameTimeline() const
+	{
+		return mGameTimeline;
+	}
+
+	Timeline& GameClock::SimulationTimeline()
+	{
+		return mSimulationTimeline;
+	}
+
+	const Timeline& GameClock::SimulationTimeline() const
+	{
+		return mSimulationTimeline;
+	}
+
 	void GameClock::Reset()
 	{
-		mStartTime = high_resolution_clock::now();
+		mStartTime = steady_clock::now();
 		mCurrentTime = mStartTime;
 		mLastTime = mCurrentTime;
+		mRealTimeline.Reset();
+		mGameTimeline.Reset();
+		mSimulationTimeline.Reset();
 	}
 
 	void GameClock::UpdateGameTime(GameTime& gameTime)
 	{
-		mCurrentTime = high_resolution_clock::now();
+		UpdateGameTime(gameTime, steady_clock::now());
+	}
+
+	void GameClock::UpdateGameTime(GameTime& gameTime, const steady_clock::time_point& currentTime)
+	{
+		assert(currentTime >= mLastTime);
 
+		mCurrentTime = currentTime;
 		gameTime.SetCurrentTime(mCurrentTime);
-		gameTime.SetTotalGameTime(duration_cast<milliseconds>(mCurrentTime - mStartTime));
-		gameTime.SetElapsedGameTime(duration_cast<milliseconds>(mCurrentTime - mLastTime));
+
+		// Each timeline sums whole nanoseconds, so the totals are exact: real time is always the time since Reset().
+		const nanoseconds realElapsed = duration_cast<nanoseconds>(mCurrentTime - mLastTime);
+		mRealTimeline.Advance(realElapsed);
+		const nanoseconds gameElapsed = mGameTimeline.Advance(mFixedTimeStep.count() > 0 ? mFixedTimeStep : realElapsed);
+		mSimulationTimeline.Advance(gameElapsed);
+
+		const Timeline::Reading realReading = mRealTimeline.Read();
+		gameTime.SetTotalRealTime(realReading.Total);
+		gameTime.SetElapsedRealTime(realReading.Elapsed);
+
+		const Timeline::Reading gameReading = mGameTimeline.Read();
+		gameTime.SetTotalGameTime(gameReading.Total);
+		gameTime.SetElapsedGameTime(gameReading.Elapsed);
+
+		const Timeline::Reading simulationReading = mSimulationTimeline.Read();
+		gameTime.SetSimulationSeconds(simulationReading.Seconds);
+		gameTime.SetElapsedSimulationTime(simulationReading.Elapsed);
+
 		mLastTime = mCurrentTime;
 	}
 }
\ No newline at end of file
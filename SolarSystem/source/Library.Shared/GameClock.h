@@ -2,11 +2,15 @@
 
 #include <exception>
 #include <chrono>
+#include "Timeline.h"
 
 namespace Library
 {
 	class GameTime;
 
+	// Reads the steady clock once per frame and advances three timelines from it: real time, which is never scaled or paused;
+	// game time, which drives GameTime and can be paused and scaled; and simulation time, which follows game time at its own
+	// scale and counts seconds from an epoch. Other threads may read the timelines at any time.
 	class GameClock final
 	{
 	public:
@@ -17,16 +21,34 @@ namespace Library
 		GameClock& operator=(GameClock&&) = delete;
 		~GameClock() = default;
 
-		const std::chrono::high_resolution_clock::time_point& StartTime() const;
-		const std::chrono::high_resolution_clock::time_point& CurrentTime() const;
-		const std::chrono::high_resolution_clock::time_point& LastTime() const;
+		const std::chrono::steady_clock::time_point& StartTime() const;
+		const std::chrono::steady_clock::time_point& CurrentTime() const;
+		const std::chrono::steady_clock::time_point& LastTime() const;
+
+		// With a fixed time step every update advances the game time by exactly that much, however long the frame took, so runs
+		// are repeatable. The current time stays on the real clock. Zero (the default) follows the real clock.
+		const std::chrono::nanoseconds& FixedTimeStep() const;
+		void SetFixedTimeStep(const std::chrono::nanoseconds& fixedTimeStep);
+
+		const Timeline& RealTimeline() const;
+		Timeline& GameTimeline();
+		const Timeline& GameTimeline() const;
+		Timeline& SimulationTimeline();
+		const Timeline& SimulationTimeline() const;
 
 		void Reset();
 		void UpdateGameTime(GameTime& gameTime);
 
+		// Advances to the given time instead of reading the clock, e.g. to replay recorded frame times.
+		void UpdateGameTime(GameTime& gameTime, const std::chrono::steady_clock::time_point& currentTime);
+
 	private:
-		std::chrono::high_resolution_clock::time_point mStartTime;
-		std::chrono::high_resolution_clock::time_point mCurrentTime;
-		std::chrono::high_resolution_clock::time_point mLastTime;
+		std::chrono::steady_clock::time_point mStartTime;
+		std::chrono::steady_clock::time_point mCurrentTime;
+		std::chrono::steady_clock::time_point mLastTime;
+		std::chrono::nanoseconds mFixedTimeStep;
+		Timeline mRealTimeline;
+		Timeline mGameTimeline;
+		Timeline mSimulationTimeline;
 	};
 }
\ No newline at end of file
@@ -2,12 +2,12 @@
 
 namespace Library
 {
-	GameException::GameException(const char* const& message, HRESULT hr) :
-		exception(message), mHR(hr)
+	GameException::GameException(const char* const& message, long hr) :
+		runtime_error(message), mHR(hr)
 	{
 	}
 
-	HRESULT GameException::HR() const
+	long GameException::HR() const
 	{
 		return mHR;
 	}
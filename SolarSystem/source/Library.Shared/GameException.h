@@ -1,26 +1,28 @@
 #pragma once
 
-#include <windows.h>
-#include <exception>
+#include <stdexcept>
 #include <string>
 
 namespace Library
 {
-	class GameException : public std::exception
+	// The error code is an HRESULT from a failed Direct3D or Windows call, or 0 (S_OK). HRESULT is a long, so the exception
+	// is declared without Windows headers and the portable parts of the library can throw it too.
+	class GameException : public std::runtime_error
 	{
 	public:
-		GameException(const char* const& message, HRESULT hr = S_OK);
+		GameException(const char* const& message, long hr = 0);
 
-		HRESULT HR() const;
+		long HR() const;
 		std::wstring whatw() const;
 
 	private:
-		HRESULT mHR;
+		long mHR;
 	};
 
-	inline void ThrowIfFailed(HRESULT hr, const char* const& message = "")
+	inline void ThrowIfFailed(long hr, const char* const& message = "")
 	{
-		if (FAILED(hr))
+		// FAILED(hr)
+		if (hr < 0)
 		{
 			throw GameException(message, hr);
 		}
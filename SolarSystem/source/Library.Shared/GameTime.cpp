@@ -5,40 +5,80 @@ using namespace std::chrono;
 namespace Library
 {
 	GameTime::GameTime() :
-		mTotalGameTime(0), mElapsedGameTime(0)
+		mTotalGameTime(0), mElapsedGameTime(0), mTotalRealTime(0), mElapsedRealTime(0), mSimulationSeconds(0.0), mElapsedSimulationTime(0)
 	{
 	}
 
-	const high_resolution_clock::time_point& GameTime::CurrentTime() const
+	const steady_clock::time_point& GameTime::CurrentTime() const
 	{
 		return mCurrentTime;
 	}
 
-	void GameTime::SetCurrentTime(const high_resolution_clock::time_point& currentTime)
+	void GameTime::SetCurrentTime(const steady_clock::time_point& currentTime)
 	{
 		mCurrentTime = currentTime;
 	}
 
-	const milliseconds& GameTime::TotalGameTime() const
+	const nanoseconds& GameTime::TotalGameTime() const
 	{
 		return mTotalGameTime;
 	}
 
-	void GameTime::SetTotalGameTime(const std::chrono::milliseconds& totalGameTime)
+	void GameTime::SetTotalGameTime(const std::chrono::nanoseconds& totalGameTime)
 	{
 		mTotalGameTime = totalGameTime;
 	}
 
-	const milliseconds& GameTime::ElapsedGameTime() const
+	const nanoseconds& GameTime::ElapsedGameTime() const
 	{
 		return mElapsedGameTime;
 	}
 
-	void GameTime::SetElapsedGameTime(const std::chrono::milliseconds& elapsedGameTime)
+	void GameTime::SetElapsedGameTime(const std::chrono::nanoseconds& elapsedGameTime)
 	{
 		mElapsedGameTime = elapsedGameTime;
 	}
 
+	const nanoseconds& GameTime::TotalRealTime() const
+	{
+		return mTotalRealTime;
+	}
+
+	void GameTime::SetTotalRealTime(const std::chrono::nanoseconds& totalRealTime)
+	{
+		mTotalRealTime = totalRealTime;
+	}
+
+	const nanoseconds& GameTime::ElapsedRealTime() const
+	{
+		return mElapsedRealTime;
+	}
+
+	void GameTime::SetElapsedRealTime(const std::chrono::nanoseconds& elapsedRealTime)
+	{
+		mElapsedRealTime = elapsedRealTime;
+	}
+
+	double GameTime::SimulationSeconds() const
+	{
+		return mSimulationSeconds;
+	}
+
+	void GameTime::SetSimulationSeconds(double simulationSeconds)
+	{
+		mSimulationSeconds = simulationSeconds;
+	}
+
+	const nanoseconds& GameTime::ElapsedSimulationTime() const
+	{
+		return mElapsedSimulationTime;
+	}
+
+	void GameTime::SetElapsedSimulationTime(const std::chrono::nanoseconds& elapsedSimulationTime)
+	{
+		mElapsedSimulationTime = elapsedSimulationTime;
+	}
+
 	duration<float> GameTime::TotalGameTimeSeconds() const
 	{
 		return duration_cast<duration<float>>(mTotalGameTime);
@@ -48,4 +88,9 @@ namespace Library
 	{
 		return duration_cast<duration<float>>(mElapsedGameTime);
 	}
+
+	duration<float> GameTime::ElapsedRealTimeSeconds() const
+	{
+		return duration_cast<duration<float>>(mElapsedRealTime);
+	}
 }
\ No newline at end of file
@@ -4,26 +4,45 @@
 
 namespace Library
 {
+	// One frame's times from GameClock, in nanoseconds. The float seconds are for per-frame deltas; long totals are better
+	// taken from the nanoseconds, or from the simulation's double seconds.
 	class GameTime final
 	{
 	public:
 		GameTime();
 
-		const std::chrono::high_resolution_clock::time_point& CurrentTime() const;
-		void SetCurrentTime(const std::chrono::high_resolution_clock::time_point& currentTime);
+		const std::chrono::steady_clock::time_point& CurrentTime() const;
+		void SetCurrentTime(const std::chrono::steady_clock::time_point& currentTime);
 
-		const std::chrono::milliseconds& TotalGameTime() const;
-		void SetTotalGameTime(const std::chrono::milliseconds& totalGameTime);
+		const std::chrono::nanoseconds& TotalGameTime() const;
+		void SetTotalGameTime(const std::chrono::nanoseconds& totalGameTime);
 
-		const std::chrono::milliseconds& ElapsedGameTime() const;
-		void SetElapsedGameTime(const std::chrono::milliseconds& elapsedGameTime);
+		const std::chrono::nanoseconds& ElapsedGameTime() const;
+		void SetElapsedGameTime(const std::chrono::nanoseconds& elapsedGameTime);
+
+		const std::chrono::nanoseconds& TotalRealTime() const;
+		void SetTotalRealTime(const std::chrono::nanoseconds& totalRealTime);
+
+		const std::chrono::nanoseconds& ElapsedRealTime() const;
+		void SetElapsedRealTime(const std::chrono::nanoseconds& elapsedRealTime);
+
+		double SimulationSeconds() const;
+		void SetSimulationSeconds(double simulationSeconds);
+
+		const std::chrono::nanoseconds& ElapsedSimulationTime() const;
+		void SetElapsedSimulationTime(const std::chrono::nanoseconds& elapsedSimulationTime);
 
 		std::chrono::duration<float> TotalGameTimeSeconds() const;
 		std::chrono::duration<float> ElapsedGameTimeSeconds() const;
+		std::chrono::duration<float> ElapsedRealTimeSeconds() const;
 
 	private:
-		std::chrono::high_resolution_clock::time_point mCurrentTime;
-		std::chrono::milliseconds mTotalGameTime;
-		std::chrono::milliseconds mElapsedGameTime;
+		std::chrono::steady_clock::time_point mCurrentTime;
+		std::chrono::nanoseconds mTotalGameTime;
+		std::chrono::nanoseconds mElapsedGameTime;
+		std::chrono::nanoseconds mTotalRealTime;
+		std::chrono::nanoseconds mElapsedRealTime;
+		double mSimulationSeconds;
+		std::chrono::nanoseconds mElapsedSimulationTime;
 	};
 }
@@ -11,15 +11,15 @@ namespace Library
 	const XMFLOAT4 Grid::DefaultColor = XMFLOAT4(0.961f, 0.871f, 0.702f, 1.0f);
 
 	Grid::Grid(Game& game, const std::shared_ptr<Camera>& camera)
-		: DrawableGameComponent(game, camera), mVertexShader(nullptr), mPixelShader(nullptr), mInputLayout(nullptr), mVertexBuffer(nullptr),
-		  mVertexCBufferPerObject(nullptr), mVertexCBufferPerObjectData(),
+		: DrawableGameComponent(game, camera), mVertexShader(), mPixelShader(), mPipelineState(), mVertexBuffer(), mConstantBuffer(),
+		  mVertexCBufferPerObjectData(),
 		  mPosition(Vector3Helper::Zero), mSize(DefaultSize), mScale(DefaultScale), mColor(DefaultColor), mWorldMatrix(MatrixHelper::Identity)
 	{
 	}
 
 	Grid::Grid(Game& game, const std::shared_ptr<Camera>& camera, UINT size, UINT scale, const XMFLOAT4& color)
-		: DrawableGameComponent(game, camera), mVertexShader(nullptr), mPixelShader(nullptr), mInputLayout(nullptr), mVertexBuffer(nullptr),
-		  mVertexCBufferPerObject(nullptr), mVertexCBufferPerObjectData(),
+		: DrawableGameComponent(game, camera), mVertexShader(), mPixelShader(), mPipelineState(), mVertexBuffer(), mConstantBuffer(),
+		  mVertexCBufferPerObjectData(),
 		  mPosition(Vector3Helper::Zero), mSize(size), mScale(scale), mColor(color), mWorldMatrix(MatrixHelper::Identity)
 	{
 	}
@@ -82,30 +82,26 @@ namespace Library
 
 	void Grid::Initialize()
 	{
+		RenderDevice& device = mGame->Device();
+
 		// Load a compiled vertex shader
 		std::vector<char> compiledVertexShader;
 		Utility::LoadBinaryFile(L"Content\\Shaders\\BasicVS.cso", compiledVertexShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateVertexShader(&compiledVertexShader[0], compiledVertexShader.size(), nullptr, mVertexShader.GetAddressOf()), "ID3D11Device::CreatedVertexShader() failed.");
+		mVertexShader = device.CreateShader(ShaderStage::Vertex, compiledVertexShader);
 
 		// Load a compiled pixel shader
 		std::vector<char> compiledPixelShader;
 		Utility::LoadBinaryFile(L"Content\\Shaders\\BasicPS.cso", compiledPixelShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreatePixelShader(&compiledPixelShader[0], compiledPixelShader.size(), nullptr, mPixelShader.GetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
+		mPixelShader = device.CreateShader(ShaderStage::Pixel, compiledPixelShader);
 
-		// Create an input layout
-		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
+		PipelineStateDescription pipelineStateDescription(mVertexShader, mPixelShader,
 		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-			{ "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-		};
-
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateInputLayout(inputElementDescriptions, ARRAYSIZE(inputElementDescriptions), &compiledVertexShader[0], compiledVertexShader.size(), mInputLayout.GetAddressOf()), "ID3D11Device::CreateInputLayout() failed.");
+			InputElement("POSITION", VertexFormat::Float4),
+			InputElement("COLOR", VertexFormat::Float4)
+		}, PrimitiveTopology::LineList);
+		mPipelineState = device.CreatePipelineState(pipelineStateDescription);
 
-		// Create constant buffers
-		D3D11_BUFFER_DESC constantBufferDesc = { 0 };
-		constantBufferDesc.ByteWidth = sizeof(VertexCBufferPerObject);
-		constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mVertexCBufferPerObject.GetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+		mConstantBuffer = device.CreateBuffer(BufferDescription(BufferType::Constant, ResourceUsage::Default, sizeof(VertexCBufferPerObject)), nullptr);
 
 		InitializeGrid();
 	}
@@ -114,32 +110,26 @@ namespace Library
 	{
 		UNREFERENCED_PARAMETER(gameTime);
 
-		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
-		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
-		direct3DDeviceContext->IASetInputLayout(mInputLayout.Get());
-
-		UINT stride = sizeof(VertexPositionColor);
-		UINT offset = 0;
-		direct3DDeviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
-
-		direct3DDeviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
-		direct3DDeviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
-		
 		XMMATRIX worldMatrix = XMLoadFloat4x4(&mWorldMatrix);
 		XMMATRIX wvp = worldMatrix * mCamera->ViewProjectionMatrix();
 		XMStoreFloat4x4(&mVertexCBufferPerObjectData.WorldViewProjection, XMMatrixTranspose(wvp));
 
-		direct3DDeviceContext->UpdateSubresource(mVertexCBufferPerObject.Get(), 0, nullptr, &mVertexCBufferPerObjectData, 0, 0);
-		direct3DDeviceContext->VSSetConstantBuffers(0, 1, mVertexCBufferPerObject.GetAddressOf());
-		
-		direct3DDeviceContext->Draw((mSize + 1) * 4, 0);
+		mGame->DrawQueue().SubmitCallback(RenderLayer::Opaque, [this]()
+		{
+			CommandEncoder& encoder = mGame->Device().ImmediateEncoder();
+			encoder.UpdateBuffer(mConstantBuffer, &mVertexCBufferPerObjectData, sizeof(mVertexCBufferPerObjectData));
+			encoder.SetPipelineState(mPipelineState);
+			encoder.SetVertexBuffer(0, mVertexBuffer, sizeof(VertexPositionColor), 0);
+			encoder.SetConstantBuffer(ShaderStage::Vertex, 0, mConstantBuffer);
+			encoder.Draw((mSize + 1) * 4, 0);
+		});
 	}
 
 	void Grid::InitializeGrid()
 	{
-		mVertexBuffer.Reset();
+		RenderDevice& device = mGame->Device();
+		device.Destroy(mVertexBuffer);
 
-		ID3D11Device* direct3DDevice = GetGame()->Direct3DDevice();
 		int length = 4 * (mSize + 1);
 		int size = sizeof(VertexPositionColor) * length;
 		std::unique_ptr<VertexPositionColor> vertexData(new VertexPositionColor[length]);		
@@ -161,14 +151,6 @@ namespace Library
             vertices[j + 3] = VertexPositionColor(XMFLOAT4(-maxPosition, 0.0f, position, 1.0f), mColor);
         }
 
-		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
-		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		vertexBufferDesc.ByteWidth = size;
-		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-		D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
-		vertexSubResourceData.pSysMem = vertices;		
-		
-		ThrowIfFailed(direct3DDevice->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, mVertexBuffer.GetAddressOf()), "ID3D11Device::CreateBuffer() failed");
+		mVertexBuffer = device.CreateBuffer(BufferDescription(BufferType::Vertex, ResourceUsage::Immutable, size), vertices);
 	}
 }
\ No newline at end of file
@@ -1,9 +1,8 @@
 #pragma once
 
 #include "DrawableGameComponent.h"
-#include <wrl.h>
-#include <d3d11_2.h>
 #include <DirectXMath.h>
+#include "RenderDevice.h"
 
 namespace Library
 {
@@ -48,11 +47,11 @@ namespace Library
 		static const UINT DefaultScale;
 		static const DirectX::XMFLOAT4 DefaultColor;
 
-		Microsoft::WRL::ComPtr<ID3D11VertexShader> mVertexShader;
-		Microsoft::WRL::ComPtr<ID3D11PixelShader> mPixelShader;
-		Microsoft::WRL::ComPtr<ID3D11InputLayout> mInputLayout;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mVertexBuffer;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mVertexCBufferPerObject;
+		ShaderHandle mVertexShader;
+		ShaderHandle mPixelShader;
+		PipelineStateHandle mPipelineState;
+		BufferHandle mVertexBuffer;
+		BufferHandle mConstantBuffer;
 		VertexCBufferPerObject mVertexCBufferPerObjectData;
 	
 		DirectX::XMFLOAT3 mPosition;
@@ -0,0 +1,212 @@
+#include "pch.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(HudComponent)
+
+	const wstring HudComponent::DefaultFontFilename = L"Content\\Fonts\\Arial_14_Regular.spritefont";
+	const uint32_t HudComponent::SpriteBatchSize = 2048;
+
+	HudComponent::HudComponent(Game& game, const wstring& fontFilename) :
+		DrawableGameComponent(game), mFontFilename(fontFilename), mLineSpacing(0.0f), mGlyphCount(0), mLayoutCount(0)
+	{
+	}
+
+	uint32_t HudComponent::CreateLabel(const XMFLOAT2& position, FXMVECTOR color)
+	{
+		XMFLOAT4 labelColor;
+		XMStoreFloat4(&labelColor, color);
+		mLabels.emplace_back(position, labelColor);
+
+		return static_cast<uint32_t>(mLabels.size() - 1);
+	}
+
+	void HudComponent::SetText(uint32_t label, const wchar_t* text)
+	{
+		Label& target = mLabels.at(label);
+		if (target.Text.compare(text) != 0)
+		{
+			// assign() keeps the string's capacity, so text that fits allocates nothing
+			target.Text.assign(text);
+			target.IsLayoutDirty = true;
+		}
+	}
+
+	void HudComponent::SetText(uint32_t label, const wstring& text)
+	{
+		Label& target = mLabels.at(label);
+		if (target.Text != text)
+		{
+			target.Text.assign(text);
+			target.IsLayoutDirty = true;
+		}
+	}
+
+	const wstring& HudComponent::Text(uint32_t label) const
+	{
+		return mLabels.at(label).Text;
+	}
+
+	void HudComponent::SetPosition(uint32_t label, const XMFLOAT2& position)
+	{
+		mLabels.at(label).Position = position;
+	}
+
+	void HudComponent::SetColor(uint32_t label, FXMVECTOR color)
+	{
+		XMStoreFloat4(&mLabels.at(label).Color, color);
+	}
+
+	void HudComponent::SetLabelVisible(uint32_t label, bool visible)
+	{
+		mLabels.at(label).Visible = visible;
+	}
+
+	float HudComponent::LineSpacing() const
+	{
+		assert(mFont.IsValid());
+
+		return mLineSpacing;
+	}
+
+	uint32_t HudComponent::LabelCount() const
+	{
+		return static_cast<uint32_t>(mLabels.size());
+	}
+
+	uint32_t HudComponent::GlyphCount() const
+	{
+		return mGlyphCount;
+	}
+
+	uint32_t HudComponent::LayoutCount() const
+	{
+		return mLayoutCount;
+	}
+
+	uint32_t HudComponent::DrawCallCount() const
+	{
+		return (mGlyphCount + SpriteBatchSize - 1) / SpriteBatchSize;
+	}
+
+	void HudComponent::Initialize()
+	{
+		RenderDevice& device = mGame->Device();
+		mFont = device.CreateFontFromFile(mFontFilename);
+		mLineSpacing = device.LineSpacing(mFont);
+
+		// Text set before the font was loaded still needs laying out
+		for (Label& label : mLabels)
+		{
+			label.IsLayoutDirty = true;
+		}
+	}
+
+	void HudComponent::Draw(const GameTime& gameTime)
+	{
+		UNREFERENCED_PARAMETER(gameTime);
+		MemoryTagScope memoryTagScope(MemoryTag::UI);
+
+		mGlyphCount = 0;
+		mLayoutCount = 0;
+		for (Label& label : mLabels)
+		{
+			if (label.IsLayoutDirty)
+			{
+				LayoutLabel(label);
+				label.IsLayoutDirty = false;
+				++mLayoutCount;
+			}
+
+			if (label.Visible)
+			{
+				mGlyphCount += static_cast<uint32_t>(label.Glyphs.size());
+			}
+		}
+
+		if (mGlyphCount > 0)
+		{
+			// The queue rebinds its state after every callback, so the glyph pass needs no save and restore.
+			mGame->DrawQueue().SubmitCallback(RenderLayer::Overlay, [this]()
+			{
+				DrawLabels();
+			});
+		}
+	}
+
+	void HudComponent::LayoutLabel(Label& label) const
+	{
+		// Mirrors SpriteFont::DrawString() for an unrotated, unscaled string, so the cached glyphs land where DrawString() would put them.
+		label.Glyphs.clear();
+
+		RenderDevice& device = mGame->Device();
+		float x = 0.0f;
+		float y = 0.0f;
+		for (wchar_t character : label.Text)
+		{
+			switch (character)
+			{
+			case L'\r':
+				break;
+
+			case L'\n':
+				x = 0.0f;
+				y += mLineSpacing;
+				break;
+
+			default:
+			{
+				FontGlyph glyph = device.Glyph(mFont, character);
+
+				x = max(x + glyph.XOffset, 0.0f);
+
+				int32_t width = glyph.Subrect.Right - glyph.Subrect.Left;
+				int32_t height = glyph.Subrect.Bottom - glyph.Subrect.Top;
+				if (iswspace(character) == 0 || width > 1 || height > 1)
+				{
+					GlyphQuad quad;
+					quad.Subrect = glyph.Subrect;
+					quad.Offset = XMFLOAT2(x, y + glyph.YOffset);
+					label.Glyphs.push_back(quad);
+				}
+
+				x += width + glyph.XAdvance;
+				break;
+			}
+			}
+		}
+	}
+
+	void HudComponent::DrawLabels()
+	{
+		PROFILE_SCOPE("HudComponent::DrawLabels");
+
+		// The sprite list keeps its capacity between frames.
+		mSprites.clear();
+		for (const Label& label : mLabels)
+		{
+			if (label.Visible == false)
+			{
+				continue;
+			}
+
+			for (const GlyphQuad& glyph : label.Glyphs)
+			{
+				GlyphSprite sprite;
+				sprite.Subrect = glyph.Subrect;
+				sprite.X = label.Position.x + glyph.Offset.x;
+				sprite.Y = label.Position.y + glyph.Offset.y;
+				sprite.Color[0] = label.Color.x;
+				sprite.Color[1] = label.Color.y;
+				sprite.Color[2] = label.Color.z;
+				sprite.Color[3] = label.Color.w;
+				mSprites.push_back(sprite);
+			}
+		}
+
+		mGame->Device().ImmediateEncoder().DrawGlyphs(mFont, mSprites.data(), static_cast<uint32_t>(mSprites.size()));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "DrawableGameComponent.h"
+#include <DirectXMath.h>
+#include <DirectXColors.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "RenderDevice.h"
+
+namespace Library
+{
+	// Draws every overlay label with one font atlas in a single RenderDevice glyph pass, submitted to the Overlay layer once all other
+	// components have drawn. A label's glyphs are laid out only when its text changes, so a label whose text is unchanged allocates nothing.
+	// Register the HUD as a service and add it after every component that sets label text.
+	class HudComponent final : public DrawableGameComponent
+	{
+		RTTI_DECLARATIONS(HudComponent, DrawableGameComponent)
+
+	public:
+		explicit HudComponent(Game& game, const std::wstring& fontFilename = DefaultFontFilename);
+
+		HudComponent() = delete;
+		HudComponent(const HudComponent&) = delete;
+		HudComponent& operator=(const HudComponent&) = delete;
+		HudComponent(HudComponent&&) = delete;
+		HudComponent& operator=(HudComponent&&) = delete;
+		~HudComponent() = default;
+
+		// Returns the label's handle. Labels can be created and given text before Initialize().
+		std::uint32_t CreateLabel(const DirectX::XMFLOAT2& position, DirectX::FXMVECTOR color = DirectX::Colors::White);
+
+		// Setting the text a label already shows does nothing.
+		void SetText(std::uint32_t label, const wchar_t* text);
+		void SetText(std::uint32_t label, const std::wstring& text);
+		const std::wstring& Text(std::uint32_t label) const;
+
+		void SetPosition(std::uint32_t label, const DirectX::XMFLOAT2& position);
+		void SetColor(std::uint32_t label, DirectX::FXMVECTOR color);
+		void SetLabelVisible(std::uint32_t label, bool visible);
+
+		// Valid after Initialize().
+		float LineSpacing() const;
+
+		// Statistics from the last Draw(). The sprite sheet is the only texture, so the Direct3D 11 device's SpriteBatch issues one
+		// draw call per SpriteBatchSize glyphs.
+		std::uint32_t LabelCount() const;
+		std::uint32_t GlyphCount() const;
+		std::uint32_t LayoutCount() const;
+		std::uint32_t DrawCallCount() const;
+
+		virtual void Initialize() override;
+		virtual void Draw(const GameTime& gameTime) override;
+
+		static const std::wstring DefaultFontFilename;
+
+	private:
+		// Offsets are relative to the label's position.
+		struct GlyphQuad
+		{
+			TextureRegion Subrect;
+			DirectX::XMFLOAT2 Offset;
+		};
+
+		struct Label
+		{
+			std::wstring Text;
+			DirectX::XMFLOAT2 Position;
+			DirectX::XMFLOAT4 Color;
+			std::vector<GlyphQuad> Glyphs;
+			bool Visible;
+			bool IsLayoutDirty;
+
+			Label(const DirectX::XMFLOAT2& position, const DirectX::XMFLOAT4& color) :
+				Text(), Position(position), Color(color), Glyphs(), Visible(true), IsLayoutDirty(false) { }
+		};
+
+		static const std::uint32_t SpriteBatchSize;
+
+		void LayoutLabel(Label& label) const;
+		void DrawLabels();
+
+		std::wstring mFontFilename;
+		FontHandle mFont;
+		float mLineSpacing;
+		std::vector<Label> mLabels;
+		std::vector<GlyphSprite> mSprites;
+
+		std::uint32_t mGlyphCount;
+		std::uint32_t mLayoutCount;
+	};
+}
\ No newline at end of file
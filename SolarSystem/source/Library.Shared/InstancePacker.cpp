@@ -0,0 +1,190 @@
+#include "pch.h"
+#include <cfloat>
+#include <chrono>
+
+using namespace std;
+using namespace DirectX;
+using namespace std::chrono;
+
+namespace Library
+{
+	uint32_t InstancePacker::Add(const XMFLOAT4X4& world, uint32_t meshIndex, uint32_t materialIndex, float ambientIntensity)
+	{
+		mSources.emplace_back(world, meshIndex, materialIndex, ambientIntensity);
+
+		return static_cast<uint32_t>(mSources.size() - 1);
+	}
+
+	void InstancePacker::Clear()
+	{
+		mSources.clear();
+		mRanges.clear();
+	}
+
+	uint32_t InstancePacker::Size() const
+	{
+		return static_cast<uint32_t>(mSources.size());
+	}
+
+	void InstancePacker::SetMeshBounds(uint32_t meshIndex, const XMFLOAT3& center, float radius)
+	{
+		assert(radius >= 0.0f);
+
+		if (meshIndex >= mMeshBounds.size())
+		{
+			mMeshBounds.resize(meshIndex + 1);
+		}
+
+		mMeshBounds[meshIndex].Center = center;
+		mMeshBounds[meshIndex].Radius = radius;
+	}
+
+	void InstancePacker::SetMeshOccluderRadius(uint32_t meshIndex, float radius)
+	{
+		assert(meshIndex < mMeshBounds.size() && mMeshBounds[meshIndex].Radius >= 0.0f);
+		assert(radius >= 0.0f && radius <= mMeshBounds[meshIndex].Radius);
+
+		mMeshBounds[meshIndex].OccluderRadius = radius;
+	}
+
+	void InstancePacker::AddOccluders(OcclusionCuller& occlusionCuller) const
+	{
+		for (const Source& source : mSources)
+		{
+			if (source.MeshIndex >= mMeshBounds.size() || mMeshBounds[source.MeshIndex].OccluderRadius <= 0.0f)
+			{
+				continue;
+			}
+
+			// Scale the radius by the shortest basis vector so that the sphere stays inside the instance.
+			const MeshBounds& meshBounds = mMeshBounds[source.MeshIndex];
+			XMMATRIX worldMatrix = XMLoadFloat4x4(source.World);
+			XMFLOAT3 center;
+			XMStoreFloat3(&center, XMVector3Transform(XMLoadFloat3(&meshBounds.Center), worldMatrix));
+
+			XMVECTOR scaleSquared = XMVectorMin(XMVectorMin(XMVector3LengthSq(worldMatrix.r[0]), XMVector3LengthSq(worldMatrix.r[1])), XMVector3LengthSq(worldMatrix.r[2]));
+			float radius = meshBounds.OccluderRadius * XMVectorGetX(XMVectorSqrt(scaleSquared));
+
+			occlusionCuller.AddSphereOccluder(center.x, center.y, center.z, radius);
+		}
+	}
+
+	void InstancePacker::Pack(const XMFLOAT4X4& viewProjection, const Frustum& frustum, InstanceData* destination, const OcclusionCuller* occlusionCuller)
+	{
+		assert(destination != nullptr || mSources.empty());
+
+		Cull(frustum, occlusionCuller);
+
+		// Counting sort by mesh index; the order of instances within a mesh is preserved.
+		mMeshOffsets.clear();
+		for (uint32_t i = 0; i < mSources.size(); ++i)
+		{
+			if (mVisibility[i] == 0)
+			{
+				continue;
+			}
+
+			const Source& source = mSources[i];
+			if (source.MeshIndex >= mMeshOffsets.size())
+			{
+				mMeshOffsets.resize(source.MeshIndex + 1, 0);
+			}
+
+			++mMeshOffsets[source.MeshIndex];
+		}
+
+		mRanges.clear();
+		uint32_t startInstance = 0;
+		for (uint32_t meshIndex = 0; meshIndex < mMeshOffsets.size(); ++meshIndex)
+		{
+			uint32_t instanceCount = mMeshOffsets[meshIndex];
+			mMeshOffsets[meshIndex] = startInstance;
+			if (instanceCount > 0)
+			{
+				mRanges.emplace_back(meshIndex, startInstance, instanceCount);
+				startInstance += instanceCount;
+			}
+		}
+
+		mVisibleCount = startInstance;
+
+		XMMATRIX viewProjectionMatrix = XMLoadFloat4x4(&viewProjection);
+		for (uint32_t i = 0; i < mSources.size(); ++i)
+		{
+			if (mVisibility[i] == 0)
+			{
+				continue;
+			}
+
+			const Source& source = mSources[i];
+			InstanceData& instance = destination[mMeshOffsets[source.MeshIndex]++];
+
+			XMMATRIX worldMatrix = XMLoadFloat4x4(source.World);
+			XMStoreFloat4x4(&instance.World, worldMatrix);
+			XMStoreFloat4x4(&instance.WorldViewProjection, worldMatrix * viewProjectionMatrix);
+			instance.MaterialIndex = source.MaterialIndex;
+			instance.AmbientIntensity = source.AmbientIntensity;
+			instance.Padding[0] = 0.0f;
+			instance.Padding[1] = 0.0f;
+		}
+	}
+
+	const vector<InstanceRange>& InstancePacker::Ranges() const
+	{
+		return mRanges;
+	}
+
+	uint32_t InstancePacker::VisibleCount() const
+	{
+		return mVisibleCount;
+	}
+
+	uint32_t InstancePacker::OccludedCount() const
+	{
+		return mOccludedCount;
+	}
+
+	double InstancePacker::OcclusionTestMicroseconds() const
+	{
+		return mOcclusionTestMicroseconds;
+	}
+
+	void InstancePacker::Cull(const Frustum& frustum, const OcclusionCuller* occlusionCuller)
+	{
+		uint32_t sourceCount = static_cast<uint32_t>(mSources.size());
+		mWorldBounds.Resize(sourceCount);
+		mVisibility.resize(sourceCount);
+
+		for (uint32_t i = 0; i < sourceCount; ++i)
+		{
+			const Source& source = mSources[i];
+			if (source.MeshIndex >= mMeshBounds.size() || mMeshBounds[source.MeshIndex].Radius < 0.0f)
+			{
+				mWorldBounds.Set(i, 0.0f, 0.0f, 0.0f, FLT_MAX);
+				continue;
+			}
+
+			// Scale the radius by the longest basis vector so that non-uniform scales stay conservative.
+			const MeshBounds& meshBounds = mMeshBounds[source.MeshIndex];
+			XMMATRIX worldMatrix = XMLoadFloat4x4(source.World);
+			XMFLOAT3 center;
+			XMStoreFloat3(&center, XMVector3Transform(XMLoadFloat3(&meshBounds.Center), worldMatrix));
+
+			XMVECTOR scaleSquared = XMVectorMax(XMVectorMax(XMVector3LengthSq(worldMatrix.r[0]), XMVector3LengthSq(worldMatrix.r[1])), XMVector3LengthSq(worldMatrix.r[2]));
+			float radius = meshBounds.Radius * XMVectorGetX(XMVectorSqrt(scaleSquared));
+
+			mWorldBounds.Set(i, center.x, center.y, center.z, radius);
+		}
+
+		FrustumCuller::Cull(frustum, mWorldBounds, mVisibility.data());
+
+		mOccludedCount = 0;
+		mOcclusionTestMicroseconds = 0.0;
+		if (occlusionCuller != nullptr)
+		{
+			high_resolution_clock::time_point startTime = high_resolution_clock::now();
+			mOccludedCount = occlusionCuller->Cull(mWorldBounds, mVisibility.data());
+			mOcclusionTestMicroseconds = duration<double, micro>(high_resolution_clock::now() - startTime).count();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <DirectXMath.h>
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+
+namespace Library
+{
+	// Per-instance vertex data. Matrices are stored row-major because the instanced shaders rebuild them from vertex element rows.
+	struct InstanceData
+	{
+		DirectX::XMFLOAT4X4 World;
+		DirectX::XMFLOAT4X4 WorldViewProjection;
+		std::uint32_t MaterialIndex;
+		float AmbientIntensity;
+		float Padding[2];
+	};
+
+	struct InstanceRange
+	{
+		std::uint32_t MeshIndex;
+		std::uint32_t StartInstance;
+		std::uint32_t InstanceCount;
+
+		InstanceRange(std::uint32_t meshIndex, std::uint32_t startInstance, std::uint32_t instanceCount) :
+			MeshIndex(meshIndex), StartInstance(startInstance), InstanceCount(instanceCount) { }
+	};
+
+	class InstancePacker final
+	{
+	public:
+		InstancePacker() = default;
+		InstancePacker(const InstancePacker&) = delete;
+		InstancePacker& operator=(const InstancePacker&) = delete;
+		InstancePacker(InstancePacker&&) = default;
+		InstancePacker& operator=(InstancePacker&&) = default;
+		~InstancePacker() = default;
+
+		std::uint32_t Add(const DirectX::XMFLOAT4X4& world, std::uint32_t meshIndex, std::uint32_t materialIndex, float ambientIntensity);
+		void Clear();
+		std::uint32_t Size() const;
+
+		// Object-space bounding sphere of a mesh; instances of meshes without bounds are never culled.
+		void SetMeshBounds(std::uint32_t meshIndex, const DirectX::XMFLOAT3& center, float radius);
+
+		// Radius of a sphere about the bounds' center that lies entirely inside the mesh. Instances of meshes with one act as occluders.
+		void SetMeshOccluderRadius(std::uint32_t meshIndex, float radius);
+
+		// Adds the occluder sphere of every instance whose mesh has one.
+		void AddOccluders(OcclusionCuller& occlusionCuller) const;
+
+		// Writes every instance that intersects the frustum, grouped by mesh, to destination (which must hold Size() entries) and rebuilds Ranges().
+		// Instances hidden behind the rasterized occluders of occlusionCuller, when one is given, are dropped as well.
+		// Touches no graphics API state, so it may run on a worker thread while the world matrices are not being written.
+		void Pack(const DirectX::XMFLOAT4X4& viewProjection, const Frustum& frustum, InstanceData* destination, const OcclusionCuller* occlusionCuller = nullptr);
+
+		const std::vector<InstanceRange>& Ranges() const;
+		std::uint32_t VisibleCount() const;
+
+		// Instances inside the frustum that were occluded in the last Pack(), and the time spent testing them.
+		std::uint32_t OccludedCount() const;
+		double OcclusionTestMicroseconds() const;
+
+	private:
+		struct Source
+		{
+			const DirectX::XMFLOAT4X4* World;
+			std::uint32_t MeshIndex;
+			std::uint32_t MaterialIndex;
+			float AmbientIntensity;
+
+			Source(const DirectX::XMFLOAT4X4& world, std::uint32_t meshIndex, std::uint32_t materialIndex, float ambientIntensity) :
+				World(&world), MeshIndex(meshIndex), MaterialIndex(materialIndex), AmbientIntensity(ambientIntensity) { }
+		};
+
+		struct MeshBounds
+		{
+			DirectX::XMFLOAT3 Center;
+			float Radius;
+			float OccluderRadius;
+
+			MeshBounds() :
+				Center(0.0f, 0.0f, 0.0f), Radius(-1.0f), OccluderRadius(0.0f) { }
+		};
+
+		void Cull(const Frustum& frustum, const OcclusionCuller* occlusionCuller);
+
+		std::vector<Source> mSources;
+		std::vector<InstanceRange> mRanges;
+		std::vector<std::uint32_t> mMeshOffsets;
+		std::vector<MeshBounds> mMeshBounds;
+		BoundingSphereSet mWorldBounds;
+		std::vector<std::uint8_t> mVisibility;
+		std::uint32_t mVisibleCount = 0;
+		std::uint32_t mOccludedCount = 0;
+		double mOcclusionTestMicroseconds = 0.0;
+	};
+}
\ No newline at end of file
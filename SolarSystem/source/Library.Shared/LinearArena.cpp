@@ -0,0 +1,107 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	LinearArena::LinearArena(size_t capacity, MemoryResource& upstream) :
+		mCapacity(capacity), mOffset(0), mUpstream(&upstream), mOverflowBytes(0), mHasWarned(false)
+	{
+	}
+
+	LinearArena::~LinearArena()
+	{
+		ReleaseOverflow();
+	}
+
+	void LinearArena::Reset()
+	{
+#if defined(DEBUG) || defined(_DEBUG)
+		if (mBuffer != nullptr)
+		{
+			memset(mBuffer.get(), PoisonByte, mOffset);
+		}
+#endif
+
+		mOffset = 0;
+		ReleaseOverflow();
+	}
+
+	size_t LinearArena::Capacity() const
+	{
+		return mCapacity;
+	}
+
+	size_t LinearArena::UsedBytes() const
+	{
+		return mOffset;
+	}
+
+	uint32_t LinearArena::OverflowCount() const
+	{
+		return static_cast<uint32_t>(mOverflow.size());
+	}
+
+	size_t LinearArena::OverflowBytes() const
+	{
+		return mOverflowBytes;
+	}
+
+	void* LinearArena::DoAllocate(size_t bytes, size_t alignment)
+	{
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+		if (mBuffer == nullptr)
+		{
+			mBuffer.reset(new unsigned char[mCapacity]);
+			mOverflow.reserve(OverflowReserve);
+		}
+
+		const uintptr_t base = reinterpret_cast<uintptr_t>(mBuffer.get());
+		const size_t alignedOffset = ((base + mOffset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+		if (alignedOffset <= mCapacity && bytes <= mCapacity - alignedOffset)
+		{
+			mOffset = alignedOffset + bytes;
+			return mBuffer.get() + alignedOffset;
+		}
+
+		if (mHasWarned == false)
+		{
+			mHasWarned = true;
+#if defined(LIBRARY_PORTABLE)
+			cerr << "LinearArena: out of space; allocating from the upstream resource. Raise the arena's capacity." << endl;
+#else
+			OutputDebugStringA("LinearArena: out of space; allocating from the upstream resource. Raise the arena's capacity.\n");
+#endif
+		}
+
+		OverflowAllocation allocation = { mUpstream->Allocate(bytes, alignment), bytes, alignment };
+		mOverflow.push_back(allocation);
+		mOverflowBytes += bytes;
+
+		return allocation.Memory;
+	}
+
+	void LinearArena::DoDeallocate(void* memory, size_t bytes, size_t alignment)
+	{
+		UNREFERENCED_PARAMETER(memory);
+		UNREFERENCED_PARAMETER(bytes);
+		UNREFERENCED_PARAMETER(alignment);
+	}
+
+	bool LinearArena::DoIsEqual(const MemoryResource& other) const
+	{
+		return (this == &other);
+	}
+
+	void LinearArena::ReleaseOverflow()
+	{
+		for (const OverflowAllocation& allocation : mOverflow)
+		{
+			mUpstream->Deallocate(allocation.Memory, allocation.Bytes, allocation.Alignment);
+		}
+
+		mOverflow.clear();
+		mOverflowBytes = 0;
+	}
+}
\ No newline at end of file
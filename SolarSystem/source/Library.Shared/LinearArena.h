@@ -0,0 +1,61 @@
+#pragma once
+
+#include "MemoryResource.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace Library
+{
+	// Hands out memory by bumping an offset through one buffer and frees it all at once with Reset(); Deallocate() does
+	// nothing. The buffer is allocated on first use. An allocation that doesn't fit comes from the upstream resource instead,
+	// with a warning the first time, and is released at the next Reset(). In debug builds Reset() overwrites the freed bytes
+	// with PoisonByte, so memory used after a reset reads as garbage rather than as stale but plausible data.
+	class LinearArena final : public MemoryResource
+	{
+	public:
+		static const unsigned char PoisonByte = 0xDD;
+
+		explicit LinearArena(std::size_t capacity, MemoryResource& upstream = MemoryResource::Heap());
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+		LinearArena(LinearArena&&) = delete;
+		LinearArena& operator=(LinearArena&&) = delete;
+		~LinearArena();
+
+		void Reset();
+
+		std::size_t Capacity() const;
+		std::size_t UsedBytes() const;
+
+		// Allocations that didn't fit since the last Reset().
+		std::uint32_t OverflowCount() const;
+		std::size_t OverflowBytes() const;
+
+	protected:
+		virtual void* DoAllocate(std::size_t bytes, std::size_t alignment) override;
+		virtual void DoDeallocate(void* memory, std::size_t bytes, std::size_t alignment) override;
+		virtual bool DoIsEqual(const MemoryResource& other) const override;
+
+	private:
+		struct OverflowAllocation
+		{
+			void* Memory;
+			std::size_t Bytes;
+			std::size_t Alignment;
+		};
+
+		void ReleaseOverflow();
+
+		static const std::size_t OverflowReserve = 16;
+
+		std::unique_ptr<unsigned char[]> mBuffer;
+		std::size_t mCapacity;
+		std::size_t mOffset;
+		MemoryResource* mUpstream;
+		std::vector<OverflowAllocation> mOverflow;
+		std::size_t mOverflowBytes;
+		bool mHasWarned;
+	};
+}
\ No newline at end of file
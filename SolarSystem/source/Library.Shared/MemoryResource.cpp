@@ -0,0 +1,33 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	MemoryResource& MemoryResource::Heap()
+	{
+		static HeapResource heapResource;
+		return heapResource;
+	}
+
+	void* HeapResource::DoAllocate(size_t bytes, size_t alignment)
+	{
+		UNREFERENCED_PARAMETER(alignment);
+		assert(alignment <= DefaultAlignment);
+
+		return ::operator new(bytes);
+	}
+
+	void HeapResource::DoDeallocate(void* memory, size_t bytes, size_t alignment)
+	{
+		UNREFERENCED_PARAMETER(bytes);
+		UNREFERENCED_PARAMETER(alignment);
+
+		::operator delete(memory);
+	}
+
+	bool HeapResource::DoIsEqual(const MemoryResource& other) const
+	{
+		return (this == &other);
+	}
+}
\ No newline at end of file
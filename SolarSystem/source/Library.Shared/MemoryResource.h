@@ -0,0 +1,129 @@
+#pragma once
+
+#include <new>
+#include <limits>
+#include <cstddef>
+
+namespace Library
+{
+	// The interface of C++17's std::pmr::memory_resource, which this toolset doesn't have yet. Derived classes implement the
+	// Do functions; containers reach a resource through PolymorphicAllocator.
+	class MemoryResource
+	{
+	public:
+		static const std::size_t DefaultAlignment = alignof(std::max_align_t);
+
+		MemoryResource() = default;
+		MemoryResource(const MemoryResource&) = delete;
+		MemoryResource& operator=(const MemoryResource&) = delete;
+		MemoryResource(MemoryResource&&) = delete;
+		MemoryResource& operator=(MemoryResource&&) = delete;
+		virtual ~MemoryResource() = default;
+
+		void* Allocate(std::size_t bytes, std::size_t alignment = DefaultAlignment)
+		{
+			return DoAllocate(bytes, alignment);
+		}
+
+		void Deallocate(void* memory, std::size_t bytes, std::size_t alignment = DefaultAlignment)
+		{
+			DoDeallocate(memory, bytes, alignment);
+		}
+
+		bool IsEqual(const MemoryResource& other) const
+		{
+			return (this == &other || DoIsEqual(other));
+		}
+
+		// A HeapResource; the resource a default-constructed PolymorphicAllocator uses.
+		static MemoryResource& Heap();
+
+	protected:
+		virtual void* DoAllocate(std::size_t bytes, std::size_t alignment) = 0;
+		virtual void DoDeallocate(void* memory, std::size_t bytes, std::size_t alignment) = 0;
+		virtual bool DoIsEqual(const MemoryResource& other) const = 0;
+	};
+
+	// The global operator new and delete, so allocations are visible to AllocationCounter. Alignments larger than
+	// MemoryResource::DefaultAlignment are not supported.
+	class HeapResource final : public MemoryResource
+	{
+	public:
+		HeapResource() = default;
+		HeapResource(const HeapResource&) = delete;
+		HeapResource& operator=(const HeapResource&) = delete;
+		HeapResource(HeapResource&&) = delete;
+		HeapResource& operator=(HeapResource&&) = delete;
+		~HeapResource() = default;
+
+	protected:
+		virtual void* DoAllocate(std::size_t bytes, std::size_t alignment) override;
+		virtual void DoDeallocate(void* memory, std::size_t bytes, std::size_t alignment) override;
+		virtual bool DoIsEqual(const MemoryResource& other) const override;
+	};
+
+	// A standard allocator that forwards to a MemoryResource, like std::pmr::polymorphic_allocator, so standard containers can
+	// allocate from an arena. As with pmr, a container copied from another one gets the heap rather than sharing its arena.
+	template <typename T>
+	class PolymorphicAllocator
+	{
+	public:
+		typedef T value_type;
+
+		PolymorphicAllocator() :
+			mResource(&MemoryResource::Heap())
+		{
+		}
+
+		PolymorphicAllocator(MemoryResource& resource) :
+			mResource(&resource)
+		{
+		}
+
+		template <typename U>
+		PolymorphicAllocator(const PolymorphicAllocator<U>& other) :
+			mResource(other.Resource())
+		{
+		}
+
+		T* allocate(std::size_t count)
+		{
+			if (count > (std::numeric_limits<std::size_t>::max)() / sizeof(T))
+			{
+				throw std::bad_alloc();
+			}
+
+			return static_cast<T*>(mResource->Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* memory, std::size_t count)
+		{
+			mResource->Deallocate(memory, count * sizeof(T), alignof(T));
+		}
+
+		PolymorphicAllocator select_on_container_copy_construction() const
+		{
+			return PolymorphicAllocator();
+		}
+
+		MemoryResource* Resource() const
+		{
+			return mResource;
+		}
+
+	private:
+		MemoryResource* mResource;
+	};
+
+	template <typename T, typename U>
+	bool operator==(const PolymorphicAllocator<T>& lhs, const PolymorphicAllocator<U>& rhs)
+	{
+		return lhs.Resource()->IsEqual(*rhs.Resource());
+	}
+
+	template <typename T, typename U>
+	bool operator!=(const PolymorphicAllocator<T>& lhs, const PolymorphicAllocator<U>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+}
\ No newline at end of file
@@ -4,79 +4,21 @@ using namespace std;
 using namespace DirectX;
 using namespace Library;
 
-#pragma region MeshData
-
-MeshData::MeshData() :
-	Material(nullptr), Name(), Vertices(),
-	Normals(), Tangents(), BiNormals(), TextureCoordinates(), VertexColors(),
-	FaceCount(0), Indices()
-{
-}
-
-MeshData::MeshData(MeshData&& rhs) :
-	Material(move(rhs.Material)), Name(move(rhs.Name)), Vertices(move(rhs.Vertices)),
-	Normals(move(rhs.Normals)), Tangents(move(rhs.Tangents)), BiNormals(move(rhs.BiNormals)),
-	TextureCoordinates(move(rhs.TextureCoordinates)), VertexColors(move(rhs.VertexColors)), FaceCount(rhs.FaceCount),
-	Indices(move(rhs.Indices))
-{
-	rhs.FaceCount = 0U;
-}
-
-MeshData& MeshData::operator=(MeshData&& rhs)
-{
-	if (this != &rhs)
-	{
-		Clear();
-		Material = move(rhs.Material);
-		Name = move(rhs.Name);
-		Vertices = move(rhs.Vertices);
-		Normals = move(rhs.Normals);
-		Tangents = move(rhs.Tangents);
-		BiNormals = move(rhs.BiNormals);
-		TextureCoordinates = move(rhs.TextureCoordinates);
-		VertexColors = move(rhs.VertexColors);
-		FaceCount = rhs.FaceCount;
-		Indices = move(rhs.Indices);
-
-		rhs.FaceCount = 0U;
-	}
-
-	return *this;
-}
-
-MeshData::~MeshData()
-{
-	Clear();
-}
-
-void MeshData::Clear()
-{
-	for (vector<XMFLOAT3>* textureCoordinates : TextureCoordinates)
-	{
-		delete textureCoordinates;
-	}
-
-	for (vector<XMFLOAT4>* vertexColors : VertexColors)
-	{
-		delete vertexColors;
-	}
-}
-
-#pragma endregion
-
-Mesh::Mesh(Model& model, InputStreamHelper& streamHelper) :
-	mModel(&model), mData()
+Mesh::Mesh(Model& model, InputStreamHelper& streamHelper, MemoryResource& resource) :
+	mModel(&model), mData(resource)
 {
 	Load(streamHelper);
+	UpdateBounds();
 }
 
 Mesh::Mesh(Model& model, MeshData&& meshData) :
 	mModel(&model), mData(move(meshData))
 {
+	UpdateBounds();
 }
 
 Mesh::Mesh(Mesh&& rhs) :
-	mModel(move(rhs.mModel)), mData(move(rhs.mData))
+	mModel(move(rhs.mModel)), mData(move(rhs.mData)), mBounds(rhs.mBounds)
 {
 }
 
@@ -86,6 +28,7 @@ Mesh& Mesh::operator=(Mesh&& rhs)
 	{
 		mModel = move(rhs.mModel);
 		mData = move(rhs.mData);
+		mBounds = rhs.mBounds;
 	}
 
 	return *this;
@@ -106,34 +49,44 @@ const string& Mesh::Name() const
 	return mData.Name;
 }
 
-const vector<XMFLOAT3>& Mesh::Vertices() const
+Span<const XMFLOAT3> Mesh::Vertices() const
+{
+	return mData.Vertices();
+}
+
+Span<const XMFLOAT3> Mesh::Normals() const
 {
-	return mData.Vertices;
+	return mData.Normals();
 }
 
-const vector<XMFLOAT3>& Mesh::Normals() const
+Span<const XMFLOAT3> Mesh::Tangents() const
 {
-	return mData.Normals;
+	return mData.Tangents();
 }
 
-const vector<XMFLOAT3>& Mesh::Tangents() const
+Span<const XMFLOAT3> Mesh::BiNormals() const
 {
-	return mData.Tangents;
+	return mData.BiNormals();
 }
 
-const vector<XMFLOAT3>& Mesh::BiNormals() const
+Span<const XMFLOAT3> Mesh::TextureCoordinates(uint32_t channel) const
 {
-	return mData.BiNormals;
+	return mData.TextureCoordinates(channel);
 }
 
-const vector<vector<XMFLOAT3>*>& Mesh::TextureCoordinates() const
+uint32_t Mesh::TextureCoordinateChannelCount() const
 {
-	return mData.TextureCoordinates;
+	return mData.Layout().TextureCoordinateChannelCount;
 }
 
-const vector<vector<XMFLOAT4>*>& Mesh::VertexColors() const
+Span<const XMFLOAT4> Mesh::VertexColors(uint32_t channel) const
 {
-	return mData.VertexColors;
+	return mData.VertexColors(channel);
+}
+
+uint32_t Mesh::VertexColorChannelCount() const
+{
+	return mData.Layout().VertexColorChannelCount;
 }
 
 uint32_t Mesh::FaceCount() const
@@ -141,9 +94,14 @@ uint32_t Mesh::FaceCount() const
 	return mData.FaceCount;
 }
 
-const vector<uint32_t>& Mesh::Indices() const
+Span<const uint32_t> Mesh::Indices() const
+{
+	return mData.Indices();
+}
+
+const BoundingSphere& Mesh::Bounds() const
 {
-	return mData.Indices;
+	return mBounds;
 }
 
 void Mesh::CreateIndexBuffer(ID3D11Device& device, ID3D11Buffer** indexBuffer)
@@ -151,16 +109,22 @@ void Mesh::CreateIndexBuffer(ID3D11Device& device, ID3D11Buffer** indexBuffer)
 	assert(indexBuffer != nullptr);
 
 	D3D11_BUFFER_DESC indexBufferDesc = { 0 };
-	indexBufferDesc.ByteWidth = static_cast<uint32_t>(sizeof(uint32_t) * mData.Indices.size());
+	indexBufferDesc.ByteWidth = static_cast<uint32_t>(mData.Indices().SizeBytes());
 	indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
 	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 
 	D3D11_SUBRESOURCE_DATA indexSubResourceData = { 0 };
-	indexSubResourceData.pSysMem = &mData.Indices[0];
+	indexSubResourceData.pSysMem = mData.Indices().Data();
 
 	ThrowIfFailed(device.CreateBuffer(&indexBufferDesc, &indexSubResourceData, indexBuffer), "ID3D11Device::CreateBuffer() failed.");
 }
 
+BufferHandle Mesh::CreateIndexBuffer(RenderDevice& device) const
+{
+	BufferDescription description(BufferType::Index, ResourceUsage::Immutable, static_cast<uint32_t>(mData.Indices().SizeBytes()));
+	return device.CreateBuffer(description, mData.Indices().Data());
+}
+
 void Mesh::Save(OutputStreamHelper& streamHelper) const
 {
 	string materialName = (mData.Material != nullptr ? mData.Material->Name() : "");
@@ -169,63 +133,35 @@ void Mesh::Save(OutputStreamHelper& streamHelper) const
 	// Serialize name
 	streamHelper << mData.Name;
 
-	// Serialize vertices
-	streamHelper << static_cast<uint32_t>(mData.Vertices.size());
-	for (const XMFLOAT3& vertex : mData.Vertices)
-	{
-		streamHelper << vertex.x << vertex.y << vertex.z;
-	}
-
-	// Serialize normals
-	streamHelper << static_cast<uint32_t>(mData.Normals.size());
-	for (const XMFLOAT3& normal : mData.Normals)
-	{
-		streamHelper << normal.x << normal.y << normal.z;
-	}
-
-	// Serialize tangents
-	streamHelper << static_cast<uint32_t>(mData.Tangents.size());
-	for (const XMFLOAT3& tangents : mData.Tangents)
-	{
-		streamHelper << tangents.x << tangents.y << tangents.z;
-	}
-
-	// Serialize binormals
-	streamHelper << static_cast<uint32_t>(mData.BiNormals.size());
-	for (const XMFLOAT3& binormal : mData.BiNormals)
+	// Serialize vertices, normals, tangents and binormals
+	for (Span<const XMFLOAT3> channel : { mData.Vertices(), mData.Normals(), mData.Tangents(), mData.BiNormals() })
 	{
-		streamHelper << binormal.x << binormal.y << binormal.z;
+		streamHelper << static_cast<uint32_t>(channel.Size());
+		streamHelper.WriteArray(reinterpret_cast<const float*>(channel.Data()), channel.Size() * 3);
 	}
 
 	// Serialize texture coordinates
-	streamHelper << static_cast<uint32_t>(mData.TextureCoordinates.size());
-	for (const auto& uvList : mData.TextureCoordinates)
+	streamHelper << mData.Layout().TextureCoordinateChannelCount;
+	for (uint32_t i = 0; i < mData.Layout().TextureCoordinateChannelCount; i++)
 	{
-		streamHelper << static_cast<uint32_t>(uvList->size());
-		for (const XMFLOAT3& uv : *uvList)
-		{
-			streamHelper << uv.x << uv.y << uv.z;
-		}
+		Span<const XMFLOAT3> textureCoordinates = mData.TextureCoordinates(i);
+		streamHelper << static_cast<uint32_t>(textureCoordinates.Size());
+		streamHelper.WriteArray(reinterpret_cast<const float*>(textureCoordinates.Data()), textureCoordinates.Size() * 3);
 	}
 
-	// Serialize vertex colors
-	streamHelper << static_cast<uint32_t>(mData.VertexColors.size());
-	for (const auto& vertexColorList : mData.VertexColors)
+	// Serialize vertex colors (as 32-bit counts, which Load() expects; they used to be written as size_t)
+	streamHelper << mData.Layout().VertexColorChannelCount;
+	for (uint32_t i = 0; i < mData.Layout().VertexColorChannelCount; i++)
 	{
-		streamHelper << vertexColorList->size();
-		for (const XMFLOAT4& vertexColor : *vertexColorList)
-		{
-			streamHelper << vertexColor.x << vertexColor.y << vertexColor.z << vertexColor.w;
-		}
+		Span<const XMFLOAT4> vertexColors = mData.VertexColors(i);
+		streamHelper << static_cast<uint32_t>(vertexColors.Size());
+		streamHelper.WriteArray(reinterpret_cast<const float*>(vertexColors.Data()), vertexColors.Size() * 4);
 	}
 
 	// Serialize indices
 	streamHelper << mData.FaceCount;
-	streamHelper << static_cast<uint32_t>(mData.Indices.size());
-	for (const uint32_t& index : mData.Indices)
-	{
-		streamHelper << index;
-	}
+	streamHelper << static_cast<uint32_t>(mData.Indices().Size());
+	streamHelper.WriteArray(mData.Indices().Data(), mData.Indices().Size());
 }
 
 void Mesh::Load(InputStreamHelper& streamHelper)
@@ -246,105 +182,132 @@ void Mesh::Load(InputStreamHelper& streamHelper)
 	// Deserialize name
 	streamHelper >> mData.Name;
 
-	// Deserialize vertices
-	uint32_t vertexCount;
-	streamHelper >> vertexCount;
-	mData.Vertices.reserve(vertexCount);
-	for (uint32_t i = 0; i < vertexCount; i++)
+	// Every channel is sized before any is read, so the mesh takes a single allocation: the first pass notes where each
+	// channel's data starts and skips it, the second reads each channel straight into place.
+	MeshLayout layout;
+	const streampos verticesPosition = SkipChannel(streamHelper, sizeof(XMFLOAT3), layout.VertexCount);
+
+	uint32_t count;
+	const streampos normalsPosition = SkipChannel(streamHelper, sizeof(XMFLOAT3), count);
+	layout.HasNormals = HasVertexChannel(count, layout.VertexCount);
+	const streampos tangentsPosition = SkipChannel(streamHelper, sizeof(XMFLOAT3), count);
+	layout.HasTangents = HasVertexChannel(count, layout.VertexCount);
+	const streampos biNormalsPosition = SkipChannel(streamHelper, sizeof(XMFLOAT3), count);
+	layout.HasBiNormals = HasVertexChannel(count, layout.VertexCount);
+
+	// Empty channels are dropped, as they always have been
+	streampos textureCoordinatePositions[MeshLayout::MaxTextureCoordinateChannels];
+	uint32_t textureCoordinateChannelCount;
+	streamHelper >> textureCoordinateChannelCount;
+	for (uint32_t i = 0; i < textureCoordinateChannelCount; i++)
 	{
-		XMFLOAT3 vertex;
-		streamHelper >> vertex.x >> vertex.y >> vertex.z;
-		mData.Vertices.push_back(vertex);
+		const streampos position = SkipChannel(streamHelper, sizeof(XMFLOAT3), count);
+		if (HasVertexChannel(count, layout.VertexCount))
+		{
+			if (layout.TextureCoordinateChannelCount == MeshLayout::MaxTextureCoordinateChannels)
+			{
+				throw GameException("Mesh::Load(): the mesh has too many texture coordinate channels.");
+			}
+
+			textureCoordinatePositions[layout.TextureCoordinateChannelCount++] = position;
+		}
 	}
 
-	// Deserialize normals
-	uint32_t normalCount;
-	streamHelper >> normalCount;
-	mData.Normals.reserve(normalCount);
-	for (uint32_t i = 0; i < normalCount; i++)
+	streampos vertexColorPositions[MeshLayout::MaxVertexColorChannels];
+	uint32_t vertexColorChannelCount;
+	streamHelper >> vertexColorChannelCount;
+	for (uint32_t i = 0; i < vertexColorChannelCount; i++)
 	{
-		XMFLOAT3 normal;
-		streamHelper >> normal.x >> normal.y >> normal.z;
-		mData.Normals.push_back(normal);
+		const streampos position = SkipChannel(streamHelper, sizeof(XMFLOAT4), count);
+		if (HasVertexChannel(count, layout.VertexCount))
+		{
+			if (layout.VertexColorChannelCount == MeshLayout::MaxVertexColorChannels)
+			{
+				throw GameException("Mesh::Load(): the mesh has too many vertex color channels.");
+			}
+
+			vertexColorPositions[layout.VertexColorChannelCount++] = position;
+		}
 	}
 
-	// Deserialize tangents
-	uint32_t tangentCount;
-	streamHelper >> tangentCount;
-	mData.Tangents.reserve(tangentCount);
-	for (uint32_t i = 0; i < tangentCount; i++)
+	streamHelper >> mData.FaceCount;
+	const streampos indicesPosition = SkipChannel(streamHelper, sizeof(uint32_t), layout.IndexCount);
+	const streampos endPosition = streamHelper.Stream().tellg();
+
+	mData.Allocate(layout);
+
+	istream& stream = streamHelper.Stream();
+	stream.seekg(verticesPosition);
+	streamHelper.ReadArray(reinterpret_cast<float*>(mData.Vertices().Data()), layout.VertexCount * 3);
+	if (layout.HasNormals)
 	{
-		XMFLOAT3 tangent;
-		streamHelper >> tangent.x >> tangent.y >> tangent.z;
-		mData.Tangents.push_back(tangent);
+		stream.seekg(normalsPosition);
+		streamHelper.ReadArray(reinterpret_cast<float*>(mData.Normals().Data()), layout.VertexCount * 3);
 	}
 
-	// Deserialize binormals
-	uint32_t binormalCount;
-	streamHelper >> binormalCount;
-	mData.BiNormals.reserve(binormalCount);
-	for (uint32_t i = 0; i < binormalCount; i++)
+	if (layout.HasTangents)
 	{
-		XMFLOAT3 binormal;
-		streamHelper >> binormal.x >> binormal.y >> binormal.z;
-		mData.BiNormals.push_back(binormal);
+		stream.seekg(tangentsPosition);
+		streamHelper.ReadArray(reinterpret_cast<float*>(mData.Tangents().Data()), layout.VertexCount * 3);
 	}
 
-	// Deserialize texture coordinates
-	uint32_t textureCoordinateCount;
-	streamHelper >> textureCoordinateCount;
-	mData.TextureCoordinates.reserve(textureCoordinateCount);
-	for (uint32_t i = 0; i < textureCoordinateCount; i++)
+	if (layout.HasBiNormals)
 	{
-		uint32_t uvListCount;
-		streamHelper >> uvListCount;
-		if (uvListCount > 0)
-		{
-			std::vector<XMFLOAT3>* uvs = new std::vector<XMFLOAT3>();
-			uvs->reserve(uvListCount);
-			mData.TextureCoordinates.push_back(uvs);
+		stream.seekg(biNormalsPosition);
+		streamHelper.ReadArray(reinterpret_cast<float*>(mData.BiNormals().Data()), layout.VertexCount * 3);
+	}
 
-			for (uint32_t j = 0; j < uvListCount; j++)
-			{
-				XMFLOAT3 uv;
-				streamHelper >> uv.x >> uv.y >> uv.z;
-				uvs->push_back(uv);
-			}
-		}
+	for (uint32_t i = 0; i < layout.TextureCoordinateChannelCount; i++)
+	{
+		stream.seekg(textureCoordinatePositions[i]);
+		streamHelper.ReadArray(reinterpret_cast<float*>(mData.TextureCoordinates(i).Data()), layout.VertexCount * 3);
 	}
 
-	// Deserialize vertex colors
-	uint32_t vertexColorCount;
-	streamHelper >> vertexColorCount;
-	mData.VertexColors.reserve(vertexColorCount);
-	for (uint32_t i = 0; i < vertexColorCount; i++)
+	for (uint32_t i = 0; i < layout.VertexColorChannelCount; i++)
 	{
-		uint32_t vertexColorListCount;
-		streamHelper >> vertexColorListCount;
-		if (vertexColorListCount > 0)
-		{
-			std::vector<XMFLOAT4>* vertexColors = new std::vector<XMFLOAT4>();
-			vertexColors->reserve(vertexColorListCount);
-			mData.VertexColors.push_back(vertexColors);
+		stream.seekg(vertexColorPositions[i]);
+		streamHelper.ReadArray(reinterpret_cast<float*>(mData.VertexColors(i).Data()), layout.VertexCount * 4);
+	}
 
-			for (uint32_t j = 0; j < vertexColorListCount; j++)
-			{
-				XMFLOAT4 vertexColor;
-				streamHelper >> vertexColor.x >> vertexColor.y >> vertexColor.z >> vertexColor.w;
-				vertexColors->push_back(vertexColor);
-			}
-		}
+	stream.seekg(indicesPosition);
+	streamHelper.ReadArray(mData.Indices().Data(), layout.IndexCount);
+
+	stream.seekg(endPosition);
+	if (stream.fail())
+	{
+		throw GameException("Mesh::Load(): the mesh data is truncated.");
 	}
+}
 
-	// Deserialize indexes	
-	streamHelper >> mData.FaceCount;
-	uint32_t indexCount;
-	streamHelper >> indexCount;
-	mData.Indices.reserve(indexCount);
-	for (uint32_t i = 0; i < indexCount; i++)
+streampos Mesh::SkipChannel(InputStreamHelper& streamHelper, size_t elementSize, uint32_t& count)
+{
+	streamHelper >> count;
+
+	istream& stream = streamHelper.Stream();
+	const streampos position = stream.tellg();
+	stream.seekg(static_cast<streamoff>(count) * static_cast<streamoff>(elementSize), ios::cur);
+
+	return position;
+}
+
+bool Mesh::HasVertexChannel(uint32_t count, uint32_t vertexCount)
+{
+	if (count != 0 && count != vertexCount)
 	{
-		uint32_t index;
-		streamHelper >> index;
-		mData.Indices.push_back(index);
+		throw GameException("Mesh::Load(): a vertex channel's size doesn't match the mesh's vertex count.");
 	}
+
+	return (count > 0);
+}
+
+void Mesh::UpdateBounds()
+{
+	Span<const XMFLOAT3> vertices = mData.Vertices();
+	if (vertices.IsEmpty())
+	{
+		mBounds = BoundingSphere();
+		return;
+	}
+
+	BoundingSphere::CreateFromPoints(mBounds, vertices.Size(), vertices.Data(), sizeof(XMFLOAT3));
 }
\ No newline at end of file
@@ -2,9 +2,15 @@
 
 #include <string>
 #include <vector>
+#include <iosfwd>
 #include <cstdint>
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
 #include <d3d11_2.h>
+#include "RenderDevice.h"
+#include "MemoryResource.h"
+#include "Span.h"
+#include "MeshData.h"
 
 namespace Library
 {
@@ -14,34 +20,10 @@ namespace Library
 	class OutputStreamHelper;
 	class InputStreamHelper;
 
-	struct MeshData
-	{
-		std::shared_ptr<ModelMaterial> Material;
-		std::string Name;
-		std::vector<DirectX::XMFLOAT3> Vertices;
-		std::vector<DirectX::XMFLOAT3> Normals;
-		std::vector<DirectX::XMFLOAT3> Tangents;
-		std::vector<DirectX::XMFLOAT3> BiNormals;
-		std::vector<std::vector<DirectX::XMFLOAT3>*> TextureCoordinates;
-		std::vector<std::vector<DirectX::XMFLOAT4>*> VertexColors;
-		std::uint32_t FaceCount;
-		std::vector<std::uint32_t> Indices;
-
-		MeshData();
-		MeshData(const MeshData&) = delete;
-		MeshData& operator=(const MeshData&) = delete;
-		MeshData(MeshData&& rhs);
-		MeshData& operator=(MeshData&& rhs);
-		~MeshData();
-
-	private:
-		void Clear();
-	};
-
     class Mesh
     {
     public:
-		Mesh(Library::Model& model, InputStreamHelper& streamHelper);
+		Mesh(Library::Model& model, InputStreamHelper& streamHelper, MemoryResource& resource = MemoryResource::Heap());
 		Mesh(Library::Model& model, MeshData&& meshData);
 		Mesh(const Mesh&) = delete;
 		Mesh& operator=(const Mesh&) = delete;
@@ -52,22 +34,33 @@ namespace Library
         std::shared_ptr<ModelMaterial> GetMaterial();
         const std::string& Name() const;
 
-		const std::vector<DirectX::XMFLOAT3>& Vertices() const;
-		const std::vector<DirectX::XMFLOAT3>& Normals() const;
-		const std::vector<DirectX::XMFLOAT3>& Tangents() const;
-		const std::vector<DirectX::XMFLOAT3>& BiNormals() const;
-		const std::vector<std::vector<DirectX::XMFLOAT3>*>& TextureCoordinates() const;
-		const std::vector<std::vector<DirectX::XMFLOAT4>*>& VertexColors() const;
+		Span<const DirectX::XMFLOAT3> Vertices() const;
+		Span<const DirectX::XMFLOAT3> Normals() const;
+		Span<const DirectX::XMFLOAT3> Tangents() const;
+		Span<const DirectX::XMFLOAT3> BiNormals() const;
+		Span<const DirectX::XMFLOAT3> TextureCoordinates(std::uint32_t channel) const;
+		std::uint32_t TextureCoordinateChannelCount() const;
+		Span<const DirectX::XMFLOAT4> VertexColors(std::uint32_t channel) const;
+		std::uint32_t VertexColorChannelCount() const;
 		std::uint32_t FaceCount() const;
-		const std::vector<std::uint32_t>& Indices() const;
+		Span<const std::uint32_t> Indices() const;
+
+		// Object-space sphere enclosing every vertex.
+		const DirectX::BoundingSphere& Bounds() const;
 
         void CreateIndexBuffer(ID3D11Device& device, ID3D11Buffer** indexBuffer);
+		BufferHandle CreateIndexBuffer(RenderDevice& device) const;
 		void Save(OutputStreamHelper& streamHelper) const;
 
     private:
 		void Load(InputStreamHelper& streamHelper);
+		void UpdateBounds();
+
+		static std::streampos SkipChannel(InputStreamHelper& streamHelper, std::size_t elementSize, std::uint32_t& count);
+		static bool HasVertexChannel(std::uint32_t count, std::uint32_t vertexCount);
 
         Library::Model* mModel;
 		MeshData mData;
+		DirectX::BoundingSphere mBounds;
     };
 }
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "pch.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+#pragma region MeshLayout
+
+MeshLayout::MeshLayout() :
+	VertexCount(0), HasNormals(false), HasTangents(false), HasBiNormals(false),
+	TextureCoordinateChannelCount(0), VertexColorChannelCount(0), IndexCount(0)
+{
+}
+
+#pragma endregion
+
+#pragma region MeshData
+
+MeshData::MeshData(MemoryResource& resource) :
+	FaceCount(0), mResource(&resource)
+{
+	Reset();
+}
+
+MeshData::MeshData(const MeshLayout& layout, MemoryResource& resource) :
+	FaceCount(0), mResource(&resource)
+{
+	Reset();
+	Allocate(layout);
+}
+
+MeshData::MeshData(MeshData&& rhs) :
+	Material(move(rhs.Material)), Name(move(rhs.Name)), FaceCount(rhs.FaceCount),
+	mResource(rhs.mResource), mMemory(rhs.mMemory), mMemorySize(rhs.mMemorySize), mLayout(rhs.mLayout),
+	mVertices(rhs.mVertices), mNormals(rhs.mNormals), mTangents(rhs.mTangents), mBiNormals(rhs.mBiNormals), mIndices(rhs.mIndices)
+{
+	copy(begin(rhs.mTextureCoordinates), end(rhs.mTextureCoordinates), mTextureCoordinates);
+	copy(begin(rhs.mVertexColors), end(rhs.mVertexColors), mVertexColors);
+
+	rhs.FaceCount = 0U;
+	rhs.Reset();
+}
+
+MeshData& MeshData::operator=(MeshData&& rhs)
+{
+	if (this != &rhs)
+	{
+		Release();
+		Material = move(rhs.Material);
+		Name = move(rhs.Name);
+		FaceCount = rhs.FaceCount;
+
+		// The memory goes back to the resource it came from, so the resource moves with it
+		mResource = rhs.mResource;
+		mMemory = rhs.mMemory;
+		mMemorySize = rhs.mMemorySize;
+		mLayout = rhs.mLayout;
+		mVertices = rhs.mVertices;
+		mNormals = rhs.mNormals;
+		mTangents = rhs.mTangents;
+		mBiNormals = rhs.mBiNormals;
+		copy(begin(rhs.mTextureCoordinates), end(rhs.mTextureCoordinates), mTextureCoordinates);
+		copy(begin(rhs.mVertexColors), end(rhs.mVertexColors), mVertexColors);
+		mIndices = rhs.mIndices;
+
+		rhs.FaceCount = 0U;
+		rhs.Reset();
+	}
+
+	return *this;
+}
+
+MeshData::~MeshData()
+{
+	Release();
+}
+
+void MeshData::Allocate(const MeshLayout& layout)
+{
+	if (layout.TextureCoordinateChannelCount > MeshLayout::MaxTextureCoordinateChannels || layout.VertexColorChannelCount > MeshLayout::MaxVertexColorChannels)
+	{
+		throw GameException("MeshData::Allocate(): the mesh has too many texture coordinate or vertex color channels.");
+	}
+
+	Release();
+
+	// Every channel starts on a ChannelAlignment boundary
+	const size_t vector3ChannelBytes = AlignChannel(layout.VertexCount * sizeof(XMFLOAT3));
+	const size_t vector4ChannelBytes = AlignChannel(layout.VertexCount * sizeof(XMFLOAT4));
+	const size_t vector3ChannelCount = 1 + (layout.HasNormals ? 1 : 0) + (layout.HasTangents ? 1 : 0) + (layout.HasBiNormals ? 1 : 0) + layout.TextureCoordinateChannelCount;
+	const size_t memorySize = vector3ChannelCount * vector3ChannelBytes + layout.VertexColorChannelCount * vector4ChannelBytes + AlignChannel(layout.IndexCount * sizeof(uint32_t));
+
+	mLayout = layout;
+	if (memorySize == 0)
+	{
+		return;
+	}
+
+	mMemory = mResource->Allocate(memorySize, ChannelAlignment);
+	mMemorySize = memorySize;
+
+	unsigned char* position = static_cast<unsigned char*>(mMemory);
+	mVertices = TakeChannel<XMFLOAT3>(position, vector3ChannelBytes);
+	mNormals = (layout.HasNormals ? TakeChannel<XMFLOAT3>(position, vector3ChannelBytes) : nullptr);
+	mTangents = (layout.HasTangents ? TakeChannel<XMFLOAT3>(position, vector3ChannelBytes) : nullptr);
+	mBiNormals = (layout.HasBiNormals ? TakeChannel<XMFLOAT3>(position, vector3ChannelBytes) : nullptr);
+	for (uint32_t i = 0; i < layout.TextureCoordinateChannelCount; ++i)
+	{
+		mTextureCoordinates[i] = TakeChannel<XMFLOAT3>(position, vector3ChannelBytes);
+	}
+
+	for (uint32_t i = 0; i < layout.VertexColorChannelCount; ++i)
+	{
+		mVertexColors[i] = TakeChannel<XMFLOAT4>(position, vector4ChannelBytes);
+	}
+
+	mIndices = TakeChannel<uint32_t>(position, AlignChannel(layout.IndexCount * sizeof(uint32_t)));
+}
+
+const MeshLayout& MeshData::Layout() const
+{
+	return mLayout;
+}
+
+MemoryResource& MeshData::Resource() const
+{
+	return *mResource;
+}
+
+uint32_t MeshData::VertexCount() const
+{
+	return mLayout.VertexCount;
+}
+
+Span<XMFLOAT3> MeshData::Vertices()
+{
+	return Span<XMFLOAT3>(mVertices, mLayout.VertexCount);
+}
+
+Span<const XMFLOAT3> MeshData::Vertices() const
+{
+	return Span<const XMFLOAT3>(mVertices, mLayout.VertexCount);
+}
+
+Span<XMFLOAT3> MeshData::Normals()
+{
+	return Span<XMFLOAT3>(mNormals, mNormals != nullptr ? mLayout.VertexCount : 0);
+}
+
+Span<const XMFLOAT3> MeshData::Normals() const
+{
+	return Span<const XMFLOAT3>(mNormals, mNormals != nullptr ? mLayout.VertexCount : 0);
+}
+
+Span<XMFLOAT3> MeshData::Tangents()
+{
+	return Span<XMFLOAT3>(mTangents, mTangents != nullptr ? mLayout.VertexCount : 0);
+}
+
+Span<const XMFLOAT3> MeshData::Tangents() const
+{
+	return Span<const XMFLOAT3>(mTangents, mTangents != nullptr ? mLayout.VertexCount : 0);
+}
+
+Span<XMFLOAT3> MeshData::BiNormals()
+{
+	return Span<XMFLOAT3>(mBiNormals, mBiNormals != nullptr ? mLayout.VertexCount : 0);
+}
+
+Span<const XMFLOAT3> MeshData::BiNormals() const
+{
+	return Span<const XMFLOAT3>(mBiNormals, mBiNormals != nullptr ? mLayout.VertexCount : 0);
+}
+
+Span<XMFLOAT3> MeshData::TextureCoordinates(uint32_t channel)
+{
+	if (channel >= mLayout.TextureCoordinateChannelCount)
+	{
+		throw GameException("MeshData::TextureCoordinates(): the mesh has no such texture coordinate channel.");
+	}
+
+	return Span<XMFLOAT3>(mTextureCoordinates[channel], mLayout.VertexCount);
+}
+
+Span<const XMFLOAT3> MeshData::TextureCoordinates(uint32_t channel) const
+{
+	return const_cast<MeshData*>(this)->TextureCoordinates(channel);
+}
+
+Span<XMFLOAT4> MeshData::VertexColors(uint32_t channel)
+{
+	if (channel >= mLayout.VertexColorChannelCount)
+	{
+		throw GameException("MeshData::VertexColors(): the mesh has no such vertex color channel.");
+	}
+
+	return Span<XMFLOAT4>(mVertexColors[channel], mLayout.VertexCount);
+}
+
+Span<const XMFLOAT4> MeshData::VertexColors(uint32_t channel) const
+{
+	return const_cast<MeshData*>(this)->VertexColors(channel);
+}
+
+Span<uint32_t> MeshData::Indices()
+{
+	return Span<uint32_t>(mIndices, mLayout.IndexCount);
+}
+
+Span<const uint32_t> MeshData::Indices() const
+{
+	return Span<const uint32_t>(mIndices, mLayout.IndexCount);
+}
+
+void MeshData::Release()
+{
+	if (mMemory != nullptr)
+	{
+		mResource->Deallocate(mMemory, mMemorySize, ChannelAlignment);
+	}
+
+	Reset();
+}
+
+void MeshData::Reset()
+{
+	mMemory = nullptr;
+	mMemorySize = 0;
+	mLayout = MeshLayout();
+	mVertices = nullptr;
+	mNormals = nullptr;
+	mTangents = nullptr;
+	mBiNormals = nullptr;
+	fill(begin(mTextureCoordinates), end(mTextureCoordinates), nullptr);
+	fill(begin(mVertexColors), end(mVertexColors), nullptr);
+	mIndices = nullptr;
+}
+
+size_t MeshData::AlignChannel(size_t bytes)
+{
+	return (bytes + ChannelAlignment - 1) & ~(ChannelAlignment - 1);
+}
+
+template <typename T>
+T* MeshData::TakeChannel(unsigned char*& position, size_t bytes)
+{
+	T* channel = reinterpret_cast<T*>(position);
+	position += bytes;
+
+	return channel;
+}
+
+#pragma endregion
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <DirectXMath.h>
+#include "MemoryResource.h"
+#include "Span.h"
+
+namespace Library
+{
+	class ModelMaterial;
+
+	// Which channels a mesh has. Every channel other than the indices holds one element per vertex.
+	struct MeshLayout
+	{
+		static const std::uint32_t MaxTextureCoordinateChannels = 8;
+		static const std::uint32_t MaxVertexColorChannels = 8;
+
+		std::uint32_t VertexCount;
+		bool HasNormals;
+		bool HasTangents;
+		bool HasBiNormals;
+		std::uint32_t TextureCoordinateChannelCount;
+		std::uint32_t VertexColorChannelCount;
+		std::uint32_t IndexCount;
+
+		MeshLayout();
+	};
+
+	// A mesh's vertex channels and indices, all in one allocation from a MemoryResource, so a model loaded into an arena
+	// is freed with the arena. The channels are exposed as spans into that allocation; moving a MeshData moves the
+	// allocation, copying is not allowed.
+	class MeshData final
+	{
+	public:
+		std::shared_ptr<ModelMaterial> Material;
+		std::string Name;
+		std::uint32_t FaceCount;
+
+		explicit MeshData(MemoryResource& resource = MemoryResource::Heap());
+		MeshData(const MeshLayout& layout, MemoryResource& resource = MemoryResource::Heap());
+		MeshData(const MeshData&) = delete;
+		MeshData& operator=(const MeshData&) = delete;
+		MeshData(MeshData&& rhs);
+		MeshData& operator=(MeshData&& rhs);
+		~MeshData();
+
+		// Replaces the channels with uninitialized ones of the layout's sizes.
+		void Allocate(const MeshLayout& layout);
+
+		const MeshLayout& Layout() const;
+		MemoryResource& Resource() const;
+		std::uint32_t VertexCount() const;
+
+		// Empty when the mesh doesn't have the channel.
+		Span<DirectX::XMFLOAT3> Vertices();
+		Span<const DirectX::XMFLOAT3> Vertices() const;
+		Span<DirectX::XMFLOAT3> Normals();
+		Span<const DirectX::XMFLOAT3> Normals() const;
+		Span<DirectX::XMFLOAT3> Tangents();
+		Span<const DirectX::XMFLOAT3> Tangents() const;
+		Span<DirectX::XMFLOAT3> BiNormals();
+		Span<const DirectX::XMFLOAT3> BiNormals() const;
+
+		// Throw if the channel is out of range.
+		Span<DirectX::XMFLOAT3> TextureCoordinates(std::uint32_t channel);
+		Span<const DirectX::XMFLOAT3> TextureCoordinates(std::uint32_t channel) const;
+		Span<DirectX::XMFLOAT4> VertexColors(std::uint32_t channel);
+		Span<const DirectX::XMFLOAT4> VertexColors(std::uint32_t channel) const;
+
+		Span<std::uint32_t> Indices();
+		Span<const std::uint32_t> Indices() const;
+
+	private:
+		void Release();
+		void Reset();
+
+		static std::size_t AlignChannel(std::size_t bytes);
+
+		template <typename T>
+		static T* TakeChannel(unsigned char*& position, std::size_t bytes);
+
+		static const std::size_t ChannelAlignment = 16;
+
+		MemoryResource* mResource;
+		void* mMemory;
+		std::size_t mMemorySize;
+		MeshLayout mLayout;
+		DirectX::XMFLOAT3* mVertices;
+		DirectX::XMFLOAT3* mNormals;
+		DirectX::XMFLOAT3* mTangents;
+		DirectX::XMFLOAT3* mBiNormals;
+		DirectX::XMFLOAT3* mTextureCoordinates[MeshLayout::MaxTextureCoordinateChannels];
+		DirectX::XMFLOAT4* mVertexColors[MeshLayout::MaxVertexColorChannels];
+		std::uint32_t* mIndices;
+	};
+}
\ No newline at end of file
@@ -25,14 +25,14 @@ namespace Library
 
 #pragma endregion
 
-	Model::Model(const string& filename)
+	Model::Model(const string& filename, MemoryResource& resource)
 	{
-		Load(filename);
+		Load(filename, resource);
 	}
 
-	Model::Model(ifstream& file)
+	Model::Model(ifstream& file, MemoryResource& resource)
 	{
-		Load(file);
+		Load(file, resource);
 	}
 
 	Model::Model(ModelData&& modelData) :
@@ -110,7 +110,7 @@ namespace Library
 		}
 	}
 
-	void Model::Load(const string& filename)
+	void Model::Load(const string& filename, MemoryResource& resource)
 	{
 		ifstream file(filename.c_str(), ios::binary);
 		if (!file.good())
@@ -118,10 +118,10 @@ namespace Library
 			throw GameException("Could not open file.");
 		}
 
-		Load(file);
+		Load(file, resource);
 	}
 
-	void Model::Load(ifstream& file)
+	void Model::Load(ifstream& file, MemoryResource& resource)
 	{
 		InputStreamHelper streamHelper(file);
 
@@ -140,7 +140,7 @@ namespace Library
 		mData.Meshes.reserve(meshCount);
 		for (uint32_t i = 0; i < meshCount; i++)
 		{
-			mData.Meshes.push_back(make_shared<Mesh>(*this, streamHelper));
+			mData.Meshes.push_back(make_shared<Mesh>(*this, streamHelper, resource));
 		}
 	}
 }
\ No newline at end of file
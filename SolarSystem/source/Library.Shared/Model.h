@@ -4,6 +4,7 @@
 #include <map>
 #include <string>
 #include <fstream>
+#include "MemoryResource.h"
 
 namespace Library
 {
@@ -26,12 +27,14 @@ namespace Library
 		~ModelData() = default;
 	};
 
+	// Models loaded from a file take their meshes' vertex and index data from the given resource, e.g. a LinearArena,
+	// which must outlive the model.
     class Model
     {
     public:
 		Model() = default;
-		Model(const std::string& filename);
-		Model(std::ifstream& file);
+		Model(const std::string& filename, MemoryResource& resource = MemoryResource::Heap());
+		Model(std::ifstream& file, MemoryResource& resource = MemoryResource::Heap());
 		Model(ModelData&& modelData);
 		Model(Model&& rhs);
 		Model& operator=(Model&& rhs);
@@ -48,8 +51,8 @@ namespace Library
 		void Save(std::ofstream& file) const;
 
     private:
-		void Load(const std::string& filename);
-		void Load(std::ifstream& file);
+		void Load(const std::string& filename, MemoryResource& resource);
+		void Load(std::ifstream& file, MemoryResource& resource);
 
 		ModelData mData;
     };
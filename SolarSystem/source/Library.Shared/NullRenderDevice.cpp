@@ -0,0 +1,693 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	const uint32_t NullRenderDevice::MaxStoredErrors = 64;
+	const float NullRenderDevice::FontLineSpacing = 16.0f;
+	const int32_t NullRenderDevice::FontGlyphWidth = 8;
+
+	NullRenderDevice::Counters::Counters() :
+		CreateCount(0), DestroyCount(0), BufferUpdateCount(0), UploadedBytes(0), MapCount(0), PipelineStateChangeCount(0), BindingCount(0),
+		DrawCount(0), ElementCount(0), InstanceCount(0), GlyphCount(0)
+	{
+	}
+
+	NullRenderDevice::Buffer::Buffer(const BufferDescription& description) :
+		Description(description), Data(description.Usage == ResourceUsage::Dynamic ? description.ByteWidth : 0), IsMapped(false), IsAlive(true)
+	{
+	}
+
+	NullRenderDevice::NullRenderDevice() :
+		mLiveObjectCount(0), mPipelineState(), mVertexBuffers(), mIndexBuffer(), mIndexFormat(IndexFormat::UInt32), mIndexBufferOffset(0),
+		mCounters(), mIssuedCallCount(0), mValidationErrorCount(0)
+	{
+	}
+
+	const char* NullRenderDevice::Name() const
+	{
+		return "Null";
+	}
+
+	bool NullRenderDevice::SupportsConstantBufferOffsets() const
+	{
+		// Like Direct3D 11.1 hardware, so that callers take their ring buffer paths.
+		return true;
+	}
+
+	BufferHandle NullRenderDevice::CreateBuffer(const BufferDescription& description, const void* initialData)
+	{
+		if (description.ByteWidth == 0)
+		{
+			ReportError("CreateBuffer: the buffer is empty.");
+			return BufferHandle();
+		}
+
+		if (description.Type == BufferType::Constant && description.ByteWidth % 16 != 0)
+		{
+			ReportError("CreateBuffer: constant buffer sizes must be multiples of 16 bytes, not " + to_string(description.ByteWidth) + ".");
+			return BufferHandle();
+		}
+
+		if (description.Usage == ResourceUsage::Immutable && initialData == nullptr)
+		{
+			ReportError("CreateBuffer: immutable buffers need initial data.");
+			return BufferHandle();
+		}
+
+		mBuffers.emplace_back(description);
+		++mLiveObjectCount;
+		++mCounters.CreateCount;
+
+		return BufferHandle(static_cast<uint32_t>(mBuffers.size()));
+	}
+
+	TextureHandle NullRenderDevice::CreateTextureFromFile(const wstring& filename)
+	{
+		// The file is not read, so a missing texture only shows up on a real device.
+		if (filename.empty())
+		{
+			ReportError("CreateTextureFromFile: the filename is empty.");
+			return TextureHandle();
+		}
+
+		Texture texture = { true };
+		mTextures.push_back(texture);
+		++mLiveObjectCount;
+		++mCounters.CreateCount;
+
+		return TextureHandle(static_cast<uint32_t>(mTextures.size()));
+	}
+
+	TextureHandle NullRenderDevice::CreateTextureArrayFromFiles(const vector<wstring>& filenames, uint32_t width, uint32_t height)
+	{
+		if (filenames.empty() || width == 0 || height == 0)
+		{
+			ReportError("CreateTextureArrayFromFiles: the texture array is empty.");
+			return TextureHandle();
+		}
+
+		for (const wstring& filename : filenames)
+		{
+			if (filename.empty())
+			{
+				ReportError("CreateTextureArrayFromFiles: a filename is empty.");
+				return TextureHandle();
+			}
+		}
+
+		Texture texture = { true };
+		mTextures.push_back(texture);
+		++mLiveObjectCount;
+		++mCounters.CreateCount;
+
+		return TextureHandle(static_cast<uint32_t>(mTextures.size()));
+	}
+
+	ShaderHandle NullRenderDevice::CreateShader(ShaderStage stage, const vector<char>& bytecode)
+	{
+		if (bytecode.empty())
+		{
+			ReportError("CreateShader: the bytecode is empty.");
+			return ShaderHandle();
+		}
+
+		Shader shader = { stage, true };
+		mShaders.push_back(shader);
+		++mLiveObjectCount;
+		++mCounters.CreateCount;
+
+		return ShaderHandle(static_cast<uint32_t>(mShaders.size()));
+	}
+
+	PipelineStateHandle NullRenderDevice::CreatePipelineState(const PipelineStateDescription& description)
+	{
+		const Shader* vertexShader = Find(mShaders, description.VertexShader.Id, "vertex shader", "CreatePipelineState");
+		const Shader* pixelShader = Find(mShaders, description.PixelShader.Id, "pixel shader", "CreatePipelineState");
+		if (vertexShader == nullptr || pixelShader == nullptr)
+		{
+			return PipelineStateHandle();
+		}
+
+		if (vertexShader->Stage != ShaderStage::Vertex || pixelShader->Stage != ShaderStage::Pixel)
+		{
+			ReportError("CreatePipelineState: the shaders are bound to the wrong stages.");
+			return PipelineStateHandle();
+		}
+
+		PipelineState pipelineState = { 0, true };
+		for (const InputElement& element : description.InputElements)
+		{
+			if (element.Slot >= MaxVertexBuffers)
+			{
+				ReportError("CreatePipelineState: input element " + string(element.SemanticName) + " reads vertex buffer slot " + to_string(element.Slot) + ".");
+				return PipelineStateHandle();
+			}
+
+			pipelineState.VertexBufferSlots |= (1u << element.Slot);
+		}
+
+		mPipelineStates.push_back(pipelineState);
+		++mLiveObjectCount;
+		++mCounters.CreateCount;
+
+		return PipelineStateHandle(static_cast<uint32_t>(mPipelineStates.size()));
+	}
+
+	FontHandle NullRenderDevice::CreateFontFromFile(const wstring& filename)
+	{
+		if (filename.empty())
+		{
+			ReportError("CreateFontFromFile: the filename is empty.");
+			return FontHandle();
+		}
+
+		Font font = { true };
+		mFonts.push_back(font);
+		++mLiveObjectCount;
+		++mCounters.CreateCount;
+
+		return FontHandle(static_cast<uint32_t>(mFonts.size()));
+	}
+
+	float NullRenderDevice::LineSpacing(FontHandle font)
+	{
+		Find(mFonts, font.Id, "font", "LineSpacing");
+
+		return FontLineSpacing;
+	}
+
+	FontGlyph NullRenderDevice::Glyph(FontHandle font, wchar_t character)
+	{
+		Find(mFonts, font.Id, "font", "Glyph");
+
+		// Spaces have an empty rectangle and advance the pen by a cell, as in a sprite font.
+		int32_t width = (character == L' ' || character == L'\t' ? 0 : FontGlyphWidth);
+		FontGlyph glyph = { { 0, 0, width, static_cast<int32_t>(FontLineSpacing) }, 0.0f, 0.0f, static_cast<float>(FontGlyphWidth - width) };
+
+		return glyph;
+	}
+
+	void NullRenderDevice::Destroy(BufferHandle buffer)
+	{
+		DestroyObject(mBuffers, buffer.Id, "buffer");
+
+		// Ids are never reused, so a destroyed buffer's contents can go.
+		if (buffer.IsValid() && buffer.Id <= mBuffers.size() && mBuffers[buffer.Id - 1].IsAlive == false)
+		{
+			vector<char>().swap(mBuffers[buffer.Id - 1].Data);
+		}
+	}
+
+	void NullRenderDevice::Destroy(TextureHandle texture)
+	{
+		DestroyObject(mTextures, texture.Id, "texture");
+	}
+
+	void NullRenderDevice::Destroy(ShaderHandle shader)
+	{
+		DestroyObject(mShaders, shader.Id, "shader");
+	}
+
+	void NullRenderDevice::Destroy(PipelineStateHandle pipelineState)
+	{
+		DestroyObject(mPipelineStates, pipelineState.Id, "pipeline state");
+	}
+
+	void NullRenderDevice::Destroy(FontHandle font)
+	{
+		DestroyObject(mFonts, font.Id, "font");
+	}
+
+	CommandEncoder& NullRenderDevice::ImmediateEncoder()
+	{
+		return *this;
+	}
+
+	bool NullRenderDevice::SupportsDeferredEncoders() const
+	{
+		return false;
+	}
+
+	CommandEncoder& NullRenderDevice::BeginDeferred(uint32_t index)
+	{
+		ReportError("BeginDeferred: the null device has no deferred encoders (index " + to_string(index) + ").");
+
+		return *this;
+	}
+
+	void NullRenderDevice::ExecuteDeferred(uint32_t index)
+	{
+		ReportError("ExecuteDeferred: the null device has no deferred encoders (index " + to_string(index) + ").");
+	}
+
+	void NullRenderDevice::UpdateBuffer(BufferHandle buffer, const void* data, uint32_t size)
+	{
+		++mIssuedCallCount;
+
+		const Buffer* target = Find(mBuffers, buffer.Id, "buffer", "UpdateBuffer");
+		if (target == nullptr)
+		{
+			return;
+		}
+
+		if (target->Description.Usage == ResourceUsage::Immutable)
+		{
+			ReportError("UpdateBuffer: immutable buffers cannot be updated.");
+		}
+		else if (target->IsMapped)
+		{
+			ReportError("UpdateBuffer: the buffer is mapped.");
+		}
+		else if (data == nullptr || size == 0)
+		{
+			ReportError("UpdateBuffer: there is no data.");
+		}
+		else if (size > target->Description.ByteWidth)
+		{
+			ReportError("UpdateBuffer: " + to_string(size) + " bytes written to a buffer of " + to_string(target->Description.ByteWidth) + ".");
+		}
+		else
+		{
+			++mCounters.BufferUpdateCount;
+			mCounters.UploadedBytes += size;
+		}
+	}
+
+	void* NullRenderDevice::Map(BufferHandle buffer, MapMode mode)
+	{
+		UNREFERENCED_PARAMETER(mode);
+		++mIssuedCallCount;
+
+		if (Find(mBuffers, buffer.Id, "buffer", "Map") == nullptr)
+		{
+			return nullptr;
+		}
+
+		Buffer& target = mBuffers[buffer.Id - 1];
+		if (target.Description.Usage != ResourceUsage::Dynamic)
+		{
+			ReportError("Map: only dynamic buffers can be mapped.");
+			return nullptr;
+		}
+
+		if (target.IsMapped)
+		{
+			ReportError("Map: the buffer is already mapped.");
+			return nullptr;
+		}
+
+		target.IsMapped = true;
+		++mCounters.MapCount;
+
+		return target.Data.data();
+	}
+
+	void NullRenderDevice::Unmap(BufferHandle buffer)
+	{
+		++mIssuedCallCount;
+
+		if (Find(mBuffers, buffer.Id, "buffer", "Unmap") == nullptr)
+		{
+			return;
+		}
+
+		Buffer& target = mBuffers[buffer.Id - 1];
+		if (target.IsMapped == false)
+		{
+			ReportError("Unmap: the buffer is not mapped.");
+			return;
+		}
+
+		target.IsMapped = false;
+	}
+
+	void NullRenderDevice::SetPipelineState(PipelineStateHandle pipelineState)
+	{
+		++mIssuedCallCount;
+
+		if (Find(mPipelineStates, pipelineState.Id, "pipeline state", "SetPipelineState") != nullptr)
+		{
+			mPipelineState = pipelineState;
+			++mCounters.PipelineStateChangeCount;
+		}
+	}
+
+	void NullRenderDevice::SetVertexBuffer(uint32_t slot, BufferHandle buffer, uint32_t stride, uint32_t offset)
+	{
+		++mIssuedCallCount;
+
+		const Buffer* vertexBuffer = Find(mBuffers, buffer.Id, "vertex buffer", "SetVertexBuffer");
+		if (vertexBuffer == nullptr)
+		{
+			return;
+		}
+
+		if (slot >= MaxVertexBuffers)
+		{
+			ReportError("SetVertexBuffer: slot " + to_string(slot) + " is out of range.");
+		}
+		else if (vertexBuffer->Description.Type != BufferType::Vertex)
+		{
+			ReportError("SetVertexBuffer: the buffer was not created as a vertex buffer.");
+		}
+		else if (stride == 0 || offset >= vertexBuffer->Description.ByteWidth)
+		{
+			ReportError("SetVertexBuffer: stride " + to_string(stride) + " and offset " + to_string(offset) + " do not fit the buffer.");
+		}
+		else
+		{
+			mVertexBuffers[slot] = buffer;
+			++mCounters.BindingCount;
+		}
+	}
+
+	void NullRenderDevice::SetIndexBuffer(BufferHandle buffer, IndexFormat format, uint32_t offset)
+	{
+		++mIssuedCallCount;
+
+		const Buffer* indexBuffer = Find(mBuffers, buffer.Id, "index buffer", "SetIndexBuffer");
+		if (indexBuffer == nullptr)
+		{
+			return;
+		}
+
+		if (indexBuffer->Description.Type != BufferType::Index)
+		{
+			ReportError("SetIndexBuffer: the buffer was not created as an index buffer.");
+		}
+		else
+		{
+			mIndexBuffer = buffer;
+			mIndexFormat = format;
+			mIndexBufferOffset = offset;
+			++mCounters.BindingCount;
+		}
+	}
+
+	void NullRenderDevice::SetConstantBuffer(ShaderStage stage, uint32_t slot, BufferHandle buffer)
+	{
+		UNREFERENCED_PARAMETER(stage);
+		++mIssuedCallCount;
+
+		const Buffer* constantBuffer = Find(mBuffers, buffer.Id, "constant buffer", "SetConstantBuffer");
+		if (constantBuffer == nullptr)
+		{
+			return;
+		}
+
+		if (slot >= MaxConstantBuffers)
+		{
+			ReportError("SetConstantBuffer: slot " + to_string(slot) + " is out of range.");
+		}
+		else if (constantBuffer->Description.Type != BufferType::Constant)
+		{
+			ReportError("SetConstantBuffer: the buffer was not created as a constant buffer.");
+		}
+		else
+		{
+			++mCounters.BindingCount;
+		}
+	}
+
+	void NullRenderDevice::SetConstantBufferRange(ShaderStage stage, uint32_t slot, BufferHandle buffer, uint32_t firstConstant, uint32_t constantCount)
+	{
+		UNREFERENCED_PARAMETER(stage);
+		++mIssuedCallCount;
+
+		const Buffer* constantBuffer = Find(mBuffers, buffer.Id, "constant buffer", "SetConstantBufferRange");
+		if (constantBuffer == nullptr)
+		{
+			return;
+		}
+
+		// Direct3D 11.1 binds at most 4096 constants, in multiples of 16.
+		if (slot >= MaxConstantBuffers)
+		{
+			ReportError("SetConstantBufferRange: slot " + to_string(slot) + " is out of range.");
+		}
+		else if (constantBuffer->Description.Type != BufferType::Constant)
+		{
+			ReportError("SetConstantBufferRange: the buffer was not created as a constant buffer.");
+		}
+		else if (firstConstant % 16 != 0 || constantCount % 16 != 0 || constantCount == 0 || constantCount > 4096)
+		{
+			ReportError("SetConstantBufferRange: " + to_string(constantCount) + " constants from " + to_string(firstConstant) + " are not multiples of 16 within 4096.");
+		}
+		else if ((static_cast<uint64_t>(firstConstant) + constantCount) * 16 > constantBuffer->Description.ByteWidth)
+		{
+			ReportError("SetConstantBufferRange: constants " + to_string(firstConstant) + " to " + to_string(firstConstant + constantCount) + " run past the end of the buffer.");
+		}
+		else
+		{
+			++mCounters.BindingCount;
+		}
+	}
+
+	void NullRenderDevice::SetTexture(ShaderStage stage, uint32_t slot, TextureHandle texture)
+	{
+		UNREFERENCED_PARAMETER(stage);
+		++mIssuedCallCount;
+
+		// A null handle unbinds the slot.
+		if (texture.IsValid() && Find(mTextures, texture.Id, "texture", "SetTexture") == nullptr)
+		{
+			return;
+		}
+
+		if (slot >= MaxTextures)
+		{
+			ReportError("SetTexture: slot " + to_string(slot) + " is out of range.");
+		}
+		else
+		{
+			++mCounters.BindingCount;
+		}
+	}
+
+	void NullRenderDevice::Draw(uint32_t vertexCount, uint32_t startVertex)
+	{
+		UNREFERENCED_PARAMETER(startVertex);
+		++mIssuedCallCount;
+
+		if (ValidateDraw("Draw", false, 0, 0))
+		{
+			++mCounters.DrawCount;
+			mCounters.ElementCount += vertexCount;
+			++mCounters.InstanceCount;
+		}
+	}
+
+	void NullRenderDevice::DrawInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance)
+	{
+		UNREFERENCED_PARAMETER(startVertex);
+		UNREFERENCED_PARAMETER(startInstance);
+		++mIssuedCallCount;
+
+		if (ValidateDraw("DrawInstanced", false, 0, 0))
+		{
+			++mCounters.DrawCount;
+			mCounters.ElementCount += static_cast<uint64_t>(vertexCount) * instanceCount;
+			mCounters.InstanceCount += instanceCount;
+		}
+	}
+
+	void NullRenderDevice::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+	{
+		UNREFERENCED_PARAMETER(baseVertex);
+		++mIssuedCallCount;
+
+		if (ValidateDraw("DrawIndexed", true, indexCount, startIndex))
+		{
+			++mCounters.DrawCount;
+			mCounters.ElementCount += indexCount;
+			++mCounters.InstanceCount;
+		}
+	}
+
+	void NullRenderDevice::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+	{
+		UNREFERENCED_PARAMETER(baseVertex);
+		UNREFERENCED_PARAMETER(startInstance);
+		++mIssuedCallCount;
+
+		if (ValidateDraw("DrawIndexedInstanced", true, indexCount, startIndex))
+		{
+			++mCounters.DrawCount;
+			mCounters.ElementCount += static_cast<uint64_t>(indexCount) * instanceCount;
+			mCounters.InstanceCount += instanceCount;
+		}
+	}
+
+	void NullRenderDevice::DrawGlyphs(FontHandle font, const GlyphSprite* glyphs, uint32_t count)
+	{
+		++mIssuedCallCount;
+
+		// Whatever drew the text leaves nothing bound, so a caller relying on earlier bindings fails here as it would on a GPU.
+		ResetBindings();
+
+		if (Find(mFonts, font.Id, "font", "DrawGlyphs") == nullptr)
+		{
+			return;
+		}
+
+		if (count > 0 && glyphs == nullptr)
+		{
+			ReportError("DrawGlyphs: there are no glyphs.");
+			return;
+		}
+
+		++mCounters.DrawCount;
+		mCounters.GlyphCount += count;
+	}
+
+	uint32_t NullRenderDevice::IssuedCallCount() const
+	{
+		return mIssuedCallCount;
+	}
+
+	uint32_t NullRenderDevice::FilteredCallCount() const
+	{
+		return 0;
+	}
+
+	const NullRenderDevice::Counters& NullRenderDevice::FrameCounters() const
+	{
+		return mCounters;
+	}
+
+	void NullRenderDevice::ResetCounters()
+	{
+		mCounters = Counters();
+	}
+
+	uint32_t NullRenderDevice::LiveObjectCount() const
+	{
+		return mLiveObjectCount;
+	}
+
+	uint32_t NullRenderDevice::ValidationErrorCount() const
+	{
+		return mValidationErrorCount;
+	}
+
+	const vector<string>& NullRenderDevice::ValidationErrors() const
+	{
+		return mValidationErrors;
+	}
+
+	void NullRenderDevice::ClearValidationErrors()
+	{
+		mValidationErrorCount = 0;
+		mValidationErrors.clear();
+	}
+
+	template <typename T>
+	const T* NullRenderDevice::Find(const vector<T>& objects, uint32_t id, const char* typeName, const char* call)
+	{
+		if (id == 0)
+		{
+			ReportError(string(call) + ": null " + typeName + " handle.");
+			return nullptr;
+		}
+
+		if (id > objects.size() || objects[id - 1].IsAlive == false)
+		{
+			ReportError(string(call) + ": " + typeName + " " + to_string(id) + " does not exist or was destroyed.");
+			return nullptr;
+		}
+
+		return &objects[id - 1];
+	}
+
+	template <typename T>
+	void NullRenderDevice::DestroyObject(vector<T>& objects, uint32_t id, const char* typeName)
+	{
+		if (id == 0)
+		{
+			return;
+		}
+
+		if (Find(objects, id, typeName, "Destroy") != nullptr)
+		{
+			objects[id - 1].IsAlive = false;
+			--mLiveObjectCount;
+			++mCounters.DestroyCount;
+		}
+	}
+
+	bool NullRenderDevice::ValidateDraw(const char* call, bool isIndexed, uint32_t indexCount, uint32_t startIndex)
+	{
+		const PipelineState* pipelineState = Find(mPipelineStates, mPipelineState.Id, "pipeline state", call);
+		if (pipelineState == nullptr)
+		{
+			return false;
+		}
+
+		for (uint32_t slot = 0; slot < MaxVertexBuffers; ++slot)
+		{
+			if ((pipelineState->VertexBufferSlots & (1u << slot)) == 0)
+			{
+				continue;
+			}
+
+			if (mVertexBuffers[slot].IsValid() == false)
+			{
+				ReportError(string(call) + ": the pipeline state reads vertex buffer slot " + to_string(slot) + ", which is not bound.");
+				return false;
+			}
+
+			const Buffer* vertexBuffer = Find(mBuffers, mVertexBuffers[slot].Id, "vertex buffer", call);
+			if (vertexBuffer == nullptr)
+			{
+				return false;
+			}
+
+			if (vertexBuffer->IsMapped)
+			{
+				ReportError(string(call) + ": the vertex buffer in slot " + to_string(slot) + " is still mapped.");
+				return false;
+			}
+		}
+
+		if (isIndexed)
+		{
+			const Buffer* indexBuffer = Find(mBuffers, mIndexBuffer.Id, "index buffer", call);
+			if (indexBuffer == nullptr)
+			{
+				return false;
+			}
+
+			uint64_t indexSize = (mIndexFormat == IndexFormat::UInt16 ? 2 : 4);
+			uint64_t end = mIndexBufferOffset + (static_cast<uint64_t>(startIndex) + indexCount) * indexSize;
+			if (end > indexBuffer->Description.ByteWidth)
+			{
+				ReportError(string(call) + ": indices " + to_string(startIndex) + " to " + to_string(startIndex + indexCount) + " run past the end of the index buffer.");
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void NullRenderDevice::ResetBindings()
+	{
+		mPipelineState = PipelineStateHandle();
+		for (BufferHandle& vertexBuffer : mVertexBuffers)
+		{
+			vertexBuffer = BufferHandle();
+		}
+
+		mIndexBuffer = BufferHandle();
+	}
+
+	void NullRenderDevice::ReportError(const string& message)
+	{
+		++mValidationErrorCount;
+		if (mValidationErrors.size() < MaxStoredErrors)
+		{
+			mValidationErrors.push_back(message);
+		}
+	}
+}
\ No newline at end of file
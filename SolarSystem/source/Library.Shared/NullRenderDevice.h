@@ -0,0 +1,167 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "RenderDevice.h"
+
+namespace Library
+{
+	// A render device that renders nothing. It checks every call the way the Direct3D debug layer would (live handles, matching
+	// stages, bound state at draw time, buffer ranges, mapping) and counts the work it was given, so engine CPU cost can be measured
+	// and scenes run without a GPU. Errors are recorded rather than thrown, and the implementation uses only the standard library.
+	// Files are never read: textures and fonts only check their filenames, and every font is a fixed-width stand-in.
+	class NullRenderDevice final : public RenderDevice, public CommandEncoder
+	{
+	public:
+		// Work submitted since the last ResetCounters().
+		struct Counters
+		{
+			std::uint32_t CreateCount;
+			std::uint32_t DestroyCount;
+			std::uint32_t BufferUpdateCount;
+			std::uint64_t UploadedBytes;
+			std::uint32_t MapCount;
+			std::uint32_t PipelineStateChangeCount;
+			std::uint32_t BindingCount;
+			std::uint32_t DrawCount;
+			std::uint64_t ElementCount;
+			std::uint64_t InstanceCount;
+			std::uint64_t GlyphCount;
+
+			Counters();
+		};
+
+		NullRenderDevice();
+		NullRenderDevice(const NullRenderDevice&) = delete;
+		NullRenderDevice& operator=(const NullRenderDevice&) = delete;
+		NullRenderDevice(NullRenderDevice&&) = delete;
+		NullRenderDevice& operator=(NullRenderDevice&&) = delete;
+		~NullRenderDevice() = default;
+
+		virtual const char* Name() const override;
+		virtual bool SupportsConstantBufferOffsets() const override;
+
+		virtual BufferHandle CreateBuffer(const BufferDescription& description, const void* initialData) override;
+		virtual TextureHandle CreateTextureFromFile(const std::wstring& filename) override;
+		virtual TextureHandle CreateTextureArrayFromFiles(const std::vector<std::wstring>& filenames, std::uint32_t width, std::uint32_t height) override;
+		virtual ShaderHandle CreateShader(ShaderStage stage, const std::vector<char>& bytecode) override;
+		virtual PipelineStateHandle CreatePipelineState(const PipelineStateDescription& description) override;
+		virtual FontHandle CreateFontFromFile(const std::wstring& filename) override;
+		virtual float LineSpacing(FontHandle font) override;
+		virtual FontGlyph Glyph(FontHandle font, wchar_t character) override;
+
+		virtual void Destroy(BufferHandle buffer) override;
+		virtual void Destroy(TextureHandle texture) override;
+		virtual void Destroy(ShaderHandle shader) override;
+		virtual void Destroy(PipelineStateHandle pipelineState) override;
+		virtual void Destroy(FontHandle font) override;
+
+		virtual CommandEncoder& ImmediateEncoder() override;
+		virtual bool SupportsDeferredEncoders() const override;
+		virtual CommandEncoder& BeginDeferred(std::uint32_t index) override;
+		virtual void ExecuteDeferred(std::uint32_t index) override;
+
+		virtual void UpdateBuffer(BufferHandle buffer, const void* data, std::uint32_t size) override;
+		virtual void* Map(BufferHandle buffer, MapMode mode) override;
+		virtual void Unmap(BufferHandle buffer) override;
+
+		virtual void SetPipelineState(PipelineStateHandle pipelineState) override;
+		virtual void SetVertexBuffer(std::uint32_t slot, BufferHandle buffer, std::uint32_t stride, std::uint32_t offset) override;
+		virtual void SetIndexBuffer(BufferHandle buffer, IndexFormat format, std::uint32_t offset) override;
+		virtual void SetConstantBuffer(ShaderStage stage, std::uint32_t slot, BufferHandle buffer) override;
+		virtual void SetConstantBufferRange(ShaderStage stage, std::uint32_t slot, BufferHandle buffer, std::uint32_t firstConstant, std::uint32_t constantCount) override;
+		virtual void SetTexture(ShaderStage stage, std::uint32_t slot, TextureHandle texture) override;
+
+		virtual void Draw(std::uint32_t vertexCount, std::uint32_t startVertex) override;
+		virtual void DrawInstanced(std::uint32_t vertexCount, std::uint32_t instanceCount, std::uint32_t startVertex, std::uint32_t startInstance) override;
+		virtual void DrawIndexed(std::uint32_t indexCount, std::uint32_t startIndex, std::int32_t baseVertex) override;
+		virtual void DrawIndexedInstanced(std::uint32_t indexCount, std::uint32_t instanceCount, std::uint32_t startIndex, std::int32_t baseVertex, std::uint32_t startInstance) override;
+		virtual void DrawGlyphs(FontHandle font, const GlyphSprite* glyphs, std::uint32_t count) override;
+
+		// Every encoder call is issued; nothing is filtered.
+		virtual std::uint32_t IssuedCallCount() const override;
+		virtual std::uint32_t FilteredCallCount() const override;
+
+		const Counters& FrameCounters() const;
+		void ResetCounters();
+
+		std::uint32_t LiveObjectCount() const;
+
+		// Every error is counted, but only the first MaxStoredErrors messages are kept.
+		std::uint32_t ValidationErrorCount() const;
+		const std::vector<std::string>& ValidationErrors() const;
+		void ClearValidationErrors();
+
+		static const std::uint32_t MaxStoredErrors;
+
+		// The stand-in font's metrics: every visible character is one GlyphWidth x LineSpacing cell.
+		static const float FontLineSpacing;
+		static const std::int32_t FontGlyphWidth;
+
+	private:
+		// Dynamic buffers keep their contents, so mapped memory can be written.
+		struct Buffer
+		{
+			BufferDescription Description;
+			std::vector<char> Data;
+			bool IsMapped;
+			bool IsAlive;
+
+			Buffer(const BufferDescription& description);
+		};
+
+		struct Texture
+		{
+			bool IsAlive;
+		};
+
+		struct Shader
+		{
+			ShaderStage Stage;
+			bool IsAlive;
+		};
+
+		struct PipelineState
+		{
+			// Bit i is set when an input element reads vertex buffer slot i.
+			std::uint32_t VertexBufferSlots;
+			bool IsAlive;
+		};
+
+		struct Font
+		{
+			bool IsAlive;
+		};
+
+		// Returns the live object behind a handle, or reports the error and returns null.
+		template <typename T>
+		const T* Find(const std::vector<T>& objects, std::uint32_t id, const char* typeName, const char* call);
+
+		template <typename T>
+		void DestroyObject(std::vector<T>& objects, std::uint32_t id, const char* typeName);
+
+		// Checks the state every draw needs; indexed draws also check the index range against the bound index buffer.
+		bool ValidateDraw(const char* call, bool isIndexed, std::uint32_t indexCount, std::uint32_t startIndex);
+		void ResetBindings();
+		void ReportError(const std::string& message);
+
+		std::vector<Buffer> mBuffers;
+		std::vector<Texture> mTextures;
+		std::vector<Shader> mShaders;
+		std::vector<PipelineState> mPipelineStates;
+		std::vector<Font> mFonts;
+		std::uint32_t mLiveObjectCount;
+
+		PipelineStateHandle mPipelineState;
+		BufferHandle mVertexBuffers[MaxVertexBuffers];
+		BufferHandle mIndexBuffer;
+		IndexFormat mIndexFormat;
+		std::uint32_t mIndexBufferOffset;
+
+		Counters mCounters;
+		std::uint32_t mIssuedCallCount;
+		std::uint32_t mValidationErrorCount;
+		std::vector<std::string> mValidationErrors;
+	};
+}
\ No newline at end of file
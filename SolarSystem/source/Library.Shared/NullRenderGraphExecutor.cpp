@@ -0,0 +1,51 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	const NullRenderGraphExecutor::Counters& NullRenderGraphExecutor::ExecutionCounters() const
+	{
+		return mCounters;
+	}
+
+	void NullRenderGraphExecutor::ResetCounters()
+	{
+		mCounters = Counters();
+	}
+
+	void NullRenderGraphExecutor::PreparePhysicalTextures(const vector<TextureDescription>& physicalTextures)
+	{
+		mCounters.PhysicalTextureCount = static_cast<uint32_t>(physicalTextures.size());
+	}
+
+	void NullRenderGraphExecutor::ApplyBarrier(const RenderGraph& graph, const RenderGraphBarrier& barrier)
+	{
+		UNREFERENCED_PARAMETER(graph);
+		UNREFERENCED_PARAMETER(barrier);
+
+		++mCounters.BarrierCount;
+	}
+
+	void NullRenderGraphExecutor::Clear(const RenderGraph& graph, RenderGraphResource resource)
+	{
+		UNREFERENCED_PARAMETER(graph);
+		UNREFERENCED_PARAMETER(resource);
+
+		++mCounters.ClearCount;
+	}
+
+	void NullRenderGraphExecutor::BeginPass(const RenderGraph& graph, uint32_t pass)
+	{
+		UNREFERENCED_PARAMETER(graph);
+		UNREFERENCED_PARAMETER(pass);
+
+		++mCounters.PassCount;
+	}
+
+	void NullRenderGraphExecutor::EndPass(const RenderGraph& graph, uint32_t pass)
+	{
+		UNREFERENCED_PARAMETER(graph);
+		UNREFERENCED_PARAMETER(pass);
+	}
+}
\ No newline at end of file
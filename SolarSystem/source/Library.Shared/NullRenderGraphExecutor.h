@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "RenderGraph.h"
+
+namespace Library
+{
+	// Runs render graphs without a GPU, for the null render device. Pass callbacks still run; the executor only counts what a
+	// real backend would have done, so the graph's culling and aliasing can be checked headless.
+	class NullRenderGraphExecutor final : public RenderGraphExecutor
+	{
+	public:
+		struct Counters
+		{
+			std::uint32_t PhysicalTextureCount;
+			std::uint32_t BarrierCount;
+			std::uint32_t ClearCount;
+			std::uint32_t PassCount;
+
+			Counters() :
+				PhysicalTextureCount(0), BarrierCount(0), ClearCount(0), PassCount(0) { }
+		};
+
+		NullRenderGraphExecutor() = default;
+		NullRenderGraphExecutor(const NullRenderGraphExecutor&) = delete;
+		NullRenderGraphExecutor& operator=(const NullRenderGraphExecutor&) = delete;
+		NullRenderGraphExecutor(NullRenderGraphExecutor&&) = delete;
+		NullRenderGraphExecutor& operator=(NullRenderGraphExecutor&&) = delete;
+		~NullRenderGraphExecutor() = default;
+
+		// Totals since construction or the last ResetCounters(); PhysicalTextureCount is the size of the last pool.
+		const Counters& ExecutionCounters() const;
+		void ResetCounters();
+
+		virtual void PreparePhysicalTextures(const std::vector<TextureDescription>& physicalTextures) override;
+		virtual void ApplyBarrier(const RenderGraph& graph, const RenderGraphBarrier& barrier) override;
+		virtual void Clear(const RenderGraph& graph, RenderGraphResource resource) override;
+		virtual void BeginPass(const RenderGraph& graph, std::uint32_t pass) override;
+		virtual void EndPass(const RenderGraph& graph, std::uint32_t pass) override;
+
+	private:
+		Counters mCounters;
+	};
+}
\ No newline at end of file
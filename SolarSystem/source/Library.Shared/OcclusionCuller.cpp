@@ -0,0 +1,454 @@
+#include "pch.h"
+#include <immintrin.h>
+#include <cfloat>
+#include <cmath>
+#include <chrono>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace Library
+{
+	const uint32_t OcclusionCuller::DefaultWidth = 256;
+	const uint32_t OcclusionCuller::DefaultHeight = 128;
+	const uint32_t OcclusionCuller::TileHeight = 8;
+	const float OcclusionCuller::MinOccluderRadius = 4.0f;
+	const uint32_t OcclusionCuller::SphereSlices = 12;
+	const uint32_t OcclusionCuller::SphereStacks = 8;
+	const float OcclusionCuller::MinW = 1e-4f;
+
+	OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height) :
+		mWidth(width), mHeight(height), mDepthBuffer(width * height, FLT_MAX), mOccluderCount(0), mRasterizationMicroseconds(0.0)
+	{
+		// Rows are rasterized four pixels at a time.
+		assert(width > 0 && width % 4 == 0);
+		assert(height > 0);
+
+		for (float& element : mViewProjection)
+		{
+			element = 0.0f;
+		}
+
+		CreateUnitSphere();
+	}
+
+	void OcclusionCuller::BeginFrame(const float* viewProjection)
+	{
+		assert(viewProjection != nullptr);
+
+		memcpy(mViewProjection, viewProjection, sizeof(mViewProjection));
+		mTriangles.clear();
+		mOccluderCount = 0;
+	}
+
+	void OcclusionCuller::AddSphereOccluder(float x, float y, float z, float radius)
+	{
+		// The nearest point of the sphere must be in front of the camera.
+		const float* m = mViewProjection;
+		float w = x * m[3] + y * m[7] + z * m[11] + m[15];
+		float wScale = sqrtf(m[3] * m[3] + m[7] * m[7] + m[11] * m[11]);
+		if (radius <= 0.0f || w - radius * wScale <= MinW)
+		{
+			return;
+		}
+
+		// The tessellated sphere is inscribed in the real one, so it never covers pixels the body does not.
+		uint32_t vertexCount = static_cast<uint32_t>(mUnitSpherePositions.size() / 3);
+		mScratchPositions.resize(mUnitSpherePositions.size());
+
+		float minX = FLT_MAX;
+		float maxX = -FLT_MAX;
+		float minY = FLT_MAX;
+		float maxY = -FLT_MAX;
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			float* position = &mScratchPositions[i * 3];
+			position[0] = x + mUnitSpherePositions[i * 3] * radius;
+			position[1] = y + mUnitSpherePositions[i * 3 + 1] * radius;
+			position[2] = z + mUnitSpherePositions[i * 3 + 2] * radius;
+
+			float screenX;
+			float screenY;
+			float depth;
+			if (Project(position[0], position[1], position[2], screenX, screenY, depth))
+			{
+				minX = (screenX < minX ? screenX : minX);
+				maxX = (screenX > maxX ? screenX : maxX);
+				minY = (screenY < minY ? screenY : minY);
+				maxY = (screenY > maxY ? screenY : maxY);
+			}
+		}
+
+		if (maxX - minX < MinOccluderRadius * 2.0f && maxY - minY < MinOccluderRadius * 2.0f)
+		{
+			return;
+		}
+
+		const uint32_t* indices = mUnitSphereIndices.data();
+		for (uint32_t i = 0; i < mUnitSphereIndices.size(); i += 3)
+		{
+			AddTriangle(&mScratchPositions[indices[i] * 3], &mScratchPositions[indices[i + 1] * 3], &mScratchPositions[indices[i + 2] * 3]);
+		}
+
+		++mOccluderCount;
+	}
+
+	void OcclusionCuller::AddOccluder(const float* positions, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+	{
+		assert(positions != nullptr && indices != nullptr);
+		assert(indexCount % 3 == 0);
+		UNREFERENCED_PARAMETER(vertexCount);
+
+		for (uint32_t i = 0; i < indexCount; i += 3)
+		{
+			assert(indices[i] < vertexCount && indices[i + 1] < vertexCount && indices[i + 2] < vertexCount);
+			AddTriangle(&positions[indices[i] * 3], &positions[indices[i + 1] * 3], &positions[indices[i + 2] * 3]);
+		}
+
+		++mOccluderCount;
+	}
+
+	void OcclusionCuller::RasterizeOccluders(ThreadPool* workers)
+	{
+		high_resolution_clock::time_point startTime = high_resolution_clock::now();
+
+		fill(mDepthBuffer.begin(), mDepthBuffer.end(), FLT_MAX);
+
+		// Each task owns a contiguous run of tiles, so no two tasks write the same row.
+		uint32_t tileCount = (mHeight + TileHeight - 1) / TileHeight;
+		uint32_t taskCount = 1;
+		if (workers != nullptr && mTriangles.empty() == false)
+		{
+			taskCount = workers->ThreadCount() + 1;
+			taskCount = (taskCount < tileCount ? taskCount : tileCount);
+		}
+
+		vector<future<void>> tasks;
+		tasks.reserve(taskCount - 1);
+		for (uint32_t task = 1; task < taskCount; ++task)
+		{
+			uint32_t firstRow = (tileCount * task / taskCount) * TileHeight;
+			uint32_t lastRow = (tileCount * (task + 1) / taskCount) * TileHeight;
+			lastRow = (lastRow < mHeight ? lastRow : mHeight);
+			tasks.push_back(workers->Enqueue([this, firstRow, lastRow]()
+			{
+				RasterizeRows(firstRow, lastRow);
+			}));
+		}
+
+		uint32_t lastRow = (tileCount / taskCount) * TileHeight;
+		RasterizeRows(0, (lastRow < mHeight ? lastRow : mHeight));
+
+		for (future<void>& task : tasks)
+		{
+			task.get();
+		}
+
+		mRasterizationMicroseconds = duration<double, micro>(high_resolution_clock::now() - startTime).count();
+	}
+
+	bool OcclusionCuller::IsOccluded(float x, float y, float z, float radius) const
+	{
+		if (radius < 0.0f || radius >= FLT_MAX)
+		{
+			return false;
+		}
+
+		// Screen rectangle and nearest depth of the bounding box corners
+		float minX = FLT_MAX;
+		float maxX = -FLT_MAX;
+		float minY = FLT_MAX;
+		float maxY = -FLT_MAX;
+		float minDepth = FLT_MAX;
+		for (uint32_t corner = 0; corner < 8; ++corner)
+		{
+			float screenX;
+			float screenY;
+			float depth;
+			if (Project((corner & 1 ? x + radius : x - radius), (corner & 2 ? y + radius : y - radius), (corner & 4 ? z + radius : z - radius), screenX, screenY, depth) == false)
+			{
+				return false;
+			}
+
+			minX = (screenX < minX ? screenX : minX);
+			maxX = (screenX > maxX ? screenX : maxX);
+			minY = (screenY < minY ? screenY : minY);
+			maxY = (screenY > maxY ? screenY : maxY);
+			minDepth = (depth < minDepth ? depth : minDepth);
+		}
+
+		if (minDepth < 0.0f || maxX < 0.0f || maxY < 0.0f || minX > static_cast<float>(mWidth) || minY > static_cast<float>(mHeight))
+		{
+			return false;
+		}
+
+		// Occluders are sampled at pixel centres, so grow the rectangle by a pixel to stay conservative along their edges.
+		int32_t firstColumn = static_cast<int32_t>(floorf(minX)) - 1;
+		int32_t lastColumn = static_cast<int32_t>(ceilf(maxX));
+		int32_t firstRow = static_cast<int32_t>(floorf(minY)) - 1;
+		int32_t lastRow = static_cast<int32_t>(ceilf(maxY));
+		firstColumn = (firstColumn > 0 ? firstColumn : 0);
+		firstRow = (firstRow > 0 ? firstRow : 0);
+		lastColumn = (lastColumn < static_cast<int32_t>(mWidth) - 1 ? lastColumn : static_cast<int32_t>(mWidth) - 1);
+		lastRow = (lastRow < static_cast<int32_t>(mHeight) - 1 ? lastRow : static_cast<int32_t>(mHeight) - 1);
+
+		__m128 objectDepth = _mm_set1_ps(minDepth);
+		for (int32_t row = firstRow; row <= lastRow; ++row)
+		{
+			const float* depthRow = &mDepthBuffer[row * mWidth];
+
+			int32_t column = firstColumn;
+			for (; column + 3 <= lastColumn; column += 4)
+			{
+				if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(depthRow + column), objectDepth)) != 0)
+				{
+					return false;
+				}
+			}
+
+			for (; column <= lastColumn; ++column)
+			{
+				if (depthRow[column] >= minDepth)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	uint32_t OcclusionCuller::Cull(const BoundingSphereSet& spheres, uint8_t* visibility) const
+	{
+		assert(visibility != nullptr || spheres.Size() == 0);
+
+		if (mOccluderCount == 0)
+		{
+			return 0;
+		}
+
+		const float* x = spheres.X();
+		const float* y = spheres.Y();
+		const float* z = spheres.Z();
+		const float* radius = spheres.Radius();
+
+		uint32_t occludedCount = 0;
+		for (uint32_t i = 0; i < spheres.Size(); ++i)
+		{
+			if (visibility[i] != 0 && IsOccluded(x[i], y[i], z[i], radius[i]))
+			{
+				visibility[i] = 0;
+				++occludedCount;
+			}
+		}
+
+		return occludedCount;
+	}
+
+	uint32_t OcclusionCuller::Width() const
+	{
+		return mWidth;
+	}
+
+	uint32_t OcclusionCuller::Height() const
+	{
+		return mHeight;
+	}
+
+	const float* OcclusionCuller::DepthBuffer() const
+	{
+		return mDepthBuffer.data();
+	}
+
+	uint32_t OcclusionCuller::OccluderCount() const
+	{
+		return mOccluderCount;
+	}
+
+	uint32_t OcclusionCuller::TriangleCount() const
+	{
+		return static_cast<uint32_t>(mTriangles.size());
+	}
+
+	double OcclusionCuller::RasterizationMicroseconds() const
+	{
+		return mRasterizationMicroseconds;
+	}
+
+	bool OcclusionCuller::Project(float x, float y, float z, float& screenX, float& screenY, float& depth) const
+	{
+		const float* m = mViewProjection;
+		float w = x * m[3] + y * m[7] + z * m[11] + m[15];
+		if (w <= MinW)
+		{
+			return false;
+		}
+
+		float inverseW = 1.0f / w;
+		screenX = ((x * m[0] + y * m[4] + z * m[8] + m[12]) * inverseW * 0.5f + 0.5f) * static_cast<float>(mWidth);
+		screenY = (0.5f - (x * m[1] + y * m[5] + z * m[9] + m[13]) * inverseW * 0.5f) * static_cast<float>(mHeight);
+		depth = (x * m[2] + y * m[6] + z * m[10] + m[14]) * inverseW;
+
+		return true;
+	}
+
+	void OcclusionCuller::AddTriangle(const float* position0, const float* position1, const float* position2)
+	{
+		// Triangles that cross the near plane are dropped rather than clipped; that only ever loses occlusion.
+		Triangle triangle;
+		float depths[3];
+		if (Project(position0[0], position0[1], position0[2], triangle.X[0], triangle.Y[0], depths[0]) == false ||
+			Project(position1[0], position1[1], position1[2], triangle.X[1], triangle.Y[1], depths[1]) == false ||
+			Project(position2[0], position2[1], position2[2], triangle.X[2], triangle.Y[2], depths[2]) == false)
+		{
+			return;
+		}
+
+		// Both windings are kept; the depth test leaves the nearer of overlapping triangles in the buffer.
+		float area = (triangle.X[1] - triangle.X[0]) * (triangle.Y[2] - triangle.Y[0]) - (triangle.X[2] - triangle.X[0]) * (triangle.Y[1] - triangle.Y[0]);
+		if (area == 0.0f)
+		{
+			return;
+		}
+
+		if (area < 0.0f)
+		{
+			swap(triangle.X[1], triangle.X[2]);
+			swap(triangle.Y[1], triangle.Y[2]);
+		}
+
+		// Rasterize at the farthest depth so that the triangle never hides anything it does not.
+		triangle.Depth = depths[0];
+		triangle.Depth = (depths[1] > triangle.Depth ? depths[1] : triangle.Depth);
+		triangle.Depth = (depths[2] > triangle.Depth ? depths[2] : triangle.Depth);
+
+		// Pixels whose centres fall within the triangle's bounds
+		float minX = (triangle.X[0] < triangle.X[1] ? triangle.X[0] : triangle.X[1]);
+		float maxX = (triangle.X[0] > triangle.X[1] ? triangle.X[0] : triangle.X[1]);
+		float minY = (triangle.Y[0] < triangle.Y[1] ? triangle.Y[0] : triangle.Y[1]);
+		float maxY = (triangle.Y[0] > triangle.Y[1] ? triangle.Y[0] : triangle.Y[1]);
+		minX = (triangle.X[2] < minX ? triangle.X[2] : minX);
+		maxX = (triangle.X[2] > maxX ? triangle.X[2] : maxX);
+		minY = (triangle.Y[2] < minY ? triangle.Y[2] : minY);
+		maxY = (triangle.Y[2] > maxY ? triangle.Y[2] : maxY);
+
+		if (maxX < 0.0f || maxY < 0.0f || minX > static_cast<float>(mWidth) || minY > static_cast<float>(mHeight))
+		{
+			return;
+		}
+
+		triangle.MinX = static_cast<int32_t>(ceilf(minX - 0.5f));
+		triangle.MaxX = static_cast<int32_t>(floorf(maxX - 0.5f));
+		triangle.MinY = static_cast<int32_t>(ceilf(minY - 0.5f));
+		triangle.MaxY = static_cast<int32_t>(floorf(maxY - 0.5f));
+		triangle.MinX = (triangle.MinX > 0 ? triangle.MinX : 0);
+		triangle.MinY = (triangle.MinY > 0 ? triangle.MinY : 0);
+		triangle.MaxX = (triangle.MaxX < static_cast<int32_t>(mWidth) - 1 ? triangle.MaxX : static_cast<int32_t>(mWidth) - 1);
+		triangle.MaxY = (triangle.MaxY < static_cast<int32_t>(mHeight) - 1 ? triangle.MaxY : static_cast<int32_t>(mHeight) - 1);
+
+		if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+		{
+			return;
+		}
+
+		mTriangles.push_back(triangle);
+	}
+
+	void OcclusionCuller::RasterizeRows(uint32_t firstRow, uint32_t lastRow)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 columnOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+		for (const Triangle& triangle : mTriangles)
+		{
+			int32_t minY = (triangle.MinY > static_cast<int32_t>(firstRow) ? triangle.MinY : static_cast<int32_t>(firstRow));
+			int32_t maxY = (triangle.MaxY < static_cast<int32_t>(lastRow) - 1 ? triangle.MaxY : static_cast<int32_t>(lastRow) - 1);
+			if (minY > maxY)
+			{
+				continue;
+			}
+
+			// Edge functions a*x + b*y + c, positive inside the triangle. Centres exactly on an edge are covered, so that
+			// triangles sharing that edge leave no gaps between them.
+			__m128 a[3];
+			float b[3];
+			float c[3];
+			for (uint32_t edge = 0; edge < 3; ++edge)
+			{
+				uint32_t next = (edge + 1) % 3;
+				float edgeA = triangle.Y[edge] - triangle.Y[next];
+				b[edge] = triangle.X[next] - triangle.X[edge];
+				c[edge] = -(edgeA * triangle.X[edge] + b[edge] * triangle.Y[edge]);
+				a[edge] = _mm_set1_ps(edgeA);
+			}
+
+			__m128 depth = _mm_set1_ps(triangle.Depth);
+			int32_t firstColumn = triangle.MinX & ~3;
+			for (int32_t row = minY; row <= maxY; ++row)
+			{
+				float centerY = row + 0.5f;
+				__m128 rowEdge0 = _mm_set1_ps(b[0] * centerY + c[0]);
+				__m128 rowEdge1 = _mm_set1_ps(b[1] * centerY + c[1]);
+				__m128 rowEdge2 = _mm_set1_ps(b[2] * centerY + c[2]);
+				float* depthRow = &mDepthBuffer[row * mWidth];
+
+				for (int32_t column = firstColumn; column <= triangle.MaxX; column += 4)
+				{
+					__m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(column)), columnOffsets);
+					__m128 edge0 = _mm_add_ps(_mm_mul_ps(a[0], centerX), rowEdge0);
+					__m128 edge1 = _mm_add_ps(_mm_mul_ps(a[1], centerX), rowEdge1);
+					__m128 edge2 = _mm_add_ps(_mm_mul_ps(a[2], centerX), rowEdge2);
+					__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+					if (_mm_movemask_ps(inside) == 0)
+					{
+						continue;
+					}
+
+					__m128 current = _mm_loadu_ps(depthRow + column);
+					__m128 nearest = _mm_min_ps(current, depth);
+					_mm_storeu_ps(depthRow + column, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+				}
+			}
+		}
+	}
+
+	void OcclusionCuller::CreateUnitSphere()
+	{
+		const float pi = 3.14159265f;
+
+		for (uint32_t stack = 0; stack <= SphereStacks; ++stack)
+		{
+			float theta = pi * stack / SphereStacks;
+			for (uint32_t slice = 0; slice < SphereSlices; ++slice)
+			{
+				float phi = 2.0f * pi * slice / SphereSlices;
+				mUnitSpherePositions.push_back(sinf(theta) * cosf(phi));
+				mUnitSpherePositions.push_back(cosf(theta));
+				mUnitSpherePositions.push_back(sinf(theta) * sinf(phi));
+			}
+		}
+
+		// The triangles at the poles are degenerate and skipped.
+		for (uint32_t stack = 0; stack < SphereStacks; ++stack)
+		{
+			for (uint32_t slice = 0; slice < SphereSlices; ++slice)
+			{
+				uint32_t nextSlice = (slice + 1) % SphereSlices;
+				uint32_t first = stack * SphereSlices;
+				uint32_t second = (stack + 1) * SphereSlices;
+
+				if (stack > 0)
+				{
+					uint32_t triangle[3] = { first + slice, first + nextSlice, second + slice };
+					mUnitSphereIndices.insert(mUnitSphereIndices.end(), triangle, triangle + 3);
+				}
+
+				if (stack < SphereStacks - 1)
+				{
+					uint32_t triangle[3] = { first + nextSlice, second + nextSlice, second + slice };
+					mUnitSphereIndices.insert(mUnitSphereIndices.end(), triangle, triangle + 3);
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace Library
+{
+	class ThreadPool;
+	class BoundingSphereSet;
+
+	// Conservative occlusion culling on the CPU against a small depth buffer.
+	// Occluder triangles are rasterized at their farthest depth, and an object is only reported hidden when every pixel under its
+	// screen bounds holds an occluder nearer than the object's nearest point.
+	class OcclusionCuller final
+	{
+	public:
+		OcclusionCuller(std::uint32_t width = DefaultWidth, std::uint32_t height = DefaultHeight);
+		OcclusionCuller(const OcclusionCuller&) = delete;
+		OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+		OcclusionCuller(OcclusionCuller&&) = default;
+		OcclusionCuller& operator=(OcclusionCuller&&) = default;
+		~OcclusionCuller() = default;
+
+		// viewProjection is a row-major matrix that transforms row vectors (the DirectXMath convention).
+		// Clears the depth buffer and the occluders of the previous frame.
+		void BeginFrame(const float* viewProjection);
+
+		// Adds a solid sphere. Spheres that cover less than MinOccluderRadius pixels, or that cross the near plane, are skipped.
+		void AddSphereOccluder(float x, float y, float z, float radius);
+
+		// Adds world-space triangles from xyz positions. Occluders have no facing, so either winding is accepted.
+		void AddOccluder(const float* positions, std::uint32_t vertexCount, const std::uint32_t* indices, std::uint32_t indexCount);
+
+		// Rasterizes the occluders, splitting the tiles between the calling thread and the workers, if any.
+		void RasterizeOccluders(ThreadPool* workers = nullptr);
+
+		// Both are read-only, so they may run concurrently once RasterizeOccluders() has returned.
+		bool IsOccluded(float x, float y, float z, float radius) const;
+
+		// Clears visibility[i] for every visible sphere that is occluded and returns how many were cleared.
+		std::uint32_t Cull(const BoundingSphereSet& spheres, std::uint8_t* visibility) const;
+
+		std::uint32_t Width() const;
+		std::uint32_t Height() const;
+		const float* DepthBuffer() const;
+
+		// Statistics from the last RasterizeOccluders().
+		std::uint32_t OccluderCount() const;
+		std::uint32_t TriangleCount() const;
+		double RasterizationMicroseconds() const;
+
+		static const std::uint32_t DefaultWidth;
+		static const std::uint32_t DefaultHeight;
+		static const std::uint32_t TileHeight;
+		static const float MinOccluderRadius;
+
+	private:
+		struct Triangle
+		{
+			float X[3];
+			float Y[3];
+			float Depth;
+			std::int32_t MinX;
+			std::int32_t MaxX;
+			std::int32_t MinY;
+			std::int32_t MaxY;
+		};
+
+		// Returns false for points too close to or behind the camera.
+		bool Project(float x, float y, float z, float& screenX, float& screenY, float& depth) const;
+		void AddTriangle(const float* position0, const float* position1, const float* position2);
+		void RasterizeRows(std::uint32_t firstRow, std::uint32_t lastRow);
+		void CreateUnitSphere();
+
+		static const std::uint32_t SphereSlices;
+		static const std::uint32_t SphereStacks;
+		static const float MinW;
+
+		std::uint32_t mWidth;
+		std::uint32_t mHeight;
+		float mViewProjection[16];
+		std::vector<float> mDepthBuffer;
+		std::vector<Triangle> mTriangles;
+		std::vector<float> mUnitSpherePositions;
+		std::vector<std::uint32_t> mUnitSphereIndices;
+		std::vector<float> mScratchPositions;
+		std::uint32_t mOccluderCount;
+		double mRasterizationMicroseconds;
+	};
+}
\ No newline at end of file
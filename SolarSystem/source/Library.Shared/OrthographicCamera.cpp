@@ -51,5 +51,6 @@ namespace Library
     {
 		XMMATRIX projectionMatrix = XMMatrixOrthographicRH(mViewWidth, mViewHeight, mNearPlaneDistance, mFarPlaneDistance);
         XMStoreFloat4x4(&mProjectionMatrix, projectionMatrix);
+        mDerivedDataDirty = true;
     }
 }
@@ -35,5 +35,6 @@ namespace Library
     {
         XMMATRIX projectionMatrix = XMMatrixPerspectiveFovRH(mFieldOfView, mAspectRatio, mNearPlaneDistance, mFarPlaneDistance);
         XMStoreFloat4x4(&mProjectionMatrix, projectionMatrix);
+        mDerivedDataDirty = true;
     }
 }
@@ -0,0 +1,281 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace Library
+{
+	const uint32_t Profiler::EventCapacityPerThread = 1 << 16;
+	const uint32_t Profiler::BinaryVersion = 1;
+
+	atomic<bool> Profiler::sEnabled(false);
+	atomic<uint32_t> Profiler::sGeneration(0);
+	mutex Profiler::sMutex;
+	vector<unique_ptr<Profiler::ThreadBuffer>> Profiler::sThreadBuffers;
+	thread_local Profiler::ThreadBuffer* Profiler::sThreadBuffer = nullptr;
+
+	Profiler::ThreadBuffer::ThreadBuffer(uint32_t index) :
+		Events(), Count(0), DroppedCount(0), Generation(sGeneration.load()), Depth(0), Index(index)
+	{
+	}
+
+	bool Profiler::IsEnabled()
+	{
+		return sEnabled.load(memory_order_relaxed);
+	}
+
+	void Profiler::SetEnabled(bool enabled)
+	{
+		sEnabled.store(enabled);
+	}
+
+	void Profiler::Clear()
+	{
+		// Each thread resets its own buffer the next time it records, so nothing here races with a recording thread.
+		sGeneration.fetch_add(1);
+	}
+
+	void Profiler::SetThreadName(const string& name)
+	{
+		ThreadBuffer& buffer = CurrentThreadBuffer();
+
+		lock_guard<mutex> lock(sMutex);
+		buffer.Name = name;
+	}
+
+	uint64_t Profiler::Now()
+	{
+		return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+	}
+
+	vector<Profiler::ThreadEvents> Profiler::Collect()
+	{
+		uint32_t generation = sGeneration.load();
+		vector<ThreadEvents> threads;
+
+		lock_guard<mutex> lock(sMutex);
+		for (const unique_ptr<ThreadBuffer>& buffer : sThreadBuffers)
+		{
+			if (buffer->Generation.load(memory_order_acquire) != generation)
+			{
+				continue;
+			}
+
+			uint32_t count = buffer->Count.load(memory_order_acquire);
+			if (count == 0)
+			{
+				continue;
+			}
+
+			ThreadEvents threadEvents;
+			threadEvents.ThreadIndex = buffer->Index;
+			threadEvents.ThreadName = buffer->Name;
+			threadEvents.DroppedCount = buffer->DroppedCount.load(memory_order_relaxed);
+			threadEvents.Events.assign(buffer->Events.begin(), buffer->Events.begin() + count);
+
+			// Events are recorded as their scopes close, so a parent lands after its children.
+			sort(threadEvents.Events.begin(), threadEvents.Events.end(), [](const Event& lhs, const Event& rhs)
+			{
+				return (lhs.Start != rhs.Start ? lhs.Start < rhs.Start : lhs.Depth < rhs.Depth);
+			});
+
+			threads.push_back(move(threadEvents));
+		}
+
+		return threads;
+	}
+
+	void Profiler::ExportChromeTrace(ostream& stream)
+	{
+		vector<ThreadEvents> threads = Collect();
+
+		uint64_t baseTime = UINT64_MAX;
+		for (const ThreadEvents& threadEvents : threads)
+		{
+			baseTime = min(baseTime, threadEvents.Events.front().Start);
+		}
+
+		ios_base::fmtflags flags = stream.flags();
+		streamsize precision = stream.precision();
+		stream << fixed << setprecision(3);
+
+		stream << "{\"traceEvents\":[";
+		bool isFirst = true;
+		for (const ThreadEvents& threadEvents : threads)
+		{
+			if (threadEvents.ThreadName.empty() == false)
+			{
+				stream << (isFirst ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadEvents.ThreadIndex << ",\"args\":{\"name\":";
+				WriteJsonString(stream, threadEvents.ThreadName.c_str());
+				stream << "}}";
+				isFirst = false;
+			}
+
+			for (const Event& event : threadEvents.Events)
+			{
+				stream << (isFirst ? "" : ",") << "\n{\"name\":";
+				WriteJsonString(stream, event.Name);
+				stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadEvents.ThreadIndex
+					<< ",\"ts\":" << static_cast<double>(event.Start - baseTime) / 1000.0 << ",\"dur\":" << static_cast<double>(event.Duration) / 1000.0 << "}";
+				isFirst = false;
+			}
+		}
+		stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+
+	void Profiler::ExportBinary(ostream& stream)
+	{
+		vector<ThreadEvents> threads = Collect();
+
+		// Names are literals, so the same text can live at several addresses; the table is keyed by content.
+		vector<string> names;
+		map<string, uint32_t> nameIndices;
+		uint64_t baseTime = (threads.empty() ? 0 : UINT64_MAX);
+		for (const ThreadEvents& threadEvents : threads)
+		{
+			baseTime = min(baseTime, threadEvents.Events.front().Start);
+			for (const Event& event : threadEvents.Events)
+			{
+				if (nameIndices.emplace(event.Name, static_cast<uint32_t>(names.size())).second)
+				{
+					names.push_back(event.Name);
+				}
+			}
+		}
+
+		stream.write("PRFL", 4);
+		WriteVarint(stream, BinaryVersion);
+
+		WriteVarint(stream, names.size());
+		for (const string& name : names)
+		{
+			WriteVarint(stream, name.size());
+			stream.write(name.data(), static_cast<streamsize>(name.size()));
+		}
+
+		WriteVarint(stream, baseTime);
+		WriteVarint(stream, threads.size());
+		for (const ThreadEvents& threadEvents : threads)
+		{
+			WriteVarint(stream, threadEvents.ThreadIndex);
+			WriteVarint(stream, threadEvents.ThreadName.size());
+			stream.write(threadEvents.ThreadName.data(), static_cast<streamsize>(threadEvents.ThreadName.size()));
+			WriteVarint(stream, threadEvents.DroppedCount);
+			WriteVarint(stream, threadEvents.Events.size());
+
+			uint64_t previousStart = baseTime;
+			for (const Event& event : threadEvents.Events)
+			{
+				WriteVarint(stream, nameIndices[event.Name]);
+				WriteVarint(stream, event.Depth);
+				WriteVarint(stream, event.Start - previousStart);
+				WriteVarint(stream, event.Duration);
+				previousStart = event.Start;
+			}
+		}
+	}
+
+	uint64_t Profiler::BeginScope()
+	{
+		++CurrentThreadBuffer().Depth;
+
+		return Now();
+	}
+
+	void Profiler::EndScope(const char* name, uint64_t start)
+	{
+		uint64_t end = Now();
+		ThreadBuffer& buffer = *sThreadBuffer;
+		--buffer.Depth;
+
+		uint32_t generation = sGeneration.load(memory_order_relaxed);
+		if (buffer.Generation.load(memory_order_relaxed) != generation)
+		{
+			buffer.Count.store(0, memory_order_relaxed);
+			buffer.DroppedCount.store(0, memory_order_relaxed);
+			buffer.Generation.store(generation, memory_order_release);
+		}
+
+		// Only the owning thread writes the buffer; publishing the count makes the new event visible to Collect().
+		uint32_t count = buffer.Count.load(memory_order_relaxed);
+		if (count == EventCapacityPerThread)
+		{
+			buffer.DroppedCount.store(buffer.DroppedCount.load(memory_order_relaxed) + 1, memory_order_relaxed);
+			return;
+		}
+
+		// Threads that never record while the profiler is enabled never pay for a buffer.
+		if (buffer.Events.empty())
+		{
+			buffer.Events.resize(EventCapacityPerThread);
+		}
+
+		Event& event = buffer.Events[count];
+		event.Name = name;
+		event.Start = start;
+		event.Duration = end - start;
+		event.Depth = buffer.Depth;
+		buffer.Count.store(count + 1, memory_order_release);
+	}
+
+	Profiler::ThreadBuffer& Profiler::CurrentThreadBuffer()
+	{
+		if (sThreadBuffer == nullptr)
+		{
+			// Buffers are never freed, so events recorded by threads that have since exited can still be exported.
+			lock_guard<mutex> lock(sMutex);
+			sThreadBuffers.push_back(make_unique<ThreadBuffer>(static_cast<uint32_t>(sThreadBuffers.size())));
+			sThreadBuffer = sThreadBuffers.back().get();
+		}
+
+		return *sThreadBuffer;
+	}
+
+	void Profiler::WriteVarint(ostream& stream, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			stream.put(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+
+		stream.put(static_cast<char>(value));
+	}
+
+	void Profiler::WriteJsonString(ostream& stream, const char* value)
+	{
+		stream << '"';
+		for (const char* character = value; *character != '\0'; ++character)
+		{
+			switch (*character)
+			{
+			case '"':
+				stream << "\\\"";
+				break;
+
+			case '\\':
+				stream << "\\\\";
+				break;
+
+			case '\n':
+				stream << "\\n";
+				break;
+
+			default:
+				if (static_cast<unsigned char>(*character) < 0x20)
+				{
+					stream << "\\u00" << hex << setw(2) << setfill('0') << static_cast<int>(*character) << dec << setfill(' ');
+				}
+				else
+				{
+					stream << *character;
+				}
+				break;
+			}
+		}
+		stream << '"';
+	}
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <iosfwd>
+#include <cstdint>
+
+namespace Library
+{
+	// Hierarchical CPU profiler. ProfileScope markers record one complete event per scope into a buffer owned by the recording
+	// thread, so nothing is locked while recording; a marker costs a relaxed atomic load while the profiler is disabled.
+	// Define LIBRARY_DISABLE_PROFILER to compile PROFILE_SCOPE markers out entirely.
+	class Profiler final
+	{
+		friend class ProfileScope;
+
+	public:
+		struct Event
+		{
+			const char* Name;
+			std::uint64_t Start;
+			std::uint64_t Duration;
+			std::uint32_t Depth;
+		};
+
+		struct ThreadEvents
+		{
+			std::uint32_t ThreadIndex;
+			std::string ThreadName;
+			std::uint32_t DroppedCount;
+			std::vector<Event> Events;
+		};
+
+		static bool IsEnabled();
+		static void SetEnabled(bool enabled);
+
+		// Discards everything recorded so far. Scopes that are open at the time are kept when they close.
+		static void Clear();
+
+		// Names the calling thread in exported traces.
+		static void SetThreadName(const std::string& name);
+
+		// Nanoseconds on the clock events are stamped with.
+		static std::uint64_t Now();
+
+		// Copies the events recorded since the last Clear(), ordered by start time within each thread. Safe to call while
+		// other threads are recording; their in-flight scopes are simply not included.
+		static std::vector<ThreadEvents> Collect();
+
+		// Chrome trace event JSON (chrome://tracing, Perfetto) with timestamps relative to the first event.
+		static void ExportChromeTrace(std::ostream& stream);
+
+		// Compact binary trace. All integers are unsigned LEB128 varints:
+		//   "PRFL" version
+		//   nameCount { length bytes }
+		//   baseTime threadCount { threadIndex nameLength bytes droppedCount eventCount { nameIndex depth startDelta duration } }
+		// Event starts are in nanoseconds, delta-encoded against the previous event of the same thread (the first against baseTime).
+		static void ExportBinary(std::ostream& stream);
+
+		static const std::uint32_t EventCapacityPerThread;
+		static const std::uint32_t BinaryVersion;
+
+		Profiler() = delete;
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+		Profiler(Profiler&&) = delete;
+		Profiler& operator=(Profiler&&) = delete;
+		~Profiler() = default;
+
+	private:
+		struct ThreadBuffer
+		{
+			std::vector<Event> Events;
+			std::atomic<std::uint32_t> Count;
+			std::atomic<std::uint32_t> DroppedCount;
+			std::atomic<std::uint32_t> Generation;
+			std::uint32_t Depth;
+			std::uint32_t Index;
+			std::string Name;
+
+			explicit ThreadBuffer(std::uint32_t index);
+		};
+
+		static std::uint64_t BeginScope();
+		static void EndScope(const char* name, std::uint64_t start);
+
+		static ThreadBuffer& CurrentThreadBuffer();
+		static void WriteVarint(std::ostream& stream, std::uint64_t value);
+		static void WriteJsonString(std::ostream& stream, const char* value);
+
+		static std::atomic<bool> sEnabled;
+		static std::atomic<std::uint32_t> sGeneration;
+		static std::mutex sMutex;
+		static std::vector<std::unique_ptr<ThreadBuffer>> sThreadBuffers;
+		static thread_local ThreadBuffer* sThreadBuffer;
+	};
+
+	class ProfileScope final
+	{
+	public:
+		explicit ProfileScope(const char* name) :
+			mName(nullptr), mStart(0)
+		{
+			if (Profiler::sEnabled.load(std::memory_order_relaxed))
+			{
+				mName = name;
+				mStart = Profiler::BeginScope();
+			}
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+		ProfileScope(ProfileScope&&) = delete;
+		ProfileScope& operator=(ProfileScope&&) = delete;
+
+		~ProfileScope()
+		{
+			if (mName != nullptr)
+			{
+				Profiler::EndScope(mName, mStart);
+			}
+		}
+
+	private:
+		const char* mName;
+		std::uint64_t mStart;
+	};
+}
+
+#if defined(LIBRARY_DISABLE_PROFILER)
+#define PROFILE_SCOPE(name)
+#else
+#define PROFILE_SCOPE_CONCATENATE_INNER(prefix, line) prefix##line
+#define PROFILE_SCOPE_CONCATENATE(prefix, line) PROFILE_SCOPE_CONCATENATE_INNER(prefix, line)
+#define PROFILE_SCOPE(name) Library::ProfileScope PROFILE_SCOPE_CONCATENATE(profileScope, __LINE__)(name)
+#endif
\ No newline at end of file
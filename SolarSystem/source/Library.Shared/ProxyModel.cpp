@@ -104,38 +104,37 @@ namespace Library
 
 	void ProxyModel::Initialize()
 	{
+		RenderDevice& device = mGame->Device();
+
 		// Load a compiled vertex shader
 		std::vector<char> compiledVertexShader;
 		Utility::LoadBinaryFile(L"Content\\Shaders\\BasicVS.cso", compiledVertexShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateVertexShader(&compiledVertexShader[0], compiledVertexShader.size(), nullptr, mVertexShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedVertexShader() failed.");
+		mVertexShader = device.CreateShader(ShaderStage::Vertex, compiledVertexShader);
 
 		// Load a compiled pixel shader
 		std::vector<char> compiledPixelShader;
 		Utility::LoadBinaryFile(L"Content\\Shaders\\BasicPS.cso", compiledPixelShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreatePixelShader(&compiledPixelShader[0], compiledPixelShader.size(), nullptr, mPixelShader.ReleaseAndGetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
+		mPixelShader = device.CreateShader(ShaderStage::Pixel, compiledPixelShader);
 
-		// Create an input layout
-		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
+		PipelineStateDescription pipelineStateDescription(mVertexShader, mPixelShader,
 		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-			{ "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-		};
+			InputElement("POSITION", VertexFormat::Float4),
+			InputElement("COLOR", VertexFormat::Float4)
+		});
+		mSolidPipelineState = device.CreatePipelineState(pipelineStateDescription);
 
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateInputLayout(inputElementDescriptions, ARRAYSIZE(inputElementDescriptions), &compiledVertexShader[0], compiledVertexShader.size(), mInputLayout.ReleaseAndGetAddressOf()), "ID3D11Device::CreateInputLayout() failed.");
+		pipelineStateDescription.Fill = FillMode::Wireframe;
+		mWireframePipelineState = device.CreatePipelineState(pipelineStateDescription);
 
-		// Create constant buffers
-		D3D11_BUFFER_DESC constantBufferDesc = { 0 };
-		constantBufferDesc.ByteWidth = sizeof(VertexCBufferPerObject);
-		constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mVertexCBufferPerObject.ReleaseAndGetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+		mConstantBuffer = device.CreateBuffer(BufferDescription(BufferType::Constant, ResourceUsage::Default, sizeof(VertexCBufferPerObject)), nullptr);
 
 		// Load a model
 		//Model model = Library::Model(mModelFileName);
 
 		// Create vertex and index buffers for the model
 		//Mesh* mesh = model.Meshes().at(0).get();
-		//CreateVertexBuffer(mGame->Direct3DDevice(), *mesh, mVertexBuffer.GetAddressOf());
-		//mesh->CreateIndexBuffer(*mGame->Direct3DDevice(), mIndexBuffer.ReleaseAndGetAddressOf());
+		//mVertexBuffer = CreateVertexBuffer(device, *mesh);
+		//mIndexBuffer = mesh->CreateIndexBuffer(device);
 		//mIndexCount = static_cast<UINT>(mesh->Indices().size());
 	}
 
@@ -156,72 +155,56 @@ namespace Library
 	{
 		UNREFERENCED_PARAMETER(gameTime);
 
-		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
-		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		direct3DDeviceContext->IASetInputLayout(mInputLayout.Get());
-
-		UINT stride = sizeof(VertexPositionColor);
-		UINT offset = 0;
-		direct3DDeviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
-		direct3DDeviceContext->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
-
-		direct3DDeviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
-		direct3DDeviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
-
 		XMMATRIX worldMatrix = XMLoadFloat4x4(&mWorldMatrix);
 		XMMATRIX wvp = worldMatrix * mCamera->ViewProjectionMatrix();
 		XMStoreFloat4x4(&mVertexCBufferPerObjectData.WorldViewProjection, XMMatrixTranspose(wvp));
 
-		direct3DDeviceContext->UpdateSubresource(mVertexCBufferPerObject.Get(), 0, nullptr, &mVertexCBufferPerObjectData, 0, 0);
-		direct3DDeviceContext->VSSetConstantBuffers(0, 1, mVertexCBufferPerObject.GetAddressOf());
-
-		if (mDisplayWireframe)
+		if (mVertexBuffer.IsValid() == false)
 		{
-			mGame->Direct3DDeviceContext()->RSSetState(RasterizerStates::Wireframe.Get());
-			direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
-			mGame->Direct3DDeviceContext()->RSSetState(nullptr);
+			return;
 		}
-		else
+
+		mGame->DrawQueue().SubmitCallback(RenderLayer::Opaque, [this]()
 		{
-			direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
-		}
+			CommandEncoder& encoder = mGame->Device().ImmediateEncoder();
+			encoder.UpdateBuffer(mConstantBuffer, &mVertexCBufferPerObjectData, sizeof(mVertexCBufferPerObjectData));
+			encoder.SetPipelineState(mDisplayWireframe ? mWireframePipelineState : mSolidPipelineState);
+			encoder.SetVertexBuffer(0, mVertexBuffer, sizeof(VertexPositionColor), 0);
+			encoder.SetIndexBuffer(mIndexBuffer, IndexFormat::UInt32, 0);
+			encoder.SetConstantBuffer(ShaderStage::Vertex, 0, mConstantBuffer);
+			encoder.DrawIndexed(mIndexCount, 0, 0);
+		});
 	}
 
-	void ProxyModel::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	BufferHandle ProxyModel::CreateVertexBuffer(RenderDevice& device, const Mesh& mesh) const
 	{
-		const std::vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
+		Span<const XMFLOAT3> sourceVertices = mesh.Vertices();
 
 		std::vector<VertexPositionColor> vertices;
-		vertices.reserve(sourceVertices.size());
-		if (mesh.VertexColors().size() > 0)
+		vertices.reserve(sourceVertices.Size());
+		if (mesh.VertexColorChannelCount() > 0)
 		{
-			std::vector<XMFLOAT4>* vertexColors = mesh.VertexColors().at(0);
-			assert(vertexColors->size() == sourceVertices.size());
+			Span<const XMFLOAT4> vertexColors = mesh.VertexColors(0);
+			assert(vertexColors.Size() == sourceVertices.Size());
 
-			for (UINT i = 0; i < sourceVertices.size(); i++)
+			for (UINT i = 0; i < sourceVertices.Size(); i++)
 			{
-				const XMFLOAT3& position = sourceVertices.at(i);
-				const XMFLOAT4& color = vertexColors->at(i);
+				const XMFLOAT3& position = sourceVertices[i];
+				const XMFLOAT4& color = vertexColors[i];
 				vertices.push_back(VertexPositionColor(XMFLOAT4(position.x, position.y, position.z, 1.0f), color));
 			}
 		}
 		else
 		{
 			XMFLOAT4 color = XMFLOAT4(reinterpret_cast<const float*>(&Colors::White));
-			for (UINT i = 0; i < sourceVertices.size(); i++)
+			for (UINT i = 0; i < sourceVertices.Size(); i++)
 			{
-				const XMFLOAT3& position = sourceVertices.at(i);
+				const XMFLOAT3& position = sourceVertices[i];
 				vertices.push_back(VertexPositionColor(XMFLOAT4(position.x, position.y, position.z, 1.0f), color));
 			}
 		}
 
-		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
-		vertexBufferDesc.ByteWidth = sizeof(VertexPositionColor) * static_cast<UINT>(vertices.size());
-		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-		D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
-		vertexSubResourceData.pSysMem = &vertices[0];
-		ThrowIfFailed(device->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer), "ID3D11Device::CreateBuffer() failed.");
+		BufferDescription description(BufferType::Vertex, ResourceUsage::Immutable, sizeof(VertexPositionColor) * static_cast<UINT>(vertices.size()));
+		return device.CreateBuffer(description, &vertices[0]);
 	}
 }
\ No newline at end of file
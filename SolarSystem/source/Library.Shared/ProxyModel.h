@@ -1,9 +1,8 @@
 #pragma once
 
 #include "DrawableGameComponent.h"
-#include <wrl.h>
-#include <d3d11_2.h>
 #include <DirectXMath.h>
+#include "RenderDevice.h"
 
 namespace Library
 {
@@ -54,7 +53,7 @@ namespace Library
 			VertexCBufferPerObject(const DirectX::XMFLOAT4X4& wvp) : WorldViewProjection(wvp) { }
 		};
 
-		void CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const;
+		BufferHandle CreateVertexBuffer(RenderDevice& device, const Mesh& mesh) const;
 
 		DirectX::XMFLOAT4X4 mWorldMatrix;
 		DirectX::XMFLOAT4X4 mScaleMatrix;
@@ -63,12 +62,13 @@ namespace Library
 		DirectX::XMFLOAT3 mUp;
 		DirectX::XMFLOAT3 mRight;
 		std::string mModelFileName;
-		Microsoft::WRL::ComPtr<ID3D11VertexShader> mVertexShader;
-		Microsoft::WRL::ComPtr<ID3D11PixelShader> mPixelShader;
-		Microsoft::WRL::ComPtr<ID3D11InputLayout> mInputLayout;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mVertexBuffer;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mIndexBuffer;		
-		Microsoft::WRL::ComPtr<ID3D11Buffer> mVertexCBufferPerObject;
+		ShaderHandle mVertexShader;
+		ShaderHandle mPixelShader;
+		PipelineStateHandle mSolidPipelineState;
+		PipelineStateHandle mWireframePipelineState;
+		BufferHandle mVertexBuffer;
+		BufferHandle mIndexBuffer;
+		BufferHandle mConstantBuffer;
 		VertexCBufferPerObject mVertexCBufferPerObjectData;
 		UINT mIndexCount;
 		bool mDisplayWireframe;
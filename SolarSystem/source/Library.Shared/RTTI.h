@@ -1,40 +1,113 @@
 #pragma once
 
-#include <windows.h>
 #include <string>
 #include <cstdint>
+#include <cstring>
+#include <cassert>
 
 namespace Library
 {
 	class RTTI
 	{
 	public:
+		static const std::uint32_t MaxTypeDepth = 15;
+
+		// A type's ancestry, indexed by depth: RTTI itself is depth 0 and the type is last. Every type's depth is known at compile
+		// time, so Is<T>() is a single comparison against slot T::TypeDepth, with no walk up the hierarchy.
+		struct TypeInfo final
+		{
+			std::uint32_t Depth;
+			std::uint64_t Ids[MaxTypeDepth + 1];
+			std::uint32_t NameHashes[MaxTypeDepth + 1];
+			const char* Names[MaxTypeDepth + 1];
+
+			TypeInfo() :
+				Depth(0), Ids(), NameHashes(), Names()
+			{
+				Names[0] = "RTTI";
+				NameHashes[0] = HashTypeName("RTTI");
+			}
+
+			TypeInfo(const TypeInfo& parent, std::uint64_t id, const char* name, std::uint32_t nameHash) :
+				TypeInfo(parent)
+			{
+				++Depth;
+				assert(Depth <= MaxTypeDepth);
+				Ids[Depth] = id;
+				NameHashes[Depth] = nameHash;
+				Names[Depth] = name;
+			}
+		};
+
+		static const std::uint32_t TypeDepth = 0;
+
 		virtual ~RTTI() = default;
 
 		virtual std::uint64_t TypeIdInstance() const = 0;
 
-		virtual RTTI* QueryInterface(const std::uint64_t id) const
+		// The type's name as a literal, for code that must not allocate (e.g. profiler markers).
+		virtual const char* TypeNameInstance() const
 		{
-			UNREFERENCED_PARAMETER(id);
-			return nullptr;
+			return "RTTI";
+		}
+
+		static const TypeInfo& ClassTypeInfo()
+		{
+			static const TypeInfo typeInfo;
+			return typeInfo;
+		}
+
+		virtual const TypeInfo& TypeInfoInstance() const
+		{
+			return ClassTypeInfo();
+		}
+
+		RTTI* QueryInterface(const std::uint64_t id) const
+		{
+			return (Is(id) ? const_cast<RTTI*>(this) : nullptr);
 		}
 
-		virtual bool Is(std::uint64_t id) const
+		// Prefer Is<T>() when the type is known at compile time; these search the (short) ancestry.
+		bool Is(std::uint64_t id) const
 		{
-			UNREFERENCED_PARAMETER(id);
+			const TypeInfo& typeInfo = TypeInfoInstance();
+			for (std::uint32_t depth = typeInfo.Depth; depth > 0; --depth)
+			{
+				if (typeInfo.Ids[depth] == id)
+				{
+					return true;
+				}
+			}
+
 			return false;
 		}
 
-		virtual bool Is(const std::string& name) const
+		bool Is(const std::string& name) const
 		{
-			UNREFERENCED_PARAMETER(name);
+			const std::uint32_t nameHash = HashTypeName(name.c_str());
+			const TypeInfo& typeInfo = TypeInfoInstance();
+			for (std::uint32_t depth = typeInfo.Depth; depth > 0; --depth)
+			{
+				if (typeInfo.NameHashes[depth] == nameHash && name.compare(typeInfo.Names[depth]) == 0)
+				{
+					return true;
+				}
+			}
+
 			return false;
 		}
 
+		template <typename T>
+		bool Is() const
+		{
+			const TypeInfo& typeInfo = TypeInfoInstance();
+			return (typeInfo.Depth >= T::TypeDepth && typeInfo.Ids[T::TypeDepth] == T::TypeIdClass());
+		}
+
 		template <typename T>
 		T* As() const
 		{
-			if (Is(T::TypeIdClass()))
+			if (Is<T>())
 			{
 				return (T*)this;
 			}
@@ -51,37 +124,34 @@ namespace Library
 		{
 			return this == rhs;
 		}
+
+		// 32-bit FNV-1a, evaluated at compile time for type names. The arithmetic stays within 64 bits so constant evaluation
+		// never overflows.
+		static constexpr std::uint32_t HashTypeName(const char* name, std::uint64_t hash = 2166136261U)
+		{
+			return (*name == '\0' ? static_cast<std::uint32_t>(hash) :
+				HashTypeName(name + 1, ((hash ^ static_cast<std::uint8_t>(*name)) * 16777619U) & 0xFFFFFFFFU));
+		}
 	};
 
 #define RTTI_DECLARATIONS(Type, ParentType)																	 \
 		public:                                                                                              \
 			typedef ParentType Parent;                                                                       \
+			static const std::uint32_t TypeDepth = Parent::TypeDepth + 1;                                    \
+			static const std::uint32_t TypeNameHash = Library::RTTI::HashTypeName(#Type);                    \
 			static std::string TypeName() { return std::string(#Type); }                                     \
-			static std::uint64_t TypeIdClass() { return sRunTimeTypeId; }                                    \
-			virtual std::uint64_t TypeIdInstance() const override { return Type::TypeIdClass(); }            \
-			virtual Library::RTTI* QueryInterface(const std::uint64_t id) const override                     \
-            {                                                                                                \
-                if (id == sRunTimeTypeId)                                                                    \
-					{ return (RTTI*)this; }                                                                  \
-                else                                                                                         \
-					{ return Parent::QueryInterface(id); }                                                   \
-            }                                                                                                \
-			virtual bool Is(std::uint64_t id) const override                                                 \
-			{                                                                                                \
-				if (id == sRunTimeTypeId)                                                                    \
-					{ return true; }                                                                         \
-				else                                                                                         \
-					{ return Parent::Is(id); }                                                               \
-			}                                                                                                \
-			virtual bool Is(const std::string& name) const override                                          \
+			static std::uint64_t TypeIdClass() { return reinterpret_cast<std::uint64_t>(&sRunTimeTypeId); }  \
+			static const Library::RTTI::TypeInfo& ClassTypeInfo()                                            \
 			{                                                                                                \
-				if (name == TypeName())                                                                      \
-					{ return true; }                                                                         \
-				else                                                                                         \
-					{ return Parent::Is(name); }                                                             \
+				static_assert(TypeDepth <= Library::RTTI::MaxTypeDepth, "Raise RTTI::MaxTypeDepth.");        \
+				static const Library::RTTI::TypeInfo typeInfo(Parent::ClassTypeInfo(), TypeIdClass(), #Type, TypeNameHash); \
+				return typeInfo;                                                                             \
 			}                                                                                                \
+			virtual std::uint64_t TypeIdInstance() const override { return Type::TypeIdClass(); }            \
+			virtual const char* TypeNameInstance() const override { return #Type; }                          \
+			virtual const Library::RTTI::TypeInfo& TypeInfoInstance() const override { return Type::ClassTypeInfo(); } \
 			private:                                                                                         \
 				static std::uint64_t sRunTimeTypeId;
 
 #define RTTI_DEFINITIONS(Type) std::uint64_t Type::sRunTimeTypeId = reinterpret_cast<std::uint64_t>(&Type::sRunTimeTypeId);
-}
\ No newline at end of file
+}
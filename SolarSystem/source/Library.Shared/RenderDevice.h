@@ -0,0 +1,289 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <initializer_list>
+
+namespace Library
+{
+	// Typed ids for objects owned by a RenderDevice. Ids are never reused, and 0 is never issued, so a default handle is null.
+	template <typename TTag>
+	struct RenderHandle
+	{
+		std::uint32_t Id;
+
+		RenderHandle() :
+			Id(0) { }
+		explicit RenderHandle(std::uint32_t id) :
+			Id(id) { }
+
+		bool IsValid() const { return Id != 0; }
+		bool operator==(const RenderHandle& rhs) const { return Id == rhs.Id; }
+		bool operator!=(const RenderHandle& rhs) const { return Id != rhs.Id; }
+	};
+
+	typedef RenderHandle<struct BufferTag> BufferHandle;
+	typedef RenderHandle<struct TextureTag> TextureHandle;
+	typedef RenderHandle<struct ShaderTag> ShaderHandle;
+	typedef RenderHandle<struct PipelineStateTag> PipelineStateHandle;
+	typedef RenderHandle<struct FontTag> FontHandle;
+
+	enum class BufferType
+	{
+		Vertex,
+		Index,
+		Constant
+	};
+
+	// Immutable buffers need initial data and cannot be updated. Dynamic buffers are rewritten whole, typically every frame, or mapped.
+	enum class ResourceUsage
+	{
+		Immutable,
+		Default,
+		Dynamic
+	};
+
+	enum class ShaderStage
+	{
+		Vertex,
+		Pixel
+	};
+
+	enum class VertexFormat
+	{
+		UInt1,
+		Float1,
+		Float2,
+		Float3,
+		Float4
+	};
+
+	enum class IndexFormat
+	{
+		UInt16,
+		UInt32
+	};
+
+	enum class PrimitiveTopology
+	{
+		PointList,
+		LineList,
+		TriangleList,
+		TriangleStrip
+	};
+
+	// Wireframe pipelines draw both faces regardless of the cull mode.
+	enum class CullMode
+	{
+		None,
+		Back,
+		Front
+	};
+
+	enum class FillMode
+	{
+		Solid,
+		Wireframe
+	};
+
+	enum class BlendMode
+	{
+		Opaque,
+		AlphaBlend
+	};
+
+	enum class DepthMode
+	{
+		ReadWrite,
+		ReadOnly,
+		Disabled
+	};
+
+	// The pixel shader's sampler in slot 0.
+	enum class SamplerMode
+	{
+		None,
+		TrilinearWrap,
+		TrilinearClamp,
+		PointClamp
+	};
+
+	// Discard hands out fresh memory for the whole buffer. NoOverwrite keeps the contents and promises not to touch any range a
+	// draw already submitted reads; on constant buffers it needs RenderDevice::SupportsConstantBufferOffsets().
+	enum class MapMode
+	{
+		Discard,
+		NoOverwrite
+	};
+
+	struct BufferDescription
+	{
+		BufferType Type;
+		ResourceUsage Usage;
+		std::uint32_t ByteWidth;
+
+		BufferDescription(BufferType type = BufferType::Vertex, ResourceUsage usage = ResourceUsage::Immutable, std::uint32_t byteWidth = 0) :
+			Type(type), Usage(usage), ByteWidth(byteWidth) { }
+	};
+
+	// Elements are packed in declaration order within each vertex buffer slot.
+	struct InputElement
+	{
+		const char* SemanticName;
+		std::uint32_t SemanticIndex;
+		VertexFormat Format;
+		std::uint32_t Slot;
+		bool PerInstance;
+
+		InputElement(const char* semanticName, VertexFormat format, std::uint32_t semanticIndex = 0, std::uint32_t slot = 0, bool perInstance = false) :
+			SemanticName(semanticName), SemanticIndex(semanticIndex), Format(format), Slot(slot), PerInstance(perInstance) { }
+	};
+
+	// A rectangle of texels, right and bottom exclusive.
+	struct TextureRegion
+	{
+		std::int32_t Left;
+		std::int32_t Top;
+		std::int32_t Right;
+		std::int32_t Bottom;
+	};
+
+	// Where a character sits in its font's sprite sheet, and how it moves the pen, in pixels (see DirectX::SpriteFont::Glyph).
+	struct FontGlyph
+	{
+		TextureRegion Subrect;
+		float XOffset;
+		float YOffset;
+		float XAdvance;
+	};
+
+	// A glyph drawn unscaled with its top-left corner at (X, Y) in render target pixels.
+	struct GlyphSprite
+	{
+		TextureRegion Subrect;
+		float X;
+		float Y;
+		float Color[4];
+	};
+
+	struct PipelineStateDescription
+	{
+		ShaderHandle VertexShader;
+		ShaderHandle PixelShader;
+		std::vector<InputElement> InputElements;
+		PrimitiveTopology Topology;
+		CullMode Cull;
+		FillMode Fill;
+		BlendMode Blend;
+		DepthMode Depth;
+		SamplerMode Sampler;
+
+		PipelineStateDescription(ShaderHandle vertexShader, ShaderHandle pixelShader, std::initializer_list<InputElement> inputElements, PrimitiveTopology topology = PrimitiveTopology::TriangleList) :
+			VertexShader(vertexShader), PixelShader(pixelShader), InputElements(inputElements), Topology(topology),
+			Cull(CullMode::Back), Fill(FillMode::Solid), Blend(BlendMode::Opaque), Depth(DepthMode::ReadWrite), Sampler(SamplerMode::None) { }
+	};
+
+	// Records state changes, uploads and draws. Bindings persist until they are replaced.
+	class CommandEncoder
+	{
+	public:
+		virtual ~CommandEncoder() = default;
+
+		virtual void UpdateBuffer(BufferHandle buffer, const void* data, std::uint32_t size) = 0;
+
+		// Returns the start of a dynamic buffer. The memory may be written from any thread until Unmap(), which must come before the
+		// buffer is drawn from; Map() and Unmap() themselves belong to the encoder's thread.
+		virtual void* Map(BufferHandle buffer, MapMode mode) = 0;
+		virtual void Unmap(BufferHandle buffer) = 0;
+
+		virtual void SetPipelineState(PipelineStateHandle pipelineState) = 0;
+		virtual void SetVertexBuffer(std::uint32_t slot, BufferHandle buffer, std::uint32_t stride, std::uint32_t offset) = 0;
+		virtual void SetIndexBuffer(BufferHandle buffer, IndexFormat format, std::uint32_t offset) = 0;
+		virtual void SetConstantBuffer(ShaderStage stage, std::uint32_t slot, BufferHandle buffer) = 0;
+
+		// Binds constantCount 16-byte constants starting at firstConstant; both must be multiples of 16. Needs
+		// RenderDevice::SupportsConstantBufferOffsets().
+		virtual void SetConstantBufferRange(ShaderStage stage, std::uint32_t slot, BufferHandle buffer, std::uint32_t firstConstant, std::uint32_t constantCount) = 0;
+		virtual void SetTexture(ShaderStage stage, std::uint32_t slot, TextureHandle texture) = 0;
+
+		virtual void Draw(std::uint32_t vertexCount, std::uint32_t startVertex) = 0;
+		virtual void DrawInstanced(std::uint32_t vertexCount, std::uint32_t instanceCount, std::uint32_t startVertex, std::uint32_t startInstance) = 0;
+		virtual void DrawIndexed(std::uint32_t indexCount, std::uint32_t startIndex, std::int32_t baseVertex) = 0;
+		virtual void DrawIndexedInstanced(std::uint32_t indexCount, std::uint32_t instanceCount, std::uint32_t startIndex, std::int32_t baseVertex, std::uint32_t startInstance) = 0;
+
+		// Draws alpha-blended sprites from the font's sprite sheet over the current render target. Only the immediate encoder draws
+		// text, and afterwards every binding is undefined until it is set again.
+		virtual void DrawGlyphs(FontHandle font, const GlyphSprite* glyphs, std::uint32_t count) = 0;
+
+		// Running totals of the calls passed on to the device and those dropped because they changed nothing.
+		virtual std::uint32_t IssuedCallCount() const = 0;
+		virtual std::uint32_t FilteredCallCount() const = 0;
+
+		static const std::uint32_t MaxVertexBuffers = 16;
+		static const std::uint32_t MaxConstantBuffers = 14;
+		static const std::uint32_t MaxTextures = 16;
+
+	protected:
+		CommandEncoder() = default;
+		CommandEncoder(const CommandEncoder&) = delete;
+		CommandEncoder& operator=(const CommandEncoder&) = delete;
+		CommandEncoder(CommandEncoder&&) = delete;
+		CommandEncoder& operator=(CommandEncoder&&) = delete;
+	};
+
+	// A thin render hardware interface: components create buffers, textures, shaders and pipeline states through it and draw with
+	// its encoder, so the same code runs on Direct3D 11 or on the null device. Nothing in this header depends on Windows.
+	class RenderDevice
+	{
+	public:
+		virtual ~RenderDevice() = default;
+
+		virtual const char* Name() const = 0;
+
+		// Whether constant buffers can be bound in ranges (CommandEncoder::SetConstantBufferRange()) and mapped with
+		// MapMode::NoOverwrite.
+		virtual bool SupportsConstantBufferOffsets() const = 0;
+
+		// initialData may be null for Default and Dynamic buffers.
+		virtual BufferHandle CreateBuffer(const BufferDescription& description, const void* initialData) = 0;
+		virtual TextureHandle CreateTextureFromFile(const std::wstring& filename) = 0;
+
+		// Resamples each file into its own width x height slice of a texture array and generates the mip chain, so textures of
+		// different sizes and formats can be indexed by one draw.
+		virtual TextureHandle CreateTextureArrayFromFiles(const std::vector<std::wstring>& filenames, std::uint32_t width, std::uint32_t height) = 0;
+		virtual ShaderHandle CreateShader(ShaderStage stage, const std::vector<char>& bytecode) = 0;
+		virtual PipelineStateHandle CreatePipelineState(const PipelineStateDescription& description) = 0;
+
+		// Loads a sprite font. The caller lays out text from the font's glyphs and draws it with CommandEncoder::DrawGlyphs().
+		virtual FontHandle CreateFontFromFile(const std::wstring& filename) = 0;
+		virtual float LineSpacing(FontHandle font) = 0;
+
+		// Characters the font lacks get its default glyph.
+		virtual FontGlyph Glyph(FontHandle font, wchar_t character) = 0;
+
+		// The device releases everything it created when it is destroyed; Destroy() releases an object early.
+		// Destroying a null handle does nothing.
+		virtual void Destroy(BufferHandle buffer) = 0;
+		virtual void Destroy(TextureHandle texture) = 0;
+		virtual void Destroy(ShaderHandle shader) = 0;
+		virtual void Destroy(PipelineStateHandle pipelineState) = 0;
+		virtual void Destroy(FontHandle font) = 0;
+
+		virtual CommandEncoder& ImmediateEncoder() = 0;
+
+		// Deferred encoders record on worker threads for the immediate encoder to play back. BeginDeferred() and ExecuteDeferred()
+		// belong to the immediate encoder's thread; in between, one other thread may record into the encoder, which starts with
+		// nothing bound but the immediate encoder's render targets. Devices without them return false and must not be asked for one.
+		virtual bool SupportsDeferredEncoders() const = 0;
+		virtual CommandEncoder& BeginDeferred(std::uint32_t index) = 0;
+		virtual void ExecuteDeferred(std::uint32_t index) = 0;
+
+	protected:
+		RenderDevice() = default;
+		RenderDevice(const RenderDevice&) = delete;
+		RenderDevice& operator=(const RenderDevice&) = delete;
+		RenderDevice(RenderDevice&&) = delete;
+		RenderDevice& operator=(RenderDevice&&) = delete;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,474 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	const uint32_t RenderGraph::NoPhysicalTexture = UINT32_MAX;
+
+	bool TextureDescription::IsDepth() const
+	{
+		return (Format == TextureFormat::D24UNormS8UInt || Format == TextureFormat::D32Float);
+	}
+
+	uint64_t TextureDescription::ByteSize() const
+	{
+		uint64_t bytesPerPixel;
+		switch (Format)
+		{
+		case TextureFormat::R16G16B16A16Float:
+			bytesPerPixel = 8;
+			break;
+
+		default:
+			bytesPerPixel = 4;
+			break;
+		}
+
+		return static_cast<uint64_t>(Width) * Height * bytesPerPixel;
+	}
+
+	bool TextureDescription::operator==(const TextureDescription& rhs) const
+	{
+		return (Width == rhs.Width && Height == rhs.Height && Format == rhs.Format);
+	}
+
+	bool TextureDescription::operator!=(const TextureDescription& rhs) const
+	{
+		return !(*this == rhs);
+	}
+
+	ClearValue::ClearValue(float red, float green, float blue, float alpha) :
+		Depth(1.0f), Stencil(0)
+	{
+		Color[0] = red;
+		Color[1] = green;
+		Color[2] = blue;
+		Color[3] = alpha;
+	}
+
+	ClearValue ClearValue::DepthStencil(float depth, uint8_t stencil)
+	{
+		ClearValue clearValue;
+		clearValue.Depth = depth;
+		clearValue.Stencil = stencil;
+
+		return clearValue;
+	}
+
+	RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, uint32_t pass) :
+		mGraph(&graph), mPass(pass)
+	{
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::Read(RenderGraphResource resource, ResourceState state)
+	{
+		mGraph->Resource(resource);
+
+		PassEntry& pass = mGraph->mPasses[mPass];
+		pass.Reads.emplace_back(resource, state);
+		pass.ReadResources.push_back(resource);
+		mGraph->mIsCompiled = false;
+
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::Write(RenderGraphResource resource)
+	{
+		mGraph->Resource(resource);
+
+		mGraph->mPasses[mPass].Writes.push_back(resource);
+		mGraph->mIsCompiled = false;
+
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::SetSideEffects()
+	{
+		mGraph->mPasses[mPass].HasSideEffects = true;
+		mGraph->mIsCompiled = false;
+
+		return *this;
+	}
+
+	uint32_t RenderGraph::PassBuilder::Pass() const
+	{
+		return mPass;
+	}
+
+	RenderGraph::RenderGraph() :
+		mTransientBytes(0), mAliasedTransientBytes(0), mIsCompiled(false)
+	{
+	}
+
+	RenderGraphResource RenderGraph::ImportTexture(const string& name, const TextureDescription& description, ResourceState initialState)
+	{
+		return AddResource(ResourceEntry(name, description, ClearValue(), initialState, true, false));
+	}
+
+	RenderGraphResource RenderGraph::ImportTexture(const string& name, const TextureDescription& description, ResourceState initialState, const ClearValue& clearValue)
+	{
+		return AddResource(ResourceEntry(name, description, clearValue, initialState, true, true));
+	}
+
+	RenderGraphResource RenderGraph::CreateTexture(const string& name, const TextureDescription& description, const ClearValue& clearValue)
+	{
+		return AddResource(ResourceEntry(name, description, clearValue, ResourceState::Undefined, false, true));
+	}
+
+	RenderGraph::PassBuilder RenderGraph::AddPass(const string& name, PassCallback callback)
+	{
+		mPasses.emplace_back(name, callback);
+		mIsCompiled = false;
+
+		return PassBuilder(*this, static_cast<uint32_t>(mPasses.size() - 1));
+	}
+
+	void RenderGraph::Compile()
+	{
+		// Every transient read must follow a write, and a pass cannot sample a texture it renders to.
+		vector<bool> isWritten(mResources.size(), false);
+		for (const PassEntry& pass : mPasses)
+		{
+			for (const ResourceAccess& read : pass.Reads)
+			{
+				const ResourceEntry& resource = Resource(read.Resource);
+				if (resource.IsImported == false && isWritten[read.Resource.Id - 1] == false)
+				{
+					throw GameException(("Render graph pass \"" + pass.Name + "\" reads \"" + resource.Name + "\" before any pass writes it.").c_str());
+				}
+
+				if (find(pass.Writes.begin(), pass.Writes.end(), read.Resource) != pass.Writes.end())
+				{
+					throw GameException(("Render graph pass \"" + pass.Name + "\" reads and writes \"" + resource.Name + "\".").c_str());
+				}
+			}
+
+			for (RenderGraphResource write : pass.Writes)
+			{
+				isWritten[write.Id - 1] = true;
+			}
+		}
+
+		CullPasses();
+		AssignPhysicalTextures();
+		ScheduleTransitions();
+		mIsCompiled = true;
+	}
+
+	void RenderGraph::Execute(RenderGraphExecutor& executor)
+	{
+		PROFILE_SCOPE("RenderGraph::Execute");
+
+		assert(mIsCompiled);
+
+		executor.PreparePhysicalTextures(mPhysicalTextures);
+
+		for (const CompiledPass& compiledPass : mCompiledPasses)
+		{
+			for (const RenderGraphBarrier& barrier : compiledPass.Barriers)
+			{
+				executor.ApplyBarrier(*this, barrier);
+			}
+
+			for (RenderGraphResource resource : compiledPass.Clears)
+			{
+				executor.Clear(*this, resource);
+			}
+
+			executor.BeginPass(*this, compiledPass.Pass);
+
+			const PassEntry& pass = mPasses[compiledPass.Pass];
+			if (pass.Callback != nullptr)
+			{
+				pass.Callback();
+			}
+
+			executor.EndPass(*this, compiledPass.Pass);
+		}
+	}
+
+	void RenderGraph::Reset()
+	{
+		mPasses.clear();
+		mResources.clear();
+		mCompiledPasses.clear();
+		mTransientBytes = 0;
+		mAliasedTransientBytes = 0;
+		mIsCompiled = false;
+	}
+
+	void RenderGraph::ReleaseTransientTextures()
+	{
+		mPhysicalTextures.clear();
+		for (ResourceEntry& resource : mResources)
+		{
+			resource.PhysicalTexture = NoPhysicalTexture;
+		}
+
+		mIsCompiled = false;
+	}
+
+	uint32_t RenderGraph::PassCount() const
+	{
+		return static_cast<uint32_t>(mPasses.size());
+	}
+
+	const string& RenderGraph::PassName(uint32_t pass) const
+	{
+		return mPasses.at(pass).Name;
+	}
+
+	const vector<RenderGraphResource>& RenderGraph::PassReads(uint32_t pass) const
+	{
+		return mPasses.at(pass).ReadResources;
+	}
+
+	const vector<RenderGraphResource>& RenderGraph::PassWrites(uint32_t pass) const
+	{
+		return mPasses.at(pass).Writes;
+	}
+
+	bool RenderGraph::IsPassCulled(uint32_t pass) const
+	{
+		return mPasses.at(pass).IsCulled;
+	}
+
+	uint32_t RenderGraph::ResourceCount() const
+	{
+		return static_cast<uint32_t>(mResources.size());
+	}
+
+	const string& RenderGraph::ResourceName(RenderGraphResource resource) const
+	{
+		return Resource(resource).Name;
+	}
+
+	const TextureDescription& RenderGraph::Description(RenderGraphResource resource) const
+	{
+		return Resource(resource).Description;
+	}
+
+	const ClearValue& RenderGraph::ResourceClearValue(RenderGraphResource resource) const
+	{
+		return Resource(resource).Clear;
+	}
+
+	bool RenderGraph::IsImported(RenderGraphResource resource) const
+	{
+		return Resource(resource).IsImported;
+	}
+
+	uint32_t RenderGraph::PhysicalTexture(RenderGraphResource resource) const
+	{
+		return Resource(resource).PhysicalTexture;
+	}
+
+	const vector<RenderGraph::CompiledPass>& RenderGraph::CompiledPasses() const
+	{
+		return mCompiledPasses;
+	}
+
+	const vector<TextureDescription>& RenderGraph::PhysicalTextures() const
+	{
+		return mPhysicalTextures;
+	}
+
+	uint64_t RenderGraph::TransientBytes() const
+	{
+		return mTransientBytes;
+	}
+
+	uint64_t RenderGraph::AliasedTransientBytes() const
+	{
+		return mAliasedTransientBytes;
+	}
+
+	ResourceState RenderGraph::WriteState(const TextureDescription& description)
+	{
+		return (description.IsDepth() ? ResourceState::DepthWrite : ResourceState::RenderTarget);
+	}
+
+	RenderGraphResource RenderGraph::AddResource(const ResourceEntry& entry)
+	{
+		mResources.push_back(entry);
+		mIsCompiled = false;
+
+		return RenderGraphResource(static_cast<uint32_t>(mResources.size()));
+	}
+
+	RenderGraph::ResourceEntry& RenderGraph::Resource(RenderGraphResource resource)
+	{
+		if (resource.IsValid() == false || resource.Id > mResources.size())
+		{
+			throw GameException("Invalid render graph resource.");
+		}
+
+		return mResources[resource.Id - 1];
+	}
+
+	const RenderGraph::ResourceEntry& RenderGraph::Resource(RenderGraphResource resource) const
+	{
+		if (resource.IsValid() == false || resource.Id > mResources.size())
+		{
+			throw GameException("Invalid render graph resource.");
+		}
+
+		return mResources[resource.Id - 1];
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		// Walk back from the passes that must run. Writes load what was there before, so a kept pass keeps the earlier writers of
+		// everything it reads or writes.
+		vector<bool> isNeeded(mResources.size(), false);
+		for (auto it = mPasses.rbegin(); it != mPasses.rend(); ++it)
+		{
+			PassEntry& pass = *it;
+
+			bool isKept = pass.HasSideEffects;
+			for (RenderGraphResource write : pass.Writes)
+			{
+				isKept = isKept || Resource(write).IsImported || isNeeded[write.Id - 1];
+			}
+
+			pass.IsCulled = (isKept == false);
+			if (isKept)
+			{
+				for (RenderGraphResource write : pass.Writes)
+				{
+					isNeeded[write.Id - 1] = true;
+				}
+
+				for (const ResourceAccess& read : pass.Reads)
+				{
+					isNeeded[read.Resource.Id - 1] = true;
+				}
+			}
+		}
+
+		mCompiledPasses.clear();
+		for (uint32_t pass = 0; pass < mPasses.size(); ++pass)
+		{
+			if (mPasses[pass].IsCulled == false)
+			{
+				mCompiledPasses.emplace_back(pass);
+			}
+		}
+	}
+
+	void RenderGraph::AssignPhysicalTextures()
+	{
+		// Lifetimes are in compiled pass indices
+		vector<uint32_t> firstUse(mResources.size(), UINT32_MAX);
+		vector<uint32_t> lastUse(mResources.size(), 0);
+		for (uint32_t index = 0; index < mCompiledPasses.size(); ++index)
+		{
+			const PassEntry& pass = mPasses[mCompiledPasses[index].Pass];
+			for (RenderGraphResource resource : pass.Writes)
+			{
+				firstUse[resource.Id - 1] = min(firstUse[resource.Id - 1], index);
+				lastUse[resource.Id - 1] = max(lastUse[resource.Id - 1], index);
+			}
+
+			for (RenderGraphResource resource : pass.ReadResources)
+			{
+				firstUse[resource.Id - 1] = min(firstUse[resource.Id - 1], index);
+				lastUse[resource.Id - 1] = max(lastUse[resource.Id - 1], index);
+			}
+		}
+
+		vector<uint32_t> transients;
+		for (uint32_t resource = 0; resource < mResources.size(); ++resource)
+		{
+			mResources[resource].PhysicalTexture = NoPhysicalTexture;
+			if (mResources[resource].IsImported == false && firstUse[resource] != UINT32_MAX)
+			{
+				transients.push_back(resource);
+			}
+		}
+
+		stable_sort(transients.begin(), transients.end(), [&firstUse](uint32_t lhs, uint32_t rhs)
+		{
+			return firstUse[lhs] < firstUse[rhs];
+		});
+
+		// Each transient takes the lowest-numbered matching texture that is free by its first use, so the result only depends on
+		// the graph and the pool.
+		vector<bool> isUsed(mPhysicalTextures.size(), false);
+		vector<uint32_t> busyUntil(mPhysicalTextures.size(), 0);
+		mTransientBytes = 0;
+		mAliasedTransientBytes = 0;
+		for (uint32_t resource : transients)
+		{
+			ResourceEntry& entry = mResources[resource];
+			mTransientBytes += entry.Description.ByteSize();
+
+			uint32_t physicalTexture = 0;
+			while (physicalTexture < mPhysicalTextures.size() &&
+				(mPhysicalTextures[physicalTexture] != entry.Description || (isUsed[physicalTexture] && busyUntil[physicalTexture] >= firstUse[resource])))
+			{
+				++physicalTexture;
+			}
+
+			if (physicalTexture == mPhysicalTextures.size())
+			{
+				mPhysicalTextures.push_back(entry.Description);
+				isUsed.push_back(false);
+				busyUntil.push_back(0);
+			}
+
+			if (isUsed[physicalTexture] == false)
+			{
+				mAliasedTransientBytes += entry.Description.ByteSize();
+				isUsed[physicalTexture] = true;
+			}
+
+			busyUntil[physicalTexture] = lastUse[resource];
+			entry.PhysicalTexture = physicalTexture;
+		}
+	}
+
+	void RenderGraph::ScheduleTransitions()
+	{
+		vector<ResourceState> states;
+		vector<bool> isWritten(mResources.size(), false);
+		states.reserve(mResources.size());
+		for (const ResourceEntry& resource : mResources)
+		{
+			states.push_back(resource.InitialState);
+		}
+
+		for (CompiledPass& compiledPass : mCompiledPasses)
+		{
+			const PassEntry& pass = mPasses[compiledPass.Pass];
+			for (const ResourceAccess& read : pass.Reads)
+			{
+				ResourceState& state = states[read.Resource.Id - 1];
+				if (state != read.State)
+				{
+					compiledPass.Barriers.emplace_back(read.Resource, state, read.State);
+					state = read.State;
+				}
+			}
+
+			for (RenderGraphResource write : pass.Writes)
+			{
+				const ResourceEntry& resource = Resource(write);
+				ResourceState writeState = WriteState(resource.Description);
+				ResourceState& state = states[write.Id - 1];
+				if (state != writeState)
+				{
+					compiledPass.Barriers.emplace_back(write, state, writeState);
+					state = writeState;
+				}
+
+				if (isWritten[write.Id - 1] == false && resource.ClearsOnFirstWrite)
+				{
+					compiledPass.Clears.push_back(write);
+				}
+				isWritten[write.Id - 1] = true;
+			}
+		}
+	}
+}
\ No newline at end of file
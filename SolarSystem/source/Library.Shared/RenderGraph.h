@@ -0,0 +1,246 @@
+#pragma once
+
+#include "RenderDevice.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+
+namespace Library
+{
+	class RenderGraphExecutor;
+
+	typedef RenderHandle<struct RenderGraphResourceTag> RenderGraphResource;
+
+	enum class TextureFormat
+	{
+		R8G8B8A8UNorm,
+		R16G16B16A16Float,
+		R11G11B10Float,
+		R32Float,
+		D24UNormS8UInt,
+		D32Float
+	};
+
+	enum class ResourceState
+	{
+		Undefined,
+		RenderTarget,
+		DepthWrite,
+		ShaderResource,
+		Present
+	};
+
+	struct TextureDescription
+	{
+		std::uint32_t Width;
+		std::uint32_t Height;
+		TextureFormat Format;
+
+		TextureDescription(std::uint32_t width = 0, std::uint32_t height = 0, TextureFormat format = TextureFormat::R8G8B8A8UNorm) :
+			Width(width), Height(height), Format(format) { }
+
+		bool IsDepth() const;
+		std::uint64_t ByteSize() const;
+
+		bool operator==(const TextureDescription& rhs) const;
+		bool operator!=(const TextureDescription& rhs) const;
+	};
+
+	struct ClearValue
+	{
+		float Color[4];
+		float Depth;
+		std::uint8_t Stencil;
+
+		ClearValue(float red = 0.0f, float green = 0.0f, float blue = 0.0f, float alpha = 0.0f);
+
+		static ClearValue DepthStencil(float depth = 1.0f, std::uint8_t stencil = 0);
+	};
+
+	struct RenderGraphBarrier
+	{
+		RenderGraphResource Resource;
+		ResourceState Before;
+		ResourceState After;
+
+		RenderGraphBarrier(RenderGraphResource resource, ResourceState before, ResourceState after) :
+			Resource(resource), Before(before), After(after) { }
+	};
+
+	// Describes a frame as passes that read and write logical textures, then schedules it. Compile() culls passes whose results
+	// nothing uses, assigns transient textures to pooled physical textures (aliasing textures whose lifetimes don't overlap),
+	// and works out the state transitions and clears each pass needs. Execute() replays that schedule through an executor.
+	// Compilation is deterministic: passes run in the order they were added and ties are broken by declaration order.
+	// Nothing in this header depends on Windows.
+	class RenderGraph final
+	{
+	public:
+		typedef std::function<void()> PassCallback;
+
+		class PassBuilder final
+		{
+			friend class RenderGraph;
+
+		public:
+			// Reads are shader resource reads unless another state (e.g. Present) is given.
+			PassBuilder& Read(RenderGraphResource resource, ResourceState state = ResourceState::ShaderResource);
+
+			// Writes keep what earlier passes wrote; a texture is cleared before the first pass that writes it.
+			PassBuilder& Write(RenderGraphResource resource);
+
+			// Passes with side effects (e.g. Present) are never culled.
+			PassBuilder& SetSideEffects();
+
+			std::uint32_t Pass() const;
+
+		private:
+			PassBuilder(RenderGraph& graph, std::uint32_t pass);
+
+			RenderGraph* mGraph;
+			std::uint32_t mPass;
+		};
+
+		struct CompiledPass
+		{
+			std::uint32_t Pass;
+			std::vector<RenderGraphBarrier> Barriers;
+			std::vector<RenderGraphResource> Clears;
+
+			explicit CompiledPass(std::uint32_t pass) :
+				Pass(pass) { }
+		};
+
+		RenderGraph();
+		RenderGraph(const RenderGraph&) = delete;
+		RenderGraph& operator=(const RenderGraph&) = delete;
+		RenderGraph(RenderGraph&&) = delete;
+		RenderGraph& operator=(RenderGraph&&) = delete;
+		~RenderGraph() = default;
+
+		// Imported textures live outside the graph (e.g. the back buffer). Passes that write them are never culled, and they are
+		// only cleared when a clear value is given.
+		RenderGraphResource ImportTexture(const std::string& name, const TextureDescription& description, ResourceState initialState);
+		RenderGraphResource ImportTexture(const std::string& name, const TextureDescription& description, ResourceState initialState, const ClearValue& clearValue);
+
+		// Transient textures only exist while the graph runs. Their contents are undefined until the first write, which clears them.
+		RenderGraphResource CreateTexture(const std::string& name, const TextureDescription& description, const ClearValue& clearValue = ClearValue());
+
+		PassBuilder AddPass(const std::string& name, PassCallback callback);
+
+		// Throws GameException if a pass reads a transient texture that nothing has written.
+		void Compile();
+		void Execute(RenderGraphExecutor& executor);
+
+		// Forgets every pass and resource. The physical textures are kept, so a graph rebuilt every frame reuses them.
+		void Reset();
+
+		// Empties the pool, e.g. after the render target size changes.
+		void ReleaseTransientTextures();
+
+		std::uint32_t PassCount() const;
+		const std::string& PassName(std::uint32_t pass) const;
+		const std::vector<RenderGraphResource>& PassReads(std::uint32_t pass) const;
+		const std::vector<RenderGraphResource>& PassWrites(std::uint32_t pass) const;
+		bool IsPassCulled(std::uint32_t pass) const;
+
+		std::uint32_t ResourceCount() const;
+		const std::string& ResourceName(RenderGraphResource resource) const;
+		const TextureDescription& Description(RenderGraphResource resource) const;
+		const ClearValue& ResourceClearValue(RenderGraphResource resource) const;
+		bool IsImported(RenderGraphResource resource) const;
+
+		// NoPhysicalTexture for imported textures and textures only used by culled passes.
+		std::uint32_t PhysicalTexture(RenderGraphResource resource) const;
+
+		// Results of the last Compile().
+		const std::vector<CompiledPass>& CompiledPasses() const;
+		const std::vector<TextureDescription>& PhysicalTextures() const;
+
+		// Memory for the transient textures the compiled passes use: one texture each, and the physical textures they alias onto.
+		std::uint64_t TransientBytes() const;
+		std::uint64_t AliasedTransientBytes() const;
+
+		static const std::uint32_t NoPhysicalTexture;
+
+	private:
+		struct ResourceAccess
+		{
+			RenderGraphResource Resource;
+			ResourceState State;
+
+			ResourceAccess(RenderGraphResource resource, ResourceState state) :
+				Resource(resource), State(state) { }
+		};
+
+		struct PassEntry
+		{
+			std::string Name;
+			PassCallback Callback;
+			std::vector<ResourceAccess> Reads;
+			std::vector<RenderGraphResource> ReadResources;
+			std::vector<RenderGraphResource> Writes;
+			bool HasSideEffects;
+			bool IsCulled;
+
+			PassEntry(const std::string& name, PassCallback callback) :
+				Name(name), Callback(callback), HasSideEffects(false), IsCulled(false) { }
+		};
+
+		struct ResourceEntry
+		{
+			std::string Name;
+			TextureDescription Description;
+			ClearValue Clear;
+			ResourceState InitialState;
+			bool IsImported;
+			bool ClearsOnFirstWrite;
+			std::uint32_t PhysicalTexture;
+
+			ResourceEntry(const std::string& name, const TextureDescription& description, const ClearValue& clearValue, ResourceState initialState, bool isImported, bool clearsOnFirstWrite) :
+				Name(name), Description(description), Clear(clearValue), InitialState(initialState), IsImported(isImported),
+				ClearsOnFirstWrite(clearsOnFirstWrite), PhysicalTexture(NoPhysicalTexture) { }
+		};
+
+		static ResourceState WriteState(const TextureDescription& description);
+
+		RenderGraphResource AddResource(const ResourceEntry& entry);
+		ResourceEntry& Resource(RenderGraphResource resource);
+		const ResourceEntry& Resource(RenderGraphResource resource) const;
+		void CullPasses();
+		void AssignPhysicalTextures();
+		void ScheduleTransitions();
+
+		std::vector<PassEntry> mPasses;
+		std::vector<ResourceEntry> mResources;
+		std::vector<CompiledPass> mCompiledPasses;
+		std::vector<TextureDescription> mPhysicalTextures;
+		std::uint64_t mTransientBytes;
+		std::uint64_t mAliasedTransientBytes;
+		bool mIsCompiled;
+	};
+
+	// Carries out a compiled graph on a particular API. Every call refers to resources through the graph that is executing.
+	class RenderGraphExecutor
+	{
+	public:
+		virtual ~RenderGraphExecutor() = default;
+
+		// Called before each execution with the whole pool. A physical texture keeps its index until the pool is released.
+		virtual void PreparePhysicalTextures(const std::vector<TextureDescription>& physicalTextures) = 0;
+
+		virtual void ApplyBarrier(const RenderGraph& graph, const RenderGraphBarrier& barrier) = 0;
+		virtual void Clear(const RenderGraph& graph, RenderGraphResource resource) = 0;
+
+		// Brackets the pass's callback; binds the textures the pass writes.
+		virtual void BeginPass(const RenderGraph& graph, std::uint32_t pass) = 0;
+		virtual void EndPass(const RenderGraph& graph, std::uint32_t pass) = 0;
+
+	protected:
+		RenderGraphExecutor() = default;
+		RenderGraphExecutor(const RenderGraphExecutor&) = delete;
+		RenderGraphExecutor& operator=(const RenderGraphExecutor&) = delete;
+		RenderGraphExecutor(RenderGraphExecutor&&) = delete;
+		RenderGraphExecutor& operator=(RenderGraphExecutor&&) = delete;
+	};
+}
\ No newline at end of file
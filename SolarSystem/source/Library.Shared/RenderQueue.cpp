@@ -0,0 +1,473 @@
+#include "pch.h"
+#include <chrono>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace Library
+{
+	const uint32_t RenderQueue::NoCallback = UINT32_MAX;
+	const uint32_t RenderQueue::MinPacketsPerPartition = 64;
+
+	RenderQueue::TextureState::TextureState(initializer_list<TextureHandle> textures) :
+		Textures(), TextureCount(0)
+	{
+		assert(textures.size() <= MaxTextures);
+
+		for (TextureHandle texture : textures)
+		{
+			Textures[TextureCount++] = texture;
+		}
+	}
+
+	RenderQueue::DrawPacket::DrawPacket() :
+		VertexBuffers(), Strides(), VertexBufferCount(0), IndexBuffer(), VSConstantBufferCount(0), PSConstantBufferCount(0),
+		ElementCount(0), InstanceCount(0), StartInstance(0)
+	{
+	}
+
+	void RenderQueue::DrawPacket::AddVertexBuffer(BufferHandle vertexBuffer, uint32_t stride)
+	{
+		assert(VertexBufferCount < MaxVertexBuffers);
+
+		VertexBuffers[VertexBufferCount] = vertexBuffer;
+		Strides[VertexBufferCount] = stride;
+		++VertexBufferCount;
+	}
+
+	void RenderQueue::DrawPacket::AddVSConstantBuffer(const ConstantBufferRing::Allocation& allocation)
+	{
+		assert(VSConstantBufferCount < MaxConstantBuffers);
+
+		VSConstantBuffers[VSConstantBufferCount++] = allocation;
+	}
+
+	void RenderQueue::DrawPacket::AddPSConstantBuffer(const ConstantBufferRing::Allocation& allocation)
+	{
+		assert(PSConstantBufferCount < MaxConstantBuffers);
+
+		PSConstantBuffers[PSConstantBufferCount++] = allocation;
+	}
+
+	RenderQueue::BoundState::BoundState() :
+		PipelineState(UINT32_MAX), Textures(UINT32_MAX), Packet(nullptr)
+	{
+	}
+
+	RenderQueue::RenderQueue(RenderDevice& device, ConstantBufferRing& constantBuffers, ThreadPool& workers) :
+		mDevice(&device), mConstantBuffers(&constantBuffers), mWorkers(&workers), mMultithreadedRecording(false),
+		mPacketCount(0), mStateChangeCount(0), mUnsortedStateChangeCount(0), mIssuedCallCount(0), mFilteredCallCount(0)
+	{
+	}
+
+	uint32_t RenderQueue::RegisterPipelineState(PipelineStateHandle pipelineState)
+	{
+		assert(pipelineState.IsValid());
+
+		for (uint32_t i = 0; i < mPipelineStates.size(); ++i)
+		{
+			if (mPipelineStates[i] == pipelineState)
+			{
+				return i;
+			}
+		}
+
+		assert(mPipelineStates.size() < (1U << DrawKey::ShaderBits));
+		mPipelineStates.push_back(pipelineState);
+
+		return static_cast<uint32_t>(mPipelineStates.size() - 1);
+	}
+
+	uint32_t RenderQueue::RegisterTextures(const TextureState& textureState)
+	{
+		for (uint32_t i = 0; i < mTextures.size(); ++i)
+		{
+			const TextureState& existing = mTextures[i];
+			if (existing.TextureCount == textureState.TextureCount &&
+				equal(existing.Textures, existing.Textures + existing.TextureCount, textureState.Textures))
+			{
+				return i;
+			}
+		}
+
+		assert(mTextures.size() < (1U << DrawKey::TextureBits));
+		mTextures.push_back(textureState);
+
+		return static_cast<uint32_t>(mTextures.size() - 1);
+	}
+
+	void RenderQueue::Submit(RenderLayer layer, uint32_t pipelineState, uint32_t textures, float depth, const DrawPacket& packet)
+	{
+		assert(pipelineState < mPipelineStates.size());
+		assert(textures < mTextures.size());
+
+		mEntries.emplace_back(DrawKey::Encode(layer, pipelineState, 0, textures, DrawKey::QuantizeDepth(depth)), static_cast<uint32_t>(mPackets.size()));
+		mPackets.emplace_back(packet, NoCallback);
+	}
+
+	void RenderQueue::SubmitCallback(RenderLayer layer, function<void()> callback)
+	{
+		mEntries.emplace_back(DrawKey::Encode(layer, 0, 0, 0, 0), static_cast<uint32_t>(mPackets.size()));
+		mPackets.emplace_back(DrawPacket(), static_cast<uint32_t>(mCallbacks.size()));
+		mCallbacks.push_back(move(callback));
+	}
+
+	void RenderQueue::Execute()
+	{
+		PROFILE_SCOPE("RenderQueue::Execute");
+
+		// Count what submission order would have cost before sorting, for comparison.
+		uint32_t entryCount = static_cast<uint32_t>(mEntries.size());
+		uint32_t unsortedStateChangeCount = Issue(nullptr, 0, entryCount);
+
+		mSorter.Sort(mEntries);
+
+		uint32_t stateChangeCount;
+		if (MultithreadedRecording())
+		{
+			stateChangeCount = ExecuteRecorded();
+		}
+		else
+		{
+			CommandEncoder& encoder = mDevice->ImmediateEncoder();
+			uint32_t issuedCallCount = encoder.IssuedCallCount();
+			uint32_t filteredCallCount = encoder.FilteredCallCount();
+
+			mPartitionStatistics.clear();
+			stateChangeCount = Issue(&encoder, 0, entryCount);
+
+			mIssuedCallCount = encoder.IssuedCallCount() - issuedCallCount;
+			mFilteredCallCount = encoder.FilteredCallCount() - filteredCallCount;
+		}
+
+		mPacketCount = static_cast<uint32_t>(mPackets.size());
+		mStateChangeCount = stateChangeCount;
+		mUnsortedStateChangeCount = unsortedStateChangeCount;
+
+		Clear();
+	}
+
+	void RenderQueue::Clear()
+	{
+		mPackets.clear();
+		mCallbacks.clear();
+		mEntries.clear();
+	}
+
+	uint32_t RenderQueue::PacketCount() const
+	{
+		return mPacketCount;
+	}
+
+	uint32_t RenderQueue::StateChangeCount() const
+	{
+		return mStateChangeCount;
+	}
+
+	uint32_t RenderQueue::UnsortedStateChangeCount() const
+	{
+		return mUnsortedStateChangeCount;
+	}
+
+	uint32_t RenderQueue::SortPassCount() const
+	{
+		return mSorter.PassCount();
+	}
+
+	uint32_t RenderQueue::IssuedCallCount() const
+	{
+		return mIssuedCallCount;
+	}
+
+	uint32_t RenderQueue::FilteredCallCount() const
+	{
+		return mFilteredCallCount;
+	}
+
+	const vector<RenderQueue::RecordingStatistics>& RenderQueue::PartitionStatistics() const
+	{
+		return mPartitionStatistics;
+	}
+
+	void RenderQueue::SetMultithreadedRecording(bool enabled)
+	{
+		mMultithreadedRecording = enabled;
+	}
+
+	bool RenderQueue::MultithreadedRecording() const
+	{
+		return (mMultithreadedRecording && SupportsCommandLists());
+	}
+
+	bool RenderQueue::SupportsCommandLists() const
+	{
+		return mDevice->SupportsDeferredEncoders();
+	}
+
+	uint32_t RenderQueue::Issue(CommandEncoder* encoder, uint32_t first, uint32_t last) const
+	{
+		uint32_t stateChangeCount = 0;
+		BoundState boundState;
+
+		for (uint32_t i = first; i < last; ++i)
+		{
+			const DrawKeyEntry& entry = mEntries[i];
+			const QueuedPacket& queuedPacket = mPackets[entry.Index];
+			if (queuedPacket.Callback == NoCallback)
+			{
+				stateChangeCount += ApplyState(encoder, entry.Key, queuedPacket.Packet, boundState);
+				if (encoder != nullptr)
+				{
+					IssueDraw(*encoder, queuedPacket.Packet);
+				}
+			}
+			else
+			{
+				if (encoder != nullptr)
+				{
+					mCallbacks[queuedPacket.Callback]();
+				}
+
+				boundState = BoundState();
+			}
+		}
+
+		return stateChangeCount;
+	}
+
+	uint32_t RenderQueue::ExecuteRecorded()
+	{
+		ThreadPool& workers = *mWorkers;
+
+		// Callbacks run on the immediate encoder, so they split the sorted draws into independent runs.
+		mPartitions.clear();
+		uint32_t entryCount = static_cast<uint32_t>(mEntries.size());
+		uint32_t runStart = 0;
+		for (uint32_t i = 0; i < entryCount; ++i)
+		{
+			uint32_t callback = mPackets[mEntries[i].Index].Callback;
+			if (callback != NoCallback)
+			{
+				AddPartitions(runStart, i, workers.ThreadCount());
+				mPartitions.emplace_back(i, i + 1, callback);
+				runStart = i + 1;
+			}
+		}
+		AddPartitions(runStart, entryCount, workers.ThreadCount());
+
+		uint32_t partitionCount = static_cast<uint32_t>(mPartitions.size());
+		mPartitionStatistics.assign(partitionCount, RecordingStatistics());
+
+		vector<future<void>> recordings(partitionCount);
+		uint32_t encoderIndex = 0;
+		for (uint32_t i = 0; i < partitionCount; ++i)
+		{
+			Partition& partition = mPartitions[i];
+			if (partition.Callback != NoCallback)
+			{
+				continue;
+			}
+
+			partition.Encoder = encoderIndex++;
+			CommandEncoder* encoder = &mDevice->BeginDeferred(partition.Encoder);
+			RecordingStatistics& statistics = mPartitionStatistics[i];
+
+			recordings[i] = workers.Enqueue([this, &partition, &statistics, encoder]()
+			{
+				PROFILE_SCOPE("RenderQueue::RecordPartition");
+				auto start = high_resolution_clock::now();
+
+				uint32_t issuedCallCount = encoder->IssuedCallCount();
+				uint32_t filteredCallCount = encoder->FilteredCallCount();
+				partition.StateChangeCount = Issue(encoder, partition.First, partition.Last);
+				partition.IssuedCallCount = encoder->IssuedCallCount() - issuedCallCount;
+				partition.FilteredCallCount = encoder->FilteredCallCount() - filteredCallCount;
+
+				statistics.PacketCount = partition.Last - partition.First;
+				statistics.ThreadId = this_thread::get_id();
+				statistics.RecordingMilliseconds = duration<double, milli>(high_resolution_clock::now() - start).count();
+			});
+		}
+
+		// Play back in sorted order as each partition finishes recording, so the output matches the single-threaded path.
+		uint32_t stateChangeCount = 0;
+		mIssuedCallCount = 0;
+		mFilteredCallCount = 0;
+		for (uint32_t i = 0; i < partitionCount; ++i)
+		{
+			Partition& partition = mPartitions[i];
+			if (partition.Callback == NoCallback)
+			{
+				recordings[i].get();
+				mDevice->ExecuteDeferred(partition.Encoder);
+				stateChangeCount += partition.StateChangeCount;
+				mIssuedCallCount += partition.IssuedCallCount;
+				mFilteredCallCount += partition.FilteredCallCount;
+			}
+			else
+			{
+				mCallbacks[partition.Callback]();
+			}
+		}
+
+		// Callback partitions have nothing to report.
+		auto end = remove_if(mPartitionStatistics.begin(), mPartitionStatistics.end(), [](const RecordingStatistics& statistics) { return statistics.PacketCount == 0; });
+		mPartitionStatistics.erase(end, mPartitionStatistics.end());
+		mPartitions.clear();
+
+		return stateChangeCount;
+	}
+
+	void RenderQueue::AddPartitions(uint32_t first, uint32_t last, uint32_t workerCount)
+	{
+		uint32_t packetCount = last - first;
+		if (packetCount == 0)
+		{
+			return;
+		}
+
+		uint32_t partitionCount = packetCount / MinPacketsPerPartition;
+		if (partitionCount > workerCount)
+		{
+			partitionCount = workerCount;
+		}
+
+		if (partitionCount == 0)
+		{
+			partitionCount = 1;
+		}
+
+		for (uint32_t i = 0; i < partitionCount; ++i)
+		{
+			mPartitions.emplace_back(first + packetCount * i / partitionCount, first + packetCount * (i + 1) / partitionCount, NoCallback);
+		}
+	}
+
+	uint32_t RenderQueue::ApplyState(CommandEncoder* encoder, uint64_t key, const DrawPacket& packet, BoundState& boundState) const
+	{
+		bool issue = (encoder != nullptr);
+		const DrawPacket* boundPacket = boundState.Packet;
+		uint32_t stateChangeCount = 0;
+
+		uint32_t pipelineState = DrawKey::Shader(key);
+		if (pipelineState != boundState.PipelineState)
+		{
+			if (issue)
+			{
+				encoder->SetPipelineState(mPipelineStates[pipelineState]);
+			}
+
+			boundState.PipelineState = pipelineState;
+			++stateChangeCount;
+		}
+
+		uint32_t textures = DrawKey::Texture(key);
+		if (textures != boundState.Textures)
+		{
+			if (issue)
+			{
+				const TextureState& textureState = mTextures[textures];
+				for (uint32_t i = 0; i < textureState.TextureCount; ++i)
+				{
+					encoder->SetTexture(ShaderStage::Pixel, i, textureState.Textures[i]);
+				}
+			}
+
+			boundState.Textures = textures;
+			++stateChangeCount;
+		}
+
+		if (boundPacket == nullptr || boundPacket->VertexBufferCount != packet.VertexBufferCount ||
+			equal(packet.VertexBuffers, packet.VertexBuffers + packet.VertexBufferCount, boundPacket->VertexBuffers) == false ||
+			equal(packet.Strides, packet.Strides + packet.VertexBufferCount, boundPacket->Strides) == false)
+		{
+			if (issue)
+			{
+				for (uint32_t i = 0; i < packet.VertexBufferCount; ++i)
+				{
+					encoder->SetVertexBuffer(i, packet.VertexBuffers[i], packet.Strides[i], 0);
+				}
+			}
+
+			++stateChangeCount;
+		}
+
+		if (boundPacket == nullptr || boundPacket->IndexBuffer != packet.IndexBuffer)
+		{
+			if (issue && packet.IndexBuffer.IsValid())
+			{
+				encoder->SetIndexBuffer(packet.IndexBuffer, IndexFormat::UInt32, 0);
+			}
+
+			++stateChangeCount;
+		}
+
+		auto sameConstantBuffers = [](const ConstantBufferRing::Allocation* lhs, uint32_t lhsCount, const ConstantBufferRing::Allocation* rhs, uint32_t rhsCount)
+		{
+			if (lhsCount != rhsCount)
+			{
+				return false;
+			}
+
+			for (uint32_t i = 0; i < lhsCount; ++i)
+			{
+				if (lhs[i].Buffer != rhs[i].Buffer || lhs[i].FirstConstant != rhs[i].FirstConstant || lhs[i].ConstantCount != rhs[i].ConstantCount)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		};
+
+		if (boundPacket == nullptr || sameConstantBuffers(packet.VSConstantBuffers, packet.VSConstantBufferCount, boundPacket->VSConstantBuffers, boundPacket->VSConstantBufferCount) == false)
+		{
+			if (issue && packet.VSConstantBufferCount > 0)
+			{
+				mConstantBuffers->SetConstantBuffers(*encoder, ShaderStage::Vertex, 0, packet.VSConstantBufferCount, packet.VSConstantBuffers);
+			}
+
+			++stateChangeCount;
+		}
+
+		if (boundPacket == nullptr || sameConstantBuffers(packet.PSConstantBuffers, packet.PSConstantBufferCount, boundPacket->PSConstantBuffers, boundPacket->PSConstantBufferCount) == false)
+		{
+			if (issue && packet.PSConstantBufferCount > 0)
+			{
+				mConstantBuffers->SetConstantBuffers(*encoder, ShaderStage::Pixel, 0, packet.PSConstantBufferCount, packet.PSConstantBuffers);
+			}
+
+			++stateChangeCount;
+		}
+
+		boundState.Packet = &packet;
+
+		return stateChangeCount;
+	}
+
+	void RenderQueue::IssueDraw(CommandEncoder& encoder, const DrawPacket& packet) const
+	{
+		if (packet.IndexBuffer.IsValid())
+		{
+			if (packet.InstanceCount > 0)
+			{
+				encoder.DrawIndexedInstanced(packet.ElementCount, packet.InstanceCount, 0, 0, packet.StartInstance);
+			}
+			else
+			{
+				encoder.DrawIndexed(packet.ElementCount, 0, 0);
+			}
+		}
+		else
+		{
+			if (packet.InstanceCount > 0)
+			{
+				encoder.DrawInstanced(packet.ElementCount, packet.InstanceCount, 0, packet.StartInstance);
+			}
+			else
+			{
+				encoder.Draw(packet.ElementCount, 0);
+			}
+		}
+	}
+}
\ No newline at end of file
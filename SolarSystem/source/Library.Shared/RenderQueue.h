@@ -0,0 +1,171 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <initializer_list>
+#include <cstdint>
+#include "DrawKey.h"
+#include "RenderDevice.h"
+#include "ConstantBufferRing.h"
+
+namespace Library
+{
+	class ThreadPool;
+
+	// Collects the frame's draws as packets, sorts them by DrawKey and issues them through a RenderDevice, binding each piece of
+	// state only when it changes.
+	class RenderQueue final
+	{
+	public:
+		static const std::uint32_t MaxVertexBuffers = 2;
+		static const std::uint32_t MaxConstantBuffers = 2;
+		static const std::uint32_t MaxTextures = 4;
+
+		// Pixel shader textures, bound from slot 0.
+		struct TextureState
+		{
+			TextureHandle Textures[MaxTextures];
+			std::uint32_t TextureCount;
+
+			TextureState(std::initializer_list<TextureHandle> textures = { });
+		};
+
+		// Everything that may differ between draws sharing the same pipeline state and textures.
+		// Index buffers are 32-bit and every buffer is bound at offset 0.
+		struct DrawPacket
+		{
+			BufferHandle VertexBuffers[MaxVertexBuffers];
+			std::uint32_t Strides[MaxVertexBuffers];
+			std::uint32_t VertexBufferCount;
+			BufferHandle IndexBuffer;
+			ConstantBufferRing::Allocation VSConstantBuffers[MaxConstantBuffers];
+			std::uint32_t VSConstantBufferCount;
+			ConstantBufferRing::Allocation PSConstantBuffers[MaxConstantBuffers];
+			std::uint32_t PSConstantBufferCount;
+			std::uint32_t ElementCount;
+			std::uint32_t InstanceCount;
+			std::uint32_t StartInstance;
+
+			DrawPacket();
+
+			void AddVertexBuffer(BufferHandle vertexBuffer, std::uint32_t stride);
+			void AddVSConstantBuffer(const ConstantBufferRing::Allocation& allocation);
+			void AddPSConstantBuffer(const ConstantBufferRing::Allocation& allocation);
+		};
+
+		// Time spent recording one partition of the sorted queue into a deferred encoder.
+		struct RecordingStatistics
+		{
+			std::uint32_t PacketCount;
+			std::thread::id ThreadId;
+			double RecordingMilliseconds;
+
+			RecordingStatistics() :
+				PacketCount(0), ThreadId(), RecordingMilliseconds(0.0) { }
+		};
+
+		RenderQueue(RenderDevice& device, ConstantBufferRing& constantBuffers, ThreadPool& workers);
+		RenderQueue(const RenderQueue&) = delete;
+		RenderQueue& operator=(const RenderQueue&) = delete;
+		RenderQueue(RenderQueue&&) = delete;
+		RenderQueue& operator=(RenderQueue&&) = delete;
+		~RenderQueue() = default;
+
+		// Registration returns the id of an identical state if one exists. The queue does not own the device objects. Pipeline
+		// states sort in the DrawKey's shader field.
+		std::uint32_t RegisterPipelineState(PipelineStateHandle pipelineState);
+		std::uint32_t RegisterTextures(const TextureState& textureState);
+
+		// depth is normalized to [0, 1]; opaque draws sort front to back and transparent draws back to front.
+		void Submit(RenderLayer layer, std::uint32_t pipelineState, std::uint32_t textures, float depth, const DrawPacket& packet);
+
+		// Runs arbitrary drawing code (e.g. text) on the device's immediate encoder at its place in the sorted order. Callbacks with
+		// equal keys run in submission order, and every piece of state is rebound afterwards.
+		void SubmitCallback(RenderLayer layer, std::function<void()> callback);
+
+		void Execute();
+		void Clear();
+
+		// When enabled, and the device has deferred encoders, Execute() splits the sorted draws between callbacks into partitions,
+		// records each on the worker threads into its own deferred encoder, and plays them back in sorted order. Direct3D 11 only
+		// offers them when the driver supports command lists, since the runtime would otherwise emulate them on one thread.
+		void SetMultithreadedRecording(bool enabled);
+		bool MultithreadedRecording() const;
+		bool SupportsCommandLists() const;
+
+		// Statistics from the last Execute().
+		std::uint32_t PacketCount() const;
+		std::uint32_t StateChangeCount() const;
+		std::uint32_t UnsortedStateChangeCount() const;
+		std::uint32_t SortPassCount() const;
+
+		// Encoder calls made and dropped as redundant while issuing.
+		std::uint32_t IssuedCallCount() const;
+		std::uint32_t FilteredCallCount() const;
+		const std::vector<RecordingStatistics>& PartitionStatistics() const;
+
+		static const std::uint32_t MinPacketsPerPartition;
+
+	private:
+		struct QueuedPacket
+		{
+			DrawPacket Packet;
+			std::uint32_t Callback;
+
+			QueuedPacket(const DrawPacket& packet, std::uint32_t callback) :
+				Packet(packet), Callback(callback) { }
+		};
+
+		struct BoundState
+		{
+			std::uint32_t PipelineState;
+			std::uint32_t Textures;
+			const DrawPacket* Packet;
+
+			BoundState();
+		};
+
+		struct Partition
+		{
+			std::uint32_t First;
+			std::uint32_t Last;
+			std::uint32_t Callback;
+			std::uint32_t Encoder;
+			std::uint32_t StateChangeCount;
+			std::uint32_t IssuedCallCount;
+			std::uint32_t FilteredCallCount;
+
+			Partition(std::uint32_t first, std::uint32_t last, std::uint32_t callback) :
+				First(first), Last(last), Callback(callback), Encoder(0), StateChangeCount(0), IssuedCallCount(0), FilteredCallCount(0) { }
+		};
+
+		// A null encoder only counts the state changes.
+		std::uint32_t Issue(CommandEncoder* encoder, std::uint32_t first, std::uint32_t last) const;
+		std::uint32_t ApplyState(CommandEncoder* encoder, std::uint64_t key, const DrawPacket& packet, BoundState& boundState) const;
+		void IssueDraw(CommandEncoder& encoder, const DrawPacket& packet) const;
+
+		std::uint32_t ExecuteRecorded();
+		void AddPartitions(std::uint32_t first, std::uint32_t last, std::uint32_t workerCount);
+
+		static const std::uint32_t NoCallback;
+
+		RenderDevice* mDevice;
+		ConstantBufferRing* mConstantBuffers;
+		ThreadPool* mWorkers;
+		std::vector<PipelineStateHandle> mPipelineStates;
+		std::vector<TextureState> mTextures;
+		std::vector<QueuedPacket> mPackets;
+		std::vector<std::function<void()>> mCallbacks;
+		std::vector<DrawKeyEntry> mEntries;
+		DrawKeySorter mSorter;
+		std::vector<Partition> mPartitions;
+		std::vector<RecordingStatistics> mPartitionStatistics;
+		bool mMultithreadedRecording;
+		std::uint32_t mPacketCount;
+		std::uint32_t mStateChangeCount;
+		std::uint32_t mUnsortedStateChangeCount;
+		std::uint32_t mIssuedCallCount;
+		std::uint32_t mFilteredCallCount;
+	};
+}
\ No newline at end of file
@@ -1,21 +1,125 @@
 #include "pch.h"
 
+using namespace std;
+
 namespace Library
 {
+	atomic<uint32_t> ServiceContainer::sNextTypeIndex(0);
+
+	ServiceContainer::ServiceContainer() :
+		mIsFrozen(false)
+	{
+	}
+
 	void ServiceContainer::AddService(uint64_t typeID, void* service)
 	{
-		mServices.insert(std::pair<uint64_t, void*>(typeID, service));
+		ThrowIfFrozen();
+
+		// Like the map this replaced, a second service for the same id is ignored
+		auto position = lower_bound(mServicesById.begin(), mServicesById.end(), make_pair(typeID, static_cast<void*>(nullptr)), CompareIds);
+		if (position == mServicesById.end() || position->first != typeID)
+		{
+			mServicesById.emplace(position, typeID, service);
+		}
 	}
 
 	void ServiceContainer::RemoveService(uint64_t typeID)
 	{
-		mServices.erase(typeID);
+		ThrowIfFrozen();
+
+		auto position = lower_bound(mServicesById.begin(), mServicesById.end(), make_pair(typeID, static_cast<void*>(nullptr)), CompareIds);
+		if (position != mServicesById.end() && position->first == typeID)
+		{
+			mServicesById.erase(position);
+		}
+
+		for (Entry& entry : mEntries)
+		{
+			if (entry.TypeId == typeID)
+			{
+				entry = Entry();
+			}
+		}
 	}
 
 	void* ServiceContainer::GetService(uint64_t typeID) const
 	{
-		std::map<uint64_t, void*>::const_iterator it = mServices.find(typeID);
+		return FindById(typeID);
+	}
+
+	void ServiceContainer::Freeze()
+	{
+		mIsFrozen = true;
+	}
+
+	bool ServiceContainer::IsFrozen() const
+	{
+		return mIsFrozen;
+	}
+
+	void ServiceContainer::AddEntry(uint32_t index, void* service, shared_ptr<void> owner, uint64_t typeId)
+	{
+		ThrowIfFrozen();
+
+		if (index >= mEntries.size())
+		{
+			mEntries.resize(index + 1);
+		}
+
+		Entry& entry = mEntries[index];
+		if (entry.Service != nullptr)
+		{
+			throw GameException("ServiceContainer::AddService(): a service of this type is already registered.");
+		}
+
+		entry.Service = service;
+		entry.Owner = move(owner);
+		entry.TypeId = typeId;
+
+		if (typeId != 0)
+		{
+			AddService(typeId, service);
+		}
+	}
+
+	void ServiceContainer::RemoveEntry(uint32_t index)
+	{
+		ThrowIfFrozen();
+
+		if (index < mEntries.size() && mEntries[index].Service != nullptr)
+		{
+			Entry& entry = mEntries[index];
+			if (entry.TypeId != 0 && FindById(entry.TypeId) == entry.Service)
+			{
+				RemoveService(entry.TypeId);
+			}
+
+			entry = Entry();
+		}
+	}
+
+	void* ServiceContainer::FindById(uint64_t typeID) const
+	{
+		if (typeID == 0)
+		{
+			return nullptr;
+		}
+
+		auto position = lower_bound(mServicesById.begin(), mServicesById.end(), make_pair(typeID, static_cast<void*>(nullptr)), CompareIds);
+
+		return (position != mServicesById.end() && position->first == typeID ? position->second : nullptr);
+	}
 
-		return (it != mServices.end() ? it->second : nullptr);
+	bool ServiceContainer::CompareIds(const pair<uint64_t, void*>& lhs, const pair<uint64_t, void*>& rhs)
+	{
+		return lhs.first < rhs.first;
+	}
+
+	void ServiceContainer::ThrowIfFrozen() const
+	{
+		if (mIsFrozen)
+		{
+			throw GameException("ServiceContainer: services cannot be added or removed once the container is frozen.");
+		}
 	}
 }
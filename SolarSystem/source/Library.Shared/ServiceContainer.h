@@ -1,21 +1,122 @@
 #pragma once
 
-#include <map>
+#include "GameException.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <utility>
 #include <cstdint>
 
 namespace Library
 {
+	// Services are looked up by type. Every type used as a service gets a small dense index the first time it is named, so
+	// GetService<T>() is an array load with no search. A service is either owned by the container (registered through a
+	// shared_ptr) or just referenced (registered by pointer, e.g. a component the game already owns).
+	// Register services during startup and Freeze() the container before other threads read it; from then on reads take no
+	// locks, and adding or removing services throws.
+	// The uint64_t-keyed functions are kept for older code and search a sorted list of every service with an id (typed
+	// services of RTTI types included). Services added through them are still found by GetService<T>() for RTTI types,
+	// after the typed lookup misses.
 	class ServiceContainer final
 	{
 	public:
-		ServiceContainer() = default;
+		ServiceContainer();
 		ServiceContainer(const ServiceContainer&) = delete;
 		ServiceContainer& operator=(const ServiceContainer&) = delete;
+		ServiceContainer(ServiceContainer&&) = delete;
+		ServiceContainer& operator=(ServiceContainer&&) = delete;
+		~ServiceContainer() = default;
+
+		// The caller keeps the service alive until it is removed or the container is destroyed.
+		template <typename T>
+		void AddService(T* service)
+		{
+			if (service == nullptr)
+			{
+				throw GameException("ServiceContainer::AddService(): service cannot be null.");
+			}
+
+			AddEntry(TypeIndex<T>(), service, nullptr, RTTITypeId<T>(0));
+		}
+
+		// The container shares ownership of the service.
+		template <typename T>
+		void AddService(const std::shared_ptr<T>& service)
+		{
+			if (service == nullptr)
+			{
+				throw GameException("ServiceContainer::AddService(): service cannot be null.");
+			}
+
+			AddEntry(TypeIndex<T>(), service.get(), service, RTTITypeId<T>(0));
+		}
+
+		template <typename T>
+		void RemoveService()
+		{
+			RemoveEntry(TypeIndex<T>());
+		}
+
+		template <typename T>
+		T* GetService() const
+		{
+			const std::uint32_t index = TypeIndex<T>();
+			if (index < mEntries.size() && mEntries[index].Service != nullptr)
+			{
+				return static_cast<T*>(mEntries[index].Service);
+			}
+
+			return static_cast<T*>(FindById(RTTITypeId<T>(0)));
+		}
 
 		void AddService(std::uint64_t typeID, void* service);
 		void RemoveService(std::uint64_t typeID);
 		void* GetService(std::uint64_t typeID) const;
 
-		std::map<std::uint64_t, void*> mServices;
+		void Freeze();
+		bool IsFrozen() const;
+
+	private:
+		struct Entry
+		{
+			void* Service;
+			std::shared_ptr<void> Owner;
+			std::uint64_t TypeId;
+
+			Entry() :
+				Service(nullptr), TypeId(0) { }
+		};
+
+		template <typename T>
+		static std::uint32_t TypeIndex()
+		{
+			static const std::uint32_t index = sNextTypeIndex++;
+			return index;
+		}
+
+		// The RTTI type id for types that have one, so the uint64_t-keyed functions find typed services; 0 otherwise.
+		template <typename T>
+		static auto RTTITypeId(int) -> decltype(T::TypeIdClass())
+		{
+			return T::TypeIdClass();
+		}
+
+		template <typename T>
+		static std::uint64_t RTTITypeId(long)
+		{
+			return 0;
+		}
+
+		void AddEntry(std::uint32_t index, void* service, std::shared_ptr<void> owner, std::uint64_t typeId);
+		void RemoveEntry(std::uint32_t index);
+		void* FindById(std::uint64_t typeID) const;
+		void ThrowIfFrozen() const;
+		static bool CompareIds(const std::pair<std::uint64_t, void*>& lhs, const std::pair<std::uint64_t, void*>& rhs);
+
+		static std::atomic<std::uint32_t> sNextTypeIndex;
+
+		std::vector<Entry> mEntries;
+		std::vector<std::pair<std::uint64_t, void*>> mServicesById;
+		bool mIsFrozen;
 	};
-}
\ No newline at end of file
+}
@@ -17,41 +17,34 @@ namespace Library
 
 	void Skybox::Initialize()
 	{
+		RenderDevice& device = mGame->Device();
 
 		// Load a compiled vertex shader
 		vector<char> compiledVertexShader;
 		Utility::LoadBinaryFile(L"Content\\Shaders\\SkyboxVS.cso", compiledVertexShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateVertexShader(&compiledVertexShader[0], compiledVertexShader.size(), nullptr, mVertexShader.GetAddressOf()), "ID3D11Device::CreatedVertexShader() failed.");
+		mVertexShader = device.CreateShader(ShaderStage::Vertex, compiledVertexShader);
 
 		// Load a compiled pixel shader
 		vector<char> compiledPixelShader;
 		Utility::LoadBinaryFile(L"Content\\Shaders\\SkyboxPS.cso", compiledPixelShader);
-		ThrowIfFailed(mGame->Direct3DDevice()->CreatePixelShader(&compiledPixelShader[0], compiledPixelShader.size(), nullptr, mPixelShader.GetAddressOf()), "ID3D11Device::CreatedPixelShader() failed.");
+		mPixelShader = device.CreateShader(ShaderStage::Pixel, compiledPixelShader);
 
-		// Create an input layout
-		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
-		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-		};
-
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateInputLayout(inputElementDescriptions, ARRAYSIZE(inputElementDescriptions), &compiledVertexShader[0], compiledVertexShader.size(), mInputLayout.GetAddressOf()), "ID3D11Device::CreateInputLayout() failed.");
+		PipelineStateDescription pipelineStateDescription(mVertexShader, mPixelShader, { InputElement("POSITION", VertexFormat::Float4) });
+		pipelineStateDescription.Cull = CullMode::None;
+		pipelineStateDescription.Sampler = SamplerMode::TrilinearClamp;
+		mPipelineState = device.CreatePipelineState(pipelineStateDescription);
 
 		// Load the model
-		Library::Model model = Library::Model("Content\\Models\\Sphere.obj.bin");
+		Library::Model model("Content\\Models\\Sphere.obj.bin");
 
 		// Create vertex and index buffers for the model
 		Mesh* mesh = model.Meshes().at(0).get();
-		CreateVertexBuffer(mGame->Direct3DDevice(), *mesh, mVertexBuffer.ReleaseAndGetAddressOf());
-		mesh->CreateIndexBuffer(*mGame->Direct3DDevice(), mIndexBuffer.ReleaseAndGetAddressOf());
-		mIndexCount = static_cast<UINT>(mesh->Indices().size());
-
-		ThrowIfFailed(DirectX::CreateDDSTextureFromFile(mGame->Direct3DDevice(), mCubeMapFileName.c_str(), nullptr, mSkyboxTexture.GetAddressOf()), "CreateDDSTextureFromFile() failed.");
+		mVertexBuffer = CreateVertexBuffer(device, *mesh);
+		mIndexBuffer = mesh->CreateIndexBuffer(device);
+		mIndexCount = static_cast<UINT>(mesh->Indices().Size());
 
-		// Create constant buffer
-		D3D11_BUFFER_DESC constantBufferDesc = { 0 };
-		constantBufferDesc.ByteWidth = sizeof(mVertexCBufferPerObjectData);
-		constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-		ThrowIfFailed(mGame->Direct3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, mVertexCBufferPerObject.GetAddressOf()), "ID3D11Device::CreateBuffer() failed.");
+		mConstantBuffer = device.CreateBuffer(BufferDescription(BufferType::Constant, ResourceUsage::Default, sizeof(VertexCBufferPerObject)), nullptr);
+		mSkyboxTexture = device.CreateTextureFromFile(mCubeMapFileName);
 	}
 
 	void Skybox::Update(const GameTime& gameTime)
@@ -66,55 +59,40 @@ namespace Library
 	{
 		UNREFERENCED_PARAMETER(gameTime);
 
-		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
-		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		direct3DDeviceContext->IASetInputLayout(mInputLayout.Get());
-
-		UINT stride = sizeof(VertexPositionTexture);
-		UINT offset = 0;
-		direct3DDeviceContext->IASetVertexBuffers(0, 1, mVertexBuffer.GetAddressOf(), &stride, &offset);
-		direct3DDeviceContext->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
-
-		direct3DDeviceContext->VSSetShader(mVertexShader.Get(), nullptr, 0);
-		direct3DDeviceContext->PSSetShader(mPixelShader.Get(), nullptr, 0);
-
 		XMMATRIX worldMatrix = XMLoadFloat4x4(&mWorldMatrix);
 		XMMATRIX wvp = worldMatrix * mCamera->ViewProjectionMatrix();
 		XMStoreFloat4x4(&mVertexCBufferPerObjectData.WorldViewProjection, XMMatrixTranspose(wvp));
 
-		direct3DDeviceContext->UpdateSubresource(mVertexCBufferPerObject.Get(), 0, nullptr, &mVertexCBufferPerObjectData, 0, 0);
-		direct3DDeviceContext->VSSetConstantBuffers(0, 1, mVertexCBufferPerObject.GetAddressOf());
-
-		direct3DDeviceContext->PSSetShaderResources(0, 1, mSkyboxTexture.GetAddressOf());
-		direct3DDeviceContext->PSSetSamplers(0, 1, SamplerStates::TrilinearClamp.GetAddressOf());
-
-		direct3DDeviceContext->RSSetState(RasterizerStates::DisabledCulling.Get());
-		direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
-		direct3DDeviceContext->RSSetState(nullptr);
+		// The skybox surrounds the camera and covers whatever is left, so it goes after the opaque geometry.
+		mGame->DrawQueue().SubmitCallback(RenderLayer::Background, [this]()
+		{
+			CommandEncoder& encoder = mGame->Device().ImmediateEncoder();
+			encoder.UpdateBuffer(mConstantBuffer, &mVertexCBufferPerObjectData, sizeof(mVertexCBufferPerObjectData));
+			encoder.SetPipelineState(mPipelineState);
+			encoder.SetVertexBuffer(0, mVertexBuffer, sizeof(VertexPositionTexture), 0);
+			encoder.SetIndexBuffer(mIndexBuffer, IndexFormat::UInt32, 0);
+			encoder.SetConstantBuffer(ShaderStage::Vertex, 0, mConstantBuffer);
+			encoder.SetTexture(ShaderStage::Pixel, 0, mSkyboxTexture);
+			encoder.DrawIndexed(mIndexCount, 0, 0);
+		});
 	}
 
-	void Skybox::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	BufferHandle Skybox::CreateVertexBuffer(RenderDevice& device, const Mesh& mesh) const
 	{
-		const vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
-		vector<XMFLOAT3>* textureCoordinates = mesh.TextureCoordinates().at(0);
-		assert(textureCoordinates->size() == sourceVertices.size());
+		Span<const XMFLOAT3> sourceVertices = mesh.Vertices();
+		Span<const XMFLOAT3> textureCoordinates = mesh.TextureCoordinates(0);
+		assert(textureCoordinates.Size() == sourceVertices.Size());
 
 		vector<VertexPositionTexture> vertices;
-		vertices.reserve(sourceVertices.size());
-		for (UINT i = 0; i < sourceVertices.size(); i++)
+		vertices.reserve(sourceVertices.Size());
+		for (UINT i = 0; i < sourceVertices.Size(); i++)
 		{
-			const XMFLOAT3& position = sourceVertices.at(i);
-			const XMFLOAT3& uv = textureCoordinates->at(i);
+			const XMFLOAT3& position = sourceVertices[i];
+			const XMFLOAT3& uv = textureCoordinates[i];
 			vertices.push_back(VertexPositionTexture(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y)));
 		}
 
-		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
-		vertexBufferDesc.ByteWidth = static_cast<UINT>(sizeof(VertexPositionTexture) * vertices.size());
-		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-		D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
-		vertexSubResourceData.pSysMem = &vertices[0];
-		ThrowIfFailed(device->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer), "ID3D11Device::CreateBuffer() failed.");
+		BufferDescription description(BufferType::Vertex, ResourceUsage::Immutable, static_cast<UINT>(sizeof(VertexPositionTexture) * vertices.size()));
+		return device.CreateBuffer(description, &vertices[0]);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,454 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace Library
+{
+	const uint32_t SnapshotBuffer::DefaultCapacity = 600;
+	const uint32_t SnapshotBuffer::DefaultKeyframeInterval = 30;
+
+#pragma region Stream Buffers
+
+	SnapshotBuffer::OutputBuffer::OutputBuffer(vector<char>& data) :
+		mData(data)
+	{
+	}
+
+	SnapshotBuffer::OutputBuffer::int_type SnapshotBuffer::OutputBuffer::overflow(int_type character)
+	{
+		if (traits_type::eq_int_type(character, traits_type::eof()) == false)
+		{
+			mData.push_back(traits_type::to_char_type(character));
+		}
+
+		return traits_type::not_eof(character);
+	}
+
+	streamsize SnapshotBuffer::OutputBuffer::xsputn(const char* source, streamsize count)
+	{
+		mData.insert(mData.end(), source, source + count);
+
+		return count;
+	}
+
+	SnapshotBuffer::InputBuffer::InputBuffer(const vector<char>& data)
+	{
+		char* begin = const_cast<char*>(data.data());
+		setg(begin, begin, begin + data.size());
+	}
+
+#pragma endregion
+
+	SnapshotBuffer::SnapshotBuffer(uint32_t capacity, uint32_t keyframeInterval) :
+		mFrames(capacity), mHead(0), mSize(0), mKeyframeInterval(keyframeInterval), mFramesSinceKeyframe(0),
+		mLastCaptureBytes(0), mLastCaptureTime(0), mLastRestoreTime(0)
+	{
+		assert(capacity > 0);
+		assert(keyframeInterval > 0);
+	}
+
+	uint32_t SnapshotBuffer::Capacity() const
+	{
+		return static_cast<uint32_t>(mFrames.size());
+	}
+
+	uint32_t SnapshotBuffer::KeyframeInterval() const
+	{
+		return mKeyframeInterval;
+	}
+
+	uint32_t SnapshotBuffer::Size() const
+	{
+		return mSize;
+	}
+
+	bool SnapshotBuffer::IsEmpty() const
+	{
+		return (mSize == 0);
+	}
+
+	uint64_t SnapshotBuffer::NewestFrame() const
+	{
+		assert(mSize > 0);
+		return FrameAt(mSize - 1).FrameIndex;
+	}
+
+	uint64_t SnapshotBuffer::OldestRestorableFrame() const
+	{
+		// Deltas whose keyframe has already been evicted cannot be reconstructed from memory.
+		for (uint32_t position = 0; position < mSize; ++position)
+		{
+			const Frame& frame = FrameAt(position);
+			if (frame.IsKeyframe)
+			{
+				return frame.FrameIndex;
+			}
+		}
+
+		throw GameException("No restorable snapshot.");
+	}
+
+	bool SnapshotBuffer::CanRestore(uint64_t frame) const
+	{
+		uint32_t position;
+		if (FindFrame(frame, position) == false)
+		{
+			return false;
+		}
+
+		for (;; --position)
+		{
+			if (FrameAt(position).IsKeyframe)
+			{
+				return true;
+			}
+
+			if (position == 0)
+			{
+				return false;
+			}
+		}
+	}
+
+	void SnapshotBuffer::EnableSpill(const string& filename)
+	{
+		mSpillFile.close();
+		mSpillFile.open(filename.c_str(), ios::binary | ios::trunc);
+		if (!mSpillFile.good())
+		{
+			throw GameException("Could not open snapshot spill file.");
+		}
+	}
+
+	void SnapshotBuffer::DisableSpill()
+	{
+		mSpillFile.close();
+	}
+
+	bool SnapshotBuffer::IsSpillEnabled() const
+	{
+		return mSpillFile.is_open();
+	}
+
+	void SnapshotBuffer::Capture(uint64_t frame, const ISnapshotable& state)
+	{
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		assert(mSize == 0 || frame > NewestFrame());
+
+		mCurrentState.clear();
+		{
+			OutputBuffer buffer(mCurrentState);
+			ostream stream(&buffer);
+			OutputStreamHelper streamHelper(stream);
+			state.SaveSnapshot(streamHelper);
+		}
+
+		if (mSize == Capacity())
+		{
+			Spill(FrameAt(0));
+			mHead = (mHead + 1) % Capacity();
+			--mSize;
+		}
+
+		Frame& newFrame = FrameAt(mSize);
+		++mSize;
+
+		newFrame.FrameIndex = frame;
+		newFrame.StateSize = static_cast<uint32_t>(mCurrentState.size());
+		newFrame.IsKeyframe = (mSize == 1 || mFramesSinceKeyframe + 1 >= mKeyframeInterval || mPreviousState.size() != mCurrentState.size());
+		if (newFrame.IsKeyframe)
+		{
+			newFrame.Data.assign(mCurrentState.begin(), mCurrentState.end());
+			mFramesSinceKeyframe = 0;
+		}
+		else
+		{
+			EncodeDelta(mPreviousState, mCurrentState, newFrame.Data);
+			++mFramesSinceKeyframe;
+		}
+
+		mPreviousState.swap(mCurrentState);
+		mLastCaptureBytes = newFrame.Data.size();
+		mLastCaptureTime = duration_cast<microseconds>(high_resolution_clock::now() - startTime);
+	}
+
+	bool SnapshotBuffer::Restore(uint64_t frame, ISnapshotable& state)
+	{
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+
+		uint32_t position;
+		if (FindFrame(frame, position) == false || Reconstruct(position, mScratch) == false)
+		{
+			return false;
+		}
+
+		LoadState(mScratch, state);
+		mLastRestoreTime = duration_cast<microseconds>(high_resolution_clock::now() - startTime);
+
+		return true;
+	}
+
+	bool SnapshotBuffer::Rewind(uint64_t frame, ISnapshotable& state)
+	{
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+
+		uint32_t position;
+		if (FindFrame(frame, position) == false || Reconstruct(position, mScratch) == false)
+		{
+			return false;
+		}
+
+		LoadState(mScratch, state);
+
+		// Discard the abandoned future and continue delta encoding from the restored state.
+		mSize = position + 1;
+		mPreviousState = mScratch;
+		mFramesSinceKeyframe = 0;
+		for (uint32_t i = position; FrameAt(i).IsKeyframe == false; --i)
+		{
+			++mFramesSinceKeyframe;
+		}
+
+		mLastRestoreTime = duration_cast<microseconds>(high_resolution_clock::now() - startTime);
+
+		return true;
+	}
+
+	void SnapshotBuffer::Clear()
+	{
+		mHead = 0;
+		mSize = 0;
+		mFramesSinceKeyframe = 0;
+		mPreviousState.clear();
+	}
+
+	size_t SnapshotBuffer::LastCaptureBytes() const
+	{
+		return mLastCaptureBytes;
+	}
+
+	const microseconds& SnapshotBuffer::LastCaptureTime() const
+	{
+		return mLastCaptureTime;
+	}
+
+	const microseconds& SnapshotBuffer::LastRestoreTime() const
+	{
+		return mLastRestoreTime;
+	}
+
+	size_t SnapshotBuffer::StoredBytes() const
+	{
+		size_t storedBytes = 0;
+		for (uint32_t position = 0; position < mSize; ++position)
+		{
+			storedBytes += FrameAt(position).Data.size();
+		}
+
+		return storedBytes;
+	}
+
+	bool SnapshotBuffer::RestoreFromSpill(const string& filename, uint64_t frame, ISnapshotable& state)
+	{
+		ifstream file(filename.c_str(), ios::binary);
+		if (!file.good())
+		{
+			throw GameException("Could not open snapshot spill file.");
+		}
+
+		InputStreamHelper streamHelper(file);
+		vector<char> snapshot;
+		vector<char> data;
+		bool hasKeyframe = false;
+
+		while (file.peek() != char_traits<char>::eof())
+		{
+			uint64_t frameIndex;
+			bool isKeyframe;
+			uint32_t stateSize;
+			uint32_t dataSize;
+			streamHelper >> frameIndex >> isKeyframe >> stateSize >> dataSize;
+
+			data.resize(dataSize);
+			file.read(data.data(), dataSize);
+			if (!file.good())
+			{
+				throw GameException("Snapshot spill file is truncated.");
+			}
+
+			if (isKeyframe)
+			{
+				snapshot = data;
+				hasKeyframe = true;
+			}
+			else if (hasKeyframe)
+			{
+				assert(snapshot.size() == stateSize);
+				ApplyDelta(data, snapshot);
+			}
+
+			if (frameIndex == frame)
+			{
+				if (hasKeyframe)
+				{
+					LoadState(snapshot, state);
+				}
+
+				return hasKeyframe;
+			}
+		}
+
+		return false;
+	}
+
+	SnapshotBuffer::Frame& SnapshotBuffer::FrameAt(uint32_t position)
+	{
+		return mFrames[(mHead + position) % mFrames.size()];
+	}
+
+	const SnapshotBuffer::Frame& SnapshotBuffer::FrameAt(uint32_t position) const
+	{
+		return mFrames[(mHead + position) % mFrames.size()];
+	}
+
+	bool SnapshotBuffer::FindFrame(uint64_t frame, uint32_t& position) const
+	{
+		// Frame indices increase monotonically around the ring, so a binary search over logical positions applies.
+		uint32_t low = 0;
+		uint32_t high = mSize;
+		while (low < high)
+		{
+			uint32_t middle = low + (high - low) / 2;
+			if (FrameAt(middle).FrameIndex < frame)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+
+		if (low < mSize && FrameAt(low).FrameIndex == frame)
+		{
+			position = low;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool SnapshotBuffer::Reconstruct(uint32_t position, vector<char>& state) const
+	{
+		uint32_t keyframePosition = position;
+		while (FrameAt(keyframePosition).IsKeyframe == false)
+		{
+			if (keyframePosition == 0)
+			{
+				return false;
+			}
+
+			--keyframePosition;
+		}
+
+		state = FrameAt(keyframePosition).Data;
+		for (uint32_t i = keyframePosition + 1; i <= position; ++i)
+		{
+			ApplyDelta(FrameAt(i).Data, state);
+		}
+
+		return true;
+	}
+
+	void SnapshotBuffer::Spill(const Frame& frame)
+	{
+		if (mSpillFile.is_open())
+		{
+			OutputStreamHelper streamHelper(mSpillFile);
+			streamHelper << frame.FrameIndex << frame.IsKeyframe << frame.StateSize << static_cast<uint32_t>(frame.Data.size());
+			mSpillFile.write(frame.Data.data(), frame.Data.size());
+		}
+	}
+
+	void SnapshotBuffer::EncodeDelta(const vector<char>& previous, const vector<char>& current, vector<char>& delta)
+	{
+		assert(previous.size() == current.size());
+
+		// XOR against the previous state, then run-length encode as (zero run, literal count, literals) triples.
+		delta.clear();
+		size_t offset = 0;
+		const size_t size = current.size();
+		while (offset < size)
+		{
+			size_t zeroStart = offset;
+			while (offset < size && previous[offset] == current[offset])
+			{
+				++offset;
+			}
+
+			size_t literalStart = offset;
+			while (offset < size && previous[offset] != current[offset])
+			{
+				++offset;
+			}
+
+			WriteVarint(delta, static_cast<uint32_t>(literalStart - zeroStart));
+			WriteVarint(delta, static_cast<uint32_t>(offset - literalStart));
+			for (size_t i = literalStart; i < offset; ++i)
+			{
+				delta.push_back(static_cast<char>(previous[i] ^ current[i]));
+			}
+		}
+	}
+
+	void SnapshotBuffer::ApplyDelta(const vector<char>& delta, vector<char>& state)
+	{
+		size_t readOffset = 0;
+		size_t writeOffset = 0;
+		while (readOffset < delta.size())
+		{
+			writeOffset += ReadVarint(delta, readOffset);
+			uint32_t literalCount = ReadVarint(delta, readOffset);
+			assert(writeOffset + literalCount <= state.size());
+
+			for (uint32_t i = 0; i < literalCount; ++i)
+			{
+				state[writeOffset++] ^= delta[readOffset++];
+			}
+		}
+	}
+
+	void SnapshotBuffer::WriteVarint(vector<char>& data, uint32_t value)
+	{
+		while (value >= 0x80)
+		{
+			data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+
+		data.push_back(static_cast<char>(value));
+	}
+
+	uint32_t SnapshotBuffer::ReadVarint(const vector<char>& data, size_t& offset)
+	{
+		uint32_t value = 0;
+		for (uint32_t shift = 0;; shift += 7)
+		{
+			uint8_t byteValue = static_cast<uint8_t>(data[offset++]);
+			value |= static_cast<uint32_t>(byteValue & 0x7F) << shift;
+			if ((byteValue & 0x80) == 0)
+			{
+				return value;
+			}
+		}
+	}
+
+	void SnapshotBuffer::LoadState(const vector<char>& data, ISnapshotable& state)
+	{
+		InputBuffer buffer(data);
+		istream stream(&buffer);
+		InputStreamHelper streamHelper(stream);
+		state.LoadSnapshot(streamHelper);
+	}
+}
\ No newline at end of file
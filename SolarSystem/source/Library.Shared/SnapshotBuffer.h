@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <streambuf>
+#include <cstdint>
+#include <chrono>
+
+namespace Library
+{
+	class OutputStreamHelper;
+	class InputStreamHelper;
+
+	class ISnapshotable
+	{
+	public:
+		virtual ~ISnapshotable() { };
+
+		virtual void SaveSnapshot(OutputStreamHelper& streamHelper) const = 0;
+		virtual void LoadSnapshot(InputStreamHelper& streamHelper) = 0;
+
+	protected:
+		ISnapshotable() { };
+	};
+
+	class SnapshotBuffer final
+	{
+	public:
+		SnapshotBuffer(std::uint32_t capacity = DefaultCapacity, std::uint32_t keyframeInterval = DefaultKeyframeInterval);
+		SnapshotBuffer(const SnapshotBuffer&) = delete;
+		SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+		SnapshotBuffer(SnapshotBuffer&&) = delete;
+		SnapshotBuffer& operator=(SnapshotBuffer&&) = delete;
+		~SnapshotBuffer() = default;
+
+		std::uint32_t Capacity() const;
+		std::uint32_t KeyframeInterval() const;
+		std::uint32_t Size() const;
+		bool IsEmpty() const;
+
+		std::uint64_t NewestFrame() const;
+		std::uint64_t OldestRestorableFrame() const;
+		bool CanRestore(std::uint64_t frame) const;
+
+		void EnableSpill(const std::string& filename);
+		void DisableSpill();
+		bool IsSpillEnabled() const;
+
+		void Capture(std::uint64_t frame, const ISnapshotable& state);
+		bool Restore(std::uint64_t frame, ISnapshotable& state);
+		bool Rewind(std::uint64_t frame, ISnapshotable& state);
+		void Clear();
+
+		std::size_t LastCaptureBytes() const;
+		const std::chrono::microseconds& LastCaptureTime() const;
+		const std::chrono::microseconds& LastRestoreTime() const;
+		std::size_t StoredBytes() const;
+
+		static bool RestoreFromSpill(const std::string& filename, std::uint64_t frame, ISnapshotable& state);
+
+		static const std::uint32_t DefaultCapacity;
+		static const std::uint32_t DefaultKeyframeInterval;
+
+	private:
+		struct Frame
+		{
+			std::uint64_t FrameIndex;
+			bool IsKeyframe;
+			std::uint32_t StateSize;
+			std::vector<char> Data;
+
+			Frame() :
+				FrameIndex(0), IsKeyframe(false), StateSize(0) { }
+		};
+
+		class OutputBuffer final : public std::streambuf
+		{
+		public:
+			OutputBuffer(std::vector<char>& data);
+
+		protected:
+			virtual int_type overflow(int_type character) override;
+			virtual std::streamsize xsputn(const char* source, std::streamsize count) override;
+
+		private:
+			std::vector<char>& mData;
+		};
+
+		class InputBuffer final : public std::streambuf
+		{
+		public:
+			InputBuffer(const std::vector<char>& data);
+		};
+
+		Frame& FrameAt(std::uint32_t position);
+		const Frame& FrameAt(std::uint32_t position) const;
+		bool FindFrame(std::uint64_t frame, std::uint32_t& position) const;
+		bool Reconstruct(std::uint32_t position, std::vector<char>& state) const;
+		void Spill(const Frame& frame);
+
+		static void EncodeDelta(const std::vector<char>& previous, const std::vector<char>& current, std::vector<char>& delta);
+		static void ApplyDelta(const std::vector<char>& delta, std::vector<char>& state);
+		static void WriteVarint(std::vector<char>& data, std::uint32_t value);
+		static std::uint32_t ReadVarint(const std::vector<char>& data, std::size_t& offset);
+		static void LoadState(const std::vector<char>& data, ISnapshotable& state);
+
+		std::vector<Frame> mFrames;
+		std::uint32_t mHead;
+		std::uint32_t mSize;
+		std::uint32_t mKeyframeInterval;
+		std::uint32_t mFramesSinceKeyframe;
+		std::vector<char> mCurrentState;
+		std::vector<char> mPreviousState;
+		std::vector<char> mScratch;
+		std::ofstream mSpillFile;
+		std::size_t mLastCaptureBytes;
+		std::chrono::microseconds mLastCaptureTime;
+		std::chrono::microseconds mLastRestoreTime;
+	};
+}
\ No newline at end of file
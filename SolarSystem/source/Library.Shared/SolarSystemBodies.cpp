@@ -0,0 +1,62 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	const CelestialBodyDescription SolarSystemBodies::Sun = { "Sun", 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, "SunComposite.dds", -1 };
+
+	const CelestialBodyDescription SolarSystemBodies::Bodies[BodyCount] =
+	{
+		{ "Mercury", .387f, .382f, .241f, .161f, 0.0f, "MercuryComposite.dds", -1 },
+		{ "Venus", .723f, .949f, .616f, .666f, 3.096f, "VenusComposite.dds", -1 },
+		{ "Earth", 1.0f, 1.0f, 1.0f, .003f, .410f, "EarthComposite.dds", -1 },
+		{ "Mars", 1.524f, .532f, 1.88f, .003f, .436f, "MarsComposite.dds", -1 },
+		{ "Jupiter", 5.203f, 11.19f, 11.86f, .001f, .052f, "JupiterComposite.dds", -1 },
+		{ "Saturn", 9.582f, 9.26f, 29.410f, .001f, .471f, "SaturnComposite.dds", -1 },
+		{ "Uranus", 19.2f, 4.01f, 84.04f, .002f, 1.709f, "UranusComposite.dds", -1 },
+		{ "Neptune", 30.05f, 3.88f, 163.72f, .002f, .517f, "NeptuneComposite.dds", -1 },
+		{ "Pluto", 39.48f, .18f, 247.93f, .017f, 2.129f, "PlutoComposite.dds", -1 },
+		{ "Moon", .2f, .272f, .074f, .074f, .026f, "MoonComposite.dds", EarthIndex }
+	};
+
+	const char* const SolarSystemBodies::SpecularFilename = "MarsSpecularMap.png";
+
+	const float SolarSystemBodies::DistanceMultiplier = 50.0f;
+	const float SolarSystemBodies::OrbitalSpeedFactor = 0.1f;
+	const float SolarSystemBodies::RotationalSpeedFactor = 0.001f;
+	const float SolarSystemBodies::SunAmbientColor = 0.8f;
+	const float SolarSystemBodies::PlanetAmbientColor = 0.0f;
+
+	OrbitalTransform SolarSystemBodies::LocalTransform(float orbitalDistance, float scale, float axialTilt, float axialDisplacement, float orbitalDisplacement)
+	{
+		// Half-angle quaternions about Y, Z and Y, multiplied in the chain's order as XMQuaternionMultiply() does
+		const float axialSine = sin(axialDisplacement * 0.5f);
+		const float axialCosine = cos(axialDisplacement * 0.5f);
+		const float tiltSine = sin(axialTilt * 0.5f);
+		const float tiltCosine = cos(axialTilt * 0.5f);
+		const float orbitalSine = sin(orbitalDisplacement * 0.5f);
+		const float orbitalCosine = cos(orbitalDisplacement * 0.5f);
+
+		// The axial rotation, then the tilt: (0, as, 0, ac) followed by (0, 0, ts, tc)
+		const float tiltedX = -axialSine * tiltSine;
+		const float tiltedY = axialSine * tiltCosine;
+		const float tiltedZ = axialCosine * tiltSine;
+		const float tiltedW = axialCosine * tiltCosine;
+
+		// Then the orbital rotation, (0, os, 0, oc)
+		OrbitalTransform transform;
+		transform.Scale = scale;
+		transform.Rotation[0] = orbitalCosine * tiltedX + orbitalSine * tiltedZ;
+		transform.Rotation[1] = orbitalCosine * tiltedY + orbitalSine * tiltedW;
+		transform.Rotation[2] = orbitalCosine * tiltedZ - orbitalSine * tiltedX;
+		transform.Rotation[3] = orbitalCosine * tiltedW - orbitalSine * tiltedY;
+
+		// rotationY(orbitalDisplacement) of (0, 0, orbitalDistance), in double-angle form
+		transform.Translation[0] = orbitalDistance * 2.0f * orbitalSine * orbitalCosine;
+		transform.Translation[1] = 0.0f;
+		transform.Translation[2] = orbitalDistance * (orbitalCosine * orbitalCosine - orbitalSine * orbitalSine);
+
+		return transform;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Library
+{
+	// One body of the solar system: sizes, distances and periods relative to Earth's.
+	struct CelestialBodyDescription
+	{
+		const char* Name;
+		float OrbitRadius;			// Astronomical units; multiplied by SolarSystemBodies::DistanceMultiplier in the scene
+		float Scale;
+		float OrbitalPeriod;		// Years; 0 for a body that stays put
+		float RotationalPeriod;		// Years
+		float AxialTilt;			// Radians
+		const char* TextureFilename;	// In the content's Textures directory
+		std::int32_t ParentIndex;	// Into SolarSystemBodies::Bodies, or -1 for a body that orbits the sun
+	};
+
+	// A body's local transform as a uniform scale, a unit quaternion and a translation.
+	struct OrbitalTransform
+	{
+		float Scale;
+		float Rotation[4];
+		float Translation[3];
+	};
+
+	// The solar system the lessons draw, and how its bodies move. Only the standard library is used, so the headless renderer
+	// draws the same bodies with the same motion as Lesson5.4.
+	class SolarSystemBodies final
+	{
+	public:
+		static const std::uint32_t BodyCount = 10;
+		static const std::uint32_t EarthIndex = 2;
+		static const std::uint32_t MoonIndex = 9;
+
+		static const CelestialBodyDescription Sun;
+
+		// The planets outward from the sun, then Earth's moon; a parent always precedes its satellites.
+		static const CelestialBodyDescription Bodies[BodyCount];
+
+		// Every body's specular map.
+		static const char* const SpecularFilename;
+
+		static const float DistanceMultiplier;
+		static const float OrbitalSpeedFactor;
+		static const float RotationalSpeedFactor;
+		static const float SunAmbientColor;
+		static const float PlanetAmbientColor;
+
+		// The transform chain
+		//   scaling * rotationY(axialDisplacement) * rotationZ(axialTilt) * translation(0, 0, orbitalDistance) * rotationY(orbitalDisplacement)
+		// as a scaling, the product of the three rotations and the orbital rotation of (0, 0, orbitalDistance).
+		static OrbitalTransform LocalTransform(float orbitalDistance, float scale, float axialTilt, float axialDisplacement, float orbitalDisplacement);
+
+		SolarSystemBodies() = delete;
+		SolarSystemBodies(const SolarSystemBodies&) = delete;
+		SolarSystemBodies& operator=(const SolarSystemBodies&) = delete;
+		SolarSystemBodies(SolarSystemBodies&&) = delete;
+		SolarSystemBodies& operator=(SolarSystemBodies&&) = delete;
+		~SolarSystemBodies() = default;
+	};
+}
\ No newline at end of file
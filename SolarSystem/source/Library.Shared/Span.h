@@ -0,0 +1,74 @@
+#pragma once
+
+#include <type_traits>
+#include <cassert>
+#include <cstddef>
+
+namespace Library
+{
+	// A view of Size() contiguous elements owned by something else, standing in for C++20's std::span. A Span<T> converts to
+	// a Span<const T>.
+	template <typename T>
+	class Span final
+	{
+	public:
+		typedef T value_type;
+		typedef T* iterator;
+
+		Span() :
+			mData(nullptr), mSize(0)
+		{
+		}
+
+		Span(T* data, std::size_t size) :
+			mData(data), mSize(size)
+		{
+		}
+
+		template <typename U, typename = typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+		Span(const Span<U>& other) :
+			mData(other.Data()), mSize(other.Size())
+		{
+		}
+
+		T* Data() const
+		{
+			return mData;
+		}
+
+		std::size_t Size() const
+		{
+			return mSize;
+		}
+
+		std::size_t SizeBytes() const
+		{
+			return mSize * sizeof(T);
+		}
+
+		bool IsEmpty() const
+		{
+			return (mSize == 0);
+		}
+
+		T& operator[](std::size_t index) const
+		{
+			assert(index < mSize);
+			return mData[index];
+		}
+
+		T* begin() const
+		{
+			return mData;
+		}
+
+		T* end() const
+		{
+			return mData + mSize;
+		}
+
+	private:
+		T* mData;
+		std::size_t mSize;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cassert>
+
+namespace Library
+{
+	// A bounded lock-free queue for exactly one producer thread and one consumer thread. Each side only writes its own index,
+	// so a push or pop is a copy plus one release store. The capacity is rounded up to a power of two; one slot is kept empty
+	// to tell a full queue from an empty one.
+	template <typename T>
+	class SpscQueue final
+	{
+	public:
+		explicit SpscQueue(std::size_t capacity) :
+			mSlots(RoundUpToPowerOfTwo(capacity + 1)), mMask(mSlots.size() - 1), mHead(0), mTail(0)
+		{
+		}
+
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue& operator=(const SpscQueue&) = delete;
+		SpscQueue(SpscQueue&&) = delete;
+		SpscQueue& operator=(SpscQueue&&) = delete;
+		~SpscQueue() = default;
+
+		// Producer only. Returns false, leaving the queue unchanged, when it is full.
+		bool TryPush(const T& item)
+		{
+			const std::size_t tail = mTail.load(std::memory_order_relaxed);
+			const std::size_t nextTail = (tail + 1) & mMask;
+			if (nextTail == mHead.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+
+			mSlots[tail] = item;
+			mTail.store(nextTail, std::memory_order_release);
+
+			return true;
+		}
+
+		// Consumer only. Returns false, leaving item unchanged, when the queue is empty.
+		bool TryPop(T& item)
+		{
+			const std::size_t head = mHead.load(std::memory_order_relaxed);
+			if (head == mTail.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+
+			item = mSlots[head];
+			mHead.store((head + 1) & mMask, std::memory_order_release);
+
+			return true;
+		}
+
+		// Either side may ask, but the answer can be stale by the time it is used unless the caller is the only one that could change it.
+		bool IsEmpty() const
+		{
+			return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+		}
+
+		std::size_t Capacity() const
+		{
+			return mSlots.size() - 1;
+		}
+
+	private:
+		static const std::size_t CacheLineSize = 64;
+
+		static std::size_t RoundUpToPowerOfTwo(std::size_t value)
+		{
+			assert(value > 1);
+
+			std::size_t result = 2;
+			while (result < value)
+			{
+				result <<= 1;
+			}
+
+			return result;
+		}
+
+		std::vector<T> mSlots;
+		const std::size_t mMask;
+
+		// Keep the indices on separate cache lines so the two threads don't contend for one line.
+		char mPadding[CacheLineSize];
+		std::atomic<std::size_t> mHead;
+		char mPadding2[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+		std::atomic<std::size_t> mTail;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,493 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+
+namespace Library
+{
+	// Forwards pipeline state calls to a device context and drops the ones that would rebind what is already bound.
+	// Slot ranges are narrowed to the slots that actually change. TTypes names the context and pipeline object types
+	// (see Direct3DStateCache.h); any context with the same member functions works, so the filtering can be exercised against
+	// a recording mock without a device.
+	// Anything that changes state behind the wrapper (SpriteBatch, ClearState, ExecuteCommandList) must be followed by Invalidate().
+	template <typename TTypes>
+	class StateCachingContext final
+	{
+	public:
+		typedef typename TTypes::DeviceContext DeviceContext;
+		typedef typename TTypes::PrimitiveTopology PrimitiveTopology;
+		typedef typename TTypes::Format Format;
+		typedef typename TTypes::InputLayout InputLayout;
+		typedef typename TTypes::Buffer Buffer;
+		typedef typename TTypes::VertexShader VertexShader;
+		typedef typename TTypes::PixelShader PixelShader;
+		typedef typename TTypes::ClassInstance ClassInstance;
+		typedef typename TTypes::ShaderResourceView ShaderResourceView;
+		typedef typename TTypes::SamplerState SamplerState;
+		typedef typename TTypes::RasterizerState RasterizerState;
+		typedef typename TTypes::BlendState BlendState;
+		typedef typename TTypes::DepthStencilState DepthStencilState;
+
+		static const std::uint32_t VertexBufferSlotCount = 32;
+		static const std::uint32_t ConstantBufferSlotCount = 14;
+		static const std::uint32_t ShaderResourceSlotCount = 16;
+		static const std::uint32_t SamplerSlotCount = 16;
+
+		explicit StateCachingContext(DeviceContext* context = nullptr);
+		StateCachingContext(const StateCachingContext&) = default;
+		StateCachingContext& operator=(const StateCachingContext&) = default;
+		StateCachingContext(StateCachingContext&&) = default;
+		StateCachingContext& operator=(StateCachingContext&&) = default;
+		~StateCachingContext() = default;
+
+		DeviceContext* Context() const;
+		void SetContext(DeviceContext* context);
+
+		// Forgets everything bound, so the next call of each kind is issued.
+		void Invalidate();
+
+		void IASetPrimitiveTopology(PrimitiveTopology topology);
+		void IASetInputLayout(InputLayout* inputLayout);
+		void IASetVertexBuffers(std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers, const std::uint32_t* strides, const std::uint32_t* offsets);
+		void IASetIndexBuffer(Buffer* buffer, Format format, std::uint32_t offset);
+
+		void VSSetShader(VertexShader* shader, ClassInstance* const* classInstances, std::uint32_t classInstanceCount);
+		void PSSetShader(PixelShader* shader, ClassInstance* const* classInstances, std::uint32_t classInstanceCount);
+
+		void VSSetConstantBuffers(std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers);
+		void PSSetConstantBuffers(std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers);
+		void VSSetConstantBuffers1(std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers, const std::uint32_t* firstConstants, const std::uint32_t* constantCounts);
+		void PSSetConstantBuffers1(std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers, const std::uint32_t* firstConstants, const std::uint32_t* constantCounts);
+
+		void PSSetShaderResources(std::uint32_t startSlot, std::uint32_t count, ShaderResourceView* const* shaderResourceViews);
+		void PSSetSamplers(std::uint32_t startSlot, std::uint32_t count, SamplerState* const* samplers);
+
+		void RSSetState(RasterizerState* rasterizerState);
+		void OMSetBlendState(BlendState* blendState, const float* blendFactor, std::uint32_t sampleMask);
+		void OMSetDepthStencilState(DepthStencilState* depthStencilState, std::uint32_t stencilReference);
+
+		// State calls forwarded to and dropped before the context since the last ResetStatistics().
+		std::uint32_t IssuedCallCount() const;
+		std::uint32_t FilteredCallCount() const;
+		void ResetStatistics();
+
+	private:
+		struct BufferSlot
+		{
+			const void* Buffer;
+			std::uint32_t First;
+			std::uint32_t Count;
+			bool IsKnown;
+		};
+
+		struct ObjectSlot
+		{
+			const void* Object;
+			bool IsKnown;
+		};
+
+		struct ShaderStage
+		{
+			ObjectSlot Shader;
+			BufferSlot ConstantBuffers[ConstantBufferSlotCount];
+		};
+
+		// Finds the slots in [startSlot, startSlot + count) that differ from the bindings and returns the first and last of them in
+		// first/last. Slots beyond the cache always count as different. Returns false when nothing would change.
+		template <typename TSlot, typename TEquals>
+		static bool ChangedRange(TSlot* slots, std::uint32_t slotCount, std::uint32_t startSlot, std::uint32_t count, TEquals equals, std::uint32_t& first, std::uint32_t& last);
+
+		bool UpdateConstantBuffers(ShaderStage& stage, std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers, const std::uint32_t* firstConstants, const std::uint32_t* constantCounts, std::uint32_t& first, std::uint32_t& last);
+
+		static bool UpdateObject(ObjectSlot& slot, const void* object);
+		bool Count(bool changed);
+
+		// Binding without offsets exposes the whole buffer, which never equals an offset binding.
+		static const std::uint32_t WholeBuffer = UINT32_MAX;
+
+		DeviceContext* mContext;
+		std::int64_t mTopology;
+		bool mIsTopologyKnown;
+		ObjectSlot mInputLayout;
+		BufferSlot mVertexBuffers[VertexBufferSlotCount];
+		BufferSlot mIndexBuffer;
+		ShaderStage mVertexStage;
+		ShaderStage mPixelStage;
+		ObjectSlot mShaderResources[ShaderResourceSlotCount];
+		ObjectSlot mSamplers[SamplerSlotCount];
+		ObjectSlot mRasterizerState;
+		ObjectSlot mBlendState;
+		float mBlendFactor[4];
+		std::uint32_t mSampleMask;
+		ObjectSlot mDepthStencilState;
+		std::uint32_t mStencilReference;
+		std::uint32_t mIssuedCallCount;
+		std::uint32_t mFilteredCallCount;
+	};
+
+	template <typename TTypes>
+	StateCachingContext<TTypes>::StateCachingContext(DeviceContext* context) :
+		mContext(context), mIssuedCallCount(0), mFilteredCallCount(0)
+	{
+		Invalidate();
+	}
+
+	template <typename TTypes>
+	typename StateCachingContext<TTypes>::DeviceContext* StateCachingContext<TTypes>::Context() const
+	{
+		return mContext;
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::SetContext(DeviceContext* context)
+	{
+		mContext = context;
+		Invalidate();
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::Invalidate()
+	{
+		const BufferSlot unknownBuffer = { nullptr, 0, 0, false };
+		const ObjectSlot unknownObject = { nullptr, false };
+
+		mTopology = 0;
+		mIsTopologyKnown = false;
+		mInputLayout = unknownObject;
+		for (BufferSlot& slot : mVertexBuffers)
+		{
+			slot = unknownBuffer;
+		}
+		mIndexBuffer = unknownBuffer;
+
+		for (ShaderStage* stage : { &mVertexStage, &mPixelStage })
+		{
+			stage->Shader = unknownObject;
+			for (BufferSlot& slot : stage->ConstantBuffers)
+			{
+				slot = unknownBuffer;
+			}
+		}
+
+		for (ObjectSlot& slot : mShaderResources)
+		{
+			slot = unknownObject;
+		}
+
+		for (ObjectSlot& slot : mSamplers)
+		{
+			slot = unknownObject;
+		}
+
+		mRasterizerState = unknownObject;
+		mBlendState = unknownObject;
+		mDepthStencilState = unknownObject;
+		mBlendFactor[0] = mBlendFactor[1] = mBlendFactor[2] = mBlendFactor[3] = 1.0f;
+		mSampleMask = 0;
+		mStencilReference = 0;
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::IASetPrimitiveTopology(PrimitiveTopology topology)
+	{
+		std::int64_t value = static_cast<std::int64_t>(topology);
+		if (Count(mIsTopologyKnown == false || mTopology != value))
+		{
+			mContext->IASetPrimitiveTopology(topology);
+			mTopology = value;
+			mIsTopologyKnown = true;
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::IASetInputLayout(InputLayout* inputLayout)
+	{
+		if (Count(UpdateObject(mInputLayout, inputLayout)))
+		{
+			mContext->IASetInputLayout(inputLayout);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::IASetVertexBuffers(std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers, const std::uint32_t* strides, const std::uint32_t* offsets)
+	{
+		auto equals = [&](const BufferSlot& slot, std::uint32_t i)
+		{
+			return (slot.Buffer == buffers[i] && slot.First == offsets[i] && slot.Count == strides[i]);
+		};
+
+		std::uint32_t first;
+		std::uint32_t last;
+		if (Count(ChangedRange(mVertexBuffers, VertexBufferSlotCount, startSlot, count, equals, first, last)))
+		{
+			for (std::uint32_t i = first; i <= last && startSlot + i < VertexBufferSlotCount; ++i)
+			{
+				BufferSlot slot = { buffers[i], offsets[i], strides[i], true };
+				mVertexBuffers[startSlot + i] = slot;
+			}
+
+			mContext->IASetVertexBuffers(startSlot + first, last - first + 1, buffers + first, strides + first, offsets + first);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::IASetIndexBuffer(Buffer* buffer, Format format, std::uint32_t offset)
+	{
+		std::uint32_t formatValue = static_cast<std::uint32_t>(format);
+		bool changed = (mIndexBuffer.IsKnown == false || mIndexBuffer.Buffer != buffer || mIndexBuffer.First != offset || mIndexBuffer.Count != formatValue);
+		if (Count(changed))
+		{
+			BufferSlot slot = { buffer, offset, formatValue, true };
+			mIndexBuffer = slot;
+			mContext->IASetIndexBuffer(buffer, format, offset);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::VSSetShader(VertexShader* shader, ClassInstance* const* classInstances, std::uint32_t classInstanceCount)
+	{
+		// Class linkage is not tracked, so calls that use it always go through.
+		bool changed = UpdateObject(mVertexStage.Shader, shader);
+		if (Count(changed || classInstanceCount > 0))
+		{
+			mContext->VSSetShader(shader, classInstances, classInstanceCount);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::PSSetShader(PixelShader* shader, ClassInstance* const* classInstances, std::uint32_t classInstanceCount)
+	{
+		bool changed = UpdateObject(mPixelStage.Shader, shader);
+		if (Count(changed || classInstanceCount > 0))
+		{
+			mContext->PSSetShader(shader, classInstances, classInstanceCount);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::VSSetConstantBuffers(std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers)
+	{
+		std::uint32_t first;
+		std::uint32_t last;
+		if (Count(UpdateConstantBuffers(mVertexStage, startSlot, count, buffers, nullptr, nullptr, first, last)))
+		{
+			mContext->VSSetConstantBuffers(startSlot + first, last - first + 1, buffers + first);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::PSSetConstantBuffers(std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers)
+	{
+		std::uint32_t first;
+		std::uint32_t last;
+		if (Count(UpdateConstantBuffers(mPixelStage, startSlot, count, buffers, nullptr, nullptr, first, last)))
+		{
+			mContext->PSSetConstantBuffers(startSlot + first, last - first + 1, buffers + first);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::VSSetConstantBuffers1(std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers, const std::uint32_t* firstConstants, const std::uint32_t* constantCounts)
+	{
+		std::uint32_t first;
+		std::uint32_t last;
+		if (Count(UpdateConstantBuffers(mVertexStage, startSlot, count, buffers, firstConstants, constantCounts, first, last)))
+		{
+			mContext->VSSetConstantBuffers1(startSlot + first, last - first + 1, buffers + first, firstConstants + first, constantCounts + first);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::PSSetConstantBuffers1(std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers, const std::uint32_t* firstConstants, const std::uint32_t* constantCounts)
+	{
+		std::uint32_t first;
+		std::uint32_t last;
+		if (Count(UpdateConstantBuffers(mPixelStage, startSlot, count, buffers, firstConstants, constantCounts, first, last)))
+		{
+			mContext->PSSetConstantBuffers1(startSlot + first, last - first + 1, buffers + first, firstConstants + first, constantCounts + first);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::PSSetShaderResources(std::uint32_t startSlot, std::uint32_t count, ShaderResourceView* const* shaderResourceViews)
+	{
+		auto equals = [&](const ObjectSlot& slot, std::uint32_t i)
+		{
+			return (slot.Object == shaderResourceViews[i]);
+		};
+
+		std::uint32_t first;
+		std::uint32_t last;
+		if (Count(ChangedRange(mShaderResources, ShaderResourceSlotCount, startSlot, count, equals, first, last)))
+		{
+			for (std::uint32_t i = first; i <= last && startSlot + i < ShaderResourceSlotCount; ++i)
+			{
+				UpdateObject(mShaderResources[startSlot + i], shaderResourceViews[i]);
+			}
+
+			mContext->PSSetShaderResources(startSlot + first, last - first + 1, shaderResourceViews + first);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::PSSetSamplers(std::uint32_t startSlot, std::uint32_t count, SamplerState* const* samplers)
+	{
+		auto equals = [&](const ObjectSlot& slot, std::uint32_t i)
+		{
+			return (slot.Object == samplers[i]);
+		};
+
+		std::uint32_t first;
+		std::uint32_t last;
+		if (Count(ChangedRange(mSamplers, SamplerSlotCount, startSlot, count, equals, first, last)))
+		{
+			for (std::uint32_t i = first; i <= last && startSlot + i < SamplerSlotCount; ++i)
+			{
+				UpdateObject(mSamplers[startSlot + i], samplers[i]);
+			}
+
+			mContext->PSSetSamplers(startSlot + first, last - first + 1, samplers + first);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::RSSetState(RasterizerState* rasterizerState)
+	{
+		if (Count(UpdateObject(mRasterizerState, rasterizerState)))
+		{
+			mContext->RSSetState(rasterizerState);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::OMSetBlendState(BlendState* blendState, const float* blendFactor, std::uint32_t sampleMask)
+	{
+		// A null blend factor means (1, 1, 1, 1).
+		static const float DefaultBlendFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		const float* factor = (blendFactor != nullptr ? blendFactor : DefaultBlendFactor);
+
+		bool changed = (mBlendState.IsKnown == false || mBlendState.Object != blendState || mSampleMask != sampleMask ||
+			mBlendFactor[0] != factor[0] || mBlendFactor[1] != factor[1] || mBlendFactor[2] != factor[2] || mBlendFactor[3] != factor[3]);
+		if (Count(changed))
+		{
+			UpdateObject(mBlendState, blendState);
+			for (std::uint32_t i = 0; i < 4; ++i)
+			{
+				mBlendFactor[i] = factor[i];
+			}
+			mSampleMask = sampleMask;
+
+			mContext->OMSetBlendState(blendState, blendFactor, sampleMask);
+		}
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::OMSetDepthStencilState(DepthStencilState* depthStencilState, std::uint32_t stencilReference)
+	{
+		bool changed = (mDepthStencilState.IsKnown == false || mDepthStencilState.Object != depthStencilState || mStencilReference != stencilReference);
+		if (Count(changed))
+		{
+			UpdateObject(mDepthStencilState, depthStencilState);
+			mStencilReference = stencilReference;
+
+			mContext->OMSetDepthStencilState(depthStencilState, stencilReference);
+		}
+	}
+
+	template <typename TTypes>
+	std::uint32_t StateCachingContext<TTypes>::IssuedCallCount() const
+	{
+		return mIssuedCallCount;
+	}
+
+	template <typename TTypes>
+	std::uint32_t StateCachingContext<TTypes>::FilteredCallCount() const
+	{
+		return mFilteredCallCount;
+	}
+
+	template <typename TTypes>
+	void StateCachingContext<TTypes>::ResetStatistics()
+	{
+		mIssuedCallCount = 0;
+		mFilteredCallCount = 0;
+	}
+
+	template <typename TTypes>
+	template <typename TSlot, typename TEquals>
+	bool StateCachingContext<TTypes>::ChangedRange(TSlot* slots, std::uint32_t slotCount, std::uint32_t startSlot, std::uint32_t count, TEquals equals, std::uint32_t& first, std::uint32_t& last)
+	{
+		bool changed = false;
+		first = 0;
+		last = 0;
+
+		for (std::uint32_t i = 0; i < count; ++i)
+		{
+			std::uint32_t slotIndex = startSlot + i;
+			if (slotIndex >= slotCount || slots[slotIndex].IsKnown == false || equals(slots[slotIndex], i) == false)
+			{
+				if (changed == false)
+				{
+					first = i;
+					changed = true;
+				}
+
+				last = i;
+			}
+		}
+
+		return changed;
+	}
+
+	template <typename TTypes>
+	bool StateCachingContext<TTypes>::UpdateConstantBuffers(ShaderStage& stage, std::uint32_t startSlot, std::uint32_t count, Buffer* const* buffers, const std::uint32_t* firstConstants, const std::uint32_t* constantCounts, std::uint32_t& first, std::uint32_t& last)
+	{
+		auto equals = [&](const BufferSlot& slot, std::uint32_t i)
+		{
+			return (slot.Buffer == buffers[i] && slot.First == (firstConstants != nullptr ? firstConstants[i] : 0) &&
+				slot.Count == (constantCounts != nullptr ? constantCounts[i] : WholeBuffer));
+		};
+
+		if (ChangedRange(stage.ConstantBuffers, ConstantBufferSlotCount, startSlot, count, equals, first, last) == false)
+		{
+			return false;
+		}
+
+		for (std::uint32_t i = first; i <= last && startSlot + i < ConstantBufferSlotCount; ++i)
+		{
+			BufferSlot slot = { buffers[i], (firstConstants != nullptr ? firstConstants[i] : 0), (constantCounts != nullptr ? constantCounts[i] : WholeBuffer), true };
+			stage.ConstantBuffers[startSlot + i] = slot;
+		}
+
+		return true;
+	}
+
+	template <typename TTypes>
+	bool StateCachingContext<TTypes>::UpdateObject(ObjectSlot& slot, const void* object)
+	{
+		if (slot.IsKnown && slot.Object == object)
+		{
+			return false;
+		}
+
+		slot.Object = object;
+		slot.IsKnown = true;
+
+		return true;
+	}
+
+	template <typename TTypes>
+	bool StateCachingContext<TTypes>::Count(bool changed)
+	{
+		if (changed)
+		{
+			++mIssuedCallCount;
+		}
+		else
+		{
+			++mFilteredCallCount;
+		}
+
+		return changed;
+	}
+}
\ No newline at end of file
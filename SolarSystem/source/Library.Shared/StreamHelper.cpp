@@ -80,6 +80,16 @@ OutputStreamHelper& OutputStreamHelper::operator<<(bool value)
 	return *this;
 }
 
+void OutputStreamHelper::WriteArray(const float* values, size_t count)
+{
+	mStream.write(reinterpret_cast<const char*>(values), count * sizeof(float));
+}
+
+void OutputStreamHelper::WriteArray(const uint32_t* values, size_t count)
+{
+	mStream.write(reinterpret_cast<const char*>(values), count * sizeof(uint32_t));
+}
+
 template <typename T>
 void OutputStreamHelper::WriteObject(ostream& stream, T value)
 {
@@ -172,6 +182,16 @@ InputStreamHelper& InputStreamHelper::operator>>(bool& value)
 	return *this;
 }
 
+void InputStreamHelper::ReadArray(float* values, size_t count)
+{
+	mStream.read(reinterpret_cast<char*>(values), count * sizeof(float));
+}
+
+void InputStreamHelper::ReadArray(uint32_t* values, size_t count)
+{
+	mStream.read(reinterpret_cast<char*>(values), count * sizeof(uint32_t));
+}
+
 template <typename T>
 void InputStreamHelper::ReadObject(istream& stream, T& value)
 {
@@ -179,7 +199,7 @@ void InputStreamHelper::ReadObject(istream& stream, T& value)
 
 	for (uint32_t size = 0; size < sizeof(T); ++size)
 	{
-		value |= stream.get() << (8 * size);
+		value |= static_cast<T>(static_cast<T>(static_cast<byte>(stream.get())) << (8 * size));
 	}
 }
 
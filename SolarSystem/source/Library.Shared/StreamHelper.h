@@ -26,6 +26,11 @@ namespace Library
 		OutputStreamHelper& operator<<(const std::string& value);
 		OutputStreamHelper& operator<<(const DirectX::XMFLOAT4X4& value);
 		OutputStreamHelper& operator<<(bool value);
+
+		// Write the same bytes as writing the values one at a time, in one write. Integers are written little-endian, which
+		// is how every platform this builds for stores them, so they are copied as they are.
+		void WriteArray(const float* values, std::size_t count);
+		void WriteArray(const std::uint32_t* values, std::size_t count);
 		
 	private:
 		template <typename T>
@@ -51,6 +56,10 @@ namespace Library
 		InputStreamHelper& operator>>(std::string& value);
 		InputStreamHelper& operator>>(DirectX::XMFLOAT4X4& value);
 		InputStreamHelper& operator>>(bool& value);
+
+		// Read values written one at a time or with OutputStreamHelper::WriteArray(), in one read.
+		void ReadArray(float* values, std::size_t count);
+		void ReadArray(std::uint32_t* values, std::size_t count);
 		
 	private:
 		template <typename T>
@@ -0,0 +1,138 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	TextBuilder::Precision TextBuilder::Fixed(int digits)
+	{
+		Precision precision = { digits };
+		return precision;
+	}
+
+	TextBuilder::TextBuilder(MemoryResource& resource, size_t reserve) :
+		mText(PolymorphicAllocator<wchar_t>(resource)), mPrecision(-1)
+	{
+		mText.reserve(reserve);
+	}
+
+	TextBuilder& TextBuilder::operator<<(const wchar_t* text)
+	{
+		mText.append(text);
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(const wstring& text)
+	{
+		mText.append(text.c_str(), text.size());
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(wchar_t character)
+	{
+		mText.push_back(character);
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(const char* text)
+	{
+		for (; *text != '\0'; ++text)
+		{
+			mText.push_back(static_cast<wchar_t>(*text));
+		}
+
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(int value)
+	{
+		AppendFormatted(L"%d", value);
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(unsigned int value)
+	{
+		AppendFormatted(L"%u", value);
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(long value)
+	{
+		AppendFormatted(L"%ld", value);
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(unsigned long value)
+	{
+		AppendFormatted(L"%lu", value);
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(long long value)
+	{
+		AppendFormatted(L"%lld", value);
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(unsigned long long value)
+	{
+		AppendFormatted(L"%llu", value);
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(double value)
+	{
+		if (mPrecision < 0)
+		{
+			AppendFormatted(L"%g", value);
+		}
+		else
+		{
+			AppendFormatted(L"%.*f", mPrecision, value);
+		}
+
+		return *this;
+	}
+
+	TextBuilder& TextBuilder::operator<<(Precision precision)
+	{
+		mPrecision = precision.Digits;
+		return *this;
+	}
+
+	const wchar_t* TextBuilder::c_str() const
+	{
+		return mText.c_str();
+	}
+
+	const TextBuilder::String& TextBuilder::Text() const
+	{
+		return mText;
+	}
+
+	size_t TextBuilder::Length() const
+	{
+		return mText.size();
+	}
+
+	void TextBuilder::Clear()
+	{
+		mText.clear();
+	}
+
+	void TextBuilder::AppendFormatted(const wchar_t* format, ...)
+	{
+		// Large enough for any 64-bit integer, and for doubles at the precisions display text uses
+		wchar_t buffer[64];
+
+		va_list arguments;
+		va_start(arguments, format);
+		int length = vswprintf(buffer, ARRAYSIZE(buffer), format, arguments);
+		va_end(arguments);
+
+		if (length > 0)
+		{
+			mText.append(buffer, static_cast<size_t>(length));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "MemoryResource.h"
+#include <string>
+#include <cstdint>
+
+namespace Library
+{
+	// Builds display text with the same << chaining as a wostringstream, into a string that allocates from a MemoryResource
+	// (usually the frame arena), for text that is rebuilt every frame. Floating-point values print like the stream's default
+	// until Fixed() sets a number of decimal places, which then applies to the rest of the text, like std::fixed with
+	// std::setprecision().
+	class TextBuilder final
+	{
+	public:
+		typedef std::basic_string<wchar_t, std::char_traits<wchar_t>, PolymorphicAllocator<wchar_t>> String;
+
+		struct Precision
+		{
+			int Digits;
+		};
+
+		static Precision Fixed(int digits);
+
+		explicit TextBuilder(MemoryResource& resource, std::size_t reserve = DefaultReserve);
+		TextBuilder(const TextBuilder&) = delete;
+		TextBuilder& operator=(const TextBuilder&) = delete;
+		TextBuilder(TextBuilder&&) = delete;
+		TextBuilder& operator=(TextBuilder&&) = delete;
+		~TextBuilder() = default;
+
+		TextBuilder& operator<<(const wchar_t* text);
+		TextBuilder& operator<<(const std::wstring& text);
+		TextBuilder& operator<<(wchar_t character);
+
+		// ASCII only, for "\n" and the like.
+		TextBuilder& operator<<(const char* text);
+
+		TextBuilder& operator<<(int value);
+		TextBuilder& operator<<(unsigned int value);
+		TextBuilder& operator<<(long value);
+		TextBuilder& operator<<(unsigned long value);
+		TextBuilder& operator<<(long long value);
+		TextBuilder& operator<<(unsigned long long value);
+		TextBuilder& operator<<(double value);
+		TextBuilder& operator<<(Precision precision);
+
+		const wchar_t* c_str() const;
+		const String& Text() const;
+		std::size_t Length() const;
+		void Clear();
+
+		static const std::size_t DefaultReserve = 256;
+
+	private:
+		void AppendFormatted(const wchar_t* format, ...);
+
+		String mText;
+		int mPrecision;
+	};
+}
\ No newline at end of file
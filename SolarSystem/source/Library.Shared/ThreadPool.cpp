@@ -0,0 +1,91 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace Library
+{
+	ThreadPool::ThreadPool(uint32_t threadCount) :
+		mShuttingDown(false)
+	{
+		assert(threadCount > 0);
+
+		mThreads.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; ++i)
+		{
+			mThreads.emplace_back(&ThreadPool::WorkerThread, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			lock_guard<mutex> lock(mMutex);
+			mShuttingDown = true;
+		}
+
+		mTaskAvailable.notify_all();
+		for (thread& workerThread : mThreads)
+		{
+			workerThread.join();
+		}
+	}
+
+	uint32_t ThreadPool::ThreadCount() const
+	{
+		return static_cast<uint32_t>(mThreads.size());
+	}
+
+	future<void> ThreadPool::Enqueue(function<void()> task)
+	{
+		// Tasks are charged to the subsystem that queued them
+		const MemoryTag memoryTag = AllocationCounter::CurrentTag();
+		packaged_task<void()> packagedTask([memoryTag, task = move(task)]()
+		{
+			MemoryTagScope memoryTagScope(memoryTag);
+			task();
+		});
+		future<void> result = packagedTask.get_future();
+
+		{
+			lock_guard<mutex> lock(mMutex);
+			mTasks.push(move(packagedTask));
+		}
+
+		mTaskAvailable.notify_one();
+
+		return result;
+	}
+
+	uint32_t ThreadPool::DefaultThreadCount()
+	{
+		// Leave one hardware thread for the thread that owns the immediate context.
+		uint32_t hardwareThreads = thread::hardware_concurrency();
+
+		return (hardwareThreads > 1 ? hardwareThreads - 1 : 1);
+	}
+
+	void ThreadPool::WorkerThread(uint32_t index)
+	{
+		Profiler::SetThreadName("Worker " + to_string(index));
+
+		for (;;)
+		{
+			packaged_task<void()> task;
+
+			{
+				unique_lock<mutex> lock(mMutex);
+				mTaskAvailable.wait(lock, [this] { return mShuttingDown || mTasks.empty() == false; });
+
+				if (mTasks.empty())
+				{
+					return;
+				}
+
+				task = move(mTasks.front());
+				mTasks.pop();
+			}
+
+			task();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <cstdint>
+
+namespace Library
+{
+	class ThreadPool final
+	{
+	public:
+		ThreadPool(std::uint32_t threadCount = DefaultThreadCount());
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+		~ThreadPool();
+
+		std::uint32_t ThreadCount() const;
+
+		std::future<void> Enqueue(std::function<void()> task);
+
+		static std::uint32_t DefaultThreadCount();
+
+	private:
+		void WorkerThread(std::uint32_t index);
+
+		std::vector<std::thread> mThreads;
+		std::queue<std::packaged_task<void()>> mTasks;
+		std::mutex mMutex;
+		std::condition_variable mTaskAvailable;
+		bool mShuttingDown;
+	};
+}
\ No newline at end of file
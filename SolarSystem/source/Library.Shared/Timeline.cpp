@@ -0,0 +1,138 @@
+#include "pch.h"
+#include <thread>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace Library
+{
+	Timeline::Timeline(double scale, double epochSeconds) :
+		mSequence(0), mTotal(0), mElapsed(0), mEpochSeconds(epochSeconds), mScale(scale), mIsPaused(false), mRemainder(0.0)
+	{
+		assert(scale >= 0.0);
+	}
+
+	Timeline::Reading Timeline::Read() const
+	{
+		for (;;)
+		{
+			const uint32_t sequence = mSequence.load(memory_order_acquire);
+			if ((sequence & 1) == 0)
+			{
+				const int64_t total = mTotal.load(memory_order_relaxed);
+				const int64_t elapsed = mElapsed.load(memory_order_relaxed);
+				const double epochSeconds = mEpochSeconds.load(memory_order_relaxed);
+
+				atomic_thread_fence(memory_order_acquire);
+				if (mSequence.load(memory_order_relaxed) == sequence)
+				{
+					// Whole seconds and the nanoseconds left over are added separately, so the epoch's precision is all that limits
+					// the sum.
+					Reading reading;
+					reading.Total = nanoseconds(total);
+					reading.Elapsed = nanoseconds(elapsed);
+					reading.Seconds = epochSeconds + static_cast<double>(total / 1000000000) + static_cast<double>(total % 1000000000) * 1e-9;
+					return reading;
+				}
+			}
+
+			this_thread::yield();
+		}
+	}
+
+	nanoseconds Timeline::Total() const
+	{
+		return Read().Total;
+	}
+
+	nanoseconds Timeline::Elapsed() const
+	{
+		return Read().Elapsed;
+	}
+
+	double Timeline::Seconds() const
+	{
+		return Read().Seconds;
+	}
+
+	double Timeline::Scale() const
+	{
+		return mScale.load(memory_order_relaxed);
+	}
+
+	void Timeline::SetScale(double scale)
+	{
+		assert(scale >= 0.0);
+		mScale.store(scale, memory_order_relaxed);
+	}
+
+	bool Timeline::IsPaused() const
+	{
+		return mIsPaused.load(memory_order_relaxed);
+	}
+
+	void Timeline::SetPaused(bool paused)
+	{
+		mIsPaused.store(paused, memory_order_relaxed);
+	}
+
+	double Timeline::EpochSeconds() const
+	{
+		return mEpochSeconds.load(memory_order_relaxed);
+	}
+
+	void Timeline::SetEpochSeconds(double epochSeconds)
+	{
+		Publish(mTotal.load(memory_order_relaxed), mElapsed.load(memory_order_relaxed), epochSeconds);
+	}
+
+	nanoseconds Timeline::Advance(const nanoseconds& time)
+	{
+		assert(time.count() >= 0);
+
+		int64_t elapsed = 0;
+		if (IsPaused() == false)
+		{
+			const double scale = Scale();
+			if (scale == 1.0)
+			{
+				elapsed = time.count();
+			}
+			else
+			{
+				const double scaled = static_cast<double>(time.count()) * scale + mRemainder;
+				const double whole = floor(scaled);
+				mRemainder = scaled - whole;
+				elapsed = static_cast<int64_t>(whole);
+			}
+		}
+
+		const int64_t total = mTotal.load(memory_order_relaxed);
+		assert(elapsed <= (numeric_limits<int64_t>::max)() - total);
+
+		Publish(total + elapsed, elapsed, mEpochSeconds.load(memory_order_relaxed));
+
+		return nanoseconds(elapsed);
+	}
+
+	void Timeline::Reset()
+	{
+		mRemainder = 0.0;
+		Publish(0, 0, mEpochSeconds.load(memory_order_relaxed));
+	}
+
+	void Timeline::Publish(int64_t total, int64_t elapsed, double epochSeconds)
+	{
+		const uint32_t sequence = mSequence.load(memory_order_relaxed);
+		mSequence.store(sequence + 1, memory_order_relaxed);
+		atomic_thread_fence(memory_order_release);
+
+		mTotal.store(total, memory_order_relaxed);
+		mElapsed.store(elapsed, memory_order_relaxed);
+		mEpochSeconds.store(epochSeconds, memory_order_relaxed);
+
+		mSequence.store(sequence + 2, memory_order_release);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Library
+{
+	// A clock that advances by the time it is given, times its scale, unless it is paused. Its time is kept in whole
+	// nanoseconds, about 292 years' worth, and the fractions of a nanosecond that scaling leaves over are carried into the
+	// next step, so a timeline doesn't drift however long it runs. Seconds() adds the time to an epoch, e.g. for a
+	// simulation's calendar. One thread, the clock's owner, calls Advance(), Reset() and SetEpochSeconds(); any thread may
+	// read the timeline and change its scale or pause it. Read() gives a consistent reading without locking.
+	class Timeline final
+	{
+	public:
+		struct Reading
+		{
+			std::chrono::nanoseconds Total;
+			std::chrono::nanoseconds Elapsed;
+			double Seconds;
+		};
+
+		explicit Timeline(double scale = 1.0, double epochSeconds = 0.0);
+		Timeline(const Timeline&) = delete;
+		Timeline& operator=(const Timeline&) = delete;
+		Timeline(Timeline&&) = delete;
+		Timeline& operator=(Timeline&&) = delete;
+		~Timeline() = default;
+
+		Reading Read() const;
+		std::chrono::nanoseconds Total() const;
+		std::chrono::nanoseconds Elapsed() const;
+		double Seconds() const;
+
+		double Scale() const;
+		void SetScale(double scale);
+
+		bool IsPaused() const;
+		void SetPaused(bool paused);
+
+		double EpochSeconds() const;
+		void SetEpochSeconds(double epochSeconds);
+
+		// Moves the timeline on by time * Scale(), or not at all while paused, and returns how far it moved.
+		std::chrono::nanoseconds Advance(const std::chrono::nanoseconds& time);
+
+		// Back to the epoch; the scale and pause state are kept.
+		void Reset();
+
+	private:
+		void Publish(std::int64_t total, std::int64_t elapsed, double epochSeconds);
+
+		// Odd while the owner is publishing; readers retry until they see the same even value before and after.
+		std::atomic<std::uint32_t> mSequence;
+		std::atomic<std::int64_t> mTotal;
+		std::atomic<std::int64_t> mElapsed;
+		std::atomic<double> mEpochSeconds;
+		std::atomic<double> mScale;
+		std::atomic<bool> mIsPaused;
+		double mRemainder;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,503 @@
+#include "pch.h"
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LIBRARY_TARGET_AVX2
+#define LIBRARY_TARGET_AVX512
+#else
+#define LIBRARY_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define LIBRARY_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#endif
+
+using namespace std;
+using namespace DirectX;
+
+namespace Library
+{
+	void TransformKernels::ComposeTrs(const TrsArrays& trs, const MatrixArray& matrices, size_t count)
+	{
+		ComposeTrs(trs, matrices, count, BestInstructionSet());
+	}
+
+	void TransformKernels::ComposeTrs(const TrsArrays& trs, const MatrixArray& matrices, size_t count, InstructionSet instructionSet)
+	{
+		size_t first = 0;
+		size_t last;
+		switch (instructionSet)
+		{
+		case InstructionSet::AVX512:
+#if defined(LIBRARY_AVX512_INTRINSICS)
+			last = count - count % AVX512Width;
+			ComposeTrsAVX512(trs, matrices, first, last);
+			first = last;
+#endif
+			// Falls through
+		case InstructionSet::AVX2:
+			last = first + (count - first) / AVX2Width * AVX2Width;
+			ComposeTrsAVX2(trs, matrices, first, last);
+			first = last;
+			// Falls through
+		case InstructionSet::SSE:
+			last = first + (count - first) / SSEWidth * SSEWidth;
+			ComposeTrsSSE(trs, matrices, first, last);
+			first = last;
+			break;
+
+		default:
+			break;
+		}
+
+		ComposeTrsScalar(trs, matrices, first, count);
+	}
+
+	void TransformKernels::Multiply(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, size_t count)
+	{
+		Multiply(lhs, rhs, products, count, BestInstructionSet());
+	}
+
+	void TransformKernels::Multiply(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, size_t count, InstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case InstructionSet::AVX512:
+#if defined(LIBRARY_AVX512_INTRINSICS)
+			MultiplyAVX512(lhs, rhs, products, 0, count);
+			break;
+#endif
+			// Falls through
+		case InstructionSet::AVX2:
+			MultiplyAVX2(lhs, rhs, products, 0, count);
+			break;
+
+		case InstructionSet::SSE:
+			MultiplySSE(lhs, rhs, products, 0, count);
+			break;
+
+		default:
+			MultiplyScalar(lhs, rhs, products, 0, count);
+			break;
+		}
+	}
+
+	void TransformKernels::WorldViewProjection(const ConstMatrixArray& worlds, const XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, size_t count)
+	{
+		WorldViewProjection(worlds, viewProjection, transposedWorlds, transposedWorldViewProjections, count, BestInstructionSet());
+	}
+
+	void TransformKernels::WorldViewProjection(const ConstMatrixArray& worlds, const XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, size_t count, InstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case InstructionSet::AVX512:
+#if defined(LIBRARY_AVX512_INTRINSICS)
+			WorldViewProjectionAVX512(worlds, viewProjection, transposedWorlds, transposedWorldViewProjections, 0, count);
+			break;
+#endif
+			// Falls through
+		case InstructionSet::AVX2:
+			WorldViewProjectionAVX2(worlds, viewProjection, transposedWorlds, transposedWorldViewProjections, 0, count);
+			break;
+
+		case InstructionSet::SSE:
+			WorldViewProjectionSSE(worlds, viewProjection, transposedWorlds, transposedWorldViewProjections, 0, count);
+			break;
+
+		default:
+			WorldViewProjectionScalar(worlds, viewProjection, transposedWorlds, transposedWorldViewProjections, 0, count);
+			break;
+		}
+	}
+
+	void TransformKernels::Transpose(const ConstMatrixArray& matrices, const MatrixArray& transposed, size_t count)
+	{
+		Transpose(matrices, transposed, count, BestInstructionSet());
+	}
+
+	void TransformKernels::Transpose(const ConstMatrixArray& matrices, const MatrixArray& transposed, size_t count, InstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case InstructionSet::AVX512:
+#if defined(LIBRARY_AVX512_INTRINSICS)
+			TransposeAVX512(matrices, transposed, 0, count);
+			break;
+#endif
+			// Falls through
+		case InstructionSet::AVX2:
+			TransposeAVX2(matrices, transposed, 0, count);
+			break;
+
+		case InstructionSet::SSE:
+			TransposeSSE(matrices, transposed, 0, count);
+			break;
+
+		default:
+			TransposeScalar(matrices, transposed, 0, count);
+			break;
+		}
+	}
+
+	TransformKernels::InstructionSet TransformKernels::BestInstructionSet()
+	{
+		static const InstructionSet instructionSet = DetectInstructionSet();
+		return instructionSet;
+	}
+
+	const char* TransformKernels::InstructionSetName(InstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case InstructionSet::SSE:
+			return "SSE";
+
+		case InstructionSet::AVX2:
+			return "AVX2";
+
+		case InstructionSet::AVX512:
+			return "AVX-512";
+
+		default:
+			return "Scalar";
+		}
+	}
+
+#pragma region AVX2
+
+	LIBRARY_TARGET_AVX2 LIBRARY_FORCEINLINE void TransformKernels::TransposeLanesAVX2(__m256* rows)
+	{
+		// A 4x4 transpose within each 128-bit half.
+		const __m256 low01 = _mm256_unpacklo_ps(rows[0], rows[1]);
+		const __m256 high01 = _mm256_unpackhi_ps(rows[0], rows[1]);
+		const __m256 low23 = _mm256_unpacklo_ps(rows[2], rows[3]);
+		const __m256 high23 = _mm256_unpackhi_ps(rows[2], rows[3]);
+
+		rows[0] = _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(1, 0, 1, 0));
+		rows[1] = _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(3, 2, 3, 2));
+		rows[2] = _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(1, 0, 1, 0));
+		rows[3] = _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+
+	LIBRARY_TARGET_AVX2 LIBRARY_FORCEINLINE void TransformKernels::StoreRowAVX2(const MatrixArray& matrices, size_t first, size_t row, const __m256* elements)
+	{
+		__m256 rows[4] = { elements[0], elements[1], elements[2], elements[3] };
+		TransposeLanesAVX2(rows);
+
+		for (size_t k = 0; k < 4; ++k)
+		{
+			_mm_storeu_ps(matrices[first + k].m[row], _mm256_castps256_ps128(rows[k]));
+			_mm_storeu_ps(matrices[first + 4 + k].m[row], _mm256_extractf128_ps(rows[k], 1));
+		}
+	}
+
+	LIBRARY_TARGET_AVX2 LIBRARY_FORCEINLINE __m256 TransformKernels::MultiplyRowsAVX2(__m256 rows, const __m256* rhs)
+	{
+		// Two rows of the left-hand matrix, one per half, with every row of rhs in both halves.
+		const __m256 x = _mm256_permute_ps(rows, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m256 y = _mm256_permute_ps(rows, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m256 z = _mm256_permute_ps(rows, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m256 w = _mm256_permute_ps(rows, _MM_SHUFFLE(3, 3, 3, 3));
+
+		return _mm256_add_ps(_mm256_fmadd_ps(z, rhs[2], _mm256_mul_ps(x, rhs[0])), _mm256_fmadd_ps(w, rhs[3], _mm256_mul_ps(y, rhs[1])));
+	}
+
+	LIBRARY_TARGET_AVX2 LIBRARY_FORCEINLINE void TransformKernels::TransposeMatrixAVX2(__m256* rows)
+	{
+		// rows[0] holds rows 0 and 1 of one matrix and rows[1] rows 2 and 3. Interleaving the two rows in each register
+		// leaves every column's elements in adjacent pairs, which 64-bit unpacks put together.
+		const __m256i order = _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7);
+		const __m256d low = _mm256_castps_pd(_mm256_permutevar8x32_ps(rows[0], order));
+		const __m256d high = _mm256_castps_pd(_mm256_permutevar8x32_ps(rows[1], order));
+
+		rows[0] = _mm256_castpd_ps(_mm256_unpacklo_pd(low, high));
+		rows[1] = _mm256_castpd_ps(_mm256_unpackhi_pd(low, high));
+	}
+
+	LIBRARY_TARGET_AVX2 void TransformKernels::ComposeTrsAVX2(const TrsArrays& trs, const MatrixArray& matrices, size_t first, size_t last)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+
+		for (size_t i = first; i < last; i += AVX2Width)
+		{
+			const __m256 x = _mm256_loadu_ps(trs.RotationX + i);
+			const __m256 y = _mm256_loadu_ps(trs.RotationY + i);
+			const __m256 z = _mm256_loadu_ps(trs.RotationZ + i);
+			const __m256 w = _mm256_loadu_ps(trs.RotationW + i);
+			const __m256 x2 = _mm256_add_ps(x, x);
+			const __m256 y2 = _mm256_add_ps(y, y);
+			const __m256 z2 = _mm256_add_ps(z, z);
+
+			const __m256 xx = _mm256_mul_ps(x, x2);
+			const __m256 yy = _mm256_mul_ps(y, y2);
+			const __m256 zz = _mm256_mul_ps(z, z2);
+			const __m256 xy = _mm256_mul_ps(x, y2);
+			const __m256 xz = _mm256_mul_ps(x, z2);
+			const __m256 yz = _mm256_mul_ps(y, z2);
+			const __m256 wx = _mm256_mul_ps(w, x2);
+			const __m256 wy = _mm256_mul_ps(w, y2);
+			const __m256 wz = _mm256_mul_ps(w, z2);
+
+			const __m256 scaleX = _mm256_loadu_ps(trs.ScaleX + i);
+			const __m256 scaleY = _mm256_loadu_ps(trs.ScaleY + i);
+			const __m256 scaleZ = _mm256_loadu_ps(trs.ScaleZ + i);
+
+			const __m256 row0[4] = { _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(one, yy), zz), scaleX), _mm256_mul_ps(_mm256_add_ps(xy, wz), scaleX), _mm256_mul_ps(_mm256_sub_ps(xz, wy), scaleX), zero };
+			const __m256 row1[4] = { _mm256_mul_ps(_mm256_sub_ps(xy, wz), scaleY), _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(one, xx), zz), scaleY), _mm256_mul_ps(_mm256_add_ps(yz, wx), scaleY), zero };
+			const __m256 row2[4] = { _mm256_mul_ps(_mm256_add_ps(xz, wy), scaleZ), _mm256_mul_ps(_mm256_sub_ps(yz, wx), scaleZ), _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(one, xx), yy), scaleZ), zero };
+			const __m256 row3[4] = { _mm256_loadu_ps(trs.TranslationX + i), _mm256_loadu_ps(trs.TranslationY + i), _mm256_loadu_ps(trs.TranslationZ + i), one };
+
+			StoreRowAVX2(matrices, i, 0, row0);
+			StoreRowAVX2(matrices, i, 1, row1);
+			StoreRowAVX2(matrices, i, 2, row2);
+			StoreRowAVX2(matrices, i, 3, row3);
+		}
+
+		_mm256_zeroupper();
+	}
+
+	LIBRARY_TARGET_AVX2 void TransformKernels::MultiplyAVX2(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			const XMFLOAT4X4& a = lhs[i];
+			const XMFLOAT4X4& b = rhs[i];
+			__m256 rhsRows[4];
+			for (size_t row = 0; row < 4; ++row)
+			{
+				const __m128 rhsRow = _mm_loadu_ps(b.m[row]);
+				rhsRows[row] = _mm256_insertf128_ps(_mm256_castps128_ps256(rhsRow), rhsRow, 1);
+			}
+
+			const __m256 rows01 = _mm256_loadu_ps(&a._11);
+			const __m256 rows23 = _mm256_loadu_ps(&a._31);
+
+			XMFLOAT4X4& product = products[i];
+			_mm256_storeu_ps(&product._11, MultiplyRowsAVX2(rows01, rhsRows));
+			_mm256_storeu_ps(&product._31, MultiplyRowsAVX2(rows23, rhsRows));
+		}
+
+		_mm256_zeroupper();
+	}
+
+	LIBRARY_TARGET_AVX2 void TransformKernels::WorldViewProjectionAVX2(const ConstMatrixArray& worlds, const XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, size_t first, size_t last)
+	{
+		__m256 rhsRows[4];
+		for (size_t row = 0; row < 4; ++row)
+		{
+			const __m128 rhsRow = _mm_loadu_ps(viewProjection.m[row]);
+			rhsRows[row] = _mm256_insertf128_ps(_mm256_castps128_ps256(rhsRow), rhsRow, 1);
+		}
+
+		for (size_t i = first; i < last; ++i)
+		{
+			const XMFLOAT4X4& world = worlds[i];
+			__m256 rows[2] = { _mm256_loadu_ps(&world._11), _mm256_loadu_ps(&world._31) };
+			__m256 products[2] = { MultiplyRowsAVX2(rows[0], rhsRows), MultiplyRowsAVX2(rows[1], rhsRows) };
+			TransposeMatrixAVX2(rows);
+			TransposeMatrixAVX2(products);
+
+			XMFLOAT4X4& transposedWorld = transposedWorlds[i];
+			XMFLOAT4X4& transposedWorldViewProjection = transposedWorldViewProjections[i];
+			_mm256_storeu_ps(&transposedWorld._11, rows[0]);
+			_mm256_storeu_ps(&transposedWorld._31, rows[1]);
+			_mm256_storeu_ps(&transposedWorldViewProjection._11, products[0]);
+			_mm256_storeu_ps(&transposedWorldViewProjection._31, products[1]);
+		}
+
+		_mm256_zeroupper();
+	}
+
+	LIBRARY_TARGET_AVX2 void TransformKernels::TransposeAVX2(const ConstMatrixArray& matrices, const MatrixArray& transposed, size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			const XMFLOAT4X4& matrix = matrices[i];
+			__m256 rows[2] = { _mm256_loadu_ps(&matrix._11), _mm256_loadu_ps(&matrix._31) };
+			TransposeMatrixAVX2(rows);
+
+			XMFLOAT4X4& transposedMatrix = transposed[i];
+			_mm256_storeu_ps(&transposedMatrix._11, rows[0]);
+			_mm256_storeu_ps(&transposedMatrix._31, rows[1]);
+		}
+
+		_mm256_zeroupper();
+	}
+
+#pragma endregion
+
+#if defined(LIBRARY_AVX512_INTRINSICS)
+#pragma region AVX-512
+
+	LIBRARY_TARGET_AVX512 LIBRARY_FORCEINLINE void TransformKernels::TransposeLanesAVX512(__m512* rows)
+	{
+		// A 4x4 transpose within each 128-bit quarter.
+		const __m512 low01 = _mm512_unpacklo_ps(rows[0], rows[1]);
+		const __m512 high01 = _mm512_unpackhi_ps(rows[0], rows[1]);
+		const __m512 low23 = _mm512_unpacklo_ps(rows[2], rows[3]);
+		const __m512 high23 = _mm512_unpackhi_ps(rows[2], rows[3]);
+
+		rows[0] = _mm512_shuffle_ps(low01, low23, _MM_SHUFFLE(1, 0, 1, 0));
+		rows[1] = _mm512_shuffle_ps(low01, low23, _MM_SHUFFLE(3, 2, 3, 2));
+		rows[2] = _mm512_shuffle_ps(high01, high23, _MM_SHUFFLE(1, 0, 1, 0));
+		rows[3] = _mm512_shuffle_ps(high01, high23, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+
+	LIBRARY_TARGET_AVX512 LIBRARY_FORCEINLINE void TransformKernels::StoreRowAVX512(const MatrixArray& matrices, size_t first, size_t row, const __m512* elements)
+	{
+		__m512 rows[4] = { elements[0], elements[1], elements[2], elements[3] };
+		TransposeLanesAVX512(rows);
+
+		for (size_t k = 0; k < 4; ++k)
+		{
+			_mm_storeu_ps(matrices[first + k].m[row], _mm512_castps512_ps128(rows[k]));
+			_mm_storeu_ps(matrices[first + 4 + k].m[row], _mm512_extractf32x4_ps(rows[k], 1));
+			_mm_storeu_ps(matrices[first + 8 + k].m[row], _mm512_extractf32x4_ps(rows[k], 2));
+			_mm_storeu_ps(matrices[first + 12 + k].m[row], _mm512_extractf32x4_ps(rows[k], 3));
+		}
+	}
+
+	LIBRARY_TARGET_AVX512 LIBRARY_FORCEINLINE __m512 TransformKernels::MultiplyMatrixAVX512(__m512 matrix, const __m512* rhs)
+	{
+		// A whole left-hand matrix, one row per quarter, with every row of rhs in each quarter.
+		const __m512 x = _mm512_permute_ps(matrix, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m512 y = _mm512_permute_ps(matrix, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m512 z = _mm512_permute_ps(matrix, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m512 w = _mm512_permute_ps(matrix, _MM_SHUFFLE(3, 3, 3, 3));
+
+		return _mm512_add_ps(_mm512_fmadd_ps(z, rhs[2], _mm512_mul_ps(x, rhs[0])), _mm512_fmadd_ps(w, rhs[3], _mm512_mul_ps(y, rhs[1])));
+	}
+
+	LIBRARY_TARGET_AVX512 void TransformKernels::ComposeTrsAVX512(const TrsArrays& trs, const MatrixArray& matrices, size_t first, size_t last)
+	{
+		const __m512 zero = _mm512_setzero_ps();
+		const __m512 one = _mm512_set1_ps(1.0f);
+
+		for (size_t i = first; i < last; i += AVX512Width)
+		{
+			const __m512 x = _mm512_loadu_ps(trs.RotationX + i);
+			const __m512 y = _mm512_loadu_ps(trs.RotationY + i);
+			const __m512 z = _mm512_loadu_ps(trs.RotationZ + i);
+			const __m512 w = _mm512_loadu_ps(trs.RotationW + i);
+			const __m512 x2 = _mm512_add_ps(x, x);
+			const __m512 y2 = _mm512_add_ps(y, y);
+			const __m512 z2 = _mm512_add_ps(z, z);
+
+			const __m512 xx = _mm512_mul_ps(x, x2);
+			const __m512 yy = _mm512_mul_ps(y, y2);
+			const __m512 zz = _mm512_mul_ps(z, z2);
+			const __m512 xy = _mm512_mul_ps(x, y2);
+			const __m512 xz = _mm512_mul_ps(x, z2);
+			const __m512 yz = _mm512_mul_ps(y, z2);
+			const __m512 wx = _mm512_mul_ps(w, x2);
+			const __m512 wy = _mm512_mul_ps(w, y2);
+			const __m512 wz = _mm512_mul_ps(w, z2);
+
+			const __m512 scaleX = _mm512_loadu_ps(trs.ScaleX + i);
+			const __m512 scaleY = _mm512_loadu_ps(trs.ScaleY + i);
+			const __m512 scaleZ = _mm512_loadu_ps(trs.ScaleZ + i);
+
+			const __m512 row0[4] = { _mm512_mul_ps(_mm512_sub_ps(_mm512_sub_ps(one, yy), zz), scaleX), _mm512_mul_ps(_mm512_add_ps(xy, wz), scaleX), _mm512_mul_ps(_mm512_sub_ps(xz, wy), scaleX), zero };
+			const __m512 row1[4] = { _mm512_mul_ps(_mm512_sub_ps(xy, wz), scaleY), _mm512_mul_ps(_mm512_sub_ps(_mm512_sub_ps(one, xx), zz), scaleY), _mm512_mul_ps(_mm512_add_ps(yz, wx), scaleY), zero };
+			const __m512 row2[4] = { _mm512_mul_ps(_mm512_add_ps(xz, wy), scaleZ), _mm512_mul_ps(_mm512_sub_ps(yz, wx), scaleZ), _mm512_mul_ps(_mm512_sub_ps(_mm512_sub_ps(one, xx), yy), scaleZ), zero };
+			const __m512 row3[4] = { _mm512_loadu_ps(trs.TranslationX + i), _mm512_loadu_ps(trs.TranslationY + i), _mm512_loadu_ps(trs.TranslationZ + i), one };
+
+			StoreRowAVX512(matrices, i, 0, row0);
+			StoreRowAVX512(matrices, i, 1, row1);
+			StoreRowAVX512(matrices, i, 2, row2);
+			StoreRowAVX512(matrices, i, 3, row3);
+		}
+
+		_mm256_zeroupper();
+	}
+
+	LIBRARY_TARGET_AVX512 void TransformKernels::MultiplyAVX512(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			const XMFLOAT4X4& b = rhs[i];
+			const __m512 rhsRows[4] = { _mm512_broadcast_f32x4(_mm_loadu_ps(b.m[0])), _mm512_broadcast_f32x4(_mm_loadu_ps(b.m[1])), _mm512_broadcast_f32x4(_mm_loadu_ps(b.m[2])), _mm512_broadcast_f32x4(_mm_loadu_ps(b.m[3])) };
+			const __m512 matrix = _mm512_loadu_ps(&lhs[i]._11);
+
+			_mm512_storeu_ps(&products[i]._11, MultiplyMatrixAVX512(matrix, rhsRows));
+		}
+
+		_mm256_zeroupper();
+	}
+
+	LIBRARY_TARGET_AVX512 void TransformKernels::WorldViewProjectionAVX512(const ConstMatrixArray& worlds, const XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, size_t first, size_t last)
+	{
+		const __m512 rhsRows[4] = { _mm512_broadcast_f32x4(_mm_loadu_ps(viewProjection.m[0])), _mm512_broadcast_f32x4(_mm_loadu_ps(viewProjection.m[1])), _mm512_broadcast_f32x4(_mm_loadu_ps(viewProjection.m[2])), _mm512_broadcast_f32x4(_mm_loadu_ps(viewProjection.m[3])) };
+		const __m512i columns = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+		for (size_t i = first; i < last; ++i)
+		{
+			const __m512 world = _mm512_loadu_ps(&worlds[i]._11);
+			const __m512 product = MultiplyMatrixAVX512(world, rhsRows);
+
+			_mm512_storeu_ps(&transposedWorlds[i]._11, _mm512_permutexvar_ps(columns, world));
+			_mm512_storeu_ps(&transposedWorldViewProjections[i]._11, _mm512_permutexvar_ps(columns, product));
+		}
+
+		_mm256_zeroupper();
+	}
+
+	LIBRARY_TARGET_AVX512 void TransformKernels::TransposeAVX512(const ConstMatrixArray& matrices, const MatrixArray& transposed, size_t first, size_t last)
+	{
+		const __m512i columns = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+		for (size_t i = first; i < last; ++i)
+		{
+			_mm512_storeu_ps(&transposed[i]._11, _mm512_permutexvar_ps(columns, _mm512_loadu_ps(&matrices[i]._11)));
+		}
+
+		_mm256_zeroupper();
+	}
+
+#pragma endregion
+#endif
+
+	TransformKernels::InstructionSet TransformKernels::DetectInstructionSet()
+	{
+#if defined(_MSC_VER)
+		// AVX2 and AVX-512 need both the CPU features and the operating system saving the wider registers (OSXSAVE + XCR0:
+		// bits 1 and 2 for YMM, bits 5 to 7 for the AVX-512 state).
+		int cpuInfo[4];
+		__cpuid(cpuInfo, 0);
+		const int maxLeaf = cpuInfo[0];
+
+		__cpuid(cpuInfo, 1);
+		const bool osxsave = ((cpuInfo[2] & (1 << 27)) != 0);
+		const bool avx = ((cpuInfo[2] & (1 << 28)) != 0);
+		const bool fma = ((cpuInfo[2] & (1 << 12)) != 0);
+		if (maxLeaf < 7 || osxsave == false || avx == false || fma == false)
+		{
+			return InstructionSet::SSE;
+		}
+
+		const unsigned long long xcr0 = _xgetbv(0);
+		if ((xcr0 & 0x6) != 0x6)
+		{
+			return InstructionSet::SSE;
+		}
+
+		__cpuidex(cpuInfo, 7, 0);
+		const bool avx2 = ((cpuInfo[1] & (1 << 5)) != 0);
+		const bool avx512 = ((cpuInfo[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6);
+#else
+		const bool avx2 = (__builtin_cpu_supports("avx2") != 0 && __builtin_cpu_supports("fma") != 0);
+		const bool avx512 = (avx2 && __builtin_cpu_supports("avx512f") != 0);
+#endif
+
+#if defined(LIBRARY_AVX512_INTRINSICS)
+		if (avx512)
+		{
+			return InstructionSet::AVX512;
+		}
+#else
+		UNREFERENCED_PARAMETER(avx512);
+#endif
+
+		return (avx2 ? InstructionSet::AVX2 : InstructionSet::SSE);
+	}
+}
\ No newline at end of file
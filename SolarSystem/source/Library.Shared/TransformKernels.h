@@ -0,0 +1,424 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <immintrin.h>
+#include <cstddef>
+
+// Visual C++ has the AVX-512 intrinsics from Visual Studio 2017 version 15.3 on; older compilers build without that path.
+#if !defined(_MSC_VER) || defined(__clang__) || _MSC_VER >= 1911
+#define LIBRARY_AVX512_INTRINSICS
+#endif
+
+// The row loads and stores must inline into the kernels, or every vector goes through memory between them.
+#if defined(_MSC_VER)
+#define LIBRARY_FORCEINLINE __forceinline
+#else
+#define LIBRARY_FORCEINLINE inline __attribute__((always_inline))
+#endif
+
+namespace Library
+{
+	// Matrices Stride bytes apart, so a kernel can write one matrix member of an array of structures in place.
+	struct MatrixArray
+	{
+		DirectX::XMFLOAT4X4* Data;
+		std::size_t Stride;
+
+		MatrixArray(DirectX::XMFLOAT4X4* data, std::size_t stride = sizeof(DirectX::XMFLOAT4X4)) :
+			Data(data), Stride(stride) { }
+
+		DirectX::XMFLOAT4X4& operator[](std::size_t index) const
+		{
+			return *reinterpret_cast<DirectX::XMFLOAT4X4*>(reinterpret_cast<unsigned char*>(Data) + index * Stride);
+		}
+	};
+
+	// Matrices Stride bytes apart for a kernel to read. A Stride of 0 gives every object the same matrix.
+	struct ConstMatrixArray
+	{
+		const DirectX::XMFLOAT4X4* Data;
+		std::size_t Stride;
+
+		ConstMatrixArray(const DirectX::XMFLOAT4X4* data, std::size_t stride = sizeof(DirectX::XMFLOAT4X4)) :
+			Data(data), Stride(stride) { }
+
+		ConstMatrixArray(const MatrixArray& matrices) :
+			Data(matrices.Data), Stride(matrices.Stride) { }
+
+		const DirectX::XMFLOAT4X4& operator[](std::size_t index) const
+		{
+			return *reinterpret_cast<const DirectX::XMFLOAT4X4*>(reinterpret_cast<const unsigned char*>(Data) + index * Stride);
+		}
+	};
+
+	// Scale, rotation (a unit quaternion) and translation for a batch of objects, one array per component.
+	struct TrsArrays
+	{
+		const float* ScaleX;
+		const float* ScaleY;
+		const float* ScaleZ;
+		const float* RotationX;
+		const float* RotationY;
+		const float* RotationZ;
+		const float* RotationW;
+		const float* TranslationX;
+		const float* TranslationY;
+		const float* TranslationZ;
+	};
+
+	// Builds and multiplies the matrices of many objects per call. ComposeTrs() works on 4, 8 or 16 objects at once, one object
+	// per SIMD lane, reading the structure-of-arrays input directly and transposing each row across the lanes on store. The
+	// matrix products keep the matrices' own layout and do one row per 128 bits, as DirectXMath does, so AVX2 does half a
+	// matrix per instruction and AVX-512 a whole one. Either way every object gets DirectXMath's arithmetic in DirectXMath's
+	// order: the scalar and SSE kernels round as its SSE path does, and the AVX2 and AVX-512 kernels fuse multiplies and adds
+	// as DirectXMath does when built for AVX2.
+	// The scalar and SSE kernels are inline, since every x86-64 processor has SSE2. The fixed-size overloads use them without
+	// dispatch, so a small batch whose size is known at compile time becomes straight-line code.
+	class TransformKernels final
+	{
+	public:
+		enum class InstructionSet
+		{
+			Scalar,
+			SSE,
+			AVX2,
+			AVX512
+		};
+
+		// matrices[i] = XMMatrixScaling(scale) * XMMatrixRotationQuaternion(rotation) * XMMatrixTranslation(translation)
+		static void ComposeTrs(const TrsArrays& trs, const MatrixArray& matrices, std::size_t count);
+		static void ComposeTrs(const TrsArrays& trs, const MatrixArray& matrices, std::size_t count, InstructionSet instructionSet);
+
+		// products[i] = lhs[i] * rhs[i]. products may be the same array as lhs or rhs.
+		static void Multiply(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, std::size_t count);
+		static void Multiply(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, std::size_t count, InstructionSet instructionSet);
+
+		// The transposed world and world-view-projection matrices a vertex shader's constant buffer takes. Faster than a transpose
+		// and a multiply per object with AVX2 or AVX-512, which transpose a matrix in two or one permute; the SSE kernel only
+		// matches them.
+		static void WorldViewProjection(const ConstMatrixArray& worlds, const DirectX::XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, std::size_t count);
+		static void WorldViewProjection(const ConstMatrixArray& worlds, const DirectX::XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, std::size_t count, InstructionSet instructionSet);
+
+		// transposed may be the same array as matrices.
+		static void Transpose(const ConstMatrixArray& matrices, const MatrixArray& transposed, std::size_t count);
+		static void Transpose(const ConstMatrixArray& matrices, const MatrixArray& transposed, std::size_t count, InstructionSet instructionSet);
+
+		template <std::size_t Count>
+		static void ComposeTrs(const TrsArrays& trs, const MatrixArray& matrices);
+
+		template <std::size_t Count>
+		static void Multiply(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products);
+
+		template <std::size_t Count>
+		static void WorldViewProjection(const ConstMatrixArray& worlds, const DirectX::XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections);
+
+		template <std::size_t Count>
+		static void Transpose(const ConstMatrixArray& matrices, const MatrixArray& transposed);
+
+		// The widest instruction set both the processor and this build support.
+		static InstructionSet BestInstructionSet();
+		static const char* InstructionSetName(InstructionSet instructionSet);
+
+		TransformKernels() = delete;
+		TransformKernels(const TransformKernels&) = delete;
+		TransformKernels& operator=(const TransformKernels&) = delete;
+		TransformKernels(TransformKernels&&) = delete;
+		TransformKernels& operator=(TransformKernels&&) = delete;
+		~TransformKernels() = default;
+
+	private:
+		static const std::size_t SSEWidth = 4;
+		static const std::size_t AVX2Width = 8;
+		static const std::size_t AVX512Width = 16;
+
+		// Each kernel handles objects [first, last). The ComposeTrs() SIMD kernels take one object per lane, so last - first
+		// must be a multiple of their width; the others take one object at a time.
+		static void ComposeTrsScalar(const TrsArrays& trs, const MatrixArray& matrices, std::size_t first, std::size_t last);
+		static void MultiplyScalar(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, std::size_t first, std::size_t last);
+		static void WorldViewProjectionScalar(const ConstMatrixArray& worlds, const DirectX::XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, std::size_t first, std::size_t last);
+		static void TransposeScalar(const ConstMatrixArray& matrices, const MatrixArray& transposed, std::size_t first, std::size_t last);
+
+		// Stores row row of the matrices first onwards from one vector per element, holding one matrix per lane.
+		static void StoreRowSSE(const MatrixArray& matrices, std::size_t first, std::size_t row, const __m128* elements);
+		static __m128 MultiplyRowSSE(__m128 row, const __m128* rhs);
+		static void ComposeTrsSSE(const TrsArrays& trs, const MatrixArray& matrices, std::size_t first, std::size_t last);
+		static void MultiplySSE(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, std::size_t first, std::size_t last);
+		static void WorldViewProjectionSSE(const ConstMatrixArray& worlds, const DirectX::XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, std::size_t first, std::size_t last);
+		static void TransposeSSE(const ConstMatrixArray& matrices, const MatrixArray& transposed, std::size_t first, std::size_t last);
+
+		static void StoreRowAVX2(const MatrixArray& matrices, std::size_t first, std::size_t row, const __m256* elements);
+		static void TransposeLanesAVX2(__m256* rows);
+		static __m256 MultiplyRowsAVX2(__m256 rows, const __m256* rhs);
+		static void TransposeMatrixAVX2(__m256* rows);
+		static void ComposeTrsAVX2(const TrsArrays& trs, const MatrixArray& matrices, std::size_t first, std::size_t last);
+		static void MultiplyAVX2(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, std::size_t first, std::size_t last);
+		static void WorldViewProjectionAVX2(const ConstMatrixArray& worlds, const DirectX::XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, std::size_t first, std::size_t last);
+		static void TransposeAVX2(const ConstMatrixArray& matrices, const MatrixArray& transposed, std::size_t first, std::size_t last);
+
+#if defined(LIBRARY_AVX512_INTRINSICS)
+		static void TransposeLanesAVX512(__m512* rows);
+		static void StoreRowAVX512(const MatrixArray& matrices, std::size_t first, std::size_t row, const __m512* elements);
+		static __m512 MultiplyMatrixAVX512(__m512 matrix, const __m512* rhs);
+		static void ComposeTrsAVX512(const TrsArrays& trs, const MatrixArray& matrices, std::size_t first, std::size_t last);
+		static void MultiplyAVX512(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, std::size_t first, std::size_t last);
+		static void WorldViewProjectionAVX512(const ConstMatrixArray& worlds, const DirectX::XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, std::size_t first, std::size_t last);
+		static void TransposeAVX512(const ConstMatrixArray& matrices, const MatrixArray& transposed, std::size_t first, std::size_t last);
+#endif
+
+		static InstructionSet DetectInstructionSet();
+	};
+
+	template <std::size_t Count>
+	inline void TransformKernels::ComposeTrs(const TrsArrays& trs, const MatrixArray& matrices)
+	{
+		static_assert(Count > 0, "A fixed-size batch needs at least one object.");
+
+		ComposeTrsSSE(trs, matrices, 0, Count - Count % SSEWidth);
+		ComposeTrsScalar(trs, matrices, Count - Count % SSEWidth, Count);
+	}
+
+	template <std::size_t Count>
+	inline void TransformKernels::Multiply(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products)
+	{
+		static_assert(Count > 0, "A fixed-size batch needs at least one object.");
+
+		MultiplySSE(lhs, rhs, products, 0, Count);
+	}
+
+	template <std::size_t Count>
+	inline void TransformKernels::WorldViewProjection(const ConstMatrixArray& worlds, const DirectX::XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections)
+	{
+		static_assert(Count > 0, "A fixed-size batch needs at least one object.");
+
+		WorldViewProjectionSSE(worlds, viewProjection, transposedWorlds, transposedWorldViewProjections, 0, Count);
+	}
+
+	template <std::size_t Count>
+	inline void TransformKernels::Transpose(const ConstMatrixArray& matrices, const MatrixArray& transposed)
+	{
+		static_assert(Count > 0, "A fixed-size batch needs at least one object.");
+
+		TransposeSSE(matrices, transposed, 0, Count);
+	}
+
+	inline void TransformKernels::ComposeTrsScalar(const TrsArrays& trs, const MatrixArray& matrices, std::size_t first, std::size_t last)
+	{
+		for (std::size_t i = first; i < last; ++i)
+		{
+			const float x = trs.RotationX[i];
+			const float y = trs.RotationY[i];
+			const float z = trs.RotationZ[i];
+			const float w = trs.RotationW[i];
+			const float x2 = x + x;
+			const float y2 = y + y;
+			const float z2 = z + z;
+
+			const float xx = x * x2;
+			const float yy = y * y2;
+			const float zz = z * z2;
+			const float xy = x * y2;
+			const float xz = x * z2;
+			const float yz = y * z2;
+			const float wx = w * x2;
+			const float wy = w * y2;
+			const float wz = w * z2;
+
+			const float scaleX = trs.ScaleX[i];
+			const float scaleY = trs.ScaleY[i];
+			const float scaleZ = trs.ScaleZ[i];
+
+			DirectX::XMFLOAT4X4& matrix = matrices[i];
+			matrix._11 = ((1.0f - yy) - zz) * scaleX;
+			matrix._12 = (xy + wz) * scaleX;
+			matrix._13 = (xz - wy) * scaleX;
+			matrix._14 = 0.0f;
+			matrix._21 = (xy - wz) * scaleY;
+			matrix._22 = ((1.0f - xx) - zz) * scaleY;
+			matrix._23 = (yz + wx) * scaleY;
+			matrix._24 = 0.0f;
+			matrix._31 = (xz + wy) * scaleZ;
+			matrix._32 = (yz - wx) * scaleZ;
+			matrix._33 = ((1.0f - xx) - yy) * scaleZ;
+			matrix._34 = 0.0f;
+			matrix._41 = trs.TranslationX[i];
+			matrix._42 = trs.TranslationY[i];
+			matrix._43 = trs.TranslationZ[i];
+			matrix._44 = 1.0f;
+		}
+	}
+
+	inline void TransformKernels::MultiplyScalar(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, std::size_t first, std::size_t last)
+	{
+		for (std::size_t i = first; i < last; ++i)
+		{
+			const DirectX::XMFLOAT4X4 a = lhs[i];
+			const DirectX::XMFLOAT4X4 b = rhs[i];
+
+			DirectX::XMFLOAT4X4& product = products[i];
+			for (std::size_t row = 0; row < 4; ++row)
+			{
+				for (std::size_t column = 0; column < 4; ++column)
+				{
+					product.m[row][column] = (a.m[row][0] * b.m[0][column] + a.m[row][2] * b.m[2][column]) + (a.m[row][1] * b.m[1][column] + a.m[row][3] * b.m[3][column]);
+				}
+			}
+		}
+	}
+
+	inline void TransformKernels::WorldViewProjectionScalar(const ConstMatrixArray& worlds, const DirectX::XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, std::size_t first, std::size_t last)
+	{
+		const DirectX::XMFLOAT4X4& b = viewProjection;
+		for (std::size_t i = first; i < last; ++i)
+		{
+			const DirectX::XMFLOAT4X4 a = worlds[i];
+
+			DirectX::XMFLOAT4X4& transposedWorld = transposedWorlds[i];
+			DirectX::XMFLOAT4X4& transposedWorldViewProjection = transposedWorldViewProjections[i];
+			for (std::size_t row = 0; row < 4; ++row)
+			{
+				for (std::size_t column = 0; column < 4; ++column)
+				{
+					transposedWorld.m[column][row] = a.m[row][column];
+					transposedWorldViewProjection.m[column][row] = (a.m[row][0] * b.m[0][column] + a.m[row][2] * b.m[2][column]) + (a.m[row][1] * b.m[1][column] + a.m[row][3] * b.m[3][column]);
+				}
+			}
+		}
+	}
+
+	inline void TransformKernels::TransposeScalar(const ConstMatrixArray& matrices, const MatrixArray& transposed, std::size_t first, std::size_t last)
+	{
+		for (std::size_t i = first; i < last; ++i)
+		{
+			const DirectX::XMFLOAT4X4 matrix = matrices[i];
+
+			DirectX::XMFLOAT4X4& transposedMatrix = transposed[i];
+			for (std::size_t row = 0; row < 4; ++row)
+			{
+				for (std::size_t column = 0; column < 4; ++column)
+				{
+					transposedMatrix.m[column][row] = matrix.m[row][column];
+				}
+			}
+		}
+	}
+
+	LIBRARY_FORCEINLINE void TransformKernels::StoreRowSSE(const MatrixArray& matrices, std::size_t first, std::size_t row, const __m128* elements)
+	{
+		__m128 rows[4] = { elements[0], elements[1], elements[2], elements[3] };
+		_MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+
+		_mm_storeu_ps(matrices[first].m[row], rows[0]);
+		_mm_storeu_ps(matrices[first + 1].m[row], rows[1]);
+		_mm_storeu_ps(matrices[first + 2].m[row], rows[2]);
+		_mm_storeu_ps(matrices[first + 3].m[row], rows[3]);
+	}
+
+	LIBRARY_FORCEINLINE __m128 TransformKernels::MultiplyRowSSE(__m128 row, const __m128* rhs)
+	{
+		const __m128 x = _mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 y = _mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 z = _mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m128 w = _mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3));
+
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, rhs[0]), _mm_mul_ps(z, rhs[2])), _mm_add_ps(_mm_mul_ps(y, rhs[1]), _mm_mul_ps(w, rhs[3])));
+	}
+
+	inline void TransformKernels::ComposeTrsSSE(const TrsArrays& trs, const MatrixArray& matrices, std::size_t first, std::size_t last)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		for (std::size_t i = first; i < last; i += SSEWidth)
+		{
+			const __m128 x = _mm_loadu_ps(trs.RotationX + i);
+			const __m128 y = _mm_loadu_ps(trs.RotationY + i);
+			const __m128 z = _mm_loadu_ps(trs.RotationZ + i);
+			const __m128 w = _mm_loadu_ps(trs.RotationW + i);
+			const __m128 x2 = _mm_add_ps(x, x);
+			const __m128 y2 = _mm_add_ps(y, y);
+			const __m128 z2 = _mm_add_ps(z, z);
+
+			const __m128 xx = _mm_mul_ps(x, x2);
+			const __m128 yy = _mm_mul_ps(y, y2);
+			const __m128 zz = _mm_mul_ps(z, z2);
+			const __m128 xy = _mm_mul_ps(x, y2);
+			const __m128 xz = _mm_mul_ps(x, z2);
+			const __m128 yz = _mm_mul_ps(y, z2);
+			const __m128 wx = _mm_mul_ps(w, x2);
+			const __m128 wy = _mm_mul_ps(w, y2);
+			const __m128 wz = _mm_mul_ps(w, z2);
+
+			const __m128 scaleX = _mm_loadu_ps(trs.ScaleX + i);
+			const __m128 scaleY = _mm_loadu_ps(trs.ScaleY + i);
+			const __m128 scaleZ = _mm_loadu_ps(trs.ScaleZ + i);
+
+			const __m128 row0[4] = { _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, yy), zz), scaleX), _mm_mul_ps(_mm_add_ps(xy, wz), scaleX), _mm_mul_ps(_mm_sub_ps(xz, wy), scaleX), zero };
+			const __m128 row1[4] = { _mm_mul_ps(_mm_sub_ps(xy, wz), scaleY), _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, xx), zz), scaleY), _mm_mul_ps(_mm_add_ps(yz, wx), scaleY), zero };
+			const __m128 row2[4] = { _mm_mul_ps(_mm_add_ps(xz, wy), scaleZ), _mm_mul_ps(_mm_sub_ps(yz, wx), scaleZ), _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, xx), yy), scaleZ), zero };
+			const __m128 row3[4] = { _mm_loadu_ps(trs.TranslationX + i), _mm_loadu_ps(trs.TranslationY + i), _mm_loadu_ps(trs.TranslationZ + i), one };
+
+			StoreRowSSE(matrices, i, 0, row0);
+			StoreRowSSE(matrices, i, 1, row1);
+			StoreRowSSE(matrices, i, 2, row2);
+			StoreRowSSE(matrices, i, 3, row3);
+		}
+	}
+
+	inline void TransformKernels::MultiplySSE(const ConstMatrixArray& lhs, const ConstMatrixArray& rhs, const MatrixArray& products, std::size_t first, std::size_t last)
+	{
+		for (std::size_t i = first; i < last; ++i)
+		{
+			const DirectX::XMFLOAT4X4& a = lhs[i];
+			const DirectX::XMFLOAT4X4& b = rhs[i];
+			const __m128 rhsRows[4] = { _mm_loadu_ps(b.m[0]), _mm_loadu_ps(b.m[1]), _mm_loadu_ps(b.m[2]), _mm_loadu_ps(b.m[3]) };
+			const __m128 lhsRows[4] = { _mm_loadu_ps(a.m[0]), _mm_loadu_ps(a.m[1]), _mm_loadu_ps(a.m[2]), _mm_loadu_ps(a.m[3]) };
+
+			DirectX::XMFLOAT4X4& product = products[i];
+			for (std::size_t row = 0; row < 4; ++row)
+			{
+				_mm_storeu_ps(product.m[row], MultiplyRowSSE(lhsRows[row], rhsRows));
+			}
+		}
+	}
+
+	inline void TransformKernels::WorldViewProjectionSSE(const ConstMatrixArray& worlds, const DirectX::XMFLOAT4X4& viewProjection, const MatrixArray& transposedWorlds, const MatrixArray& transposedWorldViewProjections, std::size_t first, std::size_t last)
+	{
+		const __m128 rhsRows[4] = { _mm_loadu_ps(viewProjection.m[0]), _mm_loadu_ps(viewProjection.m[1]), _mm_loadu_ps(viewProjection.m[2]), _mm_loadu_ps(viewProjection.m[3]) };
+
+		for (std::size_t i = first; i < last; ++i)
+		{
+			const DirectX::XMFLOAT4X4& world = worlds[i];
+			__m128 rows[4] = { _mm_loadu_ps(world.m[0]), _mm_loadu_ps(world.m[1]), _mm_loadu_ps(world.m[2]), _mm_loadu_ps(world.m[3]) };
+			__m128 products[4] = { MultiplyRowSSE(rows[0], rhsRows), MultiplyRowSSE(rows[1], rhsRows), MultiplyRowSSE(rows[2], rhsRows), MultiplyRowSSE(rows[3], rhsRows) };
+			_MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+			_MM_TRANSPOSE4_PS(products[0], products[1], products[2], products[3]);
+
+			DirectX::XMFLOAT4X4& transposedWorld = transposedWorlds[i];
+			DirectX::XMFLOAT4X4& transposedWorldViewProjection = transposedWorldViewProjections[i];
+			for (std::size_t row = 0; row < 4; ++row)
+			{
+				_mm_storeu_ps(transposedWorld.m[row], rows[row]);
+				_mm_storeu_ps(transposedWorldViewProjection.m[row], products[row]);
+			}
+		}
+	}
+
+	inline void TransformKernels::TransposeSSE(const ConstMatrixArray& matrices, const MatrixArray& transposed, std::size_t first, std::size_t last)
+	{
+		for (std::size_t i = first; i < last; ++i)
+		{
+			const DirectX::XMFLOAT4X4& matrix = matrices[i];
+			__m128 row0 = _mm_loadu_ps(matrix.m[0]);
+			__m128 row1 = _mm_loadu_ps(matrix.m[1]);
+			__m128 row2 = _mm_loadu_ps(matrix.m[2]);
+			__m128 row3 = _mm_loadu_ps(matrix.m[3]);
+			_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+			DirectX::XMFLOAT4X4& transposedMatrix = transposed[i];
+			_mm_storeu_ps(transposedMatrix.m[0], row0);
+			_mm_storeu_ps(transposedMatrix.m[1], row1);
+			_mm_storeu_ps(transposedMatrix.m[2], row2);
+			_mm_storeu_ps(transposedMatrix.m[3], row3);
+		}
+	}
+}
\ No newline at end of file
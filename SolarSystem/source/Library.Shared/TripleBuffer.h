@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Library
+{
+	// Hands whole values from one producer thread to one consumer thread without locks or copies. The producer fills
+	// WriteBuffer() and publishes it; the consumer acquires the most recently published value and reads it until its next
+	// Acquire(). Each side always owns one of the three slots and the third is swapped between them, so neither side ever
+	// waits for the other, and a value the consumer skipped is simply overwritten.
+	template <typename T>
+	class TripleBuffer final
+	{
+	public:
+		TripleBuffer() :
+			mSlots(), mWriteIndex(0), mMiddle(1), mReadIndex(2)
+		{
+		}
+
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+		TripleBuffer(TripleBuffer&&) = delete;
+		TripleBuffer& operator=(TripleBuffer&&) = delete;
+		~TripleBuffer() = default;
+
+		// Producer only. The slot's contents are whatever was published two or more values ago.
+		T& WriteBuffer()
+		{
+			return mSlots[mWriteIndex];
+		}
+
+		// Producer only. Makes the write buffer the newest value and hands the producer a free slot.
+		void Publish()
+		{
+			const std::uint32_t previous = mMiddle.exchange(mWriteIndex | FreshBit, std::memory_order_acq_rel);
+			mWriteIndex = previous & IndexMask;
+		}
+
+		// Consumer only. Returns false, keeping the current read buffer, when nothing has been published since the last call.
+		bool Acquire()
+		{
+			if ((mMiddle.load(std::memory_order_relaxed) & FreshBit) == 0)
+			{
+				return false;
+			}
+
+			const std::uint32_t previous = mMiddle.exchange(mReadIndex, std::memory_order_acq_rel);
+			mReadIndex = previous & IndexMask;
+
+			return true;
+		}
+
+		// Consumer only.
+		const T& ReadBuffer() const
+		{
+			return mSlots[mReadIndex];
+		}
+
+		// Either side; true when a published value is waiting to be acquired.
+		bool HasFreshValue() const
+		{
+			return (mMiddle.load(std::memory_order_acquire) & FreshBit) != 0;
+		}
+
+	private:
+		static const std::uint32_t FreshBit = 4;
+		static const std::uint32_t IndexMask = 3;
+
+		T mSlots[3];
+		std::uint32_t mWriteIndex;
+		std::atomic<std::uint32_t> mMiddle;
+		std::uint32_t mReadIndex;
+	};
+}
\ No newline at end of file
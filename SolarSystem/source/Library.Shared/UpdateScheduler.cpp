@@ -0,0 +1,250 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace DirectX;
+
+namespace Library
+{
+	const microseconds UpdateScheduler::DefaultFrameBudget = microseconds(1000);
+	const float UpdateScheduler::DefaultFullRateScreenSize = 8.0f;
+	const uint32_t UpdateScheduler::DefaultMaxUpdatePeriod = 16;
+	const uint32_t UpdateScheduler::BudgetCheckInterval = 8;
+
+	UpdateScheduler::UpdateScheduler(microseconds frameBudget) :
+		mFrameBudget(frameBudget), mFullRateScreenSize(DefaultFullRateScreenSize), mMaxUpdatePeriod(DefaultMaxUpdatePeriod),
+		mFrameIndex(0), mUpdatedCount(0), mDeferredCount(0), mLastUpdateCost(0), mScheduledCount(0), mLastUpdateTime(0), mRebaseUpdateTimes(false)
+	{
+	}
+
+	uint32_t UpdateScheduler::Register(IScheduledUpdatable& updatable)
+	{
+		uint32_t index = static_cast<uint32_t>(mEntries.size());
+
+		// The registration index doubles as the phase, so consecutive entities sharing a period land on different frames.
+		mEntries.emplace_back(updatable, index);
+
+		return index;
+	}
+
+	void UpdateScheduler::Clear()
+	{
+		mEntries.clear();
+		mDeadlines.clear();
+		mScheduledCount = 0;
+		mRebaseUpdateTimes = false;
+	}
+
+	uint32_t UpdateScheduler::Size() const
+	{
+		return static_cast<uint32_t>(mEntries.size());
+	}
+
+	const microseconds& UpdateScheduler::FrameBudget() const
+	{
+		return mFrameBudget;
+	}
+
+	void UpdateScheduler::SetFrameBudget(const microseconds& frameBudget)
+	{
+		mFrameBudget = frameBudget;
+	}
+
+	float& UpdateScheduler::FullRateScreenSize()
+	{
+		return mFullRateScreenSize;
+	}
+
+	uint32_t& UpdateScheduler::MaxUpdatePeriod()
+	{
+		return mMaxUpdatePeriod;
+	}
+
+	uint32_t UpdateScheduler::UpdatePeriod(uint32_t handle) const
+	{
+		return mEntries.at(handle).Period;
+	}
+
+	void UpdateScheduler::Update(const GameTime& gameTime, FXMVECTOR cameraPosition, float projectionScale)
+	{
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		const nanoseconds& currentTime = gameTime.TotalGameTime();
+
+		++mFrameIndex;
+		mUpdatedCount = 0;
+		mDeferredCount = 0;
+
+		if (mRebaseUpdateTimes)
+		{
+			const nanoseconds offset = currentTime - gameTime.ElapsedGameTime() - mLastUpdateTime;
+			for (Entry& entry : mEntries)
+			{
+				entry.LastUpdateTime += offset;
+			}
+
+			mRebaseUpdateTimes = false;
+		}
+
+		// A new entity's first deadline is the first frame, from this one on, that falls on its phase. Its first full update then
+		// covers this frame's time as well, as if it had been updated last frame.
+		for (; mScheduledCount < mEntries.size(); ++mScheduledCount)
+		{
+			Entry& entry = mEntries[mScheduledCount];
+			entry.Period = ComputeUpdatePeriod(entry, cameraPosition, projectionScale);
+			entry.LastUpdateTime = currentTime - gameTime.ElapsedGameTime();
+
+			mDeadlines.emplace_back(NextDeadline(mFrameIndex - 1, entry.Period, entry.Phase), mScheduledCount);
+			push_heap(mDeadlines.begin(), mDeadlines.end(), greater<Deadline>());
+		}
+
+		// Earliest-deadline-first: overdue entities keep their original deadline and therefore win next frame.
+		while (mDeadlines.size() > 0 && mDeadlines.front().Frame <= mFrameIndex)
+		{
+			if (mUpdatedCount > 0 && (mUpdatedCount % BudgetCheckInterval) == 0 &&
+				duration_cast<microseconds>(high_resolution_clock::now() - startTime) >= mFrameBudget)
+			{
+				break;
+			}
+
+			pop_heap(mDeadlines.begin(), mDeadlines.end(), greater<Deadline>());
+			Deadline& deadline = mDeadlines.back();
+			Entry& entry = mEntries[deadline.Index];
+
+			entry.Updatable->ScheduledUpdate(duration<float>(currentTime - entry.LastUpdateTime).count());
+			entry.LastUpdateTime = currentTime;
+			entry.LastUpdateFrame = mFrameIndex;
+			entry.Period = ComputeUpdatePeriod(entry, cameraPosition, projectionScale);
+
+			deadline.Frame = NextDeadline(mFrameIndex, entry.Period, entry.Phase);
+			push_heap(mDeadlines.begin(), mDeadlines.end(), greater<Deadline>());
+			++mUpdatedCount;
+		}
+
+		for (const Deadline& deadline : mDeadlines)
+		{
+			if (deadline.Frame <= mFrameIndex)
+			{
+				++mDeferredCount;
+			}
+		}
+
+		// Registration order guarantees parents are resolved before their children.
+		for (Entry& entry : mEntries)
+		{
+			entry.Updatable->Extrapolate(entry.LastUpdateFrame == mFrameIndex ? 0.0f : duration<float>(currentTime - entry.LastUpdateTime).count());
+		}
+
+		mLastUpdateTime = currentTime;
+		mLastUpdateCost = duration_cast<microseconds>(high_resolution_clock::now() - startTime);
+	}
+
+	float UpdateScheduler::ProjectionScale(CXMMATRIX projectionMatrix, float viewportHeight)
+	{
+		XMFLOAT4X4 projection;
+		XMStoreFloat4x4(&projection, projectionMatrix);
+
+		return projection._22 * viewportHeight * 0.5f;
+	}
+
+	uint64_t UpdateScheduler::FrameIndex() const
+	{
+		return mFrameIndex;
+	}
+
+	uint32_t UpdateScheduler::UpdatedCount() const
+	{
+		return mUpdatedCount;
+	}
+
+	uint32_t UpdateScheduler::DeferredCount() const
+	{
+		return mDeferredCount;
+	}
+
+	const microseconds& UpdateScheduler::LastUpdateCost() const
+	{
+		return mLastUpdateCost;
+	}
+
+	void UpdateScheduler::SaveSnapshot(OutputStreamHelper& streamHelper) const
+	{
+		streamHelper << mFrameIndex << mScheduledCount << static_cast<int64_t>(mLastUpdateTime.count());
+
+		streamHelper << static_cast<uint32_t>(mEntries.size());
+		for (const Entry& entry : mEntries)
+		{
+			streamHelper << entry.Period << entry.LastUpdateFrame << static_cast<int64_t>(entry.LastUpdateTime.count());
+		}
+
+		streamHelper << static_cast<uint32_t>(mDeadlines.size());
+		for (const Deadline& deadline : mDeadlines)
+		{
+			streamHelper << deadline.Frame << deadline.Index;
+		}
+	}
+
+	void UpdateScheduler::LoadSnapshot(InputStreamHelper& streamHelper)
+	{
+		int64_t time;
+		streamHelper >> mFrameIndex >> mScheduledCount >> time;
+		mLastUpdateTime = nanoseconds(time);
+
+		uint32_t entryCount;
+		streamHelper >> entryCount;
+		assert(entryCount == mEntries.size());
+		for (Entry& entry : mEntries)
+		{
+			streamHelper >> entry.Period >> entry.LastUpdateFrame >> time;
+			entry.LastUpdateTime = nanoseconds(time);
+		}
+
+		// The deadlines are stored in heap order.
+		uint32_t deadlineCount;
+		streamHelper >> deadlineCount;
+		mDeadlines.clear();
+		for (uint32_t i = 0; i < deadlineCount; ++i)
+		{
+			uint64_t frame;
+			uint32_t index;
+			streamHelper >> frame >> index;
+			mDeadlines.emplace_back(frame, index);
+		}
+
+		mRebaseUpdateTimes = true;
+	}
+
+	uint32_t UpdateScheduler::ComputeUpdatePeriod(const Entry& entry, FXMVECTOR cameraPosition, float projectionScale) const
+	{
+		XMFLOAT3 position = entry.Updatable->SchedulingPosition();
+		float radius = entry.Updatable->SchedulingRadius();
+		float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&position), cameraPosition)));
+
+		if (distance <= radius)
+		{
+			return 1;
+		}
+
+		float screenSize = radius * projectionScale / distance;
+		if (screenSize >= mFullRateScreenSize)
+		{
+			return 1;
+		}
+
+		// Halve the update rate each time the projected size halves; power-of-two periods keep the phases evenly spread.
+		uint32_t period = 1;
+		while (period < mMaxUpdatePeriod && screenSize * period < mFullRateScreenSize)
+		{
+			period <<= 1;
+		}
+
+		return (period < mMaxUpdatePeriod ? period : mMaxUpdatePeriod);
+	}
+
+	uint64_t UpdateScheduler::NextDeadline(uint64_t frame, uint32_t period, uint32_t phase)
+	{
+		uint64_t nextFrame = frame + 1;
+		uint64_t offset = (phase % period + period - nextFrame % period) % period;
+
+		return nextFrame + offset;
+	}
+}
\ No newline at end of file
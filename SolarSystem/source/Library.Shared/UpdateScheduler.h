@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <DirectXMath.h>
+#include "SnapshotBuffer.h"
+
+namespace Library
+{
+	class GameTime;
+
+	class IScheduledUpdatable
+	{
+	public:
+		virtual ~IScheduledUpdatable() { };
+
+		virtual DirectX::XMFLOAT3 SchedulingPosition() const = 0;
+		virtual float SchedulingRadius() const = 0;
+
+		// Full (expensive) update, called at the entity's scheduled rate with the time since its previous full update.
+		virtual void ScheduledUpdate(float elapsedSeconds) = 0;
+
+		// Cheap per-frame resolve, called every frame in registration order with the time since the last full update (zero on update frames).
+		virtual void Extrapolate(float elapsedSeconds) = 0;
+
+	protected:
+		IScheduledUpdatable() { };
+	};
+
+	// Snapshots hold each entity's rate, last update and deadline, but not the registrations: a snapshot is loaded into a
+	// scheduler with the same entities registered in the same order. The restored update times are moved forward to the frame
+	// before the next Update(), so a rewind doesn't count the time spent rewinding as time since the entities' last updates.
+	class UpdateScheduler final : public ISnapshotable
+	{
+	public:
+		UpdateScheduler(std::chrono::microseconds frameBudget = DefaultFrameBudget);
+		UpdateScheduler(const UpdateScheduler&) = delete;
+		UpdateScheduler& operator=(const UpdateScheduler&) = delete;
+		UpdateScheduler(UpdateScheduler&&) = default;
+		UpdateScheduler& operator=(UpdateScheduler&&) = default;
+		~UpdateScheduler() = default;
+
+		std::uint32_t Register(IScheduledUpdatable& updatable);
+		void Clear();
+		std::uint32_t Size() const;
+
+		const std::chrono::microseconds& FrameBudget() const;
+		void SetFrameBudget(const std::chrono::microseconds& frameBudget);
+
+		float& FullRateScreenSize();
+		std::uint32_t& MaxUpdatePeriod();
+		std::uint32_t UpdatePeriod(std::uint32_t handle) const;
+
+		// Entities registered since the last call are first given a deadline here, from their own rate and phase, so a new scene
+		// doesn't update every entity on its first frame. The projection scale is from ProjectionScale().
+		void Update(const GameTime& gameTime, DirectX::FXMVECTOR cameraPosition, float projectionScale);
+
+		// Pixels per world unit at unit distance.
+		static float ProjectionScale(DirectX::CXMMATRIX projectionMatrix, float viewportHeight);
+
+		std::uint64_t FrameIndex() const;
+		std::uint32_t UpdatedCount() const;
+		std::uint32_t DeferredCount() const;
+		const std::chrono::microseconds& LastUpdateCost() const;
+
+		virtual void SaveSnapshot(OutputStreamHelper& streamHelper) const override;
+		virtual void LoadSnapshot(InputStreamHelper& streamHelper) override;
+
+		static const std::chrono::microseconds DefaultFrameBudget;
+		static const float DefaultFullRateScreenSize;
+		static const std::uint32_t DefaultMaxUpdatePeriod;
+
+	private:
+		struct Entry
+		{
+			IScheduledUpdatable* Updatable;
+			std::uint32_t Period;
+			std::uint32_t Phase;
+			std::uint64_t LastUpdateFrame;
+			std::chrono::nanoseconds LastUpdateTime;
+
+			Entry(IScheduledUpdatable& updatable, std::uint32_t phase) :
+				Updatable(&updatable), Period(1), Phase(phase), LastUpdateFrame(0), LastUpdateTime(0) { }
+		};
+
+		struct Deadline
+		{
+			std::uint64_t Frame;
+			std::uint32_t Index;
+
+			Deadline(std::uint64_t frame, std::uint32_t index) :
+				Frame(frame), Index(index) { }
+
+			bool operator>(const Deadline& rhs) const
+			{
+				return (Frame != rhs.Frame ? Frame > rhs.Frame : Index > rhs.Index);
+			}
+		};
+
+		std::uint32_t ComputeUpdatePeriod(const Entry& entry, DirectX::FXMVECTOR cameraPosition, float projectionScale) const;
+		static std::uint64_t NextDeadline(std::uint64_t frame, std::uint32_t period, std::uint32_t phase);
+
+		static const std::uint32_t BudgetCheckInterval;
+
+		std::vector<Entry> mEntries;
+		std::vector<Deadline> mDeadlines;
+		std::chrono::microseconds mFrameBudget;
+		float mFullRateScreenSize;
+		std::uint32_t mMaxUpdatePeriod;
+		std::uint64_t mFrameIndex;
+		std::uint32_t mUpdatedCount;
+		std::uint32_t mDeferredCount;
+		std::chrono::microseconds mLastUpdateCost;
+
+		// Entries from this index on were registered after the last Update() and have no deadline yet.
+		std::uint32_t mScheduledCount;
+		std::chrono::nanoseconds mLastUpdateTime;
+		bool mRebaseUpdateTimes;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,98 @@
 #pragma once
 
+#if defined(LIBRARY_PORTABLE)
+
+// Builds without the Windows SDK, e.g. Tools/LibraryTests, compile only the portable sources, which need nothing beyond the
+// standard library. DirectXMath builds header-only anywhere, so defining LIBRARY_DIRECTXMATH too adds the math-based ones.
+
+// Standard
+#include <exception>
+#include <stdexcept>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <map>
+#include <stack>
+#include <cstdint>
+#include <cstring>
+#include <cstdarg>
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// The portable sources use these from <windows.h>. Windows builds of them (e.g. the headless renderer's) take the real ones,
+// which AllocationCounter's stack capture needs anyway.
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#define UNREFERENCED_PARAMETER(P) static_cast<void>(P)
+#define ARRAYSIZE(A) (sizeof(A) / sizeof((A)[0]))
+#endif
+
+#if defined(LIBRARY_DIRECTXMATH)
+// DirectX
+#include <DirectXMath.h>
+#endif
+
+// Local
+#include "RTTI.h"
+#include "GameException.h"
+#include "Timeline.h"
+#include "GameClock.h"
+#include "GameTime.h"
+#include "ServiceContainer.h"
+#include "FrameStatistics.h"
+#include "ThreadPool.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include "FramePipeline.h"
+#include "EntityWorld.h"
+#include "EntityCommandBuffer.h"
+#include "EntitySystemScheduler.h"
+#include "MemoryResource.h"
+#include "LinearArena.h"
+#include "FrameArena.h"
+#include "TextBuilder.h"
+#include "Span.h"
+#include "DrawKey.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "StateCachingContext.h"
+#include "RenderDevice.h"
+#include "NullRenderDevice.h"
+#include "ConstantBufferRing.h"
+#include "RenderQueue.h"
+#include "RenderGraph.h"
+#include "NullRenderGraphExecutor.h"
+#include "Profiler.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+#include "CameraPath.h"
+#include "SolarSystemBodies.h"
+
+#if defined(LIBRARY_DIRECTXMATH)
+#include "StreamHelper.h"
+#include "UpdateScheduler.h"
+#include "SnapshotBuffer.h"
+#include "TransformKernels.h"
+#include "InstancePacker.h"
+#include "MeshData.h"
+#endif
+
+#else
+
 // Windows
 #include <windows.h>
 #include <wrl.h>
@@ -20,6 +113,7 @@
 #include <codecvt>
 #include <algorithm>
 #include <functional>
+#include <numeric>
 
 #if defined(DEBUG) || defined(_DEBUG)
 #define _CRTDBG_MAP_ALLOC
@@ -44,6 +138,7 @@
 // Local
 #include "RTTI.h"
 #include "GameException.h"
+#include "Timeline.h"
 #include "GameClock.h"
 #include "GameTime.h"
 #include "ServiceContainer.h"
@@ -58,6 +153,8 @@
 #include "PerspectiveCamera.h"
 #include "OrthographicCamera.h"
 #include "FirstPersonCamera.h"
+#include "CameraPath.h"
+#include "SolarSystemBodies.h"
 #include "Light.h"
 #include "DirectionalLight.h"
 #include "PointLight.h"
@@ -69,9 +166,12 @@
 #include "RasterizerStates.h"
 #include "SamplerStates.h"
 #include "RenderStateHelper.h"
+#include "FrameStatistics.h"
 #include "FpsComponent.h"
+#include "HudComponent.h"
 #include "StreamHelper.h"
 #include "Model.h"
+#include "MeshData.h"
 #include "Mesh.h"
 #include "ModelMaterial.h"
 #include "ProxyModel.h"
@@ -80,6 +180,40 @@
 #include "KeyboardComponent.h"
 #include "GamePadComponent.h"
 #include "Grid.h"
+#include "UpdateScheduler.h"
+#include "SnapshotBuffer.h"
+#include "ThreadPool.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include "FramePipeline.h"
+#include "EntityWorld.h"
+#include "EntityCommandBuffer.h"
+#include "EntitySystemScheduler.h"
+#include "MemoryResource.h"
+#include "LinearArena.h"
+#include "FrameArena.h"
+#include "TextBuilder.h"
+#include "Span.h"
+#include "TransformKernels.h"
+#include "InstancePacker.h"
+#include "ConstantBufferRing.h"
+#include "DrawKey.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "StateCachingContext.h"
+#include "Direct3DStateCache.h"
+#include "RenderDevice.h"
+#include "Direct3D11RenderDevice.h"
+#include "NullRenderDevice.h"
+#include "RenderGraph.h"
+#include "Direct3D11RenderGraphExecutor.h"
+#include "NullRenderGraphExecutor.h"
+#include "Profiler.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+#endif
 
 namespace Library
 {
@@ -0,0 +1,129 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+namespace HeadlessRenderer
+{
+	const float HeadlessSolarSystem::SkyboxScale = 5000.0f;
+	const float HeadlessSolarSystem::FieldOfView = 3.14159265f / 4.0f;
+	const float HeadlessSolarSystem::NearPlaneDistance = 0.01f;
+	const float HeadlessSolarSystem::FarPlaneDistance = 10000.0f;
+	const Vector3 HeadlessSolarSystem::CameraPosition = Vector3(0.0f, 2.5f, 25.0f);
+
+	HeadlessSolarSystem::HeadlessSolarSystem(const string& contentDirectory, float aspectRatio) :
+		mContentDirectory(contentDirectory)
+	{
+		mSphere = ModelReader::LoadFirstMesh(mContentDirectory + "/Models/Sphere.obj.bin");
+
+		// The sun has no orbit and does not spin, so its world matrix stays the identity. It comes first, so the other bodies'
+		// parents are one further along than in SolarSystemBodies::Bodies.
+		mBodies.emplace_back(SolarSystemBodies::Sun, -1, SolarSystemBodies::SunAmbientColor);
+		for (const CelestialBodyDescription& description : SolarSystemBodies::Bodies)
+		{
+			mBodies.emplace_back(description, (description.ParentIndex >= 0 ? description.ParentIndex + 1 : -1), SolarSystemBodies::PlanetAmbientColor);
+		}
+
+		// A missing map is reported and its body drawn untextured, so a partial content directory still renders.
+		for (const CelestialBody& body : mBodies)
+		{
+			unique_ptr<Texture> colorMap;
+			try
+			{
+				colorMap = make_unique<Texture>(Texture::LoadDDS(mContentDirectory + "/Textures/" + body.Description->TextureFilename));
+			}
+			catch (const exception& ex)
+			{
+				cerr << "Warning: " << ex.what() << " " << body.Description->Name << " is drawn untextured." << endl;
+			}
+
+			mColorMaps.push_back(move(colorMap));
+		}
+
+		mBodyShaders.resize(mBodies.size());
+
+		mProjection = Matrix::PerspectiveFovRH(FieldOfView, aspectRatio, NearPlaneDistance, FarPlaneDistance);
+		SetCamera(CameraPosition, CameraPosition + Vector3(0.0f, 0.0f, -1.0f));
+	}
+
+	void HeadlessSolarSystem::LoadSkybox(const string& filename)
+	{
+		mSkyboxTexture = make_unique<Texture>(Texture::LoadDDS(filename));
+		if (mSkyboxTexture->FaceCount() != 6)
+		{
+			throw runtime_error(filename + " is not a cube map.");
+		}
+
+		mSkyboxShader.SetSkyboxTexture(mSkyboxTexture.get());
+	}
+
+	void HeadlessSolarSystem::SetCamera(const Vector3& position, const Vector3& target)
+	{
+		// Mirrors Camera::SetDirection(), with the world's up as the up hint
+		mCameraPosition = position;
+		Matrix view = Matrix::LookToRH(position, Normalize(target - position), Vector3(0.0f, 1.0f, 0.0f));
+		mViewProjection = view * mProjection;
+
+		// The skybox surrounds the camera
+		Matrix world = Matrix::Scaling(SkyboxScale, SkyboxScale, SkyboxScale) * Matrix::Translation(position.X, position.Y, position.Z);
+		mSkyboxShader.SetWorldViewProjection(world * mViewProjection);
+	}
+
+	void HeadlessSolarSystem::Update(float elapsedSeconds)
+	{
+		// Parents precede their satellites in mBodies
+		for (CelestialBody& body : mBodies)
+		{
+			const CelestialBodyDescription& description = *body.Description;
+			if (description.OrbitalPeriod == 0.0f)
+			{
+				continue;
+			}
+
+			body.AxialDisplacement += elapsedSeconds * (1 / description.RotationalPeriod) * SolarSystemBodies::RotationalSpeedFactor;
+			body.OrbitalDisplacement += elapsedSeconds * (1 / description.OrbitalPeriod) * SolarSystemBodies::OrbitalSpeedFactor;
+
+			const OrbitalTransform local = SolarSystemBodies::LocalTransform(description.OrbitRadius * SolarSystemBodies::DistanceMultiplier, description.Scale,
+				description.AxialTilt, body.AxialDisplacement, body.OrbitalDisplacement);
+			body.World = Matrix::AffineTransformation(local.Scale, local.Rotation, local.Translation);
+			if (body.ParentIndex >= 0)
+			{
+				body.World = body.World * mBodies[body.ParentIndex].World;
+			}
+		}
+	}
+
+	void HeadlessSolarSystem::Draw(SoftwareRasterizer& rasterizer)
+	{
+		PointLightShader::CBufferPerFrame perFrame;
+		perFrame.CameraPosition = mCameraPosition;
+
+		for (size_t i = 0; i < mBodies.size(); ++i)
+		{
+			const CelestialBody& body = mBodies[i];
+			perFrame.AmbientColor = Vector3(body.AmbientColor, body.AmbientColor, body.AmbientColor);
+
+			PointLightShader::CBufferPerObject perObject;
+			perObject.World = body.World;
+			perObject.WorldViewProjection = body.World * mViewProjection;
+
+			PointLightShader& shader = mBodyShaders[i];
+			shader.SetPerFrame(perFrame);
+			shader.SetPerObject(perObject);
+			shader.SetTextures(mColorMaps[i].get(), nullptr);
+			shader.ShadeVertices(mSphere, mVertices);
+			rasterizer.Draw(mVertices, mSphere.Indices, PointLightShader::AttributeCount, shader, CullMode::Back);
+		}
+
+		if (mSkyboxTexture != nullptr)
+		{
+			mSkyboxShader.ShadeVertices(mSphere, mVertices);
+			rasterizer.Draw(mVertices, mSphere.Indices, SkyboxShader::AttributeCount, mSkyboxShader, CullMode::None);
+		}
+	}
+
+	uint32_t HeadlessSolarSystem::BodyCount() const
+	{
+		return static_cast<uint32_t>(mBodies.size());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "VectorMath.h"
+#include "Texture.h"
+#include "ModelReader.h"
+#include "Shaders.h"
+#include "SolarSystemBodies.h"
+
+namespace HeadlessRenderer
+{
+	class SoftwareRasterizer;
+
+	// The Lesson5.4 solar system with animation enabled, seen from the game's starting camera unless SetCamera() moves it.
+	// The bodies and their motion are Library::SolarSystemBodies, which Lesson5.4 draws too; shading mirrors CelestialBodyRenderer.
+	class HeadlessSolarSystem final
+	{
+	public:
+		HeadlessSolarSystem(const std::string& contentDirectory, float aspectRatio);
+		HeadlessSolarSystem(const HeadlessSolarSystem&) = delete;
+		HeadlessSolarSystem& operator=(const HeadlessSolarSystem&) = delete;
+		HeadlessSolarSystem(HeadlessSolarSystem&&) = delete;
+		HeadlessSolarSystem& operator=(HeadlessSolarSystem&&) = delete;
+		~HeadlessSolarSystem() = default;
+
+		// Draws a skybox from a cube map DDS behind the bodies; the lesson's content ships without one.
+		void LoadSkybox(const std::string& filename);
+
+		void SetCamera(const Vector3& position, const Vector3& target);
+
+		void Update(float elapsedSeconds);
+		void Draw(SoftwareRasterizer& rasterizer);
+
+		std::uint32_t BodyCount() const;
+
+		static const float SkyboxScale;
+		static const float FieldOfView;
+		static const float NearPlaneDistance;
+		static const float FarPlaneDistance;
+		static const Vector3 CameraPosition;
+
+	private:
+		struct CelestialBody
+		{
+			const Library::CelestialBodyDescription* Description;
+			std::int32_t ParentIndex;
+			float AmbientColor;
+			float AxialDisplacement;
+			float OrbitalDisplacement;
+			Matrix World;
+
+			CelestialBody(const Library::CelestialBodyDescription& description, std::int32_t parentIndex, float ambientColor) :
+				Description(&description), ParentIndex(parentIndex), AmbientColor(ambientColor), AxialDisplacement(0.0f), OrbitalDisplacement(0.0f), World(Matrix::Identity()) { }
+		};
+
+		std::string mContentDirectory;
+		MeshData mSphere;
+		std::vector<CelestialBody> mBodies;
+		std::vector<std::unique_ptr<Texture>> mColorMaps;
+		std::vector<PointLightShader> mBodyShaders;
+		std::vector<ShadedVertex> mVertices;
+		std::unique_ptr<Texture> mSkyboxTexture;
+		SkyboxShader mSkyboxShader;
+		Vector3 mCameraPosition;
+		Matrix mProjection;
+		Matrix mViewProjection;
+	};
+}
\ No newline at end of file
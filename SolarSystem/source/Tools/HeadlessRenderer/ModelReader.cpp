@@ -0,0 +1,121 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace HeadlessRenderer
+{
+	MeshData ModelReader::LoadFirstMesh(const string& filename)
+	{
+		ifstream file(filename.c_str(), ios::binary);
+		if (!file.good())
+		{
+			throw runtime_error("Could not open file " + filename + ".");
+		}
+
+		// Materials are only texture names, which the caller supplies itself
+		uint32_t materialCount = ReadUInt32(file);
+		for (uint32_t i = 0; i < materialCount; ++i)
+		{
+			SkipString(file);
+
+			uint32_t textureTypeCount = ReadUInt32(file);
+			for (uint32_t j = 0; j < textureTypeCount; ++j)
+			{
+				ReadUInt32(file);
+				uint32_t textureCount = ReadUInt32(file);
+				for (uint32_t k = 0; k < textureCount; ++k)
+				{
+					SkipString(file);
+				}
+			}
+		}
+
+		if (ReadUInt32(file) == 0)
+		{
+			throw runtime_error(filename + " has no meshes.");
+		}
+
+		// Material reference and name
+		SkipString(file);
+		SkipString(file);
+
+		MeshData mesh;
+		ReadVectors(file, mesh.Positions);
+		ReadVectors(file, mesh.Normals);
+
+		vector<Vector3> ignored;
+		ReadVectors(file, ignored);
+		ReadVectors(file, ignored);
+
+		uint32_t textureCoordinateSetCount = ReadUInt32(file);
+		for (uint32_t i = 0; i < textureCoordinateSetCount; ++i)
+		{
+			vector<Vector3> textureCoordinates;
+			ReadVectors(file, textureCoordinates);
+			if (mesh.TextureCoordinates.empty())
+			{
+				for (const Vector3& textureCoordinate : textureCoordinates)
+				{
+					mesh.TextureCoordinates.emplace_back(textureCoordinate.X, textureCoordinate.Y);
+				}
+			}
+		}
+
+		uint32_t vertexColorSetCount = ReadUInt32(file);
+		for (uint32_t i = 0; i < vertexColorSetCount; ++i)
+		{
+			uint32_t colorCount = ReadUInt32(file);
+			file.seekg(static_cast<streamoff>(colorCount) * 4 * sizeof(float), ios::cur);
+		}
+
+		// Face count, then the indices
+		ReadUInt32(file);
+		mesh.Indices.resize(ReadUInt32(file));
+		file.read(reinterpret_cast<char*>(mesh.Indices.data()), mesh.Indices.size() * sizeof(uint32_t));
+
+		if (!file.good())
+		{
+			throw runtime_error("Truncated model file " + filename + ".");
+		}
+
+		if (mesh.Normals.size() != mesh.Positions.size() || mesh.TextureCoordinates.size() != mesh.Positions.size())
+		{
+			throw runtime_error(filename + " needs normals and texture coordinates for every vertex.");
+		}
+
+		for (uint32_t index : mesh.Indices)
+		{
+			if (index >= mesh.Positions.size())
+			{
+				throw runtime_error(filename + " has an out of range index.");
+			}
+		}
+
+		return mesh;
+	}
+
+	uint32_t ModelReader::ReadUInt32(ifstream& file)
+	{
+		uint32_t value = 0;
+		file.read(reinterpret_cast<char*>(&value), sizeof(value));
+
+		return value;
+	}
+
+	void ModelReader::SkipString(ifstream& file)
+	{
+		uint32_t length = ReadUInt32(file);
+		file.seekg(length, ios::cur);
+	}
+
+	void ModelReader::ReadVectors(ifstream& file, vector<Vector3>& vectors)
+	{
+		vectors.resize(ReadUInt32(file));
+		for (Vector3& vector : vectors)
+		{
+			file.read(reinterpret_cast<char*>(&vector.X), sizeof(float));
+			file.read(reinterpret_cast<char*>(&vector.Y), sizeof(float));
+			file.read(reinterpret_cast<char*>(&vector.Z), sizeof(float));
+		}
+	}
+}
\ No newline at end of file
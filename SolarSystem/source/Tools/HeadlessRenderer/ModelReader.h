@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include <cstdint>
+#include "VectorMath.h"
+
+namespace HeadlessRenderer
+{
+	struct MeshData
+	{
+		std::vector<Vector3> Positions;
+		std::vector<Vector3> Normals;
+		std::vector<Vector2> TextureCoordinates;
+		std::vector<std::uint32_t> Indices;
+	};
+
+	// Reads the .bin models written by the ModelPipeline tool without the Direct3D-dependent Library::Model.
+	class ModelReader final
+	{
+	public:
+		ModelReader() = delete;
+
+		// Returns the positions, normals, first texture coordinate set and indices of the model's first mesh.
+		static MeshData LoadFirstMesh(const std::string& filename);
+
+	private:
+		static std::uint32_t ReadUInt32(std::ifstream& file);
+		static void SkipString(std::ifstream& file);
+		static void ReadVectors(std::ifstream& file, std::vector<Vector3>& vectors);
+	};
+}
\ No newline at end of file
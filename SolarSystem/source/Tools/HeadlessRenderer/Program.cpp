@@ -0,0 +1,280 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+using namespace HeadlessRenderer;
+
+static const char* Usage =
+	"Usage: HeadlessRenderer [-frames count] [-width pixels] [-height pixels] [-threads count]\n"
+	"                        [-content directory] [-output directory] [-skybox cubemap.dds]\n"
+	"                        [-benchmark report.json] [-warmup count] [-path camera.path]\n"
+	"                        [-memoryreport report.txt] [-allocationsampling interval]\n";
+
+static uint32_t ParseCount(const string& option, const char* value)
+{
+	char* end = nullptr;
+	unsigned long count = strtoul(value, &end, 10);
+	if (*end != '\0' || count == 0 || count > 16384)
+	{
+		throw runtime_error("Invalid value for " + option + ": " + value);
+	}
+
+	return static_cast<uint32_t>(count);
+}
+
+static int MakeDirectory(const string& path)
+{
+#if defined(_WIN32)
+	return _mkdir(path.c_str());
+#else
+	return mkdir(path.c_str(), 0755);
+#endif
+}
+
+// Creates the directory and any missing parents, as mkdir -p does. A parent that can't be created (a drive, say, or one that
+// already exists) is passed over; if it was needed, creating the directory itself fails.
+static void CreateDirectories(const string& path)
+{
+	for (size_t separator = path.find_first_of("/\\", 1); separator != string::npos; separator = path.find_first_of("/\\", separator + 1))
+	{
+		MakeDirectory(path.substr(0, separator));
+	}
+
+	if (MakeDirectory(path) != 0 && errno != EEXIST)
+	{
+		throw runtime_error("Could not create directory " + path + ".");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+#if defined(DEBUG) | defined(_DEBUG)
+	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+	try
+	{
+		uint32_t frameCount = 60;
+		uint32_t width = 1024;
+		uint32_t height = 768;
+		uint32_t threadCount = SoftwareRasterizer::DefaultThreadCount();
+		string contentDirectory = "Content";
+		string outputDirectory;
+		string skyboxFilename;
+		string reportFilename;
+		uint32_t warmupFrameCount = 60;
+		string cameraPathFilename;
+		string memoryReportFilename;
+
+		for (int i = 1; i < argc; ++i)
+		{
+			string option = argv[i];
+			if (i + 1 >= argc)
+			{
+				throw runtime_error(string(Usage));
+			}
+
+			const char* value = argv[++i];
+			if (option == "-frames")
+			{
+				frameCount = ParseCount(option, value);
+			}
+			else if (option == "-width")
+			{
+				width = ParseCount(option, value);
+			}
+			else if (option == "-height")
+			{
+				height = ParseCount(option, value);
+			}
+			else if (option == "-threads")
+			{
+				threadCount = ParseCount(option, value);
+			}
+			else if (option == "-content")
+			{
+				contentDirectory = value;
+			}
+			else if (option == "-output")
+			{
+				outputDirectory = value;
+			}
+			else if (option == "-skybox")
+			{
+				skyboxFilename = value;
+			}
+			else if (option == "-benchmark")
+			{
+				reportFilename = value;
+			}
+			else if (option == "-warmup")
+			{
+				warmupFrameCount = (strcmp(value, "0") == 0 ? 0 : ParseCount(option, value));
+			}
+			else if (option == "-path")
+			{
+				cameraPathFilename = value;
+			}
+			else if (option == "-memoryreport")
+			{
+				memoryReportFilename = value;
+			}
+			else if (option == "-allocationsampling")
+			{
+				AllocationCounter::SetSamplingInterval(ParseCount(option, value));
+			}
+			else
+			{
+				throw runtime_error(string(Usage));
+			}
+		}
+
+		if (outputDirectory.empty() == false)
+		{
+			CreateDirectories(outputDirectory);
+		}
+
+		unique_ptr<MemoryTagScope> loadTagScope = make_unique<MemoryTagScope>(MemoryTag::Assets);
+		RenderTarget renderTarget(width, height);
+		SoftwareRasterizer rasterizer(renderTarget, threadCount);
+		HeadlessSolarSystem solarSystem(contentDirectory, static_cast<float>(width) / static_cast<float>(height));
+		if (skyboxFilename.empty() == false)
+		{
+			solarSystem.LoadSkybox(skyboxFilename);
+		}
+
+		// Benchmarks follow the game's benchmark path unless given another; warm-up frames are run first and not reported
+		unique_ptr<Benchmark> benchmark;
+		uint32_t updatePhase = 0;
+		uint32_t drawPhase = 0;
+		uint32_t rasterizePhase = 0;
+		if (reportFilename.empty() == false)
+		{
+			if (cameraPathFilename.empty())
+			{
+				cameraPathFilename = contentDirectory + "/Benchmarks/SolarSystem.path";
+			}
+
+			benchmark = make_unique<Benchmark>("SolarSystem", frameCount, warmupFrameCount);
+			updatePhase = benchmark->AddPhase("Update");
+			drawPhase = benchmark->AddPhase("Draw");
+			rasterizePhase = benchmark->AddPhase("Rasterize");
+			benchmark->SetProperty("renderer", "Software");
+			benchmark->SetProperty("resolution", to_string(width) + "x" + to_string(height));
+			benchmark->SetProperty("threads", to_string(rasterizer.ThreadCount()));
+			benchmark->SetProperty("timeStepNanoseconds", to_string(1000000000 / 60));
+			benchmark->SetProperty("cameraPath", cameraPathFilename);
+			frameCount += warmupFrameCount;
+		}
+
+		CameraPath cameraPath;
+		if (cameraPathFilename.empty() == false)
+		{
+			cameraPath = CameraPath(cameraPathFilename);
+		}
+
+		loadTagScope.reset();
+
+		cout << "Rendering " << frameCount << " frames of " << solarSystem.BodyCount() << " bodies at " << width << "x" << height
+			<< " on " << rasterizer.ThreadCount() << " threads" << endl;
+
+		// Fixed steps keep the output identical from run to run, whatever the host's speed.
+		const float elapsedSeconds = 1.0f / 60.0f;
+		const float backgroundColor[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		double totalMilliseconds = 0.0;
+		double minMilliseconds = 0.0;
+		double maxMilliseconds = 0.0;
+
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			AllocationCounter::BeginFrame();
+			if (benchmark != nullptr)
+			{
+				benchmark->BeginFrame();
+			}
+
+			auto startTime = chrono::high_resolution_clock::now();
+
+			{
+				BenchmarkPhaseScope updateScope(benchmark.get(), updatePhase);
+				MemoryTagScope memoryTagScope(MemoryTag::Simulation);
+				if (cameraPath.Keyframes().empty() == false)
+				{
+					// Matches the game, whose clock has advanced by one step by its first update
+					CameraPath::Point position;
+					CameraPath::Point target;
+					cameraPath.Evaluate((frame + 1) * elapsedSeconds, position, target);
+					solarSystem.SetCamera(Vector3(position.X, position.Y, position.Z), Vector3(target.X, target.Y, target.Z));
+				}
+
+				solarSystem.Update(elapsedSeconds);
+			}
+
+			{
+				BenchmarkPhaseScope drawScope(benchmark.get(), drawPhase);
+				MemoryTagScope memoryTagScope(MemoryTag::Rendering);
+				renderTarget.Clear(backgroundColor);
+				solarSystem.Draw(rasterizer);
+			}
+
+			{
+				BenchmarkPhaseScope rasterizeScope(benchmark.get(), rasterizePhase);
+				MemoryTagScope memoryTagScope(MemoryTag::Rendering);
+				rasterizer.Flush();
+			}
+
+			double milliseconds = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - startTime).count();
+			totalMilliseconds += milliseconds;
+			minMilliseconds = (frame == 0 || milliseconds < minMilliseconds ? milliseconds : minMilliseconds);
+			maxMilliseconds = (milliseconds > maxMilliseconds ? milliseconds : maxMilliseconds);
+
+			cout << "Frame " << setw(4) << frame << ": " << fixed << setprecision(2) << setw(8) << milliseconds << " ms, "
+				<< rasterizer.TriangleCount() << " triangles, " << rasterizer.ShadedPixelCount() << " pixels, hash "
+				<< hex << setw(16) << setfill('0') << renderTarget.Hash() << dec << setfill(' ') << endl;
+
+			if (outputDirectory.empty() == false)
+			{
+				ostringstream filename;
+				filename << outputDirectory << "/frame_" << setw(4) << setfill('0') << frame << ".tga";
+				renderTarget.SaveTga(filename.str());
+			}
+		}
+
+		cout << "Average " << fixed << setprecision(2) << totalMilliseconds / frameCount << " ms, min " << minMilliseconds
+			<< " ms, max " << maxMilliseconds << " ms" << endl;
+
+		if (benchmark != nullptr)
+		{
+			// Closes the last frame
+			benchmark->BeginFrame();
+
+			ofstream reportFile(reportFilename.c_str());
+			if (!reportFile.good())
+			{
+				throw runtime_error("Could not create file " + reportFilename + ".");
+			}
+
+			benchmark->WriteJson(reportFile);
+			cout << "Wrote " << benchmark->RecordedFrameCount() << " benchmark frames to " << reportFilename << endl;
+		}
+
+		if (memoryReportFilename.empty() == false)
+		{
+			ofstream reportFile(memoryReportFilename.c_str());
+			if (!reportFile.good())
+			{
+				throw runtime_error("Could not create file " + memoryReportFilename + ".");
+			}
+
+			AllocationCounter::WriteReport(reportFile);
+			cout << "Wrote memory report to " << memoryReportFilename << endl;
+		}
+	}
+	catch (const exception& ex)
+	{
+		cerr << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
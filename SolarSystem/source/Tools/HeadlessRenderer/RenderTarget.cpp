@@ -0,0 +1,109 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace HeadlessRenderer
+{
+	RenderTarget::RenderTarget(uint32_t width, uint32_t height) :
+		mWidth(width), mHeight(height), mColor(width * height, 0), mDepth(width * height, 1.0f)
+	{
+		assert(width > 0 && height > 0);
+	}
+
+	uint32_t RenderTarget::Width() const
+	{
+		return mWidth;
+	}
+
+	uint32_t RenderTarget::Height() const
+	{
+		return mHeight;
+	}
+
+	uint32_t* RenderTarget::Color()
+	{
+		return mColor.data();
+	}
+
+	const uint32_t* RenderTarget::Color() const
+	{
+		return mColor.data();
+	}
+
+	float* RenderTarget::Depth()
+	{
+		return mDepth.data();
+	}
+
+	const float* RenderTarget::Depth() const
+	{
+		return mDepth.data();
+	}
+
+	void RenderTarget::Clear(const float* color, float depth)
+	{
+		fill(mColor.begin(), mColor.end(), PackColor(color));
+		fill(mDepth.begin(), mDepth.end(), depth);
+	}
+
+	uint64_t RenderTarget::Hash() const
+	{
+		const uint64_t OffsetBasis = 14695981039346656037ULL;
+		const uint64_t Prime = 1099511628211ULL;
+
+		uint64_t hash = OffsetBasis;
+		for (uint32_t texel : mColor)
+		{
+			for (uint32_t byteIndex = 0; byteIndex < 4; ++byteIndex)
+			{
+				hash ^= (texel >> (byteIndex * 8)) & 0xFF;
+				hash *= Prime;
+			}
+		}
+
+		return hash;
+	}
+
+	void RenderTarget::SaveTga(const string& filename) const
+	{
+		ofstream file(filename.c_str(), ios::binary);
+		if (!file.good())
+		{
+			throw runtime_error("Could not open file " + filename + ".");
+		}
+
+		// Uncompressed true-color image with an 8-bit alpha channel and a top-left origin
+		uint8_t header[18] = { 0 };
+		header[2] = 2;
+		header[12] = static_cast<uint8_t>(mWidth & 0xFF);
+		header[13] = static_cast<uint8_t>(mWidth >> 8);
+		header[14] = static_cast<uint8_t>(mHeight & 0xFF);
+		header[15] = static_cast<uint8_t>(mHeight >> 8);
+		header[16] = 32;
+		header[17] = 0x28;
+		file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+		vector<uint8_t> pixels(mColor.size() * 4);
+		for (size_t i = 0; i < mColor.size(); ++i)
+		{
+			uint32_t texel = mColor[i];
+			pixels[i * 4] = static_cast<uint8_t>((texel >> 16) & 0xFF);
+			pixels[i * 4 + 1] = static_cast<uint8_t>((texel >> 8) & 0xFF);
+			pixels[i * 4 + 2] = static_cast<uint8_t>(texel & 0xFF);
+			pixels[i * 4 + 3] = static_cast<uint8_t>(texel >> 24);
+		}
+
+		file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+	}
+
+	uint32_t RenderTarget::PackColor(const float* color)
+	{
+		uint32_t packed = 0;
+		for (uint32_t channel = 0; channel < 4; ++channel)
+		{
+			packed |= static_cast<uint32_t>(Saturate(color[channel]) * 255.0f + 0.5f) << (channel * 8);
+		}
+
+		return packed;
+	}
+}
\ No newline at end of file
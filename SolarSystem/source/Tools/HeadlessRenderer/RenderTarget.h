@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace HeadlessRenderer
+{
+	// An offscreen RGBA8 color buffer with a matching 32-bit float depth buffer.
+	class RenderTarget final
+	{
+	public:
+		RenderTarget(std::uint32_t width, std::uint32_t height);
+		RenderTarget(const RenderTarget&) = delete;
+		RenderTarget& operator=(const RenderTarget&) = delete;
+		RenderTarget(RenderTarget&&) = default;
+		RenderTarget& operator=(RenderTarget&&) = default;
+		~RenderTarget() = default;
+
+		std::uint32_t Width() const;
+		std::uint32_t Height() const;
+
+		// Texels are packed as 0xAABBGGRR, i.e. R8G8B8A8 in memory on little-endian machines.
+		std::uint32_t* Color();
+		const std::uint32_t* Color() const;
+		float* Depth();
+		const float* Depth() const;
+
+		void Clear(const float* color, float depth = 1.0f);
+
+		// 64-bit FNV-1a hash of the color buffer, for comparing frames across runs and machines.
+		std::uint64_t Hash() const;
+
+		// Writes an uncompressed 32-bit TGA, which every image viewer reads and needs no compression library.
+		void SaveTga(const std::string& filename) const;
+
+		static std::uint32_t PackColor(const float* color);
+
+	private:
+		std::uint32_t mWidth;
+		std::uint32_t mHeight;
+		std::vector<std::uint32_t> mColor;
+		std::vector<float> mDepth;
+	};
+}
\ No newline at end of file
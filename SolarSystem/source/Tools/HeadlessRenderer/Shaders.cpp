@@ -0,0 +1,126 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace HeadlessRenderer
+{
+	const uint32_t PointLightShader::AttributeCount = 9;
+	const uint32_t SkyboxShader::AttributeCount = 3;
+
+	void PointLightShader::SetPerFrame(const CBufferPerFrame& perFrame)
+	{
+		mPerFrame = perFrame;
+	}
+
+	void PointLightShader::SetPerObject(const CBufferPerObject& perObject)
+	{
+		mPerObject = perObject;
+	}
+
+	void PointLightShader::SetTextures(const Texture* colorMap, const Texture* specularMap)
+	{
+		mColorMap = colorMap;
+		mSpecularMap = specularMap;
+	}
+
+	void PointLightShader::ShadeVertices(const MeshData& mesh, vector<ShadedVertex>& vertices) const
+	{
+		// Attributes: world position (3), attenuation (1), texture coordinate (2), normal (3)
+		vertices.resize(mesh.Positions.size());
+		for (size_t i = 0; i < mesh.Positions.size(); ++i)
+		{
+			ShadedVertex& vertex = vertices[i];
+			vertex.Position = TransformPoint(mesh.Positions[i], mPerObject.WorldViewProjection);
+
+			Vector4 worldPosition = TransformPoint(mesh.Positions[i], mPerObject.World);
+			Vector3 normal = Normalize(TransformNormal(mesh.Normals[i], mPerObject.World));
+			Vector3 lightDirection = mPerFrame.LightPosition - Vector3(worldPosition.X, worldPosition.Y, worldPosition.Z);
+
+			vertex.Attributes[0] = worldPosition.X;
+			vertex.Attributes[1] = worldPosition.Y;
+			vertex.Attributes[2] = worldPosition.Z;
+			vertex.Attributes[3] = Saturate(1.0f - (Length(lightDirection) / mPerFrame.LightRadius));
+			vertex.Attributes[4] = mesh.TextureCoordinates[i].X;
+			vertex.Attributes[5] = mesh.TextureCoordinates[i].Y;
+			vertex.Attributes[6] = normal.X;
+			vertex.Attributes[7] = normal.Y;
+			vertex.Attributes[8] = normal.Z;
+		}
+	}
+
+	void PointLightShader::Shade(const float* attributes, float* color) const
+	{
+		Vector3 worldPosition(attributes[0], attributes[1], attributes[2]);
+		float attenuation = attributes[3];
+
+		Vector3 viewDirection = Normalize(mPerFrame.CameraPosition - worldPosition);
+		Vector3 lightDirection = Normalize(mPerFrame.LightPosition - worldPosition);
+
+		Vector3 normal = Normalize(Vector3(attributes[6], attributes[7], attributes[8]));
+		float n_dot_l = Dot(normal, lightDirection);
+		Vector3 halfVector = Normalize(lightDirection + viewDirection);
+		float n_dot_h = Dot(normal, halfVector);
+
+		float sampledColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		if (mColorMap != nullptr)
+		{
+			mColorMap->Sample(attributes[4], attributes[5], sampledColor);
+		}
+
+		float specularClamp = 1.0f;
+		if (mSpecularMap != nullptr)
+		{
+			float specularSample[4];
+			mSpecularMap->Sample(attributes[4], attributes[5], specularSample);
+			specularClamp = specularSample[0];
+		}
+
+		// lit(n_dot_l, n_dot_h, m).yz
+		float diffuseCoefficient = max(n_dot_l, 0.0f);
+		float specularCoefficient = (n_dot_l < 0.0f || n_dot_h < 0.0f ? 0.0f : powf(n_dot_h, mPerObject.SpecularPower));
+
+		const float* ambientColor = &mPerFrame.AmbientColor.X;
+		const float* lightColor = &mPerFrame.LightColor.X;
+		const float* specularColor = &mPerObject.SpecularColor.X;
+		float specular = min(specularCoefficient, specularClamp) * attenuation;
+		for (uint32_t channel = 0; channel < 3; ++channel)
+		{
+			float ambient = sampledColor[channel] * ambientColor[channel];
+			float diffuse = sampledColor[channel] * diffuseCoefficient * lightColor[channel] * attenuation;
+			color[channel] = Saturate(ambient + diffuse + specular * specularColor[channel]);
+		}
+
+		color[3] = sampledColor[3];
+	}
+
+	void SkyboxShader::SetWorldViewProjection(const Matrix& worldViewProjection)
+	{
+		mWorldViewProjection = worldViewProjection;
+	}
+
+	void SkyboxShader::SetSkyboxTexture(const Texture* skyboxTexture)
+	{
+		mSkyboxTexture = skyboxTexture;
+	}
+
+	void SkyboxShader::ShadeVertices(const MeshData& mesh, vector<ShadedVertex>& vertices) const
+	{
+		// The object-space position doubles as the cube map direction
+		vertices.resize(mesh.Positions.size());
+		for (size_t i = 0; i < mesh.Positions.size(); ++i)
+		{
+			ShadedVertex& vertex = vertices[i];
+			vertex.Position = TransformPoint(mesh.Positions[i], mWorldViewProjection);
+			vertex.Attributes[0] = mesh.Positions[i].X;
+			vertex.Attributes[1] = mesh.Positions[i].Y;
+			vertex.Attributes[2] = mesh.Positions[i].Z;
+		}
+	}
+
+	void SkyboxShader::Shade(const float* attributes, float* color) const
+	{
+		assert(mSkyboxTexture != nullptr);
+
+		mSkyboxTexture->SampleCube(Vector3(attributes[0], attributes[1], attributes[2]), color);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "VectorMath.h"
+#include "SoftwareRasterizer.h"
+
+namespace HeadlessRenderer
+{
+	class Texture;
+	struct MeshData;
+
+	// Port of PointLightDemoVS.hlsl and PointLightDemoPS.hlsl.
+	class PointLightShader final : public PixelShader
+	{
+	public:
+		struct CBufferPerFrame
+		{
+			Vector3 CameraPosition;
+			Vector3 AmbientColor;
+			Vector3 LightPosition;
+			Vector3 LightColor;
+			float LightRadius;
+
+			CBufferPerFrame() :
+				LightColor(1.0f, 1.0f, 1.0f), LightRadius(100000.0f) { }
+		};
+
+		struct CBufferPerObject
+		{
+			Matrix WorldViewProjection;
+			Matrix World;
+			Vector3 SpecularColor;
+			float SpecularPower;
+
+			CBufferPerObject() :
+				WorldViewProjection(Matrix::Identity()), World(Matrix::Identity()), SpecularColor(1.0f, 1.0f, 1.0f), SpecularPower(128.0f) { }
+		};
+
+		PointLightShader() = default;
+		PointLightShader(const PointLightShader&) = default;
+		PointLightShader& operator=(const PointLightShader&) = default;
+		PointLightShader(PointLightShader&&) = default;
+		PointLightShader& operator=(PointLightShader&&) = default;
+		~PointLightShader() = default;
+
+		void SetPerFrame(const CBufferPerFrame& perFrame);
+		void SetPerObject(const CBufferPerObject& perObject);
+
+		// The game samples a specular map to clamp the highlight; without one the highlight is left unclamped.
+		void SetTextures(const Texture* colorMap, const Texture* specularMap);
+
+		void ShadeVertices(const MeshData& mesh, std::vector<ShadedVertex>& vertices) const;
+		virtual void Shade(const float* attributes, float* color) const override;
+
+		static const std::uint32_t AttributeCount;
+
+	private:
+		CBufferPerFrame mPerFrame;
+		CBufferPerObject mPerObject;
+		const Texture* mColorMap = nullptr;
+		const Texture* mSpecularMap = nullptr;
+	};
+
+	// Port of SkyboxVS.hlsl and SkyboxPS.hlsl.
+	class SkyboxShader final : public PixelShader
+	{
+	public:
+		SkyboxShader() = default;
+		SkyboxShader(const SkyboxShader&) = default;
+		SkyboxShader& operator=(const SkyboxShader&) = default;
+		SkyboxShader(SkyboxShader&&) = default;
+		SkyboxShader& operator=(SkyboxShader&&) = default;
+		~SkyboxShader() = default;
+
+		void SetWorldViewProjection(const Matrix& worldViewProjection);
+		void SetSkyboxTexture(const Texture* skyboxTexture);
+
+		void ShadeVertices(const MeshData& mesh, std::vector<ShadedVertex>& vertices) const;
+		virtual void Shade(const float* attributes, float* color) const override;
+
+		static const std::uint32_t AttributeCount;
+
+	private:
+		Matrix mWorldViewProjection = Matrix::Identity();
+		const Texture* mSkyboxTexture = nullptr;
+	};
+}
\ No newline at end of file
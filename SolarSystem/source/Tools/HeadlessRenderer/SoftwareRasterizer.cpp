@@ -0,0 +1,308 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+namespace HeadlessRenderer
+{
+	const uint32_t SoftwareRasterizer::TileSize = 64;
+
+	SoftwareRasterizer::SoftwareRasterizer(RenderTarget& renderTarget, uint32_t threadCount) :
+		mRenderTarget(&renderTarget), mThreadCount(max(threadCount, 1u)),
+		mTileColumns((renderTarget.Width() + TileSize - 1) / TileSize), mTileRows((renderTarget.Height() + TileSize - 1) / TileSize),
+		mBins(mTileColumns * mTileRows), mTriangleCount(0), mShadedPixelCount(0)
+	{
+	}
+
+	void SoftwareRasterizer::Draw(const vector<ShadedVertex>& vertices, const vector<uint32_t>& indices, uint32_t attributeCount, const PixelShader& pixelShader, CullMode cullMode)
+	{
+		assert(indices.size() % 3 == 0);
+		assert(attributeCount <= ShadedVertex::MaxAttributes);
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			assert(indices[i] < vertices.size() && indices[i + 1] < vertices.size() && indices[i + 2] < vertices.size());
+			ClipAndAdd(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]], attributeCount, pixelShader, cullMode);
+		}
+	}
+
+	void SoftwareRasterizer::Flush()
+	{
+		mTriangleCount = static_cast<uint32_t>(mTriangles.size());
+
+		// Threads pull tiles from a shared counter; a thread per flush costs little next to shading a frame.
+		atomic<uint32_t> nextTile(0);
+		atomic<uint64_t> shadedPixelCount(0);
+		auto worker = [this, &nextTile, &shadedPixelCount]()
+		{
+			MemoryTagScope memoryTagScope(MemoryTag::Rendering);
+
+			uint64_t threadPixelCount = 0;
+			for (uint32_t tileIndex = nextTile++; tileIndex < mBins.size(); tileIndex = nextTile++)
+			{
+				threadPixelCount += RasterizeTile(tileIndex);
+			}
+
+			shadedPixelCount += threadPixelCount;
+		};
+
+		vector<thread> threads;
+		uint32_t threadCount = min(mThreadCount, static_cast<uint32_t>(mBins.size()));
+		for (uint32_t i = 1; i < threadCount; ++i)
+		{
+			threads.emplace_back(worker);
+		}
+
+		worker();
+		for (thread& workerThread : threads)
+		{
+			workerThread.join();
+		}
+
+		mShadedPixelCount = shadedPixelCount;
+
+		mTriangles.clear();
+		mAttributes.clear();
+		for (vector<uint32_t>& bin : mBins)
+		{
+			bin.clear();
+		}
+	}
+
+	uint32_t SoftwareRasterizer::ThreadCount() const
+	{
+		return mThreadCount;
+	}
+
+	uint32_t SoftwareRasterizer::TriangleCount() const
+	{
+		return mTriangleCount;
+	}
+
+	uint64_t SoftwareRasterizer::ShadedPixelCount() const
+	{
+		return mShadedPixelCount;
+	}
+
+	uint32_t SoftwareRasterizer::DefaultThreadCount()
+	{
+		return max(thread::hardware_concurrency(), 1u);
+	}
+
+	void SoftwareRasterizer::ClipAndAdd(const ShadedVertex& vertex0, const ShadedVertex& vertex1, const ShadedVertex& vertex2, uint32_t attributeCount, const PixelShader& pixelShader, CullMode cullMode)
+	{
+		const ShadedVertex* input[3] = { &vertex0, &vertex1, &vertex2 };
+		bool inside[3] = { vertex0.Position.Z >= 0.0f, vertex1.Position.Z >= 0.0f, vertex2.Position.Z >= 0.0f };
+		if (inside[0] && inside[1] && inside[2])
+		{
+			AddTriangle(vertex0, vertex1, vertex2, attributeCount, pixelShader, cullMode);
+			return;
+		}
+
+		// Clip against the near plane (z = 0 in Direct3D clip space); the other planes are handled by the screen bounds and the depth test.
+		ShadedVertex clipped[4];
+		uint32_t clippedCount = 0;
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			uint32_t next = (i + 1) % 3;
+			if (inside[i])
+			{
+				clipped[clippedCount++] = *input[i];
+			}
+
+			if (inside[i] != inside[next])
+			{
+				const ShadedVertex& from = *input[i];
+				const ShadedVertex& to = *input[next];
+				float t = from.Position.Z / (from.Position.Z - to.Position.Z);
+
+				ShadedVertex& vertex = clipped[clippedCount++];
+				vertex.Position = Vector4(from.Position.X + (to.Position.X - from.Position.X) * t, from.Position.Y + (to.Position.Y - from.Position.Y) * t,
+					0.0f, from.Position.W + (to.Position.W - from.Position.W) * t);
+				for (uint32_t attribute = 0; attribute < attributeCount; ++attribute)
+				{
+					vertex.Attributes[attribute] = from.Attributes[attribute] + (to.Attributes[attribute] - from.Attributes[attribute]) * t;
+				}
+			}
+		}
+
+		for (uint32_t i = 2; i < clippedCount; ++i)
+		{
+			AddTriangle(clipped[0], clipped[i - 1], clipped[i], attributeCount, pixelShader, cullMode);
+		}
+	}
+
+	void SoftwareRasterizer::AddTriangle(const ShadedVertex& vertex0, const ShadedVertex& vertex1, const ShadedVertex& vertex2, uint32_t attributeCount, const PixelShader& pixelShader, CullMode cullMode)
+	{
+		const ShadedVertex* vertices[3] = { &vertex0, &vertex1, &vertex2 };
+		float width = static_cast<float>(mRenderTarget->Width());
+		float height = static_cast<float>(mRenderTarget->Height());
+
+		Triangle triangle;
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			const Vector4& position = vertices[i]->Position;
+			if (position.W <= 0.0f)
+			{
+				return;
+			}
+
+			float inverseW = 1.0f / position.W;
+			triangle.X[i] = (position.X * inverseW * 0.5f + 0.5f) * width;
+			triangle.Y[i] = (0.5f - position.Y * inverseW * 0.5f) * height;
+			triangle.Z[i] = position.Z * inverseW;
+			triangle.InverseW[i] = inverseW;
+		}
+
+		// Positive area is clockwise on screen, which Direct3D treats as front facing.
+		float area = (triangle.X[1] - triangle.X[0]) * (triangle.Y[2] - triangle.Y[0]) - (triangle.X[2] - triangle.X[0]) * (triangle.Y[1] - triangle.Y[0]);
+		if (area == 0.0f || (cullMode == CullMode::Back && area < 0.0f))
+		{
+			return;
+		}
+
+		if (area < 0.0f)
+		{
+			swap(vertices[1], vertices[2]);
+			swap(triangle.X[1], triangle.X[2]);
+			swap(triangle.Y[1], triangle.Y[2]);
+			swap(triangle.Z[1], triangle.Z[2]);
+			swap(triangle.InverseW[1], triangle.InverseW[2]);
+			area = -area;
+		}
+
+		// Pixels whose centers fall within the triangle's bounds
+		float minX = min(min(triangle.X[0], triangle.X[1]), triangle.X[2]);
+		float maxX = max(max(triangle.X[0], triangle.X[1]), triangle.X[2]);
+		float minY = min(min(triangle.Y[0], triangle.Y[1]), triangle.Y[2]);
+		float maxY = max(max(triangle.Y[0], triangle.Y[1]), triangle.Y[2]);
+		if (maxX < 0.0f || maxY < 0.0f || minX > width || minY > height)
+		{
+			return;
+		}
+
+		triangle.MinX = max(static_cast<int32_t>(ceilf(minX - 0.5f)), 0);
+		triangle.MaxX = min(static_cast<int32_t>(floorf(maxX - 0.5f)), static_cast<int32_t>(mRenderTarget->Width()) - 1);
+		triangle.MinY = max(static_cast<int32_t>(ceilf(minY - 0.5f)), 0);
+		triangle.MaxY = min(static_cast<int32_t>(floorf(maxY - 0.5f)), static_cast<int32_t>(mRenderTarget->Height()) - 1);
+		if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+		{
+			return;
+		}
+
+		// Attributes are stored divided by w so that they interpolate linearly in screen space.
+		triangle.InverseArea = 1.0f / area;
+		triangle.AttributeOffset = static_cast<uint32_t>(mAttributes.size());
+		triangle.AttributeCount = attributeCount;
+		triangle.Shader = &pixelShader;
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			for (uint32_t attribute = 0; attribute < attributeCount; ++attribute)
+			{
+				mAttributes.push_back(vertices[i]->Attributes[attribute] * triangle.InverseW[i]);
+			}
+		}
+
+		uint32_t triangleIndex = static_cast<uint32_t>(mTriangles.size());
+		mTriangles.push_back(triangle);
+
+		for (uint32_t tileRow = triangle.MinY / TileSize; tileRow <= triangle.MaxY / TileSize; ++tileRow)
+		{
+			for (uint32_t tileColumn = triangle.MinX / TileSize; tileColumn <= triangle.MaxX / TileSize; ++tileColumn)
+			{
+				mBins[tileRow * mTileColumns + tileColumn].push_back(triangleIndex);
+			}
+		}
+	}
+
+	uint64_t SoftwareRasterizer::RasterizeTile(uint32_t tileIndex)
+	{
+		int32_t tileMinX = static_cast<int32_t>((tileIndex % mTileColumns) * TileSize);
+		int32_t tileMinY = static_cast<int32_t>((tileIndex / mTileColumns) * TileSize);
+		int32_t tileMaxX = min(tileMinX + static_cast<int32_t>(TileSize), static_cast<int32_t>(mRenderTarget->Width())) - 1;
+		int32_t tileMaxY = min(tileMinY + static_cast<int32_t>(TileSize), static_cast<int32_t>(mRenderTarget->Height())) - 1;
+
+		uint32_t width = mRenderTarget->Width();
+		uint32_t* colorBuffer = mRenderTarget->Color();
+		float* depthBuffer = mRenderTarget->Depth();
+
+		uint64_t shadedPixelCount = 0;
+		float attributes[ShadedVertex::MaxAttributes];
+		float color[4];
+
+		for (uint32_t triangleIndex : mBins[tileIndex])
+		{
+			const Triangle& triangle = mTriangles[triangleIndex];
+			const float* vertexAttributes[3];
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				vertexAttributes[i] = &mAttributes[triangle.AttributeOffset + i * triangle.AttributeCount];
+			}
+
+			// Edge i runs from vertex i to the next one and is positive inside; its function weights the opposite vertex.
+			float a[3];
+			float b[3];
+			float c[3];
+			bool includeZero[3];
+			for (uint32_t edge = 0; edge < 3; ++edge)
+			{
+				uint32_t next = (edge + 1) % 3;
+				a[edge] = triangle.Y[edge] - triangle.Y[next];
+				b[edge] = triangle.X[next] - triangle.X[edge];
+				c[edge] = -(a[edge] * triangle.X[edge] + b[edge] * triangle.Y[edge]);
+
+				// Pixels exactly on a shared edge belong to one side only
+				includeZero[edge] = (a[edge] > 0.0f || (a[edge] == 0.0f && b[edge] > 0.0f));
+			}
+
+			int32_t minX = max(triangle.MinX, tileMinX);
+			int32_t maxX = min(triangle.MaxX, tileMaxX);
+			int32_t minY = max(triangle.MinY, tileMinY);
+			int32_t maxY = min(triangle.MaxY, tileMaxY);
+
+			for (int32_t y = minY; y <= maxY; ++y)
+			{
+				float centerY = static_cast<float>(y) + 0.5f;
+				for (int32_t x = minX; x <= maxX; ++x)
+				{
+					float centerX = static_cast<float>(x) + 0.5f;
+
+					float edges[3];
+					bool inside = true;
+					for (uint32_t edge = 0; edge < 3; ++edge)
+					{
+						edges[edge] = a[edge] * centerX + b[edge] * centerY + c[edge];
+						inside = inside && (edges[edge] > 0.0f || (edges[edge] == 0.0f && includeZero[edge]));
+					}
+
+					if (inside == false)
+					{
+						continue;
+					}
+
+					float weights[3] = { edges[1] * triangle.InverseArea, edges[2] * triangle.InverseArea, edges[0] * triangle.InverseArea };
+					float depth = weights[0] * triangle.Z[0] + weights[1] * triangle.Z[1] + weights[2] * triangle.Z[2];
+
+					uint32_t pixel = static_cast<uint32_t>(y) * width + static_cast<uint32_t>(x);
+					if (depth > 1.0f || depth >= depthBuffer[pixel])
+					{
+						continue;
+					}
+
+					float w = 1.0f / (weights[0] * triangle.InverseW[0] + weights[1] * triangle.InverseW[1] + weights[2] * triangle.InverseW[2]);
+					for (uint32_t attribute = 0; attribute < triangle.AttributeCount; ++attribute)
+					{
+						attributes[attribute] = (weights[0] * vertexAttributes[0][attribute] + weights[1] * vertexAttributes[1][attribute] + weights[2] * vertexAttributes[2][attribute]) * w;
+					}
+
+					triangle.Shader->Shade(attributes, color);
+					colorBuffer[pixel] = RenderTarget::PackColor(color);
+					depthBuffer[pixel] = depth;
+					++shadedPixelCount;
+				}
+			}
+		}
+
+		return shadedPixelCount;
+	}
+}
\ No newline at end of file
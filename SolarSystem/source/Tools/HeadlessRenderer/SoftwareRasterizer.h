@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "VectorMath.h"
+
+namespace HeadlessRenderer
+{
+	class RenderTarget;
+
+	// Output of a vertex shader: a clip-space position followed by the attributes the pixel shader interpolates.
+	struct ShadedVertex
+	{
+		static const std::uint32_t MaxAttributes = 12;
+
+		Vector4 Position;
+		float Attributes[MaxAttributes];
+	};
+
+	class PixelShader
+	{
+	public:
+		virtual ~PixelShader() = default;
+
+		// attributes are interpolated with perspective correction; color receives RGBA in [0, 1].
+		virtual void Shade(const float* attributes, float* color) const = 0;
+	};
+
+	enum class CullMode
+	{
+		None,
+		Back
+	};
+
+	// Triangles are clipped to the near plane and binned into screen tiles as they are drawn, then Flush() shades the
+	// tiles on worker threads. Each tile processes its triangles in submission order, so the image does not depend on
+	// the thread count. Follows the Direct3D 11 defaults: clockwise front faces, top-left fill rule and a less-than depth test.
+	class SoftwareRasterizer final
+	{
+	public:
+		SoftwareRasterizer(RenderTarget& renderTarget, std::uint32_t threadCount = DefaultThreadCount());
+		SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+		SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+		SoftwareRasterizer(SoftwareRasterizer&&) = delete;
+		SoftwareRasterizer& operator=(SoftwareRasterizer&&) = delete;
+		~SoftwareRasterizer() = default;
+
+		// Queues an indexed triangle list. pixelShader must stay alive until the next Flush().
+		void Draw(const std::vector<ShadedVertex>& vertices, const std::vector<std::uint32_t>& indices, std::uint32_t attributeCount, const PixelShader& pixelShader, CullMode cullMode = CullMode::Back);
+
+		// Rasterizes everything queued since the last Flush() into the render target.
+		void Flush();
+
+		std::uint32_t ThreadCount() const;
+
+		// Statistics from the last Flush()
+		std::uint32_t TriangleCount() const;
+		std::uint64_t ShadedPixelCount() const;
+
+		static std::uint32_t DefaultThreadCount();
+		static const std::uint32_t TileSize;
+
+	private:
+		struct Triangle
+		{
+			float X[3];
+			float Y[3];
+			float Z[3];
+			float InverseW[3];
+			float InverseArea;
+			std::uint32_t AttributeOffset;
+			std::uint32_t AttributeCount;
+			const PixelShader* Shader;
+			std::int32_t MinX;
+			std::int32_t MaxX;
+			std::int32_t MinY;
+			std::int32_t MaxY;
+		};
+
+		void ClipAndAdd(const ShadedVertex& vertex0, const ShadedVertex& vertex1, const ShadedVertex& vertex2, std::uint32_t attributeCount, const PixelShader& pixelShader, CullMode cullMode);
+		void AddTriangle(const ShadedVertex& vertex0, const ShadedVertex& vertex1, const ShadedVertex& vertex2, std::uint32_t attributeCount, const PixelShader& pixelShader, CullMode cullMode);
+		std::uint64_t RasterizeTile(std::uint32_t tileIndex);
+
+		RenderTarget* mRenderTarget;
+		std::uint32_t mThreadCount;
+		std::uint32_t mTileColumns;
+		std::uint32_t mTileRows;
+		std::vector<Triangle> mTriangles;
+		std::vector<float> mAttributes;
+		std::vector<std::vector<std::uint32_t>> mBins;
+		std::uint32_t mTriangleCount;
+		std::uint64_t mShadedPixelCount;
+	};
+}
\ No newline at end of file
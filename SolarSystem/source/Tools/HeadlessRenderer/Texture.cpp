@@ -0,0 +1,319 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace HeadlessRenderer
+{
+	const uint32_t Texture::DDSMagic = 0x20534444;
+	const uint32_t Texture::FourCCDXT1 = 0x31545844;
+	const uint32_t Texture::FourCCDX10 = 0x30315844;
+	const uint32_t Texture::PixelFormatFourCC = 0x4;
+	const uint32_t Texture::PixelFormatRGB = 0x40;
+	const uint32_t Texture::Caps2CubeMap = 0x200;
+	const uint32_t Texture::ResourceMiscTextureCube = 0x4;
+	const uint32_t Texture::DXGIFormatR8G8B8A8UNorm = 28;
+	const uint32_t Texture::DXGIFormatBC1UNorm = 71;
+	const uint32_t Texture::DXGIFormatBC1UNormSRGB = 72;
+	const uint32_t Texture::DXGIFormatB8G8R8A8UNorm = 87;
+
+	Texture Texture::LoadDDS(const string& filename)
+	{
+		ifstream file(filename.c_str(), ios::binary);
+		if (!file.good())
+		{
+			throw runtime_error("Could not open file " + filename + ".");
+		}
+
+		vector<uint8_t> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+		if (ReadUInt32(data, 0) != DDSMagic)
+		{
+			throw runtime_error(filename + " is not a DDS file.");
+		}
+
+		Texture texture;
+		texture.mHeight = ReadUInt32(data, 12);
+		texture.mWidth = ReadUInt32(data, 16);
+		uint32_t mipCount = max(ReadUInt32(data, 28), 1u);
+		uint32_t pixelFormatFlags = ReadUInt32(data, 80);
+		uint32_t fourCC = ReadUInt32(data, 84);
+		uint32_t bitCount = ReadUInt32(data, 88);
+		uint32_t masks[4] = { ReadUInt32(data, 92), ReadUInt32(data, 96), ReadUInt32(data, 100), ReadUInt32(data, 104) };
+		texture.mFaceCount = ((ReadUInt32(data, 112) & Caps2CubeMap) != 0 ? 6 : 1);
+
+		size_t offset = 128;
+		bool isBC1 = ((pixelFormatFlags & PixelFormatFourCC) != 0 && fourCC == FourCCDXT1);
+		bool isUncompressed = ((pixelFormatFlags & PixelFormatRGB) != 0 && bitCount == 32);
+		if ((pixelFormatFlags & PixelFormatFourCC) != 0 && fourCC == FourCCDX10)
+		{
+			uint32_t format = ReadUInt32(data, 128);
+			if ((ReadUInt32(data, 136) & ResourceMiscTextureCube) != 0)
+			{
+				texture.mFaceCount = 6;
+			}
+
+			isBC1 = (format == DXGIFormatBC1UNorm || format == DXGIFormatBC1UNormSRGB);
+			isUncompressed = (format == DXGIFormatR8G8B8A8UNorm || format == DXGIFormatB8G8R8A8UNorm);
+			masks[0] = (format == DXGIFormatR8G8B8A8UNorm ? 0x000000FF : 0x00FF0000);
+			masks[1] = 0x0000FF00;
+			masks[2] = (format == DXGIFormatR8G8B8A8UNorm ? 0x00FF0000 : 0x000000FF);
+			masks[3] = 0xFF000000;
+			offset += 20;
+		}
+
+		if (isBC1 == false && isUncompressed == false)
+		{
+			throw runtime_error(filename + " uses an unsupported DDS format.");
+		}
+
+		if (texture.mWidth == 0 || texture.mHeight == 0)
+		{
+			throw runtime_error(filename + " has no texels.");
+		}
+
+		uint32_t shifts[4];
+		uint32_t maximums[4];
+		for (uint32_t channel = 0; channel < 4; ++channel)
+		{
+			MaskShift(masks[channel], shifts[channel], maximums[channel]);
+		}
+
+		size_t faceTexelCount = static_cast<size_t>(texture.mWidth) * texture.mHeight;
+		texture.mTexels.resize(faceTexelCount * texture.mFaceCount);
+		for (uint32_t face = 0; face < texture.mFaceCount; ++face)
+		{
+			uint32_t* destination = &texture.mTexels[faceTexelCount * face];
+			if (isBC1)
+			{
+				uint32_t blockColumns = (texture.mWidth + 3) / 4;
+				uint32_t blockRows = (texture.mHeight + 3) / 4;
+				if (offset + static_cast<size_t>(blockColumns) * blockRows * 8 > data.size())
+				{
+					throw runtime_error("Truncated DDS file " + filename + ".");
+				}
+
+				texture.DecodeBC1(&data[offset], destination);
+			}
+			else
+			{
+				if (offset + faceTexelCount * 4 > data.size())
+				{
+					throw runtime_error("Truncated DDS file " + filename + ".");
+				}
+
+				for (size_t i = 0; i < faceTexelCount; ++i)
+				{
+					uint32_t texel = ReadUInt32(data, offset + i * 4);
+					destination[i] = ExpandChannel(texel, shifts[0], maximums[0], 0) | (ExpandChannel(texel, shifts[1], maximums[1], 0) << 8) |
+						(ExpandChannel(texel, shifts[2], maximums[2], 0) << 16) | (ExpandChannel(texel, shifts[3], maximums[3], 255) << 24);
+				}
+			}
+
+			// Skip the rest of this face's mip chain
+			uint32_t mipWidth = texture.mWidth;
+			uint32_t mipHeight = texture.mHeight;
+			for (uint32_t mip = 0; mip < mipCount; ++mip)
+			{
+				offset += (isBC1 ? static_cast<size_t>((mipWidth + 3) / 4) * ((mipHeight + 3) / 4) * 8 : static_cast<size_t>(mipWidth) * mipHeight * 4);
+				mipWidth = max(mipWidth / 2, 1u);
+				mipHeight = max(mipHeight / 2, 1u);
+			}
+		}
+
+		return texture;
+	}
+
+	uint32_t Texture::Width() const
+	{
+		return mWidth;
+	}
+
+	uint32_t Texture::Height() const
+	{
+		return mHeight;
+	}
+
+	uint32_t Texture::FaceCount() const
+	{
+		return mFaceCount;
+	}
+
+	void Texture::Sample(float u, float v, float* color) const
+	{
+		SampleFace(0, u, v, true, color);
+	}
+
+	void Texture::SampleCube(const Vector3& direction, float* color) const
+	{
+		assert(mFaceCount == 6);
+
+		// Face selection and orientation follow the Direct3D cube map layout (+X, -X, +Y, -Y, +Z, -Z).
+		float absoluteX = fabsf(direction.X);
+		float absoluteY = fabsf(direction.Y);
+		float absoluteZ = fabsf(direction.Z);
+
+		uint32_t face;
+		float s;
+		float t;
+		float majorAxis;
+		if (absoluteX >= absoluteY && absoluteX >= absoluteZ)
+		{
+			face = (direction.X >= 0.0f ? 0 : 1);
+			s = (direction.X >= 0.0f ? -direction.Z : direction.Z);
+			t = -direction.Y;
+			majorAxis = absoluteX;
+		}
+		else if (absoluteY >= absoluteZ)
+		{
+			face = (direction.Y >= 0.0f ? 2 : 3);
+			s = direction.X;
+			t = (direction.Y >= 0.0f ? direction.Z : -direction.Z);
+			majorAxis = absoluteY;
+		}
+		else
+		{
+			face = (direction.Z >= 0.0f ? 4 : 5);
+			s = (direction.Z >= 0.0f ? direction.X : -direction.X);
+			t = -direction.Y;
+			majorAxis = absoluteZ;
+		}
+
+		if (majorAxis == 0.0f)
+		{
+			majorAxis = 1.0f;
+		}
+
+		SampleFace(face, (s / majorAxis + 1.0f) * 0.5f, (t / majorAxis + 1.0f) * 0.5f, false, color);
+	}
+
+	void Texture::SampleFace(uint32_t face, float u, float v, bool wrap, float* color) const
+	{
+		assert(face < mFaceCount);
+
+		// Texel centers sit at half-texel offsets, as in Direct3D
+		float x = u * static_cast<float>(mWidth) - 0.5f;
+		float y = v * static_cast<float>(mHeight) - 0.5f;
+		float floorX = floorf(x);
+		float floorY = floorf(y);
+		float fractionX = x - floorX;
+		float fractionY = y - floorY;
+
+		int32_t columns[2] = { static_cast<int32_t>(floorX), static_cast<int32_t>(floorX) + 1 };
+		int32_t rows[2] = { static_cast<int32_t>(floorY), static_cast<int32_t>(floorY) + 1 };
+		int32_t width = static_cast<int32_t>(mWidth);
+		int32_t height = static_cast<int32_t>(mHeight);
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			if (wrap)
+			{
+				columns[i] = ((columns[i] % width) + width) % width;
+				rows[i] = ((rows[i] % height) + height) % height;
+			}
+			else
+			{
+				columns[i] = min(max(columns[i], 0), width - 1);
+				rows[i] = min(max(rows[i], 0), height - 1);
+			}
+		}
+
+		const uint32_t* texels = &mTexels[static_cast<size_t>(mWidth) * mHeight * face];
+		uint32_t samples[4] = { texels[rows[0] * width + columns[0]], texels[rows[0] * width + columns[1]], texels[rows[1] * width + columns[0]], texels[rows[1] * width + columns[1]] };
+		float weights[4] = { (1.0f - fractionX) * (1.0f - fractionY), fractionX * (1.0f - fractionY), (1.0f - fractionX) * fractionY, fractionX * fractionY };
+
+		for (uint32_t channel = 0; channel < 4; ++channel)
+		{
+			float value = 0.0f;
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				value += static_cast<float>((samples[i] >> (channel * 8)) & 0xFF) * weights[i];
+			}
+
+			color[channel] = value * (1.0f / 255.0f);
+		}
+	}
+
+	uint32_t Texture::ReadUInt32(const vector<uint8_t>& data, size_t offset)
+	{
+		if (offset + 4 > data.size())
+		{
+			throw runtime_error("Truncated DDS file.");
+		}
+
+		return static_cast<uint32_t>(data[offset]) | (static_cast<uint32_t>(data[offset + 1]) << 8) | (static_cast<uint32_t>(data[offset + 2]) << 16) | (static_cast<uint32_t>(data[offset + 3]) << 24);
+	}
+
+	void Texture::MaskShift(uint32_t mask, uint32_t& shift, uint32_t& maximum)
+	{
+		// Position of the lowest set bit and the largest value the channel holds
+		shift = 0;
+		while (mask != 0 && (mask & 1) == 0)
+		{
+			mask >>= 1;
+			++shift;
+		}
+
+		maximum = mask;
+	}
+
+	uint32_t Texture::ExpandChannel(uint32_t texel, uint32_t shift, uint32_t maximum, uint32_t defaultValue)
+	{
+		return (maximum == 0 ? defaultValue : (((texel >> shift) & maximum) * 255 + maximum / 2) / maximum);
+	}
+
+	void Texture::DecodeBC1(const uint8_t* source, uint32_t* destination) const
+	{
+		uint32_t blockColumns = (mWidth + 3) / 4;
+		uint32_t blockRows = (mHeight + 3) / 4;
+
+		for (uint32_t blockRow = 0; blockRow < blockRows; ++blockRow)
+		{
+			for (uint32_t blockColumn = 0; blockColumn < blockColumns; ++blockColumn, source += 8)
+			{
+				uint32_t endpoints[2] = { static_cast<uint32_t>(source[0] | (source[1] << 8)), static_cast<uint32_t>(source[2] | (source[3] << 8)) };
+				uint32_t palette[4][4];
+				for (uint32_t i = 0; i < 2; ++i)
+				{
+					uint32_t red = (endpoints[i] >> 11) & 0x1F;
+					uint32_t green = (endpoints[i] >> 5) & 0x3F;
+					uint32_t blue = endpoints[i] & 0x1F;
+					palette[i][0] = (red << 3) | (red >> 2);
+					palette[i][1] = (green << 2) | (green >> 4);
+					palette[i][2] = (blue << 3) | (blue >> 2);
+					palette[i][3] = 255;
+				}
+
+				// Four-color blocks when the first endpoint is larger, otherwise three colors and transparent black
+				for (uint32_t channel = 0; channel < 3; ++channel)
+				{
+					if (endpoints[0] > endpoints[1])
+					{
+						palette[2][channel] = (2 * palette[0][channel] + palette[1][channel] + 1) / 3;
+						palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel] + 1) / 3;
+					}
+					else
+					{
+						palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2;
+						palette[3][channel] = 0;
+					}
+				}
+
+				palette[2][3] = 255;
+				palette[3][3] = (endpoints[0] > endpoints[1] ? 255 : 0);
+
+				uint32_t indices = static_cast<uint32_t>(source[4]) | (static_cast<uint32_t>(source[5]) << 8) | (static_cast<uint32_t>(source[6]) << 16) | (static_cast<uint32_t>(source[7]) << 24);
+				for (uint32_t y = 0; y < 4; ++y)
+				{
+					for (uint32_t x = 0; x < 4; ++x)
+					{
+						uint32_t column = blockColumn * 4 + x;
+						uint32_t row = blockRow * 4 + y;
+						const uint32_t* entry = palette[(indices >> ((y * 4 + x) * 2)) & 0x3];
+						if (column < mWidth && row < mHeight)
+						{
+							destination[row * mWidth + column] = entry[0] | (entry[1] << 8) | (entry[2] << 16) | (entry[3] << 24);
+						}
+					}
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "VectorMath.h"
+
+namespace HeadlessRenderer
+{
+	// A decoded RGBA8 texture or cube map. Only the top mip level is kept.
+	class Texture final
+	{
+	public:
+		Texture() = default;
+		Texture(const Texture&) = delete;
+		Texture& operator=(const Texture&) = delete;
+		Texture(Texture&&) = default;
+		Texture& operator=(Texture&&) = default;
+		~Texture() = default;
+
+		// Reads BC1 (DXT1) and uncompressed 32-bit DDS files, including cube maps.
+		static Texture LoadDDS(const std::string& filename);
+
+		std::uint32_t Width() const;
+		std::uint32_t Height() const;
+		std::uint32_t FaceCount() const;
+
+		// Bilinear filtering with wrapped addressing, like SamplerStates::TrilinearWrap without the mips.
+		void Sample(float u, float v, float* color) const;
+
+		// Bilinear filtering within the face that direction points at.
+		void SampleCube(const Vector3& direction, float* color) const;
+
+	private:
+		void SampleFace(std::uint32_t face, float u, float v, bool wrap, float* color) const;
+		void DecodeBC1(const std::uint8_t* source, std::uint32_t* destination) const;
+		static std::uint32_t ReadUInt32(const std::vector<std::uint8_t>& data, std::size_t offset);
+		static void MaskShift(std::uint32_t mask, std::uint32_t& shift, std::uint32_t& maximum);
+		static std::uint32_t ExpandChannel(std::uint32_t texel, std::uint32_t shift, std::uint32_t maximum, std::uint32_t defaultValue);
+
+		static const std::uint32_t DDSMagic;
+		static const std::uint32_t FourCCDXT1;
+		static const std::uint32_t FourCCDX10;
+		static const std::uint32_t PixelFormatFourCC;
+		static const std::uint32_t PixelFormatRGB;
+		static const std::uint32_t Caps2CubeMap;
+		static const std::uint32_t ResourceMiscTextureCube;
+		static const std::uint32_t DXGIFormatR8G8B8A8UNorm;
+		static const std::uint32_t DXGIFormatBC1UNorm;
+		static const std::uint32_t DXGIFormatBC1UNormSRGB;
+		static const std::uint32_t DXGIFormatB8G8R8A8UNorm;
+
+		std::uint32_t mWidth = 0;
+		std::uint32_t mHeight = 0;
+		std::uint32_t mFaceCount = 0;
+		std::vector<std::uint32_t> mTexels;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "pch.h"
+
+using namespace std;
+
+namespace HeadlessRenderer
+{
+	Matrix Matrix::Identity()
+	{
+		return Scaling(1.0f, 1.0f, 1.0f);
+	}
+
+	Matrix Matrix::Scaling(float x, float y, float z)
+	{
+		Matrix matrix = { { { x, 0.0f, 0.0f, 0.0f }, { 0.0f, y, 0.0f, 0.0f }, { 0.0f, 0.0f, z, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } } };
+		return matrix;
+	}
+
+	Matrix Matrix::Translation(float x, float y, float z)
+	{
+		Matrix matrix = Identity();
+		matrix.M[3][0] = x;
+		matrix.M[3][1] = y;
+		matrix.M[3][2] = z;
+
+		return matrix;
+	}
+
+	Matrix Matrix::RotationY(float angle)
+	{
+		float sine = sinf(angle);
+		float cosine = cosf(angle);
+
+		Matrix matrix = { { { cosine, 0.0f, -sine, 0.0f }, { 0.0f, 1.0f, 0.0f, 0.0f }, { sine, 0.0f, cosine, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } } };
+		return matrix;
+	}
+
+	Matrix Matrix::RotationZ(float angle)
+	{
+		float sine = sinf(angle);
+		float cosine = cosf(angle);
+
+		Matrix matrix = { { { cosine, sine, 0.0f, 0.0f }, { -sine, cosine, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } } };
+		return matrix;
+	}
+
+	Matrix Matrix::AffineTransformation(float scale, const float rotation[4], const float translation[3])
+	{
+		// Same construction as XMMatrixAffineTransformation with a uniform scale, no rotation origin and a unit quaternion
+		const float x = rotation[0];
+		const float y = rotation[1];
+		const float z = rotation[2];
+		const float w = rotation[3];
+
+		Matrix matrix = { {
+			{ scale * (1.0f - 2.0f * (y * y + z * z)), scale * 2.0f * (x * y + z * w), scale * 2.0f * (x * z - y * w), 0.0f },
+			{ scale * 2.0f * (x * y - z * w), scale * (1.0f - 2.0f * (x * x + z * z)), scale * 2.0f * (y * z + x * w), 0.0f },
+			{ scale * 2.0f * (x * z + y * w), scale * 2.0f * (y * z - x * w), scale * (1.0f - 2.0f * (x * x + y * y)), 0.0f },
+			{ translation[0], translation[1], translation[2], 1.0f } } };
+		return matrix;
+	}
+
+	Matrix Matrix::LookToRH(const Vector3& position, const Vector3& direction, const Vector3& up)
+	{
+		// Same construction as XMMatrixLookToRH
+		Vector3 zAxis = Normalize(direction * -1.0f);
+		Vector3 xAxis = Normalize(Cross(up, zAxis));
+		Vector3 yAxis = Cross(zAxis, xAxis);
+
+		Matrix matrix = { {
+			{ xAxis.X, yAxis.X, zAxis.X, 0.0f },
+			{ xAxis.Y, yAxis.Y, zAxis.Y, 0.0f },
+			{ xAxis.Z, yAxis.Z, zAxis.Z, 0.0f },
+			{ -Dot(xAxis, position), -Dot(yAxis, position), -Dot(zAxis, position), 1.0f } } };
+		return matrix;
+	}
+
+	Matrix Matrix::PerspectiveFovRH(float fieldOfView, float aspectRatio, float nearPlaneDistance, float farPlaneDistance)
+	{
+		// Same construction as XMMatrixPerspectiveFovRH; depth maps to [0, 1]
+		float yScale = 1.0f / tanf(fieldOfView * 0.5f);
+		float xScale = yScale / aspectRatio;
+		float range = farPlaneDistance / (nearPlaneDistance - farPlaneDistance);
+
+		Matrix matrix = { {
+			{ xScale, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, yScale, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, range, -1.0f },
+			{ 0.0f, 0.0f, range * nearPlaneDistance, 0.0f } } };
+		return matrix;
+	}
+
+	Matrix operator*(const Matrix& lhs, const Matrix& rhs)
+	{
+		Matrix result;
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				result.M[row][column] = lhs.M[row][0] * rhs.M[0][column] + lhs.M[row][1] * rhs.M[1][column] + lhs.M[row][2] * rhs.M[2][column] + lhs.M[row][3] * rhs.M[3][column];
+			}
+		}
+
+		return result;
+	}
+
+	Vector4 TransformPoint(const Vector3& position, const Matrix& matrix)
+	{
+		const float (*m)[4] = matrix.M;
+		return Vector4(position.X * m[0][0] + position.Y * m[1][0] + position.Z * m[2][0] + m[3][0],
+			position.X * m[0][1] + position.Y * m[1][1] + position.Z * m[2][1] + m[3][1],
+			position.X * m[0][2] + position.Y * m[1][2] + position.Z * m[2][2] + m[3][2],
+			position.X * m[0][3] + position.Y * m[1][3] + position.Z * m[2][3] + m[3][3]);
+	}
+
+	Vector3 TransformNormal(const Vector3& normal, const Matrix& matrix)
+	{
+		const float (*m)[4] = matrix.M;
+		return Vector3(normal.X * m[0][0] + normal.Y * m[1][0] + normal.Z * m[2][0],
+			normal.X * m[0][1] + normal.Y * m[1][1] + normal.Z * m[2][1],
+			normal.X * m[0][2] + normal.Y * m[1][2] + normal.Z * m[2][2]);
+	}
+}
\ No newline at end of file
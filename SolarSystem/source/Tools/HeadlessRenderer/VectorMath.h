@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cmath>
+
+namespace HeadlessRenderer
+{
+	struct Vector2
+	{
+		float X;
+		float Y;
+
+		Vector2() :
+			X(0.0f), Y(0.0f) { }
+
+		Vector2(float x, float y) :
+			X(x), Y(y) { }
+	};
+
+	struct Vector3
+	{
+		float X;
+		float Y;
+		float Z;
+
+		Vector3() :
+			X(0.0f), Y(0.0f), Z(0.0f) { }
+
+		Vector3(float x, float y, float z) :
+			X(x), Y(y), Z(z) { }
+	};
+
+	struct Vector4
+	{
+		float X;
+		float Y;
+		float Z;
+		float W;
+
+		Vector4() :
+			X(0.0f), Y(0.0f), Z(0.0f), W(0.0f) { }
+
+		Vector4(float x, float y, float z, float w) :
+			X(x), Y(y), Z(z), W(w) { }
+	};
+
+	// Row-major and applied to row vectors, matching the DirectXMath conventions of the game.
+	struct Matrix
+	{
+		float M[4][4];
+
+		static Matrix Identity();
+		static Matrix Scaling(float x, float y, float z);
+		static Matrix Translation(float x, float y, float z);
+		static Matrix RotationY(float angle);
+		static Matrix RotationZ(float angle);
+		static Matrix AffineTransformation(float scale, const float rotation[4], const float translation[3]);
+		static Matrix LookToRH(const Vector3& position, const Vector3& direction, const Vector3& up);
+		static Matrix PerspectiveFovRH(float fieldOfView, float aspectRatio, float nearPlaneDistance, float farPlaneDistance);
+	};
+
+	Matrix operator*(const Matrix& lhs, const Matrix& rhs);
+
+	inline Vector3 operator+(const Vector3& lhs, const Vector3& rhs)
+	{
+		return Vector3(lhs.X + rhs.X, lhs.Y + rhs.Y, lhs.Z + rhs.Z);
+	}
+
+	inline Vector3 operator-(const Vector3& lhs, const Vector3& rhs)
+	{
+		return Vector3(lhs.X - rhs.X, lhs.Y - rhs.Y, lhs.Z - rhs.Z);
+	}
+
+	inline Vector3 operator*(const Vector3& lhs, float rhs)
+	{
+		return Vector3(lhs.X * rhs, lhs.Y * rhs, lhs.Z * rhs);
+	}
+
+	inline float Dot(const Vector3& lhs, const Vector3& rhs)
+	{
+		return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z;
+	}
+
+	inline Vector3 Cross(const Vector3& lhs, const Vector3& rhs)
+	{
+		return Vector3(lhs.Y * rhs.Z - lhs.Z * rhs.Y, lhs.Z * rhs.X - lhs.X * rhs.Z, lhs.X * rhs.Y - lhs.Y * rhs.X);
+	}
+
+	inline float Length(const Vector3& value)
+	{
+		return sqrtf(Dot(value, value));
+	}
+
+	inline Vector3 Normalize(const Vector3& value)
+	{
+		float length = Length(value);
+		return (length > 0.0f ? value * (1.0f / length) : value);
+	}
+
+	inline float Saturate(float value)
+	{
+		return (value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value));
+	}
+
+	// Transforms (x, y, z, 1).
+	Vector4 TransformPoint(const Vector3& position, const Matrix& matrix);
+
+	// Transforms (x, y, z, 0), i.e. ignores the translation.
+	Vector3 TransformNormal(const Vector3& normal, const Matrix& matrix);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+// Only the standard library is used so that this tool also builds without the Windows SDK, e.g. with
+// g++ -std=c++14 -O2 -pthread -DLIBRARY_PORTABLE -I../../Library.Shared *.cpp ../../Library.Shared/{GameException,AllocationCounter,FrameStatistics,Benchmark,CameraPath,SolarSystemBodies}.cpp -o HeadlessRenderer
+// The Library.Shared sources are the game's own standard-library-only ones, built through the library's portable pch.h.
+
+// Standard
+#include <memory>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <map>
+#include <numeric>
+#include <new>
+#include <cstdlib>
+#include <cerrno>
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#if defined(DEBUG) || defined(_DEBUG)
+#define _CRTDBG_MAP_ALLOC
+#include <stdlib.h>
+#include <crtdbg.h>
+#endif
+
+// Library
+#include "GameException.h"
+#include "AllocationCounter.h"
+#include "FrameStatistics.h"
+#include "CameraPath.h"
+#include "SolarSystemBodies.h"
+#include "Benchmark.h"
+
+// Local
+#include "VectorMath.h"
+#include "RenderTarget.h"
+#include "Texture.h"
+#include "ModelReader.h"
+#include "SoftwareRasterizer.h"
+#include "Shaders.h"
+#include "HeadlessSolarSystem.h"
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+static uint32_t sHandlerCallCount = 0;
+
+// Stored where the compiler can't see it unused, so it can't leave out the allocation.
+static char* volatile sAllocation = nullptr;
+
+// Gives up after three calls, as a handler that runs out of memory to release would.
+static void ReleasingHandler()
+{
+	if (++sHandlerCallCount == 3)
+	{
+		set_new_handler(nullptr);
+	}
+}
+
+static void ThrowingHandler()
+{
+	++sHandlerCallCount;
+	throw bad_alloc();
+}
+
+// Too large for any allocator, so every attempt fails. Read at run time so the compiler doesn't reject the calls.
+static size_t ImpossibleSize()
+{
+	volatile size_t size = numeric_limits<size_t>::max() - 16;
+	return size;
+}
+
+TEST_CASE(AllocationsAreCountedAndTagged)
+{
+	const uint64_t allocationCount = AllocationCounter::AllocationCount();
+	const uint64_t allocatedBytes = AllocationCounter::AllocatedBytes();
+	const AllocationCounter::Statistics before = AllocationCounter::TagStatistics(MemoryTag::Simulation);
+
+	{
+		MemoryTagScope tag(MemoryTag::Simulation);
+		CHECK(AllocationCounter::CurrentTag() == MemoryTag::Simulation);
+		sAllocation = new char[1000];
+	}
+	CHECK(AllocationCounter::CurrentTag() == MemoryTag::Untagged);
+
+	CHECK_EQUAL(allocationCount + 1, AllocationCounter::AllocationCount());
+	CHECK_EQUAL(allocatedBytes + 1000, AllocationCounter::AllocatedBytes());
+	const AllocationCounter::Statistics during = AllocationCounter::TagStatistics(MemoryTag::Simulation);
+	CHECK_EQUAL(before.LiveCount + 1, during.LiveCount);
+	CHECK_EQUAL(before.LiveBytes + 1000, during.LiveBytes);
+
+	// Freed outside the scope, but charged back to the tag that allocated.
+	delete[] sAllocation;
+	const AllocationCounter::Statistics after = AllocationCounter::TagStatistics(MemoryTag::Simulation);
+	CHECK_EQUAL(before.LiveCount, after.LiveCount);
+	CHECK_EQUAL(before.LiveBytes, after.LiveBytes);
+	CHECK(after.HighWaterBytes >= before.LiveBytes + 1000);
+}
+
+TEST_CASE(FailedAllocationsCallTheNewHandlerUntilItGivesUp)
+{
+	sHandlerCallCount = 0;
+	set_new_handler(ReleasingHandler);
+	bool threw = false;
+	try
+	{
+		::operator new(ImpossibleSize());
+	}
+	catch (const bad_alloc&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK_EQUAL(3U, sHandlerCallCount);
+	CHECK(get_new_handler() == nullptr);
+
+	// Without a handler, the first failure throws.
+	threw = false;
+	try
+	{
+		::operator new[](ImpossibleSize());
+	}
+	catch (const bad_alloc&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK_EQUAL(3U, sHandlerCallCount);
+}
+
+TEST_CASE(NothrowAllocationsReturnNullWhenTheHandlerGivesUp)
+{
+	sHandlerCallCount = 0;
+	set_new_handler(ThrowingHandler);
+	CHECK(::operator new(ImpossibleSize(), nothrow) == nullptr);
+	CHECK(::operator new[](ImpossibleSize(), nothrow) == nullptr);
+	CHECK_EQUAL(2U, sHandlerCallCount);
+
+	set_new_handler(nullptr);
+	CHECK(::operator new(ImpossibleSize(), nothrow) == nullptr);
+	CHECK_EQUAL(2U, sHandlerCallCount);
+
+	void* memory = ::operator new(16, nothrow);
+	CHECK(memory != nullptr);
+	::operator delete(memory, nothrow);
+}
\ No newline at end of file
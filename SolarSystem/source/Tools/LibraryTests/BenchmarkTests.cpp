@@ -0,0 +1,115 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace Library;
+
+static uint32_t CountOccurrences(const string& text, const string& pattern)
+{
+	uint32_t count = 0;
+	for (size_t position = text.find(pattern); position != string::npos; position = text.find(pattern, position + 1))
+	{
+		++count;
+	}
+
+	return count;
+}
+
+TEST_CASE(WarmupFramesAreNotRecorded)
+{
+	Benchmark benchmark("Single", 5, 3);
+	const uint32_t phase = benchmark.AddPhase("Update");
+	CHECK_EQUAL(1U, benchmark.SegmentCount());
+
+	uint32_t framesRun = 0;
+	while (benchmark.BeginFrame())
+	{
+		CHECK_EQUAL(framesRun, benchmark.SegmentFrameIndex());
+		CHECK_EQUAL(0U, benchmark.CurrentSegment());
+		CHECK_EQUAL(framesRun > 3 ? framesRun - 3 : 0, benchmark.RecordedFrameCount());
+		benchmark.AddPhaseTime(phase, milliseconds(framesRun), 1);
+		++framesRun;
+	}
+
+	CHECK_EQUAL(8U, framesRun);
+	CHECK(benchmark.IsComplete());
+	CHECK_EQUAL(5U, benchmark.RecordedFrameCount());
+	CHECK_EQUAL(uint64_t(5), benchmark.FrameTimes().CurrentSummary().FrameCount);
+	CHECK(benchmark.BeginFrame() == false);
+
+	// Phase times of frames 3 to 7 only.
+	ostringstream stream;
+	benchmark.WriteJson(stream);
+	const string report = stream.str();
+	CHECK(report.find("\"frames\": 5,") != string::npos);
+	CHECK(report.find("\"warmupFrames\": 3,") != string::npos);
+	CHECK(report.find("{ \"name\": \"Update\", \"totalMilliseconds\": 25, \"meanMilliseconds\": 5,") != string::npos);
+	CHECK(report.find("\"allocations\": 5, \"allocationsPerFrame\": 1 }") != string::npos);
+	CHECK(report.find("\"segments\"") == string::npos);
+	CHECK(report.back() == '\n');
+}
+
+TEST_CASE(SegmentsEachRecordTheFrameCountAfterTheirOwnWarmup)
+{
+	Benchmark benchmark("Segmented", 4, 2, vector<string>({ "Pipelined", "Serial" }));
+	const uint32_t phase = benchmark.AddPhase("Update");
+	CHECK_EQUAL(2U, benchmark.SegmentCount());
+
+	vector<uint32_t> segments;
+	vector<uint32_t> segmentFrameIndices;
+	while (benchmark.BeginFrame())
+	{
+		segments.push_back(benchmark.CurrentSegment());
+		segmentFrameIndices.push_back(benchmark.SegmentFrameIndex());
+
+		// The serial segment's frames take three times as long.
+		benchmark.AddPhaseTime(phase, milliseconds(benchmark.CurrentSegment() == 0 ? 1 : 3), 0);
+	}
+
+	CHECK(segments == vector<uint32_t>({ 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1 }));
+	CHECK(segmentFrameIndices == vector<uint32_t>({ 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5 }));
+	CHECK(benchmark.IsComplete());
+	CHECK_EQUAL(8U, benchmark.RecordedFrameCount());
+	CHECK_EQUAL(uint64_t(8), benchmark.FrameTimes().CurrentSummary().FrameCount);
+
+	ostringstream stream;
+	benchmark.WriteJson(stream);
+	const string report = stream.str();
+	CHECK(report.find("\"frames\": 8,") != string::npos);
+	CHECK(report.find("{ \"name\": \"Update\", \"totalMilliseconds\": 16,") != string::npos);
+	CHECK(report.find("\"segments\": [") != string::npos);
+	CHECK(report.find("{ \"name\": \"Pipelined\", \"frames\": 4,") != string::npos);
+	CHECK(report.find("{ \"name\": \"Serial\", \"frames\": 4,") != string::npos);
+	CHECK(report.find("{ \"name\": \"Update\", \"totalMilliseconds\": 4, \"meanMilliseconds\": 1,") != string::npos);
+	CHECK(report.find("{ \"name\": \"Update\", \"totalMilliseconds\": 12, \"meanMilliseconds\": 3,") != string::npos);
+	CHECK_EQUAL(2U, CountOccurrences(report, "\"frameTime\": { \"totalMilliseconds\""));
+	CHECK(report.find("\"Pipelined\"") < report.find("\"Serial\""));
+	CHECK(report.find("\n  ]\n}\n") != string::npos);
+}
+
+TEST_CASE(PhaseScopesAddUpWithinAFrame)
+{
+	Benchmark benchmark("Scopes", 1, 0);
+	const uint32_t phase = benchmark.AddPhase("Draw");
+	CHECK(benchmark.BeginFrame());
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		BenchmarkPhaseScope scope(&benchmark, phase);
+		this_thread::sleep_for(milliseconds(2));
+	}
+	{
+		BenchmarkPhaseScope ignored(nullptr, phase);
+	}
+	CHECK(benchmark.BeginFrame() == false);
+
+	ostringstream stream;
+	benchmark.WriteJson(stream);
+	const string report = stream.str();
+	const size_t totalPosition = report.find("{ \"name\": \"Draw\", \"totalMilliseconds\": ");
+	CHECK(totalPosition != string::npos);
+	if (totalPosition != string::npos)
+	{
+		const double total = atof(report.c_str() + totalPosition + strlen("{ \"name\": \"Draw\", \"totalMilliseconds\": "));
+		CHECK(total >= 6.0);
+	}
+}
\ No newline at end of file
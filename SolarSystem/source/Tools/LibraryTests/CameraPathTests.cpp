@@ -0,0 +1,141 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+static const char* const TestPath =
+	"# seconds  position  target\n"
+	"0  0 0 0   0 0 1\n"
+	"\n"
+	"2  2 0 0   2 0 1   # straight along x\n"
+	"4  4 0 0   4 0 1\n"
+	"6  6 0 0   6 0 1\n"
+	"8  8 2 0   8 0 1\n";
+
+static CameraPath LoadPath(const string& text)
+{
+	istringstream stream(text);
+	CameraPath path;
+	path.Load(stream);
+
+	return path;
+}
+
+static bool LoadThrows(const string& text)
+{
+	try
+	{
+		LoadPath(text);
+	}
+	catch (const GameException&)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+TEST_CASE(LoadSkipsCommentsAndBlankLines)
+{
+	CameraPath path = LoadPath(TestPath);
+	const vector<CameraPath::Keyframe>& keyframes = path.Keyframes();
+	CHECK_EQUAL(size_t(5), keyframes.size());
+	CHECK_EQUAL(8.0f, path.Duration());
+	CHECK_EQUAL(2.0f, keyframes[1].Time);
+	CHECK_EQUAL(2.0f, keyframes[1].Position.X);
+	CHECK_EQUAL(1.0f, keyframes[1].Target.Z);
+	CHECK_EQUAL(2.0f, keyframes[4].Position.Y);
+
+	CHECK_EQUAL(0.0f, CameraPath().Duration());
+}
+
+TEST_CASE(MalformedPathsThrow)
+{
+	CHECK(LoadThrows("0  0 0 0   0 0\n"));
+	CHECK(LoadThrows("0  0 0 0   0 0 1 7\n"));
+	CHECK(LoadThrows("0  0 0 x   0 0 1\n"));
+	CHECK(LoadThrows("1  0 0 0   0 0 1\n1  0 0 0   0 0 1\n"));
+	CHECK(LoadThrows("2  0 0 0   0 0 1\n1  0 0 0   0 0 1\n"));
+	CHECK(LoadThrows("0  0 0 0   0 0 1\r\n1  0 0 0   0 0 1   \r\n") == false);
+
+	bool threw = false;
+	try
+	{
+		CameraPath path("Missing.path");
+	}
+	catch (const GameException&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+}
+
+TEST_CASE(EvaluatePassesThroughKeyframesAndHoldsTheEnds)
+{
+	CameraPath path = LoadPath(TestPath);
+	CameraPath::Point position;
+	CameraPath::Point target;
+	for (const CameraPath::Keyframe& keyframe : path.Keyframes())
+	{
+		path.Evaluate(keyframe.Time, position, target);
+		CHECK_NEAR(keyframe.Position.X, position.X, 1e-6);
+		CHECK_NEAR(keyframe.Position.Y, position.Y, 1e-6);
+		CHECK_NEAR(keyframe.Target.Z, target.Z, 1e-6);
+	}
+
+	path.Evaluate(-1.0f, position, target);
+	CHECK_EQUAL(0.0f, position.X);
+	path.Evaluate(100.0f, position, target);
+	CHECK_EQUAL(8.0f, position.X);
+	CHECK_EQUAL(2.0f, position.Y);
+
+	// Evenly spaced collinear neighbours make the middle segment a straight line.
+	path.Evaluate(3.0f, position, target);
+	CHECK_NEAR(3.0, position.X, 1e-6);
+	CHECK_NEAR(0.0, position.Y, 1e-6);
+	CHECK_NEAR(3.0, target.X, 1e-6);
+
+	CameraPath single;
+	single.AddKeyframe(CameraPath::Keyframe(5.0f, CameraPath::Point(1.0f, 2.0f, 3.0f), CameraPath::Point()));
+	single.Evaluate(7.0f, position, target);
+	CHECK_EQUAL(3.0f, position.Z);
+}
+
+#if defined(LIBRARY_DIRECTXMATH)
+TEST_CASE(SplinesMatchXMVectorCatmullRom)
+{
+	using namespace DirectX;
+
+	mt19937 generator(3);
+	uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+	CameraPath path;
+	for (uint32_t i = 0; i < 8; ++i)
+	{
+		path.AddKeyframe(CameraPath::Keyframe(i * 1.5f, CameraPath::Point(coordinate(generator), coordinate(generator), coordinate(generator)),
+			CameraPath::Point(coordinate(generator), coordinate(generator), coordinate(generator))));
+	}
+
+	const vector<CameraPath::Keyframe>& keyframes = path.Keyframes();
+	for (uint32_t step = 0; step <= 1000; ++step)
+	{
+		const float seconds = path.Duration() * step / 1000.0f;
+		CameraPath::Point position;
+		CameraPath::Point target;
+		path.Evaluate(seconds, position, target);
+
+		size_t i = min(static_cast<size_t>(seconds / 1.5f), keyframes.size() - 2);
+		const CameraPath::Point& point0 = keyframes[i > 0 ? i - 1 : i].Position;
+		const CameraPath::Point& point1 = keyframes[i].Position;
+		const CameraPath::Point& point2 = keyframes[i + 1].Position;
+		const CameraPath::Point& point3 = keyframes[min(i + 2, keyframes.size() - 1)].Position;
+		const float t = (seconds - keyframes[i].Time) / (keyframes[i + 1].Time - keyframes[i].Time);
+
+		XMFLOAT3 expected;
+		XMStoreFloat3(&expected, XMVectorCatmullRom(XMVectorSet(point0.X, point0.Y, point0.Z, 0.0f), XMVectorSet(point1.X, point1.Y, point1.Z, 0.0f),
+			XMVectorSet(point2.X, point2.Y, point2.Z, 0.0f), XMVectorSet(point3.X, point3.Y, point3.Z, 0.0f), t));
+		CHECK_NEAR(expected.x, position.X, 1e-3);
+		CHECK_NEAR(expected.y, position.Y, 1e-3);
+		CHECK_NEAR(expected.z, position.Z, 1e-3);
+	}
+}
+#endif
\ No newline at end of file
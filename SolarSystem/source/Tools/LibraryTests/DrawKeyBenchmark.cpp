@@ -0,0 +1,81 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace Library;
+
+// Usage: DrawKeyBenchmark [draws] [repetitions]
+// Sorts a frame's worth of draw keys with DrawKeySorter, std::sort and std::stable_sort, for keys spread over every field and
+// for keys that only differ in depth (one material, as with the instanced bodies), and reports the best time of each.
+
+static void CreateKeys(vector<DrawKeyEntry>& entries, uint32_t count, bool depthOnly)
+{
+	mt19937 generator(1);
+	entries.clear();
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const uint32_t depth = generator() % (1U << DrawKey::DepthBits);
+		if (depthOnly)
+		{
+			entries.emplace_back(DrawKey::Encode(RenderLayer::Opaque, 3, 17, 42, depth), i);
+		}
+		else
+		{
+			entries.emplace_back(DrawKey::Encode(static_cast<RenderLayer>(generator() % 4), generator() % 64, generator() % 256, generator() % 1024, depth), i);
+		}
+	}
+}
+
+template <typename TSort>
+static double BestMicroseconds(const vector<DrawKeyEntry>& keys, uint32_t repetitions, TSort sort)
+{
+	vector<DrawKeyEntry> entries;
+	double best = numeric_limits<double>::max();
+	for (uint32_t i = 0; i < repetitions; ++i)
+	{
+		entries = keys;
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		sort(entries);
+		best = min(best, duration<double, micro>(high_resolution_clock::now() - startTime).count());
+	}
+
+	return best;
+}
+
+static void Run(const char* name, uint32_t drawCount, uint32_t repetitions, bool depthOnly)
+{
+	vector<DrawKeyEntry> keys;
+	CreateKeys(keys, drawCount, depthOnly);
+
+	DrawKeySorter sorter;
+	const double radix = BestMicroseconds(keys, repetitions, [&sorter](vector<DrawKeyEntry>& entries) { sorter.Sort(entries); });
+	const double sorted = BestMicroseconds(keys, repetitions, [](vector<DrawKeyEntry>& entries)
+	{
+		sort(entries.begin(), entries.end(), [](const DrawKeyEntry& lhs, const DrawKeyEntry& rhs) { return lhs.Key < rhs.Key; });
+	});
+	const double stableSorted = BestMicroseconds(keys, repetitions, [](vector<DrawKeyEntry>& entries)
+	{
+		stable_sort(entries.begin(), entries.end(), [](const DrawKeyEntry& lhs, const DrawKeyEntry& rhs) { return lhs.Key < rhs.Key; });
+	});
+
+	cout << left << setw(16) << name << right << fixed << setprecision(1) << setw(12) << radix << setw(8) << sorter.PassCount()
+		<< setw(12) << sorted << setw(14) << stableSorted << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t drawCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 10000);
+	const uint32_t repetitions = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 50);
+	if (drawCount == 0 || repetitions == 0)
+	{
+		cerr << "Usage: DrawKeyBenchmark [draws] [repetitions]" << endl;
+		return 1;
+	}
+
+	cout << drawCount << " draws, best of " << repetitions << "; times in microseconds" << endl;
+	cout << left << setw(16) << "" << right << setw(12) << "radix" << setw(8) << "passes" << setw(12) << "std::sort" << setw(14) << "stable_sort" << endl;
+	Run("Every field", drawCount, repetitions, false);
+	Run("Depth only", drawCount, repetitions, true);
+
+	return 0;
+}
\ No newline at end of file
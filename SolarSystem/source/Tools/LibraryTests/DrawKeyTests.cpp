@@ -0,0 +1,124 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+TEST_CASE(EncodedFieldsDecode)
+{
+	mt19937 generator(1);
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		const RenderLayer layer = static_cast<RenderLayer>(generator() % 4);
+		const uint32_t shader = generator() % (1U << DrawKey::ShaderBits);
+		const uint32_t material = generator() % (1U << DrawKey::MaterialBits);
+		const uint32_t texture = generator() % (1U << DrawKey::TextureBits);
+		const uint32_t depth = generator() % (1U << DrawKey::DepthBits);
+
+		const uint64_t key = DrawKey::Encode(layer, shader, material, texture, depth);
+		CHECK(DrawKey::Layer(key) == layer);
+		CHECK_EQUAL(shader, DrawKey::Shader(key));
+		CHECK_EQUAL(material, DrawKey::Material(key));
+		CHECK_EQUAL(texture, DrawKey::Texture(key));
+		CHECK_EQUAL((layer == RenderLayer::Transparent ? (1U << DrawKey::DepthBits) - 1 - depth : depth), DrawKey::Depth(key));
+	}
+
+	CHECK_EQUAL(64U, DrawKey::LayerBits + DrawKey::ShaderBits + DrawKey::MaterialBits + DrawKey::TextureBits + DrawKey::DepthBits);
+	CHECK_EQUAL(~0ULL, DrawKey::Encode(RenderLayer::Opaque, 0, 0, 0, 0) | DrawKey::Encode(static_cast<RenderLayer>(15), (1U << DrawKey::ShaderBits) - 1,
+		(1U << DrawKey::MaterialBits) - 1, (1U << DrawKey::TextureBits) - 1, (1U << DrawKey::DepthBits) - 1));
+}
+
+TEST_CASE(KeysOrderByLayerShaderMaterialTextureDepth)
+{
+	const uint32_t maxDepth = (1U << DrawKey::DepthBits) - 1;
+	CHECK(DrawKey::Encode(RenderLayer::Opaque, 1023, 4095, 16383, maxDepth) < DrawKey::Encode(RenderLayer::Background, 0, 0, 0, 0));
+	CHECK(DrawKey::Encode(RenderLayer::Background, 1023, 0, 0, 0) < DrawKey::Encode(RenderLayer::Transparent, 0, 0, 0, 0));
+	CHECK(DrawKey::Encode(RenderLayer::Transparent, 1023, 0, 0, 0) < DrawKey::Encode(RenderLayer::Overlay, 0, 0, 0, 0));
+	CHECK(DrawKey::Encode(RenderLayer::Opaque, 0, 4095, 16383, maxDepth) < DrawKey::Encode(RenderLayer::Opaque, 1, 0, 0, 0));
+	CHECK(DrawKey::Encode(RenderLayer::Opaque, 5, 0, 16383, maxDepth) < DrawKey::Encode(RenderLayer::Opaque, 5, 1, 0, 0));
+	CHECK(DrawKey::Encode(RenderLayer::Opaque, 5, 7, 0, maxDepth) < DrawKey::Encode(RenderLayer::Opaque, 5, 7, 1, 0));
+	CHECK(DrawKey::Encode(RenderLayer::Opaque, 5, 7, 9, 100) < DrawKey::Encode(RenderLayer::Opaque, 5, 7, 9, 101));
+
+	// Opaque draws go front to back, transparent ones back to front.
+	CHECK(DrawKey::Encode(RenderLayer::Opaque, 0, 0, 0, DrawKey::QuantizeDepth(0.1f)) < DrawKey::Encode(RenderLayer::Opaque, 0, 0, 0, DrawKey::QuantizeDepth(0.9f)));
+	CHECK(DrawKey::Encode(RenderLayer::Transparent, 0, 0, 0, DrawKey::QuantizeDepth(0.9f)) < DrawKey::Encode(RenderLayer::Transparent, 0, 0, 0, DrawKey::QuantizeDepth(0.1f)));
+}
+
+TEST_CASE(QuantizedDepthIsClampedAndRounded)
+{
+	const uint32_t maxDepth = (1U << DrawKey::DepthBits) - 1;
+	CHECK_EQUAL(0U, DrawKey::QuantizeDepth(-1.0f));
+	CHECK_EQUAL(0U, DrawKey::QuantizeDepth(0.0f));
+	CHECK_EQUAL(maxDepth, DrawKey::QuantizeDepth(1.0f));
+	CHECK_EQUAL(maxDepth, DrawKey::QuantizeDepth(2.0f));
+	CHECK_EQUAL(static_cast<uint32_t>(maxDepth * 0.5f + 0.5f), DrawKey::QuantizeDepth(0.5f));
+
+	uint32_t previous = 0;
+	for (uint32_t i = 0; i <= 1000; ++i)
+	{
+		const uint32_t depth = DrawKey::QuantizeDepth(i / 1000.0f);
+		CHECK(depth >= previous);
+		previous = depth;
+	}
+}
+
+TEST_CASE(SortMatchesStableSort)
+{
+	mt19937_64 generator(1);
+	const uint32_t sizes[] = { 2, 3, 100, 10000 };
+	for (uint32_t size : sizes)
+	{
+		// 256 distinct keys spread over four bytes, so that stability is tested as well as order.
+		vector<DrawKeyEntry> entries;
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			entries.emplace_back(generator() & 0x0300030003000003ULL, i);
+		}
+
+		vector<DrawKeyEntry> expected(entries);
+		stable_sort(expected.begin(), expected.end(), [](const DrawKeyEntry& lhs, const DrawKeyEntry& rhs) { return lhs.Key < rhs.Key; });
+
+		DrawKeySorter sorter;
+		sorter.Sort(entries);
+		CHECK_EQUAL(expected.size(), entries.size());
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			CHECK_EQUAL(expected[i].Key, entries[i].Key);
+			CHECK_EQUAL(expected[i].Index, entries[i].Index);
+		}
+	}
+}
+
+TEST_CASE(SortSkipsBytesThatAllKeysShare)
+{
+	DrawKeySorter sorter;
+	vector<DrawKeyEntry> entries;
+	sorter.Sort(entries);
+	CHECK_EQUAL(0U, sorter.PassCount());
+
+	// The keys differ only in the low byte of the depth and the low byte of the shader.
+	const uint64_t base = DrawKey::Encode(RenderLayer::Opaque, 256, 12, 34, 0x123400);
+	for (uint32_t i = 0; i < 64; ++i)
+	{
+		entries.emplace_back(base + (63 - i), i);
+	}
+
+	sorter.Sort(entries);
+	CHECK_EQUAL(1U, sorter.PassCount());
+	CHECK_EQUAL(63U, entries.front().Index);
+	CHECK_EQUAL(0U, entries.back().Index);
+
+	entries.emplace_back(DrawKey::Encode(RenderLayer::Opaque, 257, 12, 34, 0x123400), 64);
+	sorter.Sort(entries);
+	CHECK_EQUAL(2U, sorter.PassCount());
+	CHECK_EQUAL(64U, entries.back().Index);
+
+	// Already equal keys take no passes and keep their order.
+	vector<DrawKeyEntry> equalEntries(10, DrawKeyEntry(base, 0));
+	for (uint32_t i = 0; i < 10; ++i)
+	{
+		equalEntries[i].Index = i;
+	}
+	sorter.Sort(equalEntries);
+	CHECK_EQUAL(0U, sorter.PassCount());
+	CHECK_EQUAL(9U, equalEntries.back().Index);
+}
\ No newline at end of file
@@ -0,0 +1,455 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+struct Position
+{
+	float X;
+	float Y;
+};
+
+struct Velocity
+{
+	float X;
+	float Y;
+};
+
+struct Health
+{
+	uint32_t Value;
+};
+
+struct Snapshot
+{
+	float X;
+};
+
+struct alignas(32) AlignedComponent
+{
+	float Values[8];
+};
+
+// Larger than a chunk, so every entity with it gets a chunk of its own.
+struct LargeComponent
+{
+	unsigned char Bytes[EntityWorld::ChunkSize];
+};
+
+static bool Throws(function<void()> action)
+{
+	try
+	{
+		action();
+	}
+	catch (const GameException&)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+// Walks every chunk with a Position, checking that each row agrees with GetComponent() for the entity stored in it.
+static uint32_t CheckChunks(EntityWorld& world)
+{
+	uint32_t entityCount = 0;
+	bool isConsistent = true;
+	world.ForEachChunk(EntityWorld::MaskOf<Position>(), [&](const EntityChunk& chunk)
+	{
+		isConsistent = isConsistent && chunk.Count() > 0;
+		const Position* positions = chunk.Components<Position>();
+		for (uint32_t i = 0; i < chunk.Count(); ++i)
+		{
+			isConsistent = isConsistent && world.IsAlive(chunk.Entities()[i]) && world.GetComponent<Position>(chunk.Entities()[i]) == &positions[i];
+		}
+		entityCount += chunk.Count();
+	});
+	CHECK(isConsistent);
+
+	return entityCount;
+}
+
+TEST_CASE(DestroyedHandlesStayInvalidWhenIndicesAreReused)
+{
+	EntityWorld world;
+	CHECK(world.IsAlive(Entity()) == false);
+	CHECK(Entity().IsNull());
+
+	const Entity first = world.CreateEntity(Position{ 1.0f, 2.0f });
+	const Entity second = world.CreateEntity(Position{ 3.0f, 4.0f }, Health{ 10 });
+	CHECK(first != second);
+	CHECK(first.IsNull() == false);
+	CHECK_EQUAL(2U, world.EntityCount());
+	CHECK_EQUAL(2U, world.ArchetypeCount());
+
+	world.DestroyEntity(first);
+	CHECK(world.IsAlive(first) == false);
+	CHECK(world.GetComponent<Position>(first) == nullptr);
+	CHECK_EQUAL(1U, world.EntityCount());
+
+	// Destroying twice, or a handle that was never valid, does nothing.
+	world.DestroyEntity(first);
+	world.DestroyEntity(Entity(1000, 1));
+	CHECK_EQUAL(1U, world.EntityCount());
+
+	const Entity reused = world.CreateEntity(Position{ 5.0f, 6.0f });
+	CHECK_EQUAL(first.Index, reused.Index);
+	CHECK(reused.Generation != first.Generation);
+	CHECK(world.IsAlive(reused));
+	CHECK(world.IsAlive(first) == false);
+	CHECK_EQUAL(5.0f, world.GetComponent<Position>(reused)->X);
+	CHECK_EQUAL(3.0f, world.GetComponent<Position>(second)->X);
+	CHECK_EQUAL(10U, world.GetComponent<Health>(second)->Value);
+}
+
+TEST_CASE(AddingAndRemovingComponentsKeepsTheOtherValues)
+{
+	EntityWorld world;
+	const Entity entity = world.CreateEntity(Position{ 1.0f, 2.0f });
+	const Entity bystander = world.CreateEntity(Position{ 7.0f, 8.0f });
+	CHECK(world.HasComponent<Velocity>(entity) == false);
+
+	world.AddComponent(entity, Velocity{ 3.0f, 4.0f });
+	CHECK(world.HasComponent<Velocity>(entity));
+	CHECK_EQUAL(1.0f, world.GetComponent<Position>(entity)->X);
+	CHECK_EQUAL(2.0f, world.GetComponent<Position>(entity)->Y);
+	CHECK_EQUAL(4.0f, world.GetComponent<Velocity>(entity)->Y);
+	CHECK_EQUAL(2U, world.ArchetypeCount());
+
+	// Adding a component the entity already has replaces its value in place.
+	world.AddComponent(entity, Velocity{ 5.0f, 6.0f });
+	CHECK_EQUAL(5.0f, world.GetComponent<Velocity>(entity)->X);
+	CHECK_EQUAL(2U, world.ArchetypeCount());
+
+	world.AddComponent(entity, Health{ 9 });
+	world.RemoveComponent<Velocity>(entity);
+	CHECK(world.HasComponent<Velocity>(entity) == false);
+	CHECK_EQUAL(2.0f, world.GetComponent<Position>(entity)->Y);
+	CHECK_EQUAL(9U, world.GetComponent<Health>(entity)->Value);
+	CHECK_EQUAL(4U, world.ArchetypeCount());
+
+	// Removing a component it doesn't have, or from a destroyed entity, does nothing; adding to a destroyed entity throws.
+	world.RemoveComponent<Snapshot>(entity);
+	CHECK_EQUAL(9U, world.GetComponent<Health>(entity)->Value);
+	world.DestroyEntity(entity);
+	world.RemoveComponent<Health>(entity);
+	CHECK(Throws([&]() { world.AddComponent(entity, Snapshot{ 1.0f }); }));
+
+	CHECK_EQUAL(7.0f, world.GetComponent<Position>(bystander)->X);
+	CHECK_EQUAL(1U, world.EntityCount());
+}
+
+TEST_CASE(ChunksStayPackedAsEntitiesComeAndGo)
+{
+	EntityWorld world;
+	mt19937 generator(11);
+	vector<pair<Entity, float>> live;
+	for (uint32_t i = 0; i < 5000; ++i)
+	{
+		const float x = static_cast<float>(i);
+		live.emplace_back(world.CreateEntity(Position{ x, -x }, Health{ i }), x);
+	}
+	const uint32_t fullChunkCount = world.ChunkCount();
+	CHECK(fullChunkCount > 1);
+
+	// Destroy a random half and move a random quarter of the rest to another archetype.
+	shuffle(live.begin(), live.end(), generator);
+	for (size_t i = 0; i < live.size() / 2; ++i)
+	{
+		world.DestroyEntity(live[i].first);
+	}
+	live.erase(live.begin(), live.begin() + live.size() / 2);
+	for (size_t i = 0; i < live.size() / 4; ++i)
+	{
+		world.RemoveComponent<Health>(live[i].first);
+	}
+
+	CHECK_EQUAL(static_cast<uint32_t>(live.size()), world.EntityCount());
+	CHECK_EQUAL(world.EntityCount(), CheckChunks(world));
+	CHECK(world.ChunkCount() < fullChunkCount);
+	for (size_t i = 0; i < live.size(); ++i)
+	{
+		const Position* position = world.GetComponent<Position>(live[i].first);
+		CHECK(position != nullptr && position->X == live[i].second && position->Y == -live[i].second);
+		CHECK_EQUAL(i >= live.size() / 4, world.HasComponent<Health>(live[i].first));
+	}
+
+	// Only chunks that have every requested component are visited.
+	uint32_t withHealth = 0;
+	world.ForEachChunk(EntityWorld::MaskOf<Position, Health>(), [&](const EntityChunk& chunk)
+	{
+		CHECK(chunk.Has<Health>());
+		CHECK(chunk.Has<Velocity>() == false);
+		withHealth += chunk.Count();
+	});
+	CHECK_EQUAL(static_cast<uint32_t>(live.size() - live.size() / 4), withHealth);
+
+	for (const pair<Entity, float>& entity : live)
+	{
+		world.DestroyEntity(entity.first);
+	}
+	CHECK_EQUAL(0U, world.EntityCount());
+	CHECK_EQUAL(0U, world.ChunkCount());
+}
+
+TEST_CASE(ColumnsAreAlignedAndLargeRowsGetTheirOwnChunks)
+{
+	EntityWorld world;
+	for (uint32_t i = 0; i < 100; ++i)
+	{
+		world.CreateEntity(Health{ i }, AlignedComponent{ { static_cast<float>(i) } });
+	}
+	world.ForEachChunk(EntityWorld::MaskOf<AlignedComponent>(), [&](const EntityChunk& chunk)
+	{
+		CHECK_EQUAL(uintptr_t(0), reinterpret_cast<uintptr_t>(chunk.Components<AlignedComponent>()) % alignof(AlignedComponent));
+		CHECK_EQUAL(uintptr_t(0), reinterpret_cast<uintptr_t>(chunk.Components<Health>()) % alignof(Health));
+	});
+
+	unique_ptr<LargeComponent> large = make_unique<LargeComponent>();
+	large->Bytes[EntityWorld::ChunkSize - 1] = 42;
+	const uint32_t chunkCount = world.ChunkCount();
+	const Entity first = world.CreateEntity(*large);
+	const Entity second = world.CreateEntity(*large);
+	CHECK_EQUAL(chunkCount + 2, world.ChunkCount());
+	CHECK_EQUAL(42, world.GetComponent<LargeComponent>(first)->Bytes[EntityWorld::ChunkSize - 1]);
+	CHECK_EQUAL(42, world.GetComponent<LargeComponent>(second)->Bytes[EntityWorld::ChunkSize - 1]);
+}
+
+TEST_CASE(StructuralChangesThrowWhileIterating)
+{
+	EntityWorld world;
+	const Entity entity = world.CreateEntity(Position{ 1.0f, 1.0f });
+
+	bool threw = false;
+	world.ForEachChunk(EntityWorld::MaskOf<Position>(), [&](const EntityChunk&)
+	{
+		threw = Throws([&]() { world.CreateEntity(Position{ 2.0f, 2.0f }); }) && Throws([&]() { world.DestroyEntity(entity); }) &&
+			Throws([&]() { world.AddComponent(entity, Health{ 1 }); }) && Throws([&]() { world.RemoveComponent<Position>(entity); });
+	});
+	CHECK(threw);
+
+	// An exception from the callback still ends the iteration.
+	try
+	{
+		world.ForEachChunk(EntityWorld::MaskOf<Position>(), [](const EntityChunk&) { throw runtime_error("System failed"); });
+	}
+	catch (const runtime_error&)
+	{
+	}
+	world.AddComponent(entity, Health{ 3 });
+	CHECK_EQUAL(3U, world.GetComponent<Health>(entity)->Value);
+}
+
+TEST_CASE(ParallelIterationVisitsEveryChunkOnce)
+{
+	EntityWorld world;
+	for (uint32_t i = 0; i < 20000; ++i)
+	{
+		if (i % 2 == 0)
+		{
+			world.CreateEntity(Position{ static_cast<float>(i), 0.0f }, Velocity{ 1.0f, 2.0f });
+		}
+		else
+		{
+			world.CreateEntity(Position{ static_cast<float>(i), 0.0f }, Velocity{ 1.0f, 2.0f }, Health{ i });
+		}
+	}
+
+	ThreadPool workers(3);
+	atomic<uint32_t> visited(0);
+	world.ParallelForEachChunk(workers, EntityWorld::MaskOf<Position, Velocity>(), [&](const EntityChunk& chunk)
+	{
+		Position* positions = chunk.Components<Position>();
+		const Velocity* velocities = chunk.Components<Velocity>();
+		for (uint32_t i = 0; i < chunk.Count(); ++i)
+		{
+			positions[i].Y += velocities[i].Y;
+		}
+		visited += chunk.Count();
+	});
+	CHECK_EQUAL(20000U, visited.load());
+
+	bool isMovedOnce = true;
+	world.ForEachChunk(EntityWorld::MaskOf<Position>(), [&](const EntityChunk& chunk)
+	{
+		const Position* positions = chunk.Components<Position>();
+		isMovedOnce = isMovedOnce && all_of(positions, positions + chunk.Count(), [](const Position& position) { return position.Y == 2.0f; });
+	});
+	CHECK(isMovedOnce);
+
+	// Failures reach the caller once every batch is done, and the world accepts changes again.
+	bool threw = false;
+	try
+	{
+		world.ParallelForEachChunk(workers, EntityWorld::MaskOf<Health>(), [](const EntityChunk&) { throw runtime_error("System failed"); });
+	}
+	catch (const runtime_error&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+	world.CreateEntity(Position{ 0.0f, 0.0f });
+	CHECK_EQUAL(20001U, world.EntityCount());
+}
+
+TEST_CASE(CommandBuffersApplyChangesInOrderAfterIteration)
+{
+	EntityWorld world;
+	EntityCommandBuffer commandBuffer;
+	CHECK(commandBuffer.IsEmpty());
+
+	vector<Entity> entities;
+	for (uint32_t i = 0; i < 100; ++i)
+	{
+		entities.push_back(world.CreateEntity(Health{ i }));
+	}
+
+	world.ForEachChunk(EntityWorld::MaskOf<Health>(), [&](const EntityChunk& chunk)
+	{
+		const Health* health = chunk.Components<Health>();
+		for (uint32_t i = 0; i < chunk.Count(); ++i)
+		{
+			if (health[i].Value % 10 == 0)
+			{
+				commandBuffer.DestroyEntity(chunk.Entities()[i]);
+			}
+			else if (health[i].Value % 10 == 1)
+			{
+				commandBuffer.AddComponent(chunk.Entities()[i], Position{ 1.0f, 0.0f });
+				commandBuffer.AddComponent(chunk.Entities()[i], Position{ 2.0f, 0.0f });
+			}
+		}
+	});
+	commandBuffer.CreateEntity(Snapshot{ 4.0f });
+
+	// Changes to an entity destroyed before playback are skipped.
+	commandBuffer.AddComponent(entities[20], Velocity{ 1.0f, 1.0f });
+	commandBuffer.RemoveComponent<Health>(entities[30]);
+	CHECK(commandBuffer.IsEmpty() == false);
+	CHECK_EQUAL(100U, world.EntityCount());
+
+	commandBuffer.Playback(world);
+	CHECK(commandBuffer.IsEmpty());
+	CHECK_EQUAL(91U, world.EntityCount());
+	CHECK(world.IsAlive(entities[20]) == false);
+	CHECK_EQUAL(2.0f, world.GetComponent<Position>(entities[41])->X);
+	CHECK(world.HasComponent<Position>(entities[42]) == false);
+
+	uint32_t snapshots = 0;
+	world.ForEachChunk(EntityWorld::MaskOf<Snapshot>(), [&](const EntityChunk& chunk) { snapshots += chunk.Count(); });
+	CHECK_EQUAL(1U, snapshots);
+
+	// Recording from several threads at once.
+	ThreadPool workers(4);
+	world.ParallelForEachChunk(workers, EntityWorld::MaskOf<Health>(), [&](const EntityChunk& chunk)
+	{
+		for (uint32_t i = 0; i < chunk.Count(); ++i)
+		{
+			commandBuffer.AddComponent(chunk.Entities()[i], Velocity{ 0.0f, 0.0f });
+		}
+	});
+	commandBuffer.Playback(world);
+	uint32_t withVelocity = 0;
+	world.ForEachChunk(EntityWorld::MaskOf<Health, Velocity>(), [&](const EntityChunk& chunk) { withVelocity += chunk.Count(); });
+	CHECK_EQUAL(90U, withVelocity);
+}
+
+TEST_CASE(SchedulerGroupsSystemsIntoWavesByConflicts)
+{
+	EntityWorld world;
+	vector<Entity> entities;
+	for (uint32_t i = 0; i < 3000; ++i)
+	{
+		const float x = static_cast<float>(i);
+		entities.push_back(world.CreateEntity(Position{ x, 0.0f }, Velocity{ 1.0f, 0.0f }, Health{ 0 }, Snapshot{ 0.0f }));
+	}
+
+	EntitySystemScheduler scheduler;
+	EntityCommandBuffer commandBuffer;
+	scheduler.AddSystem("Move", EntityWorld::MaskOf<Velocity>(), EntityWorld::MaskOf<Position>(), [](const EntityChunk& chunk)
+	{
+		Position* positions = chunk.Components<Position>();
+		const Velocity* velocities = chunk.Components<Velocity>();
+		for (uint32_t i = 0; i < chunk.Count(); ++i)
+		{
+			positions[i].X += velocities[i].X;
+		}
+	});
+
+	// Touches none of Move's components, so it runs alongside.
+	scheduler.AddSystem("Age", 0, EntityWorld::MaskOf<Health>(), [&](const EntityChunk& chunk)
+	{
+		Health* health = chunk.Components<Health>();
+		for (uint32_t i = 0; i < chunk.Count(); ++i)
+		{
+			if (++health[i].Value == 2 && chunk.Entities()[i].Index % 100 == 0)
+			{
+				commandBuffer.DestroyEntity(chunk.Entities()[i]);
+			}
+		}
+	});
+	CHECK_EQUAL(1U, scheduler.WaveCount());
+
+	// Reads what Move writes, so it waits for Move.
+	scheduler.AddSystem("Record", EntityWorld::MaskOf<Position>(), EntityWorld::MaskOf<Snapshot>(), [](const EntityChunk& chunk)
+	{
+		const Position* positions = chunk.Components<Position>();
+		Snapshot* snapshots = chunk.Components<Snapshot>();
+		for (uint32_t i = 0; i < chunk.Count(); ++i)
+		{
+			snapshots[i].X = positions[i].X;
+		}
+	});
+	CHECK_EQUAL(2U, scheduler.WaveCount());
+
+	// Writes what Move reads, so it stays after Move, but joins Record's wave.
+	scheduler.AddSystem("Accelerate", 0, EntityWorld::MaskOf<Velocity>(), [](const EntityChunk& chunk)
+	{
+		Velocity* velocities = chunk.Components<Velocity>();
+		for (uint32_t i = 0; i < chunk.Count(); ++i)
+		{
+			velocities[i].X += 1.0f;
+		}
+	});
+	CHECK_EQUAL(4U, scheduler.SystemCount());
+	CHECK_EQUAL(2U, scheduler.WaveCount());
+
+	ThreadPool workers(4);
+	scheduler.Run(world, workers, commandBuffer);
+	scheduler.Run(world, workers, commandBuffer);
+
+	// Moved by 1 then by 2; destroyed on the second run's playback.
+	CHECK_EQUAL(2970U, world.EntityCount());
+	CHECK(commandBuffer.IsEmpty());
+	for (const Entity& entity : entities)
+	{
+		if (entity.Index % 100 == 0)
+		{
+			CHECK(world.IsAlive(entity) == false);
+			continue;
+		}
+
+		const float x = static_cast<float>(entity.Index);
+		CHECK_EQUAL(x + 3.0f, world.GetComponent<Position>(entity)->X);
+		CHECK_EQUAL(x + 3.0f, world.GetComponent<Snapshot>(entity)->X);
+		CHECK_EQUAL(3.0f, world.GetComponent<Velocity>(entity)->X);
+		CHECK_EQUAL(2U, world.GetComponent<Health>(entity)->Value);
+	}
+
+	// A failing system reaches the caller and leaves the world usable.
+	EntitySystemScheduler failing;
+	failing.AddSystem("Fail", EntityWorld::MaskOf<Position>(), 0, [](const EntityChunk&) { throw runtime_error("System failed"); });
+	bool threw = false;
+	try
+	{
+		failing.Run(world, workers, commandBuffer);
+	}
+	catch (const runtime_error&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+	world.DestroyEntity(entities[1]);
+	CHECK_EQUAL(2969U, world.EntityCount());
+}
\ No newline at end of file
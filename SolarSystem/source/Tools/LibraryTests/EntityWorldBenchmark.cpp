@@ -0,0 +1,257 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace DirectX;
+using namespace Library;
+
+// Usage: EntityWorldBenchmark [largest entity count] [frames]
+// Moves orbiting bodies for a frame with the layout CelestialBodies had, each body a GameComponent behind a shared_ptr and
+// updated through a virtual call, and with the chunked EntityWorld layout the orbit system uses, once with the same per-body
+// matrix chain and once composed in batches as SceneSystems::UpdateOrbits() does. Doubles the entity count from 1000 up to
+// the largest and reports the best frame of each in nanoseconds per body, with the batched chunks' speedup over the
+// shared_ptr layout.
+
+// GameComponent's shape: a virtual update and the game and enabled state it carries.
+class BodyComponent
+{
+public:
+	BodyComponent() :
+		mGame(nullptr), mEnabled(true) { }
+
+	virtual ~BodyComponent() = default;
+	virtual void Update(float elapsedSeconds) = 0;
+
+protected:
+	void* mGame;
+	bool mEnabled;
+};
+
+// CelestialBodies' update state and its matrix chain.
+class OrbitingBodyComponent final : public BodyComponent
+{
+public:
+	OrbitingBodyComponent(float orbitalDistance, float scale, float orbitalPeriod, float rotationalPeriod, float axialTilt) :
+		mOrbitalDistance(orbitalDistance), mScale(scale), mOrbitalPeriod(orbitalPeriod), mRotationalPeriod(rotationalPeriod), mAxialTilt(axialTilt),
+		mAxialDisplacement(0.0f), mOrbitalDisplacement(0.0f)
+	{
+		XMStoreFloat4x4(&mLocalMatrix, XMMatrixIdentity());
+		mWorldMatrix = mLocalMatrix;
+	}
+
+	virtual void Update(float elapsedSeconds) override
+	{
+		mAxialDisplacement += elapsedSeconds * (1 / mRotationalPeriod) * RotationalSpeedFactor;
+		mOrbitalDisplacement += elapsedSeconds * (1 / mOrbitalPeriod) * OrbitalSpeedFactor;
+
+		XMStoreFloat4x4(&mLocalMatrix, XMMatrixScaling(mScale, mScale, mScale) * XMMatrixRotationY(mAxialDisplacement) * XMMatrixRotationZ(mAxialTilt) *
+			XMMatrixTranslation(0.0f, 0.0f, mOrbitalDistance) * XMMatrixRotationY(mOrbitalDisplacement));
+		mWorldMatrix = mLocalMatrix;
+	}
+
+	const XMFLOAT4X4& WorldMatrix() const
+	{
+		return mWorldMatrix;
+	}
+
+private:
+	static const float OrbitalSpeedFactor;
+	static const float RotationalSpeedFactor;
+
+	float mOrbitalDistance;
+	float mScale;
+	float mOrbitalPeriod;
+	float mRotationalPeriod;
+	float mAxialTilt;
+	float mAxialDisplacement;
+	float mOrbitalDisplacement;
+	XMFLOAT4X4 mLocalMatrix;
+	XMFLOAT4X4 mWorldMatrix;
+};
+
+const float OrbitingBodyComponent::OrbitalSpeedFactor = 0.1f;
+const float OrbitingBodyComponent::RotationalSpeedFactor = 0.001f;
+
+// Lesson5.4's OrbitComponent and TransformComponent (see SceneEntities.h).
+struct Orbit
+{
+	float OrbitalDistance;
+	float Scale;
+	float OrbitalPeriod;
+	float RotationalPeriod;
+	float AxialTilt;
+	float AxialDisplacement;
+	float OrbitalDisplacement;
+	float OrbitalSpeedFactor;
+	float RotationalSpeedFactor;
+	XMFLOAT3 Center;
+};
+
+struct Transform
+{
+	XMFLOAT4X4 LocalMatrix;
+	XMFLOAT4X4 WorldMatrix;
+};
+
+static const uint32_t OrbitBatchSize = 64;
+
+static void AdvanceOrbit(Orbit& orbit, float elapsedSeconds)
+{
+	orbit.AxialDisplacement += elapsedSeconds * (1 / orbit.RotationalPeriod) * orbit.RotationalSpeedFactor;
+	orbit.OrbitalDisplacement += elapsedSeconds * (1 / orbit.OrbitalPeriod) * orbit.OrbitalSpeedFactor;
+}
+
+static void UpdateChunk(const EntityChunk& chunk, float elapsedSeconds)
+{
+	Orbit* orbits = chunk.Components<Orbit>();
+	Transform* transforms = chunk.Components<Transform>();
+	for (uint32_t i = 0; i < chunk.Count(); ++i)
+	{
+		Orbit& orbit = orbits[i];
+		AdvanceOrbit(orbit, elapsedSeconds);
+
+		XMStoreFloat4x4(&transforms[i].LocalMatrix, XMMatrixScaling(orbit.Scale, orbit.Scale, orbit.Scale) * XMMatrixRotationY(orbit.AxialDisplacement) *
+			XMMatrixRotationZ(orbit.AxialTilt) * XMMatrixTranslation(0.0f, 0.0f, orbit.OrbitalDistance) * XMMatrixRotationY(orbit.OrbitalDisplacement));
+		transforms[i].WorldMatrix = transforms[i].LocalMatrix;
+	}
+}
+
+// SceneSystems::UpdateOrbits(): the chain as a scaling, one quaternion and a translation, composed a batch at a time.
+static void UpdateChunkInBatches(const EntityChunk& chunk, float elapsedSeconds)
+{
+	Orbit* orbits = chunk.Components<Orbit>();
+	Transform* transforms = chunk.Components<Transform>();
+
+	float scales[OrbitBatchSize];
+	float rotationX[OrbitBatchSize];
+	float rotationY[OrbitBatchSize];
+	float rotationZ[OrbitBatchSize];
+	float rotationW[OrbitBatchSize];
+	float translationX[OrbitBatchSize];
+	float translationY[OrbitBatchSize];
+	float translationZ[OrbitBatchSize];
+
+	for (uint32_t first = 0; first < chunk.Count(); first += OrbitBatchSize)
+	{
+		const uint32_t count = min(chunk.Count() - first, OrbitBatchSize);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			Orbit& orbit = orbits[first + i];
+			AdvanceOrbit(orbit, elapsedSeconds);
+
+			float axialSine;
+			float axialCosine;
+			float tiltSine;
+			float tiltCosine;
+			float orbitalSine;
+			float orbitalCosine;
+			XMScalarSinCos(&axialSine, &axialCosine, orbit.AxialDisplacement * 0.5f);
+			XMScalarSinCos(&tiltSine, &tiltCosine, orbit.AxialTilt * 0.5f);
+			XMScalarSinCos(&orbitalSine, &orbitalCosine, orbit.OrbitalDisplacement * 0.5f);
+
+			XMFLOAT4 rotation;
+			XMStoreFloat4(&rotation, XMQuaternionMultiply(XMQuaternionMultiply(XMVectorSet(0.0f, axialSine, 0.0f, axialCosine), XMVectorSet(0.0f, 0.0f, tiltSine, tiltCosine)),
+				XMVectorSet(0.0f, orbitalSine, 0.0f, orbitalCosine)));
+
+			scales[i] = orbit.Scale;
+			rotationX[i] = rotation.x;
+			rotationY[i] = rotation.y;
+			rotationZ[i] = rotation.z;
+			rotationW[i] = rotation.w;
+			translationX[i] = orbit.OrbitalDistance * 2.0f * orbitalSine * orbitalCosine;
+			translationY[i] = 0.0f;
+			translationZ[i] = orbit.OrbitalDistance * (orbitalCosine * orbitalCosine - orbitalSine * orbitalSine);
+		}
+
+		const TrsArrays local = { scales, scales, scales, rotationX, rotationY, rotationZ, rotationW, translationX, translationY, translationZ };
+		TransformKernels::ComposeTrs(local, MatrixArray(&transforms[first].LocalMatrix, sizeof(Transform)), count);
+		TransformKernels::ComposeTrs(local, MatrixArray(&transforms[first].WorldMatrix, sizeof(Transform)), count);
+	}
+}
+
+template <typename TUpdate>
+static double BestNanosecondsPerBody(uint32_t bodyCount, uint32_t frames, TUpdate update)
+{
+	double best = numeric_limits<double>::max();
+	for (uint32_t i = 0; i < frames; ++i)
+	{
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		update(1.0f / 60.0f);
+		best = min(best, duration<double, nano>(high_resolution_clock::now() - startTime).count());
+	}
+
+	return best / bodyCount;
+}
+
+static void Run(uint32_t bodyCount, uint32_t frames)
+{
+	mt19937 generator(1);
+	uniform_real_distribution<float> distance(10.0f, 1000.0f);
+	uniform_real_distribution<float> scale(0.1f, 5.0f);
+	uniform_real_distribution<float> period(0.1f, 100.0f);
+	uniform_real_distribution<float> tilt(0.0f, XM_PIDIV2);
+
+	vector<shared_ptr<BodyComponent>> components;
+	EntityWorld world;
+	Transform transform;
+	XMStoreFloat4x4(&transform.LocalMatrix, XMMatrixIdentity());
+	transform.WorldMatrix = transform.LocalMatrix;
+	for (uint32_t i = 0; i < bodyCount; ++i)
+	{
+		const Orbit orbit = { distance(generator), scale(generator), period(generator), period(generator), tilt(generator), 0.0f, 0.0f, 0.1f, 0.001f, XMFLOAT3(0.0f, 0.0f, 0.0f) };
+		components.push_back(make_shared<OrbitingBodyComponent>(orbit.OrbitalDistance, orbit.Scale, orbit.OrbitalPeriod, orbit.RotationalPeriod, orbit.AxialTilt));
+		world.CreateEntity(orbit, transform);
+	}
+
+	const double sharedPointers = BestNanosecondsPerBody(bodyCount, frames, [&components](float elapsedSeconds)
+	{
+		for (const shared_ptr<BodyComponent>& component : components)
+		{
+			component->Update(elapsedSeconds);
+		}
+	});
+
+	// Components added and removed over a game's life end up scattered through the heap; shuffling the pointers stands in for
+	// that.
+	shuffle(components.begin(), components.end(), generator);
+	const double shuffledPointers = BestNanosecondsPerBody(bodyCount, frames, [&components](float elapsedSeconds)
+	{
+		for (const shared_ptr<BodyComponent>& component : components)
+		{
+			component->Update(elapsedSeconds);
+		}
+	});
+
+	const ComponentMask mask = EntityWorld::MaskOf<Orbit, Transform>();
+	const double chunks = BestNanosecondsPerBody(bodyCount, frames, [&world, mask](float elapsedSeconds)
+	{
+		world.ForEachChunk(mask, [elapsedSeconds](const EntityChunk& chunk) { UpdateChunk(chunk, elapsedSeconds); });
+	});
+	const double batchedChunks = BestNanosecondsPerBody(bodyCount, frames, [&world, mask](float elapsedSeconds)
+	{
+		world.ForEachChunk(mask, [elapsedSeconds](const EntityChunk& chunk) { UpdateChunkInBatches(chunk, elapsedSeconds); });
+	});
+
+	cout << setw(10) << bodyCount << fixed << setprecision(1) << setw(14) << sharedPointers << setw(14) << shuffledPointers << setw(12) << chunks
+		<< setw(12) << batchedChunks << setw(10) << setprecision(2) << sharedPointers / batchedChunks << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t largestCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 1024000);
+	const uint32_t frames = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 20);
+	if (largestCount == 0 || frames == 0)
+	{
+		cerr << "Usage: EntityWorldBenchmark [largest entity count] [frames]" << endl;
+		return 1;
+	}
+
+	cout << "Best of " << frames << " frames; nanoseconds per body" << endl;
+	cout << setw(10) << "bodies" << setw(14) << "shared_ptr" << setw(14) << "shuffled" << setw(12) << "chunks" << setw(12) << "batched" << setw(10) << "speedup" << endl;
+	for (uint32_t bodyCount = min(largestCount, 1000U); bodyCount <= largestCount; bodyCount *= 2)
+	{
+		Run(bodyCount, frames);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+struct SimulatedFrame
+{
+	uint32_t Input;
+	uint32_t Result;
+	thread::id ThreadId;
+
+	SimulatedFrame() :
+		Input(0), Result(0), ThreadId() { }
+};
+
+static void Simulate(const uint32_t& input, SimulatedFrame& frame)
+{
+	if (input == numeric_limits<uint32_t>::max())
+	{
+		throw runtime_error("Simulation failed");
+	}
+
+	frame.Input = input;
+	frame.Result = input * 2;
+	frame.ThreadId = this_thread::get_id();
+}
+
+TEST_CASE(SpscQueueRoundsCapacityAndKeepsOrder)
+{
+	SpscQueue<uint32_t> queue(5);
+	CHECK_EQUAL(size_t(7), queue.Capacity());
+	CHECK(queue.IsEmpty());
+
+	uint32_t item = 99;
+	CHECK(queue.TryPop(item) == false);
+	CHECK_EQUAL(99U, item);
+
+	// Wrap around the slots a few times.
+	uint32_t next = 0;
+	uint32_t expected = 0;
+	for (uint32_t round = 0; round < 5; ++round)
+	{
+		while (queue.TryPush(next))
+		{
+			++next;
+		}
+		CHECK_EQUAL(expected + 7, next);
+
+		while (queue.TryPop(item))
+		{
+			CHECK_EQUAL(expected, item);
+			++expected;
+		}
+		CHECK(queue.IsEmpty());
+	}
+
+	CHECK_EQUAL(size_t(1), SpscQueue<uint32_t>(1).Capacity());
+}
+
+TEST_CASE(SpscQueueHandsEveryItemAcrossThreadsInOrder)
+{
+	const uint32_t itemCount = 200000;
+	SpscQueue<uint32_t> queue(16);
+	thread producer([&]()
+	{
+		for (uint32_t i = 0; i < itemCount; )
+		{
+			if (queue.TryPush(i))
+			{
+				++i;
+			}
+			else
+			{
+				this_thread::yield();
+			}
+		}
+	});
+
+	uint32_t expected = 0;
+	bool isOrdered = true;
+	while (expected < itemCount)
+	{
+		uint32_t item;
+		if (queue.TryPop(item))
+		{
+			isOrdered = isOrdered && (item == expected);
+			++expected;
+		}
+		else
+		{
+			this_thread::yield();
+		}
+	}
+	producer.join();
+
+	CHECK(isOrdered);
+	CHECK(queue.IsEmpty());
+}
+
+TEST_CASE(TripleBufferGivesTheNewestPublishedValue)
+{
+	TripleBuffer<uint32_t> buffer;
+	CHECK(buffer.HasFreshValue() == false);
+	CHECK(buffer.Acquire() == false);
+
+	buffer.WriteBuffer() = 1;
+	buffer.Publish();
+	CHECK(buffer.HasFreshValue());
+	CHECK(buffer.Acquire());
+	CHECK_EQUAL(1U, buffer.ReadBuffer());
+	CHECK(buffer.Acquire() == false);
+	CHECK_EQUAL(1U, buffer.ReadBuffer());
+
+	// Values the consumer didn't acquire in time are skipped, and the read buffer is never handed to the producer.
+	buffer.WriteBuffer() = 2;
+	buffer.Publish();
+	buffer.WriteBuffer() = 3;
+	buffer.Publish();
+	CHECK(&buffer.WriteBuffer() != &buffer.ReadBuffer());
+	CHECK_EQUAL(1U, buffer.ReadBuffer());
+	CHECK(buffer.Acquire());
+	CHECK_EQUAL(3U, buffer.ReadBuffer());
+	CHECK(&buffer.WriteBuffer() != &buffer.ReadBuffer());
+}
+
+TEST_CASE(TripleBufferReadsWholeValuesAcrossThreads)
+{
+	// Every field of a published value is written together, so a torn read shows up as mismatched fields.
+	struct Value
+	{
+		uint64_t Fields[8];
+	};
+
+	const uint64_t valueCount = 100000;
+	TripleBuffer<Value> buffer;
+	thread producer([&]()
+	{
+		for (uint64_t i = 1; i <= valueCount; ++i)
+		{
+			Value& value = buffer.WriteBuffer();
+			for (uint64_t& field : value.Fields)
+			{
+				field = i;
+			}
+			buffer.Publish();
+		}
+	});
+
+	uint64_t last = 0;
+	bool isWhole = true;
+	bool isIncreasing = true;
+	while (last < valueCount)
+	{
+		if (buffer.Acquire())
+		{
+			const Value& value = buffer.ReadBuffer();
+			isWhole = isWhole && all_of(begin(value.Fields), end(value.Fields), [&](uint64_t field) { return field == value.Fields[0]; });
+			isIncreasing = isIncreasing && (value.Fields[0] > last);
+			last = value.Fields[0];
+		}
+	}
+	producer.join();
+
+	CHECK(isWhole);
+	CHECK(isIncreasing);
+}
+
+TEST_CASE(StoppedPipelineSimulatesOnTheCallingThread)
+{
+	FramePipeline<uint32_t, SimulatedFrame> pipeline(Simulate);
+	CHECK(pipeline.IsRunning() == false);
+
+	for (uint32_t input = 1; input <= 3; ++input)
+	{
+		const SimulatedFrame& frame = pipeline.Exchange(input);
+		CHECK_EQUAL(input, frame.Input);
+		CHECK_EQUAL(input * 2, frame.Result);
+		CHECK(frame.ThreadId == this_thread::get_id());
+		CHECK(&frame == &pipeline.CurrentFrame());
+		CHECK(pipeline.LastWaitTime() == chrono::nanoseconds::zero());
+	}
+}
+
+TEST_CASE(RunningPipelineReturnsTheFrameSimulatedFromThePreviousInput)
+{
+	FramePipeline<uint32_t, SimulatedFrame> pipeline(Simulate);
+	pipeline.Exchange(1);
+	pipeline.Start();
+	CHECK(pipeline.IsRunning());
+
+	// The frame current before Start() is returned once more while the simulation thread catches up.
+	CHECK_EQUAL(1U, pipeline.Exchange(2).Input);
+	for (uint32_t input = 3; input <= 1000; ++input)
+	{
+		const SimulatedFrame& frame = pipeline.Exchange(input);
+		CHECK_EQUAL(input - 1, frame.Input);
+		CHECK_EQUAL((input - 1) * 2, frame.Result);
+		CHECK(frame.ThreadId != this_thread::get_id());
+	}
+
+	// Stopping makes the frame in flight current, then simulation is back on this thread.
+	pipeline.Stop();
+	CHECK(pipeline.IsRunning() == false);
+	CHECK_EQUAL(1000U, pipeline.CurrentFrame().Input);
+	const SimulatedFrame& frame = pipeline.Exchange(1001);
+	CHECK_EQUAL(1001U, frame.Input);
+	CHECK(frame.ThreadId == this_thread::get_id());
+
+	// Restarting works like the first start.
+	pipeline.Start();
+	CHECK_EQUAL(1001U, pipeline.Exchange(1002).Input);
+	CHECK_EQUAL(1002U, pipeline.Exchange(1003).Input);
+	pipeline.Start();
+	CHECK(pipeline.IsRunning());
+}
+
+TEST_CASE(SimulationExceptionsReachTheRenderThread)
+{
+	FramePipeline<uint32_t, SimulatedFrame> stopped(Simulate);
+	bool threw = false;
+	try
+	{
+		stopped.Exchange(numeric_limits<uint32_t>::max());
+	}
+	catch (const runtime_error&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+
+	FramePipeline<uint32_t, SimulatedFrame> running(Simulate);
+	running.Exchange(1);
+	running.Start();
+	running.Exchange(2);
+	running.Exchange(numeric_limits<uint32_t>::max());
+
+	threw = false;
+	try
+	{
+		running.Exchange(3);
+	}
+	catch (const runtime_error&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+
+	// A failure still pending when the pipeline is destroyed doesn't escape the destructor.
+	FramePipeline<uint32_t, SimulatedFrame> abandoned(Simulate);
+	abandoned.Exchange(1);
+	abandoned.Start();
+	abandoned.Exchange(2);
+	abandoned.Exchange(numeric_limits<uint32_t>::max());
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace Library;
+
+static float Milliseconds(uint32_t nanoseconds)
+{
+	return static_cast<float>(nanoseconds / 1000000.0);
+}
+
+// Nearest-rank percentile over an unsorted copy of the window, as a reference for the incrementally sorted one.
+static uint32_t ReferencePercentile(vector<uint32_t> window, uint32_t percent)
+{
+	sort(window.begin(), window.end());
+	const size_t rank = static_cast<size_t>(ceil(percent / 100.0 * window.size()));
+
+	return window[rank > 0 ? rank - 1 : 0];
+}
+
+static uint32_t ReferenceBucket(uint32_t nanoseconds)
+{
+	for (uint32_t bucket = FrameStatistics::HistogramBucketCount - 1; bucket > 0; --bucket)
+	{
+		if (nanoseconds / 1000 >= FrameStatistics::HistogramBucketLowerBound(bucket))
+		{
+			return bucket;
+		}
+	}
+
+	return 0;
+}
+
+TEST_CASE(SummaryMatchesBruteForceOverSlidingWindow)
+{
+	const uint32_t windowSize = 64;
+	FrameStatistics statistics(windowSize, milliseconds(1000));
+	mt19937 generator(7);
+	uniform_int_distribution<uint32_t> frameTime(100000, 40000000);
+
+	deque<uint32_t> window;
+	for (uint32_t frame = 0; frame < 1000; ++frame)
+	{
+		// Repeated values exercise eviction of duplicates from the sorted window.
+		const uint32_t sample = (frame % 5 == 0 ? 16666666 : frameTime(generator));
+		statistics.AddFrame(nanoseconds(sample));
+		window.push_back(sample);
+		if (window.size() > windowSize)
+		{
+			window.pop_front();
+		}
+
+		const vector<uint32_t> samples(window.begin(), window.end());
+		const FrameStatistics::Summary& summary = statistics.CurrentSummary();
+		CHECK_EQUAL(uint64_t(frame + 1), summary.FrameCount);
+		CHECK_EQUAL(static_cast<uint32_t>(samples.size()), summary.SampleCount);
+		CHECK_EQUAL(Milliseconds(ReferencePercentile(samples, 50)), summary.P50Milliseconds);
+		CHECK_EQUAL(Milliseconds(ReferencePercentile(samples, 95)), summary.P95Milliseconds);
+		CHECK_EQUAL(Milliseconds(ReferencePercentile(samples, 99)), summary.P99Milliseconds);
+		CHECK_EQUAL(Milliseconds(*max_element(samples.begin(), samples.end())), summary.MaxMilliseconds);
+
+		const uint64_t sum = accumulate(samples.begin(), samples.end(), uint64_t(0));
+		CHECK_NEAR(sum / 1000000.0 / samples.size(), summary.MeanMilliseconds, 1e-4);
+
+		vector<uint32_t> histogram(FrameStatistics::HistogramBucketCount);
+		for (uint32_t sampleInWindow : samples)
+		{
+			++histogram[ReferenceBucket(sampleInWindow)];
+		}
+		CHECK(histogram == statistics.Histogram());
+	}
+
+	vector<float> recent;
+	statistics.RecentFrameTimes(recent);
+	CHECK_EQUAL(size_t(windowSize), recent.size());
+	for (size_t i = 0; i < recent.size(); ++i)
+	{
+		CHECK_EQUAL(Milliseconds(window[i]), recent[i]);
+	}
+}
+
+TEST_CASE(PercentilesUseNearestRank)
+{
+	FrameStatistics statistics(100);
+	for (uint32_t i = 1; i <= 100; ++i)
+	{
+		statistics.AddFrame(milliseconds(101 - i));
+	}
+
+	const FrameStatistics::Summary& summary = statistics.CurrentSummary();
+	CHECK_EQUAL(50.0f, summary.P50Milliseconds);
+	CHECK_EQUAL(95.0f, summary.P95Milliseconds);
+	CHECK_EQUAL(99.0f, summary.P99Milliseconds);
+	CHECK_EQUAL(100.0f, summary.MaxMilliseconds);
+	CHECK_EQUAL(50.5f, summary.MeanMilliseconds);
+
+	// A single sample is every percentile.
+	FrameStatistics single;
+	single.AddFrame(milliseconds(3));
+	CHECK_EQUAL(3.0f, single.CurrentSummary().P50Milliseconds);
+	CHECK_EQUAL(3.0f, single.CurrentSummary().P99Milliseconds);
+}
+
+TEST_CASE(HistogramBucketsArePowersOfTwoMicroseconds)
+{
+	CHECK_EQUAL(0U, FrameStatistics::HistogramBucketLowerBound(0));
+	CHECK_EQUAL(2U, FrameStatistics::HistogramBucketLowerBound(1));
+	CHECK_EQUAL(1024U, FrameStatistics::HistogramBucketLowerBound(10));
+
+	FrameStatistics statistics(16);
+	statistics.AddFrame(nanoseconds(0));
+	statistics.AddFrame(microseconds(1));
+	statistics.AddFrame(microseconds(2));
+	statistics.AddFrame(microseconds(3));
+	statistics.AddFrame(microseconds(4));
+	statistics.AddFrame(microseconds(16666));
+	statistics.AddFrame(seconds(10));
+
+	const vector<uint32_t>& histogram = statistics.Histogram();
+	CHECK_EQUAL(size_t(FrameStatistics::HistogramBucketCount), histogram.size());
+	CHECK_EQUAL(2U, histogram[0]);
+	CHECK_EQUAL(2U, histogram[1]);
+	CHECK_EQUAL(1U, histogram[2]);
+	CHECK_EQUAL(1U, histogram[14]);
+	CHECK_EQUAL(1U, histogram[FrameStatistics::HistogramBucketCount - 1]);
+	CHECK_EQUAL(7U, accumulate(histogram.begin(), histogram.end(), 0U));
+}
+
+TEST_CASE(DurationsAreClamped)
+{
+	FrameStatistics statistics(4);
+	statistics.AddFrame(nanoseconds(-5));
+	CHECK_EQUAL(0.0f, statistics.CurrentSummary().MaxMilliseconds);
+
+	statistics.AddFrame(seconds(60));
+	CHECK_EQUAL(Milliseconds(numeric_limits<uint32_t>::max()), statistics.CurrentSummary().MaxMilliseconds);
+
+	vector<float> recent;
+	statistics.RecentFrameTimes(recent);
+	CHECK(recent == vector<float>({ 0.0f, Milliseconds(numeric_limits<uint32_t>::max()) }));
+}
+
+TEST_CASE(HitchesAreCountedAndTheRecentOnesKept)
+{
+	FrameStatistics statistics(8, milliseconds(50));
+	const uint32_t frameCount = 200;
+	uint64_t expectedHitches = 0;
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		// Exactly the threshold is not a hitch.
+		const bool isHitch = (frame % 3 == 0);
+		statistics.AddFrame(isHitch ? milliseconds(60 + frame) : milliseconds(50));
+		CHECK_EQUAL(isHitch, statistics.LastFrameWasHitch());
+		expectedHitches += (isHitch ? 1 : 0);
+	}
+
+	CHECK_EQUAL(expectedHitches, statistics.CurrentSummary().HitchCount);
+	const deque<FrameStatistics::Hitch>& hitches = statistics.RecentHitches();
+	CHECK_EQUAL(size_t(FrameStatistics::MaxRecentHitches), hitches.size());
+	CHECK_EQUAL(uint64_t(198), hitches.back().FrameIndex);
+	CHECK_EQUAL(258.0f, hitches.back().Milliseconds);
+	for (size_t i = 1; i < hitches.size(); ++i)
+	{
+		CHECK_EQUAL(hitches[i - 1].FrameIndex + 3, hitches[i].FrameIndex);
+	}
+
+	statistics.SetHitchThreshold(milliseconds(10));
+	statistics.AddFrame(milliseconds(20));
+	CHECK(statistics.LastFrameWasHitch());
+	CHECK_EQUAL(expectedHitches + 1, statistics.CurrentSummary().HitchCount);
+}
+
+TEST_CASE(ResetStartsOver)
+{
+	FrameStatistics statistics(4, milliseconds(5));
+	for (uint32_t i = 0; i < 10; ++i)
+	{
+		statistics.AddFrame(milliseconds(i));
+	}
+
+	statistics.Reset();
+	CHECK_EQUAL(uint64_t(0), statistics.CurrentSummary().FrameCount);
+	CHECK_EQUAL(0U, statistics.CurrentSummary().SampleCount);
+	CHECK_EQUAL(uint64_t(0), statistics.CurrentSummary().HitchCount);
+	CHECK(statistics.RecentHitches().empty());
+	CHECK(statistics.LastFrameWasHitch() == false);
+	CHECK_EQUAL(0U, accumulate(statistics.Histogram().begin(), statistics.Histogram().end(), 0U));
+
+	vector<float> recent;
+	statistics.RecentFrameTimes(recent);
+	CHECK(recent.empty());
+
+	statistics.AddFrame(milliseconds(2));
+	CHECK_EQUAL(2.0f, statistics.CurrentSummary().MaxMilliseconds);
+	CHECK_EQUAL(1U, statistics.CurrentSummary().SampleCount);
+	statistics.RecentFrameTimes(recent);
+	CHECK(recent == vector<float>({ 2.0f }));
+}
+
+TEST_CASE(ReportsListSummaryHistogramAndHitches)
+{
+	FrameStatistics statistics(4, milliseconds(50));
+	statistics.AddFrame(milliseconds(10));
+	statistics.AddFrame(milliseconds(100));
+
+	ostringstream csv;
+	statistics.WriteCsv(csv);
+	const string csvText = csv.str();
+	CHECK(csvText.find("section,key,value\n") == 0);
+	CHECK(csvText.find("summary,frames,2\n") != string::npos);
+	CHECK(csvText.find("summary,max_ms,100\n") != string::npos);
+	CHECK(csvText.find("summary,hitches,1\n") != string::npos);
+	CHECK(csvText.find("hitch_ms,1,100\n") != string::npos);
+	CHECK_EQUAL(size_t(1 + 8 + FrameStatistics::HistogramBucketCount + 1), static_cast<size_t>(count(csvText.begin(), csvText.end(), '\n')));
+
+	ostringstream json;
+	statistics.WriteJson(json);
+	const string jsonText = json.str();
+	CHECK(jsonText.find("\"frames\": 2,") != string::npos);
+	CHECK(jsonText.find("\"hitchThresholdMilliseconds\": 50,") != string::npos);
+	CHECK(jsonText.find("{ \"frame\": 1, \"milliseconds\": 100 }") != string::npos);
+	CHECK(jsonText.find("{ \"lowerMicroseconds\": 8192, \"count\": 1 }") != string::npos);
+	CHECK(jsonText.back() == '\n');
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "pch.h"
+#include "TestFrustums.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace Library;
+using namespace LibraryTests;
+
+// Usage: FrustumCullerBenchmark [spheres] [repetitions]
+// Culls random spheres against a box frustum that holds about a fifth of them with each instruction set the processor supports
+// and reports the best time of each.
+
+int main(int argc, char* argv[])
+{
+	const uint32_t sphereCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 100000);
+	const uint32_t repetitions = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 100);
+	if (sphereCount == 0 || repetitions == 0)
+	{
+		cerr << "Usage: FrustumCullerBenchmark [spheres] [repetitions]" << endl;
+		return 1;
+	}
+
+	const Frustum frustum = TestFrustums::Box(-500.0f, -500.0f, -500.0f, 500.0f, 500.0f, 500.0f);
+	mt19937 generator(1);
+	uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+	uniform_real_distribution<float> radius(0.0f, 200.0f);
+	BoundingSphereSet spheres;
+	for (uint32_t i = 0; i < sphereCount; ++i)
+	{
+		spheres.Add(position(generator), position(generator), position(generator), radius(generator));
+	}
+
+	const pair<const char*, FrustumCuller::InstructionSet> instructionSets[] =
+	{
+		make_pair("Scalar", FrustumCuller::InstructionSet::Scalar),
+		make_pair("SSE", FrustumCuller::InstructionSet::SSE),
+		make_pair("AVX", FrustumCuller::InstructionSet::AVX)
+	};
+
+	cout << sphereCount << " spheres, best of " << repetitions << endl;
+	cout << left << setw(10) << "" << right << setw(14) << "microseconds" << setw(14) << "ns/sphere" << setw(10) << "visible" << endl;
+
+	vector<uint8_t> visibility(sphereCount);
+	for (const auto& instructionSet : instructionSets)
+	{
+		if (instructionSet.second == FrustumCuller::InstructionSet::AVX && FrustumCuller::BestInstructionSet() != FrustumCuller::InstructionSet::AVX)
+		{
+			continue;
+		}
+
+		double best = numeric_limits<double>::max();
+		for (uint32_t i = 0; i < repetitions; ++i)
+		{
+			const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+			FrustumCuller::Cull(frustum, spheres, visibility.data(), instructionSet.second);
+			best = min(best, duration<double, micro>(high_resolution_clock::now() - startTime).count());
+		}
+
+		const uint32_t visibleCount = accumulate(visibility.begin(), visibility.end(), 0U);
+		cout << left << setw(10) << instructionSet.first << right << fixed << setprecision(1) << setw(14) << best
+			<< setprecision(3) << setw(14) << best * 1000.0 / sphereCount << setw(10) << visibleCount << endl;
+	}
+
+	return 0;
+}
\ No newline at end of file
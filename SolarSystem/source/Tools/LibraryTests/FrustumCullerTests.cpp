@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "TestFrustums.h"
+
+using namespace std;
+using namespace Library;
+using namespace LibraryTests;
+
+static Frustum PerspectiveFrustum(float fieldOfView, float aspectRatio, float nearPlane, float farPlane)
+{
+	float projection[16];
+	TestFrustums::Perspective(fieldOfView, aspectRatio, nearPlane, farPlane, projection);
+
+	return TestFrustums::FromViewProjection(projection);
+}
+
+// The smallest signed distance of the sphere's surface from the frustum's planes, in double precision; the sphere
+// intersects the frustum when it isn't negative.
+static double Margin(const Frustum& frustum, float x, float y, float z, float radius)
+{
+	double margin = numeric_limits<double>::max();
+	for (uint32_t planeIndex = 0; planeIndex < Frustum::PlaneCount; ++planeIndex)
+	{
+		const float* plane = frustum.Planes[planeIndex];
+		const double distance = static_cast<double>(plane[0]) * x + static_cast<double>(plane[1]) * y + static_cast<double>(plane[2]) * z + plane[3];
+		margin = min(margin, distance + radius);
+	}
+
+	return margin;
+}
+
+static vector<FrustumCuller::InstructionSet> SupportedInstructionSets()
+{
+	vector<FrustumCuller::InstructionSet> instructionSets;
+	instructionSets.push_back(FrustumCuller::InstructionSet::Scalar);
+	instructionSets.push_back(FrustumCuller::InstructionSet::SSE);
+	if (FrustumCuller::BestInstructionSet() == FrustumCuller::InstructionSet::AVX)
+	{
+		instructionSets.push_back(FrustumCuller::InstructionSet::AVX);
+	}
+
+	return instructionSets;
+}
+
+TEST_CASE(EveryPathMatchesTheReference)
+{
+	const Frustum frustum = PerspectiveFrustum(0.785f, 16.0f / 9.0f, 0.5f, 1000.0f);
+	mt19937 generator(1);
+	uniform_real_distribution<float> xy(-600.0f, 600.0f);
+	uniform_real_distribution<float> z(-1100.0f, 100.0f);
+	uniform_real_distribution<float> radius(0.0f, 50.0f);
+
+	// Sizes around the SSE and AVX widths, so the scalar remainder is tested too.
+	const uint32_t sizes[] = { 0, 1, 3, 4, 5, 7, 8, 9, 15, 17, 1000, 10003 };
+	for (uint32_t size : sizes)
+	{
+		BoundingSphereSet spheres;
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			spheres.Add(xy(generator), xy(generator), z(generator), radius(generator));
+		}
+
+		vector<uint8_t> scalar(size + 1, 0xCD);
+		FrustumCuller::Cull(frustum, spheres, scalar.data(), FrustumCuller::InstructionSet::Scalar);
+		CHECK_EQUAL(0xCD, static_cast<int>(scalar[size]));
+
+		uint32_t visibleCount = 0;
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			const double margin = Margin(frustum, spheres.X()[i], spheres.Y()[i], spheres.Z()[i], spheres.Radius()[i]);
+			if (abs(margin) > 1e-3)
+			{
+				CHECK_EQUAL((margin >= 0.0 ? 1 : 0), static_cast<int>(scalar[i]));
+			}
+
+			visibleCount += scalar[i];
+		}
+
+		if (size >= 1000)
+		{
+			CHECK(visibleCount > size / 10 && visibleCount < size - size / 10);
+		}
+
+		for (FrustumCuller::InstructionSet instructionSet : SupportedInstructionSets())
+		{
+			vector<uint8_t> visibility(size + 1, 0xCD);
+			FrustumCuller::Cull(frustum, spheres, visibility.data(), instructionSet);
+			CHECK(visibility == scalar);
+		}
+	}
+}
+
+TEST_CASE(SpheresTouchingAPlaneAreVisible)
+{
+	const Frustum frustum = TestFrustums::Box(-10.0f, -10.0f, -10.0f, 10.0f, 10.0f, 10.0f);
+
+	// Eight spheres so that every SIMD lane gets one: touching each face, just outside two faces, and inside.
+	BoundingSphereSet spheres;
+	spheres.Add(12.0f, 0.0f, 0.0f, 2.0f);
+	spheres.Add(-12.0f, 0.0f, 0.0f, 2.0f);
+	spheres.Add(0.0f, 11.0f, 0.0f, 1.0f);
+	spheres.Add(0.0f, 0.0f, -10.5f, 0.5f);
+	spheres.Add(12.0f, 0.0f, 0.0f, 1.99f);
+	spheres.Add(0.0f, -10.5f, 0.0f, 0.25f);
+	spheres.Add(0.0f, 0.0f, 0.0f, 0.0f);
+	spheres.Add(5.0f, 5.0f, 5.0f, 100.0f);
+
+	const uint8_t expected[] = { 1, 1, 1, 1, 0, 0, 1, 1 };
+	for (FrustumCuller::InstructionSet instructionSet : SupportedInstructionSets())
+	{
+		uint8_t visibility[8];
+		FrustumCuller::Cull(frustum, spheres, visibility, instructionSet);
+		CHECK(memcmp(expected, visibility, sizeof(expected)) == 0);
+	}
+}
\ No newline at end of file
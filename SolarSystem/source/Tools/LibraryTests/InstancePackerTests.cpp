@@ -0,0 +1,153 @@
+#include "pch.h"
+#include "TestFrustums.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+using namespace LibraryTests;
+
+static XMFLOAT4X4 Translation(float x, float y, float z, float scale = 1.0f)
+{
+	XMFLOAT4X4 world;
+	XMStoreFloat4x4(&world, XMMatrixScaling(scale, scale, scale) * XMMatrixTranslation(x, y, z));
+
+	return world;
+}
+
+static const Frustum Everything = TestFrustums::Box(-1000.0f, -1000.0f, -1000.0f, 1000.0f, 1000.0f, 1000.0f);
+
+TEST_CASE(InstancesAreGroupedByMeshInOrder)
+{
+	vector<XMFLOAT4X4> worlds;
+	for (uint32_t i = 0; i < 6; ++i)
+	{
+		worlds.push_back(Translation(static_cast<float>(i), 0.0f, 0.0f));
+	}
+
+	InstancePacker packer;
+	const uint32_t meshes[] = { 2, 0, 2, 1, 0, 2 };
+	for (uint32_t i = 0; i < 6; ++i)
+	{
+		packer.Add(worlds[i], meshes[i], i, 0.5f);
+	}
+
+	XMFLOAT4X4 identity;
+	XMStoreFloat4x4(&identity, XMMatrixIdentity());
+	vector<InstanceData> instances(packer.Size());
+	packer.Pack(identity, Everything, instances.data());
+
+	CHECK_EQUAL(6U, packer.VisibleCount());
+	CHECK_EQUAL(3U, static_cast<uint32_t>(packer.Ranges().size()));
+	const uint32_t expectedRanges[3][3] = { { 0, 0, 2 }, { 1, 2, 1 }, { 2, 3, 3 } };
+	for (uint32_t i = 0; i < packer.Ranges().size(); ++i)
+	{
+		const InstanceRange& range = packer.Ranges()[i];
+		CHECK_EQUAL(expectedRanges[i][0], range.MeshIndex);
+		CHECK_EQUAL(expectedRanges[i][1], range.StartInstance);
+		CHECK_EQUAL(expectedRanges[i][2], range.InstanceCount);
+	}
+
+	const uint32_t expectedMaterials[] = { 1, 4, 3, 0, 2, 5 };
+	for (uint32_t i = 0; i < 6; ++i)
+	{
+		CHECK_EQUAL(expectedMaterials[i], instances[i].MaterialIndex);
+		CHECK_EQUAL(static_cast<float>(expectedMaterials[i]), instances[i].World._41);
+		CHECK_EQUAL(0.5f, instances[i].AmbientIntensity);
+	}
+}
+
+TEST_CASE(WorldViewProjectionMatchesDirectXMath)
+{
+	XMFLOAT4X4 world;
+	XMStoreFloat4x4(&world, XMMatrixScaling(2.0f, 2.0f, 2.0f) * XMMatrixRotationY(0.7f) * XMMatrixTranslation(3.0f, -1.0f, -20.0f));
+
+	XMMATRIX viewProjectionMatrix = XMMatrixLookToRH(XMVectorSet(0.0f, 0.0f, 5.0f, 1.0f), XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) *
+		XMMatrixPerspectiveFovRH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+	XMFLOAT4X4 viewProjection;
+	XMStoreFloat4x4(&viewProjection, viewProjectionMatrix);
+
+	InstancePacker packer;
+	packer.Add(world, 0, 0, 1.0f);
+	InstanceData instance;
+	packer.Pack(viewProjection, Everything, &instance);
+
+	XMFLOAT4X4 expected;
+	XMStoreFloat4x4(&expected, XMLoadFloat4x4(&world) * viewProjectionMatrix);
+	CHECK(memcmp(&expected, &instance.WorldViewProjection, sizeof(expected)) == 0);
+	CHECK(memcmp(&world, &instance.World, sizeof(world)) == 0);
+}
+
+TEST_CASE(InstancesOutsideTheFrustumAreCulled)
+{
+	const Frustum frustum = TestFrustums::Box(-10.0f, -10.0f, -10.0f, 10.0f, 10.0f, 10.0f);
+	vector<XMFLOAT4X4> worlds;
+	worlds.push_back(Translation(0.0f, 0.0f, 0.0f));
+	worlds.push_back(Translation(20.0f, 0.0f, 0.0f));
+	worlds.push_back(Translation(10.5f, 0.0f, 0.0f));
+
+	// Scaled by 5, so its bounds reach from 9 to 19.
+	worlds.push_back(Translation(14.0f, 0.0f, 0.0f, 5.0f));
+
+	// Mesh 1 has no bounds, so its instance is kept wherever it is.
+	worlds.push_back(Translation(500.0f, 0.0f, 0.0f));
+
+	InstancePacker packer;
+	packer.SetMeshBounds(0, XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f);
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		packer.Add(worlds[i], 0, i, 1.0f);
+	}
+	packer.Add(worlds[4], 1, 4, 1.0f);
+
+	XMFLOAT4X4 identity;
+	XMStoreFloat4x4(&identity, XMMatrixIdentity());
+	vector<InstanceData> instances(packer.Size());
+	packer.Pack(identity, frustum, instances.data());
+
+	CHECK_EQUAL(4U, packer.VisibleCount());
+	CHECK_EQUAL(0U, instances[0].MaterialIndex);
+	CHECK_EQUAL(2U, instances[1].MaterialIndex);
+	CHECK_EQUAL(3U, instances[2].MaterialIndex);
+	CHECK_EQUAL(4U, instances[3].MaterialIndex);
+}
+
+TEST_CASE(InstancesBehindOccludersAreDropped)
+{
+	XMMATRIX viewProjectionMatrix = XMMatrixLookToRH(XMVectorZero(), XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) *
+		XMMatrixPerspectiveFovRH(XM_PIDIV4, 1.0f, 0.1f, 1000.0f);
+	XMFLOAT4X4 viewProjection;
+	XMStoreFloat4x4(&viewProjection, viewProjectionMatrix);
+	const Frustum frustum = TestFrustums::FromViewProjection(&viewProjection.m[0][0]);
+
+	// A large occluding sphere 50 units ahead, a body straight behind it and one off to the side.
+	vector<XMFLOAT4X4> worlds;
+	worlds.push_back(Translation(0.0f, 0.0f, -50.0f, 10.0f));
+	worlds.push_back(Translation(0.0f, 0.0f, -100.0f));
+	worlds.push_back(Translation(30.0f, 0.0f, -100.0f));
+
+	InstancePacker packer;
+	packer.SetMeshBounds(0, XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f);
+	packer.SetMeshOccluderRadius(0, 0.9f);
+	packer.SetMeshBounds(1, XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f);
+	packer.Add(worlds[0], 0, 0, 1.0f);
+	packer.Add(worlds[1], 1, 1, 1.0f);
+	packer.Add(worlds[2], 1, 2, 1.0f);
+
+	OcclusionCuller occlusionCuller;
+	occlusionCuller.BeginFrame(&viewProjection.m[0][0]);
+	packer.AddOccluders(occlusionCuller);
+	occlusionCuller.RasterizeOccluders();
+	CHECK_EQUAL(1U, occlusionCuller.OccluderCount());
+
+	vector<InstanceData> instances(packer.Size());
+	packer.Pack(viewProjection, frustum, instances.data(), &occlusionCuller);
+	CHECK_EQUAL(2U, packer.VisibleCount());
+	CHECK_EQUAL(1U, packer.OccludedCount());
+	CHECK_EQUAL(0U, instances[0].MaterialIndex);
+	CHECK_EQUAL(2U, instances[1].MaterialIndex);
+
+	// Without the occlusion culler, all three are in the frustum.
+	packer.Pack(viewProjection, frustum, instances.data());
+	CHECK_EQUAL(3U, packer.VisibleCount());
+	CHECK_EQUAL(0U, packer.OccludedCount());
+}
\ No newline at end of file
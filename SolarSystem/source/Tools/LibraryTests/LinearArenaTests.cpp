@@ -0,0 +1,320 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+// Hands out heap memory and counts what it's asked for, as the upstream of a small arena.
+class CountingResource final : public MemoryResource
+{
+public:
+	CountingResource() :
+		AllocationCount(0), DeallocationCount(0), LiveBytes(0) { }
+
+	uint32_t AllocationCount;
+	uint32_t DeallocationCount;
+	size_t LiveBytes;
+
+protected:
+	virtual void* DoAllocate(size_t bytes, size_t alignment) override
+	{
+		++AllocationCount;
+		LiveBytes += bytes;
+		return Heap().Allocate(bytes, alignment);
+	}
+
+	virtual void DoDeallocate(void* memory, size_t bytes, size_t alignment) override
+	{
+		++DeallocationCount;
+		LiveBytes -= bytes;
+		Heap().Deallocate(memory, bytes, alignment);
+	}
+
+	virtual bool DoIsEqual(const MemoryResource& other) const override
+	{
+		return this == &other;
+	}
+};
+
+typedef vector<uint32_t, PolymorphicAllocator<uint32_t>> ArenaVector;
+
+static bool IsInside(const void* memory, const void* first, size_t bytes)
+{
+	const uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+	const uintptr_t start = reinterpret_cast<uintptr_t>(first);
+	return (address >= start && address < start + bytes);
+}
+
+TEST_CASE(AllocationsAreAlignedAndPacked)
+{
+	LinearArena arena(4096);
+	CHECK_EQUAL(size_t(4096), arena.Capacity());
+	CHECK_EQUAL(size_t(0), arena.UsedBytes());
+
+	const unsigned char* first = static_cast<unsigned char*>(arena.Allocate(1, 1));
+	for (size_t alignment = 1; alignment <= 256; alignment *= 2)
+	{
+		// An odd size first, so the next allocation has to be padded up to the alignment.
+		arena.Allocate(3, 1);
+		void* memory = arena.Allocate(alignment, alignment);
+		CHECK_EQUAL(uintptr_t(0), reinterpret_cast<uintptr_t>(memory) % alignment);
+		CHECK(IsInside(memory, first, arena.Capacity()));
+	}
+
+	// A run of same-sized allocations is packed back to back.
+	unsigned char* previous = static_cast<unsigned char*>(arena.Allocate(16, 16));
+	for (uint32_t i = 0; i < 10; ++i)
+	{
+		unsigned char* next = static_cast<unsigned char*>(arena.Allocate(16, 16));
+		CHECK(next == previous + 16);
+		previous = next;
+	}
+	CHECK(arena.UsedBytes() <= arena.Capacity());
+	CHECK_EQUAL(0U, arena.OverflowCount());
+
+	// Deallocating gives nothing back; resetting starts over at the front of the same buffer.
+	const size_t usedBytes = arena.UsedBytes();
+	arena.Deallocate(previous, 16, 16);
+	CHECK_EQUAL(usedBytes, arena.UsedBytes());
+	arena.Reset();
+	CHECK_EQUAL(size_t(0), arena.UsedBytes());
+	CHECK(arena.Allocate(1, 1) == first);
+}
+
+TEST_CASE(OverflowGoesUpstreamUntilReset)
+{
+	CountingResource upstream;
+	{
+		LinearArena arena(256, upstream);
+		arena.Allocate(200);
+		CHECK_EQUAL(0U, upstream.AllocationCount);
+
+		// Doesn't fit in what's left, then is larger than the whole arena.
+		void* overflow = arena.Allocate(100);
+		CHECK(overflow != nullptr);
+		arena.Allocate(1000, 16);
+		CHECK_EQUAL(2U, arena.OverflowCount());
+		CHECK_EQUAL(size_t(1100), arena.OverflowBytes());
+		CHECK_EQUAL(2U, upstream.AllocationCount);
+		CHECK_EQUAL(size_t(1100), upstream.LiveBytes);
+
+		// Small allocations still fit in what's left of the buffer.
+		arena.Allocate(8, 8);
+		CHECK_EQUAL(2U, arena.OverflowCount());
+
+		arena.Reset();
+		CHECK_EQUAL(0U, arena.OverflowCount());
+		CHECK_EQUAL(size_t(0), arena.OverflowBytes());
+		CHECK_EQUAL(2U, upstream.DeallocationCount);
+		CHECK_EQUAL(size_t(0), upstream.LiveBytes);
+
+		// Overflow left when the arena is destroyed goes back upstream too.
+		arena.Allocate(300);
+		CHECK_EQUAL(3U, upstream.AllocationCount);
+	}
+	CHECK_EQUAL(3U, upstream.DeallocationCount);
+	CHECK_EQUAL(size_t(0), upstream.LiveBytes);
+}
+
+TEST_CASE(ResetPoisonsFreedBytesInDebugBuilds)
+{
+	LinearArena arena(1024);
+	unsigned char* memory = static_cast<unsigned char*>(arena.Allocate(64));
+	memset(memory, 0x5A, 64);
+	arena.Reset();
+
+#if defined(DEBUG) || defined(_DEBUG)
+	CHECK(all_of(memory, memory + 64, [](unsigned char value) { return value == LinearArena::PoisonByte; }));
+#else
+	// Release builds leave the bytes alone, so resetting costs nothing per byte.
+	CHECK(all_of(memory, memory + 64, [](unsigned char value) { return value == 0x5A; }));
+#endif
+
+	// The buffer is kept and handed out again from the front.
+	CHECK(arena.Allocate(64) == memory);
+}
+
+TEST_CASE(FrameArenaKeepsLastFramesMemoryForOneMoreFrame)
+{
+	FrameArena frameArena(1024);
+	MemoryResource& resource = frameArena.ThreadResource();
+	CHECK(&resource != &MemoryResource::Heap());
+	CHECK(&frameArena.ThreadResource() == &resource);
+	CHECK_EQUAL(uint64_t(0), frameArena.FrameIndex());
+
+	uint32_t* frame0 = static_cast<uint32_t*>(resource.Allocate(16 * sizeof(uint32_t)));
+	fill(frame0, frame0 + 16, 0U);
+	CHECK_EQUAL(16 * sizeof(uint32_t), frameArena.UsedBytes());
+
+	// The next frame gets the other buffer, so the last frame's memory is untouched.
+	frameArena.BeginFrame();
+	CHECK_EQUAL(uint64_t(1), frameArena.FrameIndex());
+	uint32_t* frame1 = static_cast<uint32_t*>(resource.Allocate(16 * sizeof(uint32_t)));
+	fill(frame1, frame1 + 16, 1U);
+	CHECK(frame1 != frame0);
+	CHECK(all_of(frame0, frame0 + 16, [](uint32_t value) { return value == 0; }));
+	CHECK_EQUAL(16 * sizeof(uint32_t), frameArena.UsedBytes());
+
+	// The frame after that resets and reuses the first buffer.
+	frameArena.BeginFrame();
+	uint32_t* frame2 = static_cast<uint32_t*>(resource.Allocate(4 * sizeof(uint32_t)));
+	CHECK(frame2 == frame0);
+	CHECK(all_of(frame1, frame1 + 16, [](uint32_t value) { return value == 1; }));
+	CHECK_EQUAL(4 * sizeof(uint32_t), frameArena.UsedBytes());
+
+	// Frames without allocations don't switch buffers, and skipped frames count as one.
+	frameArena.BeginFrame();
+	frameArena.BeginFrame();
+	frameArena.BeginFrame();
+	CHECK(resource.Allocate(sizeof(uint32_t)) == frame1);
+
+	resource.Allocate(2048);
+	CHECK_EQUAL(1U, frameArena.OverflowCount());
+	frameArena.BeginFrame();
+	frameArena.BeginFrame();
+	resource.Allocate(sizeof(uint32_t));
+	CHECK_EQUAL(0U, frameArena.OverflowCount());
+}
+
+TEST_CASE(ThreadsGetTheirOwnArenasAndReuseExitedThreadsIndices)
+{
+	FrameArena frameArena(1024);
+	MemoryResource* mainResource = &frameArena.ThreadResource();
+
+	// Four threads at once each get their own arena.
+	vector<MemoryResource*> resources(4, nullptr);
+	vector<thread> threads;
+	atomic<uint32_t> readyCount(0);
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		threads.emplace_back([&, i]()
+		{
+			resources[i] = &frameArena.ThreadResource();
+			resources[i]->Allocate(64);
+
+			// Every thread holds its index until all four have one.
+			++readyCount;
+			while (readyCount.load() < 4)
+			{
+				this_thread::yield();
+			}
+		});
+	}
+	for (thread& worker : threads)
+	{
+		worker.join();
+	}
+
+	const set<MemoryResource*> distinct(resources.begin(), resources.end());
+	CHECK_EQUAL(size_t(4), distinct.size());
+	CHECK(distinct.count(mainResource) == 0);
+	CHECK(distinct.count(&MemoryResource::Heap()) == 0);
+	CHECK_EQUAL(4 * size_t(64), frameArena.UsedBytes());
+
+	// Many more threads than MaxThreads over the process's life, but never many at once, all get an arena.
+	uint32_t heapCount = 0;
+	for (uint32_t i = 0; i < FrameArena::MaxThreads * 4; ++i)
+	{
+		thread([&]()
+		{
+			heapCount += (&frameArena.ThreadResource() == &MemoryResource::Heap() ? 1 : 0);
+		}).join();
+	}
+	CHECK_EQUAL(0U, heapCount);
+}
+
+TEST_CASE(PolymorphicAllocatorPutsContainersInTheArena)
+{
+	LinearArena arena(64 * 1024);
+	const void* buffer = arena.Allocate(1, 1);
+
+	ArenaVector values{ PolymorphicAllocator<uint32_t>(arena) };
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		values.push_back(i);
+	}
+	CHECK(IsInside(values.data(), buffer, arena.Capacity()));
+	CHECK_EQUAL(999U, values.back());
+	CHECK(values.get_allocator().Resource() == &arena);
+
+	// As with pmr, a copy goes to the heap rather than sharing the arena; a move keeps it.
+	ArenaVector copy(values);
+	CHECK(copy.get_allocator().Resource() == &MemoryResource::Heap());
+	CHECK(IsInside(copy.data(), buffer, arena.Capacity()) == false);
+	CHECK(copy == values);
+
+	ArenaVector moved(move(values));
+	CHECK(moved.get_allocator().Resource() == &arena);
+
+	CHECK(PolymorphicAllocator<uint32_t>(arena) == PolymorphicAllocator<double>(arena));
+	CHECK(PolymorphicAllocator<uint32_t>(arena) != PolymorphicAllocator<uint32_t>());
+	CHECK(PolymorphicAllocator<uint32_t>() == PolymorphicAllocator<uint32_t>(MemoryResource::Heap()));
+
+	bool threw = false;
+	try
+	{
+		PolymorphicAllocator<uint64_t>(arena).allocate((numeric_limits<size_t>::max)() / 4);
+	}
+	catch (const bad_alloc&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+}
+
+TEST_CASE(TextBuilderFormatsIntoTheArena)
+{
+	LinearArena arena(4096);
+	const void* buffer = arena.Allocate(1, 1);
+
+	TextBuilder text(arena);
+	text << L"Frame " << 42 << L" of " << 100U << "\n" << L'x' << -7LL << L" " << 18446744073709551615ULL;
+	CHECK(text.Text() == L"Frame 42 of 100\nx-7 18446744073709551615");
+	CHECK_EQUAL(wcslen(text.c_str()), text.Length());
+	CHECK(IsInside(text.c_str(), buffer, arena.Capacity()));
+
+	text.Clear();
+	CHECK_EQUAL(size_t(0), text.Length());
+
+	// Doubles print like a stream's default until Fixed() sets the decimal places for the rest of the text.
+	text << 0.5 << L" " << 1e20 << L" " << TextBuilder::Fixed(2) << 3.14159 << L" " << 2.0 << L" " << wstring(L"ms");
+	CHECK(text.Text() == L"0.5 1e+20 3.14 2.00 ms");
+	CHECK_EQUAL(0U, arena.OverflowCount());
+}
+
+TEST_CASE(SteadyStateFramesAllocateNothing)
+{
+	FrameArena frameArena(16 * 1024);
+
+	// What the HUD and the frame's scratch lists do each frame.
+	auto frame = [&frameArena](uint32_t frameNumber)
+	{
+		frameArena.BeginFrame();
+		MemoryResource& resource = frameArena.ThreadResource();
+
+		TextBuilder text(resource);
+		text << L"Frame " << frameNumber << L": " << TextBuilder::Fixed(2) << frameNumber * 16.667 << L" ms";
+
+		ArenaVector visible{ PolymorphicAllocator<uint32_t>(resource) };
+		visible.reserve(256);
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			visible.push_back(i * frameNumber);
+		}
+
+		return (text.Length() > 0 && visible.size() == 256);
+	};
+
+	// The first frames set up the thread's index and the arenas' buffers.
+	CHECK(frame(0));
+	CHECK(frame(1));
+
+	const uint64_t allocationCount = AllocationCounter::AllocationCount();
+	uint32_t completeCount = 0;
+	for (uint32_t i = 2; i < 1000; ++i)
+	{
+		completeCount += (frame(i) ? 1 : 0);
+	}
+	CHECK_EQUAL(allocationCount, AllocationCounter::AllocationCount());
+	CHECK_EQUAL(998U, completeCount);
+	CHECK_EQUAL(0U, frameArena.OverflowCount());
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace DirectX;
+using namespace Library;
+
+// Usage: MeshDataBenchmark [meshes] [vertices per mesh] [repetitions]
+// Loads a model of meshes with every channel (normals, tangents, binormals, two texture coordinate channels and a vertex
+// color channel) from memory, then tears it down: with a vector per channel, as MeshData used to hold them, and with
+// MeshData's single block from the heap and from a LinearArena. Reports the best load and teardown times in microseconds
+// and the allocations each makes, counted by AllocationCounter.
+
+static const uint32_t TextureCoordinateChannelCount = 2;
+static const uint32_t VertexColorChannelCount = 1;
+
+// What Mesh::Load() reads from the stream, already in memory so only the copies and allocations are timed.
+struct SourceMesh
+{
+	vector<XMFLOAT3> Vertices;
+	vector<XMFLOAT4> Colors;
+	vector<uint32_t> Indices;
+};
+
+// The channels as MeshData held them before they shared one block.
+struct VectorMeshData
+{
+	vector<XMFLOAT3> Vertices;
+	vector<XMFLOAT3> Normals;
+	vector<XMFLOAT3> Tangents;
+	vector<XMFLOAT3> BiNormals;
+	vector<unique_ptr<vector<XMFLOAT3>>> TextureCoordinates;
+	vector<unique_ptr<vector<XMFLOAT4>>> VertexColors;
+	vector<uint32_t> Indices;
+};
+
+static SourceMesh CreateSource(uint32_t vertexCount)
+{
+	mt19937 generator(1);
+	uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+
+	SourceMesh source;
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		source.Vertices.push_back(XMFLOAT3(coordinate(generator), coordinate(generator), coordinate(generator)));
+		source.Colors.push_back(XMFLOAT4(coordinate(generator), coordinate(generator), coordinate(generator), 1.0f));
+	}
+	for (uint32_t i = 0; i < vertexCount * 3; ++i)
+	{
+		source.Indices.push_back(static_cast<uint32_t>(generator() % vertexCount));
+	}
+
+	return source;
+}
+
+// Element by element, as Mesh::Load() reads them.
+template <typename T>
+static void CopyChannel(vector<T>& channel, const vector<T>& source)
+{
+	channel.reserve(source.size());
+	for (const T& element : source)
+	{
+		channel.push_back(element);
+	}
+}
+
+template <typename T>
+static void CopyChannel(Span<T> channel, const vector<T>& source)
+{
+	for (size_t i = 0; i < source.size(); ++i)
+	{
+		channel[i] = source[i];
+	}
+}
+
+static void LoadVectors(vector<VectorMeshData>& meshes, uint32_t meshCount, const SourceMesh& source)
+{
+	meshes.reserve(meshCount);
+	for (uint32_t i = 0; i < meshCount; ++i)
+	{
+		meshes.emplace_back();
+		VectorMeshData& mesh = meshes.back();
+		CopyChannel(mesh.Vertices, source.Vertices);
+		CopyChannel(mesh.Normals, source.Vertices);
+		CopyChannel(mesh.Tangents, source.Vertices);
+		CopyChannel(mesh.BiNormals, source.Vertices);
+		for (uint32_t channel = 0; channel < TextureCoordinateChannelCount; ++channel)
+		{
+			mesh.TextureCoordinates.push_back(make_unique<vector<XMFLOAT3>>());
+			CopyChannel(*mesh.TextureCoordinates.back(), source.Vertices);
+		}
+		for (uint32_t channel = 0; channel < VertexColorChannelCount; ++channel)
+		{
+			mesh.VertexColors.push_back(make_unique<vector<XMFLOAT4>>());
+			CopyChannel(*mesh.VertexColors.back(), source.Colors);
+		}
+		CopyChannel(mesh.Indices, source.Indices);
+	}
+}
+
+static void LoadMeshData(vector<MeshData>& meshes, uint32_t meshCount, const SourceMesh& source, MemoryResource& resource)
+{
+	MeshLayout layout;
+	layout.VertexCount = static_cast<uint32_t>(source.Vertices.size());
+	layout.HasNormals = true;
+	layout.HasTangents = true;
+	layout.HasBiNormals = true;
+	layout.TextureCoordinateChannelCount = TextureCoordinateChannelCount;
+	layout.VertexColorChannelCount = VertexColorChannelCount;
+	layout.IndexCount = static_cast<uint32_t>(source.Indices.size());
+
+	meshes.reserve(meshCount);
+	for (uint32_t i = 0; i < meshCount; ++i)
+	{
+		meshes.emplace_back(layout, resource);
+		MeshData& mesh = meshes.back();
+		CopyChannel(mesh.Vertices(), source.Vertices);
+		CopyChannel(mesh.Normals(), source.Vertices);
+		CopyChannel(mesh.Tangents(), source.Vertices);
+		CopyChannel(mesh.BiNormals(), source.Vertices);
+		for (uint32_t channel = 0; channel < TextureCoordinateChannelCount; ++channel)
+		{
+			CopyChannel(mesh.TextureCoordinates(channel), source.Vertices);
+		}
+		for (uint32_t channel = 0; channel < VertexColorChannelCount; ++channel)
+		{
+			CopyChannel(mesh.VertexColors(channel), source.Colors);
+		}
+		CopyChannel(mesh.Indices(), source.Indices);
+	}
+}
+
+struct Timings
+{
+	double LoadMicroseconds;
+	double TeardownMicroseconds;
+	uint64_t LoadAllocations;
+	uint64_t TeardownAllocations;
+
+	Timings() :
+		LoadMicroseconds(numeric_limits<double>::max()), TeardownMicroseconds(numeric_limits<double>::max()), LoadAllocations(0), TeardownAllocations(0) { }
+};
+
+template <typename TLoad, typename TTeardown>
+static Timings BestTimings(uint32_t repetitions, TLoad load, TTeardown teardown)
+{
+	Timings timings;
+	for (uint32_t i = 0; i < repetitions; ++i)
+	{
+		const uint64_t startCount = AllocationCounter::AllocationCount();
+		high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		load();
+		timings.LoadMicroseconds = min(timings.LoadMicroseconds, duration<double, micro>(high_resolution_clock::now() - startTime).count());
+		timings.LoadAllocations = AllocationCounter::AllocationCount() - startCount;
+
+		const uint64_t loadedCount = AllocationCounter::AllocationCount();
+		startTime = high_resolution_clock::now();
+		teardown();
+		timings.TeardownMicroseconds = min(timings.TeardownMicroseconds, duration<double, micro>(high_resolution_clock::now() - startTime).count());
+		timings.TeardownAllocations = AllocationCounter::AllocationCount() - loadedCount;
+	}
+
+	return timings;
+}
+
+static void Print(const char* name, const Timings& timings)
+{
+	cout << left << setw(20) << name << right << fixed << setprecision(1) << setw(12) << timings.LoadMicroseconds << setw(14) << timings.TeardownMicroseconds
+		<< setw(14) << timings.LoadAllocations << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t meshCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 64);
+	const uint32_t vertexCount = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 65536);
+	const uint32_t repetitions = (argc > 3 ? static_cast<uint32_t>(stoul(argv[3])) : 10);
+	if (meshCount == 0 || vertexCount == 0 || repetitions == 0)
+	{
+		cerr << "Usage: MeshDataBenchmark [meshes] [vertices per mesh] [repetitions]" << endl;
+		return 1;
+	}
+
+	const SourceMesh source = CreateSource(vertexCount);
+
+	vector<VectorMeshData> vectorMeshes;
+	const Timings vectors = BestTimings(repetitions, [&]() { LoadVectors(vectorMeshes, meshCount, source); }, [&]() { vector<VectorMeshData>().swap(vectorMeshes); });
+
+	vector<MeshData> heapMeshes;
+	const Timings heap = BestTimings(repetitions, [&]() { LoadMeshData(heapMeshes, meshCount, source, MemoryResource::Heap()); }, [&]() { vector<MeshData>().swap(heapMeshes); });
+
+	// Sized for the whole model, with room for each mesh's channel padding, so nothing overflows to the heap.
+	const size_t meshBytes = vertexCount * (6 * sizeof(XMFLOAT3) + sizeof(XMFLOAT4) + 3 * sizeof(uint32_t)) + 16 * 8;
+	LinearArena arena(meshCount * meshBytes);
+	vector<MeshData> arenaMeshes;
+	const Timings arenaTimings = BestTimings(repetitions, [&]() { LoadMeshData(arenaMeshes, meshCount, source, arena); }, [&]()
+	{
+		vector<MeshData>().swap(arenaMeshes);
+		arena.Reset();
+	});
+
+	cout << meshCount << " meshes of " << vertexCount << " vertices, best of " << repetitions << "; times in microseconds" << endl;
+	cout << left << setw(20) << "" << right << setw(12) << "load" << setw(14) << "teardown" << setw(14) << "allocations" << endl;
+	Print("vector per channel", vectors);
+	Print("MeshData, heap", heap);
+	Print("MeshData, arena", arenaTimings);
+	if (arena.OverflowCount() > 0)
+	{
+		cerr << "The arena overflowed " << arena.OverflowCount() << " times." << endl;
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include "pch.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+// Hands out heap memory and checks that every block comes back to it with the size and alignment it was allocated with.
+class RecordingResource final : public MemoryResource
+{
+public:
+	struct Block
+	{
+		size_t Bytes;
+		size_t Alignment;
+	};
+
+	RecordingResource() :
+		AllocationCount(0), DeallocationCount(0), IsConsistent(true) { }
+
+	uint32_t AllocationCount;
+	uint32_t DeallocationCount;
+	bool IsConsistent;
+	map<void*, Block> LiveBlocks;
+
+protected:
+	virtual void* DoAllocate(size_t bytes, size_t alignment) override
+	{
+		void* memory = Heap().Allocate(bytes, alignment);
+		LiveBlocks[memory] = Block{ bytes, alignment };
+		++AllocationCount;
+
+		return memory;
+	}
+
+	virtual void DoDeallocate(void* memory, size_t bytes, size_t alignment) override
+	{
+		auto block = LiveBlocks.find(memory);
+		IsConsistent = IsConsistent && block != LiveBlocks.end() && block->second.Bytes == bytes && block->second.Alignment == alignment;
+		if (block != LiveBlocks.end())
+		{
+			LiveBlocks.erase(block);
+		}
+		++DeallocationCount;
+
+		Heap().Deallocate(memory, bytes, alignment);
+	}
+
+	virtual bool DoIsEqual(const MemoryResource& other) const override
+	{
+		return this == &other;
+	}
+};
+
+static MeshLayout FullLayout(uint32_t vertexCount)
+{
+	MeshLayout layout;
+	layout.VertexCount = vertexCount;
+	layout.HasNormals = true;
+	layout.HasTangents = true;
+	layout.HasBiNormals = true;
+	layout.TextureCoordinateChannelCount = 2;
+	layout.VertexColorChannelCount = 1;
+	layout.IndexCount = vertexCount * 3;
+
+	return layout;
+}
+
+static bool Throws(function<void()> action)
+{
+	try
+	{
+		action();
+	}
+	catch (const GameException&)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+template <typename T>
+static uintptr_t Address(Span<T> span)
+{
+	return reinterpret_cast<uintptr_t>(span.Data());
+}
+
+TEST_CASE(EmptyMeshDataAllocatesNothing)
+{
+	RecordingResource resource;
+	{
+		MeshData data(resource);
+		CHECK(&data.Resource() == &resource);
+		CHECK_EQUAL(0U, data.VertexCount());
+		CHECK(data.Vertices().IsEmpty());
+		CHECK(data.Normals().IsEmpty());
+		CHECK(data.Indices().IsEmpty());
+		CHECK(Throws([&]() { data.TextureCoordinates(0); }));
+		CHECK(Throws([&]() { data.VertexColors(0); }));
+
+		data.Allocate(MeshLayout());
+		CHECK(data.Vertices().IsEmpty());
+	}
+	CHECK_EQUAL(0U, resource.AllocationCount);
+	CHECK_EQUAL(0U, resource.DeallocationCount);
+}
+
+TEST_CASE(ChannelsShareOneAlignedAllocation)
+{
+	RecordingResource resource;
+	{
+		// An odd vertex count makes every channel's size a non-multiple of the alignment.
+		const uint32_t vertexCount = 7;
+		MeshData data(FullLayout(vertexCount), resource);
+		CHECK_EQUAL(1U, resource.AllocationCount);
+		CHECK_EQUAL(size_t(1), resource.LiveBlocks.size());
+
+		const uintptr_t blockStart = reinterpret_cast<uintptr_t>(resource.LiveBlocks.begin()->first);
+		const uintptr_t blockEnd = blockStart + resource.LiveBlocks.begin()->second.Bytes;
+		const vector<pair<uintptr_t, size_t>> channels =
+		{
+			{ Address(data.Vertices()), data.Vertices().Size() * sizeof(XMFLOAT3) },
+			{ Address(data.Normals()), data.Normals().Size() * sizeof(XMFLOAT3) },
+			{ Address(data.Tangents()), data.Tangents().Size() * sizeof(XMFLOAT3) },
+			{ Address(data.BiNormals()), data.BiNormals().Size() * sizeof(XMFLOAT3) },
+			{ Address(data.TextureCoordinates(0)), data.TextureCoordinates(0).Size() * sizeof(XMFLOAT3) },
+			{ Address(data.TextureCoordinates(1)), data.TextureCoordinates(1).Size() * sizeof(XMFLOAT3) },
+			{ Address(data.VertexColors(0)), data.VertexColors(0).Size() * sizeof(XMFLOAT4) },
+			{ Address(data.Indices()), data.Indices().Size() * sizeof(uint32_t) }
+		};
+
+		CHECK_EQUAL(blockStart, channels.front().first);
+		for (size_t i = 0; i < channels.size(); ++i)
+		{
+			CHECK_EQUAL(uintptr_t(0), channels[i].first % 16);
+			CHECK(channels[i].first + channels[i].second <= blockEnd);
+			if (i > 0)
+			{
+				CHECK(channels[i - 1].first + channels[i - 1].second <= channels[i].first);
+			}
+		}
+
+		CHECK_EQUAL(size_t(vertexCount), data.Vertices().Size());
+		CHECK_EQUAL(size_t(vertexCount * 3), data.Indices().Size());
+		CHECK(Throws([&]() { data.TextureCoordinates(2); }));
+		CHECK(Throws([&]() { data.VertexColors(1); }));
+
+		// Writing one channel leaves the others alone.
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			data.Vertices()[i] = XMFLOAT3(static_cast<float>(i), 0.0f, 0.0f);
+			data.VertexColors(0)[i] = XMFLOAT4(1.0f, 1.0f, 1.0f, static_cast<float>(i));
+			data.Normals()[i] = XMFLOAT3(0.0f, 1.0f, 0.0f);
+		}
+		for (uint32_t i = 0; i < vertexCount * 3; ++i)
+		{
+			data.Indices()[i] = i;
+		}
+		const MeshData& constData = data;
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			CHECK_EQUAL(static_cast<float>(i), constData.Vertices()[i].x);
+			CHECK_EQUAL(static_cast<float>(i), constData.VertexColors(0)[i].w);
+			CHECK_EQUAL(1.0f, constData.Normals()[i].y);
+		}
+		CHECK_EQUAL(vertexCount * 3 - 1, constData.Indices()[vertexCount * 3 - 1]);
+	}
+	CHECK_EQUAL(1U, resource.DeallocationCount);
+	CHECK(resource.LiveBlocks.empty());
+	CHECK(resource.IsConsistent);
+}
+
+TEST_CASE(MissingChannelsAreEmpty)
+{
+	MeshLayout layout;
+	layout.VertexCount = 4;
+	layout.IndexCount = 6;
+	MeshData data(layout);
+	CHECK_EQUAL(size_t(4), data.Vertices().Size());
+	CHECK(data.Normals().IsEmpty());
+	CHECK(data.Tangents().IsEmpty());
+	CHECK(data.BiNormals().IsEmpty());
+	CHECK_EQUAL(size_t(6), data.Indices().Size());
+	CHECK(&data.Resource() == &MemoryResource::Heap());
+
+	MeshLayout tooManyChannels = layout;
+	tooManyChannels.TextureCoordinateChannelCount = MeshLayout::MaxTextureCoordinateChannels + 1;
+	CHECK(Throws([&]() { data.Allocate(tooManyChannels); }));
+	tooManyChannels = layout;
+	tooManyChannels.VertexColorChannelCount = MeshLayout::MaxVertexColorChannels + 1;
+	CHECK(Throws([&]() { data.Allocate(tooManyChannels); }));
+
+	// A failed Allocate() keeps the old channels.
+	CHECK_EQUAL(size_t(4), data.Vertices().Size());
+}
+
+TEST_CASE(ReallocatingReleasesTheOldBlock)
+{
+	RecordingResource resource;
+	MeshData data(FullLayout(10), resource);
+	data.Allocate(FullLayout(100));
+	CHECK_EQUAL(2U, resource.AllocationCount);
+	CHECK_EQUAL(1U, resource.DeallocationCount);
+	CHECK_EQUAL(size_t(1), resource.LiveBlocks.size());
+	CHECK_EQUAL(size_t(100), data.Normals().Size());
+	CHECK(resource.IsConsistent);
+}
+
+TEST_CASE(MovingTakesTheBlockAndItsResource)
+{
+	RecordingResource first;
+	RecordingResource second;
+	{
+		MeshData source(FullLayout(5), first);
+		source.Name = "Sphere";
+		source.FaceCount = 5;
+		source.Vertices()[4] = XMFLOAT3(1.0f, 2.0f, 3.0f);
+		const XMFLOAT3* vertices = source.Vertices().Data();
+
+		MeshData moved(move(source));
+		CHECK(moved.Vertices().Data() == vertices);
+		CHECK(&moved.Resource() == &first);
+		CHECK_EQUAL(string("Sphere"), moved.Name);
+		CHECK_EQUAL(5U, moved.FaceCount);
+		CHECK_EQUAL(3.0f, moved.Vertices()[4].z);
+		CHECK(source.Vertices().IsEmpty());
+		CHECK_EQUAL(0U, source.FaceCount);
+		CHECK_EQUAL(0U, first.DeallocationCount);
+
+		// Assigning over a mesh from another resource frees its block there, then takes the new block and resource.
+		MeshData target(FullLayout(3), second);
+		target = move(moved);
+		CHECK_EQUAL(1U, second.DeallocationCount);
+		CHECK(second.LiveBlocks.empty());
+		CHECK(&target.Resource() == &first);
+		CHECK(target.Vertices().Data() == vertices);
+		CHECK(moved.Vertices().IsEmpty());
+
+		// Moving a mesh onto itself keeps its block.
+		MeshData& self = target;
+		target = move(self);
+		CHECK(target.Vertices().Data() == vertices);
+	}
+	CHECK_EQUAL(1U, first.AllocationCount);
+	CHECK_EQUAL(1U, first.DeallocationCount);
+	CHECK(first.IsConsistent);
+	CHECK(second.IsConsistent);
+}
+
+TEST_CASE(MeshesInALinearArenaAreFreedWithIt)
+{
+	LinearArena arena(64 * 1024);
+	{
+		vector<MeshData> meshes;
+		for (uint32_t i = 0; i < 20; ++i)
+		{
+			meshes.emplace_back(FullLayout(20), arena);
+		}
+		CHECK(arena.UsedBytes() >= 20 * 20 * (6 * sizeof(XMFLOAT3) + sizeof(XMFLOAT4) + 3 * sizeof(uint32_t)));
+		CHECK_EQUAL(0U, arena.OverflowCount());
+	}
+
+	// Destroying the meshes gives nothing back; resetting the arena frees them all.
+	CHECK(arena.UsedBytes() > 0);
+	arena.Reset();
+	CHECK_EQUAL(size_t(0), arena.UsedBytes());
+}
\ No newline at end of file
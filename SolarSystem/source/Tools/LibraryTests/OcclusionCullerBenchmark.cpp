@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "TestFrustums.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace Library;
+using namespace LibraryTests;
+
+// Usage: OcclusionCullerBenchmark [occluders] [spheres] [repetitions]
+// Rasterizes random sphere occluders on the calling thread and with a worker pool, then tests random spheres against them,
+// and reports the best time of each step.
+
+int main(int argc, char* argv[])
+{
+	const uint32_t occluderCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 100);
+	const uint32_t sphereCount = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 10000);
+	const uint32_t repetitions = (argc > 3 ? static_cast<uint32_t>(stoul(argv[3])) : 50);
+	if (occluderCount == 0 || sphereCount == 0 || repetitions == 0)
+	{
+		cerr << "Usage: OcclusionCullerBenchmark [occluders] [spheres] [repetitions]" << endl;
+		return 1;
+	}
+
+	float viewProjection[16];
+	TestFrustums::Perspective(0.785f, 16.0f / 9.0f, 0.5f, 1000.0f, viewProjection);
+
+	mt19937 generator(1);
+	uniform_real_distribution<float> xy(-150.0f, 150.0f);
+	uniform_real_distribution<float> z(-400.0f, -20.0f);
+	uniform_real_distribution<float> occluderRadius(2.0f, 20.0f);
+	uniform_real_distribution<float> sphereRadius(0.5f, 5.0f);
+
+	vector<float> occluders;
+	for (uint32_t i = 0; i < occluderCount; ++i)
+	{
+		occluders.push_back(xy(generator));
+		occluders.push_back(xy(generator));
+		occluders.push_back(z(generator));
+		occluders.push_back(occluderRadius(generator));
+	}
+
+	BoundingSphereSet spheres;
+	for (uint32_t i = 0; i < sphereCount; ++i)
+	{
+		spheres.Add(xy(generator), xy(generator), z(generator), sphereRadius(generator));
+	}
+
+	OcclusionCuller occlusionCuller;
+	ThreadPool workers;
+	double serialBest = numeric_limits<double>::max();
+	double parallelBest = numeric_limits<double>::max();
+	double cullBest = numeric_limits<double>::max();
+	uint32_t occludedCount = 0;
+	vector<uint8_t> visibility(sphereCount);
+	for (uint32_t repetition = 0; repetition < repetitions; ++repetition)
+	{
+		for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &workers })
+		{
+			occlusionCuller.BeginFrame(viewProjection);
+			for (uint32_t i = 0; i < occluderCount; ++i)
+			{
+				occlusionCuller.AddSphereOccluder(occluders[i * 4], occluders[i * 4 + 1], occluders[i * 4 + 2], occluders[i * 4 + 3]);
+			}
+
+			occlusionCuller.RasterizeOccluders(pool);
+			double& best = (pool == nullptr ? serialBest : parallelBest);
+			best = min(best, occlusionCuller.RasterizationMicroseconds());
+		}
+
+		fill(visibility.begin(), visibility.end(), static_cast<uint8_t>(1));
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		occludedCount = occlusionCuller.Cull(spheres, visibility.data());
+		cullBest = min(cullBest, duration<double, micro>(high_resolution_clock::now() - startTime).count());
+	}
+
+	cout << occluderCount << " occluders (" << occlusionCuller.OccluderCount() << " rasterized, " << occlusionCuller.TriangleCount() << " triangles), "
+		<< sphereCount << " spheres, " << occlusionCuller.Width() << "x" << occlusionCuller.Height() << " depth buffer, best of " << repetitions << endl;
+	cout << fixed << setprecision(1);
+	cout << "Rasterize on one thread:   " << setw(10) << serialBest << " us" << endl;
+	cout << "Rasterize on " << setw(2) << workers.ThreadCount() + 1 << " threads:    " << setw(10) << parallelBest << " us" << endl;
+	cout << "Test spheres:              " << setw(10) << cullBest << " us, " << occludedCount << " occluded" << endl;
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "pch.h"
+#include "TestFrustums.h"
+
+using namespace std;
+using namespace Library;
+using namespace LibraryTests;
+
+static void BeginFrame(OcclusionCuller& occlusionCuller)
+{
+	float viewProjection[16];
+	TestFrustums::Perspective(0.785f, 2.0f, 0.5f, 1000.0f, viewProjection);
+	occlusionCuller.BeginFrame(viewProjection);
+}
+
+// A square wall facing the camera at depth z, as two triangles wound one way or the other.
+static void AddWall(OcclusionCuller& occlusionCuller, float halfSize, float z, bool clockwise)
+{
+	const float positions[] =
+	{
+		-halfSize, -halfSize, z,
+		halfSize, -halfSize, z,
+		halfSize, halfSize, z,
+		-halfSize, halfSize, z
+	};
+	const uint32_t counterClockwiseIndices[] = { 0, 1, 2, 0, 2, 3 };
+	const uint32_t clockwiseIndices[] = { 0, 2, 1, 0, 3, 2 };
+
+	occlusionCuller.AddOccluder(positions, 4, (clockwise ? clockwiseIndices : counterClockwiseIndices), 6);
+}
+
+TEST_CASE(NothingIsOccludedWithoutOccluders)
+{
+	OcclusionCuller occlusionCuller;
+	BeginFrame(occlusionCuller);
+	occlusionCuller.RasterizeOccluders();
+
+	CHECK_EQUAL(0U, occlusionCuller.OccluderCount());
+	CHECK(occlusionCuller.IsOccluded(0.0f, 0.0f, -100.0f, 1.0f) == false);
+
+	BoundingSphereSet spheres;
+	spheres.Add(0.0f, 0.0f, -100.0f, 1.0f);
+	uint8_t visibility = 1;
+	CHECK_EQUAL(0U, occlusionCuller.Cull(spheres, &visibility));
+	CHECK_EQUAL(1, static_cast<int>(visibility));
+}
+
+TEST_CASE(SpheresBehindASphereAreOccluded)
+{
+	OcclusionCuller occlusionCuller;
+	BeginFrame(occlusionCuller);
+	occlusionCuller.AddSphereOccluder(0.0f, 0.0f, -50.0f, 10.0f);
+	occlusionCuller.RasterizeOccluders();
+	CHECK_EQUAL(1U, occlusionCuller.OccluderCount());
+
+	CHECK(occlusionCuller.IsOccluded(0.0f, 0.0f, -100.0f, 2.0f));
+	CHECK(occlusionCuller.IsOccluded(3.0f, -3.0f, -150.0f, 2.0f));
+
+	// In front of the occluder, around its edge, beside it, and straddling it.
+	CHECK(occlusionCuller.IsOccluded(0.0f, 0.0f, -30.0f, 2.0f) == false);
+	CHECK(occlusionCuller.IsOccluded(18.0f, 0.0f, -100.0f, 2.0f) == false);
+	CHECK(occlusionCuller.IsOccluded(60.0f, 0.0f, -100.0f, 2.0f) == false);
+	CHECK(occlusionCuller.IsOccluded(0.0f, 0.0f, -50.0f, 15.0f) == false);
+
+	// Spheres behind the camera, crossing the near plane or without bounds are never reported hidden.
+	CHECK(occlusionCuller.IsOccluded(0.0f, 0.0f, 100.0f, 2.0f) == false);
+	CHECK(occlusionCuller.IsOccluded(0.0f, 0.0f, -0.5f, 2.0f) == false);
+	CHECK(occlusionCuller.IsOccluded(0.0f, 0.0f, -100.0f, numeric_limits<float>::max()) == false);
+
+	BoundingSphereSet spheres;
+	spheres.Add(0.0f, 0.0f, -100.0f, 2.0f);
+	spheres.Add(60.0f, 0.0f, -100.0f, 2.0f);
+	spheres.Add(0.0f, 0.0f, -120.0f, 2.0f);
+	uint8_t visibility[] = { 1, 1, 0 };
+	CHECK_EQUAL(1U, occlusionCuller.Cull(spheres, visibility));
+	CHECK_EQUAL(0, static_cast<int>(visibility[0]));
+	CHECK_EQUAL(1, static_cast<int>(visibility[1]));
+	CHECK_EQUAL(0, static_cast<int>(visibility[2]));
+}
+
+TEST_CASE(WallsOccludeWithEitherWinding)
+{
+	for (bool clockwise : { false, true })
+	{
+		OcclusionCuller occlusionCuller;
+		BeginFrame(occlusionCuller);
+		AddWall(occlusionCuller, 20.0f, -40.0f, clockwise);
+		occlusionCuller.RasterizeOccluders();
+
+		CHECK_EQUAL(2U, occlusionCuller.TriangleCount());
+
+		// The diagonal the triangles share passes through pixel centres; every row must still be one unbroken run.
+		for (uint32_t row = 0; row < occlusionCuller.Height(); ++row)
+		{
+			const float* depthRow = occlusionCuller.DepthBuffer() + row * occlusionCuller.Width();
+			uint32_t runCount = 0;
+			for (uint32_t column = 0; column < occlusionCuller.Width(); ++column)
+			{
+				if (depthRow[column] < numeric_limits<float>::max() && (column == 0 || depthRow[column - 1] == numeric_limits<float>::max()))
+				{
+					++runCount;
+				}
+			}
+
+			CHECK_EQUAL(1U, runCount);
+		}
+
+		CHECK(occlusionCuller.IsOccluded(0.0f, 0.0f, -100.0f, 5.0f));
+		CHECK(occlusionCuller.IsOccluded(0.0f, 0.0f, -39.0f, 0.5f) == false);
+	}
+}
+
+TEST_CASE(SmallOrClippedOccludersAreSkipped)
+{
+	OcclusionCuller occlusionCuller;
+	BeginFrame(occlusionCuller);
+
+	// Well under MinOccluderRadius pixels across, and crossing the near plane.
+	occlusionCuller.AddSphereOccluder(0.0f, 0.0f, -900.0f, 0.5f);
+	occlusionCuller.AddSphereOccluder(0.0f, 0.0f, -1.0f, 2.0f);
+	occlusionCuller.AddSphereOccluder(0.0f, 0.0f, -50.0f, 0.0f);
+	occlusionCuller.RasterizeOccluders();
+
+	CHECK_EQUAL(0U, occlusionCuller.OccluderCount());
+	CHECK_EQUAL(0U, occlusionCuller.TriangleCount());
+	CHECK(occlusionCuller.IsOccluded(0.0f, 0.0f, -950.0f, 0.1f) == false);
+}
+
+TEST_CASE(WorkersRasterizeTheSameDepthBuffer)
+{
+	mt19937 generator(1);
+	uniform_real_distribution<float> xy(-100.0f, 100.0f);
+	uniform_real_distribution<float> z(-400.0f, -20.0f);
+	uniform_real_distribution<float> radius(2.0f, 20.0f);
+
+	OcclusionCuller serial;
+	OcclusionCuller parallel;
+	BeginFrame(serial);
+	BeginFrame(parallel);
+	for (uint32_t i = 0; i < 50; ++i)
+	{
+		const float x = xy(generator);
+		const float y = xy(generator);
+		const float depth = z(generator);
+		const float sphereRadius = radius(generator);
+		serial.AddSphereOccluder(x, y, depth, sphereRadius);
+		parallel.AddSphereOccluder(x, y, depth, sphereRadius);
+	}
+
+	ThreadPool workers(3);
+	serial.RasterizeOccluders();
+	parallel.RasterizeOccluders(&workers);
+
+	CHECK_EQUAL(serial.OccluderCount(), parallel.OccluderCount());
+	CHECK(serial.OccluderCount() > 0);
+	CHECK(memcmp(serial.DepthBuffer(), parallel.DepthBuffer(), serial.Width() * serial.Height() * sizeof(float)) == 0);
+
+	// Some of the buffer is covered and some isn't.
+	const float* depthBuffer = serial.DepthBuffer();
+	const uint32_t coveredCount = static_cast<uint32_t>(count_if(depthBuffer, depthBuffer + serial.Width() * serial.Height(), [](float depth) { return depth < numeric_limits<float>::max(); }));
+	CHECK(coveredCount > 0 && coveredCount < serial.Width() * serial.Height());
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "pch.h"
+#include "OrbitingBody.h"
+
+using namespace DirectX;
+using namespace Library;
+
+namespace LibraryTests
+{
+	OrbitingBody::OrbitingBody(float orbitRadius, float orbitalSpeed, float orbitalAngle, float radius) :
+		mOrbitRadius(orbitRadius), mOrbitalSpeed(orbitalSpeed), mOrbitalAngle(orbitalAngle), mAxialAngle(0.0f), mRadius(radius),
+		mPosition(orbitRadius * cosf(orbitalAngle), 0.0f, orbitRadius * sinf(orbitalAngle)), mUpdateCount(0), mLastUpdateSeconds(0.0f),
+		mLastExtrapolationSeconds(0.0f)
+	{
+		XMStoreFloat4x4(&mWorldMatrix, XMMatrixTranslation(mPosition.x, mPosition.y, mPosition.z));
+	}
+
+	XMFLOAT3 OrbitingBody::SchedulingPosition() const
+	{
+		return mPosition;
+	}
+
+	float OrbitingBody::SchedulingRadius() const
+	{
+		return mRadius;
+	}
+
+	void OrbitingBody::ScheduledUpdate(float elapsedSeconds)
+	{
+		mOrbitalAngle += mOrbitalSpeed * elapsedSeconds;
+		mAxialAngle += mOrbitalSpeed * 10.0f * elapsedSeconds;
+
+		XMMATRIX worldMatrix = XMMatrixScaling(mRadius, mRadius, mRadius) * XMMatrixRotationY(mAxialAngle) * XMMatrixRotationZ(0.4f) *
+			XMMatrixTranslation(mOrbitRadius, 0.0f, 0.0f) * XMMatrixRotationY(-mOrbitalAngle);
+		XMStoreFloat4x4(&mWorldMatrix, worldMatrix);
+		mPosition = XMFLOAT3(mWorldMatrix._41, mWorldMatrix._42, mWorldMatrix._43);
+
+		++mUpdateCount;
+		mLastUpdateSeconds = elapsedSeconds;
+	}
+
+	void OrbitingBody::Extrapolate(float elapsedSeconds)
+	{
+		mLastExtrapolationSeconds = elapsedSeconds;
+		if (elapsedSeconds > 0.0f)
+		{
+			const float angle = mOrbitalAngle + mOrbitalSpeed * elapsedSeconds;
+			mPosition = XMFLOAT3(mOrbitRadius * cosf(angle), 0.0f, mOrbitRadius * sinf(angle));
+		}
+	}
+
+	void OrbitingBody::SaveSnapshot(OutputStreamHelper& streamHelper) const
+	{
+		streamHelper << mOrbitalAngle << mAxialAngle;
+		streamHelper << mPosition.x << mPosition.y << mPosition.z;
+		streamHelper << mWorldMatrix;
+		streamHelper << mUpdateCount << mLastUpdateSeconds << mLastExtrapolationSeconds;
+	}
+
+	void OrbitingBody::LoadSnapshot(InputStreamHelper& streamHelper)
+	{
+		streamHelper >> mOrbitalAngle >> mAxialAngle;
+		streamHelper >> mPosition.x >> mPosition.y >> mPosition.z;
+		streamHelper >> mWorldMatrix;
+		streamHelper >> mUpdateCount >> mLastUpdateSeconds >> mLastExtrapolationSeconds;
+	}
+
+	float OrbitingBody::OrbitalAngle() const
+	{
+		return mOrbitalAngle;
+	}
+
+	const XMFLOAT3& OrbitingBody::Position() const
+	{
+		return mPosition;
+	}
+
+	const XMFLOAT4X4& OrbitingBody::WorldMatrix() const
+	{
+		return mWorldMatrix;
+	}
+
+	uint32_t OrbitingBody::UpdateCount() const
+	{
+		return mUpdateCount;
+	}
+
+	float OrbitingBody::LastUpdateSeconds() const
+	{
+		return mLastUpdateSeconds;
+	}
+
+	float OrbitingBody::LastExtrapolationSeconds() const
+	{
+		return mLastExtrapolationSeconds;
+	}
+}
\ No newline at end of file
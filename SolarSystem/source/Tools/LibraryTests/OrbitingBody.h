@@ -0,0 +1,49 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include "UpdateScheduler.h"
+#include "SnapshotBuffer.h"
+
+namespace LibraryTests
+{
+	// A body on a circular orbit in the XZ plane, spinning on a tilted axis. Its full update composes the same five matrices
+	// CelestialBodies does; Extrapolate() only advances its position along the orbit.
+	class OrbitingBody final : public Library::IScheduledUpdatable, public Library::ISnapshotable
+	{
+	public:
+		OrbitingBody(float orbitRadius, float orbitalSpeed, float orbitalAngle, float radius);
+		OrbitingBody(const OrbitingBody&) = default;
+		OrbitingBody& operator=(const OrbitingBody&) = default;
+		OrbitingBody(OrbitingBody&&) = default;
+		OrbitingBody& operator=(OrbitingBody&&) = default;
+		~OrbitingBody() = default;
+
+		DirectX::XMFLOAT3 SchedulingPosition() const override;
+		float SchedulingRadius() const override;
+		void ScheduledUpdate(float elapsedSeconds) override;
+		void Extrapolate(float elapsedSeconds) override;
+		void SaveSnapshot(Library::OutputStreamHelper& streamHelper) const override;
+		void LoadSnapshot(Library::InputStreamHelper& streamHelper) override;
+
+		float OrbitalAngle() const;
+		const DirectX::XMFLOAT3& Position() const;
+		const DirectX::XMFLOAT4X4& WorldMatrix() const;
+
+		std::uint32_t UpdateCount() const;
+		float LastUpdateSeconds() const;
+		float LastExtrapolationSeconds() const;
+
+	private:
+		float mOrbitRadius;
+		float mOrbitalSpeed;
+		float mOrbitalAngle;
+		float mAxialAngle;
+		float mRadius;
+		DirectX::XMFLOAT3 mPosition;
+		DirectX::XMFLOAT4X4 mWorldMatrix;
+		std::uint32_t mUpdateCount;
+		float mLastUpdateSeconds;
+		float mLastExtrapolationSeconds;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "pch.h"
+#include "OrbitingField.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace DirectX;
+using namespace Library;
+
+namespace LibraryTests
+{
+	const XMFLOAT3 OrbitingField::CameraPosition = XMFLOAT3(0.0f, 500.0f, 2000.0f);
+
+	OrbitingField::OrbitingField(uint32_t bodyCount, microseconds frameBudget, uint32_t seed) :
+		mScheduler(frameBudget),
+		mProjectionScale(UpdateScheduler::ProjectionScale(XMMatrixPerspectiveFovRH(XM_PIDIV4, 16.0f / 9.0f, 0.5f, 10000.0f), 1080.0f))
+	{
+		mt19937 generator(seed);
+		uniform_real_distribution<float> orbitRadius(20.0f, 5000.0f);
+		uniform_real_distribution<float> angle(0.0f, XM_2PI);
+		uniform_real_distribution<float> radius(0.5f, 5.0f);
+
+		mBodies.reserve(bodyCount);
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			const float distance = orbitRadius(generator);
+			mBodies.emplace_back(distance, 20.0f / distance, angle(generator), radius(generator));
+		}
+
+		for (OrbitingBody& body : mBodies)
+		{
+			mScheduler.Register(body);
+		}
+	}
+
+	vector<OrbitingBody>& OrbitingField::Bodies()
+	{
+		return mBodies;
+	}
+
+	UpdateScheduler& OrbitingField::Scheduler()
+	{
+		return mScheduler;
+	}
+
+	void OrbitingField::Update(const GameTime& gameTime)
+	{
+		mScheduler.Update(gameTime, XMLoadFloat3(&CameraPosition), mProjectionScale);
+	}
+
+	void OrbitingField::SaveSnapshot(OutputStreamHelper& streamHelper) const
+	{
+		for (const OrbitingBody& body : mBodies)
+		{
+			body.SaveSnapshot(streamHelper);
+		}
+
+		mScheduler.SaveSnapshot(streamHelper);
+	}
+
+	void OrbitingField::LoadSnapshot(InputStreamHelper& streamHelper)
+	{
+		for (OrbitingBody& body : mBodies)
+		{
+			body.LoadSnapshot(streamHelper);
+		}
+
+		mScheduler.LoadSnapshot(streamHelper);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "OrbitingBody.h"
+
+namespace LibraryTests
+{
+	// A seeded random field of OrbitingBody (orbits of 20 to 5000 units) registered with its own UpdateScheduler, viewed from a
+	// fixed camera 2000 units out. Its snapshot is every body followed by the scheduler.
+	class OrbitingField final : public Library::ISnapshotable
+	{
+	public:
+		OrbitingField(std::uint32_t bodyCount, std::chrono::microseconds frameBudget, std::uint32_t seed = 1);
+		OrbitingField(const OrbitingField&) = delete;
+		OrbitingField& operator=(const OrbitingField&) = delete;
+		OrbitingField(OrbitingField&&) = delete;
+		OrbitingField& operator=(OrbitingField&&) = delete;
+		~OrbitingField() = default;
+
+		std::vector<OrbitingBody>& Bodies();
+		Library::UpdateScheduler& Scheduler();
+
+		void Update(const Library::GameTime& gameTime);
+
+		void SaveSnapshot(Library::OutputStreamHelper& streamHelper) const override;
+		void LoadSnapshot(Library::InputStreamHelper& streamHelper) override;
+
+		static const DirectX::XMFLOAT3 CameraPosition;
+
+	private:
+		std::vector<OrbitingBody> mBodies;
+		Library::UpdateScheduler mScheduler;
+		float mProjectionScale;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+// The profiler is process-wide, so every case starts from a cleared, enabled profiler and only looks at its own thread.
+static void StartCapture()
+{
+	Profiler::SetEnabled(true);
+	Profiler::Clear();
+}
+
+static const Profiler::ThreadEvents* FindThread(const vector<Profiler::ThreadEvents>& threads, const string& name)
+{
+	for (const Profiler::ThreadEvents& threadEvents : threads)
+	{
+		if (threadEvents.ThreadName == name)
+		{
+			return &threadEvents;
+		}
+	}
+
+	return nullptr;
+}
+
+static uint64_t ReadVarint(istream& stream)
+{
+	uint64_t value = 0;
+	for (uint32_t shift = 0; ; shift += 7)
+	{
+		const int byte = stream.get();
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return value;
+		}
+	}
+}
+
+static string ReadString(istream& stream)
+{
+	string value(static_cast<size_t>(ReadVarint(stream)), '\0');
+	stream.read(&value[0], static_cast<streamsize>(value.size()));
+
+	return value;
+}
+
+TEST_CASE(DisabledScopesRecordNothing)
+{
+	StartCapture();
+	Profiler::SetEnabled(false);
+	{
+		PROFILE_SCOPE("Disabled");
+	}
+
+	CHECK(Profiler::IsEnabled() == false);
+	CHECK(Profiler::Collect().empty());
+}
+
+TEST_CASE(NestedScopesRecordDepthAndContainment)
+{
+	Profiler::SetThreadName("Nested");
+	StartCapture();
+	{
+		PROFILE_SCOPE("Outer");
+		{
+			PROFILE_SCOPE("Inner");
+			{
+				PROFILE_SCOPE("Innermost");
+			}
+		}
+		{
+			PROFILE_SCOPE("Sibling");
+		}
+	}
+	Profiler::SetEnabled(false);
+
+	const vector<Profiler::ThreadEvents> threads = Profiler::Collect();
+	CHECK_EQUAL(size_t(1), threads.size());
+	const Profiler::ThreadEvents* thread = FindThread(threads, "Nested");
+	CHECK(thread != nullptr);
+	if (thread == nullptr || thread->Events.size() != 4)
+	{
+		CHECK(false);
+		return;
+	}
+
+	// Collect() orders events by start, so parents come before their children.
+	const vector<Profiler::Event>& events = thread->Events;
+	CHECK_EQUAL(string("Outer"), string(events[0].Name));
+	CHECK_EQUAL(string("Inner"), string(events[1].Name));
+	CHECK_EQUAL(string("Innermost"), string(events[2].Name));
+	CHECK_EQUAL(string("Sibling"), string(events[3].Name));
+	CHECK_EQUAL(0U, events[0].Depth);
+	CHECK_EQUAL(1U, events[1].Depth);
+	CHECK_EQUAL(2U, events[2].Depth);
+	CHECK_EQUAL(1U, events[3].Depth);
+	CHECK_EQUAL(0U, thread->DroppedCount);
+
+	for (size_t i = 1; i < events.size(); ++i)
+	{
+		CHECK(events[i].Start >= events[i - 1].Start);
+		CHECK(events[i].Start >= events[0].Start);
+		CHECK(events[i].Start + events[i].Duration <= events[0].Start + events[0].Duration);
+	}
+	CHECK(events[2].Start + events[2].Duration <= events[1].Start + events[1].Duration);
+	CHECK(events[3].Start >= events[1].Start + events[1].Duration);
+}
+
+TEST_CASE(ClearDiscardsEarlierEvents)
+{
+	StartCapture();
+	{
+		PROFILE_SCOPE("BeforeClear");
+	}
+	Profiler::Clear();
+	CHECK(Profiler::Collect().empty());
+
+	{
+		PROFILE_SCOPE("AfterClear");
+	}
+	Profiler::SetEnabled(false);
+
+	const vector<Profiler::ThreadEvents> threads = Profiler::Collect();
+	CHECK_EQUAL(size_t(1), threads.size());
+	CHECK(threads.empty() == false && threads[0].Events.size() == 1 && string(threads[0].Events[0].Name) == "AfterClear");
+}
+
+TEST_CASE(ScopesOpenAcrossClearAreKept)
+{
+	StartCapture();
+	{
+		PROFILE_SCOPE("Open");
+		Profiler::Clear();
+	}
+	Profiler::SetEnabled(false);
+
+	const vector<Profiler::ThreadEvents> threads = Profiler::Collect();
+	CHECK(threads.size() == 1 && threads[0].Events.size() == 1 && string(threads[0].Events[0].Name) == "Open");
+}
+
+TEST_CASE(EachThreadRecordsIntoItsOwnBuffer)
+{
+	StartCapture();
+	{
+		PROFILE_SCOPE("Main");
+	}
+
+	const uint32_t workerCount = 4;
+	const uint32_t scopesPerWorker = 1000;
+	vector<thread> workers;
+	for (uint32_t i = 0; i < workerCount; ++i)
+	{
+		workers.emplace_back([i]()
+		{
+			Profiler::SetThreadName("Worker " + to_string(i));
+			for (uint32_t j = 0; j < scopesPerWorker; ++j)
+			{
+				PROFILE_SCOPE("Work");
+			}
+		});
+	}
+	for (thread& worker : workers)
+	{
+		worker.join();
+	}
+	Profiler::SetEnabled(false);
+
+	// Buffers outlive their threads.
+	const vector<Profiler::ThreadEvents> threads = Profiler::Collect();
+	CHECK_EQUAL(size_t(workerCount + 1), threads.size());
+	set<uint32_t> threadIndices;
+	for (const Profiler::ThreadEvents& threadEvents : threads)
+	{
+		threadIndices.insert(threadEvents.ThreadIndex);
+	}
+	CHECK_EQUAL(threads.size(), threadIndices.size());
+
+	for (uint32_t i = 0; i < workerCount; ++i)
+	{
+		const Profiler::ThreadEvents* worker = FindThread(threads, "Worker " + to_string(i));
+		CHECK(worker != nullptr);
+		if (worker != nullptr)
+		{
+			CHECK_EQUAL(size_t(scopesPerWorker), worker->Events.size());
+			CHECK(all_of(worker->Events.begin(), worker->Events.end(), [](const Profiler::Event& event)
+			{
+				return string(event.Name) == "Work" && event.Depth == 0;
+			}));
+		}
+	}
+}
+
+TEST_CASE(FullBuffersCountDroppedEvents)
+{
+	StartCapture();
+	const uint32_t extra = 10;
+	for (uint32_t i = 0; i < Profiler::EventCapacityPerThread + extra; ++i)
+	{
+		PROFILE_SCOPE("Flood");
+	}
+	Profiler::SetEnabled(false);
+
+	const vector<Profiler::ThreadEvents> threads = Profiler::Collect();
+	CHECK_EQUAL(size_t(1), threads.size());
+	if (threads.size() == 1)
+	{
+		CHECK_EQUAL(size_t(Profiler::EventCapacityPerThread), threads[0].Events.size());
+		CHECK_EQUAL(extra, threads[0].DroppedCount);
+	}
+
+	// Clearing resets the drop count along with the events.
+	StartCapture();
+	{
+		PROFILE_SCOPE("AfterFlood");
+	}
+	Profiler::SetEnabled(false);
+	const vector<Profiler::ThreadEvents> cleared = Profiler::Collect();
+	CHECK(cleared.size() == 1 && cleared[0].Events.size() == 1 && cleared[0].DroppedCount == 0);
+}
+
+TEST_CASE(ChromeTraceEscapesNamesAndNamesThreads)
+{
+	Profiler::SetThreadName("Trace \"main\"");
+	StartCapture();
+	{
+		PROFILE_SCOPE("Quote\" Backslash\\ Newline\n Tab\t");
+	}
+	Profiler::SetEnabled(false);
+
+	ostringstream stream;
+	Profiler::ExportChromeTrace(stream);
+	const string trace = stream.str();
+
+	CHECK(trace.find("{\"traceEvents\":[") == 0);
+	CHECK(trace.find("\"name\":\"Quote\\\" Backslash\\\\ Newline\\n Tab\\u0009\"") != string::npos);
+	CHECK(trace.find("\"ph\":\"X\"") != string::npos);
+	CHECK(trace.find("\"ts\":0.000") != string::npos);
+	CHECK(trace.find("{\"name\":\"thread_name\",\"ph\":\"M\"") != string::npos);
+	CHECK(trace.find("\"args\":{\"name\":\"Trace \\\"main\\\"\"}") != string::npos);
+	CHECK(trace.find("\"displayTimeUnit\":\"ns\"}") != string::npos);
+
+	// Formatting is restored for whoever writes to the stream next.
+	stream << 1.5;
+	CHECK(stream.str().substr(trace.size()) == "1.5");
+}
+
+TEST_CASE(BinaryTraceRoundTrips)
+{
+	Profiler::SetThreadName("Binary");
+	StartCapture();
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		PROFILE_SCOPE("Frame");
+		{
+			PROFILE_SCOPE("Update");
+		}
+		{
+			PROFILE_SCOPE("Draw");
+		}
+	}
+	Profiler::SetEnabled(false);
+
+	const vector<Profiler::ThreadEvents> threads = Profiler::Collect();
+	stringstream stream;
+	Profiler::ExportBinary(stream);
+
+	char magic[4];
+	stream.read(magic, sizeof(magic));
+	CHECK(string(magic, sizeof(magic)) == "PRFL");
+	CHECK_EQUAL(uint64_t(Profiler::BinaryVersion), ReadVarint(stream));
+
+	vector<string> names(static_cast<size_t>(ReadVarint(stream)));
+	for (string& name : names)
+	{
+		name = ReadString(stream);
+	}
+	CHECK_EQUAL(size_t(3), names.size());
+
+	const uint64_t baseTime = ReadVarint(stream);
+	CHECK_EQUAL(uint64_t(threads.size()), ReadVarint(stream));
+	for (const Profiler::ThreadEvents& threadEvents : threads)
+	{
+		CHECK_EQUAL(uint64_t(threadEvents.ThreadIndex), ReadVarint(stream));
+		CHECK_EQUAL(threadEvents.ThreadName, ReadString(stream));
+		CHECK_EQUAL(uint64_t(threadEvents.DroppedCount), ReadVarint(stream));
+		CHECK_EQUAL(uint64_t(threadEvents.Events.size()), ReadVarint(stream));
+
+		uint64_t start = baseTime;
+		for (const Profiler::Event& event : threadEvents.Events)
+		{
+			const uint64_t nameIndex = ReadVarint(stream);
+			CHECK(nameIndex < names.size() && names[static_cast<size_t>(nameIndex)] == event.Name);
+			CHECK_EQUAL(uint64_t(event.Depth), ReadVarint(stream));
+			start += ReadVarint(stream);
+			CHECK_EQUAL(event.Start, start);
+			CHECK_EQUAL(event.Duration, ReadVarint(stream));
+		}
+	}
+
+	CHECK(stream.good());
+	stream.get();
+	CHECK(stream.eof());
+}
+
+TEST_CASE(EmptyBinaryTraceHasNoThreads)
+{
+	StartCapture();
+	Profiler::SetEnabled(false);
+
+	stringstream stream;
+	Profiler::ExportBinary(stream);
+	const string expected = string("PRFL") + static_cast<char>(Profiler::BinaryVersion) + '\0' + '\0' + '\0';
+	CHECK(stream.str() == expected);
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace Library;
+
+// Usage: RTTIBenchmark [components] [repetitions]
+// Queries a shuffled mix of components, shaped like the game's hierarchy, with As<>(), Is<T>(), Is(id) and Is(name), with
+// dynamic_cast<> for reference, and reports the best time per query of each in nanoseconds.
+
+class Component : public RTTI
+{
+	RTTI_DECLARATIONS(Component, RTTI)
+};
+
+class DrawableComponent : public Component
+{
+	RTTI_DECLARATIONS(DrawableComponent, Component)
+};
+
+class Camera : public Component
+{
+	RTTI_DECLARATIONS(Camera, Component)
+};
+
+class PerspectiveCamera : public Camera
+{
+	RTTI_DECLARATIONS(PerspectiveCamera, Camera)
+};
+
+class FirstPersonCamera final : public PerspectiveCamera
+{
+	RTTI_DECLARATIONS(FirstPersonCamera, PerspectiveCamera)
+};
+
+class Body final : public DrawableComponent
+{
+	RTTI_DECLARATIONS(Body, DrawableComponent)
+};
+
+class Skybox final : public DrawableComponent
+{
+	RTTI_DECLARATIONS(Skybox, DrawableComponent)
+};
+
+RTTI_DEFINITIONS(Component)
+RTTI_DEFINITIONS(DrawableComponent)
+RTTI_DEFINITIONS(Camera)
+RTTI_DEFINITIONS(PerspectiveCamera)
+RTTI_DEFINITIONS(FirstPersonCamera)
+RTTI_DEFINITIONS(Body)
+RTTI_DEFINITIONS(Skybox)
+
+static void CreateComponents(vector<unique_ptr<Component>>& components, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		switch (i % 5)
+		{
+		case 0:
+			components.push_back(make_unique<Component>());
+			break;
+
+		case 1:
+			components.push_back(make_unique<FirstPersonCamera>());
+			break;
+
+		case 2:
+			components.push_back(make_unique<Skybox>());
+			break;
+
+		default:
+			components.push_back(make_unique<Body>());
+			break;
+		}
+	}
+
+	shuffle(components.begin(), components.end(), mt19937(1));
+}
+
+template <typename TQuery>
+static double BestNanoseconds(const vector<unique_ptr<Component>>& components, uint32_t repetitions, TQuery query)
+{
+	double best = numeric_limits<double>::max();
+	for (uint32_t i = 0; i < repetitions; ++i)
+	{
+		uint32_t matchCount = 0;
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		for (const unique_ptr<Component>& component : components)
+		{
+			matchCount += (query(*component) ? 1 : 0);
+		}
+		best = min(best, duration<double, nano>(high_resolution_clock::now() - startTime).count());
+
+		// Keeps the queries from being optimized away.
+		if (matchCount > components.size())
+		{
+			cerr << "Unreachable" << endl;
+		}
+	}
+
+	return best / components.size();
+}
+
+template <typename TAs, typename TIs, typename TDynamicCast>
+static void Run(const char* name, const vector<unique_ptr<Component>>& components, uint32_t repetitions, uint64_t id, const string& typeName,
+	TAs as, TIs is, TDynamicCast dynamicCast)
+{
+	const double asTime = BestNanoseconds(components, repetitions, as);
+	const double isTime = BestNanoseconds(components, repetitions, is);
+	const double isIdTime = BestNanoseconds(components, repetitions, [id](const Component& component) { return component.Is(id); });
+	const double isNameTime = BestNanoseconds(components, repetitions, [&typeName](const Component& component) { return component.Is(typeName); });
+	const double dynamicCastTime = BestNanoseconds(components, repetitions, dynamicCast);
+
+	cout << left << setw(20) << name << right << fixed << setprecision(2) << setw(10) << asTime << setw(10) << isTime << setw(10) << isIdTime
+		<< setw(12) << isNameTime << setw(14) << dynamicCastTime << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t componentCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 10000);
+	const uint32_t repetitions = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 200);
+	if (componentCount == 0 || repetitions == 0)
+	{
+		cerr << "Usage: RTTIBenchmark [components] [repetitions]" << endl;
+		return 1;
+	}
+
+	vector<unique_ptr<Component>> components;
+	CreateComponents(components, componentCount);
+
+	cout << componentCount << " components, best of " << repetitions << "; nanoseconds per query" << endl;
+	cout << left << setw(20) << "" << right << setw(10) << "As<>" << setw(10) << "Is<T>" << setw(10) << "Is(id)" << setw(12) << "Is(name)" << setw(14) << "dynamic_cast" << endl;
+
+	// A shallow type most components are, and the deepest type, which most components are not.
+	Run("DrawableComponent", components, repetitions, DrawableComponent::TypeIdClass(), DrawableComponent::TypeName(),
+		[](const Component& component) { return component.As<DrawableComponent>() != nullptr; },
+		[](const Component& component) { return component.Is<DrawableComponent>(); },
+		[](const Component& component) { return dynamic_cast<const DrawableComponent*>(&component) != nullptr; });
+	Run("FirstPersonCamera", components, repetitions, FirstPersonCamera::TypeIdClass(), FirstPersonCamera::TypeName(),
+		[](const Component& component) { return component.As<FirstPersonCamera>() != nullptr; },
+		[](const Component& component) { return component.Is<FirstPersonCamera>(); },
+		[](const Component& component) { return dynamic_cast<const FirstPersonCamera*>(&component) != nullptr; });
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+// Shaped like the game's component hierarchy: Component <- DrawableComponent <- Body, with an unrelated Service.
+class Component : public RTTI
+{
+	RTTI_DECLARATIONS(Component, RTTI)
+};
+
+class DrawableComponent : public Component
+{
+	RTTI_DECLARATIONS(DrawableComponent, Component)
+
+public:
+	virtual string ToString() const override
+	{
+		return "Drawable";
+	}
+};
+
+class Body final : public DrawableComponent
+{
+	RTTI_DECLARATIONS(Body, DrawableComponent)
+};
+
+class Service final : public RTTI
+{
+	RTTI_DECLARATIONS(Service, RTTI)
+};
+
+RTTI_DEFINITIONS(Component)
+RTTI_DEFINITIONS(DrawableComponent)
+RTTI_DEFINITIONS(Body)
+RTTI_DEFINITIONS(Service)
+
+TEST_CASE(TypeIdsAreDistinctAndMatchTheInstance)
+{
+	const set<uint64_t> ids = { Component::TypeIdClass(), DrawableComponent::TypeIdClass(), Body::TypeIdClass(), Service::TypeIdClass() };
+	CHECK_EQUAL(size_t(4), ids.size());
+
+	Body body;
+	const RTTI& rtti = body;
+	CHECK_EQUAL(Body::TypeIdClass(), rtti.TypeIdInstance());
+	CHECK_EQUAL(string("Body"), string(rtti.TypeNameInstance()));
+	CHECK_EQUAL(string("Body"), Body::TypeName());
+	CHECK_EQUAL(string("Drawable"), rtti.ToString());
+	CHECK(rtti.Equals(&body));
+	CHECK(rtti.Equals(nullptr) == false);
+}
+
+TEST_CASE(IsMatchesTheTypeAndEveryAncestor)
+{
+	Body body;
+	Component component;
+	Service service;
+	const RTTI* bodyRtti = &body;
+	const RTTI* componentRtti = &component;
+	const RTTI* serviceRtti = &service;
+
+	CHECK(bodyRtti->Is(Body::TypeIdClass()));
+	CHECK(bodyRtti->Is(DrawableComponent::TypeIdClass()));
+	CHECK(bodyRtti->Is(Component::TypeIdClass()));
+	CHECK(bodyRtti->Is(Service::TypeIdClass()) == false);
+
+	CHECK(componentRtti->Is(Component::TypeIdClass()));
+	CHECK(componentRtti->Is(DrawableComponent::TypeIdClass()) == false);
+	CHECK(componentRtti->Is(Body::TypeIdClass()) == false);
+
+	CHECK(serviceRtti->Is(Service::TypeIdClass()));
+	CHECK(serviceRtti->Is(Component::TypeIdClass()) == false);
+	CHECK(serviceRtti->Is(0) == false);
+
+	CHECK(bodyRtti->Is("Body"));
+	CHECK(bodyRtti->Is("DrawableComponent"));
+	CHECK(bodyRtti->Is("Component"));
+	CHECK(bodyRtti->Is("Service") == false);
+	CHECK(bodyRtti->Is("Bod") == false);
+	CHECK(componentRtti->Is("Body") == false);
+	CHECK(serviceRtti->Is("") == false);
+
+	CHECK(bodyRtti->Is<Body>());
+	CHECK(bodyRtti->Is<DrawableComponent>());
+	CHECK(bodyRtti->Is<Component>());
+	CHECK(bodyRtti->Is<Service>() == false);
+	CHECK(componentRtti->Is<DrawableComponent>() == false);
+	CHECK(serviceRtti->Is<Body>() == false);
+}
+
+TEST_CASE(TypeNamesAreHashedAtCompileTime)
+{
+	static_assert(Body::TypeNameHash == RTTI::HashTypeName("Body"), "Type name hashes must be constant expressions.");
+	static_assert(RTTI::HashTypeName("") == 2166136261U, "FNV-1a leaves an empty name at its offset basis.");
+	static_assert(RTTI::HashTypeName("a") == 0xE40C292CU, "FNV-1a's published value for \"a\".");
+	static_assert(Component::TypeDepth == 1 && Body::TypeDepth == 3, "A type is one deeper than its parent.");
+
+	CHECK(Body::TypeNameHash != DrawableComponent::TypeNameHash);
+	CHECK_EQUAL(3U, Body().TypeInfoInstance().Depth);
+}
+
+TEST_CASE(AsAndQueryInterfaceCastOnlyToTheTypeOrItsAncestors)
+{
+	Body body;
+	Component component;
+	Service service;
+	const RTTI* bodyRtti = &body;
+	const RTTI* componentRtti = &component;
+	const RTTI* serviceRtti = &service;
+
+	CHECK(bodyRtti->As<Body>() == &body);
+	CHECK(bodyRtti->As<DrawableComponent>() == static_cast<DrawableComponent*>(&body));
+	CHECK(bodyRtti->As<Component>() == static_cast<Component*>(&body));
+	CHECK(bodyRtti->As<Service>() == nullptr);
+	CHECK(componentRtti->As<DrawableComponent>() == nullptr);
+	CHECK(serviceRtti->As<Component>() == nullptr);
+	CHECK(serviceRtti->As<Service>() == &service);
+
+	CHECK(bodyRtti->QueryInterface(DrawableComponent::TypeIdClass()) == bodyRtti);
+	CHECK(bodyRtti->QueryInterface(Service::TypeIdClass()) == nullptr);
+	CHECK(componentRtti->QueryInterface(Component::TypeIdClass()) == componentRtti);
+	CHECK(componentRtti->QueryInterface(Body::TypeIdClass()) == nullptr);
+}
+
+TEST_CASE(FilteringDrawablesFromMixedComponents)
+{
+	// What Game::AddComponent() does once per component, so Draw() never has to.
+	vector<shared_ptr<Component>> components;
+	for (uint32_t i = 0; i < 10000; ++i)
+	{
+		if (i % 3 == 0)
+		{
+			components.push_back(make_shared<Component>());
+		}
+		else
+		{
+			components.push_back(make_shared<Body>());
+		}
+	}
+
+	vector<DrawableComponent*> drawables;
+	for (const shared_ptr<Component>& component : components)
+	{
+		DrawableComponent* drawable = component->As<DrawableComponent>();
+		if (drawable != nullptr)
+		{
+			drawables.push_back(drawable);
+		}
+	}
+
+	CHECK_EQUAL(size_t(6666), drawables.size());
+	CHECK(all_of(drawables.begin(), drawables.end(), [](const DrawableComponent* drawable) { return drawable->Is(Body::TypeIdClass()); }));
+}
\ No newline at end of file
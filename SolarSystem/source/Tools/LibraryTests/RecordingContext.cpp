@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "RecordingContext.h"
+
+using namespace std;
+
+namespace LibraryTests
+{
+	bool RecordingContext::BufferBinding::operator==(const BufferBinding& rhs) const
+	{
+		return (Buffer == rhs.Buffer && First == rhs.First && Count == rhs.Count);
+	}
+
+	// Null and zero are every binding's initial state; a blend factor of (1, 1, 1, 1) is what a null factor stands for.
+	RecordingContext::PipelineState::PipelineState() :
+		Topology(0), InputLayout(nullptr), VertexShader(nullptr), PixelShader(nullptr), RasterizerState(nullptr), BlendState(nullptr),
+		SampleMask(0), DepthStencilState(nullptr), StencilReference(0)
+	{
+		const BufferBinding unbound = { nullptr, 0, 0 };
+		fill(begin(VertexBuffers), end(VertexBuffers), unbound);
+		IndexBuffer = unbound;
+		fill(begin(VertexConstantBuffers), end(VertexConstantBuffers), unbound);
+		fill(begin(PixelConstantBuffers), end(PixelConstantBuffers), unbound);
+		fill(begin(ShaderResources), end(ShaderResources), nullptr);
+		fill(begin(Samplers), end(Samplers), nullptr);
+		fill(begin(BlendFactor), end(BlendFactor), 1.0f);
+	}
+
+	bool RecordingContext::PipelineState::operator==(const PipelineState& rhs) const
+	{
+		return (Topology == rhs.Topology && InputLayout == rhs.InputLayout && equal(begin(VertexBuffers), end(VertexBuffers), begin(rhs.VertexBuffers)) &&
+			IndexBuffer == rhs.IndexBuffer && VertexShader == rhs.VertexShader && PixelShader == rhs.PixelShader &&
+			equal(begin(VertexConstantBuffers), end(VertexConstantBuffers), begin(rhs.VertexConstantBuffers)) &&
+			equal(begin(PixelConstantBuffers), end(PixelConstantBuffers), begin(rhs.PixelConstantBuffers)) &&
+			equal(begin(ShaderResources), end(ShaderResources), begin(rhs.ShaderResources)) && equal(begin(Samplers), end(Samplers), begin(rhs.Samplers)) &&
+			RasterizerState == rhs.RasterizerState && BlendState == rhs.BlendState && equal(begin(BlendFactor), end(BlendFactor), begin(rhs.BlendFactor)) &&
+			SampleMask == rhs.SampleMask && DepthStencilState == rhs.DepthStencilState && StencilReference == rhs.StencilReference);
+	}
+
+	const RecordingContext::PipelineState& RecordingContext::State() const
+	{
+		return mState;
+	}
+
+	const vector<RecordingContext::Call>& RecordingContext::Calls() const
+	{
+		return mCalls;
+	}
+
+	void RecordingContext::ClearCalls()
+	{
+		mCalls.clear();
+	}
+
+	void RecordingContext::IASetPrimitiveTopology(uint32_t topology)
+	{
+		mState.Topology = topology;
+		mCalls.emplace_back("IASetPrimitiveTopology");
+	}
+
+	void RecordingContext::IASetInputLayout(MockObject* inputLayout)
+	{
+		mState.InputLayout = inputLayout;
+		mCalls.emplace_back("IASetInputLayout");
+	}
+
+	void RecordingContext::IASetVertexBuffers(uint32_t startSlot, uint32_t count, MockObject* const* buffers, const uint32_t* strides, const uint32_t* offsets)
+	{
+		assert(startSlot + count <= VertexBufferSlotCount);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			BufferBinding binding = { buffers[i], offsets[i], strides[i] };
+			mState.VertexBuffers[startSlot + i] = binding;
+		}
+
+		mCalls.emplace_back("IASetVertexBuffers", startSlot, count);
+	}
+
+	void RecordingContext::IASetIndexBuffer(MockObject* buffer, uint32_t format, uint32_t offset)
+	{
+		BufferBinding binding = { buffer, offset, format };
+		mState.IndexBuffer = binding;
+		mCalls.emplace_back("IASetIndexBuffer");
+	}
+
+	void RecordingContext::VSSetShader(MockObject* shader, MockObject* const* classInstances, uint32_t classInstanceCount)
+	{
+		UNREFERENCED_PARAMETER(classInstances);
+
+		mState.VertexShader = shader;
+		mCalls.emplace_back("VSSetShader", 0, classInstanceCount);
+	}
+
+	void RecordingContext::PSSetShader(MockObject* shader, MockObject* const* classInstances, uint32_t classInstanceCount)
+	{
+		UNREFERENCED_PARAMETER(classInstances);
+
+		mState.PixelShader = shader;
+		mCalls.emplace_back("PSSetShader", 0, classInstanceCount);
+	}
+
+	void RecordingContext::VSSetConstantBuffers(uint32_t startSlot, uint32_t count, MockObject* const* buffers)
+	{
+		SetConstantBuffers(mState.VertexConstantBuffers, startSlot, count, buffers, nullptr, nullptr);
+		mCalls.emplace_back("VSSetConstantBuffers", startSlot, count);
+	}
+
+	void RecordingContext::PSSetConstantBuffers(uint32_t startSlot, uint32_t count, MockObject* const* buffers)
+	{
+		SetConstantBuffers(mState.PixelConstantBuffers, startSlot, count, buffers, nullptr, nullptr);
+		mCalls.emplace_back("PSSetConstantBuffers", startSlot, count);
+	}
+
+	void RecordingContext::VSSetConstantBuffers1(uint32_t startSlot, uint32_t count, MockObject* const* buffers, const uint32_t* firstConstants, const uint32_t* constantCounts)
+	{
+		SetConstantBuffers(mState.VertexConstantBuffers, startSlot, count, buffers, firstConstants, constantCounts);
+		mCalls.emplace_back("VSSetConstantBuffers1", startSlot, count);
+	}
+
+	void RecordingContext::PSSetConstantBuffers1(uint32_t startSlot, uint32_t count, MockObject* const* buffers, const uint32_t* firstConstants, const uint32_t* constantCounts)
+	{
+		SetConstantBuffers(mState.PixelConstantBuffers, startSlot, count, buffers, firstConstants, constantCounts);
+		mCalls.emplace_back("PSSetConstantBuffers1", startSlot, count);
+	}
+
+	void RecordingContext::PSSetShaderResources(uint32_t startSlot, uint32_t count, MockObject* const* shaderResourceViews)
+	{
+		assert(startSlot + count <= ShaderResourceSlotCount);
+
+		copy(shaderResourceViews, shaderResourceViews + count, mState.ShaderResources + startSlot);
+		mCalls.emplace_back("PSSetShaderResources", startSlot, count);
+	}
+
+	void RecordingContext::PSSetSamplers(uint32_t startSlot, uint32_t count, MockObject* const* samplers)
+	{
+		assert(startSlot + count <= SamplerSlotCount);
+
+		copy(samplers, samplers + count, mState.Samplers + startSlot);
+		mCalls.emplace_back("PSSetSamplers", startSlot, count);
+	}
+
+	void RecordingContext::RSSetState(MockObject* rasterizerState)
+	{
+		mState.RasterizerState = rasterizerState;
+		mCalls.emplace_back("RSSetState");
+	}
+
+	void RecordingContext::OMSetBlendState(MockObject* blendState, const float* blendFactor, uint32_t sampleMask)
+	{
+		mState.BlendState = blendState;
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			mState.BlendFactor[i] = (blendFactor != nullptr ? blendFactor[i] : 1.0f);
+		}
+		mState.SampleMask = sampleMask;
+		mCalls.emplace_back("OMSetBlendState");
+	}
+
+	void RecordingContext::OMSetDepthStencilState(MockObject* depthStencilState, uint32_t stencilReference)
+	{
+		mState.DepthStencilState = depthStencilState;
+		mState.StencilReference = stencilReference;
+		mCalls.emplace_back("OMSetDepthStencilState");
+	}
+
+	void RecordingContext::SetConstantBuffers(BufferBinding* bindings, uint32_t startSlot, uint32_t count, MockObject* const* buffers, const uint32_t* firstConstants, const uint32_t* constantCounts)
+	{
+		assert(startSlot + count <= ConstantBufferSlotCount);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			BufferBinding binding = { buffers[i], (firstConstants != nullptr ? firstConstants[i] : 0), (constantCounts != nullptr ? constantCounts[i] : WholeBuffer) };
+			bindings[startSlot + i] = binding;
+		}
+	}
+}
\ No newline at end of file
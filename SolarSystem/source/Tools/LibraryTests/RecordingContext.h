@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "StateCachingContext.h"
+
+namespace LibraryTests
+{
+	// Stands in for every Direct3D object type; only the pointers are compared.
+	struct MockObject
+	{
+		std::uint32_t Id;
+	};
+
+	// A device context that applies state calls to a model of the pipeline state and records each call, so a sequence of calls
+	// made through StateCachingContext can be compared with the same sequence made directly.
+	class RecordingContext final
+	{
+	public:
+		struct BufferBinding
+		{
+			const MockObject* Buffer;
+			std::uint32_t First;
+			std::uint32_t Count;
+
+			bool operator==(const BufferBinding& rhs) const;
+		};
+
+		// More slots than the cache tracks, so that ranges beyond it are modeled too.
+		static const std::uint32_t VertexBufferSlotCount = 40;
+		static const std::uint32_t ConstantBufferSlotCount = 16;
+		static const std::uint32_t ShaderResourceSlotCount = 24;
+		static const std::uint32_t SamplerSlotCount = 16;
+
+		// Constant count of a binding made without offsets (the whole buffer).
+		static const std::uint32_t WholeBuffer = UINT32_MAX;
+
+		struct PipelineState
+		{
+			std::uint32_t Topology;
+			const MockObject* InputLayout;
+			BufferBinding VertexBuffers[VertexBufferSlotCount];
+			BufferBinding IndexBuffer;
+			const MockObject* VertexShader;
+			const MockObject* PixelShader;
+			BufferBinding VertexConstantBuffers[ConstantBufferSlotCount];
+			BufferBinding PixelConstantBuffers[ConstantBufferSlotCount];
+			const MockObject* ShaderResources[ShaderResourceSlotCount];
+			const MockObject* Samplers[SamplerSlotCount];
+			const MockObject* RasterizerState;
+			const MockObject* BlendState;
+			float BlendFactor[4];
+			std::uint32_t SampleMask;
+			const MockObject* DepthStencilState;
+			std::uint32_t StencilReference;
+
+			PipelineState();
+			bool operator==(const PipelineState& rhs) const;
+		};
+
+		struct Call
+		{
+			std::string Function;
+			std::uint32_t StartSlot;
+			std::uint32_t Count;
+
+			Call(const std::string& function, std::uint32_t startSlot = 0, std::uint32_t count = 1) :
+				Function(function), StartSlot(startSlot), Count(count) { }
+		};
+
+		RecordingContext() = default;
+		RecordingContext(const RecordingContext&) = delete;
+		RecordingContext& operator=(const RecordingContext&) = delete;
+		RecordingContext(RecordingContext&&) = delete;
+		RecordingContext& operator=(RecordingContext&&) = delete;
+		~RecordingContext() = default;
+
+		const PipelineState& State() const;
+		const std::vector<Call>& Calls() const;
+		void ClearCalls();
+
+		void IASetPrimitiveTopology(std::uint32_t topology);
+		void IASetInputLayout(MockObject* inputLayout);
+		void IASetVertexBuffers(std::uint32_t startSlot, std::uint32_t count, MockObject* const* buffers, const std::uint32_t* strides, const std::uint32_t* offsets);
+		void IASetIndexBuffer(MockObject* buffer, std::uint32_t format, std::uint32_t offset);
+
+		void VSSetShader(MockObject* shader, MockObject* const* classInstances, std::uint32_t classInstanceCount);
+		void PSSetShader(MockObject* shader, MockObject* const* classInstances, std::uint32_t classInstanceCount);
+
+		void VSSetConstantBuffers(std::uint32_t startSlot, std::uint32_t count, MockObject* const* buffers);
+		void PSSetConstantBuffers(std::uint32_t startSlot, std::uint32_t count, MockObject* const* buffers);
+		void VSSetConstantBuffers1(std::uint32_t startSlot, std::uint32_t count, MockObject* const* buffers, const std::uint32_t* firstConstants, const std::uint32_t* constantCounts);
+		void PSSetConstantBuffers1(std::uint32_t startSlot, std::uint32_t count, MockObject* const* buffers, const std::uint32_t* firstConstants, const std::uint32_t* constantCounts);
+
+		void PSSetShaderResources(std::uint32_t startSlot, std::uint32_t count, MockObject* const* shaderResourceViews);
+		void PSSetSamplers(std::uint32_t startSlot, std::uint32_t count, MockObject* const* samplers);
+
+		void RSSetState(MockObject* rasterizerState);
+		void OMSetBlendState(MockObject* blendState, const float* blendFactor, std::uint32_t sampleMask);
+		void OMSetDepthStencilState(MockObject* depthStencilState, std::uint32_t stencilReference);
+
+	private:
+		static void SetConstantBuffers(BufferBinding* bindings, std::uint32_t startSlot, std::uint32_t count, MockObject* const* buffers, const std::uint32_t* firstConstants, const std::uint32_t* constantCounts);
+
+		PipelineState mState;
+		std::vector<Call> mCalls;
+	};
+
+	struct RecordingStateTypes
+	{
+		typedef RecordingContext DeviceContext;
+		typedef std::uint32_t PrimitiveTopology;
+		typedef std::uint32_t Format;
+		typedef MockObject InputLayout;
+		typedef MockObject Buffer;
+		typedef MockObject VertexShader;
+		typedef MockObject PixelShader;
+		typedef MockObject ClassInstance;
+		typedef MockObject ShaderResourceView;
+		typedef MockObject SamplerState;
+		typedef MockObject RasterizerState;
+		typedef MockObject BlendState;
+		typedef MockObject DepthStencilState;
+	};
+
+	typedef Library::StateCachingContext<RecordingStateTypes> RecordingStateCache;
+}
\ No newline at end of file
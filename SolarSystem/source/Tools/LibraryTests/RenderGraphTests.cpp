@@ -0,0 +1,313 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+// Logs every executor call as text, so a test can check the exact schedule a graph replays.
+class RecordingExecutor final : public RenderGraphExecutor
+{
+public:
+	vector<string> Calls;
+
+	virtual void PreparePhysicalTextures(const vector<TextureDescription>& physicalTextures) override
+	{
+		Calls.push_back("Prepare " + to_string(physicalTextures.size()));
+	}
+
+	virtual void ApplyBarrier(const RenderGraph& graph, const RenderGraphBarrier& barrier) override
+	{
+		Calls.push_back("Barrier " + graph.ResourceName(barrier.Resource) + " " + StateName(barrier.Before) + "->" + StateName(barrier.After));
+	}
+
+	virtual void Clear(const RenderGraph& graph, RenderGraphResource resource) override
+	{
+		Calls.push_back("Clear " + graph.ResourceName(resource));
+	}
+
+	virtual void BeginPass(const RenderGraph& graph, uint32_t pass) override
+	{
+		Calls.push_back("Begin " + graph.PassName(pass));
+	}
+
+	virtual void EndPass(const RenderGraph& graph, uint32_t pass) override
+	{
+		Calls.push_back("End " + graph.PassName(pass));
+	}
+
+private:
+	static string StateName(ResourceState state)
+	{
+		switch (state)
+		{
+		case ResourceState::Undefined:
+			return "Undefined";
+
+		case ResourceState::RenderTarget:
+			return "RenderTarget";
+
+		case ResourceState::DepthWrite:
+			return "DepthWrite";
+
+		case ResourceState::ShaderResource:
+			return "ShaderResource";
+
+		default:
+			return "Present";
+		}
+	}
+};
+
+static const TextureDescription Color(64, 64, TextureFormat::R8G8B8A8UNorm);
+static const TextureDescription Hdr(64, 64, TextureFormat::R16G16B16A16Float);
+static const TextureDescription Depth(64, 64, TextureFormat::D32Float);
+
+static bool Throws(RenderGraph& graph)
+{
+	try
+	{
+		graph.Compile();
+	}
+	catch (const GameException&)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+TEST_CASE(PassesThatFeedNothingAreCulled)
+{
+	RenderGraph graph;
+	RenderGraphResource backBuffer = graph.ImportTexture("BackBuffer", Color, ResourceState::Present);
+	RenderGraphResource scene = graph.CreateTexture("Scene", Color);
+	RenderGraphResource debug = graph.CreateTexture("Debug", Color);
+	RenderGraphResource unused = graph.CreateTexture("Unused", Color);
+
+	uint32_t sceneOnly = graph.AddPass("Scene", nullptr).Write(scene).Pass();
+	uint32_t debugView = graph.AddPass("Debug", nullptr).Read(scene).Write(debug).Pass();
+	uint32_t composite = graph.AddPass("Composite", nullptr).Read(scene).Write(backBuffer).Pass();
+	uint32_t dead = graph.AddPass("Dead", nullptr).Write(unused).Pass();
+	uint32_t capture = graph.AddPass("Capture", nullptr).Read(debug).SetSideEffects().Pass();
+	uint32_t present = graph.AddPass("Present", nullptr).Read(backBuffer, ResourceState::Present).SetSideEffects().Pass();
+	graph.Compile();
+
+	// The debug view feeds a side-effect pass, so only Dead goes.
+	CHECK(graph.IsPassCulled(sceneOnly) == false);
+	CHECK(graph.IsPassCulled(debugView) == false);
+	CHECK(graph.IsPassCulled(composite) == false);
+	CHECK(graph.IsPassCulled(dead));
+	CHECK(graph.IsPassCulled(capture) == false);
+	CHECK(graph.IsPassCulled(present) == false);
+	CHECK_EQUAL(size_t(5), graph.CompiledPasses().size());
+	CHECK_EQUAL(RenderGraph::NoPhysicalTexture, graph.PhysicalTexture(unused));
+	CHECK_EQUAL(RenderGraph::NoPhysicalTexture, graph.PhysicalTexture(backBuffer));
+
+	// Without the capture, the whole debug branch goes.
+	RenderGraph withoutCapture;
+	backBuffer = withoutCapture.ImportTexture("BackBuffer", Color, ResourceState::Present);
+	scene = withoutCapture.CreateTexture("Scene", Color);
+	debug = withoutCapture.CreateTexture("Debug", Color);
+	withoutCapture.AddPass("Scene", nullptr).Write(scene);
+	debugView = withoutCapture.AddPass("Debug", nullptr).Read(scene).Write(debug).Pass();
+	withoutCapture.AddPass("Composite", nullptr).Read(scene).Write(backBuffer);
+	withoutCapture.Compile();
+	CHECK(withoutCapture.IsPassCulled(debugView));
+	CHECK_EQUAL(size_t(2), withoutCapture.CompiledPasses().size());
+	CHECK_EQUAL(size_t(1), withoutCapture.PhysicalTextures().size());
+}
+
+TEST_CASE(EarlierWritersOfAKeptTextureAreKept)
+{
+	// Writes load earlier contents, so both passes that draw into the target survive.
+	RenderGraph graph;
+	RenderGraphResource backBuffer = graph.ImportTexture("BackBuffer", Color, ResourceState::Present);
+	RenderGraphResource target = graph.CreateTexture("Target", Color);
+	uint32_t first = graph.AddPass("First", nullptr).Write(target).Pass();
+	uint32_t second = graph.AddPass("Second", nullptr).Write(target).Pass();
+	graph.AddPass("Composite", nullptr).Read(target).Write(backBuffer);
+	graph.Compile();
+
+	CHECK(graph.IsPassCulled(first) == false);
+	CHECK(graph.IsPassCulled(second) == false);
+}
+
+TEST_CASE(TransientsWithDisjointLifetimesAlias)
+{
+	RenderGraph graph;
+	RenderGraphResource backBuffer = graph.ImportTexture("BackBuffer", Color, ResourceState::Present);
+	RenderGraphResource a = graph.CreateTexture("A", Color);
+	RenderGraphResource b = graph.CreateTexture("B", Color);
+	RenderGraphResource c = graph.CreateTexture("C", Color);
+	RenderGraphResource d = graph.CreateTexture("D", Color);
+	RenderGraphResource hdr = graph.CreateTexture("Hdr", Hdr);
+	RenderGraphResource depth = graph.CreateTexture("Depth", Depth, ClearValue::DepthStencil());
+
+	// Lifetimes in compiled passes: A [0, 1], B [1, 2], C [2, 3], D [3, 4], Hdr [0, 4], Depth [0, 0].
+	graph.AddPass("Pass0", nullptr).Write(a).Write(hdr).Write(depth);
+	graph.AddPass("Pass1", nullptr).Read(a).Write(b);
+	graph.AddPass("Pass2", nullptr).Read(b).Write(c);
+	graph.AddPass("Pass3", nullptr).Read(c).Write(d);
+	graph.AddPass("Pass4", nullptr).Read(d).Read(hdr).Write(backBuffer);
+	graph.Compile();
+
+	// A texture is busy through its last use, so neighbours in the chain can't share but every other one can.
+	CHECK_EQUAL(graph.PhysicalTexture(a), graph.PhysicalTexture(c));
+	CHECK_EQUAL(graph.PhysicalTexture(b), graph.PhysicalTexture(d));
+	CHECK(graph.PhysicalTexture(a) != graph.PhysicalTexture(b));
+
+	// Formats never alias.
+	CHECK(graph.PhysicalTexture(hdr) != graph.PhysicalTexture(a) && graph.PhysicalTexture(hdr) != graph.PhysicalTexture(b));
+	CHECK(graph.PhysicalTexture(depth) != graph.PhysicalTexture(a) && graph.PhysicalTexture(depth) != graph.PhysicalTexture(b));
+
+	const vector<TextureDescription>& pool = graph.PhysicalTextures();
+	CHECK_EQUAL(size_t(4), pool.size());
+	for (RenderGraphResource resource : { a, b, c, d, hdr, depth })
+	{
+		CHECK(pool[graph.PhysicalTexture(resource)] == graph.Description(resource));
+	}
+
+	// Assignments follow first use, lowest index first.
+	CHECK_EQUAL(0U, graph.PhysicalTexture(a));
+	CHECK_EQUAL(1U, graph.PhysicalTexture(hdr));
+	CHECK_EQUAL(2U, graph.PhysicalTexture(depth));
+	CHECK_EQUAL(3U, graph.PhysicalTexture(b));
+
+	CHECK_EQUAL(4 * Color.ByteSize() + Hdr.ByteSize() + Depth.ByteSize(), graph.TransientBytes());
+	CHECK_EQUAL(2 * Color.ByteSize() + Hdr.ByteSize() + Depth.ByteSize(), graph.AliasedTransientBytes());
+	CHECK_EQUAL(uint64_t(64 * 64 * 8), Hdr.ByteSize());
+}
+
+TEST_CASE(RebuiltGraphsReuseThePool)
+{
+	RenderGraph graph;
+	vector<uint32_t> firstAssignments;
+	for (uint32_t frame = 0; frame < 3; ++frame)
+	{
+		graph.Reset();
+		RenderGraphResource backBuffer = graph.ImportTexture("BackBuffer", Color, ResourceState::Present);
+		RenderGraphResource a = graph.CreateTexture("A", Color);
+		RenderGraphResource b = graph.CreateTexture("B", Hdr);
+		graph.AddPass("Pass0", nullptr).Write(a);
+		graph.AddPass("Pass1", nullptr).Read(a).Write(b);
+		graph.AddPass("Pass2", nullptr).Read(b).Write(backBuffer);
+		graph.Compile();
+
+		vector<uint32_t> assignments = { graph.PhysicalTexture(a), graph.PhysicalTexture(b) };
+		if (frame == 0)
+		{
+			firstAssignments = assignments;
+		}
+
+		CHECK(assignments == firstAssignments);
+		CHECK_EQUAL(size_t(2), graph.PhysicalTextures().size());
+	}
+
+	// A smaller frame keeps the pool and picks from it; releasing the pool starts afresh.
+	graph.Reset();
+	RenderGraphResource backBuffer = graph.ImportTexture("BackBuffer", Color, ResourceState::Present);
+	RenderGraphResource hdrOnly = graph.CreateTexture("HdrOnly", Hdr);
+	graph.AddPass("Pass0", nullptr).Write(hdrOnly);
+	graph.AddPass("Pass1", nullptr).Read(hdrOnly).Write(backBuffer);
+	graph.Compile();
+	CHECK_EQUAL(size_t(2), graph.PhysicalTextures().size());
+	CHECK_EQUAL(firstAssignments[1], graph.PhysicalTexture(hdrOnly));
+	CHECK_EQUAL(Hdr.ByteSize(), graph.AliasedTransientBytes());
+
+	graph.ReleaseTransientTextures();
+	CHECK(graph.PhysicalTextures().empty());
+	CHECK_EQUAL(RenderGraph::NoPhysicalTexture, graph.PhysicalTexture(hdrOnly));
+	graph.Compile();
+	CHECK_EQUAL(size_t(1), graph.PhysicalTextures().size());
+	CHECK_EQUAL(0U, graph.PhysicalTexture(hdrOnly));
+}
+
+TEST_CASE(ExecutionReplaysBarriersClearsAndPassesInOrder)
+{
+	RenderGraph graph;
+	RenderGraphResource backBuffer = graph.ImportTexture("BackBuffer", Color, ResourceState::Present, ClearValue(0.0f, 0.0f, 0.0f, 1.0f));
+	RenderGraphResource history = graph.ImportTexture("History", Color, ResourceState::ShaderResource);
+	RenderGraphResource depth = graph.CreateTexture("Depth", Depth, ClearValue::DepthStencil());
+	RenderGraphResource scene = graph.CreateTexture("Scene", Hdr);
+	RenderGraphResource debug = graph.CreateTexture("Debug", Color);
+
+	vector<string> callbacks;
+	graph.AddPass("Prepass", [&callbacks]() { callbacks.push_back("Prepass"); }).Write(depth);
+	graph.AddPass("Opaque", [&callbacks]() { callbacks.push_back("Opaque"); }).Read(history).Write(scene).Write(depth);
+	graph.AddPass("Debug", [&callbacks]() { callbacks.push_back("Debug"); }).Read(scene).Write(debug);
+	graph.AddPass("Tonemap", [&callbacks]() { callbacks.push_back("Tonemap"); }).Read(scene).Write(backBuffer);
+	graph.AddPass("Present", nullptr).Read(backBuffer, ResourceState::Present).SetSideEffects();
+	graph.Compile();
+
+	RecordingExecutor executor;
+	graph.Execute(executor);
+
+	// Depth is cleared once, before its first write; the history import has no clear value and is only read.
+	const vector<string> expected =
+	{
+		"Prepare 2",
+		"Barrier Depth Undefined->DepthWrite",
+		"Clear Depth",
+		"Begin Prepass",
+		"End Prepass",
+		"Barrier Scene Undefined->RenderTarget",
+		"Clear Scene",
+		"Begin Opaque",
+		"End Opaque",
+		"Barrier Scene RenderTarget->ShaderResource",
+		"Barrier BackBuffer Present->RenderTarget",
+		"Clear BackBuffer",
+		"Begin Tonemap",
+		"End Tonemap",
+		"Barrier BackBuffer RenderTarget->Present",
+		"Begin Present",
+		"End Present"
+	};
+	CHECK(executor.Calls == expected);
+	CHECK(callbacks == vector<string>({ "Prepass", "Opaque", "Tonemap" }));
+
+	// The same schedule replays every time, and the null executor counts it.
+	NullRenderGraphExecutor counter;
+	graph.Execute(counter);
+	graph.Execute(counter);
+	CHECK_EQUAL(2U, counter.ExecutionCounters().PhysicalTextureCount);
+	CHECK_EQUAL(2U * 5, counter.ExecutionCounters().BarrierCount);
+	CHECK_EQUAL(2U * 3, counter.ExecutionCounters().ClearCount);
+	CHECK_EQUAL(2U * 4, counter.ExecutionCounters().PassCount);
+	counter.ResetCounters();
+	CHECK_EQUAL(0U, counter.ExecutionCounters().PassCount);
+}
+
+TEST_CASE(InvalidGraphsThrow)
+{
+	RenderGraph readBeforeWrite;
+	RenderGraphResource backBuffer = readBeforeWrite.ImportTexture("BackBuffer", Color, ResourceState::Present);
+	RenderGraphResource texture = readBeforeWrite.CreateTexture("Texture", Color);
+	readBeforeWrite.AddPass("Reader", nullptr).Read(texture).Write(backBuffer);
+	readBeforeWrite.AddPass("Writer", nullptr).Write(texture);
+	CHECK(Throws(readBeforeWrite));
+
+	RenderGraph readAndWrite;
+	backBuffer = readAndWrite.ImportTexture("BackBuffer", Color, ResourceState::Present);
+	texture = readAndWrite.CreateTexture("Texture", Color);
+	readAndWrite.AddPass("Writer", nullptr).Write(texture);
+	readAndWrite.AddPass("Feedback", nullptr).Read(texture).Write(texture).Write(backBuffer);
+	CHECK(Throws(readAndWrite));
+
+	// Imported textures may be read without a writer.
+	RenderGraph importedRead;
+	backBuffer = importedRead.ImportTexture("BackBuffer", Color, ResourceState::Present);
+	RenderGraphResource history = importedRead.ImportTexture("History", Color, ResourceState::ShaderResource);
+	importedRead.AddPass("Resolve", nullptr).Read(history).Write(backBuffer);
+	CHECK(Throws(importedRead) == false);
+
+	bool threw = false;
+	try
+	{
+		importedRead.AddPass("Stale", nullptr).Read(RenderGraphResource(42));
+	}
+	catch (const GameException&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+}
\ No newline at end of file
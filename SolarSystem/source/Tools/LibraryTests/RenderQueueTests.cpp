@@ -0,0 +1,174 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+// A minimal scene on the null device: two pipeline states (one reading a per-instance buffer in slot 1) and two textures.
+struct TestScene
+{
+	NullRenderDevice Device;
+	ConstantBufferRing ConstantBuffers;
+	ThreadPool Workers;
+	RenderQueue Queue;
+
+	ShaderHandle VertexShader;
+	ShaderHandle PixelShader;
+	PipelineStateHandle PipelineStates[2];
+	TextureHandle Textures[2];
+	BufferHandle VertexBuffer;
+	BufferHandle IndexBuffer;
+	BufferHandle InstanceBuffer;
+
+	TestScene(uint32_t ringSize = ConstantBufferRing::DefaultSize) :
+		Device(), ConstantBuffers(Device, ringSize), Workers(2), Queue(Device, ConstantBuffers, Workers)
+	{
+		const vector<char> bytecode(16, 0);
+		VertexShader = Device.CreateShader(ShaderStage::Vertex, bytecode);
+		PixelShader = Device.CreateShader(ShaderStage::Pixel, bytecode);
+		PipelineStates[0] = Device.CreatePipelineState(PipelineStateDescription(VertexShader, PixelShader, { InputElement("POSITION", VertexFormat::Float4) }));
+		PipelineStates[1] = Device.CreatePipelineState(PipelineStateDescription(VertexShader, PixelShader,
+			{ InputElement("POSITION", VertexFormat::Float4), InputElement("WORLD", VertexFormat::Float4, 0, 1, true) }));
+		Textures[0] = Device.CreateTextureFromFile(L"First.dds");
+		Textures[1] = Device.CreateTextureFromFile(L"Second.dds");
+
+		const float vertices[12] = { 0.0f };
+		VertexBuffer = Device.CreateBuffer(BufferDescription(BufferType::Vertex, ResourceUsage::Immutable, sizeof(vertices)), vertices);
+		const uint32_t indices[3] = { 0, 1, 2 };
+		IndexBuffer = Device.CreateBuffer(BufferDescription(BufferType::Index, ResourceUsage::Immutable, sizeof(indices)), indices);
+		InstanceBuffer = Device.CreateBuffer(BufferDescription(BufferType::Vertex, ResourceUsage::Dynamic, 16 * 64), nullptr);
+	}
+
+	// Submits count draws cycling through the states in an order the sort has to undo.
+	void Submit(uint32_t count)
+	{
+		const uint32_t pipelineStates[2] = { Queue.RegisterPipelineState(PipelineStates[0]), Queue.RegisterPipelineState(PipelineStates[1]) };
+		const uint32_t textures[2] = { Queue.RegisterTextures(RenderQueue::TextureState({ Textures[0] })), Queue.RegisterTextures(RenderQueue::TextureState({ Textures[1] })) };
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const float constants[16] = { static_cast<float>(i) };
+
+			RenderQueue::DrawPacket packet;
+			packet.AddVertexBuffer(VertexBuffer, 16);
+			packet.IndexBuffer = IndexBuffer;
+			packet.ElementCount = 3;
+			packet.AddVSConstantBuffer(ConstantBuffers.Allocate(constants));
+
+			const uint32_t pipelineState = i % 2;
+			if (pipelineState == 1)
+			{
+				packet.AddVertexBuffer(InstanceBuffer, 16);
+				packet.InstanceCount = 4;
+			}
+
+			Queue.Submit(RenderLayer::Opaque, pipelineStates[pipelineState], textures[(i / 2) % 2], (i % 7) / 7.0f, packet);
+		}
+	}
+};
+
+TEST_CASE(DrawsIssueWithoutValidationErrors)
+{
+	TestScene scene;
+	scene.ConstantBuffers.BeginFrame();
+	scene.Submit(100);
+	scene.Device.ResetCounters();
+	scene.Queue.Execute();
+
+	CHECK_EQUAL(0U, scene.Device.ValidationErrorCount());
+	CHECK_EQUAL(100U, scene.Queue.PacketCount());
+	CHECK_EQUAL(100U, scene.Device.FrameCounters().DrawCount);
+	CHECK_EQUAL(50ULL + 50 * 4, scene.Device.FrameCounters().InstanceCount);
+	CHECK(scene.Queue.StateChangeCount() < scene.Queue.UnsortedStateChangeCount());
+	CHECK(scene.Queue.IssuedCallCount() > scene.Queue.StateChangeCount());
+	CHECK_EQUAL(0U, scene.Queue.FilteredCallCount());
+}
+
+TEST_CASE(FullRingGrowsWithoutInvalidatingAllocations)
+{
+	// 400 distinct 64-byte blocks take 100 KB of 256-byte aligned slots, so a 4 KB ring is retired several times in one frame.
+	TestScene scene(4096);
+	for (uint32_t frame = 0; frame < 3; ++frame)
+	{
+		scene.ConstantBuffers.BeginFrame();
+		scene.Submit(400);
+		scene.Queue.Execute();
+		scene.Queue.Clear();
+
+		CHECK_EQUAL(400U, scene.ConstantBuffers.UploadCount());
+	}
+
+	CHECK(scene.ConstantBuffers.Size() >= 400 * ConstantBufferRing::Alignment);
+	CHECK_EQUAL(0U, scene.Device.ValidationErrorCount());
+}
+
+TEST_CASE(IdenticalConstantsShareOneUpload)
+{
+	TestScene scene;
+	scene.ConstantBuffers.BeginFrame();
+
+	const float constants[16] = { 1.0f };
+	ConstantBufferRing::Allocation first = scene.ConstantBuffers.Allocate(constants);
+	ConstantBufferRing::Allocation second = scene.ConstantBuffers.Allocate(constants);
+	CHECK(first.Buffer == second.Buffer);
+	CHECK_EQUAL(first.FirstConstant, second.FirstConstant);
+	CHECK_EQUAL(1U, scene.ConstantBuffers.UploadCount());
+	CHECK_EQUAL(1U, scene.ConstantBuffers.ReusedCount());
+
+	// Allocations are bound by range: 64 bytes round up to one 256-byte slot of 16 constants.
+	CHECK_EQUAL(16U, first.ConstantCount);
+	CHECK_EQUAL(0U, scene.Device.ValidationErrorCount());
+}
+
+TEST_CASE(CallbacksRunInSortedOrderAndRebindState)
+{
+	TestScene scene;
+	scene.ConstantBuffers.BeginFrame();
+	scene.Submit(10);
+
+	vector<uint32_t> drawCounts;
+	scene.Queue.SubmitCallback(RenderLayer::Overlay, [&scene, &drawCounts]()
+	{
+		drawCounts.push_back(scene.Device.FrameCounters().DrawCount);
+
+		// Glyph drawing leaves the bindings undefined.
+		FontHandle font = scene.Device.CreateFontFromFile(L"Arial.spritefont");
+		GlyphSprite glyph = { scene.Device.Glyph(font, L'A').Subrect, 0.0f, 0.0f, { 1.0f, 1.0f, 1.0f, 1.0f } };
+		scene.Device.DrawGlyphs(font, &glyph, 1);
+		scene.Device.Destroy(font);
+	});
+	scene.Queue.SubmitCallback(RenderLayer::Background, [&scene, &drawCounts]()
+	{
+		drawCounts.push_back(scene.Device.FrameCounters().DrawCount);
+	});
+
+	RenderQueue::DrawPacket packet;
+	packet.AddVertexBuffer(scene.VertexBuffer, 16);
+	packet.ElementCount = 3;
+	scene.Queue.Submit(RenderLayer::Overlay, scene.Queue.RegisterPipelineState(scene.PipelineStates[0]), scene.Queue.RegisterTextures(RenderQueue::TextureState()), 0.0f, packet);
+
+	scene.Device.ResetCounters();
+	scene.Queue.Execute();
+
+	// The opaque draws come before the background callback, and the overlay draw is issued with its state rebound after the text.
+	CHECK_EQUAL(2U, static_cast<uint32_t>(drawCounts.size()));
+	CHECK_EQUAL(10U, drawCounts[0]);
+	CHECK_EQUAL(10U, drawCounts[1]);
+	CHECK_EQUAL(12U, scene.Device.FrameCounters().DrawCount);
+	CHECK_EQUAL(0U, scene.Device.ValidationErrorCount());
+}
+
+TEST_CASE(RecordingFallsBackWithoutDeferredEncoders)
+{
+	TestScene scene;
+	scene.Queue.SetMultithreadedRecording(true);
+	CHECK(scene.Queue.SupportsCommandLists() == false);
+	CHECK(scene.Queue.MultithreadedRecording() == false);
+
+	scene.ConstantBuffers.BeginFrame();
+	scene.Submit(RenderQueue::MinPacketsPerPartition * 4);
+	scene.Device.ResetCounters();
+	scene.Queue.Execute();
+
+	CHECK_EQUAL(RenderQueue::MinPacketsPerPartition * 4, scene.Device.FrameCounters().DrawCount);
+	CHECK_EQUAL(0U, scene.Device.ValidationErrorCount());
+}
\ No newline at end of file
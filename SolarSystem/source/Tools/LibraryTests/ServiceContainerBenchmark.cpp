@@ -0,0 +1,136 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace Library;
+
+// Usage: ServiceContainerBenchmark [lookups] [repetitions]
+// Looks up the services a frame asks the game for, cycling through eight of them registered among 32, with GetService<T>()
+// and with the uint64_t-keyed GetService() the older code uses, and reports the best time per lookup of each in nanoseconds.
+
+#define BENCHMARK_SERVICE(Type)             \
+	class Type final : public RTTI          \
+	{                                       \
+		RTTI_DECLARATIONS(Type, RTTI)       \
+                                            \
+	public:                                 \
+		uint32_t Value = 1;                 \
+	};                                      \
+	RTTI_DEFINITIONS(Type)
+
+BENCHMARK_SERVICE(KeyboardService)
+BENCHMARK_SERVICE(MouseService)
+BENCHMARK_SERVICE(GamePadService)
+BENCHMARK_SERVICE(CameraService)
+BENCHMARK_SERVICE(RenderQueueService)
+BENCHMARK_SERVICE(ProfilerService)
+BENCHMARK_SERVICE(ThreadPoolService)
+BENCHMARK_SERVICE(FrameArenaService)
+
+// Ids for services registered through the uint64_t-keyed functions, only to fill the container as a game's other services
+// would; the addresses are unique, like RTTI type ids.
+static uint64_t sFillerIds[24];
+
+// Read through a volatile pointer for every round of lookups, so the compiler can't hoist the lookups out of the loop.
+static const ServiceContainer* volatile sServices = nullptr;
+
+static void AddFillers(ServiceContainer& services, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < first + count; ++i)
+	{
+		services.AddService(reinterpret_cast<uint64_t>(&sFillerIds[i]), &sFillerIds[i]);
+	}
+}
+
+template <typename TLookups>
+static double BestNanoseconds(uint32_t lookupCount, uint32_t repetitions, TLookups lookups)
+{
+	double best = numeric_limits<double>::max();
+	for (uint32_t i = 0; i < repetitions; ++i)
+	{
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		const uint32_t sum = lookups();
+		best = min(best, duration<double, nano>(high_resolution_clock::now() - startTime).count());
+
+		// Keeps the lookups from being optimized away.
+		if (sum != lookupCount)
+		{
+			cerr << "Lookups found " << sum << " of " << lookupCount << " services." << endl;
+		}
+	}
+
+	return best / lookupCount;
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t lookupCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 1000000);
+	const uint32_t repetitions = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 20);
+	if (lookupCount == 0 || lookupCount % 8 != 0 || repetitions == 0)
+	{
+		cerr << "Usage: ServiceContainerBenchmark [lookups, a multiple of 8] [repetitions]" << endl;
+		return 1;
+	}
+
+	KeyboardService keyboard;
+	MouseService mouse;
+	GamePadService gamePad;
+	CameraService camera;
+	RenderQueueService renderQueue;
+	ProfilerService profiler;
+	ThreadPoolService threadPool;
+	FrameArenaService frameArena;
+
+	ServiceContainer services;
+	AddFillers(services, 0, 12);
+	services.AddService(&keyboard);
+	services.AddService(&mouse);
+	services.AddService(&gamePad);
+	services.AddService(&camera);
+	AddFillers(services, 12, 12);
+	services.AddService(&renderQueue);
+	services.AddService(&profiler);
+	services.AddService(&threadPool);
+	services.AddService(&frameArena);
+	services.Freeze();
+	sServices = &services;
+
+	const double typed = BestNanoseconds(lookupCount, repetitions, [lookupCount]()
+	{
+		uint32_t sum = 0;
+		for (uint32_t i = 0; i < lookupCount; i += 8)
+		{
+			const ServiceContainer& services = *sServices;
+			sum += services.GetService<KeyboardService>()->Value + services.GetService<MouseService>()->Value + services.GetService<GamePadService>()->Value +
+				services.GetService<CameraService>()->Value + services.GetService<RenderQueueService>()->Value + services.GetService<ProfilerService>()->Value +
+				services.GetService<ThreadPoolService>()->Value + services.GetService<FrameArenaService>()->Value;
+		}
+
+		return sum;
+	});
+
+	const double byId = BestNanoseconds(lookupCount, repetitions, [lookupCount]()
+	{
+		uint32_t sum = 0;
+		for (uint32_t i = 0; i < lookupCount; i += 8)
+		{
+			const ServiceContainer& services = *sServices;
+			sum += static_cast<KeyboardService*>(services.GetService(KeyboardService::TypeIdClass()))->Value +
+				static_cast<MouseService*>(services.GetService(MouseService::TypeIdClass()))->Value +
+				static_cast<GamePadService*>(services.GetService(GamePadService::TypeIdClass()))->Value +
+				static_cast<CameraService*>(services.GetService(CameraService::TypeIdClass()))->Value +
+				static_cast<RenderQueueService*>(services.GetService(RenderQueueService::TypeIdClass()))->Value +
+				static_cast<ProfilerService*>(services.GetService(ProfilerService::TypeIdClass()))->Value +
+				static_cast<ThreadPoolService*>(services.GetService(ThreadPoolService::TypeIdClass()))->Value +
+				static_cast<FrameArenaService*>(services.GetService(FrameArenaService::TypeIdClass()))->Value;
+		}
+
+		return sum;
+	});
+
+	cout << lookupCount << " lookups among " << ARRAYSIZE(sFillerIds) + 8 << " services, best of " << repetitions << "; nanoseconds per lookup" << endl;
+	cout << left << setw(22) << "GetService<T>()" << right << fixed << setprecision(2) << setw(10) << typed << endl;
+	cout << left << setw(22) << "GetService(uint64_t)" << right << setw(10) << byId << endl;
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "pch.h"
+
+using namespace std;
+using namespace Library;
+
+class KeyboardService final : public RTTI
+{
+	RTTI_DECLARATIONS(KeyboardService, RTTI)
+
+public:
+	uint32_t KeyCount = 104;
+};
+
+class MouseService final : public RTTI
+{
+	RTTI_DECLARATIONS(MouseService, RTTI)
+};
+
+RTTI_DEFINITIONS(KeyboardService)
+RTTI_DEFINITIONS(MouseService)
+
+// Not an RTTI type, so only the typed functions find it.
+struct AudioService
+{
+	uint32_t Volume = 7;
+};
+
+static bool Throws(function<void()> action)
+{
+	try
+	{
+		action();
+	}
+	catch (const GameException&)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+TEST_CASE(TypedServicesAreFoundByType)
+{
+	ServiceContainer services;
+	CHECK(services.GetService<KeyboardService>() == nullptr);
+	CHECK(services.GetService<AudioService>() == nullptr);
+
+	KeyboardService keyboard;
+	AudioService audio;
+	services.AddService(&keyboard);
+	services.AddService(&audio);
+
+	CHECK(services.GetService<KeyboardService>() == &keyboard);
+	CHECK(services.GetService<AudioService>() == &audio);
+	CHECK(services.GetService<MouseService>() == nullptr);
+	CHECK_EQUAL(104U, services.GetService<KeyboardService>()->KeyCount);
+
+	// Each container has its own services, though type indices are shared.
+	ServiceContainer other;
+	CHECK(other.GetService<KeyboardService>() == nullptr);
+	CHECK(other.GetService<AudioService>() == nullptr);
+}
+
+TEST_CASE(IdFunctionsAndTypedFunctionsSeeTheSameRTTIServices)
+{
+	ServiceContainer services;
+	KeyboardService keyboard;
+	MouseService mouse;
+	AudioService audio;
+
+	services.AddService(&keyboard);
+	services.AddService(MouseService::TypeIdClass(), &mouse);
+	services.AddService(&audio);
+
+	CHECK(services.GetService(KeyboardService::TypeIdClass()) == &keyboard);
+	CHECK(services.GetService<MouseService>() == &mouse);
+	CHECK(services.GetService(MouseService::TypeIdClass()) == &mouse);
+	CHECK(services.GetService(0) == nullptr);
+
+	// A second service for an id is ignored, as the map the id list replaced did.
+	MouseService otherMouse;
+	services.AddService(MouseService::TypeIdClass(), &otherMouse);
+	CHECK(services.GetService(MouseService::TypeIdClass()) == &mouse);
+
+	// Removing by id removes the typed registration too.
+	services.RemoveService(KeyboardService::TypeIdClass());
+	CHECK(services.GetService<KeyboardService>() == nullptr);
+	CHECK(services.GetService(KeyboardService::TypeIdClass()) == nullptr);
+
+	services.RemoveService(MouseService::TypeIdClass());
+	CHECK(services.GetService<MouseService>() == nullptr);
+
+	services.RemoveService(12345);
+	CHECK(services.GetService<AudioService>() == &audio);
+}
+
+TEST_CASE(RemovingAndReAddingServices)
+{
+	ServiceContainer services;
+	KeyboardService keyboard;
+	services.AddService(&keyboard);
+	CHECK(Throws([&]() { services.AddService(&keyboard); }));
+
+	services.RemoveService<KeyboardService>();
+	CHECK(services.GetService<KeyboardService>() == nullptr);
+	CHECK(services.GetService(KeyboardService::TypeIdClass()) == nullptr);
+
+	// Removing a type that isn't registered does nothing.
+	services.RemoveService<KeyboardService>();
+	services.RemoveService<AudioService>();
+
+	KeyboardService replacement;
+	services.AddService(&replacement);
+	CHECK(services.GetService<KeyboardService>() == &replacement);
+	CHECK(services.GetService(KeyboardService::TypeIdClass()) == &replacement);
+
+	// A typed removal leaves an id registered for another object alone.
+	ServiceContainer mixed;
+	KeyboardService byId;
+	mixed.AddService(KeyboardService::TypeIdClass(), &byId);
+	mixed.AddService(&keyboard);
+	CHECK(mixed.GetService<KeyboardService>() == &keyboard);
+	CHECK(mixed.GetService(KeyboardService::TypeIdClass()) == &byId);
+	mixed.RemoveService<KeyboardService>();
+	CHECK(mixed.GetService<KeyboardService>() == &byId);
+}
+
+TEST_CASE(OwnedServicesLiveAsLongAsTheContainer)
+{
+	weak_ptr<AudioService> observer;
+	{
+		ServiceContainer services;
+		shared_ptr<AudioService> audio = make_shared<AudioService>();
+		observer = audio;
+		services.AddService(audio);
+		audio = nullptr;
+
+		CHECK(observer.expired() == false);
+		CHECK_EQUAL(7U, services.GetService<AudioService>()->Volume);
+
+		services.RemoveService<AudioService>();
+		CHECK(observer.expired());
+
+		audio = make_shared<AudioService>();
+		observer = audio;
+		services.AddService(audio);
+	}
+	CHECK(observer.expired());
+
+	ServiceContainer services;
+	CHECK(Throws([&]() { services.AddService(static_cast<AudioService*>(nullptr)); }));
+	CHECK(Throws([&]() { services.AddService(shared_ptr<AudioService>()); }));
+	CHECK(services.GetService<AudioService>() == nullptr);
+}
+
+TEST_CASE(FrozenContainersRejectChangesButStillAnswer)
+{
+	ServiceContainer services;
+	KeyboardService keyboard;
+	MouseService mouse;
+	services.AddService(&keyboard);
+	CHECK(services.IsFrozen() == false);
+
+	services.Freeze();
+	CHECK(services.IsFrozen());
+	CHECK(Throws([&]() { services.AddService(&mouse); }));
+	CHECK(Throws([&]() { services.AddService(MouseService::TypeIdClass(), &mouse); }));
+	CHECK(Throws([&]() { services.RemoveService<KeyboardService>(); }));
+	CHECK(Throws([&]() { services.RemoveService(KeyboardService::TypeIdClass()); }));
+	CHECK(services.GetService<KeyboardService>() == &keyboard);
+	CHECK(services.GetService<MouseService>() == nullptr);
+
+	// Readers on other threads take no locks once frozen.
+	atomic<uint32_t> found(0);
+	vector<thread> readers;
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		readers.emplace_back([&]()
+		{
+			for (uint32_t j = 0; j < 10000; ++j)
+			{
+				if (services.GetService<KeyboardService>() == &keyboard && services.GetService(KeyboardService::TypeIdClass()) == &keyboard)
+				{
+					++found;
+				}
+			}
+		});
+	}
+	for (thread& reader : readers)
+	{
+		reader.join();
+	}
+	CHECK_EQUAL(40000U, found.load());
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "pch.h"
+#include "OrbitingField.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace Library;
+using namespace LibraryTests;
+
+// Usage: SnapshotBenchmark [bodies] [frames]
+// Captures a scheduled field of orbiting bodies every frame and reports the size of its state, keyframes and deltas, the
+// time to capture each, and the time to restore the newest and the oldest restorable frame.
+
+static const nanoseconds FrameTime(16666667);
+
+static void WriteTimes(const char* name, vector<double>& microseconds)
+{
+	sort(microseconds.begin(), microseconds.end());
+	const double mean = accumulate(microseconds.begin(), microseconds.end(), 0.0) / microseconds.size();
+
+	cout << left << setw(20) << name << right << fixed << setprecision(1)
+		<< setw(10) << mean << setw(10) << microseconds[(microseconds.size() - 1) * 50 / 100]
+		<< setw(10) << microseconds[(microseconds.size() - 1) * 99 / 100] << setw(10) << microseconds.back() << endl;
+}
+
+static size_t StateBytes(const ISnapshotable& state)
+{
+	ostringstream stream;
+	OutputStreamHelper streamHelper(stream);
+	state.SaveSnapshot(streamHelper);
+
+	return stream.str().size();
+}
+
+static double TimeRestore(SnapshotBuffer& snapshots, uint64_t frame, ISnapshotable& state)
+{
+	const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+	snapshots.Restore(frame, state);
+
+	return duration<double, micro>(high_resolution_clock::now() - startTime).count();
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t bodyCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 10000);
+	const uint32_t frameCount = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 600);
+	if (bodyCount == 0 || frameCount == 0)
+	{
+		cerr << "Usage: SnapshotBenchmark [bodies] [frames]" << endl;
+		return 1;
+	}
+
+	OrbitingField field(bodyCount, hours(1));
+	SnapshotBuffer snapshots(frameCount);
+	GameTime gameTime;
+
+	vector<double> keyframeMicroseconds;
+	vector<double> deltaMicroseconds;
+	uint64_t keyframeBytes = 0;
+	uint64_t deltaBytes = 0;
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		gameTime.SetElapsedGameTime(FrameTime);
+		gameTime.SetTotalGameTime(gameTime.TotalGameTime() + FrameTime);
+		field.Update(gameTime);
+
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		snapshots.Capture(frame, field);
+		const double microseconds = duration<double, micro>(high_resolution_clock::now() - startTime).count();
+
+		// The state is the same size every frame, so keyframes fall exactly on the interval.
+		if (frame % snapshots.KeyframeInterval() == 0)
+		{
+			keyframeMicroseconds.push_back(microseconds);
+			keyframeBytes += snapshots.LastCaptureBytes();
+		}
+		else
+		{
+			deltaMicroseconds.push_back(microseconds);
+			deltaBytes += snapshots.LastCaptureBytes();
+		}
+	}
+
+	vector<double> newestMicroseconds;
+	vector<double> oldestMicroseconds;
+	for (uint32_t i = 0; i < 20; ++i)
+	{
+		newestMicroseconds.push_back(TimeRestore(snapshots, snapshots.NewestFrame(), field));
+		oldestMicroseconds.push_back(TimeRestore(snapshots, snapshots.OldestRestorableFrame(), field));
+	}
+
+	cout << bodyCount << " bodies, " << frameCount << " frames, a keyframe every " << snapshots.KeyframeInterval() << " frames" << endl;
+	cout << "State:     " << StateBytes(field) << " bytes" << endl;
+	cout << "Keyframes: " << (keyframeMicroseconds.empty() ? 0 : keyframeBytes / keyframeMicroseconds.size()) << " bytes each" << endl;
+	cout << "Deltas:    " << (deltaMicroseconds.empty() ? 0 : deltaBytes / deltaMicroseconds.size()) << " bytes each" << endl;
+	cout << "Stored:    " << snapshots.StoredBytes() << " bytes" << endl;
+	cout << left << setw(20) << "microseconds" << right << setw(10) << "mean" << setw(10) << "p50" << setw(10) << "p99" << setw(10) << "max" << endl;
+	WriteTimes("Capture keyframe", keyframeMicroseconds);
+	if (deltaMicroseconds.empty() == false)
+	{
+		WriteTimes("Capture delta", deltaMicroseconds);
+	}
+	WriteTimes("Restore newest", newestMicroseconds);
+	WriteTimes("Restore oldest", oldestMicroseconds);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "OrbitingField.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace DirectX;
+using namespace Library;
+using namespace LibraryTests;
+
+static const nanoseconds FrameTime(16666667);
+
+static void AdvanceFrame(GameTime& gameTime)
+{
+	gameTime.SetElapsedGameTime(FrameTime);
+	gameTime.SetTotalGameTime(gameTime.TotalGameTime() + FrameTime);
+}
+
+static string SaveState(const ISnapshotable& state)
+{
+	ostringstream stream;
+	OutputStreamHelper streamHelper(stream);
+	state.SaveSnapshot(streamHelper);
+
+	return stream.str();
+}
+
+static string SaveBodies(OrbitingField& field)
+{
+	ostringstream stream;
+	OutputStreamHelper streamHelper(stream);
+	for (const OrbitingBody& body : field.Bodies())
+	{
+		body.SaveSnapshot(streamHelper);
+	}
+
+	return stream.str();
+}
+
+TEST_CASE(RestoredStateMatchesCapturedState)
+{
+	OrbitingField field(500, hours(1));
+	SnapshotBuffer snapshots(100, 8);
+	GameTime gameTime;
+
+	vector<string> states;
+	for (uint64_t frame = 0; frame < 100; ++frame)
+	{
+		AdvanceFrame(gameTime);
+		field.Update(gameTime);
+		snapshots.Capture(frame, field);
+		states.push_back(SaveState(field));
+	}
+
+	// Keyframes and deltas, restored into a second field with the same bodies registered.
+	OrbitingField restoredField(500, hours(1));
+	for (uint64_t frame = 0; frame < 100; frame += 7)
+	{
+		CHECK(snapshots.Restore(frame, restoredField));
+		CHECK(SaveState(restoredField) == states[frame]);
+	}
+}
+
+TEST_CASE(RewindReplaysTheSameFrames)
+{
+	OrbitingField field(2000, hours(1));
+	SnapshotBuffer snapshots(200, 30);
+	GameTime gameTime;
+
+	for (uint64_t frame = 0; frame < 60; ++frame)
+	{
+		AdvanceFrame(gameTime);
+		field.Update(gameTime);
+		snapshots.Capture(frame, field);
+	}
+
+	vector<string> expectedFrames;
+	for (uint64_t frame = 60; frame < 120; ++frame)
+	{
+		AdvanceFrame(gameTime);
+		field.Update(gameTime);
+		snapshots.Capture(frame, field);
+		expectedFrames.push_back(SaveBodies(field));
+	}
+
+	// Rewinding takes a frame per restored frame, so game time keeps going while the simulation goes back to frame 59.
+	for (uint64_t frame = 118; frame >= 59; --frame)
+	{
+		AdvanceFrame(gameTime);
+		CHECK(snapshots.Rewind(frame, field));
+	}
+
+	for (uint64_t frame = 60; frame < 120; ++frame)
+	{
+		AdvanceFrame(gameTime);
+		field.Update(gameTime);
+		snapshots.Capture(frame, field);
+		CHECK(SaveBodies(field) == expectedFrames[frame - 60]);
+	}
+}
+
+TEST_CASE(RestoredUpdateTimesSkipTheRewind)
+{
+	OrbitingField field(1, hours(1));
+	field.Scheduler().MaxUpdatePeriod() = 1;
+	SnapshotBuffer snapshots;
+	GameTime gameTime;
+
+	for (uint64_t frame = 0; frame < 10; ++frame)
+	{
+		AdvanceFrame(gameTime);
+		field.Update(gameTime);
+		snapshots.Capture(frame, field);
+	}
+
+	CHECK(snapshots.Rewind(5, field));
+	gameTime.SetTotalGameTime(gameTime.TotalGameTime() + seconds(1));
+
+	AdvanceFrame(gameTime);
+	field.Update(gameTime);
+	CHECK_NEAR(FrameTime.count() / 1e9, field.Bodies()[0].LastUpdateSeconds(), 1e-7);
+	CHECK_EQUAL(7U, field.Bodies()[0].UpdateCount());
+}
\ No newline at end of file
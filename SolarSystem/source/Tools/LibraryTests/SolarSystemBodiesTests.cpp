@@ -0,0 +1,70 @@
+#include "pch.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+// The chain CelestialBodies built its local matrix from before it used SolarSystemBodies::LocalTransform().
+static XMMATRIX MatrixChain(float orbitalDistance, float scale, float axialTilt, float axialDisplacement, float orbitalDisplacement)
+{
+	return XMMatrixScaling(scale, scale, scale) * XMMatrixRotationY(axialDisplacement) * XMMatrixRotationZ(axialTilt) *
+		XMMatrixTranslation(0.0f, 0.0f, orbitalDistance) * XMMatrixRotationY(orbitalDisplacement);
+}
+
+static XMMATRIX ComposedTransform(const OrbitalTransform& transform)
+{
+	return XMMatrixScaling(transform.Scale, transform.Scale, transform.Scale) *
+		XMMatrixRotationQuaternion(XMVectorSet(transform.Rotation[0], transform.Rotation[1], transform.Rotation[2], transform.Rotation[3])) *
+		XMMatrixTranslation(transform.Translation[0], transform.Translation[1], transform.Translation[2]);
+}
+
+TEST_CASE(LocalTransformMatchesTheMatrixChain)
+{
+	mt19937 generator(1);
+	uniform_real_distribution<float> angle(-10.0f, 10.0f);
+
+	for (const CelestialBodyDescription& body : SolarSystemBodies::Bodies)
+	{
+		const float orbitalDistance = body.OrbitRadius * SolarSystemBodies::DistanceMultiplier;
+		const float axialDisplacement = angle(generator);
+		const float orbitalDisplacement = angle(generator);
+
+		XMFLOAT4X4 expected;
+		XMFLOAT4X4 actual;
+		XMStoreFloat4x4(&expected, MatrixChain(orbitalDistance, body.Scale, body.AxialTilt, axialDisplacement, orbitalDisplacement));
+		XMStoreFloat4x4(&actual, ComposedTransform(SolarSystemBodies::LocalTransform(orbitalDistance, body.Scale, body.AxialTilt, axialDisplacement, orbitalDisplacement)));
+
+		// Relative to the body's size for the rotation rows and to its distance for the translation
+		for (uint32_t row = 0; row < 4; ++row)
+		{
+			const double tolerance = 1e-5 * (row < 3 ? body.Scale : max(orbitalDistance, 1.0f));
+			for (uint32_t column = 0; column < 4; ++column)
+			{
+				CHECK_NEAR(expected.m[row][column], actual.m[row][column], tolerance);
+			}
+		}
+	}
+}
+
+TEST_CASE(LocalTransformRotationIsAUnitQuaternion)
+{
+	const OrbitalTransform transform = SolarSystemBodies::LocalTransform(100.0f, 2.0f, 0.4f, 3.0f, -1.5f);
+	const float* rotation = transform.Rotation;
+	CHECK_NEAR(1.0, rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2] + rotation[3] * rotation[3], 1e-6);
+	CHECK_EQUAL(2.0f, transform.Scale);
+	CHECK_EQUAL(0.0f, transform.Translation[1]);
+}
+
+TEST_CASE(ParentsPrecedeTheirSatellites)
+{
+	for (uint32_t i = 0; i < SolarSystemBodies::BodyCount; ++i)
+	{
+		CHECK(SolarSystemBodies::Bodies[i].ParentIndex < static_cast<int32_t>(i));
+		CHECK(SolarSystemBodies::Bodies[i].OrbitalPeriod > 0.0f);
+	}
+
+	CHECK_EQUAL(string("Earth"), string(SolarSystemBodies::Bodies[SolarSystemBodies::EarthIndex].Name));
+	CHECK_EQUAL(string("Moon"), string(SolarSystemBodies::Bodies[SolarSystemBodies::MoonIndex].Name));
+	CHECK_EQUAL(static_cast<int32_t>(SolarSystemBodies::EarthIndex), SolarSystemBodies::Bodies[SolarSystemBodies::MoonIndex].ParentIndex);
+	CHECK_EQUAL(0.0f, SolarSystemBodies::Sun.OrbitalPeriod);
+}
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "pch.h"
+#include "RecordingContext.h"
+
+using namespace std;
+using namespace LibraryTests;
+
+static MockObject Objects[4] = { { 1 }, { 2 }, { 3 }, { 4 } };
+
+static MockObject* RandomObject(mt19937& generator)
+{
+	const uint32_t index = generator() % 5;
+
+	return (index < 4 ? &Objects[index] : nullptr);
+}
+
+// Makes one random state call on target; both targets given the same generator state make the same call.
+template <typename TTarget>
+static void RandomCall(mt19937& generator, TTarget& target)
+{
+	MockObject* objects[8];
+	uint32_t values[8];
+	uint32_t moreValues[8];
+	for (uint32_t i = 0; i < 8; ++i)
+	{
+		objects[i] = RandomObject(generator);
+		values[i] = generator() % 3;
+		moreValues[i] = generator() % 2;
+	}
+
+	const float blendFactor[4] = { 1.0f, 1.0f, (generator() % 2 == 0 ? 1.0f : 0.5f), 1.0f };
+	const uint32_t count = 1 + generator() % 8;
+	switch (generator() % 16)
+	{
+	case 0:
+		target.IASetPrimitiveTopology(values[0]);
+		break;
+
+	case 1:
+		target.IASetInputLayout(objects[0]);
+		break;
+
+	case 2:
+		target.IASetVertexBuffers(generator() % (RecordingContext::VertexBufferSlotCount - 8), count, objects, values, moreValues);
+		break;
+
+	case 3:
+		target.IASetIndexBuffer(objects[0], values[0], moreValues[0]);
+		break;
+
+	case 4:
+		target.VSSetShader(objects[0], objects + 1, (generator() % 4 == 0 ? 1 : 0));
+		break;
+
+	case 5:
+		target.PSSetShader(objects[0], nullptr, 0);
+		break;
+
+	case 6:
+		target.VSSetConstantBuffers(generator() % (RecordingContext::ConstantBufferSlotCount - 8), count, objects);
+		break;
+
+	case 7:
+		target.PSSetConstantBuffers(generator() % (RecordingContext::ConstantBufferSlotCount - 8), count, objects);
+		break;
+
+	case 8:
+		target.VSSetConstantBuffers1(generator() % (RecordingContext::ConstantBufferSlotCount - 8), count, objects, values, moreValues);
+		break;
+
+	case 9:
+		target.PSSetConstantBuffers1(generator() % (RecordingContext::ConstantBufferSlotCount - 8), count, objects, values, moreValues);
+		break;
+
+	case 10:
+		target.PSSetShaderResources(generator() % (RecordingContext::ShaderResourceSlotCount - 8), count, objects);
+		break;
+
+	case 11:
+		target.PSSetSamplers(generator() % (RecordingContext::SamplerSlotCount - 8), count, objects);
+		break;
+
+	case 12:
+		target.RSSetState(objects[0]);
+		break;
+
+	case 13:
+		target.OMSetBlendState(objects[0], (generator() % 2 == 0 ? nullptr : blendFactor), values[0]);
+		break;
+
+	default:
+		target.OMSetDepthStencilState(objects[0], values[0]);
+		break;
+	}
+}
+
+TEST_CASE(FilteredCallsLeaveTheSameState)
+{
+	RecordingContext direct;
+	RecordingContext filtered;
+	RecordingStateCache stateCache(&filtered);
+
+	mt19937 directGenerator(1);
+	mt19937 filteredGenerator(1);
+	for (uint32_t i = 0; i < 20000; ++i)
+	{
+		RandomCall(directGenerator, direct);
+		RandomCall(filteredGenerator, stateCache);
+		if ((direct.State() == filtered.State()) == false)
+		{
+			CHECK(direct.State() == filtered.State());
+			break;
+		}
+
+		// Something else changes the state behind the cache now and then.
+		if (i % 5000 == 4999)
+		{
+			direct.IASetInputLayout(&Objects[3]);
+			filtered.IASetInputLayout(&Objects[3]);
+			stateCache.Invalidate();
+		}
+	}
+
+	// Random calls repeat the bound state often enough that a good share of them are dropped.
+	CHECK_EQUAL(20000U, stateCache.IssuedCallCount() + stateCache.FilteredCallCount());
+	CHECK_EQUAL(static_cast<size_t>(stateCache.IssuedCallCount() + 4), filtered.Calls().size());
+	CHECK(stateCache.FilteredCallCount() > 1000);
+}
+
+TEST_CASE(RepeatedCallsAreFiltered)
+{
+	RecordingContext context;
+	RecordingStateCache stateCache(&context);
+
+	MockObject* buffers[] = { &Objects[0], &Objects[1] };
+	const uint32_t strides[] = { 32, 16 };
+	const uint32_t offsets[] = { 0, 0 };
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		stateCache.IASetPrimitiveTopology(4);
+		stateCache.IASetVertexBuffers(0, 2, buffers, strides, offsets);
+		stateCache.VSSetShader(&Objects[2], nullptr, 0);
+		stateCache.PSSetConstantBuffers(0, 2, buffers);
+		stateCache.RSSetState(nullptr);
+		stateCache.OMSetBlendState(nullptr, nullptr, 0xFFFFFFFF);
+		stateCache.OMSetDepthStencilState(&Objects[3], 1);
+	}
+
+	CHECK_EQUAL(static_cast<size_t>(7), context.Calls().size());
+	CHECK_EQUAL(7U, stateCache.IssuedCallCount());
+	CHECK_EQUAL(14U, stateCache.FilteredCallCount());
+
+	// An explicit factor of ones is the same as a null one; a different stencil reference is not the same.
+	const float ones[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	stateCache.OMSetBlendState(nullptr, ones, 0xFFFFFFFF);
+	stateCache.OMSetDepthStencilState(&Objects[3], 2);
+	CHECK_EQUAL(static_cast<size_t>(8), context.Calls().size());
+	CHECK_EQUAL(string("OMSetDepthStencilState"), context.Calls().back().Function);
+
+	stateCache.ResetStatistics();
+	CHECK_EQUAL(0U, stateCache.IssuedCallCount());
+	CHECK_EQUAL(0U, stateCache.FilteredCallCount());
+}
+
+TEST_CASE(SlotRangesAreNarrowedToTheChangedSlots)
+{
+	RecordingContext context;
+	RecordingStateCache stateCache(&context);
+
+	MockObject* views[] = { &Objects[0], &Objects[1], &Objects[2], &Objects[3] };
+	stateCache.PSSetShaderResources(2, 4, views);
+	CHECK_EQUAL(2U, context.Calls().back().StartSlot);
+	CHECK_EQUAL(4U, context.Calls().back().Count);
+
+	// Only the middle two of four change.
+	MockObject* changedViews[] = { &Objects[0], &Objects[3], nullptr, &Objects[3] };
+	stateCache.PSSetShaderResources(2, 4, changedViews);
+	CHECK_EQUAL(3U, context.Calls().back().StartSlot);
+	CHECK_EQUAL(2U, context.Calls().back().Count);
+	CHECK(context.State().ShaderResources[3] == &Objects[3]);
+	CHECK(context.State().ShaderResources[4] == nullptr);
+
+	// A constant buffer bound with offsets differs from the same buffer bound whole.
+	MockObject* buffers[] = { &Objects[0] };
+	const uint32_t firstConstants[] = { 0 };
+	const uint32_t constantCounts[] = { 16 };
+	stateCache.VSSetConstantBuffers(0, 1, buffers);
+	stateCache.VSSetConstantBuffers1(0, 1, buffers, firstConstants, constantCounts);
+	stateCache.VSSetConstantBuffers1(0, 1, buffers, firstConstants, constantCounts);
+	stateCache.VSSetConstantBuffers(0, 1, buffers);
+	CHECK_EQUAL(static_cast<size_t>(5), context.Calls().size());
+
+	// Slots beyond the cache are always passed on.
+	MockObject* lastViews[] = { &Objects[0] };
+	stateCache.PSSetShaderResources(RecordingStateCache::ShaderResourceSlotCount, 1, lastViews);
+	stateCache.PSSetShaderResources(RecordingStateCache::ShaderResourceSlotCount, 1, lastViews);
+	CHECK_EQUAL(static_cast<size_t>(7), context.Calls().size());
+}
+
+TEST_CASE(InvalidateAndClassInstancesReissueCalls)
+{
+	RecordingContext context;
+	RecordingStateCache stateCache(&context);
+
+	stateCache.PSSetShader(&Objects[0], nullptr, 0);
+	stateCache.PSSetShader(&Objects[0], nullptr, 0);
+	CHECK_EQUAL(static_cast<size_t>(1), context.Calls().size());
+
+	stateCache.Invalidate();
+	stateCache.PSSetShader(&Objects[0], nullptr, 0);
+	CHECK_EQUAL(static_cast<size_t>(2), context.Calls().size());
+
+	// Class linkage isn't tracked, so those calls always go through.
+	MockObject* classInstances[] = { &Objects[1] };
+	stateCache.VSSetShader(&Objects[2], classInstances, 1);
+	stateCache.VSSetShader(&Objects[2], classInstances, 1);
+	CHECK_EQUAL(static_cast<size_t>(4), context.Calls().size());
+
+	RecordingContext otherContext;
+	stateCache.SetContext(&otherContext);
+	stateCache.PSSetShader(&Objects[0], nullptr, 0);
+	CHECK_EQUAL(static_cast<size_t>(1), otherContext.Calls().size());
+	CHECK(stateCache.Context() == &otherContext);
+}
\ No newline at end of file
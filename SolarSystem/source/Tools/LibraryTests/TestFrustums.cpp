@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "TestFrustums.h"
+
+using namespace std;
+using namespace Library;
+
+namespace LibraryTests
+{
+	Frustum TestFrustums::Box(float minX, float minY, float minZ, float maxX, float maxY, float maxZ)
+	{
+		Frustum frustum;
+		SetPlane(frustum, Frustum::Left, 1.0f, 0.0f, 0.0f, -minX);
+		SetPlane(frustum, Frustum::Right, -1.0f, 0.0f, 0.0f, maxX);
+		SetPlane(frustum, Frustum::Bottom, 0.0f, 1.0f, 0.0f, -minY);
+		SetPlane(frustum, Frustum::Top, 0.0f, -1.0f, 0.0f, maxY);
+		SetPlane(frustum, Frustum::Near, 0.0f, 0.0f, 1.0f, -minZ);
+		SetPlane(frustum, Frustum::Far, 0.0f, 0.0f, -1.0f, maxZ);
+
+		return frustum;
+	}
+
+	Frustum TestFrustums::FromViewProjection(const float* viewProjection)
+	{
+		// Column j of the matrix is element j of every row.
+		float columns[4][4];
+		for (uint32_t row = 0; row < 4; ++row)
+		{
+			for (uint32_t column = 0; column < 4; ++column)
+			{
+				columns[column][row] = viewProjection[row * 4 + column];
+			}
+		}
+
+		Frustum frustum;
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			frustum.Planes[Frustum::Left][i] = columns[3][i] + columns[0][i];
+			frustum.Planes[Frustum::Right][i] = columns[3][i] - columns[0][i];
+			frustum.Planes[Frustum::Bottom][i] = columns[3][i] + columns[1][i];
+			frustum.Planes[Frustum::Top][i] = columns[3][i] - columns[1][i];
+			frustum.Planes[Frustum::Near][i] = columns[2][i];
+			frustum.Planes[Frustum::Far][i] = columns[3][i] - columns[2][i];
+		}
+
+		for (uint32_t plane = 0; plane < Frustum::PlaneCount; ++plane)
+		{
+			float* p = frustum.Planes[plane];
+			SetPlane(frustum, static_cast<Frustum::PlaneIndex>(plane), p[0], p[1], p[2], p[3]);
+		}
+
+		return frustum;
+	}
+
+	void TestFrustums::Perspective(float fieldOfView, float aspectRatio, float nearPlane, float farPlane, float* viewProjection)
+	{
+		const float yScale = 1.0f / tan(fieldOfView * 0.5f);
+		const float range = farPlane / (nearPlane - farPlane);
+		const float projection[16] =
+		{
+			yScale / aspectRatio, 0.0f, 0.0f, 0.0f,
+			0.0f, yScale, 0.0f, 0.0f,
+			0.0f, 0.0f, range, -1.0f,
+			0.0f, 0.0f, range * nearPlane, 0.0f
+		};
+
+		copy(begin(projection), end(projection), viewProjection);
+	}
+
+	void TestFrustums::SetPlane(Frustum& frustum, Frustum::PlaneIndex index, float a, float b, float c, float d)
+	{
+		const float length = sqrt(a * a + b * b + c * c);
+		float* plane = frustum.Planes[index];
+		plane[0] = a / length;
+		plane[1] = b / length;
+		plane[2] = c / length;
+		plane[3] = d / length;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "FrustumCuller.h"
+
+namespace LibraryTests
+{
+	// Frustums for culling tests, built the way Camera builds its own.
+	class TestFrustums final
+	{
+	public:
+		// An axis-aligned box, which is a frustum whose opposite planes are parallel.
+		static Library::Frustum Box(float minX, float minY, float minZ, float maxX, float maxY, float maxZ);
+
+		// viewProjection is row-major and transforms row vectors, with 0 <= z <= w in clip space.
+		static Library::Frustum FromViewProjection(const float* viewProjection);
+
+		// Writes the 16 elements of a right-handed perspective projection from the origin down -Z, as XMMatrixPerspectiveFovRH builds it.
+		static void Perspective(float fieldOfView, float aspectRatio, float nearPlane, float farPlane, float* viewProjection);
+
+		TestFrustums() = delete;
+		TestFrustums(const TestFrustums&) = delete;
+		TestFrustums& operator=(const TestFrustums&) = delete;
+		TestFrustums(TestFrustums&&) = delete;
+		TestFrustums& operator=(TestFrustums&&) = delete;
+		~TestFrustums() = default;
+
+	private:
+		static void SetPlane(Library::Frustum& frustum, Library::Frustum::PlaneIndex index, float a, float b, float c, float d);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace LibraryTests
+{
+	uint32_t TestHarness::sFailureCount = 0;
+
+	bool TestHarness::AddTest(const char* name, TestFunction function)
+	{
+		Tests().emplace_back(name, function);
+		return true;
+	}
+
+	int TestHarness::Run(const string& filter)
+	{
+		uint32_t runCount = 0;
+		for (const Test& test : Tests())
+		{
+			if (filter.empty() == false && string(test.Name).find(filter) == string::npos)
+			{
+				continue;
+			}
+
+			const uint32_t failureCount = sFailureCount;
+			const steady_clock::time_point startTime = steady_clock::now();
+			try
+			{
+				test.Function();
+			}
+			catch (const exception& ex)
+			{
+				Fail(test.Name, 0, string("unexpected exception: ") + ex.what());
+			}
+
+			const duration<double, milli> elapsed = steady_clock::now() - startTime;
+			cout << (sFailureCount == failureCount ? "[ passed ] " : "[ FAILED ] ") << test.Name << " (" << fixed << setprecision(1) << elapsed.count() << " ms)" << endl;
+			++runCount;
+		}
+
+		cout << runCount << " tests, " << sFailureCount << " failures" << endl;
+		if (runCount == 0)
+		{
+			cout << "No test matches \"" << filter << "\"." << endl;
+			return 1;
+		}
+
+		return static_cast<int>(min(sFailureCount, 255u));
+	}
+
+	void TestHarness::Fail(const char* file, int line, const string& message)
+	{
+		++sFailureCount;
+		cout << file << "(" << line << "): " << message << endl;
+	}
+
+	uint32_t TestHarness::FailureCount()
+	{
+		return sFailureCount;
+	}
+
+	vector<TestHarness::Test>& TestHarness::Tests()
+	{
+		// A function-local static, so registrations from other translation units' static initializers always find it constructed.
+		static vector<Test> tests;
+		return tests;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	return LibraryTests::TestHarness::Run(argc > 1 ? argv[1] : "");
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdint>
+
+namespace LibraryTests
+{
+	// Each test executable registers its cases with TEST_CASE and links TestHarness.cpp for main(), which runs every case, or
+	// those whose names contain the first argument, and returns the number of failed checks.
+	class TestHarness final
+	{
+	public:
+		typedef void(*TestFunction)();
+
+		static bool AddTest(const char* name, TestFunction function);
+		static int Run(const std::string& filter);
+
+		static void Fail(const char* file, int line, const std::string& message);
+		static std::uint32_t FailureCount();
+
+		TestHarness() = delete;
+		TestHarness(const TestHarness&) = delete;
+		TestHarness& operator=(const TestHarness&) = delete;
+		TestHarness(TestHarness&&) = delete;
+		TestHarness& operator=(TestHarness&&) = delete;
+		~TestHarness() = default;
+
+	private:
+		struct Test
+		{
+			const char* Name;
+			TestFunction Function;
+
+			Test(const char* name, TestFunction function) :
+				Name(name), Function(function) { }
+		};
+
+		static std::vector<Test>& Tests();
+
+		static std::uint32_t sFailureCount;
+	};
+
+	template <typename TExpected, typename TActual>
+	inline void CheckEqual(const TExpected& expected, const TActual& actual, const char* expression, const char* file, int line)
+	{
+		if ((expected == actual) == false)
+		{
+			std::ostringstream message;
+			message << expression << ": expected " << expected << ", got " << actual;
+			TestHarness::Fail(file, line, message.str());
+		}
+	}
+
+	template <typename T>
+	inline void CheckNear(const T& expected, const T& actual, const T& tolerance, const char* expression, const char* file, int line)
+	{
+		if ((actual >= expected - tolerance && actual <= expected + tolerance) == false)
+		{
+			std::ostringstream message;
+			message.precision(17);
+			message << expression << ": expected " << expected << " within " << tolerance << ", got " << actual;
+			TestHarness::Fail(file, line, message.str());
+		}
+	}
+}
+
+#define TEST_CASE(Name) \
+	static void Name(); \
+	static const bool Name##Registered = LibraryTests::TestHarness::AddTest(#Name, Name); \
+	static void Name()
+
+#define CHECK(Condition) \
+	do \
+	{ \
+		if ((Condition) == false) \
+		{ \
+			LibraryTests::TestHarness::Fail(__FILE__, __LINE__, #Condition); \
+		} \
+	} while (false)
+
+#define CHECK_EQUAL(Expected, Actual) LibraryTests::CheckEqual((Expected), (Actual), #Actual, __FILE__, __LINE__)
+#define CHECK_NEAR(Expected, Actual, Tolerance) LibraryTests::CheckNear<double>((Expected), (Actual), (Tolerance), #Actual, __FILE__, __LINE__)
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace Library;
+
+static const int64_t NanosecondsPerDay = 86400LL * 1000000000LL;
+
+// Frame times from a quarter of a millisecond to two 60 Hz frames, to the nanosecond.
+static nanoseconds FrameTime(mt19937& generator)
+{
+	uniform_int_distribution<int64_t> frameTime(250001, 33333333);
+	return nanoseconds(frameTime(generator));
+}
+
+TEST_CASE(UnscaledTimelinesSumEveryNanosecond)
+{
+	Timeline timeline;
+	CHECK_EQUAL(1.0, timeline.Scale());
+	CHECK(timeline.IsPaused() == false);
+
+	// Shorter than a millisecond, which the old millisecond clock reported as no time at all.
+	CHECK_EQUAL(int64_t(250000), timeline.Advance(microseconds(250)).count());
+	CHECK_EQUAL(int64_t(1), timeline.Advance(nanoseconds(1)).count());
+	CHECK_EQUAL(int64_t(250001), timeline.Total().count());
+	CHECK_EQUAL(int64_t(1), timeline.Elapsed().count());
+
+	mt19937 generator(1);
+	int64_t expected = timeline.Total().count();
+	for (uint32_t i = 0; i < 100000; ++i)
+	{
+		const nanoseconds frameTime = FrameTime(generator);
+		CHECK_EQUAL(frameTime.count(), timeline.Advance(frameTime).count());
+		expected += frameTime.count();
+	}
+	CHECK_EQUAL(expected, timeline.Total().count());
+}
+
+TEST_CASE(ScaledTimelinesCarryFractionsInsteadOfDrifting)
+{
+	// One third can't be represented, and 1.5 splits an odd frame time between frames.
+	const double scales[] = { 1.0 / 3.0, 1.5, 0.001 };
+	for (double scale : scales)
+	{
+		Timeline timeline(scale);
+		mt19937 generator(2);
+		int64_t unscaled = 0;
+		int64_t elapsedSum = 0;
+		for (uint32_t i = 0; i < 100000; ++i)
+		{
+			const nanoseconds frameTime = FrameTime(generator);
+			elapsedSum += timeline.Advance(frameTime).count();
+			unscaled += frameTime.count();
+		}
+
+		// Every frame is truncated to whole nanoseconds, but the total stays within one of the exact product.
+		const double exact = static_cast<double>(unscaled) * scale;
+		CHECK_EQUAL(elapsedSum, timeline.Total().count());
+		CHECK(fabs(static_cast<double>(timeline.Total().count()) - exact) <= 1.0);
+	}
+}
+
+TEST_CASE(PausingScalingAndResetting)
+{
+	Timeline timeline(0.5);
+	timeline.Advance(nanoseconds(3));
+	CHECK_EQUAL(int64_t(1), timeline.Total().count());
+
+	timeline.SetPaused(true);
+	CHECK_EQUAL(int64_t(0), timeline.Advance(seconds(10)).count());
+	CHECK_EQUAL(int64_t(0), timeline.Elapsed().count());
+	CHECK_EQUAL(int64_t(1), timeline.Total().count());
+
+	// The half nanosecond left before the pause is still carried.
+	timeline.SetPaused(false);
+	CHECK_EQUAL(int64_t(2), timeline.Advance(nanoseconds(3)).count());
+	CHECK_EQUAL(int64_t(3), timeline.Total().count());
+
+	timeline.SetScale(0.0);
+	CHECK_EQUAL(int64_t(0), timeline.Advance(seconds(1)).count());
+	timeline.SetScale(2.0);
+	CHECK_EQUAL(int64_t(2000000000), timeline.Advance(seconds(1)).count());
+
+	timeline.Reset();
+	CHECK_EQUAL(int64_t(0), timeline.Total().count());
+	CHECK_EQUAL(int64_t(0), timeline.Elapsed().count());
+	CHECK_EQUAL(2.0, timeline.Scale());
+
+	// Reset() drops the carried fraction too.
+	timeline.SetScale(0.5);
+	timeline.Advance(nanoseconds(1));
+	timeline.Reset();
+	CHECK_EQUAL(int64_t(0), timeline.Advance(nanoseconds(1)).count());
+}
+
+TEST_CASE(EpochSecondsKeepNanosecondsAfterCenturies)
+{
+	// The J2000 epoch in Unix seconds, then a hundred years of whole days.
+	const double epochSeconds = 946728000.0;
+	Timeline timeline(1.0, epochSeconds);
+	CHECK_EQUAL(epochSeconds, timeline.Seconds());
+
+	for (uint32_t day = 0; day < 36525; ++day)
+	{
+		timeline.Advance(nanoseconds(NanosecondsPerDay));
+	}
+	timeline.Advance(nanoseconds(123456789));
+
+	const Timeline::Reading reading = timeline.Read();
+	CHECK_EQUAL(36525LL * NanosecondsPerDay + 123456789, reading.Total.count());
+	CHECK_EQUAL(int64_t(123456789), reading.Elapsed.count());
+
+	// About 4e9 seconds, where a double still resolves about half a microsecond.
+	const double expectedSeconds = epochSeconds + 36525.0 * 86400.0 + 0.123456789;
+	CHECK_NEAR(expectedSeconds, reading.Seconds, 1e-6);
+
+	timeline.SetEpochSeconds(0.0);
+	CHECK_NEAR(36525.0 * 86400.0 + 0.123456789, timeline.Seconds(), 1e-6);
+	CHECK_EQUAL(reading.Total.count(), timeline.Total().count());
+}
+
+TEST_CASE(GameClockOverAMultiDayRun)
+{
+	GameClock clock;
+	GameTime gameTime;
+	const steady_clock::time_point startTime = clock.StartTime();
+	clock.GameTimeline().SetScale(1.0 / 3.0);
+	clock.SimulationTimeline().SetScale(1000.0);
+	clock.SimulationTimeline().SetEpochSeconds(1000.0);
+
+	// Three days of 60 Hz frames with jitter, replayed instead of waited for.
+	mt19937 generator(3);
+	steady_clock::time_point currentTime = startTime;
+	int64_t gameSum = 0;
+	int64_t simulationSum = 0;
+	uint32_t frameCount = 0;
+	while (currentTime - startTime < nanoseconds(3 * NanosecondsPerDay))
+	{
+		currentTime += duration_cast<steady_clock::duration>(FrameTime(generator));
+		clock.UpdateGameTime(gameTime, currentTime);
+		gameSum += gameTime.ElapsedGameTime().count();
+		simulationSum += gameTime.ElapsedSimulationTime().count();
+		++frameCount;
+	}
+	CHECK(frameCount > 3 * 86400 * 50);
+
+	// Real time is exact; game time is within a nanosecond of a third of it and sums its frames; simulation time is exactly a
+	// thousand times game time.
+	const int64_t realTotal = duration_cast<nanoseconds>(currentTime - startTime).count();
+	CHECK_EQUAL(realTotal, gameTime.TotalRealTime().count());
+	CHECK_EQUAL(gameSum, gameTime.TotalGameTime().count());
+	CHECK(fabs(static_cast<double>(gameTime.TotalGameTime().count()) - static_cast<double>(realTotal) / 3.0) <= 1.0);
+	CHECK_EQUAL(gameSum * 1000, simulationSum);
+	CHECK_EQUAL(simulationSum, clock.SimulationTimeline().Total().count());
+	CHECK_NEAR(1000.0 + static_cast<double>(simulationSum) * 1e-9, gameTime.SimulationSeconds(), 1e-6);
+
+	// A fixed time step advances game time by exactly that much whatever the frame took.
+	clock.GameTimeline().SetScale(1.0);
+	clock.SetFixedTimeStep(nanoseconds(16666667));
+	const int64_t fixedStart = gameTime.TotalGameTime().count();
+	for (uint32_t i = 0; i < 600; ++i)
+	{
+		currentTime += duration_cast<steady_clock::duration>(FrameTime(generator));
+		clock.UpdateGameTime(gameTime, currentTime);
+		CHECK_EQUAL(int64_t(16666667), gameTime.ElapsedGameTime().count());
+	}
+	CHECK_EQUAL(fixedStart + 600LL * 16666667, gameTime.TotalGameTime().count());
+}
+
+TEST_CASE(ReadersOnOtherThreadsNeverSeeATornReading)
+{
+	const uint32_t ReaderCount = 3;
+	const uint32_t MinimumReadCount = 10000;
+	const uint32_t MinimumWriteCount = 1000;
+
+	Timeline timeline(1.0, -1.0);
+	atomic<uint32_t> startedCount(0);
+	atomic<bool> isDone(false);
+	atomic<uint32_t> tornCount(0);
+	atomic<uint32_t> readCount(0);
+
+	vector<thread> readers;
+	for (uint32_t i = 0; i < ReaderCount; ++i)
+	{
+		readers.emplace_back([&]()
+		{
+			++startedCount;
+			int64_t lastTotal = 0;
+			while (isDone.load() == false)
+			{
+				// The owner advances by 7 ns, then sets the epoch to one less than the number of steps, so a consistent reading's
+				// epoch is one or two less than its step count.
+				const Timeline::Reading reading = timeline.Read();
+				const int64_t steps = reading.Total.count() / 7;
+				const double epochSeconds = reading.Seconds - static_cast<double>(reading.Total.count()) * 1e-9;
+				const bool consistent = (reading.Total.count() >= lastTotal && reading.Total.count() % 7 == 0 &&
+					reading.Elapsed.count() == (steps == 0 ? 0 : 7) && (fabs(epochSeconds - (steps - 1)) < 1e-3 || fabs(epochSeconds - (steps - 2)) < 1e-3));
+				tornCount += (consistent ? 0 : 1);
+				lastTotal = reading.Total.count();
+				++readCount;
+			}
+		});
+	}
+
+	// Every reader is running before the first write, and the writer keeps going until they have read enough, however the
+	// threads are scheduled; on one processor the writer could otherwise finish before any reader ran.
+	while (startedCount.load() < ReaderCount)
+	{
+		this_thread::yield();
+	}
+
+	uint32_t writeCount = 0;
+	for (; writeCount < MinimumWriteCount || readCount.load() < MinimumReadCount; ++writeCount)
+	{
+		timeline.Advance(nanoseconds(7));
+		timeline.SetEpochSeconds(static_cast<double>(writeCount));
+	}
+	isDone = true;
+	for (thread& reader : readers)
+	{
+		reader.join();
+	}
+
+	CHECK_EQUAL(0U, tornCount.load());
+	CHECK(readCount.load() >= MinimumReadCount);
+	CHECK_EQUAL(int64_t(writeCount) * 7, timeline.Total().count());
+}
\ No newline at end of file
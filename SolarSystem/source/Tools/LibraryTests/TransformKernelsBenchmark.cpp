@@ -0,0 +1,160 @@
+#include "pch.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace DirectX;
+using namespace Library;
+
+// Usage: TransformKernelsBenchmark [objects] [repetitions]
+// Times each TransformKernels operation with every instruction set this processor supports, against the per-object DirectXMath
+// calls it replaces, and reports the best rate of each in millions of matrices per second.
+
+struct Batch
+{
+	vector<float> Scales;
+	vector<float> RotationX;
+	vector<float> RotationY;
+	vector<float> RotationZ;
+	vector<float> RotationW;
+	vector<float> TranslationX;
+	vector<float> TranslationY;
+	vector<float> TranslationZ;
+	vector<XMFLOAT4X4> Lhs;
+	vector<XMFLOAT4X4> Rhs;
+	vector<XMFLOAT4X4> Results;
+	vector<XMFLOAT4X4> SecondResults;
+	XMFLOAT4X4 ViewProjection;
+};
+
+static void CreateBatch(Batch& batch, uint32_t count)
+{
+	mt19937 generator(1);
+	uniform_real_distribution<float> scale(0.1f, 10.0f);
+	uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+	uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		XMFLOAT4 rotation;
+		XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(angle(generator), angle(generator), angle(generator)));
+		batch.Scales.push_back(scale(generator));
+		batch.RotationX.push_back(rotation.x);
+		batch.RotationY.push_back(rotation.y);
+		batch.RotationZ.push_back(rotation.z);
+		batch.RotationW.push_back(rotation.w);
+		batch.TranslationX.push_back(position(generator));
+		batch.TranslationY.push_back(position(generator));
+		batch.TranslationZ.push_back(position(generator));
+	}
+
+	batch.Lhs.resize(count);
+	batch.Rhs.resize(count);
+	batch.Results.resize(count);
+	batch.SecondResults.resize(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		XMStoreFloat4x4(&batch.Lhs[i], XMMatrixScaling(batch.Scales[i], batch.Scales[i], batch.Scales[i]) *
+			XMMatrixRotationQuaternion(XMVectorSet(batch.RotationX[i], batch.RotationY[i], batch.RotationZ[i], batch.RotationW[i])) *
+			XMMatrixTranslation(batch.TranslationX[i], batch.TranslationY[i], batch.TranslationZ[i]));
+		XMStoreFloat4x4(&batch.Rhs[i], XMMatrixRotationZ(angle(generator)) * XMMatrixTranslation(position(generator), 0.0f, position(generator)));
+	}
+
+	XMStoreFloat4x4(&batch.ViewProjection, XMMatrixLookToRH(XMVectorSet(0.0f, 50.0f, 200.0f, 1.0f), XMVectorSet(0.0f, -0.25f, -1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) *
+		XMMatrixPerspectiveFovRH(XM_PIDIV4, 4.0f / 3.0f, 0.5f, 10000.0f));
+}
+
+template <typename TRun>
+static double BestMatricesPerSecond(uint32_t count, uint32_t repetitions, TRun run)
+{
+	double best = numeric_limits<double>::max();
+	for (uint32_t i = 0; i < repetitions; ++i)
+	{
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		run();
+		best = min(best, duration<double>(high_resolution_clock::now() - startTime).count());
+	}
+
+	return count / max(best, 1e-9) / 1000000.0;
+}
+
+// Prints the per-object rate, then the kernel's with each instruction set.
+template <typename TPerObject, typename TKernel>
+static void Run(const char* name, uint32_t count, uint32_t repetitions, TPerObject perObject, TKernel kernel)
+{
+	cout << left << setw(22) << name << right << fixed << setprecision(1) << setw(12) << BestMatricesPerSecond(count, repetitions, perObject);
+	for (int32_t i = 0; i <= static_cast<int32_t>(TransformKernels::InstructionSet::AVX512); ++i)
+	{
+		if (i <= static_cast<int32_t>(TransformKernels::BestInstructionSet()))
+		{
+			const TransformKernels::InstructionSet instructionSet = static_cast<TransformKernels::InstructionSet>(i);
+			cout << setw(10) << BestMatricesPerSecond(count, repetitions, [&]() { kernel(instructionSet); });
+		}
+		else
+		{
+			cout << setw(10) << "-";
+		}
+	}
+	cout << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t objectCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 1024);
+	const uint32_t repetitions = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 2000);
+	if (objectCount == 0 || repetitions == 0)
+	{
+		cerr << "Usage: TransformKernelsBenchmark [objects] [repetitions]" << endl;
+		return 1;
+	}
+
+	Batch batch;
+	CreateBatch(batch, objectCount);
+	const TrsArrays trs = { batch.Scales.data(), batch.Scales.data(), batch.Scales.data(), batch.RotationX.data(), batch.RotationY.data(), batch.RotationZ.data(), batch.RotationW.data(),
+		batch.TranslationX.data(), batch.TranslationY.data(), batch.TranslationZ.data() };
+	const ConstMatrixArray lhs(batch.Lhs.data());
+	const ConstMatrixArray rhs(batch.Rhs.data());
+	const MatrixArray results(batch.Results.data());
+	const MatrixArray secondResults(batch.SecondResults.data());
+
+	cout << objectCount << " objects, best of " << repetitions << "; millions of matrices per second" << endl;
+	cout << left << setw(22) << "" << right << setw(12) << "per object" << setw(10) << "Scalar" << setw(10) << "SSE" << setw(10) << "AVX2" << setw(10) << "AVX-512" << endl;
+
+	Run("ComposeTrs", objectCount, repetitions, [&]()
+	{
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			XMStoreFloat4x4(&batch.Results[i], XMMatrixScaling(batch.Scales[i], batch.Scales[i], batch.Scales[i]) *
+				XMMatrixRotationQuaternion(XMVectorSet(batch.RotationX[i], batch.RotationY[i], batch.RotationZ[i], batch.RotationW[i])) *
+				XMMatrixTranslation(batch.TranslationX[i], batch.TranslationY[i], batch.TranslationZ[i]));
+		}
+	}, [&](TransformKernels::InstructionSet instructionSet) { TransformKernels::ComposeTrs(trs, results, objectCount, instructionSet); });
+
+	Run("Multiply", objectCount, repetitions, [&]()
+	{
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			XMStoreFloat4x4(&batch.Results[i], XMLoadFloat4x4(&batch.Lhs[i]) * XMLoadFloat4x4(&batch.Rhs[i]));
+		}
+	}, [&](TransformKernels::InstructionSet instructionSet) { TransformKernels::Multiply(lhs, rhs, results, objectCount, instructionSet); });
+
+	Run("WorldViewProjection", objectCount, repetitions, [&]()
+	{
+		const XMMATRIX viewProjection = XMLoadFloat4x4(&batch.ViewProjection);
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			const XMMATRIX world = XMLoadFloat4x4(&batch.Lhs[i]);
+			XMStoreFloat4x4(&batch.Results[i], XMMatrixTranspose(world));
+			XMStoreFloat4x4(&batch.SecondResults[i], XMMatrixTranspose(world * viewProjection));
+		}
+	}, [&](TransformKernels::InstructionSet instructionSet) { TransformKernels::WorldViewProjection(lhs, batch.ViewProjection, results, secondResults, objectCount, instructionSet); });
+
+	Run("Transpose", objectCount, repetitions, [&]()
+	{
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			XMStoreFloat4x4(&batch.Results[i], XMMatrixTranspose(XMLoadFloat4x4(&batch.Lhs[i])));
+		}
+	}, [&](TransformKernels::InstructionSet instructionSet) { TransformKernels::Transpose(lhs, results, objectCount, instructionSet); });
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include "pch.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace Library;
+
+// Not a multiple of any kernel's width, so every instruction set also runs the narrower kernels and the scalar tail.
+static const uint32_t ObjectCount = 61;
+
+// The scalar and SSE kernels do DirectXMath's arithmetic in the order of its SSE path, but DirectXMath's own build (its scalar
+// fallback, or a compiler that contracts to FMA) can round differently; the AVX2 and AVX-512 kernels fuse multiplies and adds,
+// which moves results further.
+static const uint32_t MaxUlps = 4;
+static const uint32_t FusedMaxUlps = 32;
+
+// A matrix member of an array of structures, as the kernels write into components and constant buffer data.
+struct Transform
+{
+	float Radius;
+	XMFLOAT4X4 Matrix;
+	uint32_t Flags;
+};
+
+struct TrsInput
+{
+	vector<float> ScaleX;
+	vector<float> ScaleY;
+	vector<float> ScaleZ;
+	vector<float> RotationX;
+	vector<float> RotationY;
+	vector<float> RotationZ;
+	vector<float> RotationW;
+	vector<float> TranslationX;
+	vector<float> TranslationY;
+	vector<float> TranslationZ;
+
+	TrsArrays Arrays() const
+	{
+		return TrsArrays{ ScaleX.data(), ScaleY.data(), ScaleZ.data(), RotationX.data(), RotationY.data(), RotationZ.data(), RotationW.data(),
+			TranslationX.data(), TranslationY.data(), TranslationZ.data() };
+	}
+};
+
+static TrsInput CreateTrs(uint32_t count)
+{
+	mt19937 generator(7);
+	uniform_real_distribution<float> scale(0.1f, 10.0f);
+	uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+	uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+	TrsInput trs;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		trs.ScaleX.push_back(scale(generator));
+		trs.ScaleY.push_back(scale(generator));
+		trs.ScaleZ.push_back(scale(generator));
+
+		XMFLOAT4 rotation;
+		XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(angle(generator), angle(generator), angle(generator)));
+		trs.RotationX.push_back(rotation.x);
+		trs.RotationY.push_back(rotation.y);
+		trs.RotationZ.push_back(rotation.z);
+		trs.RotationW.push_back(rotation.w);
+
+		trs.TranslationX.push_back(position(generator));
+		trs.TranslationY.push_back(position(generator));
+		trs.TranslationZ.push_back(position(generator));
+	}
+
+	return trs;
+}
+
+static XMMATRIX ComposedTrs(const TrsInput& trs, uint32_t index)
+{
+	return XMMatrixScaling(trs.ScaleX[index], trs.ScaleY[index], trs.ScaleZ[index]) *
+		XMMatrixRotationQuaternion(XMVectorSet(trs.RotationX[index], trs.RotationY[index], trs.RotationZ[index], trs.RotationW[index])) *
+		XMMatrixTranslation(trs.TranslationX[index], trs.TranslationY[index], trs.TranslationZ[index]);
+}
+
+static vector<XMFLOAT4X4> CreateMatrices(uint32_t count, uint32_t seed)
+{
+	mt19937 generator(seed);
+	uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+	uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+	vector<XMFLOAT4X4> matrices(count);
+	for (XMFLOAT4X4& matrix : matrices)
+	{
+		XMStoreFloat4x4(&matrix, XMMatrixScaling(2.0f, 0.5f, 3.0f) * XMMatrixRotationQuaternion(XMQuaternionRotationRollPitchYaw(angle(generator), angle(generator), angle(generator))) *
+			XMMatrixTranslation(position(generator), position(generator), position(generator)));
+	}
+
+	return matrices;
+}
+
+static XMFLOAT4X4 ViewProjection()
+{
+	XMFLOAT4X4 viewProjection;
+	XMStoreFloat4x4(&viewProjection, XMMatrixLookToRH(XMVectorSet(0.0f, 50.0f, 200.0f, 1.0f), XMVectorSet(0.0f, -0.25f, -1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) *
+		XMMatrixPerspectiveFovRH(XM_PIDIV4, 4.0f / 3.0f, 0.5f, 10000.0f));
+
+	return viewProjection;
+}
+
+// The number of representable floats between two values, counting across zero.
+static uint32_t UlpDistance(float lhs, float rhs)
+{
+	int32_t lhsBits;
+	int32_t rhsBits;
+	memcpy(&lhsBits, &lhs, sizeof(float));
+	memcpy(&rhsBits, &rhs, sizeof(float));
+
+	// Maps the sign-magnitude bit patterns onto one ordered line, with both zeros at 0.
+	const int64_t lhsOrdered = (lhsBits < 0 ? -static_cast<int64_t>(lhsBits & 0x7FFFFFFF) : lhsBits);
+	const int64_t rhsOrdered = (rhsBits < 0 ? -static_cast<int64_t>(rhsBits & 0x7FFFFFFF) : rhsBits);
+	const int64_t distance = (lhsOrdered > rhsOrdered ? lhsOrdered - rhsOrdered : rhsOrdered - lhsOrdered);
+
+	return static_cast<uint32_t>(min(distance, static_cast<int64_t>((numeric_limits<uint32_t>::max)())));
+}
+
+// Each element is within MaxUlps (FusedMaxUlps for the fused kernels) of DirectXMath's. An element that cancels to near zero keeps
+// the rounding error of the terms it was summed from, so it may instead be within as many units in the last place of the
+// largest element in its row.
+static bool Matches(const XMFLOAT4X4& matrix, FXMMATRIX expected, TransformKernels::InstructionSet instructionSet)
+{
+	XMFLOAT4X4 reference;
+	XMStoreFloat4x4(&reference, expected);
+
+	const bool fused = (instructionSet == TransformKernels::InstructionSet::AVX2 || instructionSet == TransformKernels::InstructionSet::AVX512);
+	const uint32_t maxUlps = (fused ? FusedMaxUlps : MaxUlps);
+	for (uint32_t row = 0; row < 4; ++row)
+	{
+		float largest = 0.0f;
+		for (uint32_t column = 0; column < 4; ++column)
+		{
+			largest = max(largest, fabs(reference.m[row][column]));
+		}
+		const float largestUlp = nextafter(largest, numeric_limits<float>::infinity()) - largest;
+
+		for (uint32_t column = 0; column < 4; ++column)
+		{
+			const float actual = matrix.m[row][column];
+			const float wanted = reference.m[row][column];
+			if (UlpDistance(actual, wanted) > maxUlps && fabs(actual - wanted) > maxUlps * largestUlp)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Every instruction set this processor can run, scalar first.
+static vector<TransformKernels::InstructionSet> SupportedInstructionSets()
+{
+	vector<TransformKernels::InstructionSet> instructionSets;
+	for (int32_t i = 0; i <= static_cast<int32_t>(TransformKernels::BestInstructionSet()); ++i)
+	{
+		instructionSets.push_back(static_cast<TransformKernels::InstructionSet>(i));
+	}
+
+	return instructionSets;
+}
+
+TEST_CASE(ComposeTrsMatchesDirectXMath)
+{
+	const TrsInput trs = CreateTrs(ObjectCount);
+	for (TransformKernels::InstructionSet instructionSet : SupportedInstructionSets())
+	{
+		vector<Transform> transforms(ObjectCount + 1);
+		transforms[ObjectCount].Flags = 0xFEEDFACE;
+		TransformKernels::ComposeTrs(trs.Arrays(), MatrixArray(&transforms[0].Matrix, sizeof(Transform)), ObjectCount, instructionSet);
+
+		uint32_t matchCount = 0;
+		for (uint32_t i = 0; i < ObjectCount; ++i)
+		{
+			matchCount += (Matches(transforms[i].Matrix, ComposedTrs(trs, i), instructionSet) ? 1 : 0);
+		}
+		CHECK_EQUAL(ObjectCount, matchCount);
+		CHECK_EQUAL(0xFEEDFACE, transforms[ObjectCount].Flags);
+	}
+}
+
+TEST_CASE(MultiplyMatchesDirectXMath)
+{
+	const vector<XMFLOAT4X4> lhs = CreateMatrices(ObjectCount, 1);
+	const vector<XMFLOAT4X4> rhs = CreateMatrices(ObjectCount, 2);
+	for (TransformKernels::InstructionSet instructionSet : SupportedInstructionSets())
+	{
+		vector<XMFLOAT4X4> products(ObjectCount);
+		TransformKernels::Multiply(ConstMatrixArray(lhs.data()), ConstMatrixArray(rhs.data()), MatrixArray(products.data()), ObjectCount, instructionSet);
+
+		// In place, with every object sharing one right-hand matrix.
+		vector<XMFLOAT4X4> inPlace = lhs;
+		TransformKernels::Multiply(ConstMatrixArray(inPlace.data()), ConstMatrixArray(rhs.data(), 0), MatrixArray(inPlace.data()), ObjectCount, instructionSet);
+
+		uint32_t matchCount = 0;
+		for (uint32_t i = 0; i < ObjectCount; ++i)
+		{
+			matchCount += (Matches(products[i], XMLoadFloat4x4(&lhs[i]) * XMLoadFloat4x4(&rhs[i]), instructionSet) ? 1 : 0);
+			matchCount += (Matches(inPlace[i], XMLoadFloat4x4(&lhs[i]) * XMLoadFloat4x4(&rhs[0]), instructionSet) ? 1 : 0);
+		}
+		CHECK_EQUAL(ObjectCount * 2, matchCount);
+	}
+}
+
+TEST_CASE(WorldViewProjectionMatchesDirectXMath)
+{
+	const vector<XMFLOAT4X4> worlds = CreateMatrices(ObjectCount, 3);
+	const XMFLOAT4X4 viewProjection = ViewProjection();
+	for (TransformKernels::InstructionSet instructionSet : SupportedInstructionSets())
+	{
+		vector<XMFLOAT4X4> transposedWorlds(ObjectCount);
+		vector<XMFLOAT4X4> transposedWorldViewProjections(ObjectCount);
+		TransformKernels::WorldViewProjection(ConstMatrixArray(worlds.data()), viewProjection, MatrixArray(transposedWorlds.data()),
+			MatrixArray(transposedWorldViewProjections.data()), ObjectCount, instructionSet);
+
+		uint32_t matchCount = 0;
+		for (uint32_t i = 0; i < ObjectCount; ++i)
+		{
+			const XMMATRIX world = XMLoadFloat4x4(&worlds[i]);
+			matchCount += (Matches(transposedWorlds[i], XMMatrixTranspose(world), TransformKernels::InstructionSet::Scalar) ? 1 : 0);
+			matchCount += (Matches(transposedWorldViewProjections[i], XMMatrixTranspose(world * XMLoadFloat4x4(&viewProjection)), instructionSet) ? 1 : 0);
+		}
+		CHECK_EQUAL(ObjectCount * 2, matchCount);
+	}
+}
+
+TEST_CASE(TransposeMatchesDirectXMath)
+{
+	const vector<XMFLOAT4X4> matrices = CreateMatrices(ObjectCount, 4);
+	for (TransformKernels::InstructionSet instructionSet : SupportedInstructionSets())
+	{
+		vector<XMFLOAT4X4> transposed(ObjectCount);
+		TransformKernels::Transpose(ConstMatrixArray(matrices.data()), MatrixArray(transposed.data()), ObjectCount, instructionSet);
+
+		vector<XMFLOAT4X4> inPlace = matrices;
+		TransformKernels::Transpose(ConstMatrixArray(inPlace.data()), MatrixArray(inPlace.data()), ObjectCount, instructionSet);
+
+		// Moving elements is exact with every instruction set.
+		uint32_t matchCount = 0;
+		for (uint32_t i = 0; i < ObjectCount; ++i)
+		{
+			XMFLOAT4X4 expected;
+			XMStoreFloat4x4(&expected, XMMatrixTranspose(XMLoadFloat4x4(&matrices[i])));
+			matchCount += (memcmp(&transposed[i], &expected, sizeof(XMFLOAT4X4)) == 0 ? 1 : 0);
+			matchCount += (memcmp(&inPlace[i], &expected, sizeof(XMFLOAT4X4)) == 0 ? 1 : 0);
+		}
+		CHECK_EQUAL(ObjectCount * 2, matchCount);
+	}
+}
+
+TEST_CASE(FixedSizeBatchesMatchDirectXMath)
+{
+	const TrsInput trs = CreateTrs(7);
+	vector<XMFLOAT4X4> composed(7);
+	TransformKernels::ComposeTrs<7>(trs.Arrays(), MatrixArray(composed.data()));
+
+	const vector<XMFLOAT4X4> rhs = CreateMatrices(7, 5);
+	vector<XMFLOAT4X4> products(7);
+	TransformKernels::Multiply<7>(ConstMatrixArray(composed.data()), ConstMatrixArray(rhs.data()), MatrixArray(products.data()));
+
+	const XMFLOAT4X4 viewProjection = ViewProjection();
+	vector<XMFLOAT4X4> transposedWorlds(7);
+	vector<XMFLOAT4X4> transposedWorldViewProjections(7);
+	TransformKernels::WorldViewProjection<7>(ConstMatrixArray(composed.data()), viewProjection, MatrixArray(transposedWorlds.data()), MatrixArray(transposedWorldViewProjections.data()));
+
+	vector<XMFLOAT4X4> transposed(7);
+	TransformKernels::Transpose<7>(ConstMatrixArray(products.data()), MatrixArray(transposed.data()));
+
+	// The fixed-size overloads use the SSE kernels, which follow DirectXMath's order.
+	const TransformKernels::InstructionSet exact = TransformKernels::InstructionSet::SSE;
+	for (uint32_t i = 0; i < 7; ++i)
+	{
+		const XMMATRIX world = ComposedTrs(trs, i);
+		CHECK(Matches(composed[i], world, exact));
+		CHECK(Matches(products[i], XMLoadFloat4x4(&composed[i]) * XMLoadFloat4x4(&rhs[i]), exact));
+		CHECK(Matches(transposedWorlds[i], XMMatrixTranspose(XMLoadFloat4x4(&composed[i])), exact));
+		CHECK(Matches(transposedWorldViewProjections[i], XMMatrixTranspose(XMLoadFloat4x4(&composed[i]) * XMLoadFloat4x4(&viewProjection)), exact));
+		CHECK(Matches(transposed[i], XMMatrixTranspose(XMLoadFloat4x4(&products[i])), exact));
+	}
+}
+
+TEST_CASE(EveryInstructionSetHasAName)
+{
+	CHECK(TransformKernels::BestInstructionSet() >= TransformKernels::InstructionSet::SSE);
+	CHECK_EQUAL(string("Scalar"), string(TransformKernels::InstructionSetName(TransformKernels::InstructionSet::Scalar)));
+	CHECK_EQUAL(string("SSE"), string(TransformKernels::InstructionSetName(TransformKernels::InstructionSet::SSE)));
+	CHECK_EQUAL(string("AVX2"), string(TransformKernels::InstructionSetName(TransformKernels::InstructionSet::AVX2)));
+	CHECK_EQUAL(string("AVX-512"), string(TransformKernels::InstructionSetName(TransformKernels::InstructionSet::AVX512)));
+}
\ No newline at end of file
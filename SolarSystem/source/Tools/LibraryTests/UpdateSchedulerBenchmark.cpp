@@ -0,0 +1,104 @@
+#include "pch.h"
+#include "OrbitingField.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace Library;
+using namespace LibraryTests;
+
+// Usage: UpdateSchedulerBenchmark [bodies] [frames]
+// Updates a field of orbiting bodies every frame, through the scheduler without a budget, and through the scheduler with
+// its default 1 ms budget, and reports the per-frame cost of each: its mean, spread and tail, and the first frame on its own.
+
+static const nanoseconds FrameTime(16666667);
+
+static void WriteReport(const char* name, const vector<double>& milliseconds, uint32_t minUpdated, uint32_t maxUpdated, uint64_t deferred)
+{
+	const double firstFrame = milliseconds.front();
+	const double mean = accumulate(milliseconds.begin(), milliseconds.end(), 0.0) / milliseconds.size();
+
+	double variance = 0.0;
+	for (double frame : milliseconds)
+	{
+		variance += (frame - mean) * (frame - mean);
+	}
+	const double standardDeviation = sqrt(variance / milliseconds.size());
+
+	vector<double> sorted(milliseconds);
+	sort(sorted.begin(), sorted.end());
+	const double p50 = sorted[(sorted.size() - 1) * 50 / 100];
+	const double p99 = sorted[(sorted.size() - 1) * 99 / 100];
+
+	cout << left << setw(24) << name << right << fixed << setprecision(3)
+		<< setw(9) << firstFrame << setw(9) << mean << setw(9) << standardDeviation << setw(9) << p50 << setw(9) << p99 << setw(9) << sorted.back()
+		<< setw(10) << minUpdated << setw(10) << maxUpdated << setw(10) << deferred << endl;
+}
+
+static void RunEveryFrame(uint32_t bodyCount, uint32_t frameCount)
+{
+	OrbitingField field(bodyCount, UpdateScheduler::DefaultFrameBudget);
+
+	const float elapsedSeconds = duration<float>(FrameTime).count();
+	vector<double> milliseconds;
+	milliseconds.reserve(frameCount);
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		for (OrbitingBody& body : field.Bodies())
+		{
+			body.ScheduledUpdate(elapsedSeconds);
+		}
+		milliseconds.push_back(duration<double, milli>(high_resolution_clock::now() - startTime).count());
+	}
+
+	WriteReport("Every frame", milliseconds, bodyCount, bodyCount, 0);
+}
+
+static void RunScheduled(const char* name, uint32_t bodyCount, uint32_t frameCount, microseconds frameBudget)
+{
+	OrbitingField field(bodyCount, frameBudget);
+	const UpdateScheduler& scheduler = field.Scheduler();
+
+	GameTime gameTime;
+	vector<double> milliseconds;
+	milliseconds.reserve(frameCount);
+	uint32_t minUpdated = numeric_limits<uint32_t>::max();
+	uint32_t maxUpdated = 0;
+	uint64_t deferred = 0;
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		gameTime.SetElapsedGameTime(FrameTime);
+		gameTime.SetTotalGameTime(gameTime.TotalGameTime() + FrameTime);
+
+		const high_resolution_clock::time_point startTime = high_resolution_clock::now();
+		field.Update(gameTime);
+		milliseconds.push_back(duration<double, milli>(high_resolution_clock::now() - startTime).count());
+
+		minUpdated = min(minUpdated, scheduler.UpdatedCount());
+		maxUpdated = max(maxUpdated, scheduler.UpdatedCount());
+		deferred += scheduler.DeferredCount();
+	}
+
+	WriteReport(name, milliseconds, minUpdated, maxUpdated, deferred);
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t bodyCount = (argc > 1 ? static_cast<uint32_t>(stoul(argv[1])) : 100000);
+	const uint32_t frameCount = (argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 600);
+	if (bodyCount == 0 || frameCount == 0)
+	{
+		cerr << "Usage: UpdateSchedulerBenchmark [bodies] [frames]" << endl;
+		return 1;
+	}
+
+	cout << bodyCount << " bodies, " << frameCount << " frames; times in milliseconds" << endl;
+	cout << left << setw(24) << "" << right << setw(9) << "first" << setw(9) << "mean" << setw(9) << "stddev" << setw(9) << "p50"
+		<< setw(9) << "p99" << setw(9) << "max" << setw(10) << "min upd" << setw(10) << "max upd" << setw(10) << "deferred" << endl;
+
+	RunEveryFrame(bodyCount, frameCount);
+	RunScheduled("Scheduled, no budget", bodyCount, frameCount, hours(1));
+	RunScheduled("Scheduled, 1 ms budget", bodyCount, frameCount, UpdateScheduler::DefaultFrameBudget);
+
+	return 0;
+}
\ No newline at end of file
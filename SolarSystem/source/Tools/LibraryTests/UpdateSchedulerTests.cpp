@@ -0,0 +1,188 @@
+#include "pch.h"
+#include "OrbitingBody.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace DirectX;
+using namespace Library;
+using namespace LibraryTests;
+
+static const nanoseconds FrameTime(16666667);
+
+static void AdvanceFrame(GameTime& gameTime)
+{
+	gameTime.SetElapsedGameTime(FrameTime);
+	gameTime.SetTotalGameTime(gameTime.TotalGameTime() + FrameTime);
+}
+
+// Bodies of radius 1 on the +X axis; at 10000 units they project to well under a pixel, so they get the longest period.
+static void CreateBodies(vector<OrbitingBody>& bodies, uint32_t count, float distance)
+{
+	bodies.reserve(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		bodies.emplace_back(distance, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+static float TestProjectionScale()
+{
+	return UpdateScheduler::ProjectionScale(XMMatrixPerspectiveFovRH(XM_PIDIV4, 16.0f / 9.0f, 0.5f, 100000.0f), 1080.0f);
+}
+
+TEST_CASE(FirstUpdatesAreStaggeredByPhase)
+{
+	const uint32_t bodyCount = 1600;
+	vector<OrbitingBody> bodies;
+	CreateBodies(bodies, bodyCount, 10000.0f);
+
+	UpdateScheduler scheduler(hours(1));
+	for (OrbitingBody& body : bodies)
+	{
+		scheduler.Register(body);
+	}
+
+	GameTime gameTime;
+	const uint32_t period = scheduler.MaxUpdatePeriod();
+	for (uint32_t frame = 0; frame < period; ++frame)
+	{
+		AdvanceFrame(gameTime);
+		scheduler.Update(gameTime, XMVectorZero(), TestProjectionScale());
+		CHECK_EQUAL(bodyCount / period, scheduler.UpdatedCount());
+		CHECK_EQUAL(0U, scheduler.DeferredCount());
+	}
+
+	for (uint32_t i = 0; i < bodyCount; ++i)
+	{
+		CHECK_EQUAL(period, scheduler.UpdatePeriod(i));
+		CHECK_EQUAL(1U, bodies[i].UpdateCount());
+	}
+}
+
+TEST_CASE(NearBodiesUpdateEveryFrame)
+{
+	vector<OrbitingBody> bodies;
+	CreateBodies(bodies, 64, 5.0f);
+
+	UpdateScheduler scheduler(hours(1));
+	for (OrbitingBody& body : bodies)
+	{
+		scheduler.Register(body);
+	}
+
+	GameTime gameTime;
+	for (uint32_t frame = 1; frame <= 10; ++frame)
+	{
+		AdvanceFrame(gameTime);
+		scheduler.Update(gameTime, XMVectorZero(), TestProjectionScale());
+		CHECK_EQUAL(64U, scheduler.UpdatedCount());
+	}
+
+	for (const OrbitingBody& body : bodies)
+	{
+		CHECK_EQUAL(10U, body.UpdateCount());
+		CHECK_EQUAL(0.0f, body.LastExtrapolationSeconds());
+	}
+}
+
+TEST_CASE(FirstUpdateCoversTheRegistrationFrame)
+{
+	vector<OrbitingBody> bodies;
+	CreateBodies(bodies, 16, 10000.0f);
+
+	UpdateScheduler scheduler(hours(1));
+	for (OrbitingBody& body : bodies)
+	{
+		scheduler.Register(body);
+	}
+
+	GameTime gameTime;
+	for (uint32_t frame = 1; frame <= 16; ++frame)
+	{
+		AdvanceFrame(gameTime);
+		scheduler.Update(gameTime, XMVectorZero(), TestProjectionScale());
+	}
+
+	// Phase i falls on frame i + 1 (or 16 for phase 0), and the first update covers every frame up to it.
+	CHECK_NEAR(16.0 * FrameTime.count() / 1e9, bodies[0].LastUpdateSeconds(), 1e-6);
+	for (uint32_t i = 1; i < 16; ++i)
+	{
+		CHECK_EQUAL(1U, bodies[i].UpdateCount());
+		CHECK_NEAR(i * FrameTime.count() / 1e9, bodies[i].LastUpdateSeconds(), 1e-6);
+	}
+}
+
+TEST_CASE(ElapsedTimeStaysExactAfterTenHours)
+{
+	vector<OrbitingBody> bodies;
+	CreateBodies(bodies, 4, 10000.0f);
+
+	UpdateScheduler scheduler(hours(1));
+	scheduler.MaxUpdatePeriod() = 4;
+	for (OrbitingBody& body : bodies)
+	{
+		scheduler.Register(body);
+	}
+
+	// A float of ten hours in seconds resolves only about 4 ms; the scheduler's elapsed times must not depend on the total.
+	GameTime gameTime;
+	gameTime.SetTotalGameTime(hours(10));
+	for (uint32_t frame = 1; frame <= 40; ++frame)
+	{
+		AdvanceFrame(gameTime);
+		scheduler.Update(gameTime, XMVectorZero(), TestProjectionScale());
+
+		for (const OrbitingBody& body : bodies)
+		{
+			if (body.LastExtrapolationSeconds() > 0.0f)
+			{
+				const double framesSinceUpdate = body.LastExtrapolationSeconds() / (FrameTime.count() / 1e9);
+				CHECK_NEAR(round(framesSinceUpdate), framesSinceUpdate, 1e-4);
+			}
+		}
+	}
+
+	for (const OrbitingBody& body : bodies)
+	{
+		CHECK_EQUAL(10U, body.UpdateCount());
+		CHECK_NEAR(4.0 * FrameTime.count() / 1e9, body.LastUpdateSeconds(), 1e-7);
+	}
+}
+
+TEST_CASE(OverBudgetUpdatesAreDeferredEarliestDeadlineFirst)
+{
+	vector<OrbitingBody> bodies;
+	CreateBodies(bodies, 40, 5.0f);
+
+	// A zero budget stops at the first budget check, after eight updates.
+	UpdateScheduler scheduler(microseconds(0));
+	for (OrbitingBody& body : bodies)
+	{
+		scheduler.Register(body);
+	}
+
+	GameTime gameTime;
+	AdvanceFrame(gameTime);
+	scheduler.Update(gameTime, XMVectorZero(), TestProjectionScale());
+	CHECK_EQUAL(8U, scheduler.UpdatedCount());
+	CHECK_EQUAL(32U, scheduler.DeferredCount());
+	for (uint32_t i = 0; i < 40; ++i)
+	{
+		CHECK_EQUAL((i < 8 ? 1U : 0U), bodies[i].UpdateCount());
+	}
+
+	// The overdue bodies keep their deadline of frame 1 and so go before the bodies updated this frame.
+	for (uint32_t frame = 2; frame <= 5; ++frame)
+	{
+		AdvanceFrame(gameTime);
+		scheduler.Update(gameTime, XMVectorZero(), TestProjectionScale());
+		CHECK_EQUAL(8U, scheduler.UpdatedCount());
+	}
+
+	for (uint32_t i = 0; i < 40; ++i)
+	{
+		CHECK_EQUAL(1U, bodies[i].UpdateCount());
+	}
+
+	CHECK_NEAR(5.0 * FrameTime.count() / 1e9, bodies[39].LastUpdateSeconds(), 1e-6);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+// The library's portable sources, as Library.Shared/pch.h gives them to a build that defines LIBRARY_PORTABLE
+#include "../../Library.Shared/pch.h"
+
+// Standard
+#include <random>
+#include <limits>
+#include <set>
+
+// Local
+#include "TestHarness.h"
\ No newline at end of file
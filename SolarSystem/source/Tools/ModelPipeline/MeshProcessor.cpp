@@ -8,81 +8,84 @@ namespace ModelPipeline
 {
 	shared_ptr<Library::Mesh> MeshProcessor::LoadMesh(Library::Model& model, aiMesh& mesh)
 	{
-		MeshData meshData;
+		// Every channel is sized up front so the mesh takes a single allocation
+		MeshLayout layout;
+		layout.VertexCount = mesh.mNumVertices;
+		layout.HasNormals = mesh.HasNormals();
+		layout.HasTangents = mesh.HasTangentsAndBitangents();
+		layout.HasBiNormals = mesh.HasTangentsAndBitangents();
+		layout.TextureCoordinateChannelCount = mesh.GetNumUVChannels();
+		layout.VertexColorChannelCount = mesh.GetNumColorChannels();
+		for (UINT i = 0; i < mesh.mNumFaces; i++)
+		{
+			layout.IndexCount += mesh.mFaces[i].mNumIndices;
+		}
 
+		MeshData meshData(layout);
 		meshData.Material = model.Materials().at(mesh.mMaterialIndex);
 
 		// Vertices
-		meshData.Vertices.reserve(mesh.mNumVertices);
+		Span<XMFLOAT3> vertices = meshData.Vertices();
 		for (UINT i = 0; i < mesh.mNumVertices; i++)
 		{
-			meshData.Vertices.push_back(XMFLOAT3(reinterpret_cast<const float*>(&mesh.mVertices[i])));
+			vertices[i] = XMFLOAT3(reinterpret_cast<const float*>(&mesh.mVertices[i]));
 		}
 
 		// Normals
-		if (mesh.HasNormals())
+		if (layout.HasNormals)
 		{
-			meshData.Normals.reserve(mesh.mNumVertices);
+			Span<XMFLOAT3> normals = meshData.Normals();
 			for (UINT i = 0; i < mesh.mNumVertices; i++)
 			{
-				meshData.Normals.push_back(XMFLOAT3(reinterpret_cast<const float*>(&mesh.mNormals[i])));
+				normals[i] = XMFLOAT3(reinterpret_cast<const float*>(&mesh.mNormals[i]));
 			}
 		}
 
 		// Tangents and Binormals
-		if (mesh.HasTangentsAndBitangents())
+		if (layout.HasTangents)
 		{
-			meshData.Tangents.reserve(mesh.mNumVertices);
-			meshData.BiNormals.reserve(mesh.mNumVertices);
+			Span<XMFLOAT3> tangents = meshData.Tangents();
+			Span<XMFLOAT3> biNormals = meshData.BiNormals();
 			for (UINT i = 0; i < mesh.mNumVertices; i++)
 			{
-				meshData.Tangents.push_back(XMFLOAT3(reinterpret_cast<const float*>(&mesh.mTangents[i])));
-				meshData.BiNormals.push_back(XMFLOAT3(reinterpret_cast<const float*>(&mesh.mBitangents[i])));
+				tangents[i] = XMFLOAT3(reinterpret_cast<const float*>(&mesh.mTangents[i]));
+				biNormals[i] = XMFLOAT3(reinterpret_cast<const float*>(&mesh.mBitangents[i]));
 			}
 		}
 
 		// Texture Coordinates
-		UINT uvChannelCount = mesh.GetNumUVChannels();
-		for (UINT i = 0; i < uvChannelCount; i++)
+		for (UINT i = 0; i < layout.TextureCoordinateChannelCount; i++)
 		{
-			vector<XMFLOAT3>* textureCoordinates = new vector<XMFLOAT3>();
-			textureCoordinates->reserve(mesh.mNumVertices);
-			meshData.TextureCoordinates.push_back(textureCoordinates);
-
+			Span<XMFLOAT3> textureCoordinates = meshData.TextureCoordinates(i);
 			aiVector3D* aiTextureCoordinates = mesh.mTextureCoords[i];
 			for (UINT j = 0; j < mesh.mNumVertices; j++)
 			{
-				textureCoordinates->push_back(XMFLOAT3(reinterpret_cast<const float*>(&aiTextureCoordinates[j])));
+				textureCoordinates[j] = XMFLOAT3(reinterpret_cast<const float*>(&aiTextureCoordinates[j]));
 			}
 		}
 
 		// Vertex Colors
-		UINT colorChannelCount = mesh.GetNumColorChannels();
-		for (UINT i = 0; i < colorChannelCount; i++)
+		for (UINT i = 0; i < layout.VertexColorChannelCount; i++)
 		{
-			vector<XMFLOAT4>* vertexColors = new vector<XMFLOAT4>();
-			vertexColors->reserve(mesh.mNumVertices);
-			meshData.VertexColors.push_back(vertexColors);
-
+			Span<XMFLOAT4> vertexColors = meshData.VertexColors(i);
 			aiColor4D* aiVertexColors = mesh.mColors[i];
 			for (UINT j = 0; j < mesh.mNumVertices; j++)
 			{
-				vertexColors->push_back(XMFLOAT4(reinterpret_cast<const float*>(&aiVertexColors[j])));
+				vertexColors[j] = XMFLOAT4(reinterpret_cast<const float*>(&aiVertexColors[j]));
 			}
 		}
 
-		// Faces (note: could pre-reserve if we limit primitive types)
-		if (mesh.HasFaces())
+		// Faces
+		meshData.FaceCount = mesh.mNumFaces;
+		Span<uint32_t> indices = meshData.Indices();
+		size_t index = 0;
+		for (UINT i = 0; i < meshData.FaceCount; i++)
 		{
-			meshData.FaceCount = mesh.mNumFaces;
-			for (UINT i = 0; i < meshData.FaceCount; i++)
-			{
-				aiFace* face = &mesh.mFaces[i];
+			aiFace* face = &mesh.mFaces[i];
 
-				for (UINT j = 0; j < face->mNumIndices; j++)
-				{
-					meshData.Indices.push_back(face->mIndices[j]);
-				}
+			for (UINT j = 0; j < face->mNumIndices; j++)
+			{
+				indices[index++] = face->mIndices[j];
 			}
 		}
 